@@ -24,6 +24,7 @@
 #include "ob_tablet_manager.h"
 #include "common/ob_atomic.h"
 #include "common/file_directory_utils.h"
+#include "common/ob_numa.h"
 #include "ob_tablet_merger_v1.h"
 #include "ob_tablet_merger_v2.h"
 
@@ -47,7 +48,8 @@ namespace oceanbase
                                    round_start_(true),round_end_(true), pending_in_upgrade_(false),
                                    merge_load_high_(0),request_count_high_(0), merge_adjust_ratio_(0),
                                    merge_load_adjust_(0), merge_pause_row_count_(0), merge_pause_sleep_time_(0),
-                                   merge_highload_sleep_time_(0), tablet_manager_(NULL)
+                                   merge_highload_sleep_time_(0), tablet_manager_(NULL),
+                                   sub_merge_head_(0), sub_merge_tail_(0), free_sub_merger_num_(0)
     {
       //memset(reinterpret_cast<void *>(&pending_merge_),0,sizeof(pending_merge_));
       for(uint32_t i=0; i < sizeof(pending_merge_) / sizeof(pending_merge_[0]); ++i)
@@ -55,6 +57,9 @@ namespace oceanbase
         pending_merge_[i] = 0;
       }
       memset(mergers_, 0, sizeof(mergers_));
+      memset(sub_merge_queue_, 0, sizeof(sub_merge_queue_));
+      memset(sub_mergers_, 0, sizeof(sub_mergers_));
+      memset(free_sub_mergers_, 0, sizeof(free_sub_mergers_));
     }
 
     void ObChunkMerge::set_config_param()
@@ -117,6 +122,7 @@ namespace oceanbase
 
         pthread_mutex_init(&mutex_,NULL);
         pthread_cond_init(&cond_,NULL);
+        pthread_cond_init(&sub_merge_cond_,NULL);
 
         int64_t max_merge_thread = chunk_server.get_config().max_merge_thread_num;
         if (max_merge_thread <= 0 || max_merge_thread > MAX_MERGE_THREAD)
@@ -141,6 +147,7 @@ namespace oceanbase
       {
         pthread_mutex_destroy(&mutex_);
         pthread_cond_destroy(&cond_);
+        pthread_cond_destroy(&sub_merge_cond_);
         inited_ = false;
       }
       return ret;
@@ -161,6 +168,7 @@ namespace oceanbase
 
         wait();
         pthread_cond_destroy(&cond_);
+        pthread_cond_destroy(&sub_merge_cond_);
         pthread_mutex_destroy(&mutex_);
         destroy_all_tablets_mergers();
       }
@@ -209,6 +217,15 @@ namespace oceanbase
       {
         TBSYS_LOG(ERROR, "create v2 Merger error, ret=%d", ret);
       }
+      else if (OB_SUCCESS != (ret = create_tablet_mergers<ObTabletMergerV2>(sub_mergers_, MAX_MERGE_THREAD)))
+      {
+        TBSYS_LOG(ERROR, "create sub range Merger error, ret=%d", ret);
+      }
+      else
+      {
+        memcpy(free_sub_mergers_, sub_mergers_, sizeof(free_sub_mergers_));
+        free_sub_merger_num_ = MAX_MERGE_THREAD;
+      }
       return ret;
     }
 
@@ -241,6 +258,8 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       destroy_tablet_mergers(mergers_, MAX_MERGE_THREAD );
       destroy_tablet_mergers(mergers_ + MAX_MERGE_THREAD, MAX_MERGE_THREAD );
+      destroy_tablet_mergers(sub_mergers_, MAX_MERGE_THREAD );
+      free_sub_merger_num_ = 0;
       return ret;
     }
 
@@ -328,6 +347,7 @@ namespace oceanbase
     {
       UNUSED(thread);
       int64_t thread_no = reinterpret_cast<int64_t>(arg);
+      ObNumaTopology::get_instance().bind_thread_round_robin(thread_no);
       merge_tablets(thread_no);
     }
 
@@ -337,6 +357,7 @@ namespace oceanbase
       const int64_t sleep_interval = 5000000;
       ObTablet *tablet = NULL;
       ObTabletMerger *merger = NULL;
+      ObSubMergeTask *sub_task = NULL;
       int64_t merge_fail_count = 0;
 
       ObChunkServer&  chunk_server = ObChunkServerMain::get_instance()->get_chunk_server();
@@ -365,17 +386,31 @@ namespace oceanbase
             TBSYS_LOG(INFO,"to merge,active_thread_num_ :%ld", active_thread_num_);
             ++active_thread_num_;
             pthread_mutex_unlock(&mutex_);
+            // cond_ is also broadcast for new round, released merge groups
+            // and queued sub ranges, check load again before taking work.
+            continue;
           }
         }
 
         pthread_mutex_lock(&mutex_);
-        ret = get_tablets(tablet);
+        // help to merge sub ranges of large tablet first, which
+        // may be the last ones to finish in this round.
+        tablet = NULL;
+        if (NULL == (sub_task = pop_sub_merge_task()))
+        {
+          ret = get_tablets(tablet);
+        }
         while (true)
         {
           if (!inited_)
           {
             break;
           }
+          if (NULL != sub_task) // got sub range for merge
+          {
+            ret = OB_SUCCESS;
+            break;
+          }
           if (OB_SUCCESS != ret)
           {
             pthread_mutex_unlock(&mutex_);
@@ -396,10 +431,19 @@ namespace oceanbase
           {
             break;
           }
-          ret = get_tablets(tablet);
+          if (NULL == (sub_task = pop_sub_merge_task()))
+          {
+            ret = get_tablets(tablet);
+          }
         }
         pthread_mutex_unlock(&mutex_);
 
+        if (NULL != sub_task)
+        {
+          run_sub_merge_task(sub_task);
+          sub_task = NULL;
+        }
+
         int64_t retry_times = chunk_server.get_config().retry_times;
         int64_t merge_per_disk = chunk_server.get_config().merge_thread_per_disk;
 
@@ -489,6 +533,121 @@ namespace oceanbase
 
     }
 
+    int ObChunkMerge::push_sub_merge_tasks(ObSubMergeTask* tasks, const int64_t count)
+    {
+      int ret = OB_SUCCESS;
+      const int64_t queue_size = sizeof(sub_merge_queue_) / sizeof(sub_merge_queue_[0]);
+
+      if (NULL == tasks || count <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid argument, tasks=%p, count=%ld", tasks, count);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        pthread_mutex_lock(&mutex_);
+        if (sub_merge_tail_ - sub_merge_head_ + count > queue_size)
+        {
+          TBSYS_LOG(WARN, "sub merge queue is full, head=%ld, tail=%ld, count=%ld",
+              sub_merge_head_, sub_merge_tail_, count);
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else
+        {
+          for (int64_t i = 0; i < count; ++i)
+          {
+            tasks[i].ret_ = OB_SUCCESS;
+            tasks[i].finished_ = false;
+            sub_merge_queue_[sub_merge_tail_++ % queue_size] = &tasks[i];
+          }
+          // wake up idle merge threads, threads sleeping for high load
+          // check load again in merge_tablets before they help.
+          pthread_cond_broadcast(&cond_);
+        }
+        pthread_mutex_unlock(&mutex_);
+      }
+      return ret;
+    }
+
+    void ObChunkMerge::wait_sub_merge_tasks(ObSubMergeTask* tasks, const int64_t count)
+    {
+      ObSubMergeTask* task = NULL;
+      bool finished = false;
+
+      pthread_mutex_lock(&mutex_);
+      while (!finished)
+      {
+        finished = true;
+        for (int64_t i = 0; i < count && finished; ++i)
+        {
+          finished = tasks[i].finished_;
+        }
+
+        if (finished)
+        {
+          break;
+        }
+        else if (NULL != (task = pop_sub_merge_task()))
+        {
+          pthread_mutex_unlock(&mutex_);
+          run_sub_merge_task(task);
+          pthread_mutex_lock(&mutex_);
+        }
+        else
+        {
+          pthread_cond_wait(&sub_merge_cond_, &mutex_);
+        }
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+
+    /**
+     * @brief get a queued sub merge task, must hold mutex_
+     */
+    ObSubMergeTask* ObChunkMerge::pop_sub_merge_task()
+    {
+      ObSubMergeTask* task = NULL;
+      const int64_t queue_size = sizeof(sub_merge_queue_) / sizeof(sub_merge_queue_[0]);
+      if (sub_merge_head_ < sub_merge_tail_ && free_sub_merger_num_ > 0)
+      {
+        task = sub_merge_queue_[sub_merge_head_++ % queue_size];
+      }
+      return task;
+    }
+
+    void ObChunkMerge::run_sub_merge_task(ObSubMergeTask* task)
+    {
+      int ret = OB_SUCCESS;
+      ObTabletMerger* merger = NULL;
+
+      pthread_mutex_lock(&mutex_);
+      if (free_sub_merger_num_ > 0)
+      {
+        merger = free_sub_mergers_[--free_sub_merger_num_];
+      }
+      pthread_mutex_unlock(&mutex_);
+
+      if (NULL == merger)
+      {
+        TBSYS_LOG(ERROR, "no free merger for sub range=%s", to_cstring(task->range_));
+        ret = OB_ERROR;
+      }
+      else
+      {
+        ret = static_cast<ObTabletMergerV2*>(merger)->merge_sub_range(*task);
+      }
+
+      pthread_mutex_lock(&mutex_);
+      if (NULL != merger)
+      {
+        free_sub_mergers_[free_sub_merger_num_++] = merger;
+      }
+      task->ret_ = ret;
+      task->finished_ = true;
+      pthread_cond_broadcast(&sub_merge_cond_);
+      pthread_mutex_unlock(&mutex_);
+    }
+
     int ObChunkMerge::fetch_frozen_time_busy_wait(const int64_t frozen_version, int64_t &frozen_time)
     {
       int ret = OB_SUCCESS;
@@ -596,6 +755,7 @@ namespace oceanbase
       }
       else
       {
+        fetch_merge_schedule_busy_wait(frozen_version);
         TBSYS_LOG(INFO, "new merge process, version=%ld, frozen_timestamp_=%ld",
             frozen_version, frozen_timestamp_);
       }
@@ -603,6 +763,76 @@ namespace oceanbase
       return ret;
     }
 
+    /**
+     * the merge plan also carries the split params of parallel
+     * merge which must be the same on all replicas, so wait until
+     * rootserver gives the plan of this version. merge all tables
+     * at once without splitting only if rootserver doesn't support
+     * the plan at all.
+     */
+    void ObChunkMerge::fetch_merge_schedule_busy_wait(const int64_t frozen_version)
+    {
+      int ret = OB_SUCCESS;
+      ObMergeSchedule schedule;
+      int64_t retry_count = 0;
+      while (inited_)
+      {
+        ret = CS_RPC_CALL_RS(get_merge_schedule, frozen_version, schedule);
+        if (OB_SUCCESS == ret || (OB_EAGAIN != ret && OB_RESPONSE_TIME_OUT != ret)) break;
+        if (0 == retry_count++ % 10)
+        {
+          TBSYS_LOG(INFO, "merge schedule of version=%ld not ready, retry_count=%ld, ret=%d",
+              frozen_version, retry_count, ret);
+        }
+        usleep(static_cast<useconds_t>(THE_CHUNK_SERVER.get_config().network_timeout));
+      }
+
+      pthread_mutex_lock(&mutex_);
+      if (OB_SUCCESS == ret && schedule.get_frozen_version() == frozen_version)
+      {
+        merge_schedule_ = schedule;
+        TBSYS_LOG(INFO, "got merge schedule, %s", to_cstring(merge_schedule_));
+      }
+      else
+      {
+        TBSYS_LOG(WARN, "failed to get merge schedule of version=%ld, merge all tables without split, ret=%d",
+            frozen_version, ret);
+        merge_schedule_.reset();
+        merge_schedule_.set_frozen_version(frozen_version);
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+
+    void ObChunkMerge::release_merge_group(const int64_t frozen_version, const int64_t group)
+    {
+      bool released = false;
+      pthread_mutex_lock(&mutex_);
+      if (frozen_version != merge_schedule_.get_frozen_version())
+      {
+        // plan of another version, don't hold back current merge
+        released = merge_schedule_.release_group(ObMergeSchedule::ALL_GROUP_RELEASED);
+      }
+      else
+      {
+        released = merge_schedule_.release_group(group);
+      }
+      if (released)
+      {
+        TBSYS_LOG(INFO, "release merge group, version=%ld, %s",
+            frozen_version, to_cstring(merge_schedule_));
+        pthread_cond_broadcast(&cond_);
+      }
+      pthread_mutex_unlock(&mutex_);
+    }
+
+    void ObChunkMerge::get_merge_split_param(int64_t& min_tablet_size, int64_t& sub_range_count)
+    {
+      pthread_mutex_lock(&mutex_);
+      min_tablet_size = merge_schedule_.get_split_tablet_size();
+      sub_range_count = merge_schedule_.get_split_range_count();
+      pthread_mutex_unlock(&mutex_);
+    }
+
     int ObChunkMerge::finish_round(const int64_t frozen_version)
     {
       int ret = OB_SUCCESS;
@@ -656,6 +886,7 @@ namespace oceanbase
       tablet = NULL;
       int err = OB_SUCCESS;
       int64_t print_step = thread_num_ > 0 ? thread_num_ : 10;
+      int64_t delayed_count = 0;
       if (tablets_num_ > 0 && tablet_index_ < tablets_num_)
       {
         TBSYS_LOG(DEBUG,"get tablet from local list,tablet_index_:%ld,tablets_num_:%ld",tablet_index_,tablets_num_);
@@ -690,7 +921,7 @@ namespace oceanbase
           TBSYS_LOG(INFO,"get tablet from tablet image, frozen_version_=%ld, tablets_num_=%ld",
               frozen_version_, tablets_num_);
           err = tablet_manager_->get_serving_tablet_image().get_tablets_for_merge(
-              frozen_version_, tablets_num_,tablet_array_);
+              frozen_version_, tablets_num_,tablet_array_, &merge_schedule_, delayed_count);
 
           if (err != OB_SUCCESS)
           {
@@ -702,6 +933,13 @@ namespace oceanbase
             tablet = tablet_array_[tablet_index_++];
             break; //got it
           }
+          else if (delayed_count > 0)
+          {
+            // wait for rootserver to release the remaining tables
+            TBSYS_LOG(INFO, "%ld tablets wait for merge schedule, %s",
+                delayed_count, to_cstring(merge_schedule_));
+            break;
+          }
           else if (!round_end_)
           {
             if (OB_SUCCESS == (err = finish_round(frozen_version_)))
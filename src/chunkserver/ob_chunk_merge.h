@@ -21,6 +21,8 @@
 #include "common/ob_define.h"
 #include "common/ob_schema.h"
 #include "common/ob_vector.h"
+#include "common/ob_range2.h"
+#include "common/ob_merge_schedule.h"
 #include "common/thread_buffer.h"
 
 
@@ -28,8 +30,24 @@ namespace oceanbase
 {
   namespace chunkserver
   {
+    class ObTablet;
     class ObTabletManager;
     class ObTabletMerger;
+
+    /**
+     * one sub range of a large tablet, merged by the idle merge
+     * threads in parallel, see ObTabletMergerV2::parallel_merge
+     */
+    struct ObSubMergeTask
+    {
+      ObTablet* tablet_;
+      int64_t frozen_version_;
+      common::ObNewRange range_;
+      common::ObVector<ObTablet*> new_tablets_; // tablets merged from this sub range
+      int ret_;
+      bool finished_;
+    };
+
     class ObChunkMerge : public tbsys::CDefaultRunnable
     {
       public:
@@ -73,10 +91,33 @@ namespace oceanbase
 
         int create_merge_threads(const int64_t max_merge_thread);
 
+        /**
+         * queue sub ranges of a large tablet, wake up the idle merge
+         * threads to merge them.
+         */
+        int push_sub_merge_tasks(ObSubMergeTask* tasks, const int64_t count);
+
+        /**
+         * help to run queued sub merge tasks in current thread until all
+         * %tasks are finished.
+         */
+        void wait_sub_merge_tasks(ObSubMergeTask* tasks, const int64_t count);
+
+        /**
+         * rootserver released merge groups up to %group of
+         * %frozen_version in heartbeat, wake up idle merge threads.
+         */
+        void release_merge_group(const int64_t frozen_version, const int64_t group);
+
+        /// tablet split parameters of parallel merge in the merge plan
+        void get_merge_split_param(int64_t& min_tablet_size, int64_t& sub_range_count);
+
       private:
         virtual void run(tbsys::CThread* thread, void *arg);
         void merge_tablets(const int64_t thread_no);
         int get_tablets(ObTablet* &tablet);
+        ObSubMergeTask* pop_sub_merge_task();
+        void run_sub_merge_task(ObSubMergeTask* task);
 
         bool have_new_version_in_othercs(const ObTablet* tablet);
         int delete_tablet_on_rootserver(const ObTablet* tablet);
@@ -86,6 +127,7 @@ namespace oceanbase
         int fetch_frozen_time_busy_wait(const int64_t frozen_version, int64_t &frozen_time);
         int fetch_frozen_schema_busy_wait(
           const int64_t frozen_version, common::ObSchemaManagerV2& schema);
+        void fetch_merge_schedule_busy_wait(const int64_t frozen_version);
         int create_all_tablet_mergers();
         int destroy_all_tablets_mergers();
         template <typename Merger>
@@ -101,10 +143,12 @@ namespace oceanbase
         const static int64_t MAX_MERGE_THREAD = 32;
         const static int32_t TABLET_COUNT_PER_MERGE = 1024;
         const static uint32_t MAX_MERGE_PER_DISK = 2;
+        const static int64_t MAX_SUB_MERGE_TASK = 32; // sub ranges of one tablet
       private:
         volatile bool inited_;
         pthread_cond_t cond_;
         pthread_mutex_t mutex_;
+        pthread_cond_t sub_merge_cond_;  // signaled when a sub merge task finished
 
         ObTablet *tablet_array_[TABLET_COUNT_PER_MERGE];
         int64_t tablets_num_;
@@ -140,9 +184,20 @@ namespace oceanbase
 
         common::ObSchemaManagerV2 last_schema_;
         common::ObSchemaManagerV2 current_schema_;
+        // tables of current frozen version released for merge by rootserver
+        common::ObMergeSchedule merge_schedule_;
 
         ObTabletManager *tablet_manager_;
         ObTabletMerger  *mergers_[MAX_MERGE_THREAD * 2];
+
+        // sub ranges of large tablets waiting for merge, and free
+        // mergers to merge them, one for each merge thread
+        ObSubMergeTask  *sub_merge_queue_[MAX_MERGE_THREAD * MAX_SUB_MERGE_TASK];
+        int64_t sub_merge_head_;
+        int64_t sub_merge_tail_;
+        ObTabletMerger  *sub_mergers_[MAX_MERGE_THREAD];
+        ObTabletMerger  *free_sub_mergers_[MAX_MERGE_THREAD];
+        int64_t free_sub_merger_num_;
     };
 
     template <typename Merger>
@@ -20,6 +20,10 @@
 #include "ob_chunk_callback.h"
 #include "common/ob_config_manager.h"
 #include "common/ob_profile_log.h"
+#include "common/ob_numa.h"
+#include "common/ob_huge_page.h"
+#include "common/ob_record_header.h"
+#include "common/ob_scan_param.h"
 
 using namespace oceanbase::common;
 
@@ -31,7 +35,7 @@ namespace oceanbase
     ObChunkServer::ObChunkServer(ObChunkServerConfig &config,
                                  ObConfigManager &config_mgr)
       : config_(config), config_mgr_(config_mgr),
-        file_service_(), file_client_(), file_client_rpc_buffer_(),
+        file_service_(), file_client_(), file_client_rpc_buffer_(), migrate_load_probe_(),
         response_buffer_(RESPONSE_PACKET_BUFFER_SIZE),
         rpc_buffer_(RPC_BUFFER_SIZE)
     {
@@ -111,6 +115,7 @@ namespace oceanbase
       set_default_queue_size((int)config.task_queue_size);
       set_min_left_time(config.task_left_time);
       tablet_manager.get_serving_block_cache().enlarg_cache_size(config.block_cache_size);
+      sstable::ObReadaheadWindow::set_disk_budget(config.sstable_readahead_size_per_disk);
       tablet_manager.get_serving_block_index_cache().enlarg_cache_size(config.block_index_cache_size);
       tablet_manager.get_fileinfo_cache().enlarg_cache_num(config.file_info_cache_num);
       tablet_manager.get_join_cache().enlarg_cache_size(config.block_index_cache_size);
@@ -155,6 +160,20 @@ namespace oceanbase
       return schema_mgr_;
     }
 
+    int64_t ObChunkServer::MigrateLoadProbe::get_load_percent() const
+    {
+      int64_t load = 0;
+      if (NULL != server_ && server_->get_config().migrate_band_limit_adaptive)
+      {
+        int64_t queue_size = server_->get_config().task_queue_size;
+        if (queue_size > 0)
+        {
+          load = static_cast<int64_t>(server_->get_current_queue_size()) * 100 / queue_size;
+        }
+      }
+      return load;
+    }
+
     ObFileClient& ObChunkServer::get_file_client()
     {
       return file_client_;
@@ -382,6 +401,18 @@ namespace oceanbase
         ret = set_min_left_time(config_.task_left_time);
       }
 
+      // numa topology must be ready before the worker threads and caches
+      if (OB_SUCCESS == ret)
+      {
+        ret = ObNumaTopology::get_instance().init(config_.numa_aware);
+        set_numa_aware(config_.numa_aware);
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        ret = ObHugePagePool::get_instance().init(config_.huge_page_mode);
+      }
+
       //TODO  initialize client_manager_ for server remote procedure call.
       if (OB_SUCCESS == ret)
       {
@@ -391,6 +422,7 @@ namespace oceanbase
       if (OB_SUCCESS == ret)
       {
         ret = tablet_manager_.init(&config_);
+        sstable::ObReadaheadWindow::set_disk_budget(config_.sstable_readahead_size_per_disk);
       }
 
       // server initialize, including start transport,
@@ -421,6 +453,12 @@ namespace oceanbase
                                       &client_manager_, config_.migrate_band_limit_per_second);
       }
 
+      if (OB_SUCCESS == ret)
+      {
+        migrate_load_probe_.init(this);
+        file_client_.set_load_probe(&migrate_load_probe_);
+      }
+
       stat_.init(get_self());
       ObStatSingleton::init(&stat_);
       return ret;
@@ -462,6 +500,25 @@ namespace oceanbase
       return timeout_time;
     }
 
+    int64_t ObChunkServer::get_packet_numa_node(ObPacket* packet)
+    {
+      // scans of one table are handled on one node, so the blocks it reads
+      // are cached in the memory of that node. other requests have no key
+      // that can be read without deserializing the whole packet.
+      int64_t node = -1;
+      uint64_t table_id = OB_INVALID_ID;
+      ObRecordHeader header;
+      const ObDataBuffer* buffer = NULL;
+      if (NULL != packet && OB_SCAN_REQUEST == packet->get_packet_code()
+          && NULL != (buffer = packet->get_packet_buffer())
+          && OB_SUCCESS == ObScanParam::peek_table_id(buffer->get_data(), buffer->get_capacity(),
+                                                      header.get_serialize_size(), table_id))
+      {
+        node = ObNumaTopology::get_instance().get_node_by_key(table_id);
+      }
+      return node;
+    }
+
     int ObChunkServer::do_request(ObPacket* base_packet)
     {
       int ret = OB_SUCCESS;
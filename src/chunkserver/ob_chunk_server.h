@@ -54,6 +54,7 @@ namespace oceanbase
         virtual void destroy();
 
         virtual int do_request(common::ObPacket* base_packet);
+        virtual int64_t get_packet_numa_node(common::ObPacket* packet);
       public:
         common::ThreadSpecificBuffer::Buffer* get_rpc_buffer() const;
         common::ThreadSpecificBuffer::Buffer* get_response_buffer() const;
@@ -89,6 +90,17 @@ namespace oceanbase
                                          const int64_t network_timeout);
         int init_file_service(const int32_t queue_size,
             const int32_t thread_cout, const int32_t band_limit);
+      private:
+        // load of the default task queue, used to adapt the band limit of migration
+        class MigrateLoadProbe : public common::ObFileClientLoadProbe
+        {
+          public:
+            MigrateLoadProbe() : server_(NULL) {}
+            void init(const ObChunkServer *server) { server_ = server; }
+            virtual int64_t get_load_percent() const;
+          private:
+            const ObChunkServer *server_;
+        };
       private:
         // request service handler
         ObChunkService service_;
@@ -102,6 +114,7 @@ namespace oceanbase
         // ob file client
         common::ObFileClient file_client_;
         common::ThreadSpecificBuffer file_client_rpc_buffer_;
+        MigrateLoadProbe migrate_load_probe_;
 
         // network objects.
         common::ObClientManager  client_manager_;
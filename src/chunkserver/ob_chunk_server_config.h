@@ -69,6 +69,7 @@ namespace oceanbase
         DEF_INT(compactsstable_cache_thread_num, "0", "[0,]", "compacet sstable cache thread number");
 
         DEF_CAP(migrate_band_limit_per_second, "50MB", "network band limit for migration");
+        DEF_BOOL(migrate_band_limit_adaptive, "False", "lower the band limit of migration as the task queue grows, down to 10% of migrate_band_limit_per_second");
 
         DEF_CAP(merge_mem_limit, "64MB", "memory usage to merge for each thread");
         DEF_INT(merge_thread_per_disk, "2", "[1,]", "merge thread per disk, increase the number will reduce daily merge time but increase response time");
@@ -107,6 +108,7 @@ namespace oceanbase
 
         DEF_TIME(slow_query_warn_time, "500ms", "beyond this value will treated as slow query");
         DEF_CAP(block_cache_size, "1GB", "(0,)", "block cache size");
+        DEF_CAP(sstable_readahead_size_per_disk, "16MB", "[128KB,]", "readahead bytes shared by the sequential sstable scans on one disk");
         DEF_CAP(block_index_cache_size, "512MB", "(0,)", "block index cache size");
         DEF_CAP(join_cache_size, "512MB", "join cache size");
         DEF_CAP(sstable_row_cache_size, "2GB", "[0,]", "sstable row cache size");
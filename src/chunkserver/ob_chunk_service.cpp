@@ -31,6 +31,7 @@
 #include "common/ob_schema_manager.h"
 #include "common/ob_version.h"
 #include "common/ob_profile_log.h"
+#include "common/ob_query_profile.h"
 #include "sql/ob_sql_scan_param.h"
 #include "sstable/ob_disk_path.h"
 #include "sstable/ob_aio_buffer_mgr.h"
@@ -933,6 +934,8 @@ namespace oceanbase
       ObPacketQueueThread& queue_thread =
         chunk_server_->get_default_task_queue_thread();
       ObSqlQueryService *sql_query_service = NULL;
+      ObRpcProfile &rpc_profile = ObRpcProfile::get_tsi();
+      int64_t packet_start_time = start_time;
 
       INIT_PROFILE_LOG_TIMER();
 
@@ -950,6 +953,7 @@ namespace oceanbase
       {
         new_scanner->reuse();
         sql_read_param_ptr->reset();
+        rpc_profile.reset();
       }
 
       if (OB_SUCCESS == rc.result_code_)
@@ -984,6 +988,22 @@ namespace oceanbase
           }
           FILL_TRACE_LOG("get_server_stat_done");
         }
+        else if (table_id == OB_ALL_SLOW_QUERY_TID)
+        {
+          if (NULL == sql_scan_param_ptr)
+          {
+            rc.result_code_ = OB_NOT_SUPPORTED;
+            TBSYS_LOG(WARN, "get method is not supported for all slow query table ");
+          }
+          else
+          {
+            // slow queries are kept by mergeservers, return an empty result
+            is_last_packet = true;
+            new_scanner->set_range(*sql_scan_param_ptr->get_range());
+            rc.result_code_ = ObSlowQueryLog::get_instance().get_scanner(
+              OB_CHUNKSERVER, chunk_server_->get_self(), *new_scanner);
+          }
+        }
         else
         {
           if (OB_SUCCESS == rc.result_code_)
@@ -1072,6 +1092,11 @@ namespace oceanbase
         // if scan return success , we can return scanner.
         if (OB_SUCCESS == rc.result_code_ && OB_SUCCESS == serialize_ret)
         {
+          // resource usage of producing the data of this packet
+          rpc_profile.server_time_ = tbsys::CTimeUtil::getTime() - packet_start_time;
+          new_scanner->set_rpc_profile(rpc_profile);
+          new_scanner->set_use_compact_row(sql_read_param_ptr->get_accept_compact_row());
+          rpc_profile.reset();
           serialize_ret = new_scanner->serialize(out_buffer.get_data(),
               out_buffer.get_capacity(), out_buffer.get_position());
           ups_data_version = new_scanner->get_data_version();
@@ -1126,6 +1151,7 @@ namespace oceanbase
           {
             response_cid = next_request->get_channel_id();
             req = next_request->get_request();
+            packet_start_time = tbsys::CTimeUtil::getTime();
             rc.result_code_ = sql_query_service->fill_scan_data(*new_scanner);
             if (OB_ITER_END == rc.result_code_)
             {
@@ -1531,9 +1557,9 @@ namespace oceanbase
 
       TBSYS_LOG(DEBUG,"cs_heart_beat,version:%d,CS_HEART_BEAT_VERSION:%d",version,CS_HEART_BEAT_VERSION);
 
+      int64_t frozen_version = 0;
       if (version >= CS_HEART_BEAT_VERSION)
       {
-        int64_t frozen_version = 0;
         if (OB_SUCCESS == rc.result_code_)
         {
           rc.result_code_ = common::serialization::decode_vi64(
@@ -1643,6 +1669,28 @@ namespace oceanbase
           }
         }
       }
+
+      if (version > CS_HEART_BEAT_VERSION + 1)
+      {
+        int64_t merge_released_group = 0;
+        if (OB_SUCCESS == rc.result_code_)
+        {
+          rc.result_code_ = serialization::decode_vi64(in_buffer.get_data(),
+                                                       in_buffer.get_capacity(),
+                                                       in_buffer.get_position(),
+                                                       &merge_released_group);
+          if (OB_SUCCESS != rc.result_code_)
+          {
+            TBSYS_LOG(ERROR, "parse heartbeat merge released group failed: ret[%d]",
+                      rc.result_code_);
+          }
+          else if (service_started_)
+          {
+            chunk_server_->get_tablet_manager().get_chunk_merge().release_merge_group(
+                frozen_version, merge_released_group);
+          }
+        }
+      }
       /*
       int serialize_ret = rc.serialize(out_buffer.get_data(),
           out_buffer.get_capacity(), out_buffer.get_position());
@@ -1670,6 +1718,7 @@ namespace oceanbase
         common::ObDataBuffer& out_buffer)
     {
       const int32_t CS_ACCEPT_SCHEMA_VERSION = 1;
+      const int32_t CS_ACCEPT_SCHEMA_DELTA_VERSION = 2;
       common::ObResultCode rc;
       rc.result_code_ = OB_SUCCESS;
       int &err = rc.result_code_;
@@ -1678,12 +1727,12 @@ namespace oceanbase
       int64_t schema_version = 0;
       int ret = OB_SUCCESS;
 
-      if (version != CS_ACCEPT_SCHEMA_VERSION)
+      if (version != CS_ACCEPT_SCHEMA_VERSION && version != CS_ACCEPT_SCHEMA_DELTA_VERSION)
       {
         err = OB_ERROR_FUNC_VERSION;
       }
 
-      if (OB_SUCCESS == err)
+      if (OB_SUCCESS == err && CS_ACCEPT_SCHEMA_VERSION == version)
       {
         if (NULL == (schema = OB_NEW(ObSchemaManagerV2, ObModIds::OB_CS_SERVICE_FUNC)))
         {
@@ -1701,7 +1750,27 @@ namespace oceanbase
         }
       }
 
-      if (OB_SUCCESS == err)
+      if (OB_SUCCESS == err && CS_ACCEPT_SCHEMA_DELTA_VERSION == version)
+      {
+        // only the tables changed since the latest version are sent
+        ObSchemaDelta delta;
+        if (OB_SUCCESS != (err = delta.deserialize(
+                in_buffer.get_data(), in_buffer.get_capacity(),
+                in_buffer.get_position())))
+        {
+          TBSYS_LOG(WARN, "fail to deserialize schema delta:err[%d]", err);
+        }
+        else if (OB_SUCCESS != (err = schema_manager->apply_delta(delta)))
+        {
+          TBSYS_LOG(WARN, "fail to apply schema delta:err[%d], base[%ld], version[%ld], latest[%ld]",
+              err, delta.get_base_version(), delta.get_version(), schema_manager->get_latest_version());
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "apply schema delta succ:%s", to_cstring(delta));
+        }
+      }
+      else if (OB_SUCCESS == err)
       {
         err = schema->deserialize(
               in_buffer.get_data(), in_buffer.get_capacity(),
@@ -1716,7 +1785,7 @@ namespace oceanbase
         }
       }
 
-      if (OB_SUCCESS == err)
+      if (OB_SUCCESS == err && CS_ACCEPT_SCHEMA_VERSION == version)
       {
         if (schema_version <= schema_manager->get_latest_version())
         {
@@ -2389,18 +2458,26 @@ namespace oceanbase
       int32_t dest_disk_no = 0;
       uint64_t crc_sum = 0;
       int64_t tablet_seq_num = 0;
+      ObFileTransferStat transfer_stat;
 
       ObMultiVersionTabletImage & tablet_image = tablet_manager.get_serving_tablet_image();
       if (OB_SUCCESS == rc.result_code_)
       {
         rc.result_code_ = tablet_manager.migrate_tablet(range,
             dest_server, src_path, dest_path, num_file, tablet_version,
-            tablet_seq_num, dest_disk_no, crc_sum);
+            tablet_seq_num, dest_disk_no, crc_sum, transfer_stat);
         if (OB_SUCCESS != rc.result_code_)
         {
           TBSYS_LOG(WARN, "ObTabletManager::migrate_tablet <%s> error, rc.result_code_=%d",
               to_cstring(range), rc.result_code_);
         }
+        else
+        {
+          TBSYS_LOG(INFO, "migrate tablet <%s> to %s, file_num=%ld bytes=%ld time=%ldus "
+              "sleep_time=%ldus speed=%ldKB/s", to_cstring(range), to_cstring(dest_server),
+              num_file, transfer_stat.bytes_, transfer_stat.time_us_,
+              transfer_stat.sleep_time_us_, transfer_stat.get_speed());
+        }
       }
 
 
@@ -2443,7 +2520,8 @@ namespace oceanbase
       if (OB_SUCCESS == rc.result_code_)
       {
         rc.result_code_= CS_RPC_CALL_RS(migrate_over, range,
-            chunk_server_->get_self(), dest_server, keep_src, tablet_version, tablet_seq_num);
+            chunk_server_->get_self(), dest_server, keep_src, tablet_version, tablet_seq_num,
+            transfer_stat.bytes_, transfer_stat.time_us_);
         if (OB_SUCCESS != rc.result_code_)
         {
           TBSYS_LOG(WARN, "report migrate tablet <%s> over error, rc.code=%d",
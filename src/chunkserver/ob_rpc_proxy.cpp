@@ -25,6 +25,7 @@
 #include "common/ob_schema_manager.h"
 #include "common/ob_statistics.h"
 #include "common/ob_common_stat.h"
+#include "common/ob_query_profile.h"
 
 namespace oceanbase
 {
@@ -1048,14 +1049,20 @@ namespace oceanbase
                     common::ObNewScanner & scanner,
                     const int64_t timeout /* = 0 */)
     {
-      return ups_get_(sql_rpc_stub_, get_param, scanner, common::MERGE_SERVER, timeout);
+      int64_t start_time = tbsys::CTimeUtil::getTime();
+      int ret = ups_get_(sql_rpc_stub_, get_param, scanner, common::MERGE_SERVER, timeout);
+      ObRpcProfile::add_ups_time(tbsys::CTimeUtil::getTime() - start_time);
+      return ret;
     }
 
     int ObMergerRpcProxy::sql_ups_scan(const common::ObScanParam & scan_param,
                      common::ObNewScanner & scanner,
                      const int64_t timeout /* = 0 */)
     {
-      return ups_scan_(sql_rpc_stub_, scan_param, scanner, common::MERGE_SERVER, timeout);
+      int64_t start_time = tbsys::CTimeUtil::getTime();
+      int ret = ups_scan_(sql_rpc_stub_, scan_param, scanner, common::MERGE_SERVER, timeout);
+      ObRpcProfile::add_ups_time(tbsys::CTimeUtil::getTime() - start_time);
+      return ret;
     }
 
   } // end namespace chunkserver
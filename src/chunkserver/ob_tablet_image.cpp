@@ -20,6 +20,7 @@
 #include "common/file_directory_utils.h"
 #include "common/ob_file.h"
 #include "common/ob_mod_define.h"
+#include "common/ob_merge_schedule.h"
 #include "sstable/ob_sstable_block_index_v2.h"
 #include "ob_tablet.h"
 #include "ob_disk_manager.h"
@@ -2505,8 +2506,17 @@ namespace oceanbase
 
     int ObMultiVersionTabletImage::get_tablets_for_merge(
         const int64_t version, int64_t &size, ObTablet *tablets[]) const
+    {
+      int64_t delayed_count = 0;
+      return get_tablets_for_merge(version, size, tablets, NULL, delayed_count);
+    }
+
+    int ObMultiVersionTabletImage::get_tablets_for_merge(
+        const int64_t version, int64_t &size, ObTablet *tablets[],
+        const ObMergeSchedule* schedule, int64_t &delayed_count) const
     {
       int ret = OB_SUCCESS;
+      delayed_count = 0;
 
       tbsys::CRLockGuard guard(lock_);
 
@@ -2527,7 +2537,16 @@ namespace oceanbase
           ObSortedVector<ObTablet*>::iterator it = tablet_list.begin();
           for (; it != tablet_list.end() && merge_count < size; ++it)
           {
-            if (!(*it)->is_merged())
+            if ((*it)->is_merged())
+            {
+              // merged already
+            }
+            else if (NULL != schedule
+                && !schedule->is_table_released((*it)->get_range().table_id_))
+            {
+              ++delayed_count;
+            }
+            else
             {
               tablets[merge_count++] = *it;
               // add reference count
@@ -2540,7 +2559,8 @@ namespace oceanbase
         index = (index + 1) % MAX_RESERVE_VERSION_COUNT;
       } while (index != eldest_index);
 
-      TBSYS_LOG(DEBUG, "for merge, version=%ld,size=%ld,newest=%ld", version, size, newest_index_);
+      TBSYS_LOG(DEBUG, "for merge, version=%ld,size=%ld,newest=%ld,delayed=%ld",
+          version, size, newest_index_, delayed_count);
 
       size = merge_count;
       return OB_SUCCESS;
@@ -30,6 +30,10 @@
 
 namespace oceanbase 
 { 
+  namespace common
+  {
+    class ObMergeSchedule;
+  }
   namespace chunkserver 
   {
     struct ObTabletMetaHeader
@@ -350,6 +354,14 @@ namespace oceanbase
          */
         int get_tablets_for_merge(const int64_t current_frozen_version, 
             int64_t &size, ObTablet *tablets[]) const;
+        /**
+         * same as above, but skip tablets of tables not released
+         * by merge %schedule yet.
+         * @param [out] delayed_count tablets skipped by %schedule
+         */
+        int get_tablets_for_merge(const int64_t current_frozen_version,
+            int64_t &size, ObTablet *tablets[],
+            const common::ObMergeSchedule* schedule, int64_t &delayed_count) const;
 
         /**
          * check if remains some tablets which has data version = %version
@@ -256,7 +256,8 @@ namespace oceanbase
                                         int64_t& tablet_version,
                                         int64_t& tablet_seq_num,
                                         int32_t& dest_disk_no,
-                                        uint64_t & crc_sum)
+                                        uint64_t & crc_sum,
+                                        common::ObFileTransferStat & transfer_stat)
     {
       int rc = OB_SUCCESS;
       ObMultiVersionTabletImage & tablet_image = get_serving_tablet_image();
@@ -395,7 +396,7 @@ namespace oceanbase
               static_cast<ObString::obstr_size_t>(strlen(dest_filename_buf)), dest_filename_buf);
 
           rc = file_client.send_file(timeout, band_limit, dest_server,
-              ob_src_path, ob_dest_dir, ob_dest_filename);
+              ob_src_path, ob_dest_dir, ob_dest_filename, &transfer_stat);
 
           if (OB_SUCCESS != rc)
           {
@@ -125,7 +125,8 @@ namespace oceanbase
             int64_t & tablet_version,
             int64_t& tablet_seq_num,
             int32_t & dest_disk_no,
-            uint64_t & crc_sum);
+            uint64_t & crc_sum,
+            common::ObFileTransferStat & transfer_stat);
 
         int dest_load_tablet(const common::ObNewRange& range,
             char (*dest_path)[common::OB_MAX_FILE_NAME_LENGTH],
@@ -20,6 +20,8 @@
 #include "common/file_directory_utils.h"
 #include "compactsstablev2/ob_sstable_store_struct.h"
 #include "compactsstablev2/ob_sstable_schema.h"
+#include "compactsstablev2/ob_compact_sstable_reader.h"
+#include "compactsstablev2/ob_sstable_block_index_mgr.h"
 #include "sql/ob_sql_scan_param.h"
 #include "ob_chunk_server_main.h"
 #include "ob_chunk_merge.h"
@@ -38,7 +40,8 @@ namespace oceanbase
      *-----------------------------------------------------------------------------*/
 
     ObTabletMergerV2::ObTabletMergerV2(ObChunkMerge& chunk_merge, ObTabletManager& manager) 
-      : ObTabletMerger(chunk_merge, manager)
+      : ObTabletMerger(chunk_merge, manager), merge_range_(NULL),
+      is_sub_range_merge_(false), sub_range_count_(0)
     {}
 
     int ObTabletMergerV2::init()
@@ -67,6 +70,11 @@ namespace oceanbase
       sstable_id_.sstable_file_id_ = 0;
       path_[0] = 0;
 
+      merge_range_ = NULL;
+      is_sub_range_merge_ = false;
+      sub_range_count_ = 0;
+      split_rowkey_arena_.reuse();
+
       sstable_schema_.reset();
       tablet_array_.clear();
 
@@ -79,7 +87,7 @@ namespace oceanbase
     }
 
     int ObTabletMergerV2::init_sstable_writer(const common::ObTableSchema & table_schema, 
-        const ObTablet* tablet, const int64_t frozen_version)
+        const ObTablet* tablet, const common::ObNewRange& range, const int64_t frozen_version)
     {
       int ret = OB_SUCCESS;
       compactsstablev2::ObFrozenMinorVersionRange version_range;
@@ -141,9 +149,9 @@ namespace oceanbase
             compressor_name, max_sstable_size, sstable_block_size);
       }
       else if (OB_SUCCESS != (ret = writer_.set_table_info(tablet->get_range().table_id_, 
-              sstable_schema_, tablet->get_range())))
+              sstable_schema_, range)))
       {
-        TBSYS_LOG(WARN, "set_table_info error, ret=%d, range=%s", ret, to_cstring(tablet->get_range()));
+        TBSYS_LOG(WARN, "set_table_info error, ret=%d, range=%s", ret, to_cstring(range));
       }
       else
       {
@@ -168,14 +176,15 @@ namespace oceanbase
             "max_sstable_size=%ld, min_split_sstable_size=%ld, sstable_block_size=%ld",
             sstable_id, tablet->get_data_version(), frozen_version,
             tablet->get_row_count(), tablet->get_occupy_size(), 
-            compressor_name, path, to_cstring(tablet->get_range()), 
+            compressor_name, path, to_cstring(range), 
             max_sstable_size, min_split_sstable_size, sstable_block_size);
       }
 
       return ret;
     }
 
-    int ObTabletMergerV2::prepare_merge(ObTablet *tablet, int64_t frozen_version)
+    int ObTabletMergerV2::prepare_merge(ObTablet *tablet, int64_t frozen_version,
+        const ObNewRange* sub_range)
     {
       int ret = OB_SUCCESS;
       ObTableSchema* table_schema = NULL;
@@ -202,7 +211,8 @@ namespace oceanbase
         TBSYS_LOG(ERROR, "convert table schema to sstable schema failed, table=%ld",
             tablet->get_range().table_id_);
       }
-      else if (OB_SUCCESS != (ret = init_sstable_writer(*table_schema, tablet, frozen_version)))
+      else if (OB_SUCCESS != (ret = init_sstable_writer(*table_schema, tablet,
+              NULL == sub_range ? tablet->get_range() : *sub_range, frozen_version)))
       {
         TBSYS_LOG(ERROR, "init_sstable_writer failed, ret=%d, table=%ld",
             ret, tablet->get_range().table_id_);
@@ -211,7 +221,8 @@ namespace oceanbase
       {
         old_tablet_ = tablet;
         frozen_version_ = frozen_version;
-
+        merge_range_ = NULL == sub_range ? &tablet->get_range() : sub_range;
+        is_sub_range_merge_ = (NULL != sub_range);
       }
       return ret;
     }
@@ -283,6 +294,7 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       bool is_tablet_unchanged = false;
       bool is_sstable_split = false;
+      bool is_parallel_merge = false;
       bool need_filter = tablet_merge_filter_.need_filter();
       /**
        * there are 2 cases that we cann't do "unmerge_if_unchanged"
@@ -291,9 +303,11 @@ namespace oceanbase
        * 2. need expire some data in this tablet
        * 3. the table need join another tables (in v2, TabletScan op do this job)
        * 4. the sub range of this tablet is splited(in v2, Writer do this job)
+       * 5. only a sub range of the tablet is merged
        */
       bool unmerge_if_unchanged =
-        (THE_CHUNK_SERVER.get_config().unmerge_if_unchanged && (!need_filter) );
+        (THE_CHUNK_SERVER.get_config().unmerge_if_unchanged && (!need_filter)
+         && !is_sub_range_merge_);
 
       if (OB_SUCCESS != (ret = wait_aio_buffer()))
       {
@@ -311,13 +325,18 @@ namespace oceanbase
         TBSYS_LOG(INFO, "tablet %s has no incremental data, finish.", to_cstring(old_tablet_->get_range()));
         ret = finish_sstable(false, true);
       }
+      else if (sub_range_count_ > 1)
+      {
+        // large tablet, merge sub ranges in parallel after scan closed.
+        is_parallel_merge = true;
+      }
       else if (OB_SUCCESS != (ret = create_new_sstable()))
       {
         TBSYS_LOG(ERROR,"create sstable failed.");
       }
 
       const ObRow *cur_row = NULL;
-      while (OB_SUCCESS == ret && !is_tablet_unchanged)
+      while (OB_SUCCESS == ret && !is_tablet_unchanged && !is_parallel_merge)
       {
         if ( manager_.is_stoped() )
         {
@@ -373,6 +392,142 @@ namespace oceanbase
       }
       CLEAR_TRACE_LOG();
 
+      if (OB_SUCCESS == ret && is_parallel_merge)
+      {
+        ret = parallel_merge();
+      }
+
+      return ret;
+    }
+
+    /**
+     * the sub ranges decide how the new sstables are cut, hence the
+     * checksum of every new tablet. replicas of a tablet must cut it the
+     * same way, so the decision only depends on:
+     * 1. the split parameters in the merge plan of the frozen version,
+     *    which rootserver gives to all chunkservers;
+     * 2. the old sstable: its size and its block index. replicas with
+     *    the same checksum of last version have the same sstable.
+     * it never depends on local config or load, and a failure to get
+     * the split points fails the merge of this tablet instead of merging
+     * it in another layout. whether sub ranges run on idle threads or
+     * one after another in current thread doesn't change the result.
+     */
+    int ObTabletMergerV2::split_sub_ranges()
+    {
+      int ret = OB_SUCCESS;
+      int64_t min_tablet_size = 0;
+      int64_t split_num = 0;
+      uint64_t table_id = old_tablet_->get_range().table_id_;
+      int64_t key_count = 0;
+      compactsstablev2::ObCompactSSTableReader* reader = NULL;
+      const compactsstablev2::ObSSTableTableIndex* table_index = NULL;
+      compactsstablev2::ObBlockIndexPositionInfo info;
+      ObNewRange sub_ranges[ObChunkMerge::MAX_SUB_MERGE_TASK];
+
+      sub_range_count_ = 0;
+      chunk_merge_.get_merge_split_param(min_tablet_size, split_num);
+      if (split_num > ObChunkMerge::MAX_SUB_MERGE_TASK)
+      {
+        split_num = ObChunkMerge::MAX_SUB_MERGE_TASK;
+      }
+
+      if (is_sub_range_merge_ || min_tablet_size <= 0 || split_num <= 1
+          || old_tablet_->get_occupy_size() < min_tablet_size)
+      {
+        // merge the whole tablet in current thread
+      }
+      else if (SSTableReader::COMPACT_SSTABLE_VERSION != old_tablet_->get_sstable_version()
+          || 1 != old_tablet_->get_sstable_reader_list().count()
+          || NULL == (reader = dynamic_cast<compactsstablev2::ObCompactSSTableReader*>(
+              old_tablet_->get_sstable_reader_list().at(0)))
+          || NULL == (table_index = reader->get_table_index(table_id)))
+      {
+        // same for all replicas, it's decided by the old sstable
+        TBSYS_LOG(INFO, "tablet %s is not in one compact sstable, merge it in one thread",
+            to_cstring(old_tablet_->get_range()));
+      }
+      else
+      {
+        info.sstable_file_id_ = reader->get_sstable_id();
+        info.index_offset_ = table_index->block_index_offset_;
+        info.index_size_ = table_index->block_index_size_;
+        info.endkey_offset_ = table_index->block_endkey_offset_;
+        info.endkey_size_ = table_index->block_endkey_size_;
+        info.block_count_ = table_index->block_count_;
+
+        if (OB_SUCCESS != (ret = manager_.get_compact_block_index_cache().get_split_rowkeys(
+                info, table_id, split_num, split_rowkey_arena_, split_rowkeys_, key_count)))
+        {
+          TBSYS_LOG(WARN, "get split rowkeys error, ret=%d, tablet=%s",
+              ret, to_cstring(old_tablet_->get_range()));
+        }
+        else if (key_count <= 0)
+        {
+          // too few blocks to split
+        }
+        else if (OB_SUCCESS != (ret = compactsstablev2::ObSSTableBlockIndexMgr::split_range(
+                old_tablet_->get_range(), split_rowkeys_, key_count, sub_ranges)))
+        {
+          TBSYS_LOG(WARN, "split range error, ret=%d, tablet=%s",
+              ret, to_cstring(old_tablet_->get_range()));
+        }
+        else
+        {
+          sub_range_count_ = key_count + 1;
+          for (int64_t i = 0; i < sub_range_count_; ++i)
+          {
+            ObSubMergeTask& task = sub_tasks_[i];
+            task.tablet_ = old_tablet_;
+            task.frozen_version_ = frozen_version_;
+            task.range_ = sub_ranges[i];
+            task.new_tablets_.clear();
+          }
+        }
+      }
+
+      return ret;
+    }
+
+    int ObTabletMergerV2::parallel_merge()
+    {
+      int ret = OB_SUCCESS;
+
+      TBSYS_LOG(INFO, "merge tablet %s in %ld sub ranges, occupy_size=%ld",
+          to_cstring(old_tablet_->get_range()), sub_range_count_,
+          old_tablet_->get_occupy_size());
+      if (OB_SUCCESS != (ret = chunk_merge_.push_sub_merge_tasks(sub_tasks_, sub_range_count_)))
+      {
+        TBSYS_LOG(WARN, "push sub merge tasks error, ret=%d", ret);
+      }
+      else
+      {
+        chunk_merge_.wait_sub_merge_tasks(sub_tasks_, sub_range_count_);
+
+        // new tablets of all sub ranges replace the old tablet together,
+        // and the sstables of finished sub ranges are cleaned up with
+        // tablet_array_ if any sub range failed.
+        for (int64_t i = 0; i < sub_range_count_; ++i)
+        {
+          ObSubMergeTask& task = sub_tasks_[i];
+          if (OB_SUCCESS != task.ret_)
+          {
+            TBSYS_LOG(WARN, "merge sub range %s error, ret=%d",
+                to_cstring(task.range_), task.ret_);
+            ret = task.ret_;
+          }
+          for (ObVector<ObTablet *>::iterator it = task.new_tablets_.begin();
+              it != task.new_tablets_.end(); ++it)
+          {
+            if (OB_SUCCESS != tablet_array_.push_back(*it))
+            {
+              TBSYS_LOG(WARN, "cannot push new_tablet=%p", *it);
+              ret = OB_ERROR;
+            }
+          }
+        }
+      }
+
       return ret;
     }
 
@@ -381,7 +536,7 @@ namespace oceanbase
       int ret = OB_SUCCESS;
 
       bool sync_meta = THE_CHUNK_SERVER.get_config().each_tablet_sync_meta;
-      if (OB_SUCCESS != (ret = prepare_merge(tablet, frozen_version)))
+      if (OB_SUCCESS != (ret = prepare_merge(tablet, frozen_version, NULL)))
       {
         TBSYS_LOG(WARN, "save merge info failed, ret=%d", ret);
       }
@@ -391,6 +546,10 @@ namespace oceanbase
         TBSYS_LOG(ERROR, "failed to initialize tablet merge filter, table=%ld",
             tablet->get_range().table_id_);
       }
+      else if (OB_SUCCESS != (ret = split_sub_ranges()))
+      {
+        TBSYS_LOG(WARN, "split_sub_ranges error, ret=%d", ret);
+      }
       else if (OB_SUCCESS != (ret = do_merge()))
       {
         TBSYS_LOG(WARN, "do_merge error, ret=%d", ret);
@@ -412,6 +571,49 @@ namespace oceanbase
       return ret;
     }
 
+    int ObTabletMergerV2::merge_sub_range(ObSubMergeTask& task)
+    {
+      int ret = OB_SUCCESS;
+
+      task.new_tablets_.clear();
+      if (OB_SUCCESS != (ret = prepare_merge(task.tablet_, task.frozen_version_, &task.range_)))
+      {
+        TBSYS_LOG(WARN, "save merge info failed, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = tablet_merge_filter_.init(chunk_merge_.current_schema_,
+                0, task.tablet_, task.frozen_version_, chunk_merge_.frozen_timestamp_)))
+      {
+        TBSYS_LOG(ERROR, "failed to initialize tablet merge filter, table=%ld",
+            task.range_.table_id_);
+      }
+      else if (OB_SUCCESS != (ret = do_merge()))
+      {
+        TBSYS_LOG(WARN, "do_merge error, ret=%d", ret);
+      }
+      else
+      {
+        for (ObVector<ObTablet *>::iterator it = tablet_array_.begin();
+            it != tablet_array_.end() && OB_SUCCESS == ret; ++it)
+        {
+          if (OB_SUCCESS != (ret = task.new_tablets_.push_back(*it)))
+          {
+            TBSYS_LOG(WARN, "cannot push new_tablet=%p", *it);
+          }
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        // merge failed, cleanup create sstable files;
+        cleanup_uncomplete_sstable_files();
+        task.new_tablets_.clear();
+      }
+
+      TBSYS_LOG(INFO, "finish merge sub range %s, ret=%d", to_cstring(task.range_), ret);
+
+      return ret;
+    }
+
     int ObTabletMergerV2::cleanup_uncomplete_sstable_files()
     {
       int64_t sstable_id = 0;
@@ -556,9 +758,9 @@ namespace oceanbase
       {
         TBSYS_LOG(ERROR, "set table id failed: [%d]",ret);
       }
-      else if (OB_SUCCESS != (ret = scan_param.set_range(old_tablet_->get_range())))
+      else if (OB_SUCCESS != (ret = scan_param.set_range(*merge_range_)))
       {
-        TBSYS_LOG(ERROR, "set range failed:[%d] range:%s", ret, to_cstring(old_tablet_->get_range()));
+        TBSYS_LOG(ERROR, "set range failed:[%d] range:%s", ret, to_cstring(*merge_range_));
       }
       else if (OB_SUCCESS != (ret = scan_param.set_project(project)))
       {
@@ -19,10 +19,12 @@
 #define OB_CHUNKSERVER_OB_TABLET_MERGER_V2_H_
 
 #include "common/ob_define.h"
+#include "common/page_arena.h"
 #include "compactsstablev2/ob_compact_sstable_writer.h"
 #include "compactsstablev2/ob_sstable_schema.h"
 #include "ob_tablet_merger_v1.h"
 #include "ob_tablet_merge_filter.h"
+#include "ob_chunk_merge.h"
 #include "sql/ob_tablet_scan.h"
 
 namespace oceanbase
@@ -41,7 +43,6 @@ namespace oceanbase
   {
     class ObTabletManager;
     class ObTablet;
-    class ObChunkMerge;
 
     class ObTabletMergerV2 : public ObTabletMerger
     {
@@ -52,12 +53,21 @@ namespace oceanbase
         virtual int init();
         virtual int merge(ObTablet *tablet, int64_t frozen_version);
 
+        /**
+         * merge one sub range of a large tablet, the new tablets are
+         * returned in %task, and applied by the merger of the whole
+         * tablet.
+         */
+        int merge_sub_range(ObSubMergeTask& task);
+
       private:
         DISALLOW_COPY_AND_ASSIGN(ObTabletMergerV2);
 
-        int prepare_merge(ObTablet *tablet, int64_t frozen_version);
+        int prepare_merge(ObTablet *tablet, int64_t frozen_version,
+            const common::ObNewRange* sub_range);
         int init_sstable_writer(const common::ObTableSchema & table_schema, 
-            const ObTablet* tablet, const int64_t frozen_version);
+            const ObTablet* tablet, const common::ObNewRange& range,
+            const int64_t frozen_version);
         
         int create_new_sstable();
         int create_hard_link_sstable();
@@ -73,11 +83,24 @@ namespace oceanbase
         int open();
         int do_merge();
 
+        int split_sub_ranges();
+        int parallel_merge();
+
         int build_extend_info(const bool is_tablet_unchanged, ObTabletExtendInfo& extend_info);
         int build_new_tablet(const bool is_tablet_unchanged, ObTablet* &tablet);
         int cleanup_uncomplete_sstable_files();
 
       private:
+        // range to merge, whole range of the old tablet or a sub range
+        const common::ObNewRange* merge_range_;
+        bool is_sub_range_merge_;
+
+        // sub ranges of large tablet merged in parallel
+        int64_t sub_range_count_;
+        common::PageArena<char> split_rowkey_arena_;
+        common::ObRowkey split_rowkeys_[ObChunkMerge::MAX_SUB_MERGE_TASK];
+        ObSubMergeTask sub_tasks_[ObChunkMerge::MAX_SUB_MERGE_TASK];
+
         compactsstablev2::ObSSTableSchema sstable_schema_;
 
         // for write merged new sstable
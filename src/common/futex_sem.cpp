@@ -65,9 +65,9 @@ namespace oceanbase
       else
       {
         ts->tv_nsec += time_ns;
-        if (ts->tv_nsec > NS_PER_SEC)
+        if (ts->tv_nsec >= NS_PER_SEC)
         {
-          ts->tv_sec += ts->tv_sec/NS_PER_SEC;
+          ts->tv_sec += ts->tv_nsec/NS_PER_SEC;
           ts->tv_nsec %= NS_PER_SEC;
         }
       }
@@ -121,6 +121,11 @@ namespace oceanbase
       return err;
     }
 
+    int futex_trywait(fsem_t* p)
+    {
+      return decrement_if_positive(&p->val_) > 0 ? 0 : EAGAIN;
+    }
+
     int futex_wait(fsem_t* p, const timespec* end_time)
     {
       int err = 0;
@@ -30,6 +30,8 @@ namespace oceanbase
     int futex_post(fsem_t* p);
     int futex_wait(fsem_t* p);
     int futex_wait(fsem_t* p, const timespec* end_time);
+    // never sleep, return EAGAIN if the sem is not positive
+    int futex_trywait(fsem_t* p);
   }; // end namespace common
 }; // end namespace oceanbase
 
@@ -82,6 +82,12 @@ namespace oceanbase
         static const int64_t TABLET_LOCATION_FIELD    = 89;
         // add for SQL
         static const int64_t SQL_DATA_VERSION        = 90;
+        /// server side resource usage of a sql read, see ObRpcProfile
+        static const int64_t SQL_RPC_PROFILE_FIELD   = 91;
+        /// rows of ObNewScanner in compact format, see ObCompactRowCodec
+        static const int64_t COMPACT_TABLE_PARAM_FIELD = 92;
+        /// sql read requester accepts COMPACT_TABLE_PARAM_FIELD in response
+        static const int64_t SQL_COMPACT_ROW_FIELD   = 93;
     };
   } /* common */
 } /* oceanbase */
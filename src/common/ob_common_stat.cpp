@@ -32,6 +32,8 @@ const char *ObStatSingleton::rs_map[] = {
   "all_tablet_count",
   "all_row_count",
   "all_data_size",
+  "migrate_bytes",
+  "migrate_time",
 };
 
 const char *ObStatSingleton::ups_map[] = {
@@ -71,6 +73,10 @@ const char *ObStatSingleton::ups_map[] = {
   "commit_log_id",
   "frozen_version",
 
+  "lock_wait_count",
+  "lock_wait_time",
+  "lock_wait_timeout_count",
+  "deadlock_count",
 };
 
 const char *ObStatSingleton::cs_map[] = {
@@ -116,6 +122,10 @@ const char *ObStatSingleton::sstable_map[] = {
   "sstable_row_cache_miss",
   "sstable_get_rows",
   "sstable_scan_rows",
+  "sstable_get_block_reuse",
+  "sstable_readahead_count",
+  "sstable_readahead_bytes",
+  "sstable_readahead_waste_bytes",
 };
 
 const char *ObStatSingleton::ms_map[] = {
@@ -160,6 +170,11 @@ const char *ObStatSingleton::sql_map[] = {
   "sql_drop_table_count",
 
   "sql_ps_allocator_count",
+
+  "sql_plan_cache_hit_count",
+  "sql_plan_cache_miss_count",
+  "sql_plan_cache_expire_count",
+  "sql_plan_cache_evict_count",
 };
 
 const char *ObStatSingleton::common_map[] = {
@@ -196,6 +211,8 @@ const char *ObStatSingleton::obmysql_map[] = {
   "sql_delete_time",
 
   "sql_query_bytes",
+  "sql_compressed_bytes",
+  "sql_multi_stmt_count",
 };
 
 
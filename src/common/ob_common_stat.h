@@ -40,6 +40,8 @@ namespace oceanbase
       INDEX_ALL_TABLET_COUNT,
       INDEX_ALL_ROW_COUNT,
       INDEX_ALL_DATA_SIZE,
+      INDEX_MIGRATE_BYTES,
+      INDEX_MIGRATE_TIMEU,
       ROOTSERVER_STAT_MAX,
     };
     /* updateserver */
@@ -82,6 +84,11 @@ namespace oceanbase
 
       UPS_STAT_FROZEN_VERSION,
 
+      UPS_STAT_LOCK_WAIT_COUNT,
+      UPS_STAT_LOCK_WAIT_TIMEU,
+      UPS_STAT_LOCK_WAIT_TIMEOUT_COUNT,
+      UPS_STAT_DEADLOCK_COUNT,
+
       UPDATESERVER_STAT_MAX,
     };
     /* chunkserver */
@@ -143,6 +150,15 @@ namespace oceanbase
       INDEX_SSTABLE_GET_ROWS,
       INDEX_SSTABLE_SCAN_ROWS,
 
+      // rows of a multi-get served by the block decoded for the previous row
+      INDEX_SSTABLE_GET_BLOCK_REUSE,
+
+      // disk reads of scans issued with a readahead window, bytes read
+      // by them and bytes read ahead but never used by the scan
+      INDEX_SSTABLE_READAHEAD_COUNT,
+      INDEX_SSTABLE_READAHEAD_BYTES,
+      INDEX_SSTABLE_READAHEAD_WASTE_BYTES,
+
       SSTABLE_STAT_MAX,
     };
     /* mergeserver */
@@ -206,6 +222,11 @@ namespace oceanbase
 
       SQL_PS_ALLOCATOR_COUNT,
 
+      SQL_PLAN_CACHE_HIT_COUNT,
+      SQL_PLAN_CACHE_MISS_COUNT,
+      SQL_PLAN_CACHE_EXPIRE_COUNT,
+      SQL_PLAN_CACHE_EVICT_COUNT,
+
       SQL_STAT_MAX,
     };
     /* obmysql */
@@ -239,6 +260,8 @@ namespace oceanbase
       SQL_DELETE_TIME,
 
       SQL_QUERY_BYTES,
+      SQL_COMPRESSED_BYTES,
+      SQL_MULTI_STMT_COUNT,
 
       OBMYSQL_STAT_MAX
     };
@@ -0,0 +1,548 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_compact_row_codec.cpp
+ *
+ */
+#include "tblog.h"
+#include "serialization.h"
+#include "ob_action_flag.h"
+#include "ob_cell_meta.h"
+#include "ob_compact_cell_iterator.h"
+#include "ob_compact_cell_writer.h"
+#include "ob_tc_malloc.h"
+#include "utility.h"
+#include "ob_compact_row_codec.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    namespace
+    {
+      // escapes written by ObCompactCellWriter::append_escape
+      bool get_escape(const ObObj &value, const uint64_t column_id, int64_t &escape)
+      {
+        bool ret = true;
+        int64_t ext = 0;
+        if (ObExtendType != value.get_type() || OB_INVALID_ID != column_id
+            || OB_SUCCESS != value.get_ext(ext))
+        {
+          ret = false;
+        }
+        else if (ObActionFlag::OP_END_ROW == ext)
+        {
+          escape = ObCellMeta::ES_END_ROW;
+        }
+        else if (ObActionFlag::OP_DEL_ROW == ext)
+        {
+          escape = ObCellMeta::ES_DEL_ROW;
+        }
+        else if (ObActionFlag::OP_NOP == ext)
+        {
+          escape = ObCellMeta::ES_NOP_ROW;
+        }
+        else if (ObActionFlag::OP_ROW_DOES_NOT_EXIST == ext)
+        {
+          escape = ObCellMeta::ES_NOT_EXIST_ROW;
+        }
+        else if (ObActionFlag::OP_NEW_ADD == ext)
+        {
+          escape = ObCellMeta::ES_NEW_ADD;
+        }
+        else if (ObActionFlag::OP_VALID == ext)
+        {
+          escape = ObCellMeta::ES_VALID;
+        }
+        else
+        {
+          ret = false;
+        }
+        return ret;
+      }
+
+      inline int64_t zigzag_delta(const int64_t value, const int64_t base)
+      {
+        uint64_t delta = static_cast<uint64_t>(value) - static_cast<uint64_t>(base);
+        return static_cast<int64_t>((delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63));
+      }
+
+      inline int64_t unzigzag_delta(const int64_t zigzag, const int64_t base)
+      {
+        uint64_t value = static_cast<uint64_t>(zigzag);
+        uint64_t delta = (value >> 1) ^ (0 - (value & 1));
+        return static_cast<int64_t>(static_cast<uint64_t>(base) + delta);
+      }
+    }
+
+    ObCompactRowCodec::ObCompactRowCodec()
+    {
+      reset_state();
+    }
+
+    ObCompactRowCodec::~ObCompactRowCodec()
+    {
+    }
+
+    void ObCompactRowCodec::reset_state()
+    {
+      for (int64_t i = 0; i < OB_ROW_MAX_COLUMNS_COUNT; ++i)
+      {
+        column_ids_[i] = OB_INVALID_ID;
+        int_values_[i] = 0;
+      }
+      if (dict_map_.created())
+      {
+        dict_map_.clear();
+      }
+      dict_.clear();
+    }
+
+    int ObCompactRowCodec::encode(const ObRowStore &row_store, const ObCompactStoreType store_type,
+        char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      int64_t new_pos = pos;
+      ObRowStore::CompactRowCursor cursor;
+      ObString compact_row;
+
+      reset_state();
+      if (NULL == buf || (SPARSE != store_type && DENSE_SPARSE != store_type))
+      {
+        ret = OB_INVALID_ARGUMENT;
+        TBSYS_LOG(WARN, "invalid argument, buf=%p, store_type=%d", buf, store_type);
+      }
+      else if (0 != row_store.get_reserved_column_count())
+      {
+        ret = OB_NOT_SUPPORTED;
+        TBSYS_LOG(WARN, "reserved cells can not be encoded, count=%ld",
+            row_store.get_reserved_column_count());
+      }
+      else if (!dict_map_.created() && OB_SUCCESS != (ret = dict_map_.create(DICT_BUCKET_NUM)))
+      {
+        TBSYS_LOG(WARN, "fail to create dictionary, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, new_pos, FORMAT_VERSION))
+          || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, new_pos, store_type)))
+      {
+        TBSYS_LOG(DEBUG, "buffer not enough for header, buf_len=%ld, pos=%ld", buf_len, new_pos);
+      }
+
+      while (OB_SUCCESS == ret
+          && OB_SUCCESS == (ret = row_store.get_next_compact_row(cursor, compact_row)))
+      {
+        ret = encode_row(compact_row, store_type, buf, buf_len, new_pos);
+      }
+      if (OB_ITER_END == ret)
+      {
+        ret = serialization::encode_i8(buf, buf_len, new_pos, TAG_END_STORE);
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        pos = new_pos;
+      }
+      return ret;
+    }
+
+    int ObCompactRowCodec::encode_row(const ObString &compact_row, const ObCompactStoreType store_type,
+        char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      ObCompactCellIterator cell_reader;
+      const ObObj *value = NULL;
+      uint64_t column_id = OB_INVALID_ID;
+      int64_t escape = 0;
+      int64_t slot = 0;
+      // DENSE_SPARSE row has an end row after rowkey
+      int64_t end_row_count = (DENSE_SPARSE == store_type) ? 2 : 1;
+
+      if (OB_SUCCESS != (ret = cell_reader.init(compact_row, store_type)))
+      {
+        TBSYS_LOG(WARN, "fail to init cell reader, ret=%d", ret);
+      }
+      while (OB_SUCCESS == ret && end_row_count > 0)
+      {
+        if (OB_SUCCESS != (ret = cell_reader.next_cell()))
+        {
+          TBSYS_LOG(WARN, "fail to get next cell, ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = cell_reader.get_cell(column_id, value)))
+        {
+          TBSYS_LOG(WARN, "fail to get cell, ret=%d", ret);
+        }
+        else if (!get_escape(*value, column_id, escape))
+        {
+          ret = encode_cell(slot++, column_id, *value, buf, buf_len, pos);
+        }
+        else if (ObCellMeta::ES_END_ROW == escape)
+        {
+          ret = serialization::encode_i8(buf, buf_len, pos, TAG_END_ROW);
+          --end_row_count;
+        }
+        else if (OB_SUCCESS == (ret = serialization::encode_i8(buf, buf_len, pos, TAG_ESCAPE)))
+        {
+          ret = serialization::encode_i8(buf, buf_len, pos, static_cast<int8_t>(escape));
+        }
+      }
+      return ret;
+    }
+
+    int ObCompactRowCodec::encode_cell(const int64_t slot, const uint64_t column_id, const ObObj &value,
+        char *buf, const int64_t buf_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      int8_t tag = 0;
+      int64_t int_value = 0;
+      int64_t index = -1;
+      ObString varchar;
+
+      if (slot >= OB_ROW_MAX_COLUMNS_COUNT)
+      {
+        ret = OB_SIZE_OVERFLOW;
+        TBSYS_LOG(WARN, "too many cells in row, slot=%ld", slot);
+      }
+      else
+      {
+        switch (value.get_type())
+        {
+          case ObNullType:
+            tag = TAG_NULL;
+            break;
+          case ObIntType:
+            tag = TAG_INT;
+            ret = value.get_int(int_value);
+            break;
+          case ObDateTimeType:
+            tag = TAG_DATETIME;
+            ret = value.get_datetime(int_value);
+            break;
+          case ObPreciseDateTimeType:
+            tag = TAG_PRECISE_DATETIME;
+            ret = value.get_precise_datetime(int_value);
+            break;
+          case ObCreateTimeType:
+            tag = TAG_CREATE_TIME;
+            ret = value.get_createtime(int_value);
+            break;
+          case ObModifyTimeType:
+            tag = TAG_MODIFY_TIME;
+            ret = value.get_modifytime(int_value);
+            break;
+          case ObVarcharType:
+            if (OB_SUCCESS == (ret = value.get_varchar(varchar)))
+            {
+              ret = lookup_dict(varchar, tag, index);
+            }
+            break;
+          default:
+            tag = TAG_OBJ;
+            break;
+        }
+        if (TAG_INT <= tag && TAG_PRECISE_DATETIME >= tag && value.get_add_fast())
+        {
+          tag = static_cast<int8_t>(tag | TAG_ADD);
+        }
+        if (column_id != column_ids_[slot])
+        {
+          tag = static_cast<int8_t>(tag | TAG_COLUMN_ID);
+        }
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "fail to get cell value, value=%s, ret=%d", to_cstring(value), ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_i8(buf, buf_len, pos, tag)))
+      {
+        TBSYS_LOG(DEBUG, "buffer not enough, buf_len=%ld, pos=%ld", buf_len, pos);
+      }
+      else if ((tag & TAG_COLUMN_ID)
+          && OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, static_cast<int64_t>(column_id))))
+      {
+        TBSYS_LOG(DEBUG, "buffer not enough, buf_len=%ld, pos=%ld", buf_len, pos);
+      }
+      else
+      {
+        column_ids_[slot] = column_id;
+        switch (tag & TAG_MASK)
+        {
+          case TAG_NULL:
+            break;
+          case TAG_VARCHAR:
+          case TAG_VARCHAR_NEW:
+            ret = serialization::encode_vstr(buf, buf_len, pos, varchar.ptr(), varchar.length());
+            break;
+          case TAG_VARCHAR_REF:
+            ret = serialization::encode_vi64(buf, buf_len, pos, index);
+            break;
+          case TAG_OBJ:
+            ret = value.serialize(buf, buf_len, pos);
+            break;
+          default:
+            ret = serialization::encode_vi64(buf, buf_len, pos, zigzag_delta(int_value, int_values_[slot]));
+            int_values_[slot] = int_value;
+            break;
+        }
+      }
+      return ret;
+    }
+
+    int ObCompactRowCodec::lookup_dict(const ObString &value, int8_t &tag, int64_t &index)
+    {
+      int ret = OB_SUCCESS;
+      tag = TAG_VARCHAR;
+      if (value.length() > 0 && value.length() <= MAX_DICT_STRING_LENGTH)
+      {
+        if (hash::HASH_EXIST == dict_map_.get(value, index))
+        {
+          tag = TAG_VARCHAR_REF;
+        }
+        else if (dict_map_.size() < MAX_DICT_SIZE)
+        {
+          index = dict_map_.size();
+          if (hash::HASH_INSERT_SUCC != dict_map_.set(value, index))
+          {
+            ret = OB_ERROR;
+            TBSYS_LOG(WARN, "fail to add string to dictionary, size=%ld", index);
+          }
+          else
+          {
+            tag = TAG_VARCHAR_NEW;
+          }
+        }
+      }
+      return ret;
+    }
+
+    int ObCompactRowCodec::decode(const char *buf, const int64_t data_len, int64_t &pos,
+        ObRowStore &row_store, int64_t &cur_size_counter)
+    {
+      int ret = OB_SUCCESS;
+      int64_t new_pos = pos;
+      int64_t version = 0;
+      int64_t store_type = 0;
+      int8_t tag = 0;
+      const int64_t row_buf_len = ObTSIBlockAllocator::BIG_BLOCK_SIZE;
+      char *row_buf = NULL;
+      ObString compact_row;
+
+      reset_state();
+      if (NULL == buf)
+      {
+        ret = OB_INVALID_ARGUMENT;
+        TBSYS_LOG(WARN, "invalid argument, buf=%p", buf);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, new_pos, &version))
+          || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, new_pos, &store_type)))
+      {
+        TBSYS_LOG(WARN, "fail to decode header, data_len=%ld, pos=%ld, ret=%d", data_len, new_pos, ret);
+      }
+      else if (FORMAT_VERSION != version || (SPARSE != store_type && DENSE_SPARSE != store_type))
+      {
+        ret = OB_NOT_SUPPORTED;
+        TBSYS_LOG(WARN, "unknown compact row format, version=%ld, store_type=%ld", version, store_type);
+      }
+      else if (NULL == (row_buf = static_cast<char*>(ob_tc_malloc(row_buf_len, ObModIds::OB_NEW_SCANNER))))
+      {
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+        TBSYS_LOG(ERROR, "no memory");
+      }
+
+      while (OB_SUCCESS == ret)
+      {
+        if (OB_SUCCESS != (ret = serialization::decode_i8(buf, data_len, new_pos, &tag)))
+        {
+          TBSYS_LOG(WARN, "fail to decode tag, data_len=%ld, pos=%ld, ret=%d", data_len, new_pos, ret);
+        }
+        else if (TAG_END_STORE == tag)
+        {
+          break;
+        }
+        else if (OB_SUCCESS != (ret = decode_row(tag, buf, data_len, new_pos,
+                static_cast<ObCompactStoreType>(store_type), row_buf, row_buf_len, compact_row)))
+        {
+          TBSYS_LOG(WARN, "fail to decode row, data_len=%ld, pos=%ld, ret=%d", data_len, new_pos, ret);
+        }
+        else if (OB_SUCCESS != (ret = row_store.add_compact_row(compact_row, cur_size_counter)))
+        {
+          TBSYS_LOG(WARN, "fail to add compact row, ret=%d", ret);
+        }
+      }
+
+      if (NULL != row_buf)
+      {
+        ob_tc_free(row_buf, ObModIds::OB_NEW_SCANNER);
+      }
+      if (OB_SUCCESS == ret)
+      {
+        pos = new_pos;
+      }
+      return ret;
+    }
+
+    int ObCompactRowCodec::decode_row(int8_t tag, const char *buf, const int64_t data_len, int64_t &pos,
+        const ObCompactStoreType store_type, char *row_buf, const int64_t row_buf_len,
+        ObString &compact_row)
+    {
+      int ret = OB_SUCCESS;
+      ObCompactCellWriter cell_writer;
+      ObObj value;
+      uint64_t column_id = OB_INVALID_ID;
+      int8_t escape = 0;
+      int64_t slot = 0;
+      int64_t end_row_count = (DENSE_SPARSE == store_type) ? 2 : 1;
+
+      if (OB_SUCCESS != (ret = cell_writer.init(row_buf, row_buf_len, store_type)))
+      {
+        TBSYS_LOG(WARN, "fail to init cell writer, ret=%d", ret);
+      }
+      while (OB_SUCCESS == ret)
+      {
+        switch (tag & TAG_MASK)
+        {
+          case TAG_END_ROW:
+            ret = cell_writer.row_finish();
+            --end_row_count;
+            break;
+          case TAG_ESCAPE:
+            if (OB_SUCCESS == (ret = serialization::decode_i8(buf, data_len, pos, &escape)))
+            {
+              ret = cell_writer.append_escape(escape);
+            }
+            break;
+          default:
+            if (OB_SUCCESS == (ret = decode_cell(tag, slot++, buf, data_len, pos, column_id, value)))
+            {
+              ret = cell_writer.append(column_id, value);
+            }
+            break;
+        }
+        if (OB_SUCCESS != ret || 0 == end_row_count)
+        {
+          break;
+        }
+        ret = serialization::decode_i8(buf, data_len, pos, &tag);
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        compact_row.assign_ptr(row_buf, static_cast<ObString::obstr_size_t>(cell_writer.size()));
+      }
+      return ret;
+    }
+
+    int ObCompactRowCodec::decode_cell(const int8_t tag, const int64_t slot, const char *buf,
+        const int64_t data_len, int64_t &pos, uint64_t &column_id, ObObj &value)
+    {
+      int ret = OB_SUCCESS;
+      int64_t int_value = 0;
+      int64_t index = 0;
+      const char *str = NULL;
+      const bool is_add = (0 != (tag & TAG_ADD));
+
+      if (slot >= OB_ROW_MAX_COLUMNS_COUNT)
+      {
+        ret = OB_SIZE_OVERFLOW;
+        TBSYS_LOG(WARN, "too many cells in row, slot=%ld", slot);
+      }
+      else if ((tag & TAG_COLUMN_ID)
+          && OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &int_value)))
+      {
+        TBSYS_LOG(WARN, "fail to decode column id, ret=%d", ret);
+      }
+      else
+      {
+        if (tag & TAG_COLUMN_ID)
+        {
+          column_ids_[slot] = static_cast<uint64_t>(int_value);
+        }
+        column_id = column_ids_[slot];
+
+        switch (tag & TAG_MASK)
+        {
+          case TAG_NULL:
+            value.set_null();
+            break;
+          case TAG_VARCHAR:
+          case TAG_VARCHAR_NEW:
+            if (NULL == (str = serialization::decode_vstr(buf, data_len, pos, &int_value)))
+            {
+              ret = OB_DESERIALIZE_ERROR;
+              TBSYS_LOG(WARN, "fail to decode varchar, data_len=%ld, pos=%ld", data_len, pos);
+            }
+            else
+            {
+              value.set_varchar(ObString(0, static_cast<ObString::obstr_size_t>(int_value), str));
+              if (TAG_VARCHAR_NEW == (tag & TAG_MASK))
+              {
+                ret = dict_.push_back(ObString(0, static_cast<ObString::obstr_size_t>(int_value), str));
+              }
+            }
+            break;
+          case TAG_VARCHAR_REF:
+            if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &index)))
+            {
+              TBSYS_LOG(WARN, "fail to decode dictionary index, ret=%d", ret);
+            }
+            else if (index < 0 || index >= dict_.count())
+            {
+              ret = OB_DESERIALIZE_ERROR;
+              TBSYS_LOG(WARN, "invalid dictionary index=%ld, size=%ld", index, dict_.count());
+            }
+            else
+            {
+              value.set_varchar(dict_.at(index));
+            }
+            break;
+          case TAG_OBJ:
+            ret = value.deserialize(buf, data_len, pos);
+            break;
+          case TAG_INT:
+          case TAG_DATETIME:
+          case TAG_PRECISE_DATETIME:
+          case TAG_CREATE_TIME:
+          case TAG_MODIFY_TIME:
+            if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &int_value)))
+            {
+              TBSYS_LOG(WARN, "fail to decode int value, ret=%d", ret);
+            }
+            else
+            {
+              int_values_[slot] = unzigzag_delta(int_value, int_values_[slot]);
+              switch (tag & TAG_MASK)
+              {
+                case TAG_INT:
+                  value.set_int(int_values_[slot], is_add);
+                  break;
+                case TAG_DATETIME:
+                  value.set_datetime(int_values_[slot], is_add);
+                  break;
+                case TAG_PRECISE_DATETIME:
+                  value.set_precise_datetime(int_values_[slot], is_add);
+                  break;
+                case TAG_CREATE_TIME:
+                  value.set_createtime(int_values_[slot]);
+                  break;
+                default:
+                  value.set_modifytime(int_values_[slot]);
+                  break;
+              }
+            }
+            break;
+          default:
+            ret = OB_DESERIALIZE_ERROR;
+            TBSYS_LOG(WARN, "unknown cell tag=%d", tag);
+            break;
+        }
+      }
+      return ret;
+    }
+  } // end namespace common
+} // end namespace oceanbase
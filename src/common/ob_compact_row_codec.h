@@ -0,0 +1,109 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_compact_row_codec.h
+ *
+ * Compact wire format of the rows in an ObRowStore, used by
+ * ObNewScanner when the requester accepts it. Every cell is a one byte
+ * tag followed by an optional column id and the value:
+ *   - column id is only sent when it differs from the cell at the same
+ *     position of the previous row, so the row description is sent once
+ *   - int and time values are sent as zigzag varint delta from the cell
+ *     at the same position of the previous row
+ *   - short varchars are put into a dictionary and sent as index when
+ *     they are seen again
+ *   - other types fall back to ObObj serialization
+ */
+#ifndef OCEANBASE_COMMON_OB_COMPACT_ROW_CODEC_H_
+#define OCEANBASE_COMMON_OB_COMPACT_ROW_CODEC_H_
+
+#include "ob_define.h"
+#include "ob_string.h"
+#include "ob_object.h"
+#include "ob_array.h"
+#include "ob_row_store.h"
+#include "ob_compact_store_type.h"
+#include "hash/ob_hashmap.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObCompactRowCodec
+    {
+      public:
+        static const int64_t FORMAT_VERSION = 1;
+        static const int64_t MAX_DICT_SIZE = 64 * 1024L;
+        static const int64_t MAX_DICT_STRING_LENGTH = 128;
+        static const int64_t DICT_BUCKET_NUM = 1024;
+
+      public:
+        ObCompactRowCodec();
+        ~ObCompactRowCodec();
+
+        /**
+         * encode all rows of %row_store, which are written in
+         * %store_type (SPARSE or DENSE_SPARSE)
+         *
+         * caller can fall back to ObRowStore::serialize on any error,
+         * e.g. %buf is too small.
+         */
+        int encode(const ObRowStore &row_store, const ObCompactStoreType store_type,
+            char *buf, const int64_t buf_len, int64_t &pos);
+
+        /// decode rows encoded by encode() and add them to %row_store
+        int decode(const char *buf, const int64_t data_len, int64_t &pos,
+            ObRowStore &row_store, int64_t &cur_size_counter);
+
+      private:
+        enum CellTag
+        {
+          TAG_END_ROW = 0,
+          TAG_ESCAPE = 1,
+          TAG_NULL = 2,
+          TAG_INT = 3,
+          TAG_DATETIME = 4,
+          TAG_PRECISE_DATETIME = 5,
+          TAG_CREATE_TIME = 6,
+          TAG_MODIFY_TIME = 7,
+          TAG_VARCHAR = 8,
+          TAG_VARCHAR_NEW = 9,
+          TAG_VARCHAR_REF = 10,
+          TAG_OBJ = 11,
+          TAG_END_STORE = 15,
+        };
+        static const int8_t TAG_MASK = 0x0f;
+        static const int8_t TAG_COLUMN_ID = 0x10;
+        static const int8_t TAG_ADD = 0x20;
+        typedef hash::ObHashMap<ObString, int64_t, hash::NoPthreadDefendMode> DictMap;
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObCompactRowCodec);
+        void reset_state();
+        int encode_row(const ObString &compact_row, const ObCompactStoreType store_type,
+            char *buf, const int64_t buf_len, int64_t &pos);
+        int encode_cell(const int64_t slot, const uint64_t column_id, const ObObj &value,
+            char *buf, const int64_t buf_len, int64_t &pos);
+        int lookup_dict(const ObString &value, int8_t &tag, int64_t &index);
+        int decode_row(int8_t tag, const char *buf, const int64_t data_len, int64_t &pos,
+            const ObCompactStoreType store_type, char *row_buf, const int64_t row_buf_len,
+            ObString &compact_row);
+        int decode_cell(const int8_t tag, const int64_t slot, const char *buf,
+            const int64_t data_len, int64_t &pos, uint64_t &column_id, ObObj &value);
+
+      private:
+        uint64_t column_ids_[OB_ROW_MAX_COLUMNS_COUNT];
+        int64_t int_values_[OB_ROW_MAX_COLUMNS_COUNT];
+        DictMap dict_map_;
+        ObArray<ObString> dict_;
+    };
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif //OCEANBASE_COMMON_OB_COMPACT_ROW_CODEC_H_
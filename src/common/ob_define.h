@@ -208,6 +208,7 @@ namespace oceanbase
     const int OB_UPS_CHANGE_MASTER_TIMEOUT = -2009;
     const int OB_FORCE_TIME_OUT = -2010;
     const int OB_BEGIN_TRANS_LOCKED = -2011;
+    const int OB_UPS_LOCK_WAIT = -2012;         // 行锁冲突 事务挂入行锁等待队列
 
     //error code for root server -3001 ---- -4000
     const int OB_ERROR_TIME_STAMP = -3001;
@@ -231,6 +232,7 @@ namespace oceanbase
     const int OB_CHUNK_SERVER_ERROR = -4008;   // chunk server cached is error
     const int OB_NO_NEW_SCHEMA = -4009;        // no new schema when parse error
     const int OB_MS_SUB_REQ_TOO_MANY = -4010; // too many sub scan request
+    const int OB_SCHEMA_DELTA_MISMATCH = -4011; // schema delta base version mismatch
 
     // SQL specific error code, -5000 ~ -6000
     const int OB_ERR_SQL_START = -5000;
@@ -313,6 +315,7 @@ namespace oceanbase
     const uint64_t OB_MAX_VALID_COLUMN_ID = 10240;   // user table max valid column id
     const int64_t OB_MAX_TABLE_NUMBER = 2048;
     const int64_t OB_MAX_JOIN_INFO_NUMBER = 10;
+    const int64_t OB_MAX_INDEX_TABLE_NUMBER = 8; // max index tables of one data table
     const int64_t OB_MAX_ROW_KEY_LENGTH = 16384; // 16KB
     const int64_t OB_MAX_ROW_KEY_SPLIT = 32;
     const int64_t OB_MAX_ROWKEY_COLUMN_NUMBER = 16;
@@ -430,6 +433,9 @@ namespace oceanbase
     const uint64_t OB_APP_MIN_COLUMN_ID = 16;
     const uint64_t OB_ACTION_FLAG_COLUMN_ID = OB_ALL_MAX_COLUMN_ID - OB_END_RESERVED_COLUMN_ID_NUM + 1; /* 65520 */
     const uint64_t OB_MAX_TMP_COLUMN_ID = OB_ALL_MAX_COLUMN_ID - OB_END_RESERVED_COLUMN_ID_NUM;
+    // old value of column cid carried by update/delete for index maintenance is
+    // output as column cid + OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET
+    const uint64_t OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET = OB_MAX_VALID_COLUMN_ID;
     // internal columns name
     //extern const char *OB_CREATE_TIME_COLUMN_NAME;
     //extern const char *OB_MODIFY_TIME_COLUMN_NAME;
@@ -440,6 +446,7 @@ namespace oceanbase
     const char* const OB_ALL_COLUMN_TABLE_NAME = "__all_all_column";
     const char* const OB_ALL_JOININFO_TABLE_NAME = "__all_join_info";
     const char* const OB_ALL_SERVER_STAT_TABLE_NAME = "__all_server_stat";
+    const char* const OB_ALL_SLOW_QUERY_TABLE_NAME = "__all_slow_query";
     const char* const OB_ALL_SYS_PARAM_TABLE_NAME = "__all_sys_param";
     const char* const OB_ALL_SYS_CONFIG_TABLE_NAME = "__all_sys_config";
     const char* const OB_ALL_SYS_STAT_TABLE_NAME = "__all_sys_stat";
@@ -485,6 +492,7 @@ namespace oceanbase
     static const uint64_t OB_PARAMETERS_SHOW_TID = 507;
     static const uint64_t OB_SERVER_STATUS_SHOW_TID = 508;
     static const uint64_t OB_ALL_SERVER_STAT_TID = 509;
+    static const uint64_t OB_ALL_SLOW_QUERY_TID = 510;
     static const uint64_t OB_APP_MIN_TABLE_ID = 1000;
 
 #define IS_SHOW_TABLE(tid) ((tid) >= OB_TABLES_SHOW_TID && (tid) <= OB_SERVER_STATUS_SHOW_TID)
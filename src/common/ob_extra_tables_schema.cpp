@@ -1125,3 +1125,126 @@ int ObExtraTablesSchema::all_server_stat_schema(TableSchema & table_schema)
       false); //is nullable
   return ret;
 }
+
+int ObExtraTablesSchema::all_slow_query_schema(TableSchema & table_schema)
+{
+  int ret = OB_SUCCESS;
+
+  table_schema.init_as_inner_table();
+  strcpy(table_schema.table_name_, OB_ALL_SLOW_QUERY_TABLE_NAME);
+  table_schema.table_id_ = OB_ALL_SLOW_QUERY_TID;
+  table_schema.rowkey_column_num_ = 4;
+  table_schema.max_used_column_id_ = OB_APP_MIN_COLUMN_ID + 17;
+  table_schema.max_rowkey_length_ = TEMP_ROWKEY_LENGTH;
+
+  int column_id = OB_APP_MIN_COLUMN_ID;
+  ADD_COLUMN_SCHEMA("svr_type", //column_name
+      column_id ++, //column_id
+      1, //rowkey_id
+      ObVarcharType,  //column_type
+      SERVER_TYPE_LENGTH, //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("svr_ip", //column_name
+      column_id ++, //column_id
+      2, //rowkey_id
+      ObVarcharType,  //column_type
+      SERVER_IP_LENGTH, //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("svr_port", //column_name
+      column_id ++, //column_id
+      3, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("seq", //column_name
+      column_id ++, //column_id
+      4, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("trace_id", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObVarcharType,  //column_type
+      32, //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("start_time", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObPreciseDateTimeType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("elapsed_time", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("cpu_time", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("row_count", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("rpc_count", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("rpc_time", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("server_time", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("ups_time", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("block_cache_hit", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("block_cache_miss", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("io_bytes", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObIntType,  //column_type
+      sizeof(int64_t), //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("query", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObVarcharType,  //column_type
+      512, //column length
+      false); //is nullable
+  ADD_COLUMN_SCHEMA("plan_profile", //column_name
+      column_id ++, //column_id
+      0, //rowkey_id
+      ObVarcharType,  //column_type
+      2048, //column length
+      false); //is nullable
+  return ret;
+}
@@ -5,9 +5,121 @@
 using namespace oceanbase;
 using namespace oceanbase::common;
 
+ObFileBlockReadAhead::ObFileBlockReadAhead():
+  ObReadAhead(BLOCK_NUM), file_reader_(NULL), file_size_(0), block_size_(0),
+  read_offset_(0), read_crc_(0)
+{
+  memset(blocks_, 0, sizeof(blocks_));
+}
+
+ObFileBlockReadAhead::~ObFileBlockReadAhead()
+{
+  stop();
+  for (int64_t i = 0; i < BLOCK_NUM; i++)
+  {
+    if (NULL != blocks_[i].buf_)
+    {
+      ob_free(blocks_[i].buf_);
+      blocks_[i].buf_ = NULL;
+    }
+  }
+}
+
+int ObFileBlockReadAhead::start(ObFileReader &file_reader,
+    const int64_t file_size, const int64_t block_size)
+{
+  int ret = OB_SUCCESS;
+
+  if (NULL != file_reader_)
+  {
+    TBSYS_LOG(WARN, "read ahead has been started");
+    ret = OB_INIT_TWICE;
+  }
+  else if (file_size < 0 || block_size <= 0)
+  {
+    TBSYS_LOG(WARN, "invalid param file_size[%ld] block_size[%ld]",
+        file_size, block_size);
+    ret = OB_INVALID_ARGUMENT;
+  }
+
+  for (int64_t i = 0; OB_SUCCESS == ret && i < BLOCK_NUM; i++)
+  {
+    blocks_[i].buf_ = reinterpret_cast<char *>(ob_malloc(block_size, ObModIds::OB_FILE_CLIENT));
+    if (NULL == blocks_[i].buf_)
+    {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      TBSYS_LOG(WARN, "Allocate memory for block buffer failed:ret[%d]", ret);
+    }
+  }
+
+  if (OB_SUCCESS == ret)
+  {
+    file_reader_ = &file_reader;
+    file_size_ = file_size;
+    block_size_ = block_size;
+    read_offset_ = 0;
+    read_crc_ = 0;
+    ret = ObReadAhead::start();
+  }
+
+  return ret;
+}
+
+int ObFileBlockReadAhead::next_block(const Block *&block)
+{
+  int ret = OB_SUCCESS;
+  int64_t slot_idx = 0;
+
+  if (OB_SUCCESS == (ret = next_slot(slot_idx)))
+  {
+    block = &blocks_[slot_idx];
+  }
+
+  return ret;
+}
+
+int ObFileBlockReadAhead::fill_slot(const int64_t slot_idx, bool &filled)
+{
+  int ret = OB_SUCCESS;
+  Block &block = blocks_[slot_idx];
+
+  filled = false;
+  if (read_offset_ >= file_size_)
+  {
+    ret = OB_ITER_END;
+  }
+  else
+  {
+    block.offset_ = read_offset_;
+    block.size_ = 0;
+    ret = file_reader_->pread(block.buf_, block_size_, read_offset_, block.size_);
+    if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(WARN, "Read file block failed:offset[%ld] ret[%d]", read_offset_, ret);
+    }
+    else if (block.size_ <= 0 || read_offset_ + block.size_ > file_size_)
+    {
+      TBSYS_LOG(WARN, "file size changed while reading:offset[%ld] read_size[%ld] "
+          "file_size[%ld]", read_offset_, block.size_, file_size_);
+      ret = OB_ERR_UNEXPECTED;
+    }
+    else
+    {
+      // chain the crc of all blocks, crc of the last block is crc of the whole file
+      read_crc_ = ob_crc64(read_crc_, block.buf_, block.size_);
+      block.crc_ = read_crc_;
+      read_offset_ += block.size_;
+      filled = true;
+    }
+  }
+
+  return ret;
+}
+
 ObFileClient::ObFileClient():
   inited_(false), client_(NULL),
-  rpc_buffer_(NULL), block_size_(ObFileService::BLOCK_SIZE),band_limit_(0)
+  rpc_buffer_(NULL), block_size_(ObFileService::BLOCK_SIZE),band_limit_(0),
+  load_probe_(NULL)
 {
 }
 
@@ -57,6 +169,11 @@ int ObFileClient::initialize(ThreadSpecificBuffer *rpc_buffer,
 
 }
 
+void ObFileClient::set_load_probe(const ObFileClientLoadProbe *load_probe)
+{
+  load_probe_ = load_probe;
+}
+
 int ObFileClient::get_rpc_buffer(ObDataBuffer& data_buffer) const
 {
   int ret = OB_SUCCESS;
@@ -148,26 +265,13 @@ int ObFileClient::send_file_pre(const int64_t timeout,
 }
 
 int ObFileClient::send_file_block(const int64_t timeout,
-    const ObServer& dest_server, ObFileReader& file_reader, char *buf,
-    const int64_t offset, int64_t& read_size,
+    const ObServer& dest_server, const ObFileBlockReadAhead::Block& block,
     ObDataBuffer& in_buffer, ObDataBuffer& out_buffer,const int64_t session_id)
 {
-  int err = OB_SUCCESS;
-
-  //FILL_TRACE_LOG("Start send block");
-  // read file data to buf
-  err = file_reader.pread(buf, block_size_, offset, read_size);
-  if (OB_SUCCESS != err)
-  {
-    TBSYS_LOG(WARN, "Read file block failed");
-  }
-
-  //FILL_TRACE_LOG("End file_reader.pread");
-
   ObResultCode rc;
   int ret = OB_SUCCESS;
 
-  rc.result_code_ = err;
+  rc.result_code_ = OB_SUCCESS;
   in_buffer.get_position() = 0;
   out_buffer.get_position() = 0;
 
@@ -184,20 +288,32 @@ int ObFileClient::send_file_block(const int64_t timeout,
   if (OB_SUCCESS == ret)
   {
     ret = serialization::encode_i64(in_buffer.get_data(),
-        in_buffer.get_capacity(), in_buffer.get_position(), offset);
+        in_buffer.get_capacity(), in_buffer.get_position(), block.offset_);
     if (OB_SUCCESS != ret)
     {
-      TBSYS_LOG(WARN, "Encode offset failed:offset[%ld], ret[%d]", offset, ret);
+      TBSYS_LOG(WARN, "Encode offset failed:offset[%ld], ret[%d]", block.offset_, ret);
     }
   }
   if (OB_SUCCESS == ret)
   {
     ret = serialization::encode_vstr(in_buffer.get_data(),
-        in_buffer.get_capacity(), in_buffer.get_position(), buf, read_size);
+        in_buffer.get_capacity(), in_buffer.get_position(), block.buf_, block.size_);
     if (OB_SUCCESS != ret)
     {
       TBSYS_LOG(WARN, "Encode block buf failed:ret[%d], "
-          "offset[%ld] read_size[%ld]", ret, offset, read_size);
+          "offset[%ld] read_size[%ld]", ret, block.offset_, block.size_);
+    }
+  }
+  // crc of the file data up to this block, the receiver checks it
+  // incrementally, old receivers ignore it.
+  if (OB_SUCCESS == ret)
+  {
+    ret = serialization::encode_i64(in_buffer.get_data(),
+        in_buffer.get_capacity(), in_buffer.get_position(),
+        static_cast<int64_t>(block.crc_));
+    if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(WARN, "Encode block crc failed:ret[%d]", ret);
     }
   }
 
@@ -229,18 +345,14 @@ int ObFileClient::send_file_block(const int64_t timeout,
           rc.result_code_);
     }
   }
-  //FILL_TRACE_LOG("End decode");
-  if (OB_SUCCESS != err)
-  {
-    ret = err;
-  }
 
   return ret;
 }
 
 int ObFileClient::send_file_end(const int64_t timeout,
-    const ObServer& dest_server, ObDataBuffer& in_buffer,
-    ObDataBuffer& out_buffer,const int64_t session_id)
+    const ObServer& dest_server, const uint64_t file_crc,
+    ObDataBuffer& in_buffer, ObDataBuffer& out_buffer,
+    const int64_t session_id)
 {
   int ret = OB_SUCCESS;
   ObResultCode rc;
@@ -255,6 +367,12 @@ int ObFileClient::send_file_end(const int64_t timeout,
     TBSYS_LOG(WARN, "Encode rc failed:rc.result_code_[%d], ret[%d]",
         rc.result_code_, ret);
   }
+  else if (OB_SUCCESS != (ret = serialization::encode_i64(in_buffer.get_data(),
+          in_buffer.get_capacity(), in_buffer.get_position(),
+          static_cast<int64_t>(file_crc))))
+  {
+    TBSYS_LOG(WARN, "Encode file crc failed:ret[%d]", ret);
+  }
 
   if (OB_SUCCESS == ret)
   {
@@ -283,18 +401,41 @@ int ObFileClient::send_file_end(const int64_t timeout,
   return ret;
 }
 
+int64_t ObFileClient::get_adaptive_band_limit(const int64_t band_limit) const
+{
+  int64_t ret = band_limit;
+  if (NULL != load_probe_)
+  {
+    int64_t percent = 100 - load_probe_->get_load_percent();
+    if (percent < MIN_ADAPTIVE_BAND_PERCENT)
+    {
+      percent = MIN_ADAPTIVE_BAND_PERCENT;
+    }
+    else if (percent > 100)
+    {
+      percent = 100;
+    }
+    ret = band_limit * percent / 100;
+    if (ret <= 0)
+    {
+      ret = 1;
+    }
+  }
+  return ret;
+}
+
 int ObFileClient::send_file_loop(const int64_t timeout,
     const int64_t band_limit_in, const ObServer& dest_server,
     const ObString& local_path, const ObString& dest_dir,
-    const ObString& dest_file_name)
+    const ObString& dest_file_name, ObFileTransferStat *transfer_stat)
 {
   int64_t t1 = tbsys::CTimeUtil::getTime();
 
   ObFileReader file_reader;
+  ObFileBlockReadAhead read_ahead;
   ObDataBuffer in_buffer;
   ObDataBuffer out_buffer;
   int64_t file_size = -1;
-  char *block_buffer = NULL;
   int64_t session_id = 0;
   int ret = OB_SUCCESS;
   int64_t band_limit = band_limit_in;
@@ -325,16 +466,6 @@ int ObFileClient::send_file_loop(const int64_t timeout,
     ret = get_rpc_buffer(out_buffer);
   }
 
-  if (OB_SUCCESS == ret)
-  {
-    block_buffer = reinterpret_cast<char *>(ob_malloc(block_size_, ObModIds::OB_FILE_CLIENT));
-    if (NULL == block_buffer)
-    {
-      ret = OB_ALLOCATE_MEMORY_FAILED;
-      TBSYS_LOG(WARN, "Allocate memory for block buffer failed:ret[%d]", ret);
-    }
-  }
-
   // get file size
   if (OB_SUCCESS == ret)
   {
@@ -374,69 +505,85 @@ int ObFileClient::send_file_loop(const int64_t timeout,
     }
   }
 
+  // start reading blocks ahead while the first block is in flight
+  if (OB_SUCCESS == ret)
+  {
+    ret = read_ahead.start(file_reader, file_size, block_size_);
+    if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(WARN, "start read ahead failed: ret[%d]", ret);
+    }
+  }
+
   //FILL_TRACE_LOG("End send_file_pre");
   // do send file loop
+  const ObFileBlockReadAhead::Block *block = NULL;
   int64_t offset = 0;
-  int64_t read_size = -1;
+  uint64_t file_crc = 0;
   int64_t start_time_us = 0;
   int64_t sleep_time_us = 0;
   int64_t cost_time_us = 0;
   int64_t total_sleep_time_us = 0;
   int64_t total_cost_time_us = 0;
+  int64_t cur_band_limit = band_limit;
 
   while(OB_SUCCESS == ret)
   {
     //FILL_TRACE_LOG("Send_file_block=%ld", offset);
     start_time_us = tbsys::CTimeUtil::getTime();
-    ret = send_file_block(timeout, dest_server, file_reader, block_buffer,
-        offset, read_size, in_buffer, out_buffer, session_id);
-    if (OB_SUCCESS != ret)
+    ret = read_ahead.next_block(block);
+    if (OB_ITER_END == ret)
     {
-      TBSYS_LOG(ERROR, "failed to send file block to server[%s] offset[%ld] "
-          "read_size[%ld] session_id[%ld]",
-          dest_server.to_cstring(), offset, read_size, session_id);
-    }
-    else
-    {
-      offset += read_size;
-      if (read_size > 0)
+      if (offset != file_size)
       {
-        cost_time_us = tbsys::CTimeUtil::getTime() - start_time_us;
-        sleep_time_us = 1000000L*read_size/1024/band_limit - cost_time_us;
-        total_cost_time_us += cost_time_us;
-
-        if (sleep_time_us > 0)
-        {
-          total_sleep_time_us += sleep_time_us;
-          usleep(static_cast<useconds_t>(sleep_time_us));
-        }
+        ret = OB_ERR_UNEXPECTED;
+        TBSYS_LOG(WARN, "Send file offset error [%ld] "
+            "should be equal to [%ld].[%.*s]",
+            offset, file_size, local_path.length(), local_path.ptr());
       }
-
-      if (offset == file_size)
+      else
       {
         // send the finish notify to dest server
         //FILL_TRACE_LOG("Start send_file_end");
-        ret = send_file_end(timeout, dest_server, in_buffer, out_buffer, session_id);
+        ret = send_file_end(timeout, dest_server, file_crc, in_buffer, out_buffer, session_id);
         if (OB_SUCCESS != ret)
         {
           TBSYS_LOG(ERROR, "failed to send_file_end:ret=[%d]", ret);
         }
-        break; // end of send file
       }
-      else if(offset > file_size)
+      break; // end of send file
+    }
+    else if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(ERROR, "failed to read file block offset[%ld] ret[%d]",
+          offset, ret);
+    }
+    else if (OB_SUCCESS != (ret = send_file_block(timeout, dest_server, *block,
+            in_buffer, out_buffer, session_id)))
+    {
+      TBSYS_LOG(ERROR, "failed to send file block to server[%s] offset[%ld] "
+          "read_size[%ld] session_id[%ld]",
+          dest_server.to_cstring(), block->offset_, block->size_, session_id);
+    }
+    else
+    {
+      offset += block->size_;
+      file_crc = block->crc_;
+      // the band limit is lowered when foreground requests are queued up
+      cur_band_limit = get_adaptive_band_limit(band_limit);
+      cost_time_us = tbsys::CTimeUtil::getTime() - start_time_us;
+      sleep_time_us = 1000000L*block->size_/1024/cur_band_limit - cost_time_us;
+      total_cost_time_us += cost_time_us;
+
+      if (sleep_time_us > 0)
       {
-        ret = OB_ERR_UNEXPECTED;
-        TBSYS_LOG(WARN, "Send file offset error [%ld] "
-            "should not larger than [%ld].[%.*s]",
-            offset, file_size, local_path.length(), local_path.ptr());
+        total_sleep_time_us += sleep_time_us;
+        usleep(static_cast<useconds_t>(sleep_time_us));
       }
     }
   }
 
-  if (NULL != block_buffer)
-  {
-    ob_free(block_buffer);
-  }
+  read_ahead.stop();
 
   if (file_reader.is_opened())
   {
@@ -455,12 +602,19 @@ int ObFileClient::send_file_loop(const int64_t timeout,
   if (OB_SUCCESS == ret)
   {
     TBSYS_LOG(INFO, "Send file local_path[%.*s] to dest_server[%s] dest_dir[%.*s] "
-        "dest_file_name[%.*s] filesize[%ld] time[%ld]us work_time[%ld] sleep_time[%ld] speed[%ld]KB/s",
+        "dest_file_name[%.*s] filesize[%ld] crc[%lu] time[%ld]us work_time[%ld] "
+        "sleep_time[%ld] speed[%ld]KB/s last_band_limit[%ld]",
         local_path.length(), local_path.ptr(), dest_server.to_cstring(),
         dest_dir.length(), dest_dir.ptr(),
         dest_file_name.length(), dest_file_name.ptr(),
-        file_size, duration, total_cost_time_us, total_sleep_time_us,
-        file_size*1000000L/1024/duration);
+        file_size, file_crc, duration, total_cost_time_us, total_sleep_time_us,
+        file_size*1000000L/1024/duration, cur_band_limit);
+    if (NULL != transfer_stat)
+    {
+      transfer_stat->bytes_ += file_size;
+      transfer_stat->time_us_ += duration;
+      transfer_stat->sleep_time_us_ += total_sleep_time_us;
+    }
   }
   else
   {
@@ -477,7 +631,8 @@ int ObFileClient::send_file_loop(const int64_t timeout,
 
 int ObFileClient::send_file(const int64_t timeout, const int64_t band_limit,
     const ObServer& dest_server, const ObString& local_path,
-    const ObString& dest_dir, const ObString& dest_file_name)
+    const ObString& dest_dir, const ObString& dest_file_name,
+    ObFileTransferStat *transfer_stat)
 {
   int ret = OB_SUCCESS;
 
@@ -491,7 +646,7 @@ int ObFileClient::send_file(const int64_t timeout, const int64_t band_limit,
   if (OB_SUCCESS == ret)
   {
     ret = send_file_loop(timeout, band_limit, dest_server, local_path,
-        dest_dir, dest_file_name);
+        dest_dir, dest_file_name, transfer_stat);
   }
   //PRINT_TRACE_LOG();
 
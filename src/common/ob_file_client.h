@@ -3,6 +3,7 @@
 
 #include <sys/stat.h>
 #include <sys/statvfs.h>
+#include <pthread.h>
 #include <tbsys.h>
 #include "ob_file.h"
 #include "ob_file_service.h"
@@ -10,11 +11,86 @@
 #include "ob_string.h"
 #include "ob_result.h"
 #include "utility.h"
+#include "ob_read_ahead.h"
 
 namespace oceanbase
 {
   namespace common
   {
+    // statistics of one or several file transfers
+    struct ObFileTransferStat
+    {
+      int64_t bytes_;
+      int64_t time_us_;
+      int64_t sleep_time_us_;
+
+      ObFileTransferStat() : bytes_(0), time_us_(0), sleep_time_us_(0) {}
+      void reset()
+      {
+        bytes_ = 0;
+        time_us_ = 0;
+        sleep_time_us_ = 0;
+      }
+      void add(const ObFileTransferStat &other)
+      {
+        bytes_ += other.bytes_;
+        time_us_ += other.time_us_;
+        sleep_time_us_ += other.sleep_time_us_;
+      }
+      // KB/s
+      int64_t get_speed() const
+      {
+        return (0 < time_us_) ? bytes_ * 1000000L / 1024 / time_us_ : 0;
+      }
+    };
+
+    // tell the file client how busy the foreground service is,
+    // the band limit of file transfer is lowered as the load goes up
+    class ObFileClientLoadProbe
+    {
+    public:
+      virtual ~ObFileClientLoadProbe() {}
+      // @return load in percent, [0, 100]
+      virtual int64_t get_load_percent() const = 0;
+    };
+
+    // read the blocks of a local file ahead in a separate thread,
+    // so that the disk read of next blocks is overlapped with the
+    // network transfer of current block.
+    class ObFileBlockReadAhead : public ObReadAhead
+    {
+    public:
+      static const int64_t BLOCK_NUM = 4;
+      struct Block
+      {
+        char *buf_;
+        int64_t offset_;
+        int64_t size_;
+        uint64_t crc_;    // crc of the file data from offset 0 to the end of this block
+      };
+
+    public:
+      ObFileBlockReadAhead();
+      ~ObFileBlockReadAhead();
+
+    public:
+      int start(ObFileReader &file_reader, const int64_t file_size, const int64_t block_size);
+      // get next block in file order, the block is valid until next call
+      // @return OB_ITER_END if all blocks have been returned
+      int next_block(const Block *&block);
+
+    protected:
+      virtual int fill_slot(const int64_t slot_idx, bool &filled);
+
+    private:
+      ObFileReader *file_reader_;
+      int64_t file_size_;
+      int64_t block_size_;
+      Block blocks_[BLOCK_NUM];
+      int64_t read_offset_;
+      uint64_t read_crc_;
+    };
+
     class ObFileClient
     {
     public:
@@ -25,6 +101,9 @@ namespace oceanbase
       int initialize(common::ThreadSpecificBuffer * rpc_buffer, 
           common::ObClientManager * client, const int64_t band_limit);
 
+      // set the probe of foreground load, NULL means never adapt band limit
+      void set_load_probe(const ObFileClientLoadProbe *load_probe);
+
     public:
       // upload a file to a file server
       // param @timeout         the timeout limit for each packet transaction
@@ -33,10 +112,12 @@ namespace oceanbase
       //       @local_path      the path of local file
       //       @dest_dir the    the path of the remote dir
       //       @dest_file_name  the name of the remote file
+      //       @transfer_stat   add the statistics of this transfer if not NULL
       //
       int send_file(const int64_t timeout, const int64_t band_limit, 
           const ObServer& dest_server, const ObString& local_path, 
-          const ObString& dest_dir, const ObString& dest_file_name);
+          const ObString& dest_dir, const ObString& dest_file_name,
+          ObFileTransferStat *transfer_stat = NULL);
 
     private:
       int get_rpc_buffer(ObDataBuffer & data_buffer) const;
@@ -47,17 +128,20 @@ namespace oceanbase
           ObDataBuffer& out_buffer,int64_t& session_id);
 
       int send_file_block(const int64_t timeout, const ObServer& dest_server,
-          ObFileReader& file_reader, char *buf, const int64_t offset, 
-          int64_t& read_size, ObDataBuffer& in_buffer, 
-          ObDataBuffer& out_buffer,const int64_t session_id);
-
-      int send_file_end(const int64_t timeout, const ObServer& dest_server,
+          const ObFileBlockReadAhead::Block& block,
           ObDataBuffer& in_buffer, ObDataBuffer& out_buffer,
           const int64_t session_id);
 
+      int send_file_end(const int64_t timeout, const ObServer& dest_server,
+          const uint64_t file_crc, ObDataBuffer& in_buffer,
+          ObDataBuffer& out_buffer, const int64_t session_id);
+
       int send_file_loop(const int64_t timeout, const int64_t band_limit, 
           const ObServer& dest_server, const ObString& local_path, 
-          const ObString& dest_dir, const ObString& dest_file_name);
+          const ObString& dest_dir, const ObString& dest_file_name,
+          ObFileTransferStat *transfer_stat);
+
+      int64_t get_adaptive_band_limit(const int64_t band_limit) const;
 
 
     private:
@@ -66,9 +150,12 @@ namespace oceanbase
       common::ThreadSpecificBuffer * rpc_buffer_;   // rpc thread buffer
       int64_t block_size_;
       int64_t band_limit_;
+      const ObFileClientLoadProbe *load_probe_;
 
       static const int32_t MAX_CONCURRENCY_COUNT = 128;
       static const int64_t MIN_BAND_LIMIT = 1024;
+      // the band limit never goes below this percent of the configured one
+      static const int64_t MIN_ADAPTIVE_BAND_PERCENT = 10;
       static const int32_t DEFAULT_VERSION = 1;
     };
   }
@@ -1,4 +1,5 @@
 #include "ob_file_service.h"
+#include "ob_crc64.h"
 
 using namespace oceanbase;
 using namespace oceanbase::common;
@@ -452,9 +453,11 @@ int ObFileService::receive_file_pre(ObFileAppender& file_appender,
 
 int ObFileService::receive_file_block(ObFileAppender& file_appender,
     char* block_buf, easy_request_t* request, ObDataBuffer& in_buffer,
-    ObDataBuffer& out_buffer, int32_t & response_cid, const int64_t session_id)
+    ObDataBuffer& out_buffer, int32_t & response_cid, const int64_t session_id,
+    int64_t& recv_size, uint64_t& file_crc, int& write_err)
 {
-  int err = OB_SUCCESS;
+  // report the failure of writing last block
+  int err = write_err;
   int64_t offset;
   int64_t read_size = -1;
   //FILL_TRACE_LOG("Start receive_file_block");
@@ -466,6 +469,12 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
     {
       TBSYS_LOG(WARN, "Decode offset failed: err=[%d]", err);
     }
+    else if (offset != recv_size)
+    {
+      TBSYS_LOG(ERROR, "block offset[%ld] is not equal to received size[%ld]",
+          offset, recv_size);
+      err = OB_INVALID_DATA;
+    }
   }
   if (OB_SUCCESS == err)
   {
@@ -477,18 +486,29 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
       TBSYS_LOG(WARN, "Decode block failed");
     }
   }
-  //FILL_TRACE_LOG("decode end");
-  // write file block
+  // check crc of the file data up to this block, old clients do not send it
+  uint64_t crc = 0;
   if (OB_SUCCESS == err)
   {
-    const bool is_fsync = false;
-    err = file_appender.append(block_buf, read_size, is_fsync);
-    if (OB_SUCCESS != err)
+    crc = ob_crc64(file_crc, block_buf, read_size);
+    if (in_buffer.get_position() < in_buffer.get_capacity())
     {
-      TBSYS_LOG(WARN, "Appender file block failed:err=[%d]", err);
+      int64_t expect_crc = 0;
+      err = serialization::decode_i64(in_buffer.get_data(),
+          in_buffer.get_capacity(), in_buffer.get_position(), &expect_crc);
+      if (OB_SUCCESS != err)
+      {
+        TBSYS_LOG(WARN, "Decode block crc failed: err=[%d]", err);
+      }
+      else if (static_cast<uint64_t>(expect_crc) != crc)
+      {
+        TBSYS_LOG(ERROR, "crc of block offset[%ld] size[%ld] mismatch: expect[%lu] real[%lu]",
+            offset, read_size, static_cast<uint64_t>(expect_crc), crc);
+        err = OB_CHECKSUM_ERROR;
+      }
     }
   }
-  //FILL_TRACE_LOG("append end");
+  //FILL_TRACE_LOG("decode end");
   // send response
   ObResultCode rc;
   int ret = OB_SUCCESS;
@@ -523,6 +543,22 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
   }
 
   //FILL_TRACE_LOG("send response end");
+  // write file block while the sender is transferring next block
+  if (OB_SUCCESS == ret && OB_SUCCESS == err)
+  {
+    const bool is_fsync = false;
+    write_err = file_appender.append(block_buf, read_size, is_fsync);
+    if (OB_SUCCESS != write_err)
+    {
+      TBSYS_LOG(WARN, "Appender file block failed:err=[%d]", write_err);
+    }
+    else
+    {
+      recv_size += read_size;
+      file_crc = crc;
+    }
+  }
+  //FILL_TRACE_LOG("append end");
   if (OB_SUCCESS == ret && OB_SUCCESS != err)
   {
     ret = err;
@@ -532,17 +568,22 @@ int ObFileService::receive_file_block(ObFileAppender& file_appender,
 
 
 int ObFileService::receive_file_end(ObString& file_path, ObString& tmp_file_path,
-    const int64_t file_size, easy_request_t* request, ObDataBuffer& out_buffer,
-    int32_t& response_cid, const int64_t session_id)
+    const int64_t file_size, const int prev_err, easy_request_t* request,
+    ObDataBuffer& out_buffer, int32_t& response_cid, const int64_t session_id)
 {
-  int ret = OB_SUCCESS;
+  int ret = prev_err;
 
   struct stat file_stat;
   char tmp_path_buf[OB_MAX_FILE_NAME_LENGTH];
   char path_buf[OB_MAX_FILE_NAME_LENGTH];
   int n = snprintf(tmp_path_buf, OB_MAX_FILE_NAME_LENGTH, "%.*s",
       tmp_file_path.length(), tmp_file_path.ptr());
-  if (n<0 || n>=OB_MAX_FILE_NAME_LENGTH)
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(ERROR, "receive file [%.*s] failed before end, ret[%d]",
+        tmp_file_path.length(), tmp_file_path.ptr(), ret);
+  }
+  else if (n<0 || n>=OB_MAX_FILE_NAME_LENGTH)
   {
     TBSYS_LOG(ERROR, "failed to get tmp_file_path length[%d] [%.*s]",
         n, tmp_file_path.length(), tmp_file_path.ptr());
@@ -633,6 +674,9 @@ int ObFileService::receive_file_loop(ObString& file_path, ObString& tmp_file_pat
   }
   // do receive file loop
   ObDataBuffer *in_buffer = NULL;
+  int64_t recv_size = 0;
+  uint64_t file_crc = 0;
+  int write_err = OB_SUCCESS;
   while(OB_SUCCESS == ret)
   {
     ret = queue_thread_->wait_for_next_request(session_id, next_request,
@@ -679,7 +723,8 @@ int ObFileService::receive_file_loop(ObString& file_path, ObString& tmp_file_pat
       if (OB_SUCCESS == rc.result_code_) // receive file block
       {
         ret = receive_file_block(file_appender, block_buf, request,
-            *in_buffer, out_buffer, response_cid, session_id);
+            *in_buffer, out_buffer, response_cid, session_id,
+            recv_size, file_crc, write_err);
         if (OB_SUCCESS != ret)
         {
           TBSYS_LOG(ERROR, "failed to receive_file_block");
@@ -692,8 +737,28 @@ int ObFileService::receive_file_loop(ObString& file_path, ObString& tmp_file_pat
         {
           file_appender.close();
         }
+        // check crc of the whole file, old clients do not send it
+        int end_err = write_err;
+        if (OB_SUCCESS == end_err
+            && in_buffer->get_position() < in_buffer->get_capacity())
+        {
+          int64_t expect_crc = 0;
+          end_err = serialization::decode_i64(in_buffer->get_data(),
+              in_buffer->get_capacity(), in_buffer->get_position(), &expect_crc);
+          if (OB_SUCCESS != end_err)
+          {
+            TBSYS_LOG(WARN, "Decode file crc failed: err=[%d]", end_err);
+          }
+          else if (static_cast<uint64_t>(expect_crc) != file_crc)
+          {
+            TBSYS_LOG(ERROR, "crc of file [%.*s] mismatch: expect[%lu] real[%lu]",
+                tmp_file_path.length(), tmp_file_path.ptr(),
+                static_cast<uint64_t>(expect_crc), file_crc);
+            end_err = OB_CHECKSUM_ERROR;
+          }
+        }
         //FILL_TRACE_LOG("receive_file_end");
-        ret = receive_file_end(file_path, tmp_file_path, file_size,
+        ret = receive_file_end(file_path, tmp_file_path, file_size, end_err,
             request, out_buffer, response_cid, session_id);
         if (OB_SUCCESS != ret)
         {
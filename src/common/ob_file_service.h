@@ -53,12 +53,16 @@ namespace oceanbase
           easy_request_t* request, ObDataBuffer& in_buffer, 
           ObDataBuffer& out_buffer, int32_t& response_cid, const int64_t session_id);
 
+      // the block is acknowledged before it is written to disk, so the
+      // sender can transfer next block meanwhile, the result of writing
+      // is returned by write_err and reported with next response.
       int receive_file_block(ObFileAppender& file_appender, char* buf,
           easy_request_t* request, ObDataBuffer& in_buffer,
-          ObDataBuffer& out_buffer, int32_t& response_cid, const int64_t session_id);
+          ObDataBuffer& out_buffer, int32_t& response_cid, const int64_t session_id,
+          int64_t& recv_size, uint64_t& file_crc, int& write_err);
 
       int receive_file_end(ObString& file_path, ObString& tmp_file_path, const int64_t file_size,
-          easy_request_t* request, ObDataBuffer& out_buffer, 
+          const int prev_err, easy_request_t* request, ObDataBuffer& out_buffer,
           int32_t& response_cid, const int64_t session_id);
 
       int receive_file_loop(ObString& file_path, ObString& tmp_file_path, const int64_t file_size,
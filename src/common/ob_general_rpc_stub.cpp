@@ -30,6 +30,7 @@
 #include "ob_strings.h"
 #include "ob_mutator.h"
 #include "ob_ups_info.h"
+#include "ob_merge_schedule.h"
 #include "location/ob_tablet_location_list.h"
 #include "sql/ob_ups_result.h"
 #include "sql/ob_physical_plan.h"
@@ -381,11 +382,41 @@ namespace oceanbase
         const common::ObServer &dest_server,
         const bool keep_src,
         const int64_t tablet_version,
-        const int64_t tablet_seq_num)
+        const int64_t tablet_seq_num,
+        const int64_t migrate_bytes,
+        const int64_t migrate_time_us)
     {
       const int32_t CS_MIGRATE_OVER_VERSION = 2;
-      return send_6_return_0(root_server, timeout, OB_MIGRATE_OVER, CS_MIGRATE_OVER_VERSION,
-          range, src_server, dest_server, keep_src, tablet_version, tablet_seq_num);
+      int ret = OB_SUCCESS;
+      int64_t pos = 0;
+      ObResultCode rc;
+      ObDataBuffer data_buffer;
+      if (OB_SUCCESS != (ret = get_rpc_buffer(data_buffer)))
+      {
+        TBSYS_LOG(WARN, "get_rpc_buffer failed with rpc call, ret =%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialize_param_6(data_buffer,
+              range, src_server, dest_server, keep_src, tablet_version, tablet_seq_num)))
+      {
+        TBSYS_LOG(WARN, "serialize migrate over param failed, ret=%d", ret);
+      }
+      // statistics of the transfer are appended, old rootservers ignore them
+      else if (OB_SUCCESS != (ret = serialize_param_2(data_buffer, migrate_bytes, migrate_time_us)))
+      {
+        TBSYS_LOG(WARN, "serialize migrate statistics failed, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = rpc_frame_->send_request(
+              root_server, OB_MIGRATE_OVER, CS_MIGRATE_OVER_VERSION, timeout, data_buffer)))
+      {
+        TBSYS_LOG(WARN, "send_request failed, ret=%d, server=%s, timeout=%ld",
+            ret, to_cstring(root_server), timeout);
+      }
+      else if (OB_SUCCESS != (ret = deserialize_result_0(data_buffer, pos, rc)))
+      {
+        TBSYS_LOG(WARN, "deserialize_result failed, ret=%d, server=%s",
+            ret, to_cstring(root_server));
+      }
+      return ret;
     }
 
     int ObGeneralRpcStub::report_capacity_info(
@@ -899,5 +930,14 @@ namespace oceanbase
       return ret;
     }
 
+    int ObGeneralRpcStub::get_merge_schedule(const int64_t timeout,
+                                             const ObServer &root_server,
+                                             const int64_t frozen_version,
+                                             ObMergeSchedule &schedule) const
+    {
+      return send_1_return_1(root_server, timeout, OB_RS_GET_MERGE_SCHEDULE,
+                             DEFAULT_VERSION, frozen_version, schedule);
+    }
+
   } // end namespace chunkserver
 } // end namespace oceanbase
@@ -43,6 +43,7 @@ namespace oceanbase
     class TableSchema;
     class ObUpsList;
     class ObStrings;
+    class ObMergeSchedule;
     class ObTabletReportInfoList;
     class ObTabletLocation;
     class ObiRole;
@@ -213,6 +214,8 @@ namespace oceanbase
          * @param [in] dest_server migrate destination server
          * @param [in] keep_src =true means copy otherwise move
          * @param [in] tablet_version migrated tablet's data version
+         * @param [in] migrate_bytes bytes of sstable files transferred
+         * @param [in] migrate_time_us time of transferring sstable files
          */
         int migrate_over(
             const int64_t timeout,
@@ -222,7 +225,9 @@ namespace oceanbase
             const ObServer &dest_server,
             const bool keep_src,
             const int64_t tablet_version,
-            const int64_t tablet_seq_num);
+            const int64_t tablet_seq_num,
+            const int64_t migrate_bytes,
+            const int64_t migrate_time_us);
 
         /*
          * report capacity info of chunkserver for load balance.
@@ -320,6 +325,9 @@ namespace oceanbase
         int execute_sql(const int64_t timeout, const ObServer & ms, const ObString &sql_str) const;
         /* get master obi rootserver address */
         int get_master_obi_rs(const int64_t timeout, const ObServer &rs, ObServer &master_obi_rs) const;
+        /* get merge plan of frozen version from root server, OB_EAGAIN if not made yet */
+        int get_merge_schedule(const int64_t timeout, const ObServer &root_server,
+            const int64_t frozen_version, ObMergeSchedule &schedule) const;
       protected:
         // default cmd version
         static const int32_t DEFAULT_VERSION = 1;
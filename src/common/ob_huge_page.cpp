@@ -0,0 +1,398 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_huge_page.cpp
+ *
+ */
+#include "ob_huge_page.h"
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include "tbsys.h"
+#include "ob_malloc.h"
+#include "utility.h"
+
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE 14
+#endif
+
+using namespace oceanbase::common;
+
+ObHugePagePool::ObHugePagePool() : mode_(HUGE_PAGE_NONE), class_num_(0),
+                                   region_num_(0), mapped_size_(0)
+{
+  pthread_spin_init(&lock_, PTHREAD_PROCESS_PRIVATE);
+  memset(classes_, 0, sizeof(classes_));
+  memset(regions_, 0, sizeof(regions_));
+  memset((void*)huge_usage_, 0, sizeof(huge_usage_));
+  memset((void*)normal_usage_, 0, sizeof(normal_usage_));
+}
+
+ObHugePagePool::~ObHugePagePool()
+{
+  // the regions live as long as the process, blocks may still be in use
+  // by static objects destroyed after this one
+  pthread_spin_destroy(&lock_);
+}
+
+ObHugePagePool &ObHugePagePool::get_instance()
+{
+  static ObHugePagePool instance;
+  return instance;
+}
+
+int ObHugePagePool::parse_mode(const char *str, ObHugePageMode &mode)
+{
+  int ret = OB_SUCCESS;
+  if (NULL == str)
+  {
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else if (0 == strcasecmp(str, "none"))
+  {
+    mode = HUGE_PAGE_NONE;
+  }
+  else if (0 == strcasecmp(str, "transparent"))
+  {
+    mode = HUGE_PAGE_TRANSPARENT;
+  }
+  else if (0 == strcasecmp(str, "2M"))
+  {
+    mode = HUGE_PAGE_EXPLICIT_2M;
+  }
+  else if (0 == strcasecmp(str, "1G"))
+  {
+    mode = HUGE_PAGE_EXPLICIT_1G;
+  }
+  else
+  {
+    ret = OB_INVALID_ARGUMENT;
+  }
+  return ret;
+}
+
+const char *ObHugePagePool::get_mode_str(const ObHugePageMode mode)
+{
+  const char *str = "unknown";
+  switch (mode)
+  {
+    case HUGE_PAGE_NONE:
+      str = "none";
+      break;
+    case HUGE_PAGE_TRANSPARENT:
+      str = "transparent";
+      break;
+    case HUGE_PAGE_EXPLICIT_2M:
+      str = "2M";
+      break;
+    case HUGE_PAGE_EXPLICIT_1G:
+      str = "1G";
+      break;
+    default:
+      break;
+  }
+  return str;
+}
+
+int ObHugePagePool::init(const char *mode_str)
+{
+  int ret = OB_SUCCESS;
+  ObHugePageMode mode = HUGE_PAGE_NONE;
+  if (OB_SUCCESS != (ret = parse_mode(mode_str, mode)))
+  {
+    TBSYS_LOG(ERROR, "invalid huge page mode [%s], should be none, transparent, 2M or 1G",
+              NULL == mode_str ? "" : mode_str);
+  }
+  else
+  {
+    mode_ = mode;
+    TBSYS_LOG(INFO, "huge page mode is %s", get_mode_str(mode_));
+  }
+  return ret;
+}
+
+int64_t ObHugePagePool::get_class_(const int64_t block_size)
+{
+  int64_t class_idx = -1;
+  int64_t class_num = class_num_;
+  for (int64_t i = 0; i < class_num; i++)
+  {
+    if (block_size == classes_[i].block_size_)
+    {
+      class_idx = i;
+      break;
+    }
+  }
+  if (0 > class_idx)
+  {
+    pthread_spin_lock(&lock_);
+    for (int64_t i = class_num; i < class_num_; i++)
+    {
+      if (block_size == classes_[i].block_size_)
+      {
+        class_idx = i;
+        break;
+      }
+    }
+    if (0 > class_idx && MAX_CLASS_NUM > class_num_)
+    {
+      class_idx = class_num_;
+      memset(&classes_[class_idx], 0, sizeof(SizeClass));
+      classes_[class_idx].block_size_ = block_size;
+      __sync_synchronize();
+      class_num_++;
+    }
+    pthread_spin_unlock(&lock_);
+  }
+  return class_idx;
+}
+
+char *ObHugePagePool::map_region_with_mode_(const ObHugePageMode mode, const int64_t region_size)
+{
+  char *ret = NULL;
+  void *ptr = MAP_FAILED;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (HUGE_PAGE_EXPLICIT_1G == mode || HUGE_PAGE_EXPLICIT_2M == mode)
+  {
+    flags |= MAP_HUGETLB | ((HUGE_PAGE_EXPLICIT_1G == mode ? 30 : 21) << MAP_HUGE_SHIFT);
+    if (MAP_FAILED != (ptr = mmap(NULL, region_size, PROT_READ | PROT_WRITE, flags, -1, 0)))
+    {
+      ret = static_cast<char*>(ptr);
+    }
+  }
+  else if (HUGE_PAGE_TRANSPARENT == mode)
+  {
+    // map one more huge page to align the region, khugepaged only
+    // collapses aligned 2MB ranges
+    const int64_t map_size = region_size + HUGE_PAGE_SIZE_2M;
+    if (MAP_FAILED != (ptr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, flags, -1, 0)))
+    {
+      char *start = reinterpret_cast<char*>(upper_align(reinterpret_cast<int64_t>(ptr), HUGE_PAGE_SIZE_2M));
+      char *end = start + region_size;
+      if (start > ptr)
+      {
+        munmap(ptr, start - static_cast<char*>(ptr));
+      }
+      if (static_cast<char*>(ptr) + map_size > end)
+      {
+        munmap(end, static_cast<char*>(ptr) + map_size - end);
+      }
+      if (0 != madvise(start, region_size, MADV_HUGEPAGE))
+      {
+        TBSYS_LOG(WARN, "madvise MADV_HUGEPAGE fail, errno=%d, transparent huge page may be unsupported", errno);
+      }
+      ret = start;
+    }
+  }
+  return ret;
+}
+
+char *ObHugePagePool::map_region_(int64_t &region_size)
+{
+  char *ret = NULL;
+  while (NULL == ret && HUGE_PAGE_NONE != mode_)
+  {
+    const ObHugePageMode mode = mode_;
+    const int64_t size = upper_align(region_size,
+                                     HUGE_PAGE_EXPLICIT_1G == mode ? HUGE_PAGE_SIZE_1G : HUGE_PAGE_SIZE_2M);
+    if (NULL != (ret = map_region_with_mode_(mode, size)))
+    {
+      region_size = size;
+    }
+    else
+    {
+      // degrade step by step, explicit huge pages may not be reserved
+      // and transparent huge pages may be disabled
+      mode_ = static_cast<ObHugePageMode>(mode - 1);
+      TBSYS_LOG(WARN, "map huge page region fail, size=%ld mode=%s errno=%d, degrade to %s",
+                size, get_mode_str(mode), errno, get_mode_str(mode_));
+    }
+  }
+  return ret;
+}
+
+void *ObHugePagePool::alloc_block_(const int64_t class_idx)
+{
+  void *ret = NULL;
+  SizeClass &size_class = classes_[class_idx];
+  pthread_spin_lock(&lock_);
+  if (NULL != size_class.free_list_)
+  {
+    ret = size_class.free_list_;
+    size_class.free_list_ = *reinterpret_cast<void**>(ret);
+    size_class.free_num_--;
+  }
+  else
+  {
+    if (size_class.cur_pos_ + size_class.block_size_ > size_class.cur_size_
+        && MAX_REGION_NUM > region_num_)
+    {
+      int64_t region_size = DEFAULT_REGION_SIZE;
+      if (size_class.block_size_ > region_size)
+      {
+        region_size = size_class.block_size_;
+      }
+      char *region = map_region_(region_size);
+      if (NULL != region)
+      {
+        regions_[region_num_].start_ = region;
+        regions_[region_num_].size_ = region_size;
+        regions_[region_num_].class_idx_ = class_idx;
+        __sync_synchronize();
+        region_num_++;
+        mapped_size_ += region_size;
+        size_class.cur_region_ = region;
+        size_class.cur_pos_ = 0;
+        size_class.cur_size_ = region_size;
+      }
+    }
+    if (size_class.cur_pos_ + size_class.block_size_ <= size_class.cur_size_)
+    {
+      ret = size_class.cur_region_ + size_class.cur_pos_;
+      size_class.cur_pos_ += size_class.block_size_;
+    }
+  }
+  pthread_spin_unlock(&lock_);
+  return ret;
+}
+
+int64_t ObHugePagePool::find_region_(const void *ptr) const
+{
+  int64_t region_idx = -1;
+  const char *p = static_cast<const char*>(ptr);
+  int64_t region_num = region_num_;
+  for (int64_t i = 0; i < region_num; i++)
+  {
+    if (regions_[i].start_ <= p && p < regions_[i].start_ + regions_[i].size_)
+    {
+      region_idx = i;
+      break;
+    }
+  }
+  return region_idx;
+}
+
+void ObHugePagePool::update_mod_usage_(const int32_t mod_id, const int64_t huge_delta, const int64_t normal_delta)
+{
+  int32_t real_mod_id = (0 < mod_id && G_MAX_MOD_NUM > mod_id) ? mod_id : 0;
+  if (0 != huge_delta)
+  {
+    __sync_add_and_fetch(&huge_usage_[real_mod_id], huge_delta);
+    // keep the module memory statistics of ob_malloc complete
+    ob_mod_usage_update(huge_delta, mod_id);
+  }
+  if (0 != normal_delta)
+  {
+    __sync_add_and_fetch(&normal_usage_[real_mod_id], normal_delta);
+  }
+}
+
+void *ObHugePagePool::alloc(const int64_t size, const int32_t mod_id)
+{
+  void *ret = NULL;
+  int64_t class_idx = -1;
+  const int64_t block_size = upper_align(size, BLOCK_ALIGN_SIZE);
+  if (0 >= size)
+  {
+    TBSYS_LOG(WARN, "invalid size %ld", size);
+  }
+  else if (HUGE_PAGE_NONE == mode_
+           || MIN_BLOCK_SIZE > block_size || MAX_BLOCK_SIZE < block_size)
+  {
+    // fall back to ob_malloc
+  }
+  else if (0 <= (class_idx = get_class_(block_size)))
+  {
+    if (NULL != (ret = alloc_block_(class_idx)))
+    {
+      update_mod_usage_(mod_id, block_size, 0);
+    }
+  }
+  if (NULL == ret && 0 < size)
+  {
+    // remember the size for the statistics in free()
+    char *buf = static_cast<char*>(ob_malloc(size + FALLBACK_HEADER_SIZE, mod_id));
+    if (NULL != buf)
+    {
+      *reinterpret_cast<int64_t*>(buf) = size;
+      ret = buf + FALLBACK_HEADER_SIZE;
+      update_mod_usage_(mod_id, 0, size);
+    }
+  }
+  return ret;
+}
+
+void ObHugePagePool::free(void *ptr, const int32_t mod_id)
+{
+  int64_t region_idx = -1;
+  if (NULL == ptr)
+  {
+    // nothing to free
+  }
+  else if (0 > (region_idx = find_region_(ptr)))
+  {
+    char *buf = static_cast<char*>(ptr) - FALLBACK_HEADER_SIZE;
+    update_mod_usage_(mod_id, 0, -*reinterpret_cast<int64_t*>(buf));
+    ob_free(buf, mod_id);
+  }
+  else
+  {
+    SizeClass &size_class = classes_[regions_[region_idx].class_idx_];
+    update_mod_usage_(mod_id, -size_class.block_size_, 0);
+    pthread_spin_lock(&lock_);
+    *reinterpret_cast<void**>(ptr) = size_class.free_list_;
+    size_class.free_list_ = ptr;
+    size_class.free_num_++;
+    pthread_spin_unlock(&lock_);
+  }
+}
+
+void ObHugePagePool::get_mod_usage(const int32_t mod_id, int64_t &huge_size, int64_t &normal_size) const
+{
+  int32_t real_mod_id = (0 < mod_id && G_MAX_MOD_NUM > mod_id) ? mod_id : 0;
+  huge_size = huge_usage_[real_mod_id];
+  normal_size = normal_usage_[real_mod_id];
+}
+
+void ObHugePagePool::print_usage() const
+{
+  TBSYS_LOG(INFO, "[HUGE_PAGE] mode=%s mapped=%ld region_num=%ld class_num=%ld",
+            get_mode_str(mode_), mapped_size_, region_num_, class_num_);
+  for (int64_t i = 0; i < class_num_; i++)
+  {
+    TBSYS_LOG(INFO, "[HUGE_PAGE] block_size=%ld free_block=%ld",
+              classes_[i].block_size_, classes_[i].free_num_);
+  }
+  for (int32_t mod_id = 0; mod_id < G_MAX_MOD_NUM; mod_id++)
+  {
+    if (0 != huge_usage_[mod_id] || 0 != normal_usage_[mod_id])
+    {
+      TBSYS_LOG(INFO, "[HUGE_PAGE] huge=% 12ld normal=% 12ld mod=%s",
+                huge_usage_[mod_id], normal_usage_[mod_id],
+                NULL == OB_MOD_SET[mod_id].mod_name_ ? "unknown" : OB_MOD_SET[mod_id].mod_name_);
+    }
+  }
+}
+
+void *oceanbase::common::ob_huge_malloc(const int64_t nbyte, const int32_t mod_id)
+{
+  return ObHugePagePool::get_instance().alloc(nbyte, mod_id);
+}
+
+void oceanbase::common::ob_huge_free(void *ptr, const int32_t mod_id)
+{
+  ObHugePagePool::get_instance().free(ptr, mod_id);
+}
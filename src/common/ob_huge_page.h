@@ -0,0 +1,121 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_huge_page.h
+ *
+ * Huge page backend of the big, long lived arenas: memtable blocks,
+ * FIFOAllocator pages and KVCache memory blocks. Blocks are carved out
+ * of huge page backed regions and kept in a free list of their size
+ * class after being freed, regions are never returned to the system.
+ * Requests the backend can not serve fall back to ob_malloc.
+ */
+#ifndef OCEANBASE_COMMON_OB_HUGE_PAGE_H_
+#define OCEANBASE_COMMON_OB_HUGE_PAGE_H_
+
+#include <pthread.h>
+#include "ob_define.h"
+#include "ob_mod_define.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    enum ObHugePageMode
+    {
+      HUGE_PAGE_NONE = 0,
+      // normal mmap advised with MADV_HUGEPAGE, khugepaged collapses it
+      HUGE_PAGE_TRANSPARENT = 1,
+      // MAP_HUGETLB from the 2MB/1GB hugetlbfs pool
+      HUGE_PAGE_EXPLICIT_2M = 2,
+      HUGE_PAGE_EXPLICIT_1G = 3,
+    };
+
+    class ObHugePagePool
+    {
+      public:
+        static const int64_t HUGE_PAGE_SIZE_2M = 2L * 1024L * 1024L;
+        static const int64_t HUGE_PAGE_SIZE_1G = 1024L * 1024L * 1024L;
+        static const int64_t DEFAULT_REGION_SIZE = 64L * 1024L * 1024L;
+        // only the fixed size blocks of the arenas are served, the rest
+        // is left to ob_malloc
+        static const int64_t MIN_BLOCK_SIZE = 512L * 1024L;
+        static const int64_t MAX_BLOCK_SIZE = 16L * 1024L * 1024L;
+        static const int64_t BLOCK_ALIGN_SIZE = 4L * 1024L;
+        static const int64_t MAX_CLASS_NUM = 16;
+        static const int64_t MAX_REGION_NUM = 8192;
+        // blocks from ob_malloc keep their size in front of the block
+        static const int64_t FALLBACK_HEADER_SIZE = 16;
+
+      public:
+        ObHugePagePool();
+        ~ObHugePagePool();
+        static ObHugePagePool &get_instance();
+        static int parse_mode(const char *str, ObHugePageMode &mode);
+        static const char *get_mode_str(const ObHugePageMode mode);
+
+      public:
+        // mode_str is one of none, transparent, 2M and 1G, not thread
+        // safe, call it before the arenas allocate memory
+        int init(const char *mode_str);
+        ObHugePageMode get_mode() const
+        {
+          return mode_;
+        }
+        void *alloc(const int64_t size, const int32_t mod_id);
+        void free(void *ptr, const int32_t mod_id);
+        // bytes handed out to mod_id from huge pages and from ob_malloc
+        void get_mod_usage(const int32_t mod_id, int64_t &huge_size, int64_t &normal_size) const;
+        void print_usage() const;
+
+      private:
+        struct Region
+        {
+          char *start_;
+          int64_t size_;
+          int64_t class_idx_;
+        };
+        struct SizeClass
+        {
+          int64_t block_size_;
+          void *free_list_;
+          int64_t free_num_;
+          char *cur_region_;
+          int64_t cur_pos_;
+          int64_t cur_size_;
+        };
+
+      private:
+        int64_t get_class_(const int64_t block_size);
+        void *alloc_block_(const int64_t class_idx);
+        char *map_region_(int64_t &region_size);
+        char *map_region_with_mode_(const ObHugePageMode mode, const int64_t region_size);
+        int64_t find_region_(const void *ptr) const;
+        void update_mod_usage_(const int32_t mod_id, const int64_t huge_delta, const int64_t normal_delta);
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObHugePagePool);
+        ObHugePageMode mode_;
+        pthread_spinlock_t lock_;
+        SizeClass classes_[MAX_CLASS_NUM];
+        volatile int64_t class_num_;
+        Region regions_[MAX_REGION_NUM];
+        volatile int64_t region_num_;
+        volatile int64_t mapped_size_;
+        volatile int64_t huge_usage_[G_MAX_MOD_NUM];
+        volatile int64_t normal_usage_[G_MAX_MOD_NUM];
+    };
+
+    /// allocate a big long lived block, served from huge pages if enabled
+    void *ob_huge_malloc(const int64_t nbyte, const int32_t mod_id);
+    /// free a block allocated by ob_huge_malloc
+    void ob_huge_free(void *ptr, const int32_t mod_id);
+  }
+}
+
+#endif //OCEANBASE_COMMON_OB_HUGE_PAGE_H_
@@ -40,6 +40,8 @@
 #include "ob_define.h"
 #include "ob_mod_define.h"
 #include "ob_malloc.h"
+#include "ob_numa.h"
+#include "ob_huge_page.h"
 #include "ob_atomic.h"
 #include "ob_thread_objpool.h"
 #include "ob_trace_log.h"
@@ -184,10 +186,12 @@ namespace oceanbase
         data->~ObRowkey();
       }
 
+      // memory blocks of the cache are big and live as long as the cache,
+      // serve them from the huge page pool
       struct DefaultAllocator
       {
-        void *alloc(const int32_t nbyte) {return ob_malloc(nbyte, ObModIds::OB_KVSTORE_CACHE);};
-        void free(void *ptr) {ob_free(ptr, ObModIds::OB_KVSTORE_CACHE);};
+        void *alloc(const int32_t nbyte) {return ob_huge_malloc(nbyte, ObModIds::OB_KVSTORE_CACHE);};
+        void free(void *ptr) {ob_huge_free(ptr, ObModIds::OB_KVSTORE_CACHE);};
       };
 
       ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -678,6 +682,9 @@ namespace oceanbase
             if (NULL != buffer_)
             {
               payload_size_ = alloc_size;
+              // the block is filled by the calling thread, keep it on the
+              // numa node of that thread
+              ObNumaTopology::get_instance().bind_memory(buffer_, alloc_size, ObNumaTopology::LOCAL_NODE);
             }
 
             return ret;
@@ -16,6 +16,7 @@
  */
 #include "ob_malloc.h"
 #include <errno.h>
+#include "ob_huge_page.h"
 #include "ob_memory_pool.h"
 #include "ob_mod_define.h"
 #include "ob_thread_mempool.h"
@@ -203,6 +204,7 @@ void oceanbase::common::ob_print_mod_memory_usage(bool print_to_std)
   {
     TBSYS_LOG(INFO, "[BLOCK_STAT] size=%ld times=%ld", MON_BLOCK_SIZE_ARRAY[i], MON_BLOCK_ARRAY[i]);
   } // end for
+  ObHugePagePool::get_instance().print_usage();
 }
 
 int64_t oceanbase::common::ob_get_mod_memory_usage(int32_t mod_id)
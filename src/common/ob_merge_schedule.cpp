@@ -0,0 +1,229 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_merge_schedule.cpp
+ *
+ */
+#include <algorithm>
+#include <tbsys.h>
+#include "utility.h"
+#include "ob_merge_schedule.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    ObMergeSchedule::ObMergeSchedule()
+      : frozen_version_(0), group_count_(0), released_group_(ALL_GROUP_RELEASED),
+      split_tablet_size_(0), split_range_count_(0)
+    {
+    }
+
+    ObMergeSchedule::~ObMergeSchedule()
+    {
+    }
+
+    void ObMergeSchedule::reset()
+    {
+      frozen_version_ = 0;
+      group_count_ = 0;
+      released_group_ = ALL_GROUP_RELEASED;
+      split_tablet_size_ = 0;
+      split_range_count_ = 0;
+      tables_.clear();
+    }
+
+    int ObMergeSchedule::add_table(const uint64_t table_id, const int64_t group)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_INVALID_ID == table_id || group < 0)
+      {
+        TBSYS_LOG(WARN, "invalid argument, table_id=%lu, group=%ld", table_id, group);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = tables_.push_back(ObTableMergeGroup(table_id, group))))
+      {
+        TBSYS_LOG(WARN, "failed to add table to merge schedule, table_id=%lu, ret=%d",
+            table_id, ret);
+      }
+      else
+      {
+        if (group >= group_count_)
+        {
+          group_count_ = group + 1;
+        }
+        // nothing released until rootserver says so
+        released_group_ = -1;
+      }
+      return ret;
+    }
+
+    void ObMergeSchedule::finish()
+    {
+      if (tables_.count() > 1)
+      {
+        std::sort(&tables_.at(0), &tables_.at(0) + tables_.count());
+      }
+    }
+
+    int64_t ObMergeSchedule::get_table_group(const uint64_t table_id) const
+    {
+      int64_t group = 0;
+      if (tables_.count() > 0)
+      {
+        const ObTableMergeGroup* begin = &tables_.at(0);
+        const ObTableMergeGroup* end = begin + tables_.count();
+        const ObTableMergeGroup* it = std::lower_bound(begin, end,
+            ObTableMergeGroup(table_id, 0));
+        if (it != end && it->table_id_ == table_id)
+        {
+          group = it->group_;
+        }
+      }
+      return group;
+    }
+
+    bool ObMergeSchedule::release_group(const int64_t group)
+    {
+      bool released = false;
+      if (group > released_group_)
+      {
+        released_group_ = group;
+        released = true;
+      }
+      return released;
+    }
+
+    int64_t ObMergeSchedule::to_string(char* buffer, const int64_t length) const
+    {
+      int64_t pos = 0;
+      databuff_printf(buffer, length, pos, "frozen_version=%ld, table_count=%ld, "
+          "group_count=%ld, released_group=%ld, split_tablet_size=%ld, split_range_count=%ld",
+          frozen_version_, tables_.count(), group_count_, released_group_,
+          split_tablet_size_, split_range_count_);
+      return pos;
+    }
+
+    DEFINE_SERIALIZE(ObMergeSchedule)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, frozen_version_)))
+      {
+        TBSYS_LOG(WARN, "failed to serialize frozen_version, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, released_group_)))
+      {
+        TBSYS_LOG(WARN, "failed to serialize released_group, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, split_tablet_size_)))
+      {
+        TBSYS_LOG(WARN, "failed to serialize split_tablet_size, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, split_range_count_)))
+      {
+        TBSYS_LOG(WARN, "failed to serialize split_range_count, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, tables_.count())))
+      {
+        TBSYS_LOG(WARN, "failed to serialize table count, ret=%d", ret);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < tables_.count(); ++i)
+      {
+        if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos,
+                static_cast<int64_t>(tables_.at(i).table_id_))))
+        {
+          TBSYS_LOG(WARN, "failed to serialize table id, ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos,
+                tables_.at(i).group_)))
+        {
+          TBSYS_LOG(WARN, "failed to serialize table group, ret=%d", ret);
+        }
+      }
+      return ret;
+    }
+
+    DEFINE_DESERIALIZE(ObMergeSchedule)
+    {
+      int ret = OB_SUCCESS;
+      int64_t frozen_version = 0;
+      int64_t released_group = 0;
+      int64_t split_tablet_size = 0;
+      int64_t split_range_count = 0;
+      int64_t count = 0;
+      int64_t table_id = 0;
+      int64_t group = 0;
+
+      reset();
+      if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &frozen_version)))
+      {
+        TBSYS_LOG(WARN, "failed to deserialize frozen_version, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &released_group)))
+      {
+        TBSYS_LOG(WARN, "failed to deserialize released_group, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &split_tablet_size)))
+      {
+        TBSYS_LOG(WARN, "failed to deserialize split_tablet_size, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &split_range_count)))
+      {
+        TBSYS_LOG(WARN, "failed to deserialize split_range_count, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &count)))
+      {
+        TBSYS_LOG(WARN, "failed to deserialize table count, ret=%d", ret);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < count; ++i)
+      {
+        if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &table_id)))
+        {
+          TBSYS_LOG(WARN, "failed to deserialize table id, ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &group)))
+        {
+          TBSYS_LOG(WARN, "failed to deserialize table group, ret=%d", ret);
+        }
+        else
+        {
+          ret = add_table(static_cast<uint64_t>(table_id), group);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        finish();
+        frozen_version_ = frozen_version;
+        released_group_ = released_group;
+        split_tablet_size_ = split_tablet_size;
+        split_range_count_ = split_range_count;
+      }
+      else
+      {
+        reset();
+      }
+      return ret;
+    }
+
+    DEFINE_GET_SERIALIZE_SIZE(ObMergeSchedule)
+    {
+      int64_t size = serialization::encoded_length_vi64(frozen_version_)
+        + serialization::encoded_length_vi64(released_group_)
+        + serialization::encoded_length_vi64(split_tablet_size_)
+        + serialization::encoded_length_vi64(split_range_count_)
+        + serialization::encoded_length_vi64(tables_.count());
+      for (int64_t i = 0; i < tables_.count(); ++i)
+      {
+        size += serialization::encoded_length_vi64(static_cast<int64_t>(tables_.at(i).table_id_));
+        size += serialization::encoded_length_vi64(tables_.at(i).group_);
+      }
+      return size;
+    }
+  } // end namespace common
+} // end namespace oceanbase
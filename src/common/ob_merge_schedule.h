@@ -0,0 +1,106 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_merge_schedule.h
+ *
+ * Staggered merge plan of one frozen version. Rootserver puts every
+ * table into a merge group, and releases the groups one by one within
+ * the merge window; chunkserver only merges tablets of the tables
+ * whose group has been released. Tables not in the plan belong to
+ * group 0, an empty plan releases everything at once.
+ *
+ * The plan also carries the tablet split parameters of parallel merge,
+ * so that all replicas of a tablet are cut into the same sub ranges
+ * whatever the local config of the chunkserver is.
+ */
+#ifndef OCEANBASE_COMMON_OB_MERGE_SCHEDULE_H_
+#define OCEANBASE_COMMON_OB_MERGE_SCHEDULE_H_
+
+#include "ob_define.h"
+#include "ob_array.h"
+#include "serialization.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    struct ObTableMergeGroup
+    {
+      uint64_t table_id_;
+      int64_t group_;
+
+      ObTableMergeGroup() : table_id_(OB_INVALID_ID), group_(0) {}
+      ObTableMergeGroup(const uint64_t table_id, const int64_t group)
+        : table_id_(table_id), group_(group) {}
+      bool operator<(const ObTableMergeGroup& other) const
+      {
+        return table_id_ < other.table_id_;
+      }
+    };
+
+    class ObMergeSchedule
+    {
+      public:
+        static const int64_t ALL_GROUP_RELEASED = INT64_MAX;
+
+      public:
+        ObMergeSchedule();
+        ~ObMergeSchedule();
+
+        void reset();
+
+        /**
+         * add table into merge group %group, call finish() after
+         * all tables added.
+         */
+        int add_table(const uint64_t table_id, const int64_t group);
+        void finish();
+
+        int64_t get_table_group(const uint64_t table_id) const;
+        inline bool is_table_released(const uint64_t table_id) const
+        {
+          return get_table_group(table_id) <= released_group_;
+        }
+
+        /// only goes forward, return true if %group released more tables
+        bool release_group(const int64_t group);
+
+        inline void set_frozen_version(const int64_t frozen_version)
+        {
+          frozen_version_ = frozen_version;
+        }
+        inline int64_t get_frozen_version() const { return frozen_version_; }
+        inline int64_t get_group_count() const { return group_count_; }
+        inline int64_t get_released_group() const { return released_group_; }
+        inline int64_t get_table_count() const { return tables_.count(); }
+
+        /// tablets not smaller than %min_tablet_size merge in %sub_range_count sub ranges
+        inline void set_split_param(const int64_t min_tablet_size, const int64_t sub_range_count)
+        {
+          split_tablet_size_ = min_tablet_size;
+          split_range_count_ = sub_range_count;
+        }
+        inline int64_t get_split_tablet_size() const { return split_tablet_size_; }
+        inline int64_t get_split_range_count() const { return split_range_count_; }
+
+        int64_t to_string(char* buffer, const int64_t length) const;
+        NEED_SERIALIZE_AND_DESERIALIZE;
+
+      private:
+        int64_t frozen_version_;
+        int64_t group_count_;
+        int64_t released_group_;
+        int64_t split_tablet_size_;
+        int64_t split_range_count_;
+        ObArray<ObTableMergeGroup> tables_;
+    };
+  } // end namespace common
+} // end namespace oceanbase
+
+#endif //OCEANBASE_COMMON_OB_MERGE_SCHEDULE_H_
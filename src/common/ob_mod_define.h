@@ -211,6 +211,7 @@ namespace oceanbase
         OB_SQL_RESULT_SET_DYN,
         OB_SQL_SESSION_HASHMAP,
         OB_SQL_SESSION_SBLOCK,
+        OB_SQL_SORT,
 
         OB_MOD_END
       };
@@ -358,6 +359,7 @@ namespace oceanbase
       ADD_MOD(OB_SQL_RESULT_SET_DYN);
       ADD_MOD(OB_SQL_SESSION_HASHMAP);
       ADD_MOD(OB_SQL_SESSION_SBLOCK);
+      ADD_MOD(OB_SQL_SORT);
 
       ADD_MOD(OB_MOD_END);
     }
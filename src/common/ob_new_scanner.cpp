@@ -29,6 +29,7 @@
 #include "utility.h"
 #include "ob_row.h"
 #include "ob_schema.h"
+#include "ob_compact_row_codec.h"
 
 using namespace oceanbase::common;
 
@@ -44,6 +45,10 @@ default_row_desc_(NULL)
   is_request_fullfilled_ = false;
   fullfilled_row_num_ = 0;
   cur_row_num_ = 0;
+  rpc_profile_.reset();
+  use_compact_row_ = false;
+  has_row_with_rowkey_ = false;
+  has_row_without_rowkey_ = false;
 }
 
 ObNewScanner::~ObNewScanner()
@@ -67,6 +72,10 @@ void ObNewScanner::reuse()
 
   cur_row_num_ = 0;
   default_row_desc_ = NULL;
+  rpc_profile_.reset();
+  use_compact_row_ = false;
+  has_row_with_rowkey_ = false;
+  has_row_without_rowkey_ = false;
 }
 
 void ObNewScanner::clear()
@@ -84,6 +93,10 @@ void ObNewScanner::clear()
 
   cur_row_num_ = 0;
   default_row_desc_ = NULL;
+  rpc_profile_.reset();
+  use_compact_row_ = false;
+  has_row_with_rowkey_ = false;
+  has_row_without_rowkey_ = false;
 }
 
 int64_t ObNewScanner::set_mem_size_limit(const int64_t limit)
@@ -113,6 +126,10 @@ int ObNewScanner::add_row(const ObRow &row)
   {
     TBSYS_LOG(WARN, "fail to add_row to row store. ret=%d", ret);
   }
+  else
+  {
+    has_row_without_rowkey_ = true;
+  }
   if (cur_size_counter_ > mem_size_limit_)
   {
     TBSYS_LOG(WARN, "scanner memory exceeds the limit."
@@ -322,7 +339,22 @@ DEFINE_SERIALIZE(ObNewScanner)
     }
   }
 
-  if (OB_SUCCESS == ret)
+  bool compact_done = false;
+  if (OB_SUCCESS == ret && use_compact_row_ && has_row_with_rowkey_ != has_row_without_rowkey_)
+  {
+    int64_t table_pos = next_pos;
+    if (OB_SUCCESS == serialize_compact_table_(buf, buf_len, next_pos))
+    {
+      compact_done = true;
+    }
+    else
+    {
+      // fall back to the plain format
+      next_pos = table_pos;
+    }
+  }
+
+  if (OB_SUCCESS == ret && !compact_done)
   {
     ///obj.reset();
     obj.set_ext(ObActionFlag::TABLE_PARAM_FIELD);
@@ -334,7 +366,7 @@ DEFINE_SERIALIZE(ObNewScanner)
     }
   }
 
-  if (OB_SUCCESS == ret)
+  if (OB_SUCCESS == ret && !compact_done)
   {
     ret = row_store_.serialize(buf, buf_len, next_pos);
     if (OB_SUCCESS != ret)
@@ -344,6 +376,15 @@ DEFINE_SERIALIZE(ObNewScanner)
     }
   }
 
+  if (OB_SUCCESS == ret && !rpc_profile_.is_empty())
+  {
+    ret = serialize_profile_(buf, buf_len, next_pos);
+    if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(WARN, "fail to serialize rpc profile. ret=%d", ret);
+    }
+  }
+
   if (OB_SUCCESS == ret)
   {
     ///obj.reset();
@@ -450,6 +491,22 @@ DEFINE_DESERIALIZE(ObNewScanner)
                         ret, buf, data_len, new_pos);
             }
             break;
+          case ObActionFlag::COMPACT_TABLE_PARAM_FIELD:
+            ret = deserialize_compact_table_(buf, data_len, new_pos, param_id);
+            if (OB_SUCCESS != ret)
+            {
+              TBSYS_LOG(WARN, "deserialize_compact_table_ error, ret=%d buf=%p data_len=%ld new_pos=%ld",
+                        ret, buf, data_len, new_pos);
+            }
+            break;
+          case ObActionFlag::SQL_RPC_PROFILE_FIELD:
+            ret = deserialize_profile_(buf, data_len, new_pos, param_id);
+            if (OB_SUCCESS != ret)
+            {
+              TBSYS_LOG(WARN, "deserialize_profile_ error, ret=%d buf=%p data_len=%ld new_pos=%ld",
+                        ret, buf, data_len, new_pos);
+            }
+            break;
           case ObActionFlag::END_PARAM_FIELD:
             is_end = true;
             break;
@@ -613,6 +670,150 @@ int ObNewScanner::deserialize_table_(const char* buf, const int64_t data_len, in
   return ret;
 }
 
+int ObNewScanner::serialize_compact_table_(char* buf, const int64_t buf_len, int64_t& pos) const
+{
+  int ret = OB_SUCCESS;
+  ObObj obj;
+  ObCompactRowCodec codec;
+  int64_t new_pos = pos;
+  int64_t data_pos = 0;
+  int64_t data_len = 0;
+  int64_t len_size = 0;
+
+  obj.set_ext(ObActionFlag::COMPACT_TABLE_PARAM_FIELD);
+  if (OB_SUCCESS != (ret = obj.serialize(buf, buf_len, new_pos)))
+  {
+    TBSYS_LOG(DEBUG, "ObObj serialize error, ret=%d buf=%p buf_len=%ld new_pos=%ld",
+        ret, buf, buf_len, new_pos);
+  }
+  else
+  {
+    // encoded size is unknown yet, leave room for the size obj
+    obj.set_int(buf_len);
+    data_pos = new_pos + obj.get_serialize_size();
+    if (data_pos > buf_len)
+    {
+      ret = OB_BUF_NOT_ENOUGH;
+    }
+    else if (OB_SUCCESS != (ret = codec.encode(row_store_,
+            has_row_with_rowkey_ ? DENSE_SPARSE : SPARSE, buf, buf_len, data_pos)))
+    {
+      TBSYS_LOG(DEBUG, "fail to encode compact rows, ret=%d buf_len=%ld", ret, buf_len);
+    }
+    else
+    {
+      data_len = data_pos - new_pos - obj.get_serialize_size();
+      if (data_len >= row_store_.get_serialize_size())
+      {
+        ret = OB_SIZE_OVERFLOW;
+        TBSYS_LOG(DEBUG, "compact rows is not smaller, size=%ld", data_len);
+      }
+    }
+  }
+
+  if (OB_SUCCESS == ret)
+  {
+    obj.set_int(data_len);
+    len_size = obj.get_serialize_size();
+    memmove(buf + new_pos + len_size, buf + data_pos - data_len, data_len);
+    if (OB_SUCCESS != (ret = obj.serialize(buf, buf_len, new_pos)))
+    {
+      TBSYS_LOG(WARN, "ObObj serialize error, ret=%d buf=%p buf_len=%ld new_pos=%ld",
+          ret, buf, buf_len, new_pos);
+    }
+    else
+    {
+      pos = new_pos + data_len;
+    }
+  }
+  return ret;
+}
+
+int ObNewScanner::deserialize_compact_table_(const char* buf, const int64_t data_len, int64_t& pos, ObObj &last_obj)
+{
+  int ret = OB_SUCCESS;
+  ObCompactRowCodec codec;
+  int64_t compact_len = 0;
+  int64_t end_pos = 0;
+
+  if (OB_SUCCESS != (ret = deserialize_int_(buf, data_len, pos, compact_len, last_obj)))
+  {
+    TBSYS_LOG(WARN, "deserialize_int_ error, ret=%d buf=%p data_len=%ld pos=%ld",
+        ret, buf, data_len, pos);
+  }
+  else if (compact_len < 0 || (end_pos = pos + compact_len) > data_len)
+  {
+    ret = OB_DESERIALIZE_ERROR;
+    TBSYS_LOG(WARN, "invalid compact rows size=%ld, data_len=%ld pos=%ld", compact_len, data_len, pos);
+  }
+  else if (OB_SUCCESS != (ret = codec.decode(buf, end_pos, pos, row_store_, cur_size_counter_)))
+  {
+    TBSYS_LOG(WARN, "fail to decode compact rows, ret=%d buf=%p data_len=%ld pos=%ld",
+        ret, buf, end_pos, pos);
+  }
+  else if (pos != end_pos)
+  {
+    ret = OB_DESERIALIZE_ERROR;
+    TBSYS_LOG(WARN, "compact rows size mismatch, pos=%ld end_pos=%ld", pos, end_pos);
+  }
+  else if (OB_SUCCESS != (ret = last_obj.deserialize(buf, data_len, pos)))
+  {
+    TBSYS_LOG(WARN, "ObObj deserialize error, ret=%d", ret);
+  }
+  return ret;
+}
+
+int ObNewScanner::serialize_profile_(char* buf, const int64_t buf_len, int64_t& pos) const
+{
+  int ret = OB_SUCCESS;
+  ObObj obj;
+  const int64_t values[ObRpcProfile::FIELD_NUM] = {
+    rpc_profile_.server_time_, rpc_profile_.ups_time_, rpc_profile_.block_cache_hit_,
+    rpc_profile_.block_cache_miss_, rpc_profile_.io_bytes_};
+
+  obj.set_ext(ObActionFlag::SQL_RPC_PROFILE_FIELD);
+  ret = obj.serialize(buf, buf_len, pos);
+  for (int64_t i = 0; OB_SUCCESS == ret && i < ObRpcProfile::FIELD_NUM; i++)
+  {
+    obj.set_int(values[i]);
+    ret = obj.serialize(buf, buf_len, pos);
+  }
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(WARN, "ObObj serialize error, ret=%d buf=%p data_len=%ld pos=%ld",
+              ret, buf, buf_len, pos);
+  }
+  return ret;
+}
+
+int ObNewScanner::deserialize_profile_(const char* buf, const int64_t data_len, int64_t& pos, ObObj &last_obj)
+{
+  int ret = OB_SUCCESS;
+  int64_t *values[ObRpcProfile::FIELD_NUM] = {
+    &rpc_profile_.server_time_, &rpc_profile_.ups_time_, &rpc_profile_.block_cache_hit_,
+    &rpc_profile_.block_cache_miss_, &rpc_profile_.io_bytes_};
+
+  for (int64_t i = 0; OB_SUCCESS == ret && i < ObRpcProfile::FIELD_NUM; i++)
+  {
+    ret = deserialize_int_(buf, data_len, pos, *values[i], last_obj);
+  }
+  // skip the fields added by newer servers
+  if (OB_SUCCESS == ret)
+  {
+    ret = last_obj.deserialize(buf, data_len, pos);
+    while (OB_SUCCESS == ret && ObExtendType != last_obj.get_type())
+    {
+      ret = last_obj.deserialize(buf, data_len, pos);
+    }
+  }
+  if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(WARN, "deserialize rpc profile error, ret=%d buf=%p data_len=%ld pos=%ld",
+              ret, buf, data_len, pos);
+  }
+  return ret;
+}
+
 int ObNewScanner::deserialize_int_(const char* buf, const int64_t data_len, int64_t& pos,
     int64_t &value, ObObj &last_obj)
 {
@@ -720,6 +921,10 @@ int ObNewScanner::add_row(const ObRowkey &rowkey, const ObRow &row)
   {
     TBSYS_LOG(WARN, "fail to add_row to row store. ret=%d", ret);
   }
+  else
+  {
+    has_row_with_rowkey_ = true;
+  }
   if (cur_size_counter_ > mem_size_limit_)
   {
     TBSYS_LOG(WARN, "scanner memory exceeds the limit."
@@ -27,6 +27,7 @@
 #include "ob_object.h"
 #include "ob_row.h"
 #include "ob_row_store.h"
+#include "ob_query_profile.h"
 
 namespace oceanbase
 {
@@ -100,6 +101,29 @@ namespace oceanbase
           return data_version_;
         }
 
+        /// resource usage of the server producing this scanner
+        inline void set_rpc_profile(const ObRpcProfile &rpc_profile)
+        {
+          rpc_profile_ = rpc_profile;
+        }
+
+        inline const ObRpcProfile &get_rpc_profile() const
+        {
+          return rpc_profile_;
+        }
+
+        /// serialize rows in compact format when it is smaller,
+        /// only set when the requester accepts it
+        inline void set_use_compact_row(const bool use_compact_row)
+        {
+          use_compact_row_ = use_compact_row;
+        }
+
+        inline bool get_use_compact_row() const
+        {
+          return use_compact_row_;
+        }
+
         /* 获取数据占用的空间总大小（包括暂未使用的缓冲区) */
         inline int64_t get_used_mem_size() const
         {
@@ -127,6 +151,12 @@ namespace oceanbase
 
         int deserialize_table_(const char* buf, const int64_t data_len, int64_t& pos, ObObj &last_obj);
 
+        int serialize_compact_table_(char* buf, const int64_t buf_len, int64_t& pos) const;
+        int deserialize_compact_table_(const char* buf, const int64_t data_len, int64_t& pos, ObObj &last_obj);
+
+        int serialize_profile_(char* buf, const int64_t buf_len, int64_t& pos) const;
+        int deserialize_profile_(const char* buf, const int64_t data_len, int64_t& pos, ObObj &last_obj);
+
         static int deserialize_int_(const char* buf, const int64_t data_len, int64_t& pos,
             int64_t &value, ObObj &last_obj);
 
@@ -151,6 +181,11 @@ namespace oceanbase
         ModulePageAllocator mod_;
         mutable ModuleArena rowkey_allocator_;
         const ObRowDesc* default_row_desc_;        
+        ObRpcProfile rpc_profile_;
+        bool use_compact_row_;
+        // compact row format depends on whether rows are added with rowkey
+        bool has_row_with_rowkey_;
+        bool has_row_without_rowkey_;
     };
 
     class ObCellNewScanner : public ObNewScanner
@@ -0,0 +1,358 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_numa.cpp
+ *
+ * The topology is read from /sys/devices/system/node and the memory
+ * policy is set with the mbind syscall, so no libnuma is needed.
+ */
+#include "ob_numa.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include "tbsys.h"
+#include "utility.h"
+
+using namespace oceanbase::common;
+
+namespace
+{
+  const char *NUMA_NODE_DIR = "/sys/devices/system/node";
+
+  int64_t &get_tsi_bound_node()
+  {
+    static __thread int64_t bound_node = -1;
+    return bound_node;
+  }
+
+  int read_sys_file(const char *path, char *buf, const int64_t buf_len)
+  {
+    int ret = OB_SUCCESS;
+    FILE *fp = NULL;
+    if (NULL == (fp = fopen(path, "r")))
+    {
+      ret = OB_IO_ERROR;
+    }
+    else
+    {
+      size_t read_len = fread(buf, 1, buf_len - 1, fp);
+      buf[read_len] = '\0';
+      fclose(fp);
+    }
+    return ret;
+  }
+}
+
+ObNumaTopology::ObNumaTopology() : enabled_(false), node_num_(1)
+{
+  memset(node_cpus_, 0, sizeof(node_cpus_));
+  memset(cpu_node_, 0, sizeof(cpu_node_));
+  memset(stats_, 0, sizeof(stats_));
+}
+
+ObNumaTopology::~ObNumaTopology()
+{
+}
+
+ObNumaTopology &ObNumaTopology::get_instance()
+{
+  static ObNumaTopology instance;
+  return instance;
+}
+
+int ObNumaTopology::init(const bool enable)
+{
+  int ret = OB_SUCCESS;
+  enabled_ = false;
+  if (!enable)
+  {
+    TBSYS_LOG(INFO, "numa awareness is disabled");
+  }
+  else if (OB_SUCCESS != (ret = load_topology_()))
+  {
+    TBSYS_LOG(WARN, "load numa topology fail ret=%d, numa awareness is disabled", ret);
+    ret = OB_SUCCESS;
+  }
+  else if (1 >= node_num_)
+  {
+    TBSYS_LOG(INFO, "only one numa node, numa awareness is disabled");
+  }
+  else
+  {
+    enabled_ = true;
+    for (int64_t i = 0; i < node_num_; i++)
+    {
+      TBSYS_LOG(INFO, "numa node %ld has %d cpus", i, CPU_COUNT(&node_cpus_[i]));
+    }
+    TBSYS_LOG(INFO, "numa awareness is enabled, node_num=%ld", node_num_);
+  }
+  return ret;
+}
+
+int ObNumaTopology::load_topology_()
+{
+  int ret = OB_SUCCESS;
+  char path[OB_MAX_FILE_NAME_LENGTH];
+  char cpu_list[OB_MAX_FILE_NAME_LENGTH * 4];
+  int64_t node_num = 0;
+  memset(cpu_node_, 0, sizeof(cpu_node_));
+  // node ids are dense on the machines we run on, stop at the first hole
+  for (; OB_SUCCESS == ret && node_num < MAX_NODE_NUM; node_num++)
+  {
+    snprintf(path, sizeof(path), "%s/node%ld/cpulist", NUMA_NODE_DIR, node_num);
+    if (OB_SUCCESS != read_sys_file(path, cpu_list, sizeof(cpu_list)))
+    {
+      break;
+    }
+    else if (OB_SUCCESS != (ret = parse_cpu_list(cpu_list, node_cpus_[node_num])))
+    {
+      TBSYS_LOG(WARN, "parse cpu list of node %ld fail, cpu_list=[%s]", node_num, cpu_list);
+    }
+    else
+    {
+      for (int64_t cpu = 0; cpu < MAX_CPU_NUM; cpu++)
+      {
+        if (CPU_ISSET(cpu, &node_cpus_[node_num]))
+        {
+          cpu_node_[cpu] = static_cast<int8_t>(node_num);
+        }
+      }
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    node_num_ = 0 < node_num ? node_num : 1;
+  }
+  return ret;
+}
+
+int ObNumaTopology::parse_cpu_list(const char *cpu_list, cpu_set_t &cpus)
+{
+  int ret = OB_SUCCESS;
+  const char *p = cpu_list;
+  char *end = NULL;
+  CPU_ZERO(&cpus);
+  if (NULL == cpu_list)
+  {
+    ret = OB_INVALID_ARGUMENT;
+  }
+  while (OB_SUCCESS == ret && '\0' != *p && '\n' != *p)
+  {
+    int64_t start = strtol(p, &end, 10);
+    int64_t last = start;
+    if (end == p)
+    {
+      ret = OB_INVALID_ARGUMENT;
+    }
+    else if ('-' == *end)
+    {
+      p = end + 1;
+      last = strtol(p, &end, 10);
+      if (end == p)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+    }
+    if (OB_SUCCESS == ret)
+    {
+      if (start < 0 || last < start || last >= MAX_CPU_NUM)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        for (int64_t cpu = start; cpu <= last; cpu++)
+        {
+          CPU_SET(cpu, &cpus);
+        }
+        p = (',' == *end) ? end + 1 : end;
+      }
+    }
+  }
+  return ret;
+}
+
+int64_t ObNumaTopology::get_current_node() const
+{
+  int64_t node = -1;
+  if (enabled_)
+  {
+    node = get_tsi_bound_node();
+    if (0 > node)
+    {
+      int cpu = sched_getcpu();
+      node = (0 <= cpu && cpu < MAX_CPU_NUM) ? cpu_node_[cpu] : 0;
+    }
+  }
+  return node;
+}
+
+int64_t ObNumaTopology::get_node_by_key(const uint64_t key) const
+{
+  return enabled_ ? static_cast<int64_t>(key % node_num_) : -1;
+}
+
+int ObNumaTopology::bind_thread(const int64_t node)
+{
+  int ret = OB_SUCCESS;
+  int err = 0;
+  if (!enabled_)
+  {
+    ret = OB_NOT_INIT;
+  }
+  else if (0 > node || node >= node_num_)
+  {
+    TBSYS_LOG(WARN, "invalid numa node %ld, node_num=%ld", node, node_num_);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else if (0 != (err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &node_cpus_[node])))
+  {
+    TBSYS_LOG(WARN, "bind thread to numa node %ld fail, err=%d", node, err);
+    ret = OB_ERROR;
+  }
+  else
+  {
+    if (0 <= get_tsi_bound_node())
+    {
+      __sync_add_and_fetch(&stats_[get_tsi_bound_node()].thread_num_, -1);
+    }
+    get_tsi_bound_node() = node;
+    __sync_add_and_fetch(&stats_[node].thread_num_, 1);
+  }
+  return ret;
+}
+
+int64_t ObNumaTopology::bind_thread_round_robin(const int64_t thread_index)
+{
+  int64_t node = -1;
+  if (enabled_ && 0 <= thread_index
+      && OB_SUCCESS == bind_thread(thread_index % node_num_))
+  {
+    node = thread_index % node_num_;
+  }
+  return node;
+}
+
+int64_t ObNumaTopology::get_bound_node_(const int64_t node) const
+{
+  return LOCAL_NODE == node ? get_current_node() : node;
+}
+
+int ObNumaTopology::bind_memory(void *ptr, const int64_t size, const int64_t node)
+{
+  int ret = OB_SUCCESS;
+  const int64_t page_size = sysconf(_SC_PAGESIZE);
+  const int64_t bound_node = get_bound_node_(node);
+  // only whole pages inside the buffer are bound, the pages at both ends
+  // may be shared with other allocations
+  int64_t start = upper_align(reinterpret_cast<int64_t>(ptr), page_size);
+  int64_t end = lower_align(reinterpret_cast<int64_t>(ptr) + size, page_size);
+  unsigned long node_mask = 0;
+  int mode = MPOL_PREFERRED;
+  if (!enabled_ || NULL == ptr || 0 >= size || end <= start)
+  {
+    // nothing to bind
+  }
+  else if (INTERLEAVE_NODE != bound_node && (0 > bound_node || bound_node >= node_num_))
+  {
+    TBSYS_LOG(WARN, "invalid numa node %ld, node_num=%ld", bound_node, node_num_);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else
+  {
+    if (INTERLEAVE_NODE == bound_node)
+    {
+      mode = MPOL_INTERLEAVE;
+      node_mask = (1UL << node_num_) - 1;
+    }
+    else
+    {
+      node_mask = 1UL << bound_node;
+    }
+    if (0 != syscall(__NR_mbind, start, end - start, mode, &node_mask,
+                     sizeof(node_mask) * 8, MPOL_MF_MOVE))
+    {
+      TBSYS_LOG(WARN, "mbind fail, ptr=%p size=%ld node=%ld errno=%d",
+                ptr, size, bound_node, errno);
+      ret = OB_ERROR;
+    }
+    else if (INTERLEAVE_NODE == bound_node)
+    {
+      for (int64_t i = 0; i < node_num_; i++)
+      {
+        __sync_add_and_fetch(&stats_[i].bound_memory_, (end - start) / node_num_);
+      }
+    }
+    else
+    {
+      __sync_add_and_fetch(&stats_[bound_node].bound_memory_, end - start);
+    }
+  }
+  return ret;
+}
+
+void ObNumaTopology::add_request_stat(const int64_t node, const int64_t time_used)
+{
+  if (enabled_ && 0 <= node && node < node_num_)
+  {
+    __sync_add_and_fetch(&stats_[node].request_count_, 1);
+    __sync_add_and_fetch(&stats_[node].request_time_, time_used);
+    if (REACH_TIME_INTERVAL(STAT_PRINT_INTERVAL))
+    {
+      print_stat();
+    }
+  }
+}
+
+const ObNumaTopology::NodeStat *ObNumaTopology::get_node_stat(const int64_t node) const
+{
+  return (0 <= node && node < node_num_) ? &stats_[node] : NULL;
+}
+
+void ObNumaTopology::get_node_meminfo_(const int64_t node, int64_t &total, int64_t &free) const
+{
+  char path[OB_MAX_FILE_NAME_LENGTH];
+  char buf[OB_MAX_FILE_NAME_LENGTH * 4];
+  const char *p = NULL;
+  total = 0;
+  free = 0;
+  snprintf(path, sizeof(path), "%s/node%ld/meminfo", NUMA_NODE_DIR, node);
+  if (OB_SUCCESS == read_sys_file(path, buf, sizeof(buf)))
+  {
+    // lines look like "Node 0 MemTotal:       32898488 kB"
+    if (NULL != (p = strstr(buf, "MemTotal:")))
+    {
+      total = strtol(p + strlen("MemTotal:"), NULL, 10) * 1024;
+    }
+    if (NULL != (p = strstr(buf, "MemFree:")))
+    {
+      free = strtol(p + strlen("MemFree:"), NULL, 10) * 1024;
+    }
+  }
+}
+
+void ObNumaTopology::print_stat() const
+{
+  int64_t mem_total = 0;
+  int64_t mem_free = 0;
+  for (int64_t i = 0; enabled_ && i < node_num_; i++)
+  {
+    get_node_meminfo_(i, mem_total, mem_free);
+    TBSYS_LOG(INFO, "numa node %ld: mem_total=%ld mem_free=%ld bound_memory=%ld "
+              "thread_num=%ld request_count=%ld avg_request_time=%ld",
+              i, mem_total, mem_free, stats_[i].bound_memory_, stats_[i].thread_num_,
+              stats_[i].request_count_,
+              0 == stats_[i].request_count_ ? 0 : stats_[i].request_time_ / stats_[i].request_count_);
+  }
+}
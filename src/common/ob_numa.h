@@ -0,0 +1,102 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_numa.h
+ *
+ * NUMA topology of the local machine. Binds threads to nodes, places
+ * big memory blocks on nodes and keeps per-node statistics. Everything
+ * is a no-op unless init() is called with numa awareness enabled on a
+ * machine with more than one node.
+ */
+#ifndef OCEANBASE_COMMON_OB_NUMA_H_
+#define OCEANBASE_COMMON_OB_NUMA_H_
+
+#include <sched.h>
+#include "ob_define.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObNumaTopology
+    {
+      public:
+        static const int64_t MAX_NODE_NUM = 8;
+        static const int64_t MAX_CPU_NUM = CPU_SETSIZE;
+        // node argument of bind_memory()
+        static const int64_t INTERLEAVE_NODE = -1;
+        static const int64_t LOCAL_NODE = -2;
+        static const int64_t STAT_PRINT_INTERVAL = 60L * 1000L * 1000L;
+
+        struct NodeStat
+        {
+          volatile int64_t thread_num_;
+          // bytes ever bound to the node, the current usage of the node
+          // is read from sysfs
+          volatile int64_t bound_memory_;
+          volatile int64_t request_count_;
+          volatile int64_t request_time_;
+        };
+
+      public:
+        ObNumaTopology();
+        ~ObNumaTopology();
+        static ObNumaTopology &get_instance();
+
+      public:
+        // read the topology from sysfs, disabled if enable is false or
+        // there is only one node
+        int init(const bool enable);
+        bool is_enabled() const
+        {
+          return enabled_;
+        }
+        int64_t get_node_num() const
+        {
+          return node_num_;
+        }
+        // node the calling thread is bound to, or the node of the cpu it
+        // is running on, -1 if disabled
+        int64_t get_current_node() const;
+        // node serving a routing key, -1 if disabled
+        int64_t get_node_by_key(const uint64_t key) const;
+
+        int bind_thread(const int64_t node);
+        // bind the thread_index-th thread of a pool, pools are spread over
+        // the nodes round robin, return the node or -1 if not bound
+        int64_t bind_thread_round_robin(const int64_t thread_index);
+        // set the memory policy of [ptr, ptr + size), node is a node id,
+        // INTERLEAVE_NODE or LOCAL_NODE, pages already touched are moved
+        int bind_memory(void *ptr, const int64_t size, const int64_t node);
+
+        void add_request_stat(const int64_t node, const int64_t time_used);
+        const NodeStat *get_node_stat(const int64_t node) const;
+        void print_stat() const;
+
+      public:
+        // parse a sysfs cpu list like "0-3,8,10-11"
+        static int parse_cpu_list(const char *cpu_list, cpu_set_t &cpus);
+
+      private:
+        int load_topology_();
+        int64_t get_bound_node_(const int64_t node) const;
+        void get_node_meminfo_(const int64_t node, int64_t &total, int64_t &free) const;
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObNumaTopology);
+        bool enabled_;
+        int64_t node_num_;
+        cpu_set_t node_cpus_[MAX_NODE_NUM];
+        int8_t cpu_node_[MAX_CPU_NUM];
+        NodeStat stats_[MAX_NODE_NUM];
+    };
+  }
+}
+
+#endif //OCEANBASE_COMMON_OB_NUMA_H_
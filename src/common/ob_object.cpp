@@ -1121,6 +1121,118 @@ DEFINE_DESERIALIZE(ObObj)
   return ret;
 }
 
+int ObObj::skip(const char* buf, const int64_t data_len, int64_t& pos)
+{
+  int ret = OB_SUCCESS;
+  int64_t tmp_pos = pos;
+  int8_t first_byte = 0;
+  int64_t len = 0;
+
+  if (OB_SUCCESS != (ret = serialization::decode_i8(buf, data_len, tmp_pos, &first_byte)))
+  {
+    // buffer end
+  }
+  else if (serialization::OB_EXTEND_TYPE == first_byte)
+  {
+    int64_t ext_val = 0;
+    ret = serialization::decode_vi64(buf, data_len, tmp_pos, &ext_val);
+  }
+  else if (serialization::OB_DECIMAL_TYPE == first_byte)
+  {
+    // variable length words, let deserialize walk over it
+    ObObj obj;
+    tmp_pos = pos;
+    ret = obj.deserialize(buf, data_len, tmp_pos);
+  }
+  else
+  {
+    switch ((first_byte & 0xc0) >> 6)
+    {
+      case 0:
+      case 1: //int
+        {
+          int8_t len_or_value = static_cast<int8_t>(first_byte & serialization::OB_INT_VALUE_MASK);
+          if (len_or_value > static_cast<int8_t>(serialization::OB_MAX_INT_1B))
+          {
+            len = len_or_value - serialization::OB_MAX_INT_1B;
+          }
+        }
+        break;
+      case 2: //str
+        {
+          int8_t len_or_value = static_cast<int8_t>(first_byte & serialization::OB_VARCHAR_LEN_MASK);
+          if (len_or_value <= serialization::OB_MAX_1B_STR_LEN)
+          {
+            len = len_or_value;
+          }
+          else
+          {
+            int8_t tmp = 0;
+            int64_t str_len = 0;
+            for (int64_t n = 0; OB_SUCCESS == ret && n < len_or_value - serialization::OB_MAX_1B_STR_LEN; ++n)
+            {
+              if (OB_SUCCESS == (ret = serialization::decode_i8(buf, data_len, tmp_pos, &tmp)))
+              {
+                str_len |= (static_cast<int64_t>(static_cast<uint8_t>(tmp)) << (n << 3));
+              }
+            }
+            len = str_len;
+          }
+        }
+        break;
+      default: //other
+        if (static_cast<int8_t>(first_byte & 0xfc) == serialization::OB_NULL_TYPE)
+        {
+          // null: 0xfc, bool: 0xfd
+          len = (serialization::OB_BOOL_TYPE == first_byte) ? 1 : 0;
+        }
+        else if (static_cast<int8_t>(first_byte & 0xfc) == serialization::OB_FLOAT_TYPE)
+        {
+          // float: 0xf8 0xf9, double: 0xfa 0xfb
+          len = (first_byte & 0x02) ? static_cast<int64_t>(sizeof(double)) : static_cast<int64_t>(sizeof(float));
+        }
+        else if (static_cast<int8_t>(first_byte & 0xf0) == serialization::OB_SEQ_TYPE)
+        {
+          len = 0;
+        }
+        else
+        {
+          // datetime, precise datetime, modifytime, createtime
+          switch (first_byte & serialization::OB_DATETIME_LEN_MASK)
+          {
+            case 0:
+              len = 4;
+              break;
+            case 1:
+              len = 6;
+              break;
+            case 2:
+              len = 8;
+              break;
+            default:
+              TBSYS_LOG(ERROR, "invalid time length mark, first_byte=%d", first_byte);
+              ret = OB_ERR_UNEXPECTED;
+              break;
+          }
+        }
+        break;
+    }
+  }
+
+  if (OB_SUCCESS == ret)
+  {
+    if (len < 0 || data_len - tmp_pos < len)
+    {
+      ret = OB_DESERIALIZE_ERROR;
+    }
+    else
+    {
+      pos = tmp_pos + len;
+    }
+  }
+  return ret;
+}
+
 DEFINE_GET_SERIALIZE_SIZE(ObObj)
 {
   ObObjType type = get_type();
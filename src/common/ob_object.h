@@ -102,6 +102,8 @@ namespace oceanbase
         int64_t to_string(char* buffer, const int64_t length) const;
         //
         NEED_SERIALIZE_AND_DESERIALIZE;
+        /// 跳过buf中pos处序列化的一个ObObj，只解析长度，不构造对象
+        static int skip(const char* buf, const int64_t data_len, int64_t& pos);
         /*
          *   获取列值，用户根据已知的数据类型调用相应函数，如果类型不符则返回失败
          */
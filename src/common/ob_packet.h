@@ -338,6 +338,7 @@ namespace oceanbase
       OB_UPS_SHOW_SESSIONS_RESPONSE = 1308,
       OB_UPS_KILL_SESSION = 1309,
       OB_UPS_KILL_SESSION_RESPONSE = 1310,
+      OB_UPS_ASYNC_CHECKPOINT_MEMTABLE = 1311,
 
       OB_GET_CLOG_STAT = 1340,
       OB_GET_CLOG_STAT_RESPONSE = 1341,
@@ -348,6 +349,8 @@ namespace oceanbase
       OB_RS_GET_LAST_FROZEN_VERSION_RESPONSE = 1503,
       OB_RS_CHECK_ROOTTABLE = 1504,
       OB_RS_CHECK_ROOTTABLE_RESPONSE = 1505,
+      OB_RS_GET_MERGE_SCHEDULE = 1506,
+      OB_RS_GET_MERGE_SCHEDULE_RESPONSE = 1507,
 
       OB_GET_INSTANCE_ROLE = 2048,
       OB_GET_INSTANCE_ROLE_RESPONSE = 2049,
@@ -18,6 +18,7 @@
 #include "ob_profile_log.h"
 #include "ob_profile_type.h"
 #include "ob_tsi_factory.h"
+#include "ob_numa.h"
 
 using namespace oceanbase::common;
 
@@ -51,12 +52,18 @@ ObPacketQueueThread::ObPacketQueueThread()
   waiting_ = false;
   handler_ = NULL;
   args_ = NULL;
-  queue_.init();
+  queued_sem_.val_ = 0;
+  queued_sem_.nwaiters_ = 0;
   session_id_ = 1;
   next_wait_map_.create(MAX_THREAD_COUNT);
   max_waiting_thread_count_  = 0;
   waiting_thread_count_ = 0;
   next_packet_buffer_ = NULL;
+  numa_aware_ = false;
+  node_num_ = 0;
+  node_queues_ = NULL;
+  queue_capacity_ = DEFAULT_QUEUE_CAPACITY;
+  pop_batch_num_ = 1;
 }
 
 ObPacketQueueThread::~ObPacketQueueThread()
@@ -68,6 +75,11 @@ ObPacketQueueThread::~ObPacketQueueThread()
     ob_free(next_packet_buffer_);
     next_packet_buffer_ = NULL;
   }
+  if (NULL != node_queues_)
+  {
+    delete [] node_queues_;
+    node_queues_ = NULL;
+  }
 }
 
 void ObPacketQueueThread::setThreadParameter(int thread_count, ObPacketQueueHandler *handler, void* args)
@@ -75,6 +87,7 @@ void ObPacketQueueThread::setThreadParameter(int thread_count, ObPacketQueueHand
   setThreadCount(thread_count);
   handler_ = handler;
   args_ = args;
+  init_queues_();
 
   //default all of threads for wait..
   //FIXME: streaming interface may use all the work threads, we will add
@@ -90,16 +103,150 @@ void ObPacketQueueThread::setThreadParameter(int thread_count, ObPacketQueueHand
   }
 }
 
+void ObPacketQueueThread::set_numa_aware(const bool numa_aware)
+{
+  ObNumaTopology &topology = ObNumaTopology::get_instance();
+  numa_aware_ = numa_aware && topology.is_enabled();
+  if (numa_aware_ && NULL == node_queues_)
+  {
+    node_num_ = topology.get_node_num();
+    node_queues_ = new(std::nothrow) ObFixedQueue<ObPacket>[node_num_];
+    if (NULL == node_queues_)
+    {
+      TBSYS_LOG(WARN, "alloc numa node queues fail, node_num=%ld", node_num_);
+      numa_aware_ = false;
+    }
+    for (int64_t i = 0; NULL != node_queues_ && i < node_num_; i++)
+    {
+      if (OB_SUCCESS != node_queues_[i].init(queue_capacity_))
+      {
+        TBSYS_LOG(WARN, "init numa node queue fail, node=%ld capacity=%ld", i, queue_capacity_);
+        delete [] node_queues_;
+        node_queues_ = NULL;
+        numa_aware_ = false;
+      }
+    }
+  }
+}
+
+void ObPacketQueueThread::set_queue_capacity(const int64_t capacity)
+{
+  if (0 < capacity)
+  {
+    queue_capacity_ = capacity;
+  }
+}
+
+void ObPacketQueueThread::set_pop_batch_num(const int64_t batch_num)
+{
+  if (0 < batch_num && batch_num <= MAX_POP_BATCH_NUM)
+  {
+    pop_batch_num_ = batch_num;
+  }
+  else
+  {
+    TBSYS_LOG(WARN, "invalid pop batch num %ld, keep %ld", batch_num, pop_batch_num_);
+  }
+}
+
+int ObPacketQueueThread::init_queues_()
+{
+  int ret = queue_.init(queue_capacity_);
+  if (OB_INIT_TWICE == ret)
+  {
+    ret = OB_SUCCESS;
+  }
+  else if (OB_SUCCESS != ret)
+  {
+    TBSYS_LOG(ERROR, "init packet queue fail, capacity=%ld ret=%d", queue_capacity_, ret);
+  }
+  return ret;
+}
+
+int64_t ObPacketQueueThread::queued_size_() const
+{
+  int64_t size = queue_.get_total();
+  for (int64_t i = 0; NULL != node_queues_ && i < node_num_; i++)
+  {
+    size += node_queues_[i].get_total();
+  }
+  return size;
+}
+
+ObPacket *ObPacketQueueThread::pop_packet_(const int64_t numa_node)
+{
+  ObPacket *packet = NULL;
+  if (NULL != node_queues_ && 0 <= numa_node && numa_node < node_num_)
+  {
+    node_queues_[numa_node].pop(packet);
+  }
+  if (NULL == packet)
+  {
+    queue_.pop(packet);
+  }
+  // steal from the other nodes rather than stay idle
+  for (int64_t i = 0; NULL == packet && NULL != node_queues_ && i < node_num_; i++)
+  {
+    node_queues_[i].pop(packet);
+  }
+  return packet;
+}
+
+int64_t ObPacketQueueThread::pop_packets_(const int64_t numa_node, ObPacket **packets, const int64_t max_num)
+{
+  int64_t token_num = 0;
+  int64_t packet_num = 0;
+  ObPacket *packet = NULL;
+  timespec end_time;
+  if (0 == futex_wait(&queued_sem_, calc_abs_time(&end_time, QUEUE_WAIT_TIME_NS)))
+  {
+    token_num = 1;
+    while (token_num < max_num && 0 == futex_trywait(&queued_sem_))
+    {
+      token_num++;
+    }
+  }
+  // every token stands for a packet pushed, but the packet may still be
+  // on the way to its slot or taken from another ring by a worker which
+  // owns the token of a packet in our ring
+  while (packet_num < token_num && !_stop)
+  {
+    if (NULL != (packet = pop_packet_(numa_node)))
+    {
+      packets[packet_num++] = packet;
+    }
+    else
+    {
+      PAUSE();
+    }
+  }
+  int64_t now = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < packet_num; i++)
+  {
+    if (0 < packets[i]->get_receive_ts())
+    {
+      wait_time_histogram_.add(now - packets[i]->get_receive_ts());
+    }
+  }
+  if (0 < packet_num && wait_time_histogram_.reach_print_interval())
+  {
+    TBSYS_LOG(INFO, "packet queue %p wait time: %s", this, to_cstring(wait_time_histogram_));
+  }
+  return packet_num;
+}
+
 void ObPacketQueueThread::stop(bool wait_finish)
 {
-  cond_.lock();
-  _stop = true;
   wait_finish_ = wait_finish;
-  cond_.broadcast();
-  cond_.unlock();
+  _stop = true;
+  // wake up the idle workers
+  for (int64_t i = 0; i < _threadCount; i++)
+  {
+    futex_post(&queued_sem_);
+  }
 }
 
-bool ObPacketQueueThread::push(ObPacket* packet, int max_queue_len, bool block)
+bool ObPacketQueueThread::push(ObPacket* packet, int max_queue_len, bool block, int64_t numa_node)
 {
   if (_stop || _thread == NULL)
   {
@@ -115,16 +262,16 @@ bool ObPacketQueueThread::push(ObPacket* packet, int max_queue_len, bool block)
     return true;
   }
 
-  if (max_queue_len > 0 && queue_.size() >= max_queue_len)
+  if (max_queue_len > 0 && queued_size_() >= max_queue_len)
   {
     pushcond_.lock();
     waiting_ = true;
-    while (_stop == false && queue_.size() >= max_queue_len && block)
+    while (_stop == false && queued_size_() >= max_queue_len && block)
     {
       pushcond_.wait(1000);
     }
     waiting_ = false;
-    if (queue_.size() >= max_queue_len && !block)
+    if (queued_size_() >= max_queue_len && !block)
     {
       pushcond_.unlock();
       return false;
@@ -137,11 +284,37 @@ bool ObPacketQueueThread::push(ObPacket* packet, int max_queue_len, bool block)
     }
   }
 
-  cond_.lock();
-  queue_.push(packet);
-  cond_.signal();
-  cond_.unlock();
-  return true;
+  return push_packet_(packet, numa_node, block);
+}
+
+bool ObPacketQueueThread::push_packet_(ObPacket *packet, const int64_t numa_node, const bool block)
+{
+  bool ret = true;
+  int err = OB_SUCCESS;
+  ObFixedQueue<ObPacket> &queue = (NULL != node_queues_ && 0 <= numa_node && numa_node < node_num_)
+    ? node_queues_[numa_node] : queue_;
+  while (OB_SIZE_OVERFLOW == (err = queue.push(packet)) && block && !_stop)
+  {
+    // the ring is full, wait for the workers as if max_queue_len is reached
+    pushcond_.lock();
+    waiting_ = true;
+    pushcond_.wait(1);
+    waiting_ = false;
+    pushcond_.unlock();
+  }
+  if (OB_SUCCESS == err)
+  {
+    futex_post(&queued_sem_);
+  }
+  else if (OB_SIZE_OVERFLOW == err && !block)
+  {
+    ret = false;
+  }
+  else if (!_stop)
+  {
+    TBSYS_LOG(ERROR, "push packet fail, err=%d queued_size=%ld", err, queued_size_());
+  }
+  return ret;
 }
 
 void ObPacketQueueThread::pushQueue(ObPacketQueue& packet_queue, int max_queue_len)
@@ -151,11 +324,11 @@ void ObPacketQueueThread::pushQueue(ObPacketQueue& packet_queue, int max_queue_l
     return;
   }
 
-  if (max_queue_len > 0 && queue_.size() >= max_queue_len)
+  if (max_queue_len > 0 && queued_size_() >= max_queue_len)
   {
     pushcond_.lock();
     waiting_ = true;
-    while (_stop == false && queue_.size() >= max_queue_len)
+    while (_stop == false && queued_size_() >= max_queue_len)
     {
       pushcond_.wait(1000);
     }
@@ -167,10 +340,11 @@ void ObPacketQueueThread::pushQueue(ObPacketQueue& packet_queue, int max_queue_l
     }
   }
 
-  cond_.lock();
-  packet_queue.move_to(&queue_);
-  cond_.signal();
-  cond_.unlock();
+  ObPacket *packet = NULL;
+  while (NULL != (packet = packet_queue.pop()))
+  {
+    push_packet_(packet, -1, true);
+  }
 }
 void ObPacketQueueThread::set_ip_port(const IpPort & ip_port)
 {
@@ -429,30 +603,63 @@ int ObPacketQueueThread::wait_for_next_request(int64_t session_id, ObPacket* &ne
   return ret;
 }
 
+void ObPacketQueueThread::handle_packet_(ObPacket *packet, const int64_t numa_node)
+{
+  TBSYS_LOG(DEBUG, "pop packet code is %d", packet->get_packet_code());
+  int64_t trace_id = packet->get_trace_id();
+  if (0 == trace_id)
+  {
+    //从外部进来的packet，trace id为0
+    TraceId *new_id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
+    (new_id->id).seq_ = atomic_inc(&(SeqGenerator::seq_generator_));
+    (new_id->id).ip_ = ip_port_.ip_;
+    (new_id->id).port_ = ip_port_.port_;
+    //产生一个trace id
+    packet->set_trace_id(new_id->uval_);
+  }
+  else
+  {
+    TraceId *id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
+    id->uval_ = static_cast<uint64_t>(trace_id);
+  }
+  uint32_t *src_channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_SOURCE_CHID_1);
+  //将来源包的chid设置到线程中
+  *src_channel_id = packet->get_channel_id();
+  // reset
+  uint32_t *channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_CHID_1);
+  *channel_id = 0;
+  int64_t st = tbsys::CTimeUtil::getTime();
+  //这个时候仅仅是有来源包，还没有开始发包，所有chid id设置为0
+  PROFILE_LOG(DEBUG, HANDLE_PACKET_START_TIME PCODE, st, packet->get_packet_code());
+  handler_->handlePacketQueue(packet, args_);
+  int64_t ed = tbsys::CTimeUtil::getTime();
+  //这里已经有了chid id了
+  PROFILE_LOG(DEBUG, HANDLE_PACKET_END_TIME PCODE, ed, packet->get_packet_code());
+  if (0 <= numa_node)
+  {
+    ObNumaTopology::get_instance().add_request_stat(numa_node, ed - st);
+  }
+}
+
 void ObPacketQueueThread::run(tbsys::CThread* thread, void* args)
 {
   UNUSED(thread);
 
   long thread_no = reinterpret_cast<long>(args);
   set_thread_no(thread_no);
+  int64_t numa_node = -1;
+  if (numa_aware_)
+  {
+    numa_node = ObNumaTopology::get_instance().bind_thread_round_robin(thread_no);
+  }
   ObServer *host = GET_TSI_MULT(ObServer, TSI_COMMON_OBSERVER_1);
   *host = host_;
+  ObPacket* packets[MAX_POP_BATCH_NUM];
   ObPacket* packet = NULL;
+  int64_t packet_num = 0;
   while (!_stop)
   {
-    cond_.lock();
-    while (!_stop && queue_.size() == 0)
-    {
-      cond_.wait();
-    }
-    if (_stop)
-    {
-      cond_.unlock();
-      break;
-    }
-
-    packet = (ObPacket*)queue_.pop();
-    cond_.unlock();
+    packet_num = pop_packets_(numa_node, packets, pop_batch_num_);
 
     if (waiting_)
     {
@@ -461,78 +668,18 @@ void ObPacketQueueThread::run(tbsys::CThread* thread, void* args)
       pushcond_.unlock();
     }
 
-    if (packet == NULL) continue;
-
-    if (handler_)
+    for (int64_t i = 0; NULL != handler_ && i < packet_num; i++)
     {
-      TBSYS_LOG(DEBUG, "pop packet code is %d", packet->get_packet_code());
-      int64_t trace_id = packet->get_trace_id();
-      if (0 == trace_id)
-      {
-        TraceId *new_id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-        (new_id->id).seq_ = atomic_inc(&(SeqGenerator::seq_generator_));
-        (new_id->id).ip_ = ip_port_.ip_;
-        (new_id->id).port_ = ip_port_.port_;
-        packet->set_trace_id(new_id->uval_);
-      }
-      else
-      {
-        TraceId *id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-        id->uval_ = static_cast<uint64_t>(trace_id);
-      }
-      uint32_t *src_channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_SOURCE_CHID_1);
-      //将来源包的chid设置到线程中
-      *src_channel_id = packet->get_channel_id();
-      // reset
-      uint32_t *channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_CHID_1);
-      *channel_id = 0;
-      int64_t st = tbsys::CTimeUtil::getTime();
-      PROFILE_LOG(DEBUG, HANDLE_PACKET_START_TIME PCODE, st, packet->get_packet_code());
-      handler_->handlePacketQueue(packet, args_);
-      int64_t ed = tbsys::CTimeUtil::getTime();
-      PROFILE_LOG(DEBUG, HANDLE_PACKET_END_TIME PCODE, ed, packet->get_packet_code());
+      handle_packet_(packets[i], numa_node);
     }
   }
-  cond_.lock();
-  while (queue_.size() > 0)
+  while (NULL != (packet = pop_packet_(numa_node)))
   {
-    packet = (ObPacket*)queue_.pop();
-    cond_.unlock();
     if (handler_ && wait_finish_)
     {
-      TBSYS_LOG(DEBUG, "pop packet code is %d", packet->get_packet_code());
-      int64_t trace_id = packet->get_trace_id();
-      if (0 == trace_id)
-      {
-        //从外部进来的packet，trace id为0
-        TraceId *new_id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-        (new_id->id).seq_ = atomic_inc(&(SeqGenerator::seq_generator_));
-        (new_id->id).ip_ = ip_port_.ip_;
-        (new_id->id).port_ = ip_port_.port_;
-        //产生一个trace id
-        packet->set_trace_id(new_id->uval_);
-      }
-      else
-      {
-        TraceId *id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-        id->uval_ = static_cast<uint64_t>(trace_id);
-      }
-      uint32_t *src_channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_SOURCE_CHID_1);
-      *src_channel_id = packet->get_channel_id();
-      // reset
-      uint32_t *channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_CHID_1);
-      *channel_id = 0;
-      int64_t st = tbsys::CTimeUtil::getTime();
-      //这个时候仅仅是有来源包，还没有开始发包，所有chid id设置为0
-      PROFILE_LOG(DEBUG, HANDLE_PACKET_START_TIME PCODE, st, packet->get_packet_code());
-      handler_->handlePacketQueue(packet, args_);
-      int64_t ed = tbsys::CTimeUtil::getTime();
-      //这里已经有了chid id了
-      PROFILE_LOG(DEBUG, HANDLE_PACKET_END_TIME PCODE, ed, packet->get_packet_code());
+      handle_packet_(packet, numa_node);
     }
-    cond_.lock();
   }
-  cond_.unlock();
 }
 
 void ObPacketQueueThread::clear()
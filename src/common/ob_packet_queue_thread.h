@@ -19,6 +19,9 @@
 #include "ob_define.h"
 #include "ob_packet.h"
 #include "ob_packet_queue.h"
+#include "ob_fixed_queue.h"
+#include "ob_wait_time_histogram.h"
+#include "futex_sem.h"
 #include "hash/ob_hashmap.h"
 #include "ob_trace_id.h"
 #include "ob_server.h"
@@ -27,8 +30,16 @@ namespace oceanbase
 {
   namespace common
   {
+    /**
+     * packets are kept in lock free rings, idle workers sleep on a futex
+     * semaphore counting the queued packets.
+     */
     class ObPacketQueueThread : public tbsys::CDefaultRunnable
     {
+      public:
+        static const int64_t DEFAULT_QUEUE_CAPACITY = 64L * 1024L;
+        static const int64_t MAX_POP_BATCH_NUM = 64;
+
       public:
         ObPacketQueueThread();
 
@@ -38,24 +49,40 @@ namespace oceanbase
 
         void stop(bool waitFinish = false);
 
-        bool push(ObPacket *packet, int maxQueueLen = 0, bool block = true);
+        /**
+         * bind the worker threads to numa nodes round robin, each node gets
+         * its own queue. call before start(), no effect if numa awareness
+         * is not enabled in ObNumaTopology.
+         */
+        void set_numa_aware(const bool numa_aware);
+
+        /**
+         * max number of packets each ring can hold, call before
+         * setThreadParameter() and set_numa_aware().
+         */
+        void set_queue_capacity(const int64_t capacity);
+
+        /**
+         * a worker takes up to batch_num queued packets at a time and
+         * handles them in turn, 1 by default.
+         */
+        void set_pop_batch_num(const int64_t batch_num);
+
+        /**
+         * numa_node is the node whose workers should handle the packet,
+         * -1 means any worker. workers of other nodes take the packet
+         * when they are idle.
+         */
+        bool push(ObPacket *packet, int maxQueueLen = 0, bool block = true, int64_t numa_node = -1);
 
         void pushQueue(ObPacketQueue &packetQueue, int maxQueueLen = 0);
         void set_ip_port(const IpPort & ip_port);
         void set_host(const ObServer &host);
         void run(tbsys::CThread *thread, void *arg);
 
-        ObPacket *head()
-        {
-          return queue_.head();
-        }
-        ObPacket *tail()
-        {
-          return queue_.tail();
-        }
         size_t size() const
         {
-          return queue_.size();
+          return queued_size_();
         }
 
         void clear();
@@ -84,16 +111,31 @@ namespace oceanbase
         inline void set_max_wait_thread_count(const uint64_t max_wait_count) 
         { max_waiting_thread_count_ = max_wait_count; }
 
+        const ObWaitTimeHistogram &get_wait_time_histogram() const
+        {
+          return wait_time_histogram_;
+        }
+
       protected:
         bool wait_finish_; 
         bool waiting_;
-        ObPacketQueue queue_;
+        ObFixedQueue<ObPacket> queue_;
         ObPacketQueueHandler* handler_;
-        tbsys::CThreadCond cond_;
+        // number of packets in all the rings
+        fsem_t queued_sem_;
         tbsys::CThreadCond pushcond_;
 
         void* args_;
 
+      private:
+        static const int64_t QUEUE_WAIT_TIME_NS = 100L * 1000L * 1000L;
+        int init_queues_();
+        int64_t queued_size_() const;
+        bool push_packet_(ObPacket *packet, const int64_t numa_node, const bool block);
+        ObPacket *pop_packet_(const int64_t numa_node);
+        int64_t pop_packets_(const int64_t numa_node, ObPacket **packets, const int64_t max_num);
+        void handle_packet_(ObPacket *packet, const int64_t numa_node);
+
       private:
         struct WaitObject
         {
@@ -123,6 +165,12 @@ namespace oceanbase
         IpPort ip_port_;
         ObServer host_;
         char* next_packet_buffer_;
+        bool numa_aware_;
+        int64_t node_num_;
+        ObFixedQueue<ObPacket> *node_queues_;
+        int64_t queue_capacity_;
+        int64_t pop_batch_num_;
+        ObWaitTimeHistogram wait_time_histogram_;
     };
 
   } // end namespace common
@@ -0,0 +1,379 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_query_profile.cpp
+ */
+#include "ob_query_profile.h"
+#include <time.h>
+#include <algorithm>
+#include "tbsys.h"
+#include "ob_atomic.h"
+#include "ob_common_stat.h"
+#include "ob_new_scanner.h"
+#include "ob_row.h"
+#include "ob_row_desc.h"
+#include "utility.h"
+
+using namespace oceanbase::common;
+
+namespace
+{
+  ObRpcProfile &get_tsi_rpc_profile()
+  {
+    static __thread ObRpcProfile rpc_profile;
+    return rpc_profile;
+  }
+
+  ObQueryProfile *&get_tsi_query_profile()
+  {
+    static __thread ObQueryProfile *query_profile = NULL;
+    return query_profile;
+  }
+}
+
+ObRpcProfile &ObRpcProfile::operator +=(const ObRpcProfile &other)
+{
+  server_time_ += other.server_time_;
+  ups_time_ += other.ups_time_;
+  block_cache_hit_ += other.block_cache_hit_;
+  block_cache_miss_ += other.block_cache_miss_;
+  io_bytes_ += other.io_bytes_;
+  return *this;
+}
+
+int64_t ObRpcProfile::to_string(char *buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "server_time=%ld ups_time=%ld block_cache_hit=%ld "
+                  "block_cache_miss=%ld io_bytes=%ld", server_time_, ups_time_,
+                  block_cache_hit_, block_cache_miss_, io_bytes_);
+  return pos;
+}
+
+ObRpcProfile &ObRpcProfile::get_tsi()
+{
+  return get_tsi_rpc_profile();
+}
+
+void ObRpcProfile::add_sstable_stat(const int32_t index, const int64_t value)
+{
+  ObRpcProfile &profile = get_tsi_rpc_profile();
+  switch (index)
+  {
+    case INDEX_BLOCK_CACHE_HIT:
+      profile.block_cache_hit_ += value;
+      break;
+    case INDEX_BLOCK_CACHE_MISS:
+      profile.block_cache_miss_ += value;
+      break;
+    case INDEX_DISK_IO_BYTES:
+      profile.io_bytes_ += value;
+      break;
+    default:
+      break;
+  }
+}
+
+void ObRpcProfile::add_ups_time(const int64_t time_used)
+{
+  get_tsi_rpc_profile().ups_time_ += time_used;
+}
+
+int64_t ObOperatorProfile::to_string(char *buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "%*s%s(rows_in=%ld rows_out=%ld wall=%ld cpu=%ld mem=%ld)",
+                  depth_ * 2, "", name_, rows_in_, rows_out_, wall_time_, cpu_time_, mem_hwm_);
+  return pos;
+}
+
+volatile int64_t ObQueryProfile::global_seq_ = 0;
+
+ObQueryProfile::ObQueryProfile()
+{
+  reset();
+}
+
+ObQueryProfile::~ObQueryProfile()
+{
+}
+
+void ObQueryProfile::reset()
+{
+  seq_ = 0;
+  trace_id_ = 0;
+  query_[0] = '\0';
+  query_length_ = 0;
+  start_time_ = 0;
+  start_cpu_time_ = 0;
+  elapsed_time_ = 0;
+  cpu_time_ = 0;
+  rpc_count_ = 0;
+  rpc_time_ = 0;
+  rpc_profile_.reset();
+  op_num_ = 0;
+}
+
+ObQueryProfile *ObQueryProfile::get_current()
+{
+  return get_tsi_query_profile();
+}
+
+void ObQueryProfile::set_current(ObQueryProfile *profile)
+{
+  get_tsi_query_profile() = profile;
+}
+
+int64_t ObQueryProfile::get_thread_cpu_time()
+{
+  struct timespec ts;
+  int64_t cpu_time = 0;
+  if (0 == clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+  {
+    cpu_time = ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
+  }
+  return cpu_time;
+}
+
+void ObQueryProfile::start(const uint64_t trace_id, const ObString &query, const int64_t start_time)
+{
+  reset();
+  seq_ = atomic_inc(reinterpret_cast<volatile uint64_t*>(&global_seq_));
+  trace_id_ = trace_id;
+  query_length_ = std::min(query.length(), static_cast<int32_t>(MAX_QUERY_LENGTH - 1));
+  if (0 < query_length_)
+  {
+    memcpy(query_, query.ptr(), query_length_);
+  }
+  query_[query_length_] = '\0';
+  start_time_ = start_time;
+  start_cpu_time_ = get_thread_cpu_time();
+}
+
+void ObQueryProfile::finish(const int64_t end_time)
+{
+  elapsed_time_ = end_time - start_time_;
+  cpu_time_ = get_thread_cpu_time() - start_cpu_time_;
+  // slots are in pre-order, the children of an operator are the
+  // following slots one level deeper until the depth goes back
+  for (int64_t i = 0; i < op_num_; i++)
+  {
+    ops_[i].rows_in_ = 0;
+    for (int64_t j = i + 1; j < op_num_ && ops_[j].depth_ > ops_[i].depth_; j++)
+    {
+      if (ops_[j].depth_ == ops_[i].depth_ + 1)
+      {
+        ops_[i].rows_in_ += ops_[j].rows_out_;
+      }
+    }
+  }
+}
+
+ObOperatorProfile *ObQueryProfile::add_operator(const char *name, const int32_t depth)
+{
+  ObOperatorProfile *op = NULL;
+  if (op_num_ < MAX_OPERATOR_NUM)
+  {
+    op = &ops_[op_num_++];
+    memset(op, 0, sizeof(*op));
+    snprintf(op->name_, sizeof(op->name_), "%s", NULL == name ? "" : name);
+    op->depth_ = depth;
+  }
+  return op;
+}
+
+void ObQueryProfile::add_rpc(const int64_t rpc_time, const ObRpcProfile &rpc_profile)
+{
+  rpc_count_++;
+  rpc_time_ += rpc_time;
+  rpc_profile_ += rpc_profile;
+}
+
+int64_t ObQueryProfile::operators_to_string(char *buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  for (int64_t i = 0; i < op_num_ && pos < buf_len; i++)
+  {
+    if (0 < i)
+    {
+      databuff_printf(buf, buf_len, pos, "\n");
+    }
+    pos += ops_[i].to_string(buf + pos, buf_len - pos);
+  }
+  return pos;
+}
+
+int64_t ObQueryProfile::to_string(char *buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "trace_id=%lu elapsed=%ld cpu=%ld rows=%ld rpc_count=%ld "
+                  "rpc_time=%ld ", trace_id_, elapsed_time_, cpu_time_, get_row_count(),
+                  rpc_count_, rpc_time_);
+  if (pos < buf_len)
+  {
+    pos += rpc_profile_.to_string(buf + pos, buf_len - pos);
+  }
+  databuff_printf(buf, buf_len, pos, " query=\"%s\"", query_);
+  return pos;
+}
+
+ObSlowQueryLog::ObSlowQueryLog() : total_count_(0)
+{
+  pthread_spin_init(&lock_, PTHREAD_PROCESS_PRIVATE);
+}
+
+ObSlowQueryLog::~ObSlowQueryLog()
+{
+  pthread_spin_destroy(&lock_);
+}
+
+ObSlowQueryLog &ObSlowQueryLog::get_instance()
+{
+  static ObSlowQueryLog instance;
+  return instance;
+}
+
+void ObSlowQueryLog::add(const ObQueryProfile &profile)
+{
+  pthread_spin_lock(&lock_);
+  queries_[total_count_ % MAX_SLOW_QUERY_NUM] = profile;
+  total_count_++;
+  pthread_spin_unlock(&lock_);
+}
+
+int64_t ObSlowQueryLog::get_count() const
+{
+  return std::min(total_count_, MAX_SLOW_QUERY_NUM);
+}
+
+int ObSlowQueryLog::get(const int64_t idx, ObQueryProfile &profile) const
+{
+  int ret = OB_SUCCESS;
+  pthread_spin_lock(&lock_);
+  int64_t count = std::min(total_count_, MAX_SLOW_QUERY_NUM);
+  if (0 > idx || idx >= count)
+  {
+    ret = OB_ENTRY_NOT_EXIST;
+  }
+  else
+  {
+    profile = queries_[(total_count_ - count + idx) % MAX_SLOW_QUERY_NUM];
+  }
+  pthread_spin_unlock(&lock_);
+  return ret;
+}
+
+void ObSlowQueryLog::clear()
+{
+  pthread_spin_lock(&lock_);
+  total_count_ = 0;
+  pthread_spin_unlock(&lock_);
+}
+
+int ObSlowQueryLog::get_scanner(const ObRole role, const ObServer &server, ObNewScanner &scanner) const
+{
+  int ret = OB_SUCCESS;
+  char ipbuf[OB_IP_STR_BUFF] = {0};
+  char trace_id_buf[32] = {0};
+  char profile_buf[MAX_PROFILE_STR_LENGTH];
+  server.ip_to_string(ipbuf, sizeof(ipbuf));
+  ObString ipstr = ObString::make_string(ipbuf);
+  ObString server_name = ObString::make_string(print_role(role));
+  const int32_t port = server.get_port();
+  ObQueryProfile profile;
+  ObRowDesc row_desc;
+  ObRow row;
+  ObObj obj;
+  int64_t row_count = 0;
+  int64_t last_seq = 0;
+  int32_t column_id = OB_APP_MIN_COLUMN_ID;
+  for (int64_t i = 0; i < COLUMN_NUM; i++)
+  {
+    row_desc.add_column_desc(OB_ALL_SLOW_QUERY_TID, column_id++);
+  }
+  row_desc.set_rowkey_cell_count(4);
+  for (int64_t i = 0; OB_SUCCESS == ret && OB_SUCCESS == get(i, profile); i++)
+  {
+    column_id = OB_APP_MIN_COLUMN_ID;
+    row.reset(false, ObRow::DEFAULT_NULL);
+    row.set_row_desc(row_desc);
+    /* rowkey: server type, ip, port, seq */
+    obj.set_varchar(server_name);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_varchar(ipstr);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(port);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.seq_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    /* trace id */
+    snprintf(trace_id_buf, sizeof(trace_id_buf), "%lu", profile.trace_id_);
+    obj.set_varchar(ObString::make_string(trace_id_buf));
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_precise_datetime(profile.start_time_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.elapsed_time_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.cpu_time_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.get_row_count());
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    /* rpc profile */
+    obj.set_int(profile.rpc_count_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.rpc_time_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.rpc_profile_.server_time_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.rpc_profile_.ups_time_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.rpc_profile_.block_cache_hit_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.rpc_profile_.block_cache_miss_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    obj.set_int(profile.rpc_profile_.io_bytes_);
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    /* query and operator profiles */
+    obj.set_varchar(ObString(0, profile.query_length_, profile.query_));
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+    int64_t profile_len = profile.operators_to_string(profile_buf, sizeof(profile_buf));
+    obj.set_varchar(ObString(0, static_cast<int32_t>(profile_len), profile_buf));
+    row.set_cell(OB_ALL_SLOW_QUERY_TID, column_id++, obj);
+
+    if (OB_SUCCESS != (ret = scanner.add_row(row)))
+    {
+      TBSYS_LOG(WARN, "add slow query row to scanner fail, ret=%d row_count=%ld", ret, row_count);
+    }
+    else
+    {
+      last_seq = profile.seq_;
+      row_count++;
+    }
+  }
+  if (OB_SIZE_OVERFLOW == ret)
+  {
+    // the oldest queries are enough for one packet
+    ret = OB_SUCCESS;
+  }
+  if (OB_SUCCESS == ret && 0 < row_count)
+  {
+    ObObj rk_objs[4];
+    rk_objs[0].set_varchar(server_name);
+    rk_objs[1].set_varchar(ipstr);
+    rk_objs[2].set_int(port);
+    rk_objs[3].set_int(last_seq);
+    ObRowkey rowkey(rk_objs, 4);
+    ret = scanner.set_last_row_key(rowkey);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    scanner.set_is_req_fullfilled(true, row_count);
+  }
+  return ret;
+}
@@ -0,0 +1,175 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_query_profile.h
+ *
+ * Per query resource accounting. A chunkserver fills an ObRpcProfile
+ * while serving one sql read and sends it back in the ObNewScanner, the
+ * mergeserver adds the rpc profiles and the profile of every physical
+ * operator into the ObQueryProfile of the query, and queries slower
+ * than slow_query_threshold are kept in ObSlowQueryLog, which is the
+ * content of the __all_slow_query virtual table.
+ */
+#ifndef OCEANBASE_COMMON_OB_QUERY_PROFILE_H_
+#define OCEANBASE_COMMON_OB_QUERY_PROFILE_H_
+
+#include <pthread.h>
+#include "ob_define.h"
+#include "ob_string.h"
+#include "ob_server.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObNewScanner;
+
+    /// resource usage of one rpc on the server side, no constructor so
+    /// that it can be kept in a __thread variable
+    struct ObRpcProfile
+    {
+      // number of int fields in the serialized form
+      static const int64_t FIELD_NUM = 5;
+
+      int64_t server_time_;
+      // part of server_time_ spent waiting for updateserver
+      int64_t ups_time_;
+      int64_t block_cache_hit_;
+      int64_t block_cache_miss_;
+      int64_t io_bytes_;
+
+      void reset()
+      {
+        server_time_ = 0;
+        ups_time_ = 0;
+        block_cache_hit_ = 0;
+        block_cache_miss_ = 0;
+        io_bytes_ = 0;
+      }
+      bool is_empty() const
+      {
+        return 0 == server_time_ && 0 == ups_time_ && 0 == block_cache_hit_
+          && 0 == block_cache_miss_ && 0 == io_bytes_;
+      }
+      ObRpcProfile &operator +=(const ObRpcProfile &other);
+      int64_t to_string(char *buf, const int64_t buf_len) const;
+
+      /// counters of the request the calling thread is serving
+      static ObRpcProfile &get_tsi();
+      /// called by ObStatManager for every sstable statistic
+      static void add_sstable_stat(const int32_t index, const int64_t value);
+      /// called by the chunkserver around every rpc to updateserver
+      static void add_ups_time(const int64_t time_used);
+    };
+
+    struct ObOperatorProfile
+    {
+      static const int64_t MAX_NAME_LENGTH = 32;
+
+      char name_[MAX_NAME_LENGTH];
+      int32_t depth_;
+      // sum of rows_out_ of the children, filled by ObQueryProfile::finish
+      int64_t rows_in_;
+      int64_t rows_out_;
+      // wall time of open, get_next_row and close, children included,
+      // get_next_row is sampled, see ObProfileOperator
+      int64_t wall_time_;
+      // cpu time of open and close, children included
+      int64_t cpu_time_;
+      int64_t mem_hwm_;
+
+      int64_t to_string(char *buf, const int64_t buf_len) const;
+    };
+
+    class ObQueryProfile
+    {
+      public:
+        static const int64_t MAX_OPERATOR_NUM = 32;
+        static const int64_t MAX_QUERY_LENGTH = 512;
+
+      public:
+        ObQueryProfile();
+        ~ObQueryProfile();
+        void reset();
+
+        /// profile of the query the calling thread is executing, NULL if
+        /// the query is not profiled
+        static ObQueryProfile *get_current();
+        static void set_current(ObQueryProfile *profile);
+        static int64_t get_thread_cpu_time();
+
+        void start(const uint64_t trace_id, const ObString &query, const int64_t start_time);
+        void finish(const int64_t end_time);
+
+        /// the operators open in pre-order and get a slot with the depth
+        /// of the operator in the plan, NULL if there is no slot left
+        ObOperatorProfile *add_operator(const char *name, const int32_t depth);
+        void add_rpc(const int64_t rpc_time, const ObRpcProfile &rpc_profile);
+
+        int64_t get_seq() const { return seq_; }
+        int64_t get_elapsed_time() const { return elapsed_time_; }
+        int64_t get_row_count() const { return op_num_ > 0 ? ops_[0].rows_out_ : 0; }
+        int64_t get_operator_num() const { return op_num_; }
+        const ObOperatorProfile &get_operator(const int64_t idx) const { return ops_[idx]; }
+        const ObRpcProfile &get_rpc_profile() const { return rpc_profile_; }
+        int64_t to_string(char *buf, const int64_t buf_len) const;
+        int64_t operators_to_string(char *buf, const int64_t buf_len) const;
+
+      private:
+        friend class ObSlowQueryLog;
+        // executions of all queries, identifies the execution an operator
+        // slot belongs to
+        static volatile int64_t global_seq_;
+        int64_t seq_;
+        uint64_t trace_id_;
+        char query_[MAX_QUERY_LENGTH];
+        int32_t query_length_;
+        int64_t start_time_;
+        int64_t start_cpu_time_;
+        int64_t elapsed_time_;
+        int64_t cpu_time_;
+        int64_t rpc_count_;
+        int64_t rpc_time_;
+        ObRpcProfile rpc_profile_;
+        int64_t op_num_;
+        ObOperatorProfile ops_[MAX_OPERATOR_NUM];
+    };
+
+    /// ring buffer of the latest slow queries
+    class ObSlowQueryLog
+    {
+      public:
+        static const int64_t MAX_SLOW_QUERY_NUM = 128;
+        static const int64_t MAX_PROFILE_STR_LENGTH = 2048;
+        // columns of __all_slow_query, see ObExtraTablesSchema
+        static const int64_t COLUMN_NUM = 18;
+
+      public:
+        ObSlowQueryLog();
+        ~ObSlowQueryLog();
+        static ObSlowQueryLog &get_instance();
+
+        void add(const ObQueryProfile &profile);
+        int64_t get_count() const;
+        /// copy the idx-th oldest query kept, idx in [0, get_count())
+        int get(const int64_t idx, ObQueryProfile &profile) const;
+        void clear();
+        /// rows of __all_slow_query served by this server
+        int get_scanner(const ObRole role, const ObServer &server, ObNewScanner &scanner) const;
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObSlowQueryLog);
+        mutable pthread_spinlock_t lock_;
+        int64_t total_count_;
+        ObQueryProfile queries_[MAX_SLOW_QUERY_NUM];
+    };
+  }
+}
+
+#endif //OCEANBASE_COMMON_OB_QUERY_PROFILE_H_
@@ -0,0 +1,190 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_read_ahead.cpp
+ *
+ */
+#include "ob_read_ahead.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    ObReadAhead::ObReadAhead(const int64_t slot_num)
+      : slot_num_(slot_num), thread_(), started_(false), thread_started_(false),
+        stop_(false), end_(false), end_ret_(OB_SUCCESS), produced_(0), consumed_(0),
+        has_cur_slot_(false), cond_()
+    {
+    }
+
+    ObReadAhead::~ObReadAhead()
+    {
+      stop();
+    }
+
+    int ObReadAhead::start()
+    {
+      int ret = OB_SUCCESS;
+
+      if (thread_started_)
+      {
+        TBSYS_LOG(WARN, "read ahead has been started");
+        ret = OB_INIT_TWICE;
+      }
+      else if (slot_num_ <= 0)
+      {
+        TBSYS_LOG(WARN, "invalid slot_num=%ld", slot_num_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        stop_ = false;
+        end_ = false;
+        end_ret_ = OB_SUCCESS;
+        produced_ = 0;
+        consumed_ = 0;
+        has_cur_slot_ = false;
+        started_ = true;
+        int err = pthread_create(&thread_, NULL, thread_func_, this);
+        if (0 != err)
+        {
+          TBSYS_LOG(WARN, "create read ahead thread failed errno=%d, "
+              "will fill slots synchronously", err);
+        }
+        else
+        {
+          thread_started_ = true;
+        }
+      }
+
+      return ret;
+    }
+
+    void ObReadAhead::stop()
+    {
+      if (thread_started_)
+      {
+        cond_.lock();
+        stop_ = true;
+        cond_.broadcast();
+        cond_.unlock();
+        pthread_join(thread_, NULL);
+        thread_started_ = false;
+      }
+    }
+
+    int ObReadAhead::next_slot(int64_t &slot_idx)
+    {
+      int ret = OB_SUCCESS;
+
+      if (!started_)
+      {
+        TBSYS_LOG(WARN, "read ahead has not been started");
+        ret = OB_NOT_INIT;
+      }
+      else if (!thread_started_)
+      {
+        ret = fill_sync_(slot_idx);
+      }
+      else
+      {
+        cond_.lock();
+        if (has_cur_slot_)
+        {
+          consumed_++;
+          has_cur_slot_ = false;
+          cond_.signal();
+        }
+        while (consumed_ >= produced_ && !end_)
+        {
+          cond_.wait();
+        }
+        if (consumed_ < produced_)
+        {
+          slot_idx = consumed_ % slot_num_;
+          has_cur_slot_ = true;
+        }
+        else
+        {
+          ret = end_ret_;
+        }
+        cond_.unlock();
+      }
+
+      return ret;
+    }
+
+    int ObReadAhead::fill_sync_(int64_t &slot_idx)
+    {
+      int ret = OB_SUCCESS;
+      bool filled = false;
+
+      while (!end_ && !filled)
+      {
+        if (OB_SUCCESS != (end_ret_ = fill_slot(0, filled)))
+        {
+          end_ = true;
+        }
+      }
+      if (filled)
+      {
+        slot_idx = 0;
+      }
+      else
+      {
+        ret = end_ret_;
+      }
+
+      return ret;
+    }
+
+    void *ObReadAhead::thread_func_(void *arg)
+    {
+      ObReadAhead *self = reinterpret_cast<ObReadAhead *>(arg);
+      if (NULL != self)
+      {
+        self->produce_();
+      }
+      return NULL;
+    }
+
+    void ObReadAhead::produce_()
+    {
+      bool end = false;
+      while (!end)
+      {
+        cond_.lock();
+        while (!stop_ && slot_num_ <= produced_ - consumed_)
+        {
+          cond_.wait();
+        }
+        end = stop_;
+        cond_.unlock();
+        if (!end)
+        {
+          bool filled = false;
+          int ret = fill_slot(produced_ % slot_num_, filled);
+          cond_.lock();
+          if (filled)
+          {
+            produced_++;
+          }
+          if (OB_SUCCESS != ret)
+          {
+            end_ret_ = ret;
+            end_ = true;
+            end = true;
+          }
+          cond_.signal();
+          cond_.unlock();
+        }
+      }
+    }
+  }
+}
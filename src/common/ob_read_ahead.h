@@ -0,0 +1,76 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_read_ahead.h
+ *
+ * Bounded read ahead with one producer thread. The producer fills
+ * slots of a ring of slot_num slots in order, the consumer gets them
+ * in the same order and gives one back when it asks for the next, so
+ * at most slot_num slots are filled ahead of the consumer. The slots
+ * themselves are owned by the derived class, which only knows how to
+ * fill the slot of a given index. If the producer thread cannot be
+ * created, the slots are filled synchronously in the consumer thread.
+ */
+#ifndef OCEANBASE_COMMON_OB_READ_AHEAD_H_
+#define OCEANBASE_COMMON_OB_READ_AHEAD_H_
+
+#include <pthread.h>
+#include <tbsys.h>
+#include "ob_define.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObReadAhead
+    {
+    public:
+      explicit ObReadAhead(const int64_t slot_num);
+      // derived class must call stop() in its destructor before the
+      // slots are freed, the producer may still be filling one
+      virtual ~ObReadAhead();
+
+    public:
+      int start();
+      // stop the producer, safe to call more than once
+      void stop();
+      // get index of next filled slot, the slot is valid until next call
+      // @return error of fill_slot() after all filled slots have been
+      //         returned, OB_ITER_END if the data ends normally
+      int next_slot(int64_t &slot_idx);
+
+    protected:
+      // fill the slot of slot_idx with next data, called in the producer
+      // thread only. set filled if the slot has data to hand over, return
+      // OB_ITER_END or an error to end the read ahead after this slot.
+      virtual int fill_slot(const int64_t slot_idx, bool &filled) = 0;
+
+    private:
+      static void *thread_func_(void *arg);
+      void produce_();
+      int fill_sync_(int64_t &slot_idx);
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(ObReadAhead);
+      int64_t slot_num_;
+      pthread_t thread_;
+      bool started_;
+      bool thread_started_;
+      bool stop_;
+      bool end_;
+      int end_ret_;
+      int64_t produced_;
+      int64_t consumed_;
+      bool has_cur_slot_;
+      tbsys::CThreadCond cond_;
+    };
+  }
+}
+
+#endif /* OCEANBASE_COMMON_OB_READ_AHEAD_H_ */
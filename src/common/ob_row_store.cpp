@@ -412,6 +412,73 @@ int ObRowStore::add_row(const ObRowkey *rowkey, const ObRow &row, const StoredRo
   return ret;
 }
 
+int ObRowStore::add_compact_row(const ObString &compact_row, int64_t &cur_size_counter)
+{
+  int ret = OB_SUCCESS;
+  const int64_t reserved_size = get_reserved_cells_size(0);
+  const int64_t row_size = reserved_size + compact_row.length();
+
+  rollback_block_list_ = block_list_head_;
+  rollback_iter_pos_ = ((block_list_head_==NULL) ? (-1) : block_list_head_->get_curr_data_pos());
+
+  if (0 != reserved_columns_.count())
+  {
+    ret = OB_NOT_SUPPORTED;
+    TBSYS_LOG(WARN, "can not add compact row to a store with reserved columns, count=%ld",
+        reserved_columns_.count());
+  }
+  else if (row_size > BLOCK_SIZE - static_cast<int64_t>(sizeof(BlockInfo)))
+  {
+    ret = OB_SIZE_OVERFLOW;
+    TBSYS_LOG(WARN, "compact row is too large, size=%d", compact_row.length());
+  }
+  else if (NULL == block_list_head_ || block_list_head_->get_remain_size() < row_size)
+  {
+    ret = new_block();
+  }
+
+  if (OB_SUCCESS == ret)
+  {
+    StoredRow *stored_row = reinterpret_cast<StoredRow*>(block_list_head_->get_buffer());
+    stored_row->reserved_cells_count_ = 0;
+    stored_row->compact_row_size_ = compact_row.length();
+    memcpy(block_list_head_->get_buffer() + reserved_size, compact_row.ptr(), compact_row.length());
+    block_list_head_->advance(row_size);
+    cur_size_counter_ += row_size;
+    cur_size_counter = cur_size_counter_;
+  }
+  return ret;
+}
+
+int ObRowStore::get_next_compact_row(CompactRowCursor &cursor, ObString &compact_row) const
+{
+  int ret = OB_SUCCESS;
+  if (!cursor.started_)
+  {
+    cursor.block_ = block_list_tail_;
+    cursor.pos_ = 0;
+    cursor.started_ = true;
+  }
+  // blocks after block_list_head_ are left by rollback and not used
+  while (NULL != cursor.block_ && 0 >= cursor.block_->get_remain_size_for_read(cursor.pos_))
+  {
+    cursor.block_ = (cursor.block_ == block_list_head_) ? NULL : cursor.block_->next_block_;
+    cursor.pos_ = 0;
+  }
+  if (NULL == cursor.block_)
+  {
+    ret = OB_ITER_END;
+  }
+  else
+  {
+    const StoredRow *stored_row = reinterpret_cast<const StoredRow *>(
+        cursor.block_->get_buffer_head() + cursor.pos_);
+    cursor.pos_ += get_reserved_cells_size(stored_row->reserved_cells_count_) + stored_row->compact_row_size_;
+    compact_row = stored_row->get_compact_row();
+  }
+  return ret;
+}
+
 int ObRowStore::next_iter_pos(BlockInfo *&iter_block, int64_t &iter_pos)
 {
   int ret = OB_SUCCESS;
@@ -43,6 +43,17 @@ namespace oceanbase
           // ... compact_row
           const common::ObString get_compact_row() const;
         };
+        /**
+         * position of a walk through the stored rows, independent of
+         * the row iterator so that it can be used by const methods
+         */
+        struct CompactRowCursor
+        {
+          CompactRowCursor() : block_(NULL), pos_(0), started_(false) {}
+          const BlockInfo *block_;
+          int64_t pos_;
+          bool started_;
+        };
       public:
         ObRowStore(const int32_t mod_id = ObModIds::OB_SQL_ROW_STORE, ObIAllocator* allocator = NULL);
         ~ObRowStore();
@@ -88,6 +99,22 @@ namespace oceanbase
         int add_ups_row(const ObRowkey &rowkey, const ObUpsRow &row, const StoredRow *&stored_row);
         int add_ups_row(const ObRowkey &rowkey, const ObUpsRow &row, int64_t &cur_size_counter);
 
+        /**
+         * add a row already in compact format, no reserved cells are kept.
+         * used to rebuild the store from a compact encoded scanner.
+         */
+        int add_compact_row(const common::ObString &compact_row, int64_t &cur_size_counter);
+        /**
+         * get the compact format of the next stored row after %cursor
+         *
+         * @return OB_ITER_END if no more rows
+         */
+        int get_next_compact_row(CompactRowCursor &cursor, common::ObString &compact_row) const;
+        inline int64_t get_reserved_column_count() const
+        {
+          return reserved_columns_.count();
+        }
+
         bool is_empty() const;
         int64_t get_used_mem_size() const;
 
@@ -88,6 +88,14 @@ int ObMsgUpsHeartbeatResp::serialize(char* buf, const int64_t buf_len, int64_t &
   {
     TBSYS_LOG(ERROR, "failed to serialize, err=%d", ret);
   }
+  else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, memtable_used_)))
+  {
+    TBSYS_LOG(ERROR, "failed to serialize, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, pos, memtable_limit_)))
+  {
+    TBSYS_LOG(ERROR, "failed to serialize, err=%d", ret);
+  }
   return ret;
 }
 
@@ -109,6 +117,13 @@ int ObMsgUpsHeartbeatResp::deserialize(const char* buf, const int64_t data_len,
   {
     TBSYS_LOG(ERROR, "failed to deserialize, err=%d", ret);
   }
+  // old updateserver sends no memtable usage
+  else if (pos < data_len
+      && (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &memtable_used_))
+        || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &memtable_limit_))))
+  {
+    TBSYS_LOG(ERROR, "failed to deserialize memtable usage, err=%d", ret);
+  }
   else
   {
     if (SYNC == status)
@@ -45,6 +45,11 @@ namespace oceanbase
         NOTSYNC = 1
       } status_;
       ObiRole obi_role_;
+      // memtable memory usage for merge scheduling of rootserver, appended
+      // at the end and optional on decode, an old updateserver sends none
+      int64_t memtable_used_;
+      int64_t memtable_limit_;
+      ObMsgUpsHeartbeatResp() : status_(NOTSYNC), memtable_used_(0), memtable_limit_(0) {}
       int serialize(char* buf, const int64_t buf_len, int64_t& pos) const;
       int deserialize(const char* buf, const int64_t data_len, int64_t& pos);
     };
@@ -1801,6 +1801,40 @@ namespace oceanbase
       return ret;
     }
 
+    int ObScanParam::peek_table_id(const char *buf, const int64_t data_len, int64_t pos, uint64_t &table_id)
+    {
+      ObObj obj;
+      ObReadParam read_param;
+      int64_t int_value = 0;
+      int ret = OB_SUCCESS;
+      // skip to the basic param field the same way deserialize() does
+      do
+      {
+        ret = obj.deserialize(buf, data_len, pos);
+      } while (OB_SUCCESS == ret
+               && (ObExtendType != obj.get_type()
+                   || (ObActionFlag::BASIC_PARAM_FIELD != obj.get_ext()
+                       && ObActionFlag::END_PARAM_FIELD != obj.get_ext())));
+
+      if (OB_SUCCESS == ret && ObActionFlag::BASIC_PARAM_FIELD != obj.get_ext())
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (OB_SUCCESS == ret && OB_SUCCESS == (ret = read_param.deserialize(buf, data_len, pos))
+               && OB_SUCCESS == (ret = obj.deserialize(buf, data_len, pos)))
+      {
+        if (ObIntType != obj.get_type())
+        {
+          ret = OB_ENTRY_NOT_EXIST;
+        }
+        else if (OB_SUCCESS == (ret = obj.get_int(int_value)))
+        {
+          table_id = int_value;
+        }
+      }
+      return ret;
+    }
+
     DEFINE_DESERIALIZE(ObScanParam)
     {
       // reset contents
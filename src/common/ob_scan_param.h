@@ -187,6 +187,11 @@ namespace oceanbase
 
       NEED_SERIALIZE_AND_DESERIALIZE;
 
+      /// read only the table id of a serialized scan param, for routing the
+      /// request before it is deserialized, OB_ENTRY_NOT_EXIST if the table
+      /// is given by name
+      static int peek_table_id(const char *buf, const int64_t data_len, int64_t pos, uint64_t &table_id);
+
       // dump scan param info, basic version
       void dump(void) const;
       void dump_basic_param(void) const;
@@ -24,6 +24,7 @@
 #include "ob_obj_type.h"
 #include "common/ob_schema_service.h"
 #include "ob_schema_helper.h"
+#include "murmur_hash.h"
 #include "ob_define.h"
 
 namespace
@@ -67,6 +68,7 @@ namespace
   const char* STR_IS_EXPIRE_EFFECT_IMMEDIATELY="expire_effect_immediately";
   const char* STR_MAX_SCAN_ROWS_PER_TABLET="max_scan_rows_per_tablet";
   const char* STR_INTERNAL_UPS_SCAN_SIZE="internal_ups_scan_size";
+  const char* STR_INDEX_DATA_TABLE_ID="index_data_table_id";
 
   const unsigned int COLUMN_ID_RESERVED = 2;
 
@@ -963,6 +965,31 @@ namespace oceanbase
       return replica_count_;
     }
 
+    bool ObTableSchema::is_index_table() const
+    {
+      return 0 != reserved_[0];
+    }
+
+    uint64_t ObTableSchema::get_index_data_table_id() const
+    {
+      return 0 != reserved_[0] ? static_cast<uint64_t>(reserved_[0]) : OB_INVALID_ID;
+    }
+
+    void ObTableSchema::set_index_data_table_id(const uint64_t table_id)
+    {
+      reserved_[0] = OB_INVALID_ID != table_id ? static_cast<int64_t>(table_id) : 0;
+    }
+
+    bool ObTableSchema::is_index_built() const
+    {
+      return 0 != reserved_[1];
+    }
+
+    void ObTableSchema::set_index_built(const bool built)
+    {
+      reserved_[1] = built ? 1 : 0;
+    }
+
     void ObTableSchema::print(FILE* fd) const
     {
       fprintf(fd, "table=%s id=%ld, version=%ld\n", name_, table_id_, version_);
@@ -981,6 +1008,11 @@ namespace oceanbase
             i < rowkey_info_.get_size()-1 ? "," : "\n");
       }
       fprintf(fd, "expire_condition_=%s\n", expire_condition_);
+      if (is_index_table())
+      {
+        fprintf(fd, "index_data_table_id=%lu index_built=%s\n", get_index_data_table_id(),
+            is_index_built() ? "true" : "false");
+      }
     }
 
     const char* ObTableSchema::get_expire_condition() const
@@ -1604,7 +1636,10 @@ namespace oceanbase
       len += serialization::encoded_length_vi64(internal_ups_scan_size_);
       len += serialization::encoded_length_vi64(merge_write_sstable_version_);
       len += serialization::encoded_length_vi64(replica_count_);
-      len += serialization::encoded_length_vi64(reserved_[0]) * TABLE_SCHEMA_RESERVED_NUM;
+      for (int64_t i = 0; i < TABLE_SCHEMA_RESERVED_NUM; ++i)
+      {
+        len += serialization::encoded_length_vi64(reserved_[i]);
+      }
       return len;
     }
 
@@ -1620,6 +1655,7 @@ namespace oceanbase
                                             column_group_nums_(0)
     {
       app_name_[0] = '\0';
+      build_table_index();
     }
 
     ObSchemaManagerV2::ObSchemaManagerV2(const int64_t timestamp): schema_magic_(OB_SCHEMA_MAGIC_NUMBER),
@@ -1630,6 +1666,7 @@ namespace oceanbase
                                                                    column_group_nums_(0)
     {
       app_name_[0] = '\0';
+      build_table_index();
     }
 
     ObSchemaManagerV2::~ObSchemaManagerV2()
@@ -1658,6 +1695,7 @@ namespace oceanbase
 
         snprintf(app_name_,sizeof(app_name_),"%s",schema.app_name_);
 
+        invalidate_table_index();
         memcpy(&table_infos_,&schema.table_infos_,sizeof(table_infos_));
 
         if (OB_SUCCESS == prepare_column_storage(schema.column_nums_))
@@ -1688,6 +1726,7 @@ namespace oceanbase
                                                                             column_group_nums_(0)
     {
       app_name_[0] = '\0';
+      build_table_index();
       *this = schema;
     }
 
@@ -1707,12 +1746,24 @@ namespace oceanbase
 
       if (table_name != NULL && *table_name != '\0' && table_nums_ > 0)
       {
-        ObTableSchema tmp;
-        tmp.set_table_name(table_name);
-        table = std::find(table_infos_,table_infos_ + table_nums_,tmp);
-        if (table == (table_infos_ + table_nums_))
+        int64_t name_length = static_cast<int64_t>(strlen(table_name));
+        int64_t index = -1;
+        if (is_table_index_valid() && name_length < OB_MAX_TABLE_NAME_LENGTH)
         {
-          table = NULL;
+          if ((index = find_table_index(table_name, name_length)) >= 0)
+          {
+            table = table_infos_ + index;
+          }
+        }
+        else
+        {
+          ObTableSchema tmp;
+          tmp.set_table_name(table_name);
+          table = std::find(table_infos_,table_infos_ + table_nums_,tmp);
+          if (table == (table_infos_ + table_nums_))
+          {
+            table = NULL;
+          }
         }
       }
       return table;
@@ -1724,10 +1775,21 @@ namespace oceanbase
 
       if (table_name.ptr() != NULL && table_name.length() > 0 && table_nums_ > 0)
       {
-        table = std::find(table_infos_,table_infos_ + table_nums_,table_name);
-        if (table == (table_infos_ + table_nums_))
+        int64_t index = -1;
+        if (is_table_index_valid())
         {
-          table = NULL;
+          if ((index = find_table_index(table_name.ptr(), table_name.length())) >= 0)
+          {
+            table = table_infos_ + index;
+          }
+        }
+        else
+        {
+          table = std::find(table_infos_,table_infos_ + table_nums_,table_name);
+          if (table == (table_infos_ + table_nums_))
+          {
+            table = NULL;
+          }
         }
       }
       return table;
@@ -1740,12 +1802,23 @@ namespace oceanbase
 
       if (table_nums_ > 0)
       {
-        ObTableSchema tmp;
-        tmp.set_table_id(table_id);
-        table = std::find(table_infos_,table_infos_ + table_nums_,tmp);
-        if (table == (table_infos_ + table_nums_))
+        int64_t index = -1;
+        if (is_table_index_valid())
         {
-          table = NULL;
+          if ((index = find_table_index(table_id)) >= 0)
+          {
+            table = table_infos_ + index;
+          }
+        }
+        else
+        {
+          ObTableSchema tmp;
+          tmp.set_table_id(table_id);
+          table = std::find(table_infos_,table_infos_ + table_nums_,tmp);
+          if (table == (table_infos_ + table_nums_))
+          {
+            table = NULL;
+          }
         }
       }
       return table;
@@ -1753,36 +1826,97 @@ namespace oceanbase
 
     ObTableSchema* ObSchemaManagerV2::get_table_schema(const char* table_name)
     {
-      ObTableSchema *table = NULL;
+      return const_cast<ObTableSchema*>(
+          static_cast<const ObSchemaManagerV2*>(this)->get_table_schema(table_name));
+    }
 
-      if (table_name != NULL && *table_name != '\0' && table_nums_ > 0)
+    ObTableSchema* ObSchemaManagerV2::get_table_schema(const uint64_t table_id)
+    {
+      return const_cast<ObTableSchema*>(
+          static_cast<const ObSchemaManagerV2*>(this)->get_table_schema(table_id));
+    }
+
+    void ObSchemaManagerV2::build_table_index()
+    {
+      memset(table_id_index_, -1, sizeof(table_id_index_));
+      memset(table_name_index_, -1, sizeof(table_name_index_));
+      indexed_table_nums_ = 0;
+      for (int64_t i = 0; i < table_nums_; ++i)
       {
-        ObTableSchema tmp;
-        tmp.set_table_name(table_name);
-        table = std::find(table_infos_,table_infos_ + table_nums_,tmp);
-        if (table == (table_infos_ + table_nums_))
+        add_table_index(i);
+      }
+    }
+
+    void ObSchemaManagerV2::add_table_index(const int64_t table_index)
+    {
+      // the tables must be indexed in order, otherwise the index is left
+      // invalid until the next build_table_index
+      if (indexed_table_nums_ == table_index && table_index < table_nums_)
+      {
+        const ObTableSchema &table = table_infos_[table_index];
+        uint64_t table_id = table.get_table_id();
+        int64_t pos = murmurhash2(&table_id, static_cast<int32_t>(sizeof(table_id)), 0) & (TABLE_INDEX_SIZE - 1);
+        while (table_id_index_[pos] >= 0)
+        {
+          pos = (pos + 1) & (TABLE_INDEX_SIZE - 1);
+        }
+        table_id_index_[pos] = static_cast<int32_t>(table_index);
+
+        const char *table_name = table.get_table_name();
+        pos = murmurhash2(table_name, static_cast<int32_t>(strlen(table_name)), 0) & (TABLE_INDEX_SIZE - 1);
+        while (table_name_index_[pos] >= 0)
         {
-          table = NULL;
+          pos = (pos + 1) & (TABLE_INDEX_SIZE - 1);
         }
+        table_name_index_[pos] = static_cast<int32_t>(table_index);
+        ++indexed_table_nums_;
       }
-      return table;
     }
 
-    ObTableSchema* ObSchemaManagerV2::get_table_schema(const uint64_t table_id)
+    void ObSchemaManagerV2::invalidate_table_index()
+    {
+      indexed_table_nums_ = -1;
+    }
+
+    bool ObSchemaManagerV2::is_table_index_valid() const
     {
-      ObTableSchema *table = NULL;
+      return indexed_table_nums_ == table_nums_;
+    }
 
-      if (table_nums_ > 0)
+    int64_t ObSchemaManagerV2::find_table_index(const uint64_t table_id) const
+    {
+      int64_t index = -1;
+      if (OB_INVALID_ID != table_id)
+      {
+        int64_t pos = murmurhash2(&table_id, static_cast<int32_t>(sizeof(table_id)), 0) & (TABLE_INDEX_SIZE - 1);
+        while (table_id_index_[pos] >= 0)
+        {
+          if (table_infos_[table_id_index_[pos]].get_table_id() == table_id)
+          {
+            index = table_id_index_[pos];
+            break;
+          }
+          pos = (pos + 1) & (TABLE_INDEX_SIZE - 1);
+        }
+      }
+      return index;
+    }
+
+    int64_t ObSchemaManagerV2::find_table_index(const char* table_name, const int64_t name_length) const
+    {
+      int64_t index = -1;
+      int64_t pos = murmurhash2(table_name, static_cast<int32_t>(name_length), 0) & (TABLE_INDEX_SIZE - 1);
+      while (table_name_index_[pos] >= 0)
       {
-        ObTableSchema tmp;
-        tmp.set_table_id(table_id);
-        table = std::find(table_infos_,table_infos_ + table_nums_,tmp);
-        if (table == (table_infos_ + table_nums_))
+        const char *name = table_infos_[table_name_index_[pos]].get_table_name();
+        if (0 == strncmp(name, table_name, name_length) && '\0' == name[name_length])
         {
-          table = NULL;
+          index = table_name_index_[pos];
+          break;
         }
+        pos = (pos + 1) & (TABLE_INDEX_SIZE - 1);
       }
-      return table;
+      return index;
     }
 
     int64_t ObSchemaManagerV2::get_table_query_cache_expire_time(const ObString& table_name) const
@@ -1820,6 +1954,32 @@ namespace oceanbase
       return id;
     }
 
+    int ObSchemaManagerV2::get_index_tables(const uint64_t data_table_id,
+        const ObTableSchema* index_tables[], int64_t& size) const
+    {
+      int ret = OB_SUCCESS;
+      int64_t count = 0;
+      for (int64_t i = 0; i < table_nums_ && OB_SUCCESS == ret; ++i)
+      {
+        if (table_infos_[i].is_index_table()
+            && table_infos_[i].get_index_data_table_id() == data_table_id)
+        {
+          if (count >= size)
+          {
+            TBSYS_LOG(WARN, "too many index tables, data_table_id=%lu size=%ld",
+                data_table_id, size);
+            ret = OB_SIZE_OVERFLOW;
+          }
+          else
+          {
+            index_tables[count++] = table_infos_ + i;
+          }
+        }
+      }
+      size = count;
+      return ret;
+    }
+
     struct __table_sort
     {
       __table_sort(tbsys::CConfig& config): config_(config) {}
@@ -1908,6 +2068,7 @@ namespace oceanbase
           std::sort(sections.begin(),sections.end(),__table_sort(config));
 
           uint32_t index = 0;
+          invalidate_table_index();
 
           for(vector<string>::iterator it = sections.begin();
               it != sections.end() && parse_ok; ++it)
@@ -1975,6 +2136,11 @@ namespace oceanbase
           {
             parse_ok = check_table_expire_condition();
           }
+
+          if (parse_ok)
+          {
+            parse_ok = check_index_tables();
+          }
         }
 
       }
@@ -2106,6 +2272,8 @@ namespace oceanbase
           config.getInt(section_name, STR_MAX_SCAN_ROWS_PER_TABLET, 0);
         int64_t scan_size =
           config.getInt(section_name, STR_INTERNAL_UPS_SCAN_SIZE, 0);
+        int64_t index_data_table_id =
+          config.getInt(section_name, STR_INDEX_DATA_TABLE_ID, 0);
         if (expire_frequency < 1)
         {
           TBSYS_LOG(ERROR, "expire_frequency is %ld, must greater than 0",
@@ -2141,6 +2309,13 @@ namespace oceanbase
             scan_size);
           parse_ok = false;
         }
+        else if (index_data_table_id < 0
+            || static_cast<uint64_t>(index_data_table_id) == schema.get_table_id())
+        {
+          TBSYS_LOG(ERROR, "index_data_table_id is %ld, must be the id of another table",
+            index_data_table_id);
+          parse_ok = false;
+        }
         else
         {
           schema.set_expire_condition(expire_condition);
@@ -2151,6 +2326,10 @@ namespace oceanbase
           schema.set_expire_effect_immediately(expire_effect);
           schema.set_max_scan_rows_per_tablet(max_scan_rows);
           schema.set_internal_ups_scan_size(scan_size);
+          if (index_data_table_id > 0)
+          {
+            schema.set_index_data_table_id(index_data_table_id);
+          }
         }
       }
 
@@ -3008,6 +3187,7 @@ namespace oceanbase
       if (OB_SUCCESS == ret)
       {
         table_infos_[table_nums_++] = table;
+        add_table_index(table_nums_ - 1);
         if ((OB_INVALID_ID == max_table_id_) || (table.get_table_id() > max_table_id_))
           max_table_id_ = table.get_table_id();
       }
@@ -3641,6 +3821,7 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
 
+      build_table_index();
       std::sort(columns_, columns_+column_nums_, ObColumnSchemaV2Compare());
       if (!hash_sorted_)
       {
@@ -3990,6 +4171,86 @@ namespace oceanbase
       return bret;
     }
 
+    bool ObSchemaManagerV2::check_index_tables() const
+    {
+      bool bret = true;
+      for (int64_t i = 0; i < table_nums_ && bret; ++i)
+      {
+        const ObTableSchema &index_table = table_infos_[i];
+        const ObTableSchema *data_table = NULL;
+        const ObTableSchema *index_tables[OB_MAX_INDEX_TABLE_NUMBER];
+        int64_t index_num = OB_MAX_INDEX_TABLE_NUMBER;
+        if (!index_table.is_index_table())
+        {
+          continue;
+        }
+        else if (NULL == (data_table = get_table_schema(index_table.get_index_data_table_id()))
+            || data_table->is_index_table())
+        {
+          TBSYS_LOG(ERROR, "data table %lu of index table %s not exist or is an index table",
+              index_table.get_index_data_table_id(), index_table.get_table_name());
+          bret = false;
+        }
+        else if (OB_SUCCESS != get_index_tables(data_table->get_table_id(), index_tables, index_num))
+        {
+          TBSYS_LOG(ERROR, "table %s has more than %ld index tables",
+              data_table->get_table_name(), OB_MAX_INDEX_TABLE_NUMBER);
+          bret = false;
+        }
+        else
+        {
+          // rowkey of index table: at least one non-rowkey column of data table
+          // followed by the rowkey columns of data table in the same order
+          const ObRowkeyInfo &index_rowkey = index_table.get_rowkey_info();
+          const ObRowkeyInfo &data_rowkey = data_table->get_rowkey_info();
+          int64_t index_column_num = index_rowkey.get_size() - data_rowkey.get_size();
+          uint64_t column_id = OB_INVALID_ID;
+          uint64_t data_column_id = OB_INVALID_ID;
+          if (index_column_num <= 0)
+          {
+            TBSYS_LOG(ERROR, "index table %s has no index column", index_table.get_table_name());
+            bret = false;
+          }
+          for (int64_t j = 0; j < index_rowkey.get_size() && bret; ++j)
+          {
+            index_rowkey.get_column_id(j, column_id);
+            if (j < index_column_num)
+            {
+              bret = !data_rowkey.is_rowkey_column(column_id);
+            }
+            else
+            {
+              data_rowkey.get_column_id(j - index_column_num, data_column_id);
+              bret = (column_id == data_column_id);
+            }
+            if (!bret)
+            {
+              TBSYS_LOG(ERROR, "rowkey column %lu of index table %s does not match data table %s",
+                  column_id, index_table.get_table_name(), data_table->get_table_name());
+            }
+          }
+          // columns of index table share the column ids of data table
+          int32_t size = 0;
+          const ObColumnSchemaV2 *columns = get_table_schema(index_table.get_table_id(), size);
+          for (int32_t j = 0; NULL != columns && j < size && bret; ++j)
+          {
+            const ObColumnSchemaV2 *data_column = get_column_schema(
+                data_table->get_table_id(), columns[j].get_id());
+            if (NULL == data_column
+                || data_column->get_type() != columns[j].get_type()
+                || 0 != strcmp(data_column->get_name(), columns[j].get_name()))
+            {
+              TBSYS_LOG(ERROR, "column %s(%lu) of index table %s does not match data table %s",
+                  columns[j].get_name(), columns[j].get_id(),
+                  index_table.get_table_name(), data_table->get_table_name());
+              bret = false;
+            }
+          }
+        }
+      }
+      return bret;
+    }
+
     bool ObSchemaManagerV2::ObColumnGroupHelperCompare::operator() (const ObColumnGroupHelper& l,
                                                                     const ObColumnGroupHelper& r) const
     {
@@ -4223,6 +4484,7 @@ namespace oceanbase
 
           if (OB_SUCCESS == ret)
           {
+            invalidate_table_index();
             for (int64_t i = 0; i < table_nums_; ++i)
             {
               table_infos_[i].set_version(version_);
@@ -123,6 +123,7 @@ namespace oceanbase
 
     class ObOperator;
     class ObSchemaManagerV2;
+    class ObSchemaDelta;
 
     class ObColumnSchemaV2
     {
@@ -271,6 +272,23 @@ namespace oceanbase
         uint64_t get_create_time_column_id() const;
         uint64_t get_modify_time_column_id() const;
 
+        /**
+         * an index table is a hidden table keyed by (index columns, rowkey
+         * columns of its data table), its columns share the column ids of
+         * the data table and are maintained by the updateserver along with
+         * the data table rows
+         */
+        bool is_index_table() const;
+        uint64_t get_index_data_table_id() const;
+        void set_index_data_table_id(const uint64_t table_id);
+        /**
+         * rows written before the index table was created are not in it,
+         * so an index table is not read until the rootserver sees a merged
+         * version where it has as many rows as its data table
+         */
+        bool is_index_built() const;
+        void set_index_built(const bool built);
+
         void set_table_id(const uint64_t id);
         void set_max_column_id(const uint64_t id);
         void set_version(const int64_t version);
@@ -345,6 +363,8 @@ namespace oceanbase
         int64_t internal_ups_scan_size_;
         int64_t merge_write_sstable_version_;
         int64_t replica_count_;
+        // reserved_[0]: data table id of index table
+        // reserved_[1]: 1 if the index table is built
         int64_t reserved_[TABLE_SCHEMA_RESERVED_NUM];
         int64_t version_;
 
@@ -358,6 +378,7 @@ namespace oceanbase
     {
       public:
         friend class ObSchemaSortByIdHelper;
+        friend class ObSchemaDelta;
       public:
         ObSchemaManagerV2();
         explicit ObSchemaManagerV2(const int64_t timestamp);
@@ -449,6 +470,18 @@ namespace oceanbase
         uint64_t get_create_time_column_id(const uint64_t table_id) const;
         uint64_t get_modify_time_column_id(const uint64_t table_id) const;
 
+        /**
+         * @brief get the index tables of a data table
+         *
+         * @param data_table_id the id of data table
+         * @param index_tables[out] index table schemas
+         * @param size[in/out] capacity of index_tables, count of index tables
+         *
+         * @return OB_SUCCESS or OB_SIZE_OVERFLOW
+         */
+        int get_index_tables(const uint64_t data_table_id,
+                             const ObTableSchema* index_tables[], int64_t& size) const;
+
         int get_column_index(const char *table_name,const char* column_name,int32_t index_array[],int32_t& size) const;
         int get_column_index(const uint64_t table_id, const uint64_t column_id, int32_t index_array[],int32_t& size) const;
 
@@ -552,9 +585,13 @@ namespace oceanbase
         NEED_SERIALIZE_AND_DESERIALIZE;
         int sort_column();
         bool check_table_expire_condition() const;
+        bool check_index_tables() const;
 
         static const int64_t MAX_COLUMNS_LIMIT = OB_MAX_TABLE_NUMBER * OB_MAX_COLUMN_NUMBER;
         static const int64_t DEFAULT_MAX_COLUMNS = 16 * OB_MAX_COLUMN_NUMBER;;
+        // open addressing slots of the table id/name index, at least twice
+        // of OB_MAX_TABLE_NUMBER and power of 2
+        static const int64_t TABLE_INDEX_SIZE = 2 * OB_MAX_TABLE_NUMBER;
 
       private:
         int replace_system_variable(char* expire_condition, const int64_t buf_size) const;
@@ -562,6 +599,17 @@ namespace oceanbase
           const ObTableSchema& table_schema, ObExpressionParser& parser) const;
         int ensure_column_storage();
         int prepare_column_storage(const int64_t column_num, bool need_reserve_space = false);
+        /**
+         * index of table_infos_ by table id and by table name, valid only if
+         * all the tables are indexed, otherwise the lookups fall back to
+         * scan table_infos_
+         */
+        void build_table_index();
+        void add_table_index(const int64_t table_index);
+        void invalidate_table_index();
+        bool is_table_index_valid() const;
+        int64_t find_table_index(const uint64_t table_id) const;
+        int64_t find_table_index(const char* table_name, const int64_t name_length) const;
 
       private:
         int32_t   schema_magic_;
@@ -577,6 +625,11 @@ namespace oceanbase
         ObColumnSchemaV2 *columns_;
         int64_t   column_capacity_; // current %columns_ occupy size.
 
+        //just in mem, -1 is empty slot
+        int32_t table_id_index_[TABLE_INDEX_SIZE];
+        int32_t table_name_index_[TABLE_INDEX_SIZE];
+        int64_t indexed_table_nums_; // -1 if the index is invalid
+
         //just in mem
         bool drop_column_group_; //
         volatile bool hash_sorted_;       //after deserialize,will rebuild the hash maps
@@ -0,0 +1,420 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_schema_delta.cpp
+ */
+#include "ob_schema_delta.h"
+#include <algorithm>
+#include "ob_malloc.h"
+#include "serialization.h"
+#include "utility.h"
+
+using namespace oceanbase::common;
+
+namespace
+{
+  const int64_t SERIALIZE_BUF_SIZE = 4096;
+
+  // two schema objects are the same if they serialize to the same bytes
+  template <typename T>
+  int is_same_serialized(const T &l, const T &r, bool &is_same)
+  {
+    int ret = OB_SUCCESS;
+    char local_buf[SERIALIZE_BUF_SIZE];
+    char *buf = local_buf;
+    int64_t len = l.get_serialize_size();
+    int64_t l_pos = 0;
+    int64_t r_pos = len;
+    is_same = false;
+    if (len != r.get_serialize_size())
+    {
+      // differ
+    }
+    else if (2 * len > SERIALIZE_BUF_SIZE
+             && NULL == (buf = reinterpret_cast<char*>(ob_malloc(2 * len, ObModIds::OB_SCHEMA))))
+    {
+      TBSYS_LOG(WARN, "allocate serialize buffer fail, len=%ld", len);
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else if (OB_SUCCESS != (ret = l.serialize(buf, len, l_pos))
+             || OB_SUCCESS != (ret = r.serialize(buf, 2 * len, r_pos)))
+    {
+      TBSYS_LOG(WARN, "serialize schema fail, ret=%d", ret);
+    }
+    else
+    {
+      is_same = (l_pos == len && r_pos == 2 * len && 0 == memcmp(buf, buf + len, len));
+    }
+    if (NULL != buf && local_buf != buf)
+    {
+      ob_free(buf, ObModIds::OB_SCHEMA);
+    }
+    return ret;
+  }
+
+  struct ObTableIdCompare
+  {
+    bool operator()(const ObTableSchema &l, const ObTableSchema &r) const
+    {
+      return l.get_table_id() < r.get_table_id();
+    }
+  };
+}
+
+ObSchemaDelta::ObSchemaDelta() : base_version_(0), version_(0), max_table_id_(OB_INVALID_ID)
+{
+  app_name_[0] = '\0';
+}
+
+ObSchemaDelta::~ObSchemaDelta()
+{
+}
+
+void ObSchemaDelta::reset()
+{
+  base_version_ = 0;
+  version_ = 0;
+  max_table_id_ = OB_INVALID_ID;
+  app_name_[0] = '\0';
+  tables_.clear();
+  columns_.clear();
+  dropped_table_ids_.clear();
+}
+
+int ObSchemaDelta::is_same_table(const ObSchemaManagerV2 &base, const ObTableSchema &base_table,
+    const ObSchemaManagerV2 &target, const ObTableSchema &target_table, bool &is_same)
+{
+  int ret = OB_SUCCESS;
+  int32_t base_size = 0;
+  int32_t target_size = 0;
+  const ObColumnSchemaV2 *base_columns = base.get_table_schema(base_table.get_table_id(), base_size);
+  const ObColumnSchemaV2 *target_columns = target.get_table_schema(target_table.get_table_id(), target_size);
+  if (OB_SUCCESS != (ret = is_same_serialized(base_table, target_table, is_same)))
+  {
+    TBSYS_LOG(WARN, "compare table fail, table_id=%lu ret=%d", target_table.get_table_id(), ret);
+  }
+  else if (is_same && base_size != target_size)
+  {
+    is_same = false;
+  }
+  for (int32_t i = 0; OB_SUCCESS == ret && is_same && i < target_size; i++)
+  {
+    ret = is_same_serialized(base_columns[i], target_columns[i], is_same);
+  }
+  return ret;
+}
+
+int ObSchemaDelta::add_table(const ObSchemaManagerV2 &schema, const ObTableSchema &table)
+{
+  int ret = OB_SUCCESS;
+  int32_t size = 0;
+  const ObColumnSchemaV2 *columns = schema.get_table_schema(table.get_table_id(), size);
+  if (OB_SUCCESS != (ret = tables_.push_back(table)))
+  {
+    TBSYS_LOG(WARN, "push table fail, table_id=%lu ret=%d", table.get_table_id(), ret);
+  }
+  for (int32_t i = 0; OB_SUCCESS == ret && i < size; i++)
+  {
+    if (OB_SUCCESS != (ret = columns_.push_back(columns[i])))
+    {
+      TBSYS_LOG(WARN, "push column fail, table_id=%lu ret=%d", table.get_table_id(), ret);
+    }
+  }
+  return ret;
+}
+
+int ObSchemaDelta::diff(const ObSchemaManagerV2 &base, const ObSchemaManagerV2 &target)
+{
+  int ret = OB_SUCCESS;
+  bool is_same = false;
+  reset();
+  base_version_ = base.get_version();
+  version_ = target.get_version();
+  max_table_id_ = target.get_max_table_id();
+  snprintf(app_name_, sizeof(app_name_), "%s", target.get_app_name());
+  for (const ObTableSchema *table = target.table_begin();
+       OB_SUCCESS == ret && table != target.table_end(); ++table)
+  {
+    const ObTableSchema *base_table = base.get_table_schema(table->get_table_id());
+    if (NULL == base_table)
+    {
+      ret = add_table(target, *table);
+    }
+    else if (OB_SUCCESS != (ret = is_same_table(base, *base_table, target, *table, is_same)))
+    {
+      TBSYS_LOG(WARN, "compare table fail, table_id=%lu ret=%d", table->get_table_id(), ret);
+    }
+    else if (!is_same)
+    {
+      ret = add_table(target, *table);
+    }
+  }
+  for (const ObTableSchema *table = base.table_begin();
+       OB_SUCCESS == ret && table != base.table_end(); ++table)
+  {
+    if (NULL == target.get_table_schema(table->get_table_id())
+        && OB_SUCCESS != (ret = dropped_table_ids_.push_back(table->get_table_id())))
+    {
+      TBSYS_LOG(WARN, "push dropped table fail, table_id=%lu ret=%d", table->get_table_id(), ret);
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    TBSYS_LOG(INFO, "schema delta %s", to_cstring(*this));
+  }
+  return ret;
+}
+
+int ObSchemaDelta::apply(const ObSchemaManagerV2 &base, ObSchemaManagerV2 &result) const
+{
+  int ret = OB_SUCCESS;
+  // tables of base replaced or dropped by the delta, sorted
+  uint64_t skip_ids[OB_MAX_TABLE_NUMBER];
+  int64_t skip_num = 0;
+  if (base.get_version() != base_version_)
+  {
+    TBSYS_LOG(WARN, "schema delta base version mismatch, base=%ld delta_base=%ld",
+        base.get_version(), base_version_);
+    ret = OB_SCHEMA_DELTA_MISMATCH;
+  }
+  else if (&base == &result)
+  {
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else if (tables_.count() + dropped_table_ids_.count() > OB_MAX_TABLE_NUMBER)
+  {
+    TBSYS_LOG(WARN, "too many tables in schema delta, changed=%ld dropped=%ld",
+        tables_.count(), dropped_table_ids_.count());
+    ret = OB_SIZE_OVERFLOW;
+  }
+  else if (OB_SUCCESS != (ret = result.prepare_column_storage(base.column_nums_ + columns_.count())))
+  {
+    TBSYS_LOG(WARN, "prepare column storage fail, column_num=%ld ret=%d",
+        base.column_nums_ + columns_.count(), ret);
+  }
+  else
+  {
+    for (int64_t i = 0; i < tables_.count(); i++)
+    {
+      skip_ids[skip_num++] = tables_.at(i).get_table_id();
+    }
+    for (int64_t i = 0; i < dropped_table_ids_.count(); i++)
+    {
+      skip_ids[skip_num++] = dropped_table_ids_.at(i);
+    }
+    std::sort(skip_ids, skip_ids + skip_num);
+
+    result.invalidate_table_index();
+    result.timestamp_ = version_;
+    result.max_table_id_ = max_table_id_;
+    result.drop_column_group_ = base.drop_column_group_;
+    snprintf(result.app_name_, sizeof(result.app_name_), "%s", app_name_);
+    result.table_nums_ = 0;
+    result.column_nums_ = 0;
+    // tables untouched by the delta are taken from base as they are
+    for (int64_t i = 0; i < base.table_nums_; i++)
+    {
+      if (!std::binary_search(skip_ids, skip_ids + skip_num, base.table_infos_[i].get_table_id()))
+      {
+        result.table_infos_[result.table_nums_++] = base.table_infos_[i];
+      }
+    }
+    for (int64_t i = 0; i < base.column_nums_; i++)
+    {
+      if (!std::binary_search(skip_ids, skip_ids + skip_num, base.columns_[i].get_table_id()))
+      {
+        result.columns_[result.column_nums_++] = base.columns_[i];
+      }
+    }
+    for (int64_t i = 0; OB_SUCCESS == ret && i < tables_.count(); i++)
+    {
+      if (result.table_nums_ >= OB_MAX_TABLE_NUMBER)
+      {
+        TBSYS_LOG(WARN, "too many tables after apply schema delta, table_num=%ld", result.table_nums_);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        result.table_infos_[result.table_nums_++] = tables_.at(i);
+      }
+    }
+    for (int64_t i = 0; OB_SUCCESS == ret && i < columns_.count(); i++)
+    {
+      result.columns_[result.column_nums_++] = columns_.at(i);
+    }
+    if (OB_SUCCESS == ret)
+    {
+      std::sort(result.table_infos_, result.table_infos_ + result.table_nums_, ObTableIdCompare());
+      if (OB_SUCCESS != (ret = result.sort_column()))
+      {
+        TBSYS_LOG(WARN, "sort column fail, ret=%d", ret);
+      }
+    }
+    if (OB_SUCCESS != ret)
+    {
+      result.table_nums_ = 0;
+      result.column_nums_ = 0;
+    }
+  }
+  return ret;
+}
+
+int64_t ObSchemaDelta::to_string(char *buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "base_version=%ld version=%ld changed_tables=[",
+      base_version_, version_);
+  for (int64_t i = 0; i < tables_.count(); i++)
+  {
+    databuff_printf(buf, buf_len, pos, "%s%lu", 0 == i ? "" : ",", tables_.at(i).get_table_id());
+  }
+  databuff_printf(buf, buf_len, pos, "] column_num=%ld dropped_tables=[", columns_.count());
+  for (int64_t i = 0; i < dropped_table_ids_.count(); i++)
+  {
+    databuff_printf(buf, buf_len, pos, "%s%lu", 0 == i ? "" : ",", dropped_table_ids_.at(i));
+  }
+  databuff_printf(buf, buf_len, pos, "]");
+  return pos;
+}
+
+DEFINE_SERIALIZE(ObSchemaDelta)
+{
+  int ret = OB_SUCCESS;
+  int64_t tmp_pos = pos;
+  if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos, base_version_))
+      || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos, version_))
+      || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos, static_cast<int64_t>(max_table_id_)))
+      || OB_SUCCESS != (ret = serialization::encode_vstr(buf, buf_len, tmp_pos, app_name_))
+      || OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, tmp_pos, tables_.count())))
+  {
+    TBSYS_LOG(WARN, "serialize schema delta header fail, ret=%d", ret);
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < tables_.count(); i++)
+  {
+    ret = tables_.at(i).serialize(buf, buf_len, tmp_pos);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    ret = serialization::encode_vi64(buf, buf_len, tmp_pos, columns_.count());
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < columns_.count(); i++)
+  {
+    ret = columns_.at(i).serialize(buf, buf_len, tmp_pos);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    ret = serialization::encode_vi64(buf, buf_len, tmp_pos, dropped_table_ids_.count());
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < dropped_table_ids_.count(); i++)
+  {
+    ret = serialization::encode_vi64(buf, buf_len, tmp_pos, static_cast<int64_t>(dropped_table_ids_.at(i)));
+  }
+  if (OB_SUCCESS == ret)
+  {
+    pos = tmp_pos;
+  }
+  return ret;
+}
+
+DEFINE_DESERIALIZE(ObSchemaDelta)
+{
+  int ret = OB_SUCCESS;
+  int64_t tmp_pos = pos;
+  int64_t count = 0;
+  int64_t len = 0;
+  reset();
+  if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &base_version_))
+      || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &version_))
+      || OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos,
+          reinterpret_cast<int64_t*>(&max_table_id_))))
+  {
+    TBSYS_LOG(WARN, "deserialize schema delta header fail, ret=%d", ret);
+  }
+  else if (NULL == serialization::decode_vstr(buf, data_len, tmp_pos, app_name_, sizeof(app_name_), &len)
+           || 0 > len)
+  {
+    ret = OB_DESERIALIZE_ERROR;
+  }
+  else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &count)))
+  {
+    TBSYS_LOG(WARN, "deserialize table count fail, ret=%d", ret);
+  }
+  else if (0 > count || OB_MAX_TABLE_NUMBER < count)
+  {
+    TBSYS_LOG(WARN, "invalid table count %ld", count);
+    ret = OB_DESERIALIZE_ERROR;
+  }
+  else
+  {
+    ObTableSchema table;
+    for (int64_t i = 0; OB_SUCCESS == ret && i < count; i++)
+    {
+      table.set_version(OB_SCHEMA_VERSION_FOUR);
+      if (OB_SUCCESS == (ret = table.deserialize(buf, data_len, tmp_pos)))
+      {
+        ret = tables_.push_back(table);
+      }
+    }
+  }
+  if (OB_SUCCESS == ret && OB_SUCCESS == (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &count)))
+  {
+    ObColumnSchemaV2 column;
+    for (int64_t i = 0; OB_SUCCESS == ret && i < count; i++)
+    {
+      if (OB_SUCCESS == (ret = column.deserialize(buf, data_len, tmp_pos)))
+      {
+        ret = columns_.push_back(column);
+      }
+    }
+  }
+  if (OB_SUCCESS == ret && OB_SUCCESS == (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &count)))
+  {
+    int64_t table_id = 0;
+    for (int64_t i = 0; OB_SUCCESS == ret && i < count; i++)
+    {
+      if (OB_SUCCESS == (ret = serialization::decode_vi64(buf, data_len, tmp_pos, &table_id)))
+      {
+        ret = dropped_table_ids_.push_back(static_cast<uint64_t>(table_id));
+      }
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    pos = tmp_pos;
+  }
+  else
+  {
+    TBSYS_LOG(WARN, "deserialize schema delta fail, ret=%d", ret);
+  }
+  return ret;
+}
+
+DEFINE_GET_SERIALIZE_SIZE(ObSchemaDelta)
+{
+  int64_t len = serialization::encoded_length_vi64(base_version_);
+  len += serialization::encoded_length_vi64(version_);
+  len += serialization::encoded_length_vi64(static_cast<int64_t>(max_table_id_));
+  len += serialization::encoded_length_vstr(app_name_);
+  len += serialization::encoded_length_vi64(tables_.count());
+  for (int64_t i = 0; i < tables_.count(); i++)
+  {
+    len += tables_.at(i).get_serialize_size();
+  }
+  len += serialization::encoded_length_vi64(columns_.count());
+  for (int64_t i = 0; i < columns_.count(); i++)
+  {
+    len += columns_.at(i).get_serialize_size();
+  }
+  len += serialization::encoded_length_vi64(dropped_table_ids_.count());
+  for (int64_t i = 0; i < dropped_table_ids_.count(); i++)
+  {
+    len += serialization::encoded_length_vi64(static_cast<int64_t>(dropped_table_ids_.at(i)));
+  }
+  return len;
+}
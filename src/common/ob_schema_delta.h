@@ -0,0 +1,81 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_schema_delta.h
+ *
+ * Difference between two versions of ObSchemaManagerV2 at table
+ * granularity. The rootserver broadcasts the delta of a DDL instead of
+ * the whole schema, a server holding the base version builds the new
+ * version from its base and the delta, leaving the base untouched for
+ * the readers still using it.
+ */
+#ifndef OCEANBASE_COMMON_OB_SCHEMA_DELTA_H_
+#define OCEANBASE_COMMON_OB_SCHEMA_DELTA_H_
+
+#include "ob_define.h"
+#include "ob_array.h"
+#include "ob_schema.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObSchemaDelta
+    {
+      public:
+        ObSchemaDelta();
+        ~ObSchemaDelta();
+        void reset();
+
+        /// tables of target which are new or differ from the ones of base,
+        /// and ids of the tables of base which are dropped in target
+        int diff(const ObSchemaManagerV2 &base, const ObSchemaManagerV2 &target);
+        /// build the target version in result, base must be the version the
+        /// delta is made from, otherwise OB_SCHEMA_DELTA_MISMATCH
+        int apply(const ObSchemaManagerV2 &base, ObSchemaManagerV2 &result) const;
+
+        int64_t get_base_version() const
+        {
+          return base_version_;
+        }
+        int64_t get_version() const
+        {
+          return version_;
+        }
+        int64_t get_changed_table_count() const
+        {
+          return tables_.count();
+        }
+        int64_t get_dropped_table_count() const
+        {
+          return dropped_table_ids_.count();
+        }
+        int64_t to_string(char *buf, const int64_t buf_len) const;
+
+        NEED_SERIALIZE_AND_DESERIALIZE;
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObSchemaDelta);
+        int add_table(const ObSchemaManagerV2 &schema, const ObTableSchema &table);
+        static int is_same_table(const ObSchemaManagerV2 &base, const ObTableSchema &base_table,
+            const ObSchemaManagerV2 &target, const ObTableSchema &target_table, bool &is_same);
+
+      private:
+        int64_t base_version_;
+        int64_t version_;
+        uint64_t max_table_id_;
+        char app_name_[OB_MAX_APP_NAME_LENGTH];
+        ObArray<ObTableSchema> tables_;
+        ObArray<ObColumnSchemaV2> columns_;
+        ObArray<uint64_t> dropped_table_ids_;
+    };
+  }
+}
+
+#endif //OCEANBASE_COMMON_OB_SCHEMA_DELTA_H_
@@ -88,6 +88,52 @@ int ObMergerSchemaManager::add_schema(const ObSchemaManagerV2 & schema,
   return ret;
 }
 
+int ObMergerSchemaManager::apply_delta(const ObSchemaDelta & delta)
+{
+  int ret = OB_SUCCESS;
+  const ObSchemaManagerV2 * base = NULL;
+  ObSchemaManagerV2 * schema = NULL;
+  if (false == check_inner_stat())
+  {
+    TBSYS_LOG(ERROR, "%s", "check inner stat failed");
+    ret = OB_INNER_STAT_ERROR;
+  }
+  else if (delta.get_version() <= get_latest_version())
+  {
+    TBSYS_LOG(WARN, "check schema version failed:latest[%ld], delta[%ld]",
+        get_latest_version(), delta.get_version());
+    ret = OB_OLD_SCHEMA_VERSION;
+  }
+  else if (NULL == (base = get_user_schema(0)))
+  {
+    TBSYS_LOG(WARN, "get latest schema failed:latest[%ld]", get_latest_version());
+    ret = OB_SCHEMA_DELTA_MISMATCH;
+  }
+  else
+  {
+    if (NULL == (schema = OB_NEW(ObSchemaManagerV2, ObModIds::OB_SCHEMA)))
+    {
+      TBSYS_LOG(WARN, "%s", "fail to new ObSchemaManagerV2");
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+    else if (OB_SUCCESS != (ret = delta.apply(*base, *schema)))
+    {
+      TBSYS_LOG(WARN, "apply schema delta failed:base[%ld], delta[%ld], ret[%d]",
+          base->get_version(), delta.get_base_version(), ret);
+    }
+    release_schema(base);
+    if (OB_SUCCESS == ret && OB_SUCCESS != (ret = add_schema(*schema)))
+    {
+      TBSYS_LOG(WARN, "add schema failed:version[%ld], ret[%d]", schema->get_version(), ret);
+    }
+    if (NULL != schema)
+    {
+      OB_DELETE(ObSchemaManagerV2, ObModIds::OB_SCHEMA, schema);
+    }
+  }
+  return ret;
+}
+
 int64_t ObMergerSchemaManager::find_replace_pos(void) const
 {
   int64_t pos = -1;
@@ -23,6 +23,7 @@
 #include "tbsys.h"
 #include "common/ob_string.h"
 #include "common/ob_schema.h"
+#include "common/ob_schema_delta.h"
 
 namespace oceanbase
 {
@@ -49,6 +50,10 @@ namespace oceanbase
       int add_schema(const common::ObSchemaManagerV2 & schema,
           const common::ObSchemaManagerV2 ** manager = NULL);
 
+      // add the new schema built from the latest version and the delta, the
+      // delta must be based on the latest version
+      int apply_delta(const common::ObSchemaDelta & delta);
+
       // get sys or user table schema of local newest version if not exist return null
       const common::ObSchemaManagerV2 * get_schema(const common::ObString & table_name);
       const common::ObSchemaManagerV2 * get_schema(const uint64_t table_id);
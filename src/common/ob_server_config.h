@@ -64,6 +64,9 @@ namespace oceanbase
         DEF_INT(port, "0", "(1024,65536)", "listen port");
         DEF_STR(devname, "bond0", "listen device");
         DEF_INT(retry_times, "3", "[1,]", "retry times if failed");
+        DEF_BOOL(numa_aware, "False", "bind worker threads and big memory blocks to numa nodes, need restart");
+        DEF_STR(huge_page_mode, "none", "huge page backend of memtable and cache memory blocks: "
+                "none, transparent, 2M or 1G, falls back to normal pages if unavailable, need restart");
     };
   }
 }
@@ -11,7 +11,7 @@ namespace oceanbase
 {
   namespace common
   {
-    ObSingleServer::ObSingleServer() : thread_count_(0), task_queue_size_(100), min_left_time_(0), drop_packet_count_(0), host_()
+    ObSingleServer::ObSingleServer() : thread_count_(0), task_queue_size_(100), min_left_time_(0), drop_packet_count_(0), numa_aware_(false), host_()
     {
     }
 
@@ -29,6 +29,7 @@ namespace oceanbase
         default_task_queue_thread_.set_ip_port(ip_port);
         default_task_queue_thread_.set_host(host_);
         default_task_queue_thread_.setThreadParameter(thread_count_, this, NULL);
+        default_task_queue_thread_.set_numa_aware(numa_aware_);
         default_task_queue_thread_.start();
       }
 
@@ -120,6 +121,17 @@ namespace oceanbase
       return ret;
     }
 
+    void ObSingleServer::set_numa_aware(const bool numa_aware)
+    {
+      numa_aware_ = numa_aware;
+    }
+
+    int64_t ObSingleServer::get_packet_numa_node(ObPacket *packet)
+    {
+      UNUSED(packet);
+      return -1;
+    }
+
     uint64_t ObSingleServer::get_drop_packet_count(void) const
     {
       return drop_packet_count_;
@@ -141,7 +153,8 @@ namespace oceanbase
       }
       else
       {
-        bool ps = default_task_queue_thread_.push(req, task_queue_size_, false);
+        bool ps = default_task_queue_thread_.push(req, task_queue_size_, false,
+                                                  numa_aware_ ? get_packet_numa_node(req) : -1);
         if (!ps)
         {
           if (!handle_overflow_packet(req))
@@ -35,6 +35,15 @@ namespace oceanbase
         /** set the queue size of the default task queue */
         int set_default_queue_size(const int task_queue_size);
 
+        /** bind worker threads to numa nodes, call before initialize() */
+        void set_numa_aware(const bool numa_aware);
+
+        /**
+         * numa node whose workers should handle the packet, called in the
+         * io thread so it must be cheap. default -1 means any worker.
+         */
+        virtual int64_t get_packet_numa_node(ObPacket *packet);
+
         /** get current dropped packet count */
         uint64_t get_drop_packet_count(void) const;
 
@@ -71,6 +80,7 @@ namespace oceanbase
         int task_queue_size_;
         int64_t min_left_time_;
         uint64_t drop_packet_count_;
+        bool numa_aware_;
         ObPacketQueueThread default_task_queue_thread_;
         ObServer host_;
     };
@@ -14,13 +14,16 @@
 #include "ob_stack_allocator.h"
 #include "ob_mod_define.h"
 #include "ob_malloc.h"
+#include "ob_numa.h"
+#include "ob_huge_page.h"
 #include "utility.h"
 
 namespace oceanbase
 {
   namespace common
   {
-    DefaultBlockAllocator::DefaultBlockAllocator(): mod_(ObModIds::BLOCK_ALLOC), limit_(INT64_MAX), allocated_(0)
+    DefaultBlockAllocator::DefaultBlockAllocator(): mod_(ObModIds::BLOCK_ALLOC), limit_(INT64_MAX), allocated_(0),
+                                                   numa_interleave_(false), huge_page_(false)
     {}
 
     DefaultBlockAllocator::~DefaultBlockAllocator()
@@ -36,6 +39,16 @@ namespace oceanbase
       mod_ = mod;
     }
 
+    void DefaultBlockAllocator::set_numa_interleave(const bool numa_interleave)
+    {
+      numa_interleave_ = numa_interleave;
+    }
+
+    void DefaultBlockAllocator::set_huge_page(const bool huge_page)
+    {
+      huge_page_ = huge_page;
+    }
+
     int DefaultBlockAllocator::set_limit(const int64_t limit)
     {
       int err = OB_SUCCESS;
@@ -76,7 +89,7 @@ namespace oceanbase
         __sync_add_and_fetch(&allocated_, -alloc_size);
         TBSYS_LOG(ERROR, "allocated[%ld] + size[%ld] > limit[%ld]", allocated_, alloc_size, limit_);
       }
-      else if (NULL == (p = ob_malloc(alloc_size, mod_)))
+      else if (NULL == (p = huge_page_ ? ob_huge_malloc(alloc_size, mod_) : ob_malloc(alloc_size, mod_)))
       {
         err = OB_MEM_OVERFLOW;
         __sync_add_and_fetch(&allocated_, -alloc_size);
@@ -84,6 +97,10 @@ namespace oceanbase
       }
       else
       {
+        if (numa_interleave_)
+        {
+          ObNumaTopology::get_instance().bind_memory(p, alloc_size, ObNumaTopology::INTERLEAVE_NODE);
+        }
         *((int64_t*)p) = alloc_size;
         p = (char*)p + sizeof(alloc_size);
       }
@@ -111,7 +128,14 @@ namespace oceanbase
       }
       else
       {
-        ob_free((void*)((char*)p - sizeof(int64_t)), mod_);
+        if (huge_page_)
+        {
+          ob_huge_free((void*)((char*)p - sizeof(int64_t)), mod_);
+        }
+        else
+        {
+          ob_free((void*)((char*)p - sizeof(int64_t)), mod_);
+        }
       }
     }
 
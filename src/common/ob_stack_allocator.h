@@ -30,6 +30,11 @@ namespace oceanbase
       public:
         void set_mod_id(int32_t mod);
         int set_limit(const int64_t limit);
+        // spread the blocks over all numa nodes, for memory shared by
+        // threads of every node
+        void set_numa_interleave(const bool numa_interleave);
+        // serve the blocks from the huge page pool, for big long lived arenas
+        void set_huge_page(const bool huge_page);
         const int64_t get_allocated() const;
         void* alloc(const int64_t size);
         void free(void* p);
@@ -37,6 +42,8 @@ namespace oceanbase
         int32_t mod_;
         int64_t limit_;
         volatile int64_t allocated_;
+        bool numa_interleave_;
+        bool huge_page_;
     };
 
     class StackAllocator: public ObIAllocator
@@ -15,6 +15,7 @@
 #include "ob_atomic.h"
 #include "serialization.h"
 #include "ob_new_scanner.h"
+#include "ob_query_profile.h"
 
 namespace oceanbase
 {
@@ -229,6 +230,11 @@ namespace oceanbase
       int ret = OB_ERROR;
       bool need_add_new = true;
       assert(mod_id < OB_MAX_MOD_NUMBER);
+      if (OB_STAT_SSTABLE == mod_id)
+      {
+        // block cache and io usage of the request being served
+        ObRpcProfile::add_sstable_stat(index, inc_value);
+      }
       for (int32_t i = 0; table_id != OB_INVALID_ID && mod_id != OB_INVALID_ID && i < table_stats_[mod_id].get_array_index(); i++)
       {
         if (data_holder_[mod_id][i].get_table_id() == table_id)
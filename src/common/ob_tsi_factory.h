@@ -167,6 +167,7 @@ namespace oceanbase
       TSI_MYSQL_RESULT_SET_1,
       TSI_MYSQL_PREPARE_RESULT_1,
       TSI_MYSQL_SESSION_KEY_1,
+      TSI_MYSQL_QUERY_PROFILE_1,
     };
 
     enum TSIRootserverType
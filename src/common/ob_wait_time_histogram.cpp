@@ -0,0 +1,100 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_wait_time_histogram.cpp
+ *
+ */
+#include "ob_wait_time_histogram.h"
+#include "tbsys.h"
+#include "utility.h"
+
+using namespace oceanbase::common;
+
+ObWaitTimeHistogram::ObWaitTimeHistogram()
+{
+  reset();
+  last_print_time_ = 0;
+}
+
+ObWaitTimeHistogram::~ObWaitTimeHistogram()
+{
+}
+
+void ObWaitTimeHistogram::reset()
+{
+  for (int64_t i = 0; i < BUCKET_NUM; i++)
+  {
+    buckets_[i] = 0;
+  }
+  total_count_ = 0;
+  total_wait_time_ = 0;
+}
+
+int64_t ObWaitTimeHistogram::get_bucket(const int64_t wait_time)
+{
+  int64_t bucket = 0;
+  if (0 < wait_time)
+  {
+    // number of significant bits
+    bucket = 64 - __builtin_clzl(static_cast<uint64_t>(wait_time));
+  }
+  return bucket < BUCKET_NUM ? bucket : BUCKET_NUM - 1;
+}
+
+void ObWaitTimeHistogram::add(const int64_t wait_time)
+{
+  __sync_add_and_fetch(&buckets_[get_bucket(wait_time)], 1);
+  __sync_add_and_fetch(&total_count_, 1);
+  __sync_add_and_fetch(&total_wait_time_, 0 < wait_time ? wait_time : 0);
+}
+
+int64_t ObWaitTimeHistogram::get_count(const int64_t bucket) const
+{
+  return (0 <= bucket && bucket < BUCKET_NUM) ? buckets_[bucket] : 0;
+}
+
+int64_t ObWaitTimeHistogram::get_avg_wait_time() const
+{
+  int64_t count = total_count_;
+  return 0 == count ? 0 : total_wait_time_ / count;
+}
+
+bool ObWaitTimeHistogram::reach_print_interval()
+{
+  bool ret = false;
+  int64_t now = tbsys::CTimeUtil::getTime();
+  int64_t last = last_print_time_;
+  if (now - last >= PRINT_INTERVAL)
+  {
+    ret = (last == __sync_val_compare_and_swap(&last_print_time_, last, now));
+  }
+  return ret;
+}
+
+int64_t ObWaitTimeHistogram::to_string(char *buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  databuff_printf(buf, buf_len, pos, "count=%ld avg_wait=%ldus", total_count_, get_avg_wait_time());
+  for (int64_t i = 0; i < BUCKET_NUM; i++)
+  {
+    if (0 == buckets_[i])
+    {
+      // skip empty buckets
+    }
+    else if (BUCKET_NUM - 1 == i)
+    {
+      databuff_printf(buf, buf_len, pos, " >=%ldus:%ld", 1L << (i - 1), buckets_[i]);
+    }
+    else
+    {
+      databuff_printf(buf, buf_len, pos, " <%ldus:%ld", 1L << i, buckets_[i]);
+    }
+  }
+  return pos;
+}
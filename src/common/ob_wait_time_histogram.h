@@ -0,0 +1,59 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_wait_time_histogram.h
+ *
+ * Lock free histogram of the time requests wait in a queue, bucket i
+ * counts the waits in [2^(i-1), 2^i) us, the last bucket counts all the
+ * longer ones.
+ */
+#ifndef OCEANBASE_COMMON_OB_WAIT_TIME_HISTOGRAM_H_
+#define OCEANBASE_COMMON_OB_WAIT_TIME_HISTOGRAM_H_
+
+#include "ob_define.h"
+
+namespace oceanbase
+{
+  namespace common
+  {
+    class ObWaitTimeHistogram
+    {
+      public:
+        // the last bucket starts at about 1s
+        static const int64_t BUCKET_NUM = 21;
+        static const int64_t PRINT_INTERVAL = 60L * 1000L * 1000L;
+
+      public:
+        ObWaitTimeHistogram();
+        ~ObWaitTimeHistogram();
+        void reset();
+        void add(const int64_t wait_time);
+        int64_t get_count(const int64_t bucket) const;
+        int64_t get_total_count() const
+        {
+          return total_count_;
+        }
+        int64_t get_avg_wait_time() const;
+        /// return true for only one caller every PRINT_INTERVAL
+        bool reach_print_interval();
+        int64_t to_string(char *buf, const int64_t buf_len) const;
+
+        static int64_t get_bucket(const int64_t wait_time);
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObWaitTimeHistogram);
+        volatile int64_t buckets_[BUCKET_NUM];
+        volatile int64_t total_count_;
+        volatile int64_t total_wait_time_;
+        volatile int64_t last_print_time_;
+    };
+  }
+}
+
+#endif //OCEANBASE_COMMON_OB_WAIT_TIME_HISTOGRAM_H_
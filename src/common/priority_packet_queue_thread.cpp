@@ -21,6 +21,7 @@
 #include "ob_profile_log.h"
 #include "ob_profile_type.h"
 #include "ob_atomic.h"
+#include "ob_numa.h"
 
 namespace oceanbase {
 namespace common {
@@ -32,10 +33,14 @@ PriorityPacketQueueThread::PriorityPacketQueueThread() : tbsys::CDefaultRunnable
   _waitFinish = false;
   _handler = NULL;
   _args = NULL;
+  _numaAware = false;
+  _queuedSem.val_ = 0;
+  _queuedSem.nwaiters_ = 0;
+  _queueCapacity = DEFAULT_QUEUE_CAPACITY;
+  _popBatchNum = 1;
   for (int64_t i = 0; i < QUEUE_NUM; ++i)
   {
     _waiting[i] = false;
-    _queues[i].init();
   }
 
   _percent[LOW_PRIV] = 10;
@@ -51,6 +56,11 @@ PriorityPacketQueueThread::PriorityPacketQueueThread(int threadCount, ObPacketQu
   _waitFinish = false;
   _handler = handler;
   _args = args;
+  _numaAware = false;
+  _queuedSem.val_ = 0;
+  _queuedSem.nwaiters_ = 0;
+  _queueCapacity = DEFAULT_QUEUE_CAPACITY;
+  _popBatchNum = 1;
   for (int64_t i = 0; i < QUEUE_NUM; ++i)
   {
     _waiting[i] = false;
@@ -59,6 +69,7 @@ PriorityPacketQueueThread::PriorityPacketQueueThread(int threadCount, ObPacketQu
   _percent[LOW_PRIV] = 10;
   _percent[NORMAL_PRIV] = 90;
   _sum = 100;
+  init_queues_();
 }
 
 // 析构
@@ -73,6 +84,45 @@ void PriorityPacketQueueThread::setThreadParameter(int threadCount, ObPacketQueu
     setThreadCount(threadCount);
     _handler = handler;
     _args = args;
+    init_queues_();
+}
+
+void PriorityPacketQueueThread::set_queue_capacity(const int64_t capacity)
+{
+  if (0 < capacity)
+  {
+    _queueCapacity = capacity;
+  }
+}
+
+void PriorityPacketQueueThread::set_pop_batch_num(const int64_t batch_num)
+{
+  if (0 < batch_num && batch_num <= MAX_POP_BATCH_NUM)
+  {
+    _popBatchNum = batch_num;
+  }
+  else
+  {
+    TBSYS_LOG(WARN, "invalid pop batch num %ld, keep %ld", batch_num, _popBatchNum);
+  }
+}
+
+int PriorityPacketQueueThread::init_queues_()
+{
+  int ret = OB_SUCCESS;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < QUEUE_NUM; ++i)
+  {
+    ret = _queues[i].init(_queueCapacity);
+    if (OB_INIT_TWICE == ret)
+    {
+      ret = OB_SUCCESS;
+    }
+    else if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(ERROR, "init packet queue fail, priority=%ld capacity=%ld ret=%d", i, _queueCapacity, ret);
+    }
+  }
+  return ret;
 }
 
 // stop
@@ -80,6 +130,11 @@ void PriorityPacketQueueThread::stop(bool waitFinish)
 {
     _waitFinish = waitFinish;
     _stop = true;
+    // 唤醒空闲的工作线程
+    for (int64_t i = 0; i < _threadCount; ++i)
+    {
+      futex_post(&_queuedSem);
+    }
 }
 
 // push
@@ -87,6 +142,7 @@ void PriorityPacketQueueThread::stop(bool waitFinish)
 // otherwise, return false directly, client must be free this packet.
 bool PriorityPacketQueueThread::push(ObPacket *packet, int maxQueueLen, bool block, int priority)
 {
+  int err = OB_SUCCESS;
   // invalid param
   if (NULL == packet)
   {
@@ -105,16 +161,16 @@ bool PriorityPacketQueueThread::push(ObPacket *packet, int maxQueueLen, bool blo
   }
 
   // 是否要限制push长度
-  if (maxQueueLen>0 && _queues[priority].size() >= maxQueueLen)
+  if (maxQueueLen>0 && size(priority) >= static_cast<size_t>(maxQueueLen))
   {
     _pushcond[priority].lock();
     _waiting[priority] = true;
-    while (_stop == false && _queues[priority].size() >= maxQueueLen && block)
+    while (_stop == false && size(priority) >= static_cast<size_t>(maxQueueLen) && block)
     {
       _pushcond[priority].wait(1000);
     }
     _waiting[priority] = false;
-    if (_queues[priority].size() >= maxQueueLen && !block)
+    if (size(priority) >= static_cast<size_t>(maxQueueLen) && !block)
     {
       _pushcond[priority].unlock();
       return false;
@@ -127,165 +183,181 @@ bool PriorityPacketQueueThread::push(ObPacket *packet, int maxQueueLen, bool blo
     }
   }
 
-  // 加锁写入队列
-  _cond[priority].lock();
-  _queues[priority].push(packet);
-  _cond[priority].unlock();
-  _cond[priority].signal();
+  // 无锁写入队列, 队列满时和超过maxQueueLen一样等待
+  while (OB_SIZE_OVERFLOW == (err = _queues[priority].push(packet)) && block && !_stop)
+  {
+    _pushcond[priority].lock();
+    _waiting[priority] = true;
+    _pushcond[priority].wait(1);
+    _waiting[priority] = false;
+    _pushcond[priority].unlock();
+  }
+  if (OB_SUCCESS == err)
+  {
+    futex_post(&_queuedSem);
+  }
+  else if (OB_SIZE_OVERFLOW == err && !block)
+  {
+    return false;
+  }
+  else if (!_stop)
+  {
+    TBSYS_LOG(ERROR, "push packet fail, err=%d priority=%d", err, priority);
+  }
   return true;
 }
 
+int64_t PriorityPacketQueueThread::choose_priority_()
+{
+  int64_t priority = NORMAL_PRIV;
+  if (_queues[NORMAL_PRIV].get_total() == 0)
+  {
+    // only low priv queue has task
+    priority = LOW_PRIV;
+  }
+  else if (_queues[LOW_PRIV].get_total() > 0)
+  {
+    priority = ObStalessProbabilityRandom::random(_percent, QUEUE_NUM, _sum);
+    if (priority >= QUEUE_NUM || priority < 0)
+    {
+      priority = NORMAL_PRIV;
+    }
+  }
+  return priority;
+}
+
 ObPacket* PriorityPacketQueueThread::pop_packet_(const int64_t priority)
 {
   ObPacket* packet = NULL;
 
-    _cond[priority].lock();
-    // 取出packet
-    packet = _queues[priority].pop();
-    _cond[priority].unlock();
+  // 取出packet
+  _queues[priority].pop(packet);
 
-    // push 在等吗?
+  // push 在等吗?
   if (NULL != packet && _waiting[priority])
   {
-      _pushcond[priority].lock();
-      _pushcond[priority].signal();
-      _pushcond[priority].unlock();
-    }
+    _pushcond[priority].lock();
+    _pushcond[priority].signal();
+    _pushcond[priority].unlock();
+  }
 
   return packet;
 }
-void PriorityPacketQueueThread::set_ip_port(const IpPort & ip_port)
-{
-  ip_port_ = ip_port;
-}
 
-// Runnable 接口
-void PriorityPacketQueueThread::run(tbsys::CThread *, void *)
+int64_t PriorityPacketQueueThread::pop_packets_(ObPacket **packets, const int64_t max_num)
 {
+  int64_t token_num = 0;
+  int64_t packet_num = 0;
+  int64_t priority = NORMAL_PRIV;
   ObPacket *packet = NULL;
-  int64_t priority = -1;
-  static const int64_t TASK_WAIT_TIME = 1; // wait 1ms if there is no task
-
-  while (!_stop)
+  timespec end_time;
+  if (0 == futex_wait(&_queuedSem, calc_abs_time(&end_time, QUEUE_WAIT_TIME_NS)))
   {
-    if (_queues[NORMAL_PRIV].size() == 0)
+    token_num = 1;
+    while (token_num < max_num && 0 == futex_trywait(&_queuedSem))
     {
-      if (_queues[LOW_PRIV].size() == 0) // no task at all
-      {
-        // wait 1ms for normal task
-        _cond[NORMAL_PRIV].lock();
-        _cond[NORMAL_PRIV].wait(TASK_WAIT_TIME);
-        _cond[NORMAL_PRIV].unlock();
-        continue;
-      }
-      else // only low priv queue has task
-      {
-        priority = LOW_PRIV;
-      }
+      token_num++;
     }
-    else
+  }
+  // 每个token对应一个已经push的packet, 但packet可能还没有写入槽位
+  while (packet_num < token_num && !_stop)
+  {
+    priority = choose_priority_();
+    if (NULL != (packet = pop_packet_(priority))
+        || NULL != (packet = pop_packet_(NORMAL_PRIV == priority ? LOW_PRIV : NORMAL_PRIV)))
     {
-      if (_queues[LOW_PRIV].size() == 0) // only normal priv queue has task
-      {
-      priority = NORMAL_PRIV;
+      packets[packet_num++] = packet;
     }
     else
     {
-        priority = ObStalessProbabilityRandom::random(_percent, QUEUE_NUM, _sum);
-        if (priority >= QUEUE_NUM || priority < 0)
-        {
-          priority = NORMAL_PRIV;
-        }
-      }
+      PAUSE();
     }
+  }
+  int64_t now = tbsys::CTimeUtil::getTime();
+  for (int64_t i = 0; i < packet_num; ++i)
+  {
+    if (0 < packets[i]->get_receive_ts())
+    {
+      _waitTimeHistogram.add(now - packets[i]->get_receive_ts());
+    }
+  }
+  if (0 < packet_num && _waitTimeHistogram.reach_print_interval())
+  {
+    TBSYS_LOG(INFO, "priority packet queue %p wait time: %s", this, to_cstring(_waitTimeHistogram));
+  }
+  return packet_num;
+}
 
-    if (_stop) break;
+void PriorityPacketQueueThread::set_ip_port(const IpPort & ip_port)
+{
+  ip_port_ = ip_port;
+}
 
-    packet = pop_packet_(priority);
-    if (packet == NULL) continue;
+void PriorityPacketQueueThread::handle_packet_(ObPacket *packet, const int64_t numa_node)
+{
+  int64_t trace_id = packet->get_trace_id();
+  if (0 == trace_id)
+  {
+    TraceId *new_id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
+    (new_id->id).seq_ = atomic_inc(&(SeqGenerator::seq_generator_));
+    (new_id->id).ip_ = ip_port_.ip_;
+    (new_id->id).port_ = ip_port_.port_;
+    packet->set_trace_id(new_id->uval_);
+  }
+  else
+  {
+    uint32_t *channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_CHID_1);
+    *channel_id = packet->get_channel_id();
+    TraceId *id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
+    id->uval_ = static_cast<uint64_t>(trace_id);
+  }
+  int64_t st = tbsys::CTimeUtil::getTime();
+  PROFILE_LOG(DEBUG, HANDLE_PACKET_START_TIME PCODE, st, packet->get_packet_code());
+  _handler->handlePacketQueue(packet, _args);
+  int64_t ed = tbsys::CTimeUtil::getTime();
+  PROFILE_LOG(DEBUG, HANDLE_PACKET_END_TIME PCODE, ed, packet->get_packet_code());
+  if (0 <= numa_node)
+  {
+    ObNumaTopology::get_instance().add_request_stat(numa_node, ed - st);
+  }
+}
 
-    // handle packet
-    if (_handler)
-    {
-      int64_t trace_id = packet->get_trace_id();
-      if (0 == trace_id)
-      {
-        TraceId *new_id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-        (new_id->id).seq_ = atomic_inc(&(SeqGenerator::seq_generator_));
-        (new_id->id).ip_ = ip_port_.ip_;
-        (new_id->id).port_ = ip_port_.port_;
-        packet->set_trace_id(new_id->uval_);
-      }
-      else
-      {
-        uint32_t *channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_CHID_1);
-        *channel_id = packet->get_channel_id();
-        TraceId *id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-        id->uval_ = static_cast<uint64_t>(trace_id);
-      }
-      int64_t st = tbsys::CTimeUtil::getTime();
-      PROFILE_LOG(DEBUG, HANDLE_PACKET_START_TIME PCODE, st, packet->get_packet_code());
-      _handler->handlePacketQueue(packet, _args);
-      int64_t ed = tbsys::CTimeUtil::getTime();
-      PROFILE_LOG(DEBUG, HANDLE_PACKET_END_TIME PCODE, ed, packet->get_packet_code());
-    }
+// Runnable 接口
+void PriorityPacketQueueThread::run(tbsys::CThread *, void *arg)
+{
+  ObPacket *packets[MAX_POP_BATCH_NUM];
+  ObPacket *packet = NULL;
+  int64_t packet_num = 0;
+  int64_t numa_node = -1;
+  if (_numaAware)
+  {
+    numa_node = ObNumaTopology::get_instance().bind_thread_round_robin(reinterpret_cast<int64_t>(arg));
   }
 
-  // 把queue中所有的task做完
-  if (_waitFinish)
+  while (!_stop)
   {
-    for (int64_t priority = NORMAL_PRIV; priority <= LOW_PRIV; ++priority)
-    {
-      bool ret = true;
-      _cond[priority].lock();
-      while (_queues[priority].size() > 0) {
-        packet = _queues[priority].pop();
-        _cond[priority].unlock();
-        ret = true;
-        if (_handler) {
-          int64_t trace_id = packet->get_trace_id();
-          if (0 == trace_id)
-          {
-            TraceId *new_id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-            (new_id->id).seq_ = atomic_inc(&(SeqGenerator::seq_generator_));
-            (new_id->id).ip_ = ip_port_.ip_;
-            (new_id->id).port_ = ip_port_.port_;
-            packet->set_trace_id(new_id->uval_);
-          }
-          else
-          {
-            uint32_t *channel_id = GET_TSI_MULT(uint32_t, TSI_COMMON_PACKET_CHID_1);
-            *channel_id = packet->get_channel_id();
-            TraceId *id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
-            id->uval_ = static_cast<uint64_t>(trace_id);
-          }
-          int64_t st = tbsys::CTimeUtil::getTime();
-          PROFILE_LOG(DEBUG, HANDLE_PACKET_START_TIME PCODE, st, packet->get_packet_code());
-          ret = _handler->handlePacketQueue(packet, _args);
-          int64_t ed = tbsys::CTimeUtil::getTime();
-          PROFILE_LOG(DEBUG, HANDLE_PACKET_END_TIME PCODE, ed, packet->get_packet_code());
-        }
-        //if (ret) delete packet;
+    // 没有任务时在信号量上睡眠, push时唤醒
+    packet_num = pop_packets_(packets, _popBatchNum);
 
-        _cond[priority].lock();
-      }
-      _cond[priority].unlock();
+    // handle packet
+    for (int64_t i = 0; NULL != _handler && i < packet_num; ++i)
+    {
+      handle_packet_(packets[i], numa_node);
     }
   }
-  else
+
+  // 把queue中所有的task做完, 否则丢弃
+  for (int64_t priority = NORMAL_PRIV; priority <= LOW_PRIV; ++priority)
   {
-    // 把queue中的free掉
-    for (int64_t priority = NORMAL_PRIV; priority <= LOW_PRIV; ++priority)
+    while (NULL != (packet = pop_packet_(priority)))
     {
-      _cond[priority].lock();
-      while (_queues[priority].size() > 0) {
-        _queues[priority].pop();
+      if (_waitFinish && NULL != _handler)
+      {
+        handle_packet_(packet, -1);
       }
-      _cond[priority].unlock();
     }
   }
 }
 
 }
 }
-
@@ -19,8 +19,10 @@
 #define OCEANBASE_COMMON_PRIORITY_PACKET_QUEUE_THREAD_H
 
 #include "ob_packet.h"
-#include "ob_packet_queue.h"
+#include "ob_fixed_queue.h"
 #include "ob_packet_queue_handler.h"
+#include "ob_wait_time_histogram.h"
+#include "futex_sem.h"
 #include "ob_trace_id.h"
 
 namespace oceanbase {
@@ -50,30 +52,37 @@ public:
   // stop
   void stop(bool waitFinish = false);
 
+  // 工作线程按round robin绑定到numa node上, 在start之前调用
+  void set_numa_aware(const bool numa_aware)
+  {
+    _numaAware = numa_aware;
+  }
+
+  // 每个优先级队列最多容纳的packet数, 在setThreadParameter之前调用
+  void set_queue_capacity(const int64_t capacity);
+
+  // 工作线程一次最多取batch_num个packet依次处理, 默认为1
+  void set_pop_batch_num(const int64_t batch_num);
+
   // push
   bool push(ObPacket *packet, int maxQueueLen = 0, bool block = true, int priority = NORMAL_PRIV);
 
   // Runnable 接口
   void run(tbsys::CThread *thread, void *arg);
 
-  ObPacket* head(int priority)
-  {
-    return _queues[priority].head();
-  }
-
-  ObPacket* tail(int priority)
+  size_t size(int priority)
   {
-    return _queues[priority].tail();
+    return static_cast<size_t>(_queues[priority].get_total());
   }
 
-  size_t size(int priority)
+  size_t size()
   {
-    return _queues[priority].size();
+    return static_cast<size_t>(_queues[NORMAL_PRIV].get_total() + _queues[LOW_PRIV].get_total());
   }
 
-  size_t size()
+  const ObWaitTimeHistogram &get_wait_time_histogram() const
   {
-    return _queues[NORMAL_PRIV].size() + _queues[LOW_PRIV].size();
+    return _waitTimeHistogram;
   }
 
   int64_t get_low_priv_cur_percent()
@@ -99,12 +108,20 @@ public:
   }
 
 private:
+  int init_queues_();
+  // 按比例选择下一个packet的优先级
+  int64_t choose_priority_();
   // pop packet from packet queue
   ObPacket* pop_packet_(const int64_t priority);
+  // 等待并取出最多max_num个packet
+  int64_t pop_packets_(ObPacket **packets, const int64_t max_num);
+  void handle_packet_(ObPacket *packet, const int64_t numa_node);
 
 public:
   static const int64_t LOW_PRIV_MAX_PERCENT = 90;
   static const int64_t LOW_PRIV_MIN_PERCENT = 10;
+  static const int64_t DEFAULT_QUEUE_CAPACITY = 64L * 1024L;
+  static const int64_t MAX_POP_BATCH_NUM = 64;
 
 private:
   static const int64_t QUEUE_NUM = 2;
@@ -112,11 +129,14 @@ private:
   static const int64_t MAX_WAIT_TIME_MS = 1000; // 1000ms
   // The work thread fetches several(3, by default) normal tasks and then try to fetch a low priv task
   static const int64_t CONTINOUS_NORMAL_TASK_NUM = 3;
+  // 空闲的工作线程最长等待时间, 醒来后检查是否已经stop
+  static const int64_t QUEUE_WAIT_TIME_NS = 100L * 1000L * 1000L;
 
 private:
-  ObPacketQueue _queues[QUEUE_NUM];
+  ObFixedQueue<ObPacket> _queues[QUEUE_NUM];
   ObPacketQueueHandler *_handler;
-  tbsys::CThreadCond _cond[QUEUE_NUM];
+  // 两个队列中packet的总数
+  fsem_t _queuedSem;
   tbsys::CThreadCond _pushcond[QUEUE_NUM];
   void *_args;
   bool _waitFinish;       // 等待完成
@@ -125,6 +145,10 @@ private:
   int32_t _percent[QUEUE_NUM];
   int32_t _sum;
   IpPort ip_port_;
+  bool _numaAware;
+  int64_t _queueCapacity;
+  int64_t _popBatchNum;
+  ObWaitTimeHistogram _waitTimeHistogram;
 };
 
 }
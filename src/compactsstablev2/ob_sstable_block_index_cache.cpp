@@ -178,6 +178,75 @@ namespace oceanbase
       return ret;
     }
 
+    int ObSSTableBlockIndexCache::get_split_rowkeys(
+        const ObBlockIndexPositionInfo& block_index_info,
+        const uint64_t table_id,
+        const int64_t split_num,
+        PageArena<char>& allocator,
+        ObRowkey* keys,
+        int64_t& key_count)
+    {
+      int ret = OB_SUCCESS;
+      bool revert_handle = false;
+      ObSSTableBlockIndexMgr block_index;
+      Handle handle;
+      ObRowkey endkey;
+      int64_t block_count = 0;
+      int64_t index = 0;
+      int64_t last_index = -1;
+      key_count = 0;
+
+      if (NULL == keys || split_num <= 1)
+      {
+        TBSYS_LOG(WARN, "invalid argument, keys=%p, split_num=%ld", keys, split_num);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = check_param(block_index_info, table_id)))
+      {
+        TBSYS_LOG(ERROR, "check param error");
+      }
+      else if (OB_SUCCESS != (ret = load_block_index(block_index_info, 
+              block_index, table_id, handle)))
+      {
+        TBSYS_LOG(ERROR, "load block index error");
+      }
+      else
+      {
+        revert_handle = true;
+        block_count = block_index.get_block_count();
+        for (int64_t i = 1; i < split_num && OB_SUCCESS == ret; i ++)
+        {
+          index = block_count * i / split_num - 1;
+          if (index <= last_index)
+          {
+            //not enough blocks
+            continue;
+          }
+          else if (OB_SUCCESS != (ret = block_index.get_block_endkey(index, endkey)))
+          {
+            TBSYS_LOG(WARN, "get block endkey error:ret=%d,index=%ld", ret, index);
+          }
+          else if (OB_SUCCESS != (ret = endkey.deep_copy(keys[key_count], allocator)))
+          {
+            TBSYS_LOG(WARN, "deep copy endkey error:ret=%d,endkey=%s",
+                ret, to_cstring(endkey));
+          }
+          else
+          {
+            key_count ++;
+            last_index = index;
+          }
+        }
+      }
+
+      if (revert_handle && OB_SUCCESS != kv_cache_.revert(handle))
+      {
+        TBSYS_LOG(WARN, "kv cache revert error");
+      }
+
+      return ret;
+    }
+
 
     int ObSSTableBlockIndexCache::read_index_record(IFileInfoMgr& fileinfo_cache, 
         const uint64_t sstable_id, const int64_t offset, 
@@ -5,6 +5,7 @@
 #include "common/ob_kv_storecache.h"
 #include "common/ob_fileinfo_manager.h"
 #include "common/ob_range2.h"
+#include "common/page_arena.h"
 #include "common/ob_record_header_v2.h"
 #include "ob_sstable_block_index_mgr.h"
 
@@ -129,6 +130,17 @@ namespace oceanbase
           const uint64_t table_id, const int64_t cur_offset,
           const SearchMode search_mode, ObBlockPositionInfos& pos_info);
 
+      /**
+       * split the blocks of the table into %split_num parts with almost
+       * same block count, and deep copy the endkeys of the first parts
+       * into %keys, at most %split_num - 1 keys, fewer if the table has
+       * not enough blocks.
+       */
+      int get_split_rowkeys(const ObBlockIndexPositionInfo& block_index_info,
+          const uint64_t table_id, const int64_t split_num,
+          common::PageArena<char>& allocator, common::ObRowkey* keys,
+          int64_t& key_count);
+
     private:
       int read_index_record(common::IFileInfoMgr& fileinfo_cache, 
                       const uint64_t sstable_id, 
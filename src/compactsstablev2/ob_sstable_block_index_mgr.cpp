@@ -402,6 +402,65 @@ namespace oceanbase
       return OB_SUCCESS;
     }
 
+    int ObSSTableBlockIndexMgr::get_block_endkey(const int64_t index,
+        common::ObRowkey& key) const
+    {
+      int ret = OB_SUCCESS;
+      Bound bound;
+
+      if (index < 0 || index >= block_count_)
+      {
+        TBSYS_LOG(WARN, "invalid block index:index=%ld,block_count_=%ld",
+            index, block_count_);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = get_bound(bound)))
+      {
+        TBSYS_LOG(ERROR, "get bound error");
+      }
+      else if (OB_SUCCESS != (ret = get_row_key(*(bound.begin_ + index), key)))
+      {
+        TBSYS_LOG(WARN, "get row key error:ret=%d,index=%ld", ret, index);
+      }
+
+      return ret;
+    }
+
+    int ObSSTableBlockIndexMgr::split_range(const common::ObNewRange& range,
+        const common::ObRowkey* keys, const int64_t key_count,
+        common::ObNewRange* sub_ranges)
+    {
+      int ret = OB_SUCCESS;
+
+      if ((key_count > 0 && NULL == keys) || key_count < 0 || NULL == sub_ranges)
+      {
+        TBSYS_LOG(WARN, "invalid argument:keys=%p,key_count=%ld,sub_ranges=%p",
+            keys, key_count, sub_ranges);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        for (int64_t i = 0; i <= key_count; i ++)
+        {
+          sub_ranges[i] = range;
+          if (i > 0)
+          {
+            sub_ranges[i].start_key_ = keys[i - 1];
+            sub_ranges[i].border_flag_.unset_inclusive_start();
+            sub_ranges[i].border_flag_.unset_min_value();
+          }
+          if (i < key_count)
+          {
+            sub_ranges[i].end_key_ = keys[i];
+            sub_ranges[i].border_flag_.set_inclusive_end();
+            sub_ranges[i].border_flag_.unset_max_value();
+          }
+        }
+      }
+
+      return ret;
+    }
+
     int ObSSTableBlockIndexMgr::get_row_key(const ObSSTableBlockIndex& index, 
         common::ObRowkey& key) const
     {
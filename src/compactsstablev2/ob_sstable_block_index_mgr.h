@@ -214,6 +214,23 @@ namespace oceanbase
 
       ObSSTableBlockIndexMgr* copy(char* buffer) const;
 
+      /**
+       * get the endkey of the %index-th block, %key points to thread
+       * local buffer, deep copy it before next call
+       */
+      int get_block_endkey(const int64_t index, common::ObRowkey& key) const;
+
+      /**
+       * cut %range at the ascending %keys into %key_count + 1 sub ranges,
+       * each split key is the inclusive end of one sub range and the
+       * exclusive start of the next one, so every row of %range falls
+       * into exactly one sub range. sub ranges share keys with %range
+       * and %keys, no deep copy.
+       */
+      static int split_range(const common::ObNewRange& range,
+          const common::ObRowkey* keys, const int64_t key_count,
+          common::ObNewRange* sub_ranges);
+
       inline int64_t get_size() const
       {
         return (sizeof(*this) + block_index_length_ + block_endkey_length_);
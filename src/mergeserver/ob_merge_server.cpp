@@ -6,6 +6,9 @@
 #include "ob_merge_callback.h"
 #include "common/ob_tbnet_callback.h"
 #include "common/utility.h"
+#include "common/ob_numa.h"
+#include "common/ob_huge_page.h"
+#include "sql/ob_in_memory_sort.h"
 
 using namespace oceanbase::common;
 
@@ -163,11 +166,31 @@ namespace oceanbase
         ret = set_min_left_time(ms_config_.task_left_time);
       }
 
+      if (ret == OB_SUCCESS)
+      {
+        ret = ObNumaTopology::get_instance().init(ms_config_.numa_aware);
+        set_numa_aware(ms_config_.numa_aware);
+      }
+
+      if (ret == OB_SUCCESS)
+      {
+        ret = ObHugePagePool::get_instance().init(ms_config_.huge_page_mode);
+      }
+
       if (ret == OB_SUCCESS)
       {
         ret = task_timer_.init();
       }
 
+      if (ret == OB_SUCCESS)
+      {
+        ret = sort_worker_pool_.init(ms_config_.sort_thread_count);
+        if (OB_SUCCESS == ret)
+        {
+          sql::ObInMemorySort::set_worker_pool(&sort_worker_pool_);
+        }
+      }
+
       if (OB_SUCCESS == ret)
       {
         ret = client_manager_.initialize(eio_, &server_handler_);
@@ -190,6 +213,8 @@ namespace oceanbase
     {
       task_timer_.destroy();
       service_.destroy();
+      sql::ObInMemorySort::set_worker_pool(NULL);
+      sort_worker_pool_.destroy();
       ObSingleServer::destroy();
     }
 
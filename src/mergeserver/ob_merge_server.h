@@ -9,6 +9,7 @@
 #include "common/ob_client_manager.h"
 #include "common/ob_config_manager.h"
 #include "common/ob_privilege_manager.h"
+#include "sql/ob_sort_worker_pool.h"
 #include "ob_merge_server_service.h"
 
 namespace oceanbase
@@ -88,6 +89,7 @@ namespace oceanbase
         common::ObServer root_server_;
         ObMergeServerService service_;
         common::ObPrivilegeManager privilege_mgr_;
+        sql::ObSortWorkerPool sort_worker_pool_;
     };
   } /* mergeserver */
 } /* oceanbase */
@@ -67,7 +67,11 @@ namespace oceanbase
         DEF_INT(timeout_percent, "70", "[10,80]", "max cs timeout to ms timeout, used by ms retry");
         DEF_BOOL(allow_return_uncomplete_result, "False", "allow return uncomplete result");
         DEF_TIME(slow_query_threshold, "100ms", "query time beyond this value will be treat as slow query");
+        DEF_BOOL(enable_query_profile, "False", "profile every sql query and keep slow ones in __all_slow_query");
+        DEF_BOOL(accept_compact_row, "True", "ask chunkservers to return scan rows in compact format");
         DEF_CAP(query_cache_size, "0", "[0,]", "query cache size, 0 means disabled");
+        DEF_INT(max_cached_plans_per_session, "0", "[0,10240]", "max number of parameterized plans cached by one session, 0 means disabled");
+        DEF_INT(sort_thread_count, "8", "[0,64]", "threads shared by all the sorts with ob_query_parallel_degree > 1, 0 means sort in the session thread, can't reload");
         //param for obmysql
         DEF_INT(obmysql_port, "3100", "(1024,65536)", "obmysql listen port");
         DEF_INT(obmysql_io_thread_count, "4", "[1,]", "obmysql io thread count for libeasy");
@@ -15,6 +15,7 @@
 #include "common/ob_tsi_factory.h"
 #include "common/ob_schema_manager.h"
 #include "common/ob_new_scanner.h"
+#include "common/ob_query_profile.h"
 #include "sql/ob_sql_result_set.h"
 #include "ob_ms_rpc_proxy.h"
 #include "common/ob_general_rpc_stub.h"
@@ -1556,6 +1557,7 @@ namespace oceanbase
       UNUSED(start_time);
       UNUSED(timeout_us);
       const int32_t OB_MS_ACCEPT_SCHEMA_VERSION = 1;
+      const int32_t OB_MS_ACCEPT_SCHEMA_DELTA_VERSION = 2;
 
       common::ObResultCode rc;
       rc.result_code_ = OB_SUCCESS;
@@ -1564,12 +1566,12 @@ namespace oceanbase
       int ret = OB_SUCCESS;
       int64_t schema_version = 0;
 
-      if (version != OB_MS_ACCEPT_SCHEMA_VERSION)
+      if (version != OB_MS_ACCEPT_SCHEMA_VERSION && version != OB_MS_ACCEPT_SCHEMA_DELTA_VERSION)
       {
         err = OB_ERROR_FUNC_VERSION;
       }
 
-      if (OB_SUCCESS == err)
+      if (OB_SUCCESS == err && OB_MS_ACCEPT_SCHEMA_VERSION == version)
       {
         if (NULL == (schema = OB_NEW(ObSchemaManagerV2, ObModIds::OB_MS_SERVICE_FUNC)))
         {
@@ -1587,7 +1589,27 @@ namespace oceanbase
         }
       }
 
-      if (OB_SUCCESS == err)
+      if (OB_SUCCESS == err && OB_MS_ACCEPT_SCHEMA_DELTA_VERSION == version)
+      {
+        // only the tables changed since the latest version are sent
+        ObSchemaDelta delta;
+        if (OB_SUCCESS != (err = delta.deserialize(
+                in_buffer.get_data(), in_buffer.get_capacity(),
+                in_buffer.get_position())))
+        {
+          TBSYS_LOG(WARN, "fail to deserialize schema delta:err[%d]", err);
+        }
+        else if (OB_SUCCESS != (err = schema_mgr_->apply_delta(delta)))
+        {
+          TBSYS_LOG(WARN, "fail to apply schema delta:err[%d], base[%ld], version[%ld], latest[%ld]",
+              err, delta.get_base_version(), delta.get_version(), schema_mgr_->get_latest_version());
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "apply schema delta succ:%s", to_cstring(delta));
+        }
+      }
+      else if (OB_SUCCESS == err)
       {
         err = schema->deserialize(
               in_buffer.get_data(), in_buffer.get_capacity(),
@@ -1602,7 +1624,7 @@ namespace oceanbase
         }
       }
 
-      if (OB_SUCCESS == err)
+      if (OB_SUCCESS == err && OB_MS_ACCEPT_SCHEMA_VERSION == version)
       {
         if (schema_version <= schema_mgr_->get_latest_version())
         {
@@ -2262,6 +2284,12 @@ namespace oceanbase
           new_scanner->set_range(*sql_scan_param_ptr->get_range());
           rc.result_code_ = service_monitor_->get_scanner(*new_scanner);
         }
+        else if (OB_ALL_SLOW_QUERY_TID == table_id)
+        {
+          new_scanner->set_range(*sql_scan_param_ptr->get_range());
+          rc.result_code_ = ObSlowQueryLog::get_instance().get_scanner(
+            OB_MERGESERVER, merge_server_->get_self(), *new_scanner);
+        }
         if(OB_SUCCESS != rc.result_code_)
         {
           TBSYS_LOG(WARN, "open query service fail:err[%d]", rc.result_code_);
@@ -5,6 +5,7 @@
 #include "common/ob_atomic.h"
 #include "common/ob_common_param.h"
 #include "common/ob_malloc.h"
+#include "common/ob_query_profile.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::mergeserver;
@@ -271,6 +272,11 @@ int ObMsSqlRequest::process_rpc_event(const int64_t timeout, ObMsSqlRpcEvent * e
     {
       TBSYS_LOG(DEBUG, "push the event to result succ:client[%lu], request[%lu], event[%lu]",
           event->get_client_id(), request_id_, event->get_event_id());
+      ObQueryProfile *query_profile = ObQueryProfile::get_current();
+      if (NULL != query_profile && OB_SUCCESS == event->get_result_code())
+      {
+        query_profile->add_rpc(event->get_time_used(), event->get_result().get_rpc_profile());
+      }
       ret = process_result(timeout, event, finish);
       if (ret != OB_SUCCESS)
       {
@@ -7,6 +7,7 @@
 #include "common/utility.h"
 #include "common/hash/ob_hashutils.h"
 #include "obmysql/packet/ob_mysql_error_packet.h"
+#include "ob_mysql_compress.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::common::hash;
@@ -35,9 +36,8 @@ namespace oceanbase
     {
       uint32_t pkt_len = 0;
       uint8_t pkt_seq = 0;
-      uint8_t pkt_type = 0;
       ObMySQLCommandPacket* packet = NULL;
-      char* buffer = NULL;
+      ObMySQLConnectionInfo* info = NULL;
       int32_t len = 0;
 
       if (NULL == m)
@@ -48,6 +48,10 @@ namespace oceanbase
       {
         TBSYS_LOG(ERROR, "invalide argument m->input is %p", m->input);
       }
+      else if (NULL != (info = ObMySQLConnectionInfo::get(m->c)) && info->is_compress())
+      {
+        packet = decode_compressed(m, info);
+      }
       else
       {
         if ((len = static_cast<int32_t>(m->input->last - m->input->pos)) >= OB_MYSQL_PACKET_HEADER_SIZE)
@@ -60,27 +64,7 @@ namespace oceanbase
           //message has enough buffer
           if (pkt_len <= m->input->last - m->input->pos)
           {
-            ObMySQLUtil::get_uint1(m->input->pos, pkt_type);
-            //利用message带的pool进行应用层内存的分配
-            buffer = reinterpret_cast<char*>(easy_pool_alloc(m->pool,
-                                                              static_cast<uint32_t>(sizeof(ObMySQLCommandPacket) + pkt_len)));
-            if (NULL == buffer)
-            {
-              TBSYS_LOG(ERROR, "alloc packet buffer(length=%lu) from m->pool failed", sizeof(ObMySQLCommandPacket) + pkt_len);
-            }
-            else
-            {
-              TBSYS_LOG(DEBUG, "alloc packet buffer length = %lu", sizeof(ObMySQLCommandPacket) + pkt_len);
-              packet = new(buffer)ObMySQLCommandPacket();
-              packet->set_header(pkt_len, pkt_seq);
-              packet->set_type(pkt_type);
-              packet->set_receive_ts(tbsys::CTimeUtil::getTime());
-              memcpy(buffer + sizeof(ObMySQLCommandPacket), m->input->pos, pkt_len - 1);
-              packet->get_command().assign(buffer + sizeof(ObMySQLCommandPacket), pkt_len - 1);
-              TBSYS_LOG(DEBUG, "decode comand packet command is \"%.*s\"", packet->get_command().length(),
-                        packet->get_command().ptr());
-              m->input->pos += pkt_len - 1;
-            }
+            packet = new_command_packet(m->pool, pkt_len, pkt_seq, m->input->pos);
           }
           else
           {
@@ -94,6 +78,177 @@ namespace oceanbase
       return packet;
     }
 
+    ObMySQLCommandPacket* ObMySQLCallback::decode_compressed(easy_message_t* m, ObMySQLConnectionInfo* info)
+    {
+      int ret = OB_SUCCESS;
+      ObMySQLCommandPacket* packet = NULL;
+      bool is_complete = true;
+      uint32_t pkt_len = 0;
+      uint8_t pkt_seq = 0;
+      while (OB_SUCCESS == ret && NULL == packet && is_complete)
+      {
+        if (has_plain_packet(info, pkt_len))
+        {
+          char* pos = info->plain_buf_ + info->plain_pos_;
+          ObMySQLUtil::get_uint3(pos, pkt_len);
+          ObMySQLUtil::get_uint1(pos, pkt_seq);
+          if (0 == pkt_len)
+          {
+            TBSYS_LOG(WARN, "empty packet in compressed stream, peer=%s", inet_ntoa_r(m->c->addr));
+            ret = OB_INVALID_DATA;
+          }
+          else if (NULL == (packet = new_command_packet(m->pool, pkt_len, pkt_seq, pos)))
+          {
+            ret = OB_ALLOCATE_MEMORY_FAILED;
+          }
+          else
+          {
+            info->plain_pos_ += OB_MYSQL_PACKET_HEADER_SIZE + pkt_len;
+          }
+        }
+        else if (0 < info->frame_len_)
+        {
+          //the rest of the stream buffer continues in next frame
+          m->input->pos += info->frame_len_;
+          info->frame_len_ = 0;
+        }
+        else
+        {
+          ret = decompress_frame(m, info, is_complete);
+        }
+      }
+      //easy stops decoding when the input is used up, so hold the frame
+      //in input while it still has complete packets left
+      if (NULL != packet && 0 < info->frame_len_ && !has_plain_packet(info, pkt_len))
+      {
+        m->input->pos += info->frame_len_;
+        info->frame_len_ = 0;
+      }
+      if (OB_SUCCESS != ret)
+      {
+        //destroy the connection, the stream can not be decoded any more
+        m->status = EASY_ERROR;
+      }
+      return packet;
+    }
+
+    int ObMySQLCallback::decompress_frame(easy_message_t* m, ObMySQLConnectionInfo* info, bool& is_complete)
+    {
+      int ret = OB_SUCCESS;
+      uint32_t payload_len = 0;
+      uint8_t compress_seq = 0;
+      uint32_t data_len = 0;
+      int64_t len = m->input->last - m->input->pos;
+      is_complete = false;
+      if (len >= ObMySQLCompress::COMPRESS_HEADER_SIZE)
+      {
+        ObMySQLCompress::decode_header(m->input->pos, payload_len, compress_seq, data_len);
+        len -= ObMySQLCompress::COMPRESS_HEADER_SIZE;
+        if (payload_len > len)
+        {
+          m->next_read_len = static_cast<int>(payload_len - len);
+          TBSYS_LOG(DEBUG, "not enough data in message, compressed length = %u, data in message is %ld",
+                    payload_len, len);
+        }
+        else
+        {
+          int64_t left_len = info->plain_len_ - info->plain_pos_;
+          int64_t buf_len = left_len + std::max(payload_len, data_len);
+          int64_t plain_len = 0;
+          if (buf_len > info->plain_buf_size_)
+          {
+            int64_t new_size = std::max(buf_len, 2 * info->plain_buf_size_);
+            char* new_buf = reinterpret_cast<char*>(ob_malloc(new_size, ObModIds::OB_MYSQL_PACKET));
+            if (NULL == new_buf)
+            {
+              TBSYS_LOG(ERROR, "alloc uncompress buffer(length=%ld) failed", new_size);
+              ret = OB_ALLOCATE_MEMORY_FAILED;
+            }
+            else
+            {
+              if (0 < left_len)
+              {
+                memcpy(new_buf, info->plain_buf_ + info->plain_pos_, left_len);
+              }
+              if (NULL != info->plain_buf_)
+              {
+                ob_free(info->plain_buf_);
+              }
+              info->plain_buf_ = new_buf;
+              info->plain_buf_size_ = new_size;
+            }
+          }
+          else if (0 < left_len && 0 < info->plain_pos_)
+          {
+            memmove(info->plain_buf_, info->plain_buf_ + info->plain_pos_, left_len);
+          }
+          if (OB_SUCCESS == ret)
+          {
+            info->plain_pos_ = 0;
+            info->plain_len_ = left_len;
+            if (OB_SUCCESS != (ret = ObMySQLCompress::decode_payload(
+                                 m->input->pos + ObMySQLCompress::COMPRESS_HEADER_SIZE,
+                                 payload_len, data_len, info->plain_buf_ + left_len,
+                                 info->plain_buf_size_ - left_len, plain_len)))
+            {
+              TBSYS_LOG(WARN, "decode compressed packet failed, ret=%d peer=%s", ret, inet_ntoa_r(m->c->addr));
+            }
+            else
+            {
+              info->plain_len_ += plain_len;
+              info->frame_len_ = ObMySQLCompress::COMPRESS_HEADER_SIZE + payload_len;
+              //responses of this command continue the compressed sequence of client
+              info->compress_seq_ = static_cast<uint8_t>(compress_seq + 1);
+              is_complete = true;
+            }
+          }
+        }
+      }
+      return ret;
+    }
+
+    bool ObMySQLCallback::has_plain_packet(const ObMySQLConnectionInfo* info, uint32_t& pkt_len)
+    {
+      bool bret = false;
+      int64_t left_len = info->plain_len_ - info->plain_pos_;
+      if (left_len >= OB_MYSQL_PACKET_HEADER_SIZE)
+      {
+        char* pos = info->plain_buf_ + info->plain_pos_;
+        ObMySQLUtil::get_uint3(pos, pkt_len);
+        bret = (OB_MYSQL_PACKET_HEADER_SIZE + pkt_len <= left_len);
+      }
+      return bret;
+    }
+
+    ObMySQLCommandPacket* ObMySQLCallback::new_command_packet(easy_pool_t* pool, const uint32_t pkt_len,
+                                                              const uint8_t pkt_seq, char*& pos)
+    {
+      ObMySQLCommandPacket* packet = NULL;
+      uint8_t pkt_type = 0;
+      ObMySQLUtil::get_uint1(pos, pkt_type);
+      //利用message带的pool进行应用层内存的分配
+      char* buffer = reinterpret_cast<char*>(easy_pool_alloc(pool,
+                                                             static_cast<uint32_t>(sizeof(ObMySQLCommandPacket) + pkt_len)));
+      if (NULL == buffer)
+      {
+        TBSYS_LOG(ERROR, "alloc packet buffer(length=%lu) from m->pool failed", sizeof(ObMySQLCommandPacket) + pkt_len);
+      }
+      else
+      {
+        TBSYS_LOG(DEBUG, "alloc packet buffer length = %lu", sizeof(ObMySQLCommandPacket) + pkt_len);
+        packet = new(buffer)ObMySQLCommandPacket();
+        packet->set_header(pkt_len, pkt_seq);
+        packet->set_type(pkt_type);
+        packet->set_receive_ts(tbsys::CTimeUtil::getTime());
+        memcpy(buffer + sizeof(ObMySQLCommandPacket), pos, pkt_len - 1);
+        packet->get_command().assign(buffer + sizeof(ObMySQLCommandPacket), pkt_len - 1);
+        TBSYS_LOG(DEBUG, "decode comand packet command is \"%.*s\"", packet->get_command().length(),
+                  packet->get_command().ptr());
+        pos += pkt_len - 1;
+      }
+      return packet;
+    }
+
     int ObMySQLCallback::process(easy_request_t* r)
     {
       int ret = EASY_OK;
@@ -218,6 +373,13 @@ namespace oceanbase
           c->auto_reconn = 0;
         }
         ObMySQLServer* server = reinterpret_cast<ObMySQLServer*>(c->handler->user_data);
+        ObMySQLConnectionInfo* info = ObMySQLConnectionInfo::get(c);
+        if (NULL != info && NULL != info->plain_buf_)
+        {
+          ob_free(info->plain_buf_);
+          info->plain_buf_ = NULL;
+          info->plain_buf_size_ = 0;
+        }
         ObSQLSessionInfo *expired_session = NULL;
         ret = server->get_session_mgr()->get(c->seq, expired_session);
         if (HASH_EXIST == ret)
@@ -24,6 +24,8 @@ namespace oceanbase
 {
   namespace obmysql
   {
+    class ObMySQLCommandPacket;
+    struct ObMySQLConnectionInfo;
     class ObMySQLCallback
     {
       public:
@@ -42,6 +44,32 @@ namespace oceanbase
         static uint64_t get_packet_id(easy_connection_t* c, void* packet);
 
         static int clean_up(easy_request_t *r, void *apacket);
+
+      private:
+        /**
+         * decode next command packet of the compressed stream, used after CLIENT_COMPRESS
+         * is negotiated. frames are decompressed into the stream buffer of the connection,
+         * the input is moved past a frame only after all complete packets in it are decoded
+         */
+        static ObMySQLCommandPacket* decode_compressed(easy_message_t* m, ObMySQLConnectionInfo* info);
+
+        /**
+         * decompress the frame at input pos and append it to the stream buffer
+         * @param is_complete [out] false if the frame is not fully received yet
+         */
+        static int decompress_frame(easy_message_t* m, ObMySQLConnectionInfo* info, bool& is_complete);
+
+        /**
+         * @return true if the stream buffer holds a complete packet, whose length is pkt_len
+         */
+        static bool has_plain_packet(const ObMySQLConnectionInfo* info, uint32_t& pkt_len);
+
+        /**
+         * copy command packet whose header is already decoded into pool
+         * @param pos [in/out] points to the command type, moved to end of the packet
+         */
+        static ObMySQLCommandPacket* new_command_packet(easy_pool_t* pool, const uint32_t pkt_len,
+                                                        const uint8_t pkt_seq, char*& pos);
     };
   }
 }
@@ -1,6 +1,7 @@
 #include "ob_mysql_command_queue_thread.h"
 #include "common/ob_atomic.h"
 #include "common/ob_profile_type.h"
+#include "common/ob_numa.h"
 #include "obmysql/ob_mysql_define.h"
 
 using namespace oceanbase::common;
@@ -16,6 +17,7 @@ namespace  oceanbase
       waiting_ = false;
       queue_.init();
       handler_ = NULL;
+      numa_aware_ = false;
     }
 
     ObMySQLCommandQueueThread::~ObMySQLCommandQueueThread()
@@ -34,6 +36,11 @@ namespace  oceanbase
       handler_ = handler;
       UNUSED(args);
     }
+    void ObMySQLCommandQueueThread::set_numa_aware(const bool numa_aware)
+    {
+      numa_aware_ = numa_aware;
+    }
+
     void ObMySQLCommandQueueThread::set_ip_port(const IpPort & ip_port)
     {
       ip_port_ = ip_port;
@@ -86,7 +93,10 @@ namespace  oceanbase
     void ObMySQLCommandQueueThread::run(tbsys::CThread* thread,void* args)
     {
       UNUSED(thread);
-      UNUSED(args);
+      if (numa_aware_)
+      {
+        ObNumaTopology::get_instance().bind_thread_round_robin(reinterpret_cast<int64_t>(args));
+      }
       ObServer *host = GET_TSI_MULT(ObServer, TSI_COMMON_OBSERVER_1);
       *host = host_;
       ObMySQLCommandPacket* packet = NULL;
@@ -47,6 +47,10 @@ namespace oceanbase
          */
         void run(tbsys::CThread* thread, void* arg);
         void set_self_to_thread_queue(const common::ObServer & host);
+        /**
+         * 工作线程按round robin绑定到numa node上 在start之前调用
+         */
+        void set_numa_aware(const bool numa_aware);
 
       private:
         ObMySQLCommandQueue queue_;
@@ -57,6 +61,7 @@ namespace oceanbase
         bool waiting_;
         common::IpPort ip_port_;
         common::ObServer host_;
+        bool numa_aware_;
     };
   }// end namespace obmysql
 }// end namespace oceanbase
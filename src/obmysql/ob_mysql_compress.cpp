@@ -0,0 +1,121 @@
+/*
+ * (C) 2007-2013 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $id
+ *
+ * ob_mysql_compress.cpp
+ *
+ */
+
+#include "ob_mysql_compress.h"
+#include <zlib.h>
+#include <string.h>
+#include "tblog.h"
+#include "ob_mysql_util.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obmysql;
+
+int64_t ObMySQLCompress::get_max_frame_size(const int64_t data_len)
+{
+  return COMPRESS_HEADER_SIZE + static_cast<int64_t>(compressBound(static_cast<uLong>(data_len)));
+}
+
+int ObMySQLCompress::encode_frame(const char *data, const int64_t data_len, const uint8_t seq,
+                                  char *buf, const int64_t buf_len, int64_t &pos)
+{
+  int ret = OB_SUCCESS;
+  if (NULL == data || 0 > data_len || MAX_PAYLOAD_LENGTH < data_len || NULL == buf || 0 > pos)
+  {
+    TBSYS_LOG(ERROR, "invalid argument data=%p data_len=%ld buf=%p pos=%ld",
+              data, data_len, buf, pos);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else if (buf_len - pos < COMPRESS_HEADER_SIZE + data_len)
+  {
+    ret = OB_SIZE_OVERFLOW;
+  }
+  else
+  {
+    int64_t header_pos = pos;
+    char *payload = buf + pos + COMPRESS_HEADER_SIZE;
+    uLongf payload_len = static_cast<uLongf>(buf_len - pos - COMPRESS_HEADER_SIZE);
+    int64_t origin_len = 0;
+    if (MIN_COMPRESS_LENGTH > data_len
+        || Z_OK != compress(reinterpret_cast<Bytef*>(payload), &payload_len,
+                            reinterpret_cast<const Bytef*>(data), static_cast<uLong>(data_len))
+        || static_cast<int64_t>(payload_len) >= data_len)
+    {
+      // not worth compressing, send as it is
+      memcpy(payload, data, data_len);
+      payload_len = static_cast<uLongf>(data_len);
+    }
+    else
+    {
+      origin_len = data_len;
+    }
+    ObMySQLUtil::store_int3(buf, buf_len, static_cast<int32_t>(payload_len), header_pos);
+    ObMySQLUtil::store_int1(buf, buf_len, seq, header_pos);
+    ObMySQLUtil::store_int3(buf, buf_len, static_cast<int32_t>(origin_len), header_pos);
+    pos = header_pos + static_cast<int64_t>(payload_len);
+  }
+  return ret;
+}
+
+void ObMySQLCompress::decode_header(const char *buf, uint32_t &payload_len, uint8_t &seq,
+                                    uint32_t &data_len)
+{
+  char *pos = const_cast<char*>(buf);
+  ObMySQLUtil::get_uint3(pos, payload_len);
+  ObMySQLUtil::get_uint1(pos, seq);
+  ObMySQLUtil::get_uint3(pos, data_len);
+}
+
+int ObMySQLCompress::decode_payload(const char *payload, const uint32_t payload_len,
+                                    const uint32_t data_len, char *buf, const int64_t buf_len,
+                                    int64_t &out_len)
+{
+  int ret = OB_SUCCESS;
+  if (NULL == payload || NULL == buf)
+  {
+    TBSYS_LOG(ERROR, "invalid argument payload=%p buf=%p", payload, buf);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else if (0 == data_len)
+  {
+    if (buf_len < payload_len)
+    {
+      ret = OB_SIZE_OVERFLOW;
+    }
+    else
+    {
+      memcpy(buf, payload, payload_len);
+      out_len = payload_len;
+    }
+  }
+  else if (buf_len < data_len)
+  {
+    ret = OB_SIZE_OVERFLOW;
+  }
+  else
+  {
+    uLongf len = static_cast<uLongf>(data_len);
+    int zret = uncompress(reinterpret_cast<Bytef*>(buf), &len,
+                          reinterpret_cast<const Bytef*>(payload), static_cast<uLong>(payload_len));
+    if (Z_OK != zret || data_len != len)
+    {
+      TBSYS_LOG(WARN, "uncompress mysql packet failed, zret=%d payload_len=%u data_len=%u real_len=%lu",
+                zret, payload_len, data_len, len);
+      ret = OB_INVALID_DATA;
+    }
+    else
+    {
+      out_len = data_len;
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,84 @@
+/*
+ * (C) 2007-2013 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $id
+ *
+ * ob_mysql_compress.h
+ *
+ */
+
+#ifndef _OB_MYSQL_COMPRESS_H_
+#define _OB_MYSQL_COMPRESS_H_
+
+#include <stdint.h>
+#include "common/ob_define.h"
+
+namespace oceanbase
+{
+  namespace obmysql
+  {
+    /**
+     * Compressed packet framing of MySQL protocol (CLIENT_COMPRESS).
+     *
+     * Once compression is negotiated, everything on the wire is wrapped in
+     * frames of
+     *   3   length of compressed payload
+     *   1   compressed sequence id
+     *   3   length of payload before compression, 0 if not compressed
+     *   n   zlib compressed payload, which is one or more plain MySQL packets
+     */
+    class ObMySQLCompress
+    {
+      public:
+        static const int64_t COMPRESS_HEADER_SIZE = 7;
+        /* payload shorter than this is sent without compression, same as mysqld */
+        static const int64_t MIN_COMPRESS_LENGTH = 50;
+        static const int64_t MAX_PAYLOAD_LENGTH = 0xFFFFFF;
+
+      public:
+        /**
+         * max buffer size needed by encode_frame for data_len bytes of payload
+         */
+        static int64_t get_max_frame_size(const int64_t data_len);
+
+        /**
+         * wrap data into one compressed frame
+         * @param data     plain MySQL packets
+         * @param data_len length of data, no more than MAX_PAYLOAD_LENGTH
+         * @param seq      compressed sequence id of this frame
+         * @param buf      output buffer
+         * @param buf_len  length of output buffer
+         * @param pos[in/out]
+         *
+         * @return OB_SUCCESS or OB_SIZE_OVERFLOW if buf is not large enough
+         */
+        static int encode_frame(const char *data, const int64_t data_len, const uint8_t seq,
+                                char *buf, const int64_t buf_len, int64_t &pos);
+
+        /**
+         * decode header of a compressed frame, buf must hold at least COMPRESS_HEADER_SIZE bytes
+         */
+        static void decode_header(const char *buf, uint32_t &payload_len, uint8_t &seq,
+                                  uint32_t &data_len);
+
+        /**
+         * restore the plain MySQL packets of a frame
+         * @param payload     payload of the frame
+         * @param payload_len payload length in header
+         * @param data_len    length before compression in header, 0 means not compressed
+         * @param buf         output buffer, should be at least max(payload_len, data_len) bytes
+         * @param buf_len     length of output buffer
+         * @param out_len[out] length of plain data
+         */
+        static int decode_payload(const char *payload, const uint32_t payload_len,
+                                  const uint32_t data_len, char *buf, const int64_t buf_len,
+                                  int64_t &out_len);
+    };
+  } // end of namespace obmysql
+} // end of namespace oceanbase
+
+#endif /* _OB_MYSQL_COMPRESS_H_ */
@@ -30,4 +30,27 @@ enum enum_server_command
                                  在连接断开的时候，需要删除session 但是此时有可能在回调函数disconnect中获取不到
                                 session的锁，此时会往obmysql的队列中添加一个异步任务*/
 };
+
+/* capability flags negotiated in handshake, only the ones checked by obmysql are listed */
+enum enum_client_capability
+{
+  CLIENT_COMPRESS = 0x00000020,
+  CLIENT_MULTI_STATEMENTS = 0x00010000,
+  CLIENT_MULTI_RESULTS = 0x00020000
+};
+
+/* status flags in OK/EOF packet */
+enum enum_server_status
+{
+  SERVER_STATUS_AUTOCOMMIT = 0x0002,
+  SERVER_MORE_RESULTS_EXISTS = 0x0008,
+  SERVER_QUERY_NO_INDEX_USED = 0x0020
+};
+
+/* option of COM_SET_OPTION */
+enum enum_mysql_set_option
+{
+  MYSQL_OPTION_MULTI_STATEMENTS_ON,
+  MYSQL_OPTION_MULTI_STATEMENTS_OFF
+};
 #endif
@@ -61,6 +61,10 @@ int ObMySQLLoginer::login(easy_connection_t* c, sql::ObSQLSessionInfo *& session
       {
         TBSYS_LOG(WARN, "parse client auth packet failed");
       }
+      else if (OB_SUCCESS != (ret = init_connection_info(c)))
+      {
+        TBSYS_LOG(WARN, "init connection info failed, ret=%d", ret);
+      }
       else
       {
         ret = check_privilege(c, session);
@@ -221,6 +225,33 @@ int ObMySQLLoginer::parse_packet(easy_connection_t* c)
   return ret;
 }
 
+int ObMySQLLoginer::init_connection_info(easy_connection_t* c)
+{
+  int ret = OB_SUCCESS;
+  ObMySQLConnectionInfo* info = reinterpret_cast<ObMySQLConnectionInfo*>(
+    easy_pool_alloc(c->pool, static_cast<uint32_t>(sizeof(ObMySQLConnectionInfo))));
+  if (NULL == info)
+  {
+    TBSYS_LOG(ERROR, "alloc connection info from c->pool failed");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    info->capability_flags_ = login_info_.capability_flags_ & ObMySQLHandshakePacket::SERVER_CAPABILITIES;
+    info->compress_seq_ = 0;
+    info->is_send_pending_ = false;
+    info->plain_buf_ = NULL;
+    info->plain_buf_size_ = 0;
+    info->plain_pos_ = 0;
+    info->plain_len_ = 0;
+    info->frame_len_ = 0;
+    c->user_data = info;
+    TBSYS_LOG(INFO, "client capability flags=0x%x, negotiated=0x%x, peer=%s",
+              login_info_.capability_flags_, info->capability_flags_, inet_ntoa_r(c->addr));
+  }
+  return ret;
+}
+
 int ObMySQLLoginer::insert_new_session(easy_connection_t* c, sql::ObSQLSessionInfo *&session)
 {
   int ret = OB_SUCCESS;
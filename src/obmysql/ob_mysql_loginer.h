@@ -24,12 +24,47 @@
 #include "common/ob_privilege_manager.h"
 #include "common/ob_string.h"
 #include "sql/ob_sql_session_info.h"
+#include "ob_mysql_define.h"
 
 namespace oceanbase
 {
   namespace obmysql
   {
     class ObMySQLServer;
+
+    /**
+     * protocol state of one client connection, hung on easy_connection_t::user_data
+     * it is allocated from the pool of the connection, so lives as long as the connection
+     */
+    struct ObMySQLConnectionInfo
+    {
+      uint32_t capability_flags_;   // capabilities supported by both client and server
+      uint8_t compress_seq_;        // next compressed sequence id to send, see ObMySQLCompress
+      bool is_send_pending_;        // a result set buffer is still being sent by IO thread
+      easy_client_wait_t send_wait_; // wait object of the pending send, see ObMySQLServer::flush_raw_packet
+      // decompressed stream of the compressed protocol, see ObMySQLCallback::decode_compressed
+      // a frame may carry several packets and a packet may span frames, so the data
+      // not yet decoded into packets is kept across frames. freed when disconnected
+      char *plain_buf_;
+      int64_t plain_buf_size_;
+      int64_t plain_pos_;           // start of the first packet not yet decoded
+      int64_t plain_len_;
+      int64_t frame_len_;           // length of the frame at input pos already decompressed, 0 if none
+
+      inline bool is_compress() const
+      {
+        return 0 != (capability_flags_ & CLIENT_COMPRESS);
+      }
+      inline bool is_multi_statements() const
+      {
+        return 0 != (capability_flags_ & CLIENT_MULTI_STATEMENTS);
+      }
+      static inline ObMySQLConnectionInfo* get(easy_connection_t *c)
+      {
+        return NULL == c ? NULL : reinterpret_cast<ObMySQLConnectionInfo*>(c->user_data);
+      }
+    };
+
     class ObMySQLLoginer
     {
       public:
@@ -77,6 +112,13 @@ namespace oceanbase
          */
         int parse_packet(easy_connection_t* c);
 
+        /**
+         * remember capabilities negotiated with client in c->user_data
+         * @param c   connection authorized
+         *
+         */
+        int init_connection_info(easy_connection_t* c);
+
         /**
          * send ok packet to client
          * @param c
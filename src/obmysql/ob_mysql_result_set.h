@@ -34,7 +34,7 @@ namespace oceanbase {
          * @param [in] obrs SQL执行起返回的数据集
          */
         ObMySQLResultSet()
-          : field_index_(0), param_index_(0) {};
+          : field_index_(0), param_index_(0), has_more_result_(false) {};
         /**
          * 析构函数
          */
@@ -81,14 +81,31 @@ namespace oceanbase {
          * @return 成功返回OB_SUCCESS。如果没有数据，则返回Ob_ITER_END
          */
         int next_row(ObMySQLRow &obmr);
+
+        /**
+         * 多语句查询中后面还有语句的结果需要发送，OK/EOF包中需要设置SERVER_MORE_RESULTS_EXISTS
+         */
+        void set_has_more_result(bool has_more_result);
+        bool has_more_result() const;
         int64_t to_string(char* buf, const int64_t buf_len) const;
       private:
         int get_next_row(const ObRow *&row);
       private:
         int64_t field_index_;     /**< 下一个需要读取的字段的序号 */
         int64_t param_index_;     /* < 下一个需要读取的参数的序号*/
+        bool has_more_result_;    /**< 后面是否还有其他语句的结果 */
     }; // end class ObMySQLResultSet
 
+    inline void ObMySQLResultSet::set_has_more_result(bool has_more_result)
+    {
+      has_more_result_ = has_more_result;
+    }
+
+    inline bool ObMySQLResultSet::has_more_result() const
+    {
+      return has_more_result_;
+    }
+
     inline int64_t ObMySQLResultSet::to_string(char* buf, const int64_t buf_len) const
     {
       return ObResultSet::to_string(buf, buf_len);
@@ -123,7 +123,8 @@ namespace oceanbase {
         if (TEXT == type_)
         {
           /* skip 1 byte to store length */
-          length = snprintf(buf + pos + 1, len - pos - 1, "%d", bool_val ? 1 : 0);
+          buf[pos + 1] = bool_val ? '1' : '0';
+          length = 1;
           ObMySQLUtil::store_length(buf, len, length, pos);
           pos += length;
         }
@@ -153,7 +154,7 @@ namespace oceanbase {
         if (TEXT == type_)
         {
           /* skip 1 byte to store length */
-          length = snprintf(buf + pos + 1, len - pos - 1, "%ld", int_val);
+          length = ObMySQLUtil::int_to_text(int_val, buf + pos + 1);
           ObMySQLUtil::store_length(buf, len, length, pos);
           pos += length;
         }
@@ -211,7 +212,6 @@ namespace oceanbase {
       int ret = OB_SUCCESS;
       int32_t microsecond = 0;
       uint64_t length = 0;
-      size_t r = 0;
       uint8_t timelen = 0;
       ret = obj.get_timestamp(datetime);
       // that's precise datetime which has millisecond.
@@ -219,8 +219,14 @@ namespace oceanbase {
       {
         microsecond = static_cast<int32_t>(datetime % 1000000);
         time = datetime / 1000000;
+        if (microsecond < 0)
+        {
+          // before 1970, keep the fraction positive
+          microsecond += 1000000;
+          time -= 1;
+        }
 
-        localtime_r(&time, &tms);
+        ObMySQLUtil::get_local_time(time, tms);
         if (type_ == BINARY)
         {
           if (0 == tms.tm_year && 0 == tms.tm_mon
@@ -267,49 +273,16 @@ namespace oceanbase {
         else
         {
           /* skip 1 byte to store length */
-          if (len - pos <= 1 || 0 == (r = strftime(buf + pos + 1, len - pos - 1, "%F %T", &tms)))
+          if (len - pos <= ObMySQLUtil::MAX_DATETIME_TEXT_LENGTH)
           {
             ret = OB_SIZE_OVERFLOW;
           }
           else
           {
-            length = r;
-            if (0 != microsecond)
-            {
-              /* skip 1 byte to store length */
-              if (len - pos - length <= 1)
-              {
-                ret = OB_SIZE_OVERFLOW;
-              }
-              else
-              {
-                r = snprintf(buf + pos + length + 1, len - pos - length - 1, ".%d", microsecond);
-                if (r >= len - pos - length - 1)
-                {
-                  ret = OB_SIZE_OVERFLOW;
-                }
-                else if (0 == r)
-                {
-                  ret = OB_ERROR;
-                  TBSYS_LOG(ERROR, "snprintf microsecond(%d) to buffer failed", microsecond);
-                }
-              }
-              if (OB_SUCCESS == ret)
-              {
-                length += r;
-              }
-            }
-          }
-
-          if (OB_SUCCESS == ret && static_cast<int64_t>(length + 1) <= len - pos)
-          {
+            length = ObMySQLUtil::datetime_to_text(tms, microsecond, buf + pos + 1);
             ObMySQLUtil::store_length(buf, len, length, pos);
             pos += length;
           }
-          else                    /* not enough space to hold the string */
-          {
-            ret = OB_SIZE_OVERFLOW;
-          }
         }
       }
       return ret;
@@ -7,6 +7,8 @@
 #include "common/ob_array.h"
 #include "common/ob_string.h"
 #include "common/ob_trace_log.h"
+#include "common/ob_trace_id.h"
+#include "common/ob_query_profile.h"
 #include "ob_mysql_util.h"
 #include "packet/ob_mysql_resheader_packet.h"
 #include "packet/ob_mysql_eof_packet.h"
@@ -22,6 +24,7 @@
 #include "common/ob_row.h"
 #include "common/location/ob_tablet_location_cache_proxy.h"
 #include "common/ob_obj_cast.h"
+#include "ob_mysql_compress.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::common::hash;
@@ -148,6 +151,7 @@ namespace oceanbase
           command_queue_thread_.set_self_to_thread_queue(self_);
           command_queue_thread_.set_ip_port(ip_port);
           command_queue_thread_.setThreadParameter(work_thread_count_, this, NULL);
+          command_queue_thread_.set_numa_aware(config_->numa_aware);
           TBSYS_LOG(INFO, "obmysql work thread count=%d", work_thread_count_);
           command_queue_thread_.start();
         }
@@ -915,6 +919,9 @@ namespace oceanbase
           case COM_PING:
             ret = do_com_ping(packet);
             break;
+          case COM_SET_OPTION:
+            ret = do_com_set_option(packet);
+            break;
           case COM_DELETE_SESSION:
             ret = do_com_delete_session(packet);
             break;
@@ -1045,18 +1052,61 @@ namespace oceanbase
     }
 
     int ObMySQLServer::do_com_query(ObMySQLCommandPacket* packet)
+    {
+      int ret = OB_SUCCESS;
+      ret = check_param(packet);
+      if (OB_SUCCESS == ret)
+      {
+        const common::ObString& q = packet->get_command();
+        ObMySQLConnectionInfo* info = ObMySQLConnectionInfo::get(packet->get_request()->ms->c);
+        ObString stmt;
+        ObString next_stmt;
+        int64_t pos = 0;
+        bool is_multi_stmt = false;
+        number = packet->get_packet_header().seq_;
+        if (NULL != info && info->is_multi_statements()
+            && ObMySQLUtil::get_next_statement(q, pos, stmt))
+        {
+          is_multi_stmt = ObMySQLUtil::get_next_statement(q, pos, next_stmt);
+        }
+        if (!is_multi_stmt)
+        {
+          ret = do_single_query(packet, q, false);
+        }
+        else
+        {
+          //statements are executed one by one, results are sent with SERVER_MORE_RESULTS_EXISTS
+          //until the last one, and the first failed statement terminates the whole query
+          OB_STAT_INC(OBMYSQL, SQL_MULTI_STMT_COUNT);
+          bool is_last = false;
+          while (OB_SUCCESS == ret && !is_last)
+          {
+            ret = do_single_query(packet, stmt, true);
+            stmt = next_stmt;
+            is_last = !ObMySQLUtil::get_next_statement(q, pos, next_stmt);
+          }
+          if (OB_SUCCESS == ret)
+          {
+            ret = do_single_query(packet, stmt, false);
+          }
+        }
+      }
+      return ret;
+    }
+
+    int ObMySQLServer::do_single_query(ObMySQLCommandPacket* packet, const ObString& q, const bool has_more_result)
     {
       int ret = OB_SUCCESS;
       int err = OB_SUCCESS;
       int64_t start_time = tbsys::CTimeUtil::getTime();
       ObBasicStmt::StmtType inner_stmt_type = ObBasicStmt::T_NONE;
+      ObQueryProfile *profile = start_query_profile(q, start_time);
       ret = check_param(packet);
       if (OB_SUCCESS == ret)
       {
         ObSqlContext context;
         ObMySQLResultSet result;
         easy_addr_t addr = get_easy_addr(packet->get_request());
-        const common::ObString& q = packet->get_command();
         int32_t truncated_length = std::min(q.length(), 384);
         FILL_TRACE_LOG("stmt=\"%.*s\"", truncated_length, q.ptr());
         TBSYS_LOG(INFO, "start query: \"%.*s\" real_query_len=%d, peer=%s",
@@ -1069,7 +1119,7 @@ namespace oceanbase
         else
         {
           int64_t schema_version = 0;
-          number = packet->get_packet_header().seq_;
+          result.set_has_more_result(has_more_result);
           ret = init_sql_env(*packet, context, schema_version, result);
           if (OB_SUCCESS != ret)
           {
@@ -1083,7 +1133,8 @@ namespace oceanbase
           else
           {
             // do it
-            ret = ObSql::direct_execute(q, result, context);
+            ret = ObSql::direct_execute_with_plan_cache(q, result, context,
+                                                        config_->max_cached_plans_per_session);
             FILL_TRACE_LOG("direct_execute");
             // process result
             if (OB_SUCCESS != ret)
@@ -1128,6 +1179,7 @@ namespace oceanbase
         TBSYS_LOG(DEBUG, "end query");
       }
 
+      finish_query_profile(profile);
       do_stat(inner_stmt_type, tbsys::CTimeUtil::getTime() - start_time);
       if (OB_SUCCESS == ret)
       {
@@ -1140,6 +1192,34 @@ namespace oceanbase
       return ret;
     }
 
+    ObQueryProfile* ObMySQLServer::start_query_profile(const ObString& q, const int64_t start_time)
+    {
+      ObQueryProfile *profile = NULL;
+      TraceId *trace_id = NULL;
+      if (config_->enable_query_profile
+          && NULL != (profile = GET_TSI_MULT(ObQueryProfile, TSI_MYSQL_QUERY_PROFILE_1)))
+      {
+        trace_id = GET_TSI_MULT(TraceId, TSI_COMMON_PACKET_TRACE_ID_1);
+        profile->start(NULL == trace_id ? 0 : trace_id->uval_, q, start_time);
+        ObQueryProfile::set_current(profile);
+      }
+      return profile;
+    }
+
+    void ObMySQLServer::finish_query_profile(ObQueryProfile* profile)
+    {
+      if (NULL != profile)
+      {
+        ObQueryProfile::set_current(NULL);
+        profile->finish(tbsys::CTimeUtil::getTime());
+        if (profile->get_elapsed_time() > config_->slow_query_threshold)
+        {
+          ObSlowQueryLog::get_instance().add(*profile);
+          TBSYS_LOG(INFO, "slow query: %s", to_cstring(*profile));
+        }
+      }
+    }
+
     int ObMySQLServer::do_com_prepare(ObMySQLCommandPacket* packet)
     {
       int ret = OB_SUCCESS;
@@ -1442,6 +1522,62 @@ namespace oceanbase
       return ret;
     }
 
+    int ObMySQLServer::do_com_set_option(ObMySQLCommandPacket* packet)
+    {
+      int ret = OB_SUCCESS;
+      ret = check_param(packet);
+      if (OB_SUCCESS == ret)
+      {
+        easy_request_t* req = packet->get_request();
+        easy_addr_t addr = get_easy_addr(req);
+        ObMySQLConnectionInfo* info = ObMySQLConnectionInfo::get(req->ms->c);
+        uint16_t option = 0;
+        char* pos = packet->get_command().ptr();
+        number = packet->get_packet_header().seq_;
+        if (NULL == info || static_cast<int32_t>(sizeof(option)) > packet->get_command_length())
+        {
+          TBSYS_LOG(WARN, "invalid COM_SET_OPTION packet, info=%p length=%d, peer=%s",
+                    info, packet->get_command_length(), inet_ntoa_r(addr));
+          ret = do_unsupport(packet);
+        }
+        else
+        {
+          ObMySQLUtil::get_uint2(pos, option);
+          if (MYSQL_OPTION_MULTI_STATEMENTS_ON != option && MYSQL_OPTION_MULTI_STATEMENTS_OFF != option)
+          {
+            TBSYS_LOG(WARN, "unknown option %u of COM_SET_OPTION, peer=%s", option, inet_ntoa_r(addr));
+            ret = do_unsupport(packet);
+          }
+          else
+          {
+            if (MYSQL_OPTION_MULTI_STATEMENTS_ON == option)
+            {
+              info->capability_flags_ |= CLIENT_MULTI_STATEMENTS;
+            }
+            else
+            {
+              info->capability_flags_ &= ~static_cast<uint32_t>(CLIENT_MULTI_STATEMENTS);
+            }
+            //server replies COM_SET_OPTION with an EOF packet
+            ObMySQLEofPacket eof;
+            ++number;
+            req->retcode = EASY_OK;
+            if (OB_SUCCESS != (ret = post_packet(req, &eof, number)))
+            {
+              TBSYS_LOG(ERROR, "failed to send eof packet to mysql client(%s) ret is %d",
+                        inet_ntoa_r(addr), ret);
+            }
+            else
+            {
+              TBSYS_LOG(DEBUG, "set option %u, capability flags=0x%x, peer=%s",
+                        option, info->capability_flags_, inet_ntoa_r(addr));
+            }
+          }
+        }
+      }
+      return ret;
+    }
+
     int ObMySQLServer::post_packet(easy_request_t* req, ObMySQLPacket* packet, uint8_t seq)
     {
       int ret = OB_SUCCESS;
@@ -1451,6 +1587,10 @@ namespace oceanbase
                   req, packet);
         ret = OB_INVALID_ARGUMENT;
       }
+      else if (OB_SUCCESS != (ret = wait_raw_packet(req)))
+      {
+        TBSYS_LOG(WARN, "wait previous raw packet failed ret is %d", ret);
+      }
       else
       {
         ObDataBuffer buffer;
@@ -1486,6 +1626,10 @@ namespace oceanbase
             //设置output packet
             req->opacket = reinterpret_cast<void*>(buf);
             //hex_dump(buf->pos,  static_cast<int32_t>(buf->last - buf->pos), true, TBSYS_LOG_LEVEL_INFO);
+            if (OB_SUCCESS != (ret = compress_output(req, false)))
+            {
+              TBSYS_LOG(ERROR, "compress packet failed ret is %d", ret);
+            }
           }
         }
         else
@@ -1527,7 +1671,7 @@ namespace oceanbase
       {
         easy_request_t* req = packet->get_request();
         easy_addr_t addr = get_easy_addr(req);
-        number = packet->get_packet_header().seq_;
+        //number is set by caller, results of a multi-statement query share one sequence
         if (OB_SUCCESS != (ret = result->open()))
         {
           ObString err_msg = ob_get_err_msg();
@@ -1570,6 +1714,16 @@ namespace oceanbase
             {
               TBSYS_LOG(ERROR, "send ok packet to client(%s) failed ret is %d",
                         inet_ntoa_r(addr), ret);
+              //request is still waiting for the rest results, terminate it,
+              //post_packet wakes up the request even if the error packet fails
+              if (result->has_more_result() && OB_CONNECT_ERROR != ret)
+              {
+                result->set_errcode(ret);
+                if (OB_SUCCESS != (err = send_error_packet(packet, result)))
+                {
+                  TBSYS_LOG(WARN, "fail to send error packet. err=%d", err);
+                }
+              }
             }
             FILL_TRACE_LOG("client_res=ok");
           }
@@ -1580,6 +1734,15 @@ namespace oceanbase
             if (OB_SUCCESS == ret)
             {
               ret = ret2;
+              //request is still waiting for the rest results, terminate it
+              if (result->has_more_result())
+              {
+                result->set_errcode(ret);
+                if (OB_SUCCESS != (err = send_error_packet(packet, result)))
+                {
+                  TBSYS_LOG(WARN, "fail to send error packet. err=%d", err);
+                }
+              }
             }
           }
           FILL_TRACE_LOG("close, query_result=(%s)", to_cstring(*result));
@@ -1791,14 +1954,22 @@ namespace oceanbase
         ok.set_affected_rows(result->get_affected_rows());
         ok.set_warning_count(static_cast<uint16_t>(result->get_warning_count()));
         //TODO get server status from resultset
-        ok.set_server_status(0x22);
+        ok.set_server_status(get_server_status(result, SERVER_STATUS_AUTOCOMMIT | SERVER_QUERY_NO_INDEX_USED));
         ObString message(ObString(static_cast<int32_t>(strlen(result->get_message())),
                                   static_cast<int32_t>(strlen(result->get_message())),
                                   const_cast<char*>(result->get_message())));
         ok.set_message(message);
-        number++;
-        req->retcode = EASY_OK;
-        ret = post_packet(req, &ok, number);
+        if (result->has_more_result())
+        {
+          //keep the request alive for results of following statements
+          ret = send_packet(req, &ok);
+        }
+        else
+        {
+          number++;
+          req->retcode = EASY_OK;
+          ret = post_packet(req, &ok, number);
+        }
         if (OB_SUCCESS != ret)
         {
           TBSYS_LOG(ERROR, "post ok packet to client(%s) failed ret is %d",
@@ -2166,7 +2337,7 @@ namespace oceanbase
       {
         //基于结果集都是很小的假设每次都在message申请6k内存，尽可能的把所有的数据包都放到这个内存里面去
         //如果能够放下那么直接调用异步发送接口 工作线程不用等待IO线程发包
-        //如果发现6k不能放下所有结果，先发送序列化好的包，等待IO线程发送完毕以便复用这个6k的内存
+        //如果发现6k不能放下所有结果，行数据改为流式发送，见process_stream_packet
         easy_addr_t addr = get_easy_addr(req);
         easy_buf_t* buf = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, OB_MYSQL_PACKET_BUFF_SIZE));
         if (NULL != buf)
@@ -2199,12 +2370,29 @@ namespace oceanbase
             TBSYS_LOG(DEBUG, "send result set to client %s", inet_ntoa_r(addr));
             buf->last = buf->pos + buffer_pos;
             req->opacket = reinterpret_cast<void*>(buf);
-            ret = post_raw_packet(req);
+            if (result->has_more_result())
+            {
+              //keep the request alive for results of following statements
+              ret = send_raw_packet(req);
+            }
+            else
+            {
+              ret = post_raw_packet(req);
+            }
             if (OB_SUCCESS != ret)
             {
               TBSYS_LOG(ERROR, "post packet to client(%s) failed ret is %d", inet_ntoa_r(addr), ret);
             }
           }
+          else
+          {
+            //rows may still be in flight, the request can not be touched before they are sent
+            int wret = wait_raw_packet(req);
+            if (OB_SUCCESS != wret)
+            {
+              TBSYS_LOG(WARN, "wait raw packet(dest is %s) failed ret is %d", inet_ntoa_r(addr), wret);
+            }
+          }
         }
         else
         {
@@ -2430,6 +2618,7 @@ namespace oceanbase
         easy_addr_t addr = get_easy_addr(req);
         ObMySQLEofPacket eof;
         eof.set_warning_count(static_cast<uint16_t>(result->get_warning_count()));
+        eof.set_server_status(get_server_status(result, 0));
         eof.set_seq(static_cast<uint8_t>(number+1));
         ret = process_single_packet(buff, buff_pos, req, &eof);
         if (OB_SUCCESS != ret)
@@ -2455,6 +2644,7 @@ namespace oceanbase
         easy_addr_t addr = get_easy_addr(req);
         ObMySQLRow row;
         int64_t row_num = 0;
+        easy_buf_t *spare = NULL;
         while (OB_SUCCESS == ret
                && OB_SUCCESS == (ret = result->next_row(row)))
         {
@@ -2462,7 +2652,7 @@ namespace oceanbase
           row.set_protocol_type(type);
           ObMySQLRowPacket rpacket(&row);
           rpacket.set_seq(static_cast<uint8_t>(number+1));
-          ret = process_single_packet(buff, buff_pos, req, &rpacket);
+          ret = process_stream_packet(buff, spare, buff_pos, req, &rpacket);
           if (OB_SUCCESS != ret)
           {
             TBSYS_LOG(ERROR, "process row packet failed, dest is %s ret is %d",
@@ -2592,22 +2782,166 @@ namespace oceanbase
       return ret;
     }
 
-    int ObMySQLServer::send_raw_packet(easy_request_t *req)
+    int ObMySQLServer::process_stream_packet(easy_buf_t *&buff, easy_buf_t *&spare, int64_t &buff_pos,
+                                             easy_request_t *req, ObMySQLPacket *packet)
     {
       int ret = OB_SUCCESS;
+      if (NULL == buff || NULL == req || NULL == packet)
+      {
+        TBSYS_LOG(ERROR, "invalid argument buff is %p, req is %p, packet is %p", buff, req, packet);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        ret = packet->encode(buff->pos, buff->end - buff->pos, buff_pos);
+        if (OB_SUCCESS == ret)
+        {
+          number++; //increase number when packet serialize into buffer
+        }
+        else if (OB_BUF_NOT_ENOUGH != ret && OB_ARRAY_OUT_OF_RANGE != ret && OB_SIZE_OVERFLOW != ret)
+        {
+          TBSYS_LOG(ERROR, "serialize packet(%p) failed ret is %d", packet, ret);
+        }
+        else if (0 == buff_pos)
+        {
+          //packet is larger than the whole buffer, let process_single_packet alloc a 2M one
+          ret = process_single_packet(buff, buff_pos, req, packet);
+        }
+        else
+        {
+          if (NULL == spare)
+          {
+            spare = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, STREAM_BUFF_SIZE));
+            if (NULL != spare)
+            {
+              init_easy_buf(spare, reinterpret_cast<char *>(spare + 1), req, STREAM_BUFF_SIZE - sizeof(easy_buf_t));
+            }
+          }
+          if (NULL == spare)
+          {
+            TBSYS_LOG(WARN, "alloc stream buffer failed, send result set synchronously");
+            ret = process_single_packet(buff, buff_pos, req, packet);
+          }
+          else
+          {
+            easy_buf_t *sent = buff;
+            buff->last = buff->pos + buff_pos;
+            req->opacket = reinterpret_cast<void*>(buff);
+            if (OB_SUCCESS != (ret = flush_raw_packet(req)))
+            {
+              TBSYS_LOG(WARN, "flush raw packet failed ret is %d", ret);
+            }
+            else
+            {
+              buff = spare;
+              init_easy_buf(buff, reinterpret_cast<char *>(buff + 1), req, buff->end - reinterpret_cast<char *>(buff + 1));
+              buff_pos = 0;
+              //the buffer just flushed is refilled after the next flush waits for it,
+              //the first 6k one is too small to be worth it
+              if (sent->end - reinterpret_cast<char *>(sent + 1)
+                  >= static_cast<int64_t>(STREAM_BUFF_SIZE - sizeof(easy_buf_t)))
+              {
+                spare = sent;
+              }
+              else
+              {
+                spare = NULL;
+              }
+              ret = process_single_packet(buff, buff_pos, req, packet);
+            }
+          }
+        }
+      }
+      return ret;
+    }
+
+    int ObMySQLServer::flush_raw_packet(easy_request_t *req)
+    {
+      int ret = OB_SUCCESS;
+      ObMySQLConnectionInfo* info = NULL;
       if (NULL == req)
       {
         TBSYS_LOG(ERROR, "invalid argument req is %p", req);
         ret = OB_INVALID_ARGUMENT;
       }
+      else if (NULL == (info = ObMySQLConnectionInfo::get(req->ms->c)))
+      {
+        ret = send_raw_packet(req);
+      }
+      else if (OB_SUCCESS != (ret = wait_raw_packet(req)))
+      {
+        TBSYS_LOG(WARN, "wait previous raw packet failed ret is %d", ret);
+      }
       else
       {
+        easy_buf_t *buf = static_cast<easy_buf_t*>(req->opacket);
+        if (NULL != buf)
+        {
+          OB_STAT_INC(OBMYSQL, SQL_QUERY_BYTES, buf->last - buf->pos);
+        }
+        //the frame is not reused before wait_raw_packet, so it can be built in thread buffer
+        if (OB_SUCCESS != (ret = compress_output(req, true)))
+        {
+          TBSYS_LOG(ERROR, "compress packet failed ret is %d", ret);
+        }
+        info->send_wait_.done_count = 0;
+        easy_client_wait_init(&info->send_wait_);
+        req->client_wait = &info->send_wait_;
+        req->retcode = EASY_AGAIN;
+        info->is_send_pending_ = true;
+        easy_request_wakeup(req);
+      }
+      return ret;
+    }
+
+    int ObMySQLServer::wait_raw_packet(easy_request_t *req)
+    {
+      int ret = OB_SUCCESS;
+      ObMySQLConnectionInfo* info = NULL;
+      if (NULL == req)
+      {
+        TBSYS_LOG(ERROR, "invalid argument req is %p", req);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (NULL != (info = ObMySQLConnectionInfo::get(req->ms->c)) && info->is_send_pending_)
+      {
+        wait_client_obj(info->send_wait_);
+        if (EASY_CONN_CLOSE == info->send_wait_.status)
+        {
+          TBSYS_LOG(WARN, "send error happen, quit current query");
+          ret = OB_CONNECT_ERROR;
+        }
+        easy_client_wait_cleanup(&info->send_wait_);
+        req->client_wait = NULL;
+        info->is_send_pending_ = false;
+      }
+      return ret;
+    }
 
+    int ObMySQLServer::send_raw_packet(easy_request_t *req)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL == req)
+      {
+        TBSYS_LOG(ERROR, "invalid argument req is %p", req);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (OB_SUCCESS != (ret = wait_raw_packet(req)))
+      {
+        TBSYS_LOG(WARN, "wait previous raw packet failed ret is %d", ret);
+      }
+      else
+      {
         easy_buf_t *buf = static_cast<easy_buf_t*>(req->opacket);
         if (NULL != buf)
         {
           OB_STAT_INC(OBMYSQL, SQL_QUERY_BYTES, buf->last - buf->pos);
         }
+        //we wait here until the packet is sent, so the frame can be built in thread buffer
+        if (OB_SUCCESS != (ret = compress_output(req, true)))
+        {
+          TBSYS_LOG(ERROR, "compress packet failed ret is %d", ret);
+        }
         easy_client_wait_t wait_obj;
         wait_obj.done_count = 0;
         easy_client_wait_init(&wait_obj);
@@ -2637,6 +2971,10 @@ namespace oceanbase
         TBSYS_LOG(ERROR, "invalid argument req is %p", req);
         ret = OB_INVALID_ARGUMENT;
       }
+      else if (OB_SUCCESS != (ret = wait_raw_packet(req)))
+      {
+        TBSYS_LOG(WARN, "wait previous raw packet failed ret is %d", ret);
+      }
       else
       {
         easy_buf_t *buf = static_cast<easy_buf_t*>(req->opacket);
@@ -2644,6 +2982,10 @@ namespace oceanbase
         {
           OB_STAT_INC(OBMYSQL, SQL_QUERY_BYTES, buf->last - buf->pos);
         }
+        if (OB_SUCCESS != (ret = compress_output(req, false)))
+        {
+          TBSYS_LOG(ERROR, "compress packet failed ret is %d", ret);
+        }
         req->retcode = EASY_OK;
         //io线程被唤醒，r->opacket被挂过去,send_response->easy_connection_request_done
         easy_request_wakeup(req);
@@ -2651,6 +2993,91 @@ namespace oceanbase
       return ret;
     }
 
+    int ObMySQLServer::send_packet(easy_request_t *req, ObMySQLPacket *packet)
+    {
+      int ret = OB_SUCCESS;
+      int64_t buffer_pos = 0;
+      easy_buf_t* buf = NULL;
+      if (NULL == req || NULL == packet)
+      {
+        TBSYS_LOG(ERROR, "invalid argument req is %p, packet is %p", req, packet);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (NULL == (buf = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, OB_MYSQL_PACKET_BUFF_SIZE))))
+      {
+        TBSYS_LOG(ERROR, "alloc buffer from req->ms->pool failed");
+        ret = OB_ERROR;
+      }
+      else
+      {
+        init_easy_buf(buf, reinterpret_cast<char *>(buf + 1), req, OB_MYSQL_PACKET_BUFF_SIZE - sizeof(easy_buf_t));
+        packet->set_seq(static_cast<uint8_t>(number+1));
+        if (OB_SUCCESS != (ret = process_single_packet(buf, buffer_pos, req, packet)))
+        {
+          TBSYS_LOG(ERROR, "process packet failed ret is %d", ret);
+        }
+        else
+        {
+          buf->last = buf->pos + buffer_pos;
+          req->opacket = reinterpret_cast<void*>(buf);
+          ret = send_raw_packet(req);
+        }
+      }
+      return ret;
+    }
+
+    int ObMySQLServer::compress_output(easy_request_t *req, const bool is_sync)
+    {
+      int ret = OB_SUCCESS;
+      ObMySQLConnectionInfo* info = ObMySQLConnectionInfo::get(req->ms->c);
+      easy_buf_t* buf = static_cast<easy_buf_t*>(req->opacket);
+      if (NULL != info && info->is_compress() && NULL != buf)
+      {
+        int64_t data_len = buf->last - buf->pos;
+        int64_t size = static_cast<int64_t>(sizeof(easy_buf_t)) + ObMySQLCompress::get_max_frame_size(data_len);
+        int64_t pos = 0;
+        easy_buf_t* frame = NULL;
+        common::ThreadSpecificBuffer::Buffer* thread_buffer = NULL;
+        if (is_sync && NULL != (thread_buffer = get_buffer()))
+        {
+          thread_buffer->reset();
+          if (size <= thread_buffer->remain())
+          {
+            frame = reinterpret_cast<easy_buf_t*>(thread_buffer->current());
+          }
+        }
+        if (NULL == frame)
+        {
+          frame = reinterpret_cast<easy_buf_t*>(easy_pool_alloc(req->ms->pool, static_cast<uint32_t>(size)));
+        }
+        if (NULL == frame)
+        {
+          TBSYS_LOG(ERROR, "alloc compress buffer(length=%ld) failed", size);
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+        }
+        else
+        {
+          char* data = reinterpret_cast<char*>(frame + 1);
+          init_easy_buf(frame, data, req, size - sizeof(easy_buf_t));
+          if (OB_SUCCESS != (ret = ObMySQLCompress::encode_frame(buf->pos, data_len, info->compress_seq_,
+                                                                 data, size - sizeof(easy_buf_t), pos)))
+          {
+            TBSYS_LOG(ERROR, "encode compressed frame failed, data_len=%ld ret=%d", data_len, ret);
+          }
+          else
+          {
+            OB_STAT_INC(OBMYSQL, SQL_COMPRESSED_BYTES, pos);
+            ++info->compress_seq_;
+            frame->last = data + pos;
+            //the plain data is consumed, same as libeasy does after sending it
+            buf->pos = buf->last;
+            req->opacket = reinterpret_cast<void*>(frame);
+          }
+        }
+      }
+      return ret;
+    }
+
     int ObMySQLServer::do_stat(ObBasicStmt::StmtType stmt_type, int64_t consumed_time)
     {
       switch(stmt_type)
@@ -41,6 +41,7 @@ namespace oceanbase
   {
     class ObMergerSchemaManager;
     class ObTabletLocationCacheProxy;
+    class ObQueryProfile;
   } // end namespace common
   namespace mergeserver
   {
@@ -151,6 +152,14 @@ namespace oceanbase
         /** perf stat */
         inline int do_stat(ObBasicStmt::StmtType stmt_type, int64_t consumed_time);
 
+        /**
+         * start profiling the query executed by this thread if
+         * enable_query_profile is set, return NULL if it is not profiled
+         */
+        common::ObQueryProfile* start_query_profile(const common::ObString& q, const int64_t start_time);
+        /** keep the profile in the slow query log if the query is slow */
+        void finish_query_profile(common::ObQueryProfile* profile);
+
         int set_port(const int32_t port);
         int set_task_queue_size(const int32_t task_queue_size);
 
@@ -169,8 +178,21 @@ namespace oceanbase
         common::ThreadSpecificBuffer::Buffer* get_buffer() const;
 
         //handle request
+        /**
+         * handle COM_QUERY, if CLIENT_MULTI_STATEMENTS is set and the query
+         * has several ';' separated statements, execute them one by one
+         */
         int do_com_query(ObMySQLCommandPacket* packet);
 
+        /**
+         * execute one statement of COM_QUERY and send its result
+         * @param packet            request packet
+         * @param q                 statement to execute
+         * @param has_more_result   there are statements following, the request
+         *                          should be kept for their results
+         */
+        int do_single_query(ObMySQLCommandPacket* packet, const common::ObString& q, const bool has_more_result);
+
         int do_com_quit(ObMySQLCommandPacket* packet);
 
         int do_com_prepare(ObMySQLCommandPacket* packet);
@@ -183,6 +205,11 @@ namespace oceanbase
 
         int do_com_ping(ObMySQLCommandPacket* packet);
 
+        /**
+         * COM_SET_OPTION, turn CLIENT_MULTI_STATEMENTS on or off for this connection
+         */
+        int do_com_set_option(ObMySQLCommandPacket* packet);
+
         int do_com_delete_session(ObMySQLCommandPacket* packet);
 
         //TODO just skip request to be deleted
@@ -423,8 +450,57 @@ namespace oceanbase
          * @param packet             待发送的数据包
          */
         int process_single_packet(easy_buf_t *&buff, int64_t &buff_pos, easy_request_t *req, ObMySQLPacket *packet);
+
+        /**
+         * 流式发送结果集中的行
+         * buff满了以后交给IO线程异步发送，同时换到spare继续序列化，两个buffer轮流使用
+         * 上一个buffer还没发送完时工作线程等待，结果集占用的内存不超过两个STREAM_BUFF_SIZE
+         * @param buff               buff pointer, swapped with spare after flush
+         * @param spare              buffer to use after buff is flushed, NULL if not allocated yet
+         * @param req                req pointer
+         * @param packet             待发送的数据包
+         */
+        int process_stream_packet(easy_buf_t *&buff, easy_buf_t *&spare, int64_t &buff_pos,
+                                  easy_request_t *req, ObMySQLPacket *packet);
+
+        /**
+         * 异步发送req->opacket，不等待IO线程发送完成
+         * 同一时刻只有一个buffer在发送，发送前先等待上一次flush完成
+         * 连接信息不存在时退化为send_raw_packet
+         * @param    req   request pointer
+         */
+        int flush_raw_packet(easy_request_t *req);
+
+        /**
+         * 等待flush_raw_packet发出的buffer发送完成，没有正在发送的buffer时直接返回
+         * 所有同步/异步发送接口在挂新的opacket之前都会先调用它
+         * @param    req   request pointer
+         *
+         * @return   int   OB_CONNECT_ERROR if connection is closed
+         */
+        int wait_raw_packet(easy_request_t *req);
         //end of 优化发送结果集
 
+        /**
+         * 同步发送单个数据包，用于多语句查询中间语句的OK包
+         * 发送完成后request仍然有效，可以继续发送后续语句的结果
+         * @param    req      request pointer
+         * @param    packet   packet to send
+         */
+        int send_packet(easy_request_t *req, ObMySQLPacket *packet);
+
+        /**
+         * 如果连接协商了CLIENT_COMPRESS，把req->opacket中的数据压缩成一个压缩包，替换req->opacket
+         * @param    req      request pointer
+         * @param    is_sync  发送完成之前工作线程会等待，压缩包可以放在线程buffer中
+         */
+        int compress_output(easy_request_t *req, const bool is_sync);
+
+        inline uint16_t get_server_status(const ObMySQLResultSet *result, const uint16_t status) const
+        {
+          return static_cast<uint16_t>(result->has_more_result() ? (status | SERVER_MORE_RESULTS_EXISTS) : status);
+        }
+
         inline void wait_client_obj(easy_client_wait_t& client_wait)
         {
           pthread_mutex_lock(&client_wait.mutex);
@@ -454,6 +530,7 @@ namespace oceanbase
 
       private:
         static const int64_t SEQ_OFFSET = 3; /* offset of seq in MySQL packet */
+        static const int64_t STREAM_BUFF_SIZE = 64 * 1024; /* buffer size to stream large result set */
       private:
         int32_t io_thread_count_;
         int32_t work_thread_count_;
@@ -1,4 +1,5 @@
 #include "ob_mysql_util.h"
+#include <ctype.h>
 
 namespace oceanbase
 {
@@ -49,6 +50,194 @@ namespace oceanbase
       return ret;
     }
 
+    bool ObMySQLUtil::get_next_statement(const ObString &query, int64_t &pos, ObString &stmt)
+    {
+      bool found = false;
+      const char *str = query.ptr();
+      const int64_t len = query.length();
+      while (!found && NULL != str && pos < len)
+      {
+        int64_t start = pos;
+        int64_t end = pos;
+        char quote = '\0';
+        // only whitespace and comments, e.g. the tail after the last ';'
+        bool only_comment = true;
+        // find the end of current statement
+        while (end < len && (';' != str[end] || '\0' != quote))
+        {
+          const char c = str[end];
+          if ('\0' != quote)
+          {
+            if ('\\' == c && '`' != quote)
+            {
+              ++end;
+            }
+            else if (quote == c)
+            {
+              quote = '\0';
+            }
+          }
+          else if ('\'' == c || '"' == c || '`' == c)
+          {
+            quote = c;
+            only_comment = false;
+          }
+          else if ('#' == c
+                   || ('-' == c && end + 2 < len && '-' == str[end + 1]
+                       && isspace(static_cast<unsigned char>(str[end + 2]))))
+          {
+            while (end + 1 < len && '\n' != str[end + 1])
+            {
+              ++end;
+            }
+          }
+          else if ('/' == c && end + 1 < len && '*' == str[end + 1])
+          {
+            // /*! ... */ is executed by mysql, not a comment
+            if (end + 2 < len && '!' == str[end + 2])
+            {
+              only_comment = false;
+            }
+            end += 2;
+            while (end + 1 < len && !('*' == str[end] && '/' == str[end + 1]))
+            {
+              ++end;
+            }
+            ++end;  // the '/' of "*/"
+          }
+          else if (!isspace(static_cast<unsigned char>(c)))
+          {
+            only_comment = false;
+          }
+          ++end;
+        }
+        if (end > len)
+        {
+          end = len;
+        }
+        pos = end < len ? end + 1 : len;  // skip the ';'
+        while (start < end && isspace(static_cast<unsigned char>(str[start])))
+        {
+          ++start;
+        }
+        while (end > start && isspace(static_cast<unsigned char>(str[end - 1])))
+        {
+          --end;
+        }
+        if (end > start && !only_comment)
+        {
+          stmt.assign_ptr(const_cast<char*>(str + start), static_cast<int32_t>(end - start));
+          found = true;
+        }
+      }
+      return found;
+    }
+
+    namespace
+    {
+      const char DIGITS_PAIRS[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+      inline void put_2digits(int value, char *buf)
+      {
+        buf[0] = DIGITS_PAIRS[value * 2];
+        buf[1] = DIGITS_PAIRS[value * 2 + 1];
+      }
+
+      // the cached local hour of get_local_time(), valid for [hour_begin, hour_begin + 3600)
+      __thread bool local_hour_valid = false;
+      __thread time_t local_hour_begin = 0;
+      __thread struct tm local_hour_tm;
+    }
+
+    int64_t ObMySQLUtil::int_to_text(int64_t value, char *buf)
+    {
+      char tmp[MAX_INT_TEXT_LENGTH];
+      char *p = tmp + MAX_INT_TEXT_LENGTH;
+      uint64_t uval = value < 0 ? (0 - static_cast<uint64_t>(value)) : static_cast<uint64_t>(value);
+      int64_t length = 0;
+      while (uval >= 100)
+      {
+        p -= 2;
+        put_2digits(static_cast<int>(uval % 100), p);
+        uval /= 100;
+      }
+      if (uval >= 10)
+      {
+        p -= 2;
+        put_2digits(static_cast<int>(uval), p);
+      }
+      else
+      {
+        *--p = static_cast<char>('0' + uval);
+      }
+      if (value < 0)
+      {
+        *--p = '-';
+      }
+      length = tmp + MAX_INT_TEXT_LENGTH - p;
+      memcpy(buf, p, length);
+      return length;
+    }
+
+    int64_t ObMySQLUtil::datetime_to_text(const struct tm &tms, int32_t usec, char *buf)
+    {
+      int64_t pos = 0;
+      int64_t year = tms.tm_year + 1900L;
+      if (0 <= year && year <= 9999)
+      {
+        put_2digits(static_cast<int>(year / 100), buf);
+        put_2digits(static_cast<int>(year % 100), buf + 2);
+        pos = 4;
+      }
+      else
+      {
+        pos = int_to_text(year, buf);
+      }
+      buf[pos] = '-';
+      put_2digits(tms.tm_mon + 1, buf + pos + 1);
+      buf[pos + 3] = '-';
+      put_2digits(tms.tm_mday, buf + pos + 4);
+      buf[pos + 6] = ' ';
+      put_2digits(tms.tm_hour, buf + pos + 7);
+      buf[pos + 9] = ':';
+      put_2digits(tms.tm_min, buf + pos + 10);
+      buf[pos + 12] = ':';
+      put_2digits(tms.tm_sec, buf + pos + 13);
+      pos += 15;
+      if (0 != usec)
+      {
+        buf[pos] = '.';
+        put_2digits(usec / 10000, buf + pos + 1);
+        put_2digits(usec / 100 % 100, buf + pos + 3);
+        put_2digits(usec % 100, buf + pos + 5);
+        pos += 7;
+      }
+      return pos;
+    }
+
+    void ObMySQLUtil::get_local_time(const time_t time, struct tm &tms)
+    {
+      // DST and zone offset changes happen on the hour in local time, so the
+      // cached hour never spans one
+      if (local_hour_valid && local_hour_begin <= time && time < local_hour_begin + 3600)
+      {
+        int64_t seconds = time - local_hour_begin;
+        tms = local_hour_tm;
+        tms.tm_min = static_cast<int>(seconds / 60);
+        tms.tm_sec = static_cast<int>(seconds % 60);
+      }
+      else
+      {
+        localtime_r(&time, &tms);
+        local_hour_tm = tms;
+        local_hour_begin = time - tms.tm_min * 60 - tms.tm_sec;
+        local_hour_valid = true;
+      }
+    }
+
     int ObMySQLUtil::store_length(char *buf, int64_t len, uint64_t length, int64_t &pos)
     {
       int ret = OB_SUCCESS;
@@ -64,6 +64,48 @@ namespace oceanbase
          */
         static bool update_from_bitmap(ObObj &param, const char *bitmap, int64_t field_index);
 
+        /**
+         * get next statement of a multi-statement query (CLIENT_MULTI_STATEMENTS),
+         * statements are separated by ';' out of quotes and comments, empty ones are skipped
+         *
+         * @param query[in]       the whole query
+         * @param pos[in/out]     where to start, moved after the statement found
+         * @param stmt[out]       statement without the ';' and surrounding spaces
+         *
+         * @return bool   true if a statement is found, false at the end of query
+         */
+        static bool get_next_statement(const ObString &query, int64_t &pos, ObString &stmt);
+
+        /**
+         * write decimal text of an integer, no '\0' appended
+         *
+         * @param value[in]
+         * @param buf[out]        at least MAX_INT_TEXT_LENGTH bytes
+         *
+         * @return int64_t  length of the text
+         */
+        static int64_t int_to_text(int64_t value, char *buf);
+
+        /**
+         * write "YYYY-MM-DD HH:MM:SS[.uuuuuu]", fraction is omitted when usec is 0, no '\0' appended
+         *
+         * @param tms[in]         broken-down local time
+         * @param usec[in]        microseconds, [0, 1000000)
+         * @param buf[out]        at least MAX_DATETIME_TEXT_LENGTH bytes
+         *
+         * @return int64_t  length of the text
+         */
+        static int64_t datetime_to_text(const struct tm &tms, int32_t usec, char *buf);
+
+        /**
+         * same as localtime_r(), but the broken-down time of the last hour is cached per thread,
+         * the timezone lock of libc is only taken once an hour for ordered or clustered timestamps
+         */
+        static void get_local_time(const time_t time, struct tm &tms);
+
+        static const int64_t MAX_INT_TEXT_LENGTH = 20;       // "-9223372036854775808"
+        static const int64_t MAX_DATETIME_TEXT_LENGTH = 33;  // year may take up to 11 digits
+
         /**
          * 将长度写入到buf里面，可能占1,3,4,9个字节。
          *
@@ -14,11 +14,11 @@ namespace oceanbase
       thread_id_ = 0;
       memset(scramble_buff_, 'a', 8);
       filler_ = 0;
-      //0xF7FF, 多个flag的组合，其中支持4.1 协议的flag置了1,
+      //多个flag的组合，其中支持4.1 协议的flag置了1,
       //CLIENT_PLUGIN_AUTH 这个flag没有置上,它的值为0x00080000
       //CLIENT_PLUGIN_AUTH_LENENC_CLIENT_DATA 没有置为1，0x00200000
       //CLIENT_CONNECT_WITH_DB:IS SET,0x00000008
-      server_capabilities_ = 63487;
+      server_capabilities_ = SERVER_CAPABILITIES;
       server_language_ = 8;//latin1_swedish_ci
       server_status_ = 0;// no this value in mysql protocol document
       memset(plugin_, 0, sizeof(plugin_));
@@ -86,7 +86,8 @@ namespace oceanbase
             TBSYS_LOG(ERROR, "serialize packet filler_ failed, buffer=%p, length=%ld,"
                       "server_capabilities=%c, pos=%ld", buffer, len, filler_, pos);
           }
-          else*/ if (OB_SUCCESS != (ret = ObMySQLUtil::store_int2(buffer, len, server_capabilities_, pos)))
+          else*/ if (OB_SUCCESS != (ret = ObMySQLUtil::store_int2(buffer, len,
+                                                                 static_cast<int16_t>(server_capabilities_ & 0xFFFF), pos)))
           {
             TBSYS_LOG(ERROR, "serialize packet server_capabilities failed, buffer=%p, length=%ld,"
                       "server_capabilities=%d, pos=%ld", buffer, len, server_capabilities_, pos);
@@ -101,6 +102,12 @@ namespace oceanbase
             TBSYS_LOG(ERROR, "serialize packet server_status failed, buffer=%p, length=%ld,"
                       "server_status=%d, pos=%ld", buffer, len, server_status_, pos);
           }
+          else if (OB_SUCCESS != (ret = ObMySQLUtil::store_int2(buffer, len,
+                                                                static_cast<int16_t>(server_capabilities_ >> 16), pos)))
+          {
+            TBSYS_LOG(ERROR, "serialize packet upper server_capabilities failed, buffer=%p, length=%ld,"
+                      "server_capabilities=%u, pos=%ld", buffer, len, server_capabilities_, pos);
+          }
         }
 
         if (OB_SUCCESS == ret)
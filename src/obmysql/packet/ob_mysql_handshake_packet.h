@@ -32,8 +32,11 @@ namespace oceanbase
     {
       public:
         static const int32_t SCRAMBLE_SIZE = 8;
-        static const int32_t PLUGIN_SIZE   = 13;
+        static const int32_t PLUGIN_SIZE   = 11;
         static const int32_t PLUGIN2_SIZE   = 12;
+        //lower 2 bytes(0xF7FF) are the 4.1 protocol flags except CLIENT_SSL(0x800),
+        //upper 2 bytes are CLIENT_MULTI_STATEMENTS(0x10000) and CLIENT_MULTI_RESULTS(0x20000)
+        static const uint32_t SERVER_CAPABILITIES = 0x0003F7FF;
 
       public:
         ObMySQLHandshakePacket();
@@ -45,7 +48,7 @@ namespace oceanbase
 
         int set_server_version(common::ObString& version);
 
-        inline void set_server_capability(uint16_t capability)
+        inline void set_server_capability(uint32_t capability)
         {
           server_capabilities_ = capability;
         }
@@ -85,10 +88,10 @@ namespace oceanbase
         uint32_t thread_id_;// connection_id
         char scramble_buff_[8];// auth_plugin_data_part_1 : first 8 bytes of the auth-plugin data
         char filler_;                  /* always 0x00 */
-        uint16_t server_capabilities_;  /* set value to use 4.1protocol */
+        uint32_t server_capabilities_;  /* set value to use 4.1protocol */
         uint8_t server_language_;
         uint16_t server_status_;
-        char plugin_[13];        /* always 0x00 */
+        char plugin_[11];        /* auth plugin data length and reserved, always 0x00 */
         char plugin2_[12];
         char terminated_;
         common::ObStringBuf str_buf_;   //store ObString content
@@ -62,11 +62,17 @@ void ObDailyMergeChecker::run(tbsys::CThread * thread, void * arg)
       TBSYS_LOG(ERROR, "merge process alreay have some error, check it");
     }
     int64_t now = tbsys::CTimeUtil::getMonotonicTime();
-    int64_t max_merge_duration_us = root_server_->config_.max_merge_duration_time;
+    // staggered tables start merging up to merge_stagger_window later
+    int64_t max_merge_duration_us = root_server_->config_.max_merge_duration_time
+      + root_server_->config_.merge_stagger_window;
     if (root_server_->is_master() && (root_server_->last_frozen_time_ > 0))
     {
       // check all tablet merged finish and root table is integrated
       int64_t frozen_version = root_server_->get_last_frozen_version();
+      if (OB_SUCCESS != (err = root_server_->update_merge_schedule()))
+      {
+        TBSYS_LOG(WARN, "update merge schedule failed:version[%ld], err[%d]", frozen_version, err);
+      }
       if (!root_server_->check_all_tablet_merged())
       {
         if (now > last_check_timestamp + CHECK_DROP_INTERVAL)
@@ -93,6 +99,10 @@ void ObDailyMergeChecker::run(tbsys::CThread * thread, void * arg)
         // write the log for qa & dba
         TBSYS_LOG(INFO, "build new root table ok:last_version[%ld]", frozen_version);
         root_server_->last_frozen_time_ = 0;
+        if (OB_SUCCESS != (err = root_server_->update_index_build_status()))
+        {
+          TBSYS_LOG(WARN, "update index build status failed:version[%ld], err[%d]", frozen_version, err);
+        }
         // checkpointing after done merge
         root_server_->make_checkpointing();
       }
@@ -74,7 +74,8 @@ void ObHeartbeatChecker::run(tbsys::CThread * thread, void * arg)
                     root_server_->config_.cs_lease_duration_time,
                     root_server_->last_frozen_mem_version_,
                     root_server_->get_schema_version(),
-                    root_server_->get_config_version()) != OB_SUCCESS)
+                    root_server_->get_config_version(),
+                    root_server_->get_merge_released_group()) != OB_SUCCESS)
               {
                 TBSYS_LOG(WARN, "heart beart to cs fail, cs: [%s]",
                     to_cstring(tmp_server));
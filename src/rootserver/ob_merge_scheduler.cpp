@@ -0,0 +1,231 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_merge_scheduler.cpp
+ *
+ */
+#include <algorithm>
+#include "common/utility.h"
+#include "ob_merge_scheduler.h"
+
+namespace oceanbase
+{
+  namespace rootserver
+  {
+    using namespace common;
+
+    namespace
+    {
+      struct MergeOrder
+      {
+        bool operator()(const ObTableMergeStat& lhs, const ObTableMergeStat& rhs) const
+        {
+          bool ret = false;
+          if (lhs.get_read_latency() != rhs.get_read_latency())
+          {
+            ret = lhs.get_read_latency() > rhs.get_read_latency();
+          }
+          else if (lhs.data_size_ != rhs.data_size_)
+          {
+            ret = lhs.data_size_ > rhs.data_size_;
+          }
+          else
+          {
+            ret = lhs.table_id_ < rhs.table_id_;
+          }
+          return ret;
+        }
+      };
+    }
+
+    ObMergeScheduler::ObMergeScheduler()
+      : start_time_(0), ups_memtable_used_(0), ups_memtable_limit_(0),
+      ups_memory_pressure_percent_(100), split_tablet_size_(0), split_range_count_(0)
+    {
+    }
+
+    ObMergeScheduler::~ObMergeScheduler()
+    {
+    }
+
+    int ObMergeScheduler::make_schedule(const int64_t frozen_version, const int64_t start_time,
+        ObArray<ObTableMergeStat>& tables, const int64_t group_count)
+    {
+      int ret = OB_SUCCESS;
+      const int64_t table_count = tables.count();
+      int64_t total_size = 0;
+      int64_t size = 0;
+      int64_t group = 0;
+
+      tbsys::CThreadGuard guard(&mutex_);
+      schedule_.reset();
+      schedule_.set_split_param(split_tablet_size_, split_range_count_);
+      if (group_count > 1 && table_count > 1)
+      {
+        std::sort(&tables.at(0), &tables.at(0) + table_count, MergeOrder());
+        for (int64_t i = 0; i < table_count; ++i)
+        {
+          total_size += tables.at(i).data_size_;
+        }
+        for (int64_t i = 0; OB_SUCCESS == ret && i < table_count; ++i)
+        {
+          // cut by data size, so that groups need about the same merge time
+          group = total_size > 0 ? size * group_count / total_size : i * group_count / table_count;
+          if (group >= group_count)
+          {
+            group = group_count - 1;
+          }
+          size += tables.at(i).data_size_;
+          ret = schedule_.add_table(tables.at(i).table_id_, group);
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        schedule_.finish();
+        schedule_.set_frozen_version(frozen_version);
+        start_time_ = start_time;
+        if (schedule_.get_group_count() > 0)
+        {
+          schedule_.release_group(0);
+        }
+        TBSYS_LOG(INFO, "make merge schedule, %s", to_cstring(schedule_));
+      }
+      else
+      {
+        TBSYS_LOG(WARN, "failed to make merge schedule, merge all tables at once, "
+            "frozen_version=%ld, ret=%d", frozen_version, ret);
+        schedule_.reset();
+        schedule_.set_split_param(split_tablet_size_, split_range_count_);
+        schedule_.set_frozen_version(frozen_version);
+      }
+      SplitParam &split = split_history_[frozen_version % SPLIT_HISTORY_SIZE];
+      split.frozen_version_ = frozen_version;
+      split.tablet_size_ = split_tablet_size_;
+      split.range_count_ = split_range_count_;
+      return ret;
+    }
+
+    int64_t ObMergeScheduler::release_groups(const int64_t now, const int64_t window)
+    {
+      int64_t group = 0;
+      tbsys::CThreadGuard guard(&mutex_);
+      const int64_t group_count = schedule_.get_group_count();
+
+      if (group_count > 0)
+      {
+        if (window <= 0 || now - start_time_ >= window)
+        {
+          group = group_count - 1;
+        }
+        else
+        {
+          group = (now - start_time_) * group_count / window;
+        }
+        if (group < group_count - 1 && is_ups_memory_pressed())
+        {
+          TBSYS_LOG(WARN, "updateserver memtable used=%ld, limit=%ld, release all merge groups",
+              ups_memtable_used_, ups_memtable_limit_);
+          group = group_count - 1;
+        }
+        if (schedule_.release_group(group))
+        {
+          TBSYS_LOG(INFO, "release merge group, %s", to_cstring(schedule_));
+        }
+      }
+      return schedule_.get_released_group();
+    }
+
+    void ObMergeScheduler::set_ups_memory_usage(const int64_t memtable_used,
+        const int64_t memtable_limit)
+    {
+      tbsys::CThreadGuard guard(&mutex_);
+      ups_memtable_used_ = memtable_used;
+      ups_memtable_limit_ = memtable_limit;
+    }
+
+    void ObMergeScheduler::set_ups_memory_pressure_percent(const int64_t percent)
+    {
+      tbsys::CThreadGuard guard(&mutex_);
+      ups_memory_pressure_percent_ = percent;
+    }
+
+    void ObMergeScheduler::set_split_param(const int64_t min_tablet_size,
+        const int64_t sub_range_count)
+    {
+      tbsys::CThreadGuard guard(&mutex_);
+      split_tablet_size_ = min_tablet_size;
+      split_range_count_ = sub_range_count;
+    }
+
+    int64_t ObMergeScheduler::get_frozen_version() const
+    {
+      tbsys::CThreadGuard guard(&mutex_);
+      return schedule_.get_frozen_version();
+    }
+
+    int64_t ObMergeScheduler::get_released_group(const int64_t frozen_version) const
+    {
+      int64_t group = ObMergeSchedule::ALL_GROUP_RELEASED;
+      tbsys::CThreadGuard guard(&mutex_);
+      if (frozen_version == schedule_.get_frozen_version())
+      {
+        group = schedule_.get_released_group();
+      }
+      else if (frozen_version > schedule_.get_frozen_version())
+      {
+        // plan not made yet, release nothing
+        group = -1;
+      }
+      return group;
+    }
+
+    int ObMergeScheduler::serialize_schedule(const int64_t frozen_version,
+        char* buf, const int64_t buf_len, int64_t& pos) const
+    {
+      int ret = OB_SUCCESS;
+      tbsys::CThreadGuard guard(&mutex_);
+      if (frozen_version == schedule_.get_frozen_version())
+      {
+        ret = schedule_.serialize(buf, buf_len, pos);
+      }
+      else if (frozen_version > schedule_.get_frozen_version())
+      {
+        ret = OB_EAGAIN;
+      }
+      else
+      {
+        // merge of old version is late, no need to wait, but split
+        // tablets the same way as the replicas merged in time. if the
+        // plan of that version is forgotten, don't split at all.
+        ObMergeSchedule schedule;
+        const SplitParam &split = split_history_[frozen_version % SPLIT_HISTORY_SIZE];
+        schedule.set_frozen_version(frozen_version);
+        if (frozen_version == split.frozen_version_)
+        {
+          schedule.set_split_param(split.tablet_size_, split.range_count_);
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "split params of old version are forgotten, don't split:"
+              "frozen_version[%ld], current[%ld]", frozen_version, schedule_.get_frozen_version());
+          schedule.set_split_param(0, 0);
+        }
+        ret = schedule.serialize(buf, buf_len, pos);
+      }
+      return ret;
+    }
+
+    bool ObMergeScheduler::is_ups_memory_pressed() const
+    {
+      return ups_memtable_limit_ > 0
+        && ups_memtable_used_ * 100 >= ups_memtable_limit_ * ups_memory_pressure_percent_;
+    }
+  } // end namespace rootserver
+} // end namespace oceanbase
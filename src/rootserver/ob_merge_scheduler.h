@@ -0,0 +1,129 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_merge_scheduler.h
+ *
+ * Spread the daily merge of one frozen version over the merge window:
+ *   1. tables are ordered by read latency on chunkservers, tables whose
+ *      reads suffer most from the unmerged data are merged first
+ *   2. the ordered tables are cut into groups of about the same data size
+ *   3. group i is released at start + window * i / group_count, all groups
+ *      are released at once when updateserver memtable is under pressure,
+ *      because the frozen memtable can only be dropped after the merge
+ * Old tablet versions are still discarded only after the whole version is
+ * merged, see ObRootTable2::check_tablet_version_merged.
+ */
+#ifndef OCEANBASE_ROOTSERVER_OB_MERGE_SCHEDULER_H_
+#define OCEANBASE_ROOTSERVER_OB_MERGE_SCHEDULER_H_
+
+#include <tbsys.h>
+#include "common/ob_define.h"
+#include "common/ob_array.h"
+#include "common/ob_merge_schedule.h"
+
+namespace oceanbase
+{
+  namespace rootserver
+  {
+    struct ObTableMergeStat
+    {
+      uint64_t table_id_;
+      int64_t data_size_;
+      int64_t row_count_;
+      int64_t read_count_;
+      int64_t read_time_;
+
+      ObTableMergeStat()
+        : table_id_(common::OB_INVALID_ID), data_size_(0), row_count_(0), read_count_(0), read_time_(0) {}
+      inline int64_t get_read_latency() const
+      {
+        return read_count_ > 0 ? read_time_ / read_count_ : 0;
+      }
+      struct TableIdLess
+      {
+        bool operator()(const ObTableMergeStat& lhs, const ObTableMergeStat& rhs) const
+        {
+          return lhs.table_id_ < rhs.table_id_;
+        }
+      };
+    };
+
+    class ObMergeScheduler
+    {
+      public:
+        ObMergeScheduler();
+        ~ObMergeScheduler();
+
+        /**
+         * make merge plan of %frozen_version with at most %group_count
+         * groups, no plan if %group_count <= 1, then all tables are
+         * released at once.
+         */
+        int make_schedule(const int64_t frozen_version, const int64_t start_time,
+            common::ObArray<ObTableMergeStat>& tables, const int64_t group_count);
+
+        /**
+         * release the merge groups whose time has come in %window.
+         * @return the released group
+         */
+        int64_t release_groups(const int64_t now, const int64_t window);
+
+        /// updateserver reports memtable usage in its lease renew message
+        void set_ups_memory_usage(const int64_t memtable_used, const int64_t memtable_limit);
+        void set_ups_memory_pressure_percent(const int64_t percent);
+        /**
+         * split parameters of parallel merge, put into the plan when it
+         * is made, so changes take effect from the next frozen version.
+         */
+        void set_split_param(const int64_t min_tablet_size, const int64_t sub_range_count);
+
+        int64_t get_frozen_version() const;
+        /**
+         * released group of %frozen_version, -1 if the plan is not made
+         * yet, all released for older versions.
+         */
+        int64_t get_released_group(const int64_t frozen_version) const;
+        /**
+         * serialize the plan of %frozen_version, OB_EAGAIN if not made yet.
+         * an older version has no plan and releases all tables, it splits
+         * tablets as its own plan did, or not at all if that is forgotten.
+         */
+        int serialize_schedule(const int64_t frozen_version,
+            char* buf, const int64_t buf_len, int64_t& pos) const;
+
+      private:
+        static const int64_t SPLIT_HISTORY_SIZE = 4;
+        struct SplitParam
+        {
+          int64_t frozen_version_;
+          int64_t tablet_size_;
+          int64_t range_count_;
+          SplitParam() : frozen_version_(0), tablet_size_(0), range_count_(0) {}
+        };
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObMergeScheduler);
+        bool is_ups_memory_pressed() const;
+
+      private:
+        mutable tbsys::CThreadMutex mutex_;
+        common::ObMergeSchedule schedule_;
+        int64_t start_time_;
+        int64_t ups_memtable_used_;
+        int64_t ups_memtable_limit_;
+        int64_t ups_memory_pressure_percent_;
+        int64_t split_tablet_size_;
+        int64_t split_range_count_;
+        // split params of recent plans, indexed by frozen_version % SPLIT_HISTORY_SIZE
+        SplitParam split_history_[SPLIT_HISTORY_SIZE];
+    };
+  } // end namespace rootserver
+} // end namespace oceanbase
+
+#endif //OCEANBASE_ROOTSERVER_OB_MERGE_SCHEDULER_H_
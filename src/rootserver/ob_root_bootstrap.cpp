@@ -376,6 +376,18 @@ int ObBootstrap::bootstrap_sys_tables(void)
       TBSYS_LOG(WARN, "failed to create table for __all_server_stat, err=%d", ret);
     }
   }
+  // create table __all_slow_query
+  if (OB_SUCCESS == ret)
+  {
+    if (OB_SUCCESS != (ret = ObExtraTablesSchema::all_slow_query_schema(table_schema)))
+    {
+      TBSYS_LOG(WARN, "failed to get schema of __all_slow_query, err=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = create_sys_table(table_schema)))
+    {
+      TBSYS_LOG(WARN, "failed to create table for __all_slow_query, err=%d", ret);
+    }
+  }
   // create table __all_sys_config_stat
   if (OB_SUCCESS == ret)
   {
@@ -740,6 +752,13 @@ int ObBootstrap::init_all_sys_param()
         ObIntType,
         "1",
         "");
+    INSERT_ALL_SYS_PARAM_ROW(
+        ret,
+        acc,
+        "ob_query_parallel_degree",
+        ObIntType,
+        "1",
+        "Max threads to sort rows of one query in mergeserver");
     char version_comment[256];
     snprintf(version_comment, 256, "OceanBase %s (r%s) (Built %s %s)",
              PACKAGE_VERSION, svn_version(), build_date(), build_time());
@@ -195,6 +195,49 @@ int ObRootRpcStub::switch_schema(const common::ObServer& server, const common::O
   return ret;
 }
 
+int ObRootRpcStub::switch_schema_delta(const common::ObServer& server, const common::ObSchemaDelta& delta, const int64_t timeout_us)
+{
+  int ret = OB_SUCCESS;
+  ObDataBuffer msgbuf;
+
+  if (NULL == client_mgr_)
+  {
+    TBSYS_LOG(ERROR, "client_mgr_=NULL");
+    ret = OB_ERROR;
+  }
+  else if (OB_SUCCESS != (ret = get_thread_buffer_(msgbuf)))
+  {
+    TBSYS_LOG(ERROR, "failed to get thread buffer, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = delta.serialize(msgbuf.get_data(), msgbuf.get_capacity(), msgbuf.get_position())))
+  {
+    TBSYS_LOG(ERROR, "failed to serialize schema delta, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = client_mgr_->send_request(server, OB_SWITCH_SCHEMA, SWITCH_SCHEMA_DELTA_VERSION, timeout_us, msgbuf)))
+  {
+    TBSYS_LOG(WARN, "failed to send request, err=%d", ret);
+  }
+  else
+  {
+    ObResultCode result;
+    int64_t pos = 0;
+    if (OB_SUCCESS != (ret = result.deserialize(msgbuf.get_data(), msgbuf.get_position(), pos)))
+    {
+      TBSYS_LOG(ERROR, "failed to deserialize response, err=%d", ret);
+    }
+    else if (OB_SUCCESS != result.result_code_)
+    {
+      TBSYS_LOG(INFO, "failed to switch schema delta, server=%s err=%d", to_cstring(server), result.result_code_);
+      ret = result.result_code_;
+    }
+    else
+    {
+      TBSYS_LOG(INFO, "send switch_schema_delta, server=%s %s", to_cstring(server), to_cstring(delta));
+    }
+  }
+  return ret;
+}
+
 int ObRootRpcStub::migrate_tablet(const common::ObServer& src_cs, const common::ObServer& dest_cs,
     const common::ObNewRange& range, bool keey_src, const int64_t timeout_us)
 {
@@ -465,10 +508,10 @@ int ObRootRpcStub::get_obi_role(const common::ObServer& master, const int64_t ti
 }
 
 int ObRootRpcStub::heartbeat_to_cs(const common::ObServer& cs, const int64_t lease_time, const int64_t frozen_mem_version,
-    const int64_t schema_version, const int64_t config_version)
+    const int64_t schema_version, const int64_t config_version, const int64_t merge_released_group)
 {
   int ret = OB_SUCCESS;
-  static const int MY_VERSION = 3;
+  static const int MY_VERSION = 4;
   ObDataBuffer msgbuf;
 
   if (NULL == client_mgr_)
@@ -496,6 +539,10 @@ int ObRootRpcStub::heartbeat_to_cs(const common::ObServer& cs, const int64_t lea
   {
     TBSYS_LOG(ERROR, "failed to serialize config_version, err=%d", ret);
   }
+  else if (OB_SUCCESS != (ret = common::serialization::encode_vi64(msgbuf.get_data(), msgbuf.get_capacity(), msgbuf.get_position(), merge_released_group)))
+  {
+    TBSYS_LOG(ERROR, "failed to serialize merge_released_group, err=%d", ret);
+  }
   else if (OB_SUCCESS != (ret = client_mgr_->post_request(cs, OB_REQUIRE_HEARTBEAT, MY_VERSION, msgbuf)))
   {
     TBSYS_LOG(WARN, "failed to send request, err=%d", ret);
@@ -878,6 +925,46 @@ int ObRootRpcStub::table_exist_in_cs(const ObServer &cs, const int64_t timeout_u
   return ret;
 }
 
+int ObRootRpcStub::fetch_stats(const common::ObServer& server, const int64_t timeout_us,
+    common::ObStatManager &stat_manager)
+{
+  int ret = OB_SUCCESS;
+  ObDataBuffer msgbuf;
+
+  if (NULL == client_mgr_)
+  {
+    TBSYS_LOG(ERROR, "client_mgr_=NULL");
+    ret = OB_ERROR;
+  }
+  else if (OB_SUCCESS != (ret = get_thread_buffer_(msgbuf)))
+  {
+    TBSYS_LOG(ERROR, "failed to get thread buffer, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = client_mgr_->send_request(server, OB_FETCH_STATS, DEFAULT_VERSION, timeout_us, msgbuf)))
+  {
+    TBSYS_LOG(WARN, "failed to send request, server=%s, err=%d", server.to_cstring(), ret);
+  }
+  else
+  {
+    ObResultCode result;
+    int64_t pos = 0;
+    if (OB_SUCCESS != (ret = result.deserialize(msgbuf.get_data(), msgbuf.get_position(), pos)))
+    {
+      TBSYS_LOG(ERROR, "failed to deserialize response, err=%d", ret);
+    }
+    else if (OB_SUCCESS != result.result_code_)
+    {
+      TBSYS_LOG(WARN, "failed to fetch stats, server=%s, err=%d", server.to_cstring(), result.result_code_);
+      ret = result.result_code_;
+    }
+    else if (OB_SUCCESS != (ret = stat_manager.deserialize(msgbuf.get_data(), msgbuf.get_position(), pos)))
+    {
+      TBSYS_LOG(WARN, "failed to deserialize stats, server=%s, err=%d", server.to_cstring(), ret);
+    }
+  }
+  return ret;
+}
+
 int ObRootRpcStub::execute_sql(const ObServer& ms, const ObString sql, int64_t timeout)
 {
   int ret = OB_SUCCESS;
@@ -5,10 +5,12 @@
 #include "common/ob_common_rpc_stub.h"
 #include "common/ob_server.h"
 #include "common/ob_schema.h"
+#include "common/ob_schema_delta.h"
 #include "common/ob_range.h"
 #include "common/ob_tablet_info.h"
 #include "common/ob_tablet_info.h"
 #include "common/ob_rs_ups_message.h"
+#include "common/ob_statistics.h"
 #include "ob_chunk_server_manager.h"
 
 namespace oceanbase
@@ -25,6 +27,8 @@ namespace oceanbase
         virtual int slave_register(const common::ObServer& master, const common::ObServer& slave_addr, common::ObFetchParam& fetch_param, const int64_t timeout);
         virtual int set_obi_role(const common::ObServer& ups, const common::ObiRole& role, const int64_t timeout_us);
         virtual int switch_schema(const common::ObServer& server, const common::ObSchemaManagerV2& schema_manager, const int64_t timeout_us);
+        // servers older than the delta protocol return OB_ERROR_FUNC_VERSION
+        virtual int switch_schema_delta(const common::ObServer& server, const common::ObSchemaDelta& delta, const int64_t timeout_us);
         virtual int migrate_tablet(const common::ObServer& src_cs, const common::ObServer& dest_cs, const common::ObNewRange& range, bool keep_src, const int64_t timeout_us);
         virtual int create_tablet(const common::ObServer& cs, const common::ObNewRange& range, const int64_t mem_version, const int64_t timeout_us);
         virtual int delete_tablets(const common::ObServer& cs, const common::ObTabletReportInfoList &tablets, const int64_t timeout_us);
@@ -39,12 +43,15 @@ namespace oceanbase
              const uint64_t table_id, const int64_t frozen_version, common::ObTabletInfoList &tablets);
         virtual int table_exist_in_cs(const common::ObServer &cs, const int64_t timeout_us,
             const uint64_t table_id, bool &is_exist_in_cs);
+        virtual int fetch_stats(const common::ObServer& server, const int64_t timeout_us,
+            common::ObStatManager &stat_manager);
         // asynchronous rpc messages
         virtual int heartbeat_to_cs(const common::ObServer& cs,
                                     const int64_t lease_time,
                                     const int64_t frozen_mem_version,
                                     const int64_t schema_version,
-                                    const int64_t config_version);
+                                    const int64_t config_version,
+                                    const int64_t merge_released_group);
         virtual int heartbeat_to_ms(const common::ObServer& ms,
                                     const int64_t lease_time,
                                     const int64_t frozen_mem_version,
@@ -63,6 +70,7 @@ namespace oceanbase
         int get_thread_buffer_(common::ObDataBuffer& data_buffer);
       private:
         static const int32_t DEFAULT_VERSION = 1;
+        static const int32_t SWITCH_SCHEMA_DELTA_VERSION = 2;
         common::ThreadSpecificBuffer *thread_buffer_;
     };
   } /* rootserver */
@@ -11,6 +11,7 @@
  *
  ================================================================*/
 #include <new>
+#include <algorithm>
 #include <string.h>
 #include <cmath>
 #include <tbsys.h>
@@ -189,7 +190,8 @@ ObRootServer2::ObRootServer2(ObRootServerConfig &config)
     heart_beat_checker_(this),
     ms_provider_(server_manager_),
     local_schema_manager_(NULL),
-    schema_manager_for_cache_(NULL)
+    schema_manager_for_cache_(NULL),
+    last_sync_schema_(NULL)
 {
 }
 
@@ -205,6 +207,11 @@ ObRootServer2::~ObRootServer2()
     OB_DELETE(ObSchemaManagerV2, ObModIds::OB_RS_SCHEMA_MANAGER, schema_manager_for_cache_);
     schema_manager_for_cache_ = NULL;
   }
+  if (last_sync_schema_)
+  {
+    OB_DELETE(ObSchemaManagerV2, ObModIds::OB_RS_SCHEMA_MANAGER, last_sync_schema_);
+    last_sync_schema_ = NULL;
+  }
   if (root_table_)
   {
     OB_DELETE(ObRootTable2, ObModIds::OB_RS_ROOT_TABLE, root_table_);
@@ -1154,7 +1161,25 @@ int ObRootServer2::switch_schema_manager(const ObSchemaManagerV2 & schema_manage
   }
   else
   {
+    // index build status is only known by rootserver, keep it across schema reloads
+    ObArray<uint64_t> built_index_tables;
+    for (const ObTableSchema* it = schema_manager_for_cache_->table_begin();
+         OB_SUCCESS == ret && it != schema_manager_for_cache_->table_end(); ++it)
+    {
+      if (it->is_index_table() && it->is_index_built())
+      {
+        ret = built_index_tables.push_back(it->get_table_id());
+      }
+    }
     *schema_manager_for_cache_ = schema_manager;
+    for (int64_t i = 0; i < built_index_tables.count(); ++i)
+    {
+      ObTableSchema *table = schema_manager_for_cache_->get_table_schema(built_index_tables.at(i));
+      if (NULL != table && table->is_index_table())
+      {
+        table->set_index_built(true);
+      }
+    }
   }
   return ret;
 }
@@ -4219,6 +4244,179 @@ bool ObRootServer2::check_all_tablet_merged(void) const
   return ret;
 }
 
+int ObRootServer2::update_merge_schedule()
+{
+  int ret = OB_SUCCESS;
+  const int64_t frozen_version = last_frozen_mem_version_;
+  const int64_t now = tbsys::CTimeUtil::getTime();
+  const int64_t window = config_.merge_stagger_window;
+  merge_scheduler_.set_ups_memory_pressure_percent(config_.merge_stagger_ups_memory_percent);
+  if (frozen_version > merge_scheduler_.get_frozen_version())
+  {
+    ObArray<ObTableMergeStat> tables;
+    int64_t group_count = window > 0 ? (int64_t)config_.merge_stagger_group_count : 1;
+    merge_scheduler_.set_split_param(config_.parallel_merge_min_tablet_size,
+        config_.parallel_merge_sub_range_count);
+    if (group_count > 1 && OB_SUCCESS != (ret = collect_table_merge_stat(tables)))
+    {
+      TBSYS_LOG(WARN, "collect table merge stat failed, merge all tables at once:ret[%d]", ret);
+      group_count = 1;
+    }
+    ret = merge_scheduler_.make_schedule(frozen_version, now, tables, group_count);
+  }
+  merge_scheduler_.release_groups(now, window);
+  return ret;
+}
+
+int64_t ObRootServer2::get_merge_released_group() const
+{
+  return merge_scheduler_.get_released_group(last_frozen_mem_version_);
+}
+
+int ObRootServer2::serialize_merge_schedule(const int64_t frozen_version,
+    char* buf, const int64_t buf_len, int64_t& pos) const
+{
+  return merge_scheduler_.serialize_schedule(frozen_version, buf, buf_len, pos);
+}
+
+int ObRootServer2::update_index_build_status()
+{
+  int ret = OB_SUCCESS;
+  ObArray<ObTableMergeStat> tables;
+  bool changed = false;
+  {
+    tbsys::CRLockGuard guard(root_table_rwlock_);
+    if (NULL == root_table_)
+    {
+      ret = OB_NOT_INIT;
+    }
+    else
+    {
+      ret = root_table_->get_table_data_size(tables);
+    }
+  }
+  if (OB_SUCCESS == ret && tables.count() > 0)
+  {
+    ObTableMergeStat *begin = &tables.at(0);
+    ObTableMergeStat *end = begin + tables.count();
+    ObTableMergeStat index_key;
+    ObTableMergeStat data_key;
+    tbsys::CWLockGuard guard(schema_manager_rwlock_);
+    for (const ObTableSchema* it = schema_manager_for_cache_->table_begin();
+         it != schema_manager_for_cache_->table_end(); ++it)
+    {
+      if (!it->is_index_table() || it->is_index_built())
+      {
+        continue;
+      }
+      // every row of the data table merged so far has its index row in the
+      // same version, unless the index table missed the rows written before it
+      index_key.table_id_ = it->get_table_id();
+      data_key.table_id_ = it->get_index_data_table_id();
+      ObTableMergeStat *index_stat = std::lower_bound(begin, end, index_key, ObTableMergeStat::TableIdLess());
+      ObTableMergeStat *data_stat = std::lower_bound(begin, end, data_key, ObTableMergeStat::TableIdLess());
+      if (index_stat != end && index_stat->table_id_ == index_key.table_id_
+          && data_stat != end && data_stat->table_id_ == data_key.table_id_
+          && index_stat->row_count_ == data_stat->row_count_)
+      {
+        schema_manager_for_cache_->get_table_schema(it->get_table_id())->set_index_built(true);
+        changed = true;
+        TBSYS_LOG(INFO, "index table is built:index_table[%lu], data_table[%lu], row_count[%ld]",
+            index_key.table_id_, data_key.table_id_, index_stat->row_count_);
+      }
+      else
+      {
+        TBSYS_LOG(INFO, "index table is not built yet:index_table[%lu], data_table[%lu]",
+            index_key.table_id_, data_key.table_id_);
+      }
+    }
+    if (changed)
+    {
+      schema_timestamp_ = tbsys::CTimeUtil::getTime();
+      schema_manager_for_cache_->set_version(schema_timestamp_);
+    }
+  }
+  if (OB_SUCCESS == ret && changed && OB_SUCCESS != (ret = notify_switch_schema(false)))
+  {
+    TBSYS_LOG(WARN, "fail to notify switch schema, servers get the index on next heartbeat:ret[%d]", ret);
+  }
+  return ret;
+}
+
+int ObRootServer2::collect_table_merge_stat(ObArray<ObTableMergeStat> &tables)
+{
+  int ret = OB_SUCCESS;
+  ObArray<ObServer> servers;
+  ObServer cs;
+  ObStatManager *stat_manager = NULL;
+  {
+    tbsys::CRLockGuard guard(root_table_rwlock_);
+    if (NULL == root_table_)
+    {
+      ret = OB_NOT_INIT;
+    }
+    else
+    {
+      ret = root_table_->get_table_data_size(tables);
+    }
+  }
+  if (OB_SUCCESS == ret)
+  {
+    tbsys::CRLockGuard guard(server_manager_rwlock_);
+    ObChunkServerManager::const_iterator it = server_manager_.begin();
+    for (; OB_SUCCESS == ret && it != server_manager_.end(); ++it)
+    {
+      if (it->status_ != ObServerStatus::STATUS_DEAD && it->port_cs_ != 0)
+      {
+        cs = it->server_;
+        cs.set_port(it->port_cs_);
+        ret = servers.push_back(cs);
+      }
+    }
+  }
+  if (OB_SUCCESS == ret && tables.count() > 0)
+  {
+    stat_manager = new (std::nothrow) ObStatManager(OB_CHUNKSERVER);
+    if (NULL == stat_manager)
+    {
+      TBSYS_LOG(WARN, "no memory for stat manager");
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+    }
+  }
+  // read latency of each table summed from all chunkservers, one
+  // chunkserver failed only makes the order less accurate
+  for (int64_t i = 0; OB_SUCCESS == ret && NULL != stat_manager && i < servers.count(); ++i)
+  {
+    if (OB_SUCCESS != worker_->get_rpc_stub().fetch_stats(servers.at(i),
+          config_.network_timeout, *stat_manager))
+    {
+      TBSYS_LOG(WARN, "fetch stats from cs failed, skip it:cs[%s]", to_cstring(servers.at(i)));
+      continue;
+    }
+    ObStatManager::const_iterator it = stat_manager->begin(OB_STAT_CHUNKSERVER);
+    for (; it != stat_manager->end(OB_STAT_CHUNKSERVER); ++it)
+    {
+      // tables are in table id order as root table
+      ObTableMergeStat *begin = &tables.at(0);
+      ObTableMergeStat *end = begin + tables.count();
+      ObTableMergeStat key;
+      key.table_id_ = it->get_table_id();
+      ObTableMergeStat *stat = std::lower_bound(begin, end, key, ObTableMergeStat::TableIdLess());
+      if (stat != end && stat->table_id_ == it->get_table_id())
+      {
+        stat->read_count_ += it->get_value(INDEX_GET_COUNT) + it->get_value(INDEX_SCAN_COUNT);
+        stat->read_time_ += it->get_value(INDEX_GET_TIME) + it->get_value(INDEX_SCAN_TIME);
+      }
+    }
+  }
+  if (NULL != stat_manager)
+  {
+    delete stat_manager;
+    stat_manager = NULL;
+  }
+  return ret;
+}
+
 int ObRootServer2::report_frozen_memtable(const int64_t frozen_version, const int64_t last_frozen_time, bool did_replay)
 {
   int ret = OB_SUCCESS;
@@ -4621,7 +4819,7 @@ void ObRootServer2::do_stat_merge(char* buf, const int64_t buf_len, int64_t &pos
     else
     {
       int64_t now = tbsys::CTimeUtil::getMonotonicTime();
-      int64_t max_merge_duration_us = config_.max_merge_duration_time;
+      int64_t max_merge_duration_us = config_.max_merge_duration_time + config_.merge_stagger_window;
       if (now > last_frozen_time_ + max_merge_duration_us)
       {
         databuff_printf(buf, buf_len, pos, "merge: TIMEOUT");
@@ -4741,6 +4939,15 @@ int ObRootServer2::do_stat(int stat_key, char *buf, const int64_t buf_len, int64
     case OB_RS_STAT_DATA_SIZE:
       databuff_printf(buf, buf_len, pos, "data_size: %ld", get_stat_value(INDEX_ALL_DATA_SIZE));
       break;
+    case OB_RS_STAT_MIGRATE_SPEED:
+      {
+        int64_t migrate_bytes = get_stat_value(INDEX_MIGRATE_BYTES);
+        int64_t migrate_timeu = get_stat_value(INDEX_MIGRATE_TIMEU);
+        databuff_printf(buf, buf_len, pos, "migrate_bytes: %ld migrate_time: %ldus migrate_speed: %ldKB/s",
+            migrate_bytes, migrate_timeu,
+            (0 < migrate_timeu) ? migrate_bytes * 1000000L / 1024 / migrate_timeu : 0);
+      }
+      break;
     case OB_RS_STAT_CS_NUM:
       do_stat_cs_num(buf, buf_len, pos);
       break;
@@ -4808,7 +5015,8 @@ int ObRootServer2::register_ups(const common::ObServer &addr, int32_t inner_port
 }
 
 int ObRootServer2::receive_ups_heartbeat_resp(const common::ObServer &addr, ObUpsStatus stat,
-                                              const common::ObiRole &obi_role)
+                                              const common::ObiRole &obi_role,
+                                              const int64_t memtable_used, const int64_t memtable_limit)
 {
   int ret = OB_SUCCESS;
   if (NULL == ups_manager_)
@@ -4819,6 +5027,10 @@ int ObRootServer2::receive_ups_heartbeat_resp(const common::ObServer &addr, ObUp
   else
   {
     ret = ups_manager_->renew_lease(addr, stat, obi_role);
+    if (OB_SUCCESS == ret && memtable_limit > 0)
+    {
+      merge_scheduler_.set_ups_memory_usage(memtable_used, memtable_limit);
+    }
   }
   return ret;
 }
@@ -5099,7 +5311,7 @@ int ObRootServer2::force_heartbeat_all_servers(void)
         tmp_server.set_port(it->port_cs_);
         ret = worker_->get_rpc_stub().heartbeat_to_cs(tmp_server,
             config_.cs_lease_duration_time, last_frozen_mem_version_,
-            get_schema_version(), get_config_version());
+            get_schema_version(), get_config_version(), get_merge_released_group());
         if (OB_SUCCESS == ret)
         {
           TBSYS_LOG(INFO, "force hearbeat to cs %s", to_cstring(tmp_server));
@@ -5134,9 +5346,25 @@ int ObRootServer2::force_heartbeat_all_servers(void)
 int ObRootServer2::force_sync_schema_all_servers(const ObSchemaManagerV2 &schema)
 {
   int ret = OB_SUCCESS;
+  int err = OB_SUCCESS;
   ObServer tmp_server;
   if (this->is_master())
   {
+    tbsys::CThreadGuard guard(&sync_schema_mutex_);
+    ObSchemaDelta delta;
+    const ObSchemaDelta *sync_delta = NULL;
+    if (NULL != last_sync_schema_ && last_sync_schema_->get_version() < schema.get_version())
+    {
+      if (OB_SUCCESS != (err = delta.diff(*last_sync_schema_, schema)))
+      {
+        TBSYS_LOG(WARN, "fail to diff schema, sync the whole schema. base[%ld], version[%ld], err[%d]",
+            last_sync_schema_->get_version(), schema.get_version(), err);
+      }
+      else
+      {
+        sync_delta = &delta;
+      }
+    }
     ObChunkServerManager::iterator it = this->server_manager_.begin();
     for (; OB_SUCCESS == ret && it != this->server_manager_.end(); ++it)
     {
@@ -5144,8 +5372,7 @@ int ObRootServer2::force_sync_schema_all_servers(const ObSchemaManagerV2 &schema
       {
         tmp_server = it->server_;
         tmp_server.set_port(it->port_cs_);
-        ret = this->worker_->get_rpc_stub().switch_schema(tmp_server,
-            schema, config_.network_timeout);
+        ret = sync_schema_to_server(tmp_server, schema, sync_delta);
         if (OB_SUCCESS == ret)
         {
           TBSYS_LOG(INFO, "sync schema to cs %s, version[%ld]", to_cstring(tmp_server), schema.get_version());
@@ -5165,8 +5392,7 @@ int ObRootServer2::force_sync_schema_all_servers(const ObSchemaManagerV2 &schema
         //hb to ms
         tmp_server = it->server_;
         tmp_server.set_port(it->port_ms_);
-        ret = this->worker_->get_rpc_stub().switch_schema(tmp_server,
-            schema, config_.network_timeout);
+        ret = sync_schema_to_server(tmp_server, schema, sync_delta);
         if (OB_SUCCESS == ret)
         {
           // do nothing
@@ -5183,6 +5409,32 @@ int ObRootServer2::force_sync_schema_all_servers(const ObSchemaManagerV2 &schema
         }
       }
     } //end for
+    // servers missed this version can not apply the next delta, they get
+    // the whole schema instead
+    if (NULL == last_sync_schema_
+        && NULL == (last_sync_schema_ = OB_NEW(ObSchemaManagerV2, ObModIds::OB_RS_SCHEMA_MANAGER)))
+    {
+      TBSYS_LOG(WARN, "fail to new ObSchemaManagerV2, sync the whole schema next time");
+    }
+    else if (NULL != last_sync_schema_)
+    {
+      *last_sync_schema_ = schema;
+    }
   } //end if master
   return ret;
 }
+
+int ObRootServer2::sync_schema_to_server(const ObServer &server, const ObSchemaManagerV2 &schema,
+    const ObSchemaDelta *delta)
+{
+  int ret = OB_SUCCESS;
+  if (NULL != delta)
+  {
+    ret = worker_->get_rpc_stub().switch_schema_delta(server, *delta, config_.network_timeout);
+  }
+  if (NULL == delta || OB_SCHEMA_DELTA_MISMATCH == ret || OB_ERROR_FUNC_VERSION == ret)
+  {
+    ret = worker_->get_rpc_stub().switch_schema(server, schema, config_.network_timeout);
+  }
+  return ret;
+}
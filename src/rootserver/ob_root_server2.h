@@ -26,6 +26,7 @@
 #include "common/ob_schema_table.h"
 #include "common/ob_schema_service.h"
 #include "common/ob_table_id_name.h"
+#include "common/ob_schema_delta.h"
 #include "common/ob_array.h"
 #include "common/ob_timer.h"
 #include "common/ob_tablet_info.h"
@@ -47,6 +48,7 @@
 #include "ob_root_balancer_runnable.h"
 #include "ob_root_ddl_operator.h"
 #include "ob_daily_merge_checker.h"
+#include "ob_merge_scheduler.h"
 #include "ob_heartbeat_checker.h"
 #include "ob_root_server_config.h"
 #include "ob_root_ms_provider.h"
@@ -253,7 +255,7 @@ namespace oceanbase
         int do_stat(int stat_key, char *buf, const int64_t buf_len, int64_t& pos);
         int register_ups(const common::ObServer &addr, int32_t inner_port, int64_t log_seq_num, int64_t lease, const char *server_version_);
         int receive_ups_heartbeat_resp(const common::ObServer &addr, ObUpsStatus stat,
-            const common::ObiRole &obi_role);
+            const common::ObiRole &obi_role, const int64_t memtable_used, const int64_t memtable_limit);
         int ups_slave_failure(const common::ObServer &addr, const common::ObServer &slave_addr);
         int get_ups_list(common::ObUpsList &ups_list);
         int set_ups_config(const common::ObServer &ups, int32_t ms_read_percentage, int32_t cs_read_percentage);
@@ -283,6 +285,13 @@ namespace oceanbase
         int alter_table(common::AlterTableSchema &tschema);
         int drop_tables(const bool if_exists, const common::ObStrings &tables);
         int64_t get_last_frozen_version() const;
+        /// make merge plan for the new frozen version and release its merge groups in time
+        int update_merge_schedule();
+        int64_t get_merge_released_group() const;
+        int serialize_merge_schedule(const int64_t frozen_version,
+            char* buf, const int64_t buf_len, int64_t& pos) const;
+        /// after a merge, mark index tables as built when they have as many rows as their data table
+        int update_index_build_status();
 
         /// check the table exist according the local schema manager
         int check_table_exist(const common::ObString & table_name, bool & exist);
@@ -381,7 +390,12 @@ namespace oceanbase
         int drop_one_table(const bool if_exists, const common::ObString & table_name, bool & refresh);
         /// force sync schema to all servers include ms\cs\master ups
         int force_sync_schema_all_servers(const common::ObSchemaManagerV2 &schema);
+        /// send delta if not NULL, fall back to the whole schema if the server can not apply it
+        int sync_schema_to_server(const common::ObServer &server, const common::ObSchemaManagerV2 &schema,
+            const common::ObSchemaDelta *delta);
         int force_heartbeat_all_servers(void);
+        /// data size from root table and read latency from chunkservers of each table
+        int collect_table_merge_stat(common::ObArray<ObTableMergeStat> &tables);
       private:
         static const int MIN_BALANCE_TOLERANCE = 1;
 
@@ -438,6 +452,7 @@ namespace oceanbase
         // sequence async task queue
         ObRootAsyncTaskQueue seq_task_queue_;
         ObDailyMergeChecker merge_checker_;
+        ObMergeScheduler merge_scheduler_;
         ObHeartbeatChecker heart_beat_checker_;
         // trigger tools
         ObRootMsProvider ms_provider_;
@@ -451,6 +466,9 @@ namespace oceanbase
         //used for cache
         common::ObSchemaManagerV2 * schema_manager_for_cache_;
         mutable tbsys::CRWLock schema_manager_rwlock_;
+        //the last version synced to cs/ms, base of the next schema delta
+        common::ObSchemaManagerV2 * last_sync_schema_;
+        tbsys::CThreadMutex sync_schema_mutex_;
     };
   }
 }
@@ -61,6 +61,11 @@ namespace oceanbase
         DEF_TIME(log_replay_wait_time, "100ms", "log replay wait time");
         DEF_CAP(log_sync_limit, "40MB", "log sync limit");
         DEF_TIME(max_merge_duration_time, "2h", "max merge duration time");
+        DEF_TIME(merge_stagger_window, "0s", "[0s,]", "spread merge of tables over the window after major freeze, 0 to merge all tables at once");
+        DEF_INT(merge_stagger_group_count, "8", "[1,1024]", "number of table groups released one by one in merge stagger window");
+        DEF_INT(merge_stagger_ups_memory_percent, "80", "[1,100]", "release all merge groups when updateserver memtable usage reaches the percent");
+        DEF_CAP(parallel_merge_min_tablet_size, "0", "chunkserver splits compact sstable tablet larger than this into sub ranges merged in parallel, taken when merge plan of a frozen version is made, 0 means disabled");
+        DEF_INT(parallel_merge_sub_range_count, "4", "[2,32]", "number of sub ranges to split a large tablet into for parallel merge");
         DEF_TIME(cs_probation_period, "5s", "duration before cs can adopt migrate");
 
         DEF_TIME(ups_lease_time, "9s", "ups lease time");
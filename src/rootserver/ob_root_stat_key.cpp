@@ -59,6 +59,7 @@ const char* oceanbase::rootserver::OB_RS_STAT_KEYSTR[]=
   "tablet_count",               // 37
   "row_count",                  // 38
   "data_size",                  // 39
+  "migrate_speed",              // 40
   NULL
 };
 
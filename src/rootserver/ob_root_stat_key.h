@@ -62,6 +62,7 @@ namespace oceanbase
       OB_RS_STAT_TABLET_COUNT = 37,
       OB_RS_STAT_ROW_COUNT = 38,
       OB_RS_STAT_DATA_SIZE = 39,
+      OB_RS_STAT_MIGRATE_SPEED = 40,
       OB_RS_STAT_END
     };
 
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include "rootserver/ob_root_table2.h"
 #include "rootserver/ob_chunk_server_manager.h"
+#include "rootserver/ob_merge_scheduler.h"
 #include "common/ob_record_header.h"
 #include "common/file_utils.h"
 #include "common/ob_atomic.h"
@@ -461,6 +462,43 @@ void ObRootTable2::get_tablet_info(int64_t & tablet_count, int64_t & row_count,
   }
 }
 
+int ObRootTable2::get_table_data_size(common::ObArray<ObTableMergeStat> & tables) const
+{
+  int ret = OB_SUCCESS;
+  const common::ObTabletInfo * tablet_info = NULL;
+  ObTableMergeStat stat;
+  tables.clear();
+  if (NULL == tablet_info_manager_)
+  {
+    TBSYS_LOG(WARN, "tablet_info_manager is null");
+    ret = OB_NOT_INIT;
+  }
+  // tablets of one table are adjacent in root table
+  for (int32_t i = 0; OB_SUCCESS == ret && i < meta_table_.get_array_index(); i++)
+  {
+    tablet_info = tablet_info_manager_->get_tablet_info(data_holder_[i].tablet_info_index_);
+    if (NULL != tablet_info)
+    {
+      if (tablet_info->range_.table_id_ != stat.table_id_)
+      {
+        if (OB_INVALID_ID != stat.table_id_)
+        {
+          ret = tables.push_back(stat);
+        }
+        stat = ObTableMergeStat();
+        stat.table_id_ = tablet_info->range_.table_id_;
+      }
+      stat.data_size_ += tablet_info->occupy_size_;
+      stat.row_count_ += tablet_info->row_count_;
+    }
+  }
+  if (OB_SUCCESS == ret && OB_INVALID_ID != stat.table_id_)
+  {
+    ret = tables.push_back(stat);
+  }
+  return ret;
+}
+
 const ObTabletInfo* ObRootTable2::get_tablet_info(const const_iterator& it) const
 {
   int32_t tablet_index = 0;
@@ -22,6 +22,7 @@ namespace oceanbase
   namespace rootserver
   {
     class ObRootServer2;
+    struct ObTableMergeStat;
     class ObRootTable2
     {
       public:
@@ -58,6 +59,8 @@ namespace oceanbase
         void get_cs_version(const int64_t index, int64_t &version);
         //
         void get_tablet_info(int64_t & tablet_count, int64_t & row_count, int64_t & data_size) const;
+        // data size and row count of each table, counted by one replica
+        int get_table_data_size(common::ObArray<ObTableMergeStat> & tables) const;
         // find a proper position for insert operation
         // return SUCCESS when same range found or the proper new pos found for insert
         // return OB_FIND_OUT_OF_RANGE when the proper new pos found for insert is end()
@@ -798,6 +798,7 @@ namespace oceanbase
         case OB_RS_SHUTDOWN_SERVERS:
         case OB_RS_RESTART_SERVERS:
         case OB_RS_CHECK_TABLET_MERGED:
+        case OB_RS_GET_MERGE_SCHEDULE:
         case OB_RS_FORCE_CS_REPORT:
         case OB_RS_SPLIT_TABLET:
         case OB_HANDLE_TRIGGER_EVENT:
@@ -1022,6 +1023,9 @@ namespace oceanbase
                     case OB_RS_CHECK_TABLET_MERGED:
                       return_code = rt_check_tablet_merged(version, *in_buf, req, channel_id, thread_buff);
                       break;
+                    case OB_RS_GET_MERGE_SCHEDULE:
+                      return_code = rt_get_merge_schedule(version, *in_buf, req, channel_id, thread_buff);
+                      break;
                     case OB_FETCH_STATS:
                       return_code = rt_fetch_stats(version, *in_buf, req, channel_id, thread_buff);
                       break;
@@ -1414,7 +1418,9 @@ namespace oceanbase
       }
       if (OB_SUCCESS == ret && OB_SUCCESS == result_msg.result_code_)
       {
-        if ((*get_param)[0]->table_id_ == OB_ALL_SERVER_STAT_TID)
+        // the virtual tables served by every server
+        if ((*get_param)[0]->table_id_ == OB_ALL_SERVER_STAT_TID
+            || (*get_param)[0]->table_id_ == OB_ALL_SLOW_QUERY_TID)
         {
           result_msg.result_code_ = root_server_.find_monitor_table_key(*get_param, *scanner);
         }
@@ -2047,10 +2053,46 @@ namespace oceanbase
           TBSYS_LOG(ERROR, "keep_src.deserialize error");
         }
       }
+      // tablet_seq_num and statistics of the transfer are optional
+      int64_t tablet_seq_num = 0;
+      int64_t migrate_bytes = 0;
+      int64_t migrate_time_us = 0;
+      if (OB_SUCCESS == ret && OB_SUCCESS == result_msg.result_code_
+          && in_buff.get_position() < in_buff.get_capacity())
+      {
+        ret = serialization::decode_vi64(in_buff.get_data(), in_buff.get_capacity(),
+            in_buff.get_position(), &tablet_seq_num);
+        if (ret != OB_SUCCESS)
+        {
+          TBSYS_LOG(ERROR, "tablet_seq_num.deserialize error");
+        }
+      }
+      if (OB_SUCCESS == ret && OB_SUCCESS == result_msg.result_code_
+          && in_buff.get_position() < in_buff.get_capacity())
+      {
+        if (OB_SUCCESS != (ret = serialization::decode_vi64(in_buff.get_data(), in_buff.get_capacity(),
+                in_buff.get_position(), &migrate_bytes)))
+        {
+          TBSYS_LOG(ERROR, "migrate_bytes.deserialize error");
+        }
+        else if (OB_SUCCESS != (ret = serialization::decode_vi64(in_buff.get_data(), in_buff.get_capacity(),
+                in_buff.get_position(), &migrate_time_us)))
+        {
+          TBSYS_LOG(ERROR, "migrate_time_us.deserialize error");
+        }
+      }
       if (OB_SUCCESS == ret && OB_SUCCESS == result_msg.result_code_)
       {
         result_msg.result_code_ = root_server_.migrate_over(range, src_server, dest_server,
             keep_src, tablet_version);
+        if (OB_SUCCESS == result_msg.result_code_ && 0 < migrate_time_us)
+        {
+          OB_STAT_INC(ROOTSERVER, INDEX_MIGRATE_BYTES, migrate_bytes);
+          OB_STAT_INC(ROOTSERVER, INDEX_MIGRATE_TIMEU, migrate_time_us);
+          TBSYS_LOG(INFO, "migrate over, src=%s dest=%s keep_src=%c bytes=%ld time=%ldus speed=%ldKB/s",
+              to_cstring(src_server), to_cstring(dest_server), keep_src ? 'Y' : 'N',
+              migrate_bytes, migrate_time_us, migrate_bytes * 1000000L / 1024 / migrate_time_us);
+        }
       }
       if (OB_SUCCESS == ret)
       {
@@ -2291,6 +2333,57 @@ namespace oceanbase
       return err;
     }
 
+    int ObRootWorker::rt_get_merge_schedule(const int32_t version, common::ObDataBuffer& in_buff,
+        easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff)
+    {
+      static const int MY_VERSION = 1;
+      int err = OB_SUCCESS;
+      common::ObResultCode result_msg;
+      result_msg.result_code_ = OB_SUCCESS;
+      int64_t frozen_version = 0;
+      int64_t pos = 0;
+      if (MY_VERSION != version)
+      {
+        TBSYS_LOG(WARN, "function version not equeal. version=%d, my_version=%d", version, MY_VERSION);
+        result_msg.result_code_ = OB_ERROR_FUNC_VERSION;
+      }
+      else if (OB_SUCCESS != (result_msg.result_code_ = serialization::decode_vi64(in_buff.get_data(),
+              in_buff.get_capacity(), in_buff.get_position(), &frozen_version)))
+      {
+        TBSYS_LOG(WARN, "fail to decode frozen_version, err=%d", result_msg.result_code_);
+      }
+      else
+      {
+        // reserve room for result code, the schedule follows it
+        pos = out_buff.get_position() + result_msg.get_serialize_size();
+        result_msg.result_code_ = root_server_.serialize_merge_schedule(frozen_version,
+            out_buff.get_data(), out_buff.get_capacity(), pos);
+        if (OB_SUCCESS != result_msg.result_code_ && OB_EAGAIN != result_msg.result_code_)
+        {
+          TBSYS_LOG(WARN, "fail to serialize merge schedule, frozen_version=%ld, err=%d",
+              frozen_version, result_msg.result_code_);
+        }
+      }
+      if (OB_SUCCESS != (err = result_msg.serialize(out_buff.get_data(), out_buff.get_capacity(),
+              out_buff.get_position())))
+      {
+        TBSYS_LOG(WARN, "result_msg.serialize error");
+      }
+      else
+      {
+        if (OB_SUCCESS == result_msg.result_code_)
+        {
+          out_buff.get_position() = pos;
+        }
+        err = send_response(OB_RS_GET_MERGE_SCHEDULE_RESPONSE, MY_VERSION, out_buff, req, channel_id);
+        if (OB_SUCCESS != err)
+        {
+          TBSYS_LOG(WARN, "fail to send response. err=%d", err);
+        }
+      }
+      return err;
+    }
+
     int ObRootWorker::rt_dump_cs_info(const int32_t version, common::ObDataBuffer& in_buff,
         easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff)
     {
@@ -3400,7 +3493,8 @@ int ObRootWorker::rt_set_obi_role_to_slave(const int32_t version, common::ObData
         {
           TBSYS_LOG(ERROR, "fatal error, stat=%d", msg.status_);
         }
-        ret = root_server_.receive_ups_heartbeat_resp(msg.addr_, ups_status, msg.obi_role_);
+        ret = root_server_.receive_ups_heartbeat_resp(msg.addr_, ups_status, msg.obi_role_,
+            msg.memtable_used_, msg.memtable_limit_);
       }
       // no response
       easy_request_wakeup(req);
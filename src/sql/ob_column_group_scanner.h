@@ -19,6 +19,7 @@
 #include "common/thread_buffer.h"
 #include "sstable/ob_scan_column_indexes.h"
 #include "sstable/ob_sstable_block_index_v2.h"
+#include "sstable/ob_readahead_window.h"
 #include "ob_sstable_block_scanner.h"
 #include "ob_multi_cg_scanner.h"
 
@@ -193,6 +194,7 @@ namespace oceanbase
         char* block_internal_buffer_;
         int64_t block_internal_bufsiz_;
         sstable::ObBlockPositionInfos index_array_;
+        sstable::ObReadaheadWindow readahead_window_;
 
         // for densense format sstable
         //sstable::ObScanColumnIndexes current_scan_column_indexes_;
@@ -112,3 +112,22 @@ ObPhyOperator *ObDoubleChildrenPhyOperator::get_child(int32_t child_idx) const
   }
   return ret;
 }
+
+int ObDoubleChildrenPhyOperator::replace_child(int32_t child_idx, ObPhyOperator &child_operator)
+{
+  int ret = OB_SUCCESS;
+  if (0 == child_idx && NULL != left_op_)
+  {
+    left_op_ = &child_operator;
+  }
+  else if (1 == child_idx && NULL != right_op_)
+  {
+    right_op_ = &child_operator;
+  }
+  else
+  {
+    ret = OB_INVALID_ARGUMENT;
+    TBSYS_LOG(WARN, "invalid child idx=%d or child not init", child_idx);
+  }
+  return ret;
+}
@@ -31,6 +31,7 @@ namespace oceanbase
         virtual int set_child(int32_t child_idx, ObPhyOperator &child_operator);
         virtual ObPhyOperator *get_child(int32_t child_idx) const;
         virtual int32_t get_child_num() const;
+        virtual int replace_child(int32_t child_idx, ObPhyOperator &child_operator);
         /// open children operators
         virtual int open();
         /// close children operators
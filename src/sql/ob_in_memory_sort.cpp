@@ -15,11 +15,14 @@
  */
 #include "ob_in_memory_sort.h"
 #include "common/ob_row_util.h"
+#include "common/ob_malloc.h"
 using namespace oceanbase::sql;
 using namespace oceanbase::common;
 
+ObSortWorkerPool *ObInMemorySort::worker_pool_ = NULL;
+
 ObInMemorySort::ObInMemorySort()
-  :sort_columns_(NULL), sort_array_get_pos_(0), row_desc_(NULL)
+  :sort_columns_(NULL), sort_array_get_pos_(0), row_desc_(NULL), parallel_degree_(1)
 {
 }
 
@@ -102,15 +105,139 @@ struct ObInMemorySort::Comparer
     const common::ObArray<ObSortColumn> &sort_columns_;
 };
 
+// sort [begin_, end_) of src_ in place if dest_ is NULL,
+// otherwise merge the sorted [begin_, middle_) and [middle_, end_) of src_ into dest_
+struct ObInMemorySort::SortTask: public ObSortWorkerPool::Task
+{
+  const Comparer *comparer_;
+  const common::ObRowStore::StoredRow **src_;
+  const common::ObRowStore::StoredRow **dest_;
+  int64_t begin_;
+  int64_t middle_;
+  int64_t end_;
+
+  SortTask()
+    :comparer_(NULL), src_(NULL), dest_(NULL), begin_(0), middle_(0), end_(0)
+  {
+  }
+  void set(const Comparer *comparer, const common::ObRowStore::StoredRow **src,
+           const common::ObRowStore::StoredRow **dest, const int64_t begin, const int64_t middle, const int64_t end)
+  {
+    comparer_ = comparer;
+    src_ = src;
+    dest_ = dest;
+    begin_ = begin;
+    middle_ = middle;
+    end_ = end;
+  }
+  void run()
+  {
+    if (NULL == dest_)
+    {
+      std::sort(src_ + begin_, src_ + end_, *comparer_);
+    }
+    else
+    {
+      std::merge(src_ + begin_, src_ + middle_, src_ + middle_, src_ + end_, dest_ + begin_, *comparer_);
+    }
+  }
+};
+
+void ObInMemorySort::set_worker_pool(ObSortWorkerPool *pool)
+{
+  worker_pool_ = pool;
+}
+
+void ObInMemorySort::run_sort_tasks(SortTask *tasks, const int64_t task_count)
+{
+  ObSortWorkerPool::Task *task_ptrs[MAX_PARALLEL_DEGREE];
+  for (int64_t i = 0; i < task_count; ++i)
+  {
+    task_ptrs[i] = &tasks[i];
+  }
+  // the calling thread runs the first task and helps with the others
+  worker_pool_->run_tasks(task_ptrs, task_count);
+}
+
+int ObInMemorySort::parallel_sort(const int64_t degree)
+{
+  int ret = OB_SUCCESS;
+  const int64_t count = sort_array_.count();
+  const common::ObRowStore::StoredRow **rows = &sort_array_.at(0);
+  const common::ObRowStore::StoredRow **buf = NULL;
+  Comparer comparer(*sort_columns_);
+  if (NULL == (buf = reinterpret_cast<const common::ObRowStore::StoredRow**>(
+                 ob_malloc(count * sizeof(void*), ObModIds::OB_SQL_SORT))))
+  {
+    TBSYS_LOG(ERROR, "no memory for parallel sort, count=%ld", count);
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    SortTask tasks[MAX_PARALLEL_DEGREE];
+    int64_t bounds[MAX_PARALLEL_DEGREE + 1];
+    int64_t runs = degree;
+    for (int64_t i = 0; i <= runs; ++i)
+    {
+      bounds[i] = count * i / runs;
+    }
+    // 1. sort each run
+    for (int64_t i = 0; i < runs; ++i)
+    {
+      tasks[i].set(&comparer, rows, NULL, bounds[i], bounds[i + 1], bounds[i + 1]);
+    }
+    run_sort_tasks(tasks, runs);
+    // 2. merge runs pairwise between rows and buf until one run left
+    const common::ObRowStore::StoredRow **src = rows;
+    const common::ObRowStore::StoredRow **dest = buf;
+    while (runs > 1)
+    {
+      int64_t merged_runs = 0;
+      for (int64_t i = 0; i < runs; i += 2)
+      {
+        // the odd one is merged with an empty run, i.e. copied
+        int64_t end = (i + 1 < runs) ? bounds[i + 2] : bounds[i + 1];
+        tasks[merged_runs].set(&comparer, src, dest, bounds[i], bounds[i + 1], end);
+        bounds[merged_runs++] = bounds[i];
+      }
+      bounds[merged_runs] = count;
+      run_sort_tasks(tasks, merged_runs);
+      runs = merged_runs;
+      std::swap(src, dest);
+    }
+    if (src != rows)
+    {
+      memcpy(rows, src, count * sizeof(void*));
+    }
+    ob_free(buf);
+  }
+  return ret;
+}
+
 int ObInMemorySort::sort_rows()
 {
   int ret = OB_SUCCESS;
   OB_ASSERT(sort_columns_);
   if (0 < sort_array_.count())
   {
-    TBSYS_LOG(DEBUG, "sort rows, count=%ld", sort_array_.count());
-    const common::ObRowStore::StoredRow **first_row = &sort_array_.at(0);
-    std::sort(first_row, first_row+sort_array_.count(), Comparer(*sort_columns_));
+    int64_t degree = std::min(parallel_degree_, sort_array_.count() / MIN_ROWS_PER_SORT_TASK);
+    // the calling thread runs one task besides the threads of the pool
+    const int64_t max_degree = (NULL == worker_pool_) ? 1 : worker_pool_->get_thread_num() + 1;
+    if (degree > max_degree)
+    {
+      degree = max_degree;
+    }
+    if (degree > MAX_PARALLEL_DEGREE)
+    {
+      degree = MAX_PARALLEL_DEGREE;
+    }
+    TBSYS_LOG(DEBUG, "sort rows, count=%ld degree=%ld", sort_array_.count(), degree);
+    if (1 >= degree || OB_SUCCESS != parallel_sort(degree))
+    {
+      // few rows, no worker pool, or no memory for the merge buffer
+      const common::ObRowStore::StoredRow **first_row = &sort_array_.at(0);
+      std::sort(first_row, first_row+sort_array_.count(), Comparer(*sort_columns_));
+    }
   }
   return ret;
 }
@@ -20,6 +20,7 @@
 #include "common/ob_object.h"
 #include "common/ob_row.h"
 #include "ob_sort_helper.h"
+#include "ob_sort_worker_pool.h"
 #include "common/ob_row_store.h"
 
 namespace oceanbase
@@ -51,6 +52,8 @@ namespace oceanbase
         void reset();
         int add_row(const common::ObRow &row);
         int sort_rows();
+        /// sort with up to degree threads when there are enough rows, 1 by default
+        void set_parallel_degree(const int64_t degree);
 
         // @pre sort_rows()
         virtual int get_next_row(const common::ObRow *&row);
@@ -60,13 +63,23 @@ namespace oceanbase
 
         int64_t get_row_count() const;
         int64_t get_used_mem_size() const;
+      public:
+        static const int64_t MAX_PARALLEL_DEGREE = 64;
+        static const int64_t MIN_ROWS_PER_SORT_TASK = 32 * 1024;
+        /// threads shared by all the sorts in this process, sort in the
+        /// calling thread only if not set
+        static void set_worker_pool(ObSortWorkerPool *pool);
       private:
         // types
         struct Comparer;
+        struct SortTask;
       private:
         // disallow copy
         ObInMemorySort(const ObInMemorySort &other);
         ObInMemorySort& operator=(const ObInMemorySort &other);
+        // function members
+        int parallel_sort(const int64_t degree);
+        static void run_sort_tasks(SortTask *tasks, const int64_t task_count);
       private:
         // data members
         const common::ObArray<ObSortColumn> *sort_columns_;
@@ -75,12 +88,19 @@ namespace oceanbase
         int64_t sort_array_get_pos_;
         common::ObRow curr_row_;
         const common::ObRowDesc *row_desc_;
+        int64_t parallel_degree_;
+        static ObSortWorkerPool *worker_pool_;
     };
 
     inline const common::ObRowDesc* ObInMemorySort::get_row_desc() const
     {
       return row_desc_;
     }
+
+    inline void ObInMemorySort::set_parallel_degree(const int64_t degree)
+    {
+      parallel_degree_ = degree;
+    }
   } // end namespace sql
 } // end namespace oceanbase
 
@@ -38,6 +38,7 @@ namespace oceanbase
         virtual int close();
         virtual int get_next_row(const common::ObRow *&row);
         virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
+        virtual int64_t get_used_mem_size() const;
         // used by ScalarAggregate operator when there's no input rows
         int get_row_for_empty_set(const ObRow *&row);
         void assign(const ObMergeGroupBy& other);
@@ -61,6 +62,11 @@ namespace oceanbase
       aggr_func_.set_int_div_as_double(did);
     }
 
+    inline int64_t ObMergeGroupBy::get_used_mem_size() const
+    {
+      return aggr_func_.get_used_mem_size();
+    }
+
     inline int ObMergeGroupBy::get_row_for_empty_set(const ObRow *&row)
     {
       return aggr_func_.get_result_for_empty_set(row);
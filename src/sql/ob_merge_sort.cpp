@@ -221,7 +221,7 @@ int ObMergeSort::build_merge_heap()
   }
   if (OB_SUCCESS == ret)
   {
-    OB_ASSERT(2 <= heap_array_.count());
+    OB_ASSERT(1 <= heap_array_.count());
     OB_ASSERT(sort_columns_);
     TBSYS_LOG(INFO, "build merge heap, size=%ld sort_columns_count=%ld",
               heap_array_.count(), sort_columns_->count());
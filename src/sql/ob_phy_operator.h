@@ -45,6 +45,20 @@ namespace oceanbase
           return 0;
         }
 
+        /// 替换已设置的子运算符，用于在计划中插入ObProfileOperator，不支持的运算符返回OB_NOT_SUPPORTED
+        virtual int replace_child(int32_t child_idx, ObPhyOperator &child_operator)
+        {
+          UNUSED(child_idx);
+          UNUSED(child_operator);
+          return common::OB_NOT_SUPPORTED;
+        }
+
+        /// 运算符当前占用的内存，用于统计查询的内存峰值
+        virtual int64_t get_used_mem_size() const
+        {
+          return 0;
+        }
+
         virtual enum ObPhyOperatorType get_type() const
         {
           return PHY_INVALID;
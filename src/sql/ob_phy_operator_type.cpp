@@ -57,6 +57,7 @@ namespace oceanbase
         DEF_OP(PHY_EMPTY_ROW_FILTER);
         DEF_OP(PHY_EXPR_VALUES);
         DEF_OP(PHY_UPS_EXECUTOR);
+        DEF_OP(PHY_PROFILE);
         default:
           break;
       }
@@ -44,6 +44,7 @@ namespace oceanbase
       PHY_EMPTY_ROW_FILTER,
       PHY_EXPR_VALUES,
       PHY_UPS_EXECUTOR,
+      PHY_PROFILE,
 
       PHY_END /* end of phy operator type */
     };
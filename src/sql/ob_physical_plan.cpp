@@ -17,6 +17,7 @@
 #include "common/utility.h"
 #include "ob_table_rpc_scan.h"
 #include "ob_mem_sstable_scan.h"
+#include "ob_table_scan.h"
 #include "common/serialization.h"
 #include "ob_phy_operator_factory.h"
 
@@ -32,7 +33,8 @@ ObPhysicalPlan::ObPhysicalPlan()
    allocator_(NULL),
    op_factory_(NULL),
    my_result_set_(NULL),
-   start_trans_(false)
+   start_trans_(false),
+   profiled_(false)
 {
 }
 
@@ -114,6 +116,123 @@ int ObPhysicalPlan::remove_phy_query(ObPhyOperator *phy_query)
   return ret;
 }
 
+int ObPhysicalPlan::add_profile_operators()
+{
+  int ret = OB_SUCCESS;
+  ObPhyOperator *wrapper = NULL;
+  if (profiled_ || NULL == main_query_)
+  {
+    // nothing to do
+  }
+  else if (OB_SUCCESS != (ret = add_profile_operator(*main_query_, 0, wrapper)))
+  {
+    // put the original operators back, the plan is left unprofiled
+    TBSYS_LOG(WARN, "fail to add profile operators:ret[%d]", ret);
+    remove_profile_operators(*main_query_);
+  }
+  else
+  {
+    for (int32_t i = 0; i < phy_querys_.count(); ++i)
+    {
+      if (main_query_ == phy_querys_.at(i))
+      {
+        phy_querys_.at(i) = wrapper;
+      }
+    }
+    main_query_ = wrapper;
+    profiled_ = true;
+  }
+  return ret;
+}
+
+int ObPhysicalPlan::add_profile_operator(ObPhyOperator &op, const int32_t depth, ObPhyOperator *&wrapper)
+{
+  int ret = OB_SUCCESS;
+  ObPhyOperator *child = NULL;
+  ObPhyOperator *child_wrapper = NULL;
+  ObProfileOperator *profile_op = NULL;
+  void *ptr = NULL;
+  // table scans build their children when opened, they are profiled as a whole
+  if (NULL == dynamic_cast<ObTableScan*>(&op))
+  {
+    for (int32_t i = 0; OB_SUCCESS == ret && i < op.get_child_num(); ++i)
+    {
+      if (NULL == (child = op.get_child(i)))
+      {
+        // child not set
+      }
+      else if (OB_SUCCESS != (ret = add_profile_operator(*child, depth + 1, child_wrapper)))
+      {
+        TBSYS_LOG(WARN, "fail to add profile operator:ret[%d] depth[%d]", ret, depth + 1);
+      }
+      else if (OB_SUCCESS != (ret = op.replace_child(i, *child_wrapper)))
+      {
+        TBSYS_LOG(WARN, "fail to replace child:ret[%d] type[%s]", ret, ob_phy_operator_type_str(op.get_type()));
+      }
+    }
+  }
+  if (OB_SUCCESS == ret
+      && NULL == (ptr = ob_malloc(sizeof(ObProfileOperator), ObModIds::OB_SQL_PHY_PLAN)))
+  {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    TBSYS_LOG(WARN, "no memory for profile operator");
+  }
+  if (OB_SUCCESS == ret)
+  {
+    profile_op = new(ptr) ObProfileOperator();
+    ob_inc_phy_operator_stat(PHY_PROFILE);
+    if (OB_SUCCESS != (ret = profile_operators_.push_back(profile_op)))
+    {
+      TBSYS_LOG(WARN, "fail to store profile operator:ret[%d]", ret);
+      ob_dec_phy_operator_stat(PHY_PROFILE);
+      profile_op->~ObProfileOperator();
+      ob_free(ptr, ObModIds::OB_SQL_PHY_PLAN);
+    }
+    else if (OB_SUCCESS != (ret = profile_op->init(op, depth)))
+    {
+      TBSYS_LOG(WARN, "fail to init profile operator:ret[%d]", ret);
+    }
+    else
+    {
+      profile_op->set_phy_plan(this);
+      wrapper = profile_op;
+    }
+  }
+  return ret;
+}
+
+void ObPhysicalPlan::remove_profile_operators(ObPhyOperator &op)
+{
+  ObPhyOperator *child = NULL;
+  ObPhyOperator *origin = NULL;
+  if (NULL == dynamic_cast<ObTableScan*>(&op))
+  {
+    for (int32_t i = 0; i < op.get_child_num(); ++i)
+    {
+      if (NULL == (child = op.get_child(i)))
+      {
+        // child not set
+      }
+      else if (PHY_PROFILE != child->get_type())
+      {
+        remove_profile_operators(*child);
+      }
+      else if (NULL == (origin = child->get_child(0)))
+      {
+        TBSYS_LOG(ERROR, "profile operator without child, type[%s]", ob_phy_operator_type_str(op.get_type()));
+      }
+      else if (OB_SUCCESS != op.replace_child(i, *origin))
+      {
+        TBSYS_LOG(ERROR, "fail to restore child, type[%s]", ob_phy_operator_type_str(op.get_type()));
+      }
+      else
+      {
+        remove_profile_operators(*origin);
+      }
+    }
+  }
+}
+
 int64_t ObPhysicalPlan::to_string(char* buf, const int64_t buf_len) const
 {
   int64_t pos = 0;
@@ -17,6 +17,7 @@
 #define _OB_PHYSICAL_PLAN_H
 #include "ob_phy_operator.h"
 #include "ob_phy_operator_factory.h"
+#include "ob_profile_operator.h"
 #include "common/ob_vector.h"
 #include "common/page_arena.h"
 #include "common/ob_transaction.h"
@@ -79,6 +80,12 @@ namespace oceanbase
         void set_start_trans(bool did_start) {start_trans_ = did_start;};
         bool get_start_trans() const {return start_trans_;};
         common::ObTransReq& get_trans_req() {return start_trans_req_;};
+        /**
+         * wrap every operator of the main query with an ObProfileOperator,
+         * the plan must only be executed locally afterwards
+         */
+        int add_profile_operators();
+        bool is_profiled() const {return profiled_;};
         NEED_SERIALIZE_AND_DESERIALIZE;
 
       private:
@@ -86,12 +93,15 @@ namespace oceanbase
         static const int64_t COMMON_SUB_QUERY_NUM = 6;
         typedef oceanbase::common::ObSEArray<ObPhyOperator*, COMMON_OP_NUM> OperatorStore;
         typedef oceanbase::common::ObSEArray<ObPhyOperator*, COMMON_SUB_QUERY_NUM> SubQueries;
+        typedef oceanbase::common::ObSEArray<ObProfileOperator*, COMMON_OP_NUM> ProfileOperators;
       private:
         DISALLOW_COPY_AND_ASSIGN(ObPhysicalPlan);
         ObPhyOperator* get_phy_operator(int64_t index) const;
         int64_t get_operator_size() const { return operators_store_.count(); }
         int deserialize_tree(const char *buf, int64_t data_len, int64_t &pos, common::ModuleArena &allocator, OperatorStore &operators_store, ObPhyOperator *&root);
         int serialize_tree(char *buf, int64_t buf_len, int64_t &pos, const ObPhyOperator &root) const;
+        int add_profile_operator(ObPhyOperator &op, const int32_t depth, ObPhyOperator *&wrapper);
+        void remove_profile_operators(ObPhyOperator &op);
 
       private:
         common::ObTransID trans_id_;
@@ -105,6 +115,9 @@ namespace oceanbase
         ObResultSet *my_result_set_; // The result set who owns this physical plan
         bool start_trans_;
         common::ObTransReq start_trans_req_;
+        // not allocated from allocator_, which is not set on mergeserver
+        ProfileOperators profile_operators_;
+        bool profiled_;
     };
 
     inline int ObPhysicalPlan::set_operator_factory(ObPhyOperatorFactory* factory)
@@ -143,6 +156,15 @@ namespace oceanbase
         operators_store_.at(i) = NULL;
       }
       operators_store_.clear();
+
+      for(int32_t i = 0; i < profile_operators_.count(); i++)
+      {
+        ob_dec_phy_operator_stat(PHY_PROFILE);
+        profile_operators_.at(i)->~ObProfileOperator();
+        common::ob_free(profile_operators_.at(i), common::ObModIds::OB_SQL_PHY_PLAN);
+      }
+      profile_operators_.clear();
+      profiled_ = false;
     }
 
     inline const common::ObTransID& ObPhysicalPlan::get_trans_id() const
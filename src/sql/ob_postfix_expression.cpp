@@ -1298,6 +1298,141 @@ namespace oceanbase
       return is_simple_expr;
     }
 
+    inline void ObPostfixExpression::get_const_value(bool real_val, const int64_t idx, ObObj &value) const
+    {
+      if (real_val && ObExtendType == expr_.at(idx).get_type()) // question mark
+      {
+        int64_t obj_addr = common::OB_INVALID_ID;
+        expr_.at(idx).get_ext(obj_addr);
+        value = *(reinterpret_cast<ObObj *>(obj_addr));
+      }
+      else
+      {
+        value = expr_.at(idx);
+      }
+    }
+
+    bool ObPostfixExpression::is_simple_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const
+    {
+      return is_simple_in_value_list(real_val, column_id, values)
+        || is_simple_or_value_list(real_val, column_id, values);
+    }
+
+    // (c) in ((v1), (v2), ...)
+    // COLUMN_IDX tid cid | OP ROW 1 | OP LEFT_PARAM_END 2 | {CONST v | OP ROW 1} * n | OP ROW n | OP IN 2 | END
+    bool ObPostfixExpression::is_simple_in_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const
+    {
+      bool is_value_list = false;
+      int64_t len = expr_.count();
+      int64_t row_count = 0;
+      int64_t cid = OB_INVALID_ID;
+      ObObj value;
+      if (len > 16 && (len - 16) % 5 == 0)
+      {
+        row_count = (len - 16) / 5;
+        if (!ExprUtil::is_column_idx(expr_.at(0)) || OB_SUCCESS != expr_.at(2).get_int(cid)
+            || !ExprUtil::is_op(expr_.at(3)) || !ExprUtil::is_op_of_type(expr_.at(4), T_OP_ROW)
+            || !ExprUtil::is_value(expr_.at(5), 1L)
+            || !ExprUtil::is_op(expr_.at(6)) || !ExprUtil::is_op_of_type(expr_.at(7), T_OP_LEFT_PARAM_END)
+            || !ExprUtil::is_value(expr_.at(8), 2L))
+        {
+          // not single column in
+        }
+        else if (!ExprUtil::is_op(expr_.at(len - 7)) || !ExprUtil::is_op_of_type(expr_.at(len - 6), T_OP_ROW)
+            || !ExprUtil::is_value(expr_.at(len - 5), row_count)
+            || !ExprUtil::is_op(expr_.at(len - 4)) || !ExprUtil::is_op_of_type(expr_.at(len - 3), T_OP_IN)
+            || !ExprUtil::is_value(expr_.at(len - 2), 2L) || !ExprUtil::is_end(expr_.at(len - 1)))
+        {
+          // not single column in
+        }
+        else
+        {
+          is_value_list = true;
+          values.clear();
+          for (int64_t row = 0; row < row_count; row++)
+          {
+            const int64_t offset = 9 + row * 5; // CONST v, OP ROW 1
+            if (!ExprUtil::is_const_obj(expr_.at(offset)) || !ExprUtil::is_op(expr_.at(offset + 2))
+                || !ExprUtil::is_op_of_type(expr_.at(offset + 3), T_OP_ROW) || !ExprUtil::is_value(expr_.at(offset + 4), 1L))
+            {
+              is_value_list = false;
+              break;
+            }
+            get_const_value(real_val, offset + 1, value);
+            if (OB_SUCCESS != values.push_back(value))
+            {
+              is_value_list = false;
+              break;
+            }
+          }
+          column_id = static_cast<uint64_t>(cid);
+        }
+      }
+      return is_value_list;
+    }
+
+    // c = v1 or c = v2 or ...
+    // {COLUMN_IDX tid cid | CONST v | OP EQ 2} and (OP OR 2) in any valid postfix order, then END
+    bool ObPostfixExpression::is_simple_or_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const
+    {
+      bool is_value_list = true;
+      int64_t len = expr_.count();
+      int64_t idx = 0;
+      int64_t depth = 0;
+      int64_t cid = OB_INVALID_ID;
+      int64_t first_cid = OB_INVALID_ID;
+      ObObj value;
+      values.clear();
+      if (len < (8 * 2 + 3 + 1) || !ExprUtil::is_end(expr_.at(len - 1)))
+      {
+        is_value_list = false;
+      }
+      while (is_value_list && idx < len - 1)
+      {
+        if (ExprUtil::is_column_idx(expr_.at(idx)))
+        {
+          if (idx + 8 > len - 1 || OB_SUCCESS != expr_.at(idx + 2).get_int(cid)
+              || !ExprUtil::is_const_obj(expr_.at(idx + 3)) || !ExprUtil::is_op(expr_.at(idx + 5))
+              || !ExprUtil::is_op_of_type(expr_.at(idx + 6), T_OP_EQ) || !ExprUtil::is_value(expr_.at(idx + 7), 2L)
+              || (values.count() > 0 && first_cid != cid))
+          {
+            is_value_list = false;
+          }
+          else
+          {
+            first_cid = cid;
+            get_const_value(real_val, idx + 4, value);
+            if (OB_SUCCESS != values.push_back(value))
+            {
+              is_value_list = false;
+            }
+            depth++;
+            idx += 8;
+          }
+        }
+        else if (idx + 3 <= len - 1 && ExprUtil::is_op(expr_.at(idx))
+            && ExprUtil::is_op_of_type(expr_.at(idx + 1), T_OP_OR) && ExprUtil::is_value(expr_.at(idx + 2), 2L)
+            && depth >= 2)
+        {
+          depth--;
+          idx += 3;
+        }
+        else
+        {
+          is_value_list = false;
+        }
+      }
+      if (is_value_list && 1 == depth && values.count() >= 2)
+      {
+        column_id = static_cast<uint64_t>(first_cid);
+      }
+      else
+      {
+        is_value_list = false;
+      }
+      return is_value_list;
+    }
+
     DEFINE_DESERIALIZE(ObPostfixExpression)
     {
       int ret = OB_SUCCESS;
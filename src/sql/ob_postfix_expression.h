@@ -328,6 +328,11 @@ namespace oceanbase
         bool is_simple_between(bool real_val, uint64_t &column_id, int64_t &cond_op, ObObj &cond_start, ObObj &cond_end) const;
         bool is_simple_in_expr(const ObRowkeyInfo &info, ObArray<ObRowkey> &rowkey_array, 
             common::PageArena<ObObj,common::ModulePageAllocator> &allocator) const; 
+        /*
+         * 单列的等值列表：c in (v1, v2, ...) 或者 c = v1 or c = v2 or ...
+         * 用于在rowkey前缀上展开多个scan range
+         */
+        bool is_simple_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const;
         static const char *get_sys_func_name(enum ObSqlSysFunc func_id);
         static int get_sys_func_param_num(const common::ObString& name, int32_t& param_num);
         // print the postfix expression
@@ -354,6 +359,9 @@ namespace oceanbase
           static inline bool is_value(const ObObj &obj, int64_t value);
           static inline bool is_op_of_type(const ObObj &obj, ObItemType type);
         };
+        inline void get_const_value(bool real_val, const int64_t idx, ObObj &value) const;
+        bool is_simple_in_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const;
+        bool is_simple_or_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const;
       private:
         ObPostfixExpression(const ObPostfixExpression &other);
         static inline int nop_func(ObExprObj *stack_i, int &idx_i, ObExprObj &result, const ObPostExprExtraParams &params);
@@ -0,0 +1,214 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_profile_operator.cpp
+ *
+ */
+
+#include "ob_profile_operator.h"
+#include <cxxabi.h>
+#include <typeinfo>
+#include "common/utility.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace sql;
+
+ObProfileOperator::ObProfileOperator()
+  : depth_(0), query_seq_(0), row_seq_(0), profile_(NULL)
+{
+  name_[0] = '\0';
+}
+
+ObProfileOperator::~ObProfileOperator()
+{
+}
+
+int ObProfileOperator::init(ObPhyOperator &child_op, const int32_t depth)
+{
+  int ret = OB_SUCCESS;
+  int status = 0;
+  char *demangled = NULL;
+  const char *name = typeid(child_op).name();
+  if (OB_SUCCESS != (ret = set_child(0, child_op)))
+  {
+    TBSYS_LOG(WARN, "fail to set child:ret[%d]", ret);
+  }
+  else
+  {
+    depth_ = depth;
+    if (NULL != (demangled = abi::__cxa_demangle(name, NULL, NULL, &status)))
+    {
+      name = demangled;
+    }
+    // oceanbase::sql::ObSort => ObSort
+    const char *last = strrchr(name, ':');
+    snprintf(name_, sizeof(name_), "%s", NULL == last ? name : last + 1);
+    if (NULL != demangled)
+    {
+      free(demangled);
+    }
+  }
+  return ret;
+}
+
+int ObProfileOperator::open()
+{
+  int ret = OB_SUCCESS;
+  ObQueryProfile *query_profile = ObQueryProfile::get_current();
+  int64_t start_time = 0;
+  int64_t start_cpu_time = 0;
+  if (NULL == query_profile)
+  {
+    profile_ = NULL;
+    query_seq_ = 0;
+  }
+  else if (query_profile->get_seq() != query_seq_)
+  {
+    profile_ = query_profile->add_operator(name_, depth_);
+    query_seq_ = query_profile->get_seq();
+  }
+  if (NULL == profile_)
+  {
+    ret = ObSingleChildPhyOperator::open();
+  }
+  else
+  {
+    start_time = tbsys::CTimeUtil::getTime();
+    start_cpu_time = ObQueryProfile::get_thread_cpu_time();
+    ret = ObSingleChildPhyOperator::open();
+    profile_->wall_time_ += tbsys::CTimeUtil::getTime() - start_time;
+    profile_->cpu_time_ += ObQueryProfile::get_thread_cpu_time() - start_cpu_time;
+    update_mem_hwm_();
+  }
+  return ret;
+}
+
+int ObProfileOperator::close()
+{
+  int ret = OB_SUCCESS;
+  int64_t start_time = 0;
+  int64_t start_cpu_time = 0;
+  if (NULL == profile_)
+  {
+    ret = ObSingleChildPhyOperator::close();
+  }
+  else
+  {
+    // 关闭前算子还持有全部内存
+    update_mem_hwm_();
+    start_time = tbsys::CTimeUtil::getTime();
+    start_cpu_time = ObQueryProfile::get_thread_cpu_time();
+    ret = ObSingleChildPhyOperator::close();
+    profile_->wall_time_ += tbsys::CTimeUtil::getTime() - start_time;
+    profile_->cpu_time_ += ObQueryProfile::get_thread_cpu_time() - start_cpu_time;
+  }
+  return ret;
+}
+
+int ObProfileOperator::get_next_row(const common::ObRow *&row)
+{
+  int ret = OB_SUCCESS;
+  int64_t start_time = 0;
+  if (NULL == child_op_)
+  {
+    ret = OB_NOT_INIT;
+  }
+  else if (NULL == profile_)
+  {
+    ret = child_op_->get_next_row(row);
+  }
+  else
+  {
+    if (0 == (row_seq_++ % ROW_SAMPLE_INTERVAL))
+    {
+      start_time = tbsys::CTimeUtil::getTime();
+      ret = child_op_->get_next_row(row);
+      profile_->wall_time_ += (tbsys::CTimeUtil::getTime() - start_time) * ROW_SAMPLE_INTERVAL;
+    }
+    else
+    {
+      ret = child_op_->get_next_row(row);
+    }
+    if (OB_SUCCESS == ret)
+    {
+      profile_->rows_out_++;
+    }
+    else if (OB_ITER_END == ret)
+    {
+      update_mem_hwm_();
+    }
+  }
+  return ret;
+}
+
+void ObProfileOperator::update_mem_hwm_()
+{
+  int64_t mem_size = get_used_mem_size();
+  if (NULL != profile_ && mem_size > profile_->mem_hwm_)
+  {
+    profile_->mem_hwm_ = mem_size;
+  }
+}
+
+int ObProfileOperator::get_row_desc(const common::ObRowDesc *&row_desc) const
+{
+  int ret = OB_SUCCESS;
+  if (NULL == child_op_)
+  {
+    ret = OB_NOT_INIT;
+  }
+  else
+  {
+    ret = child_op_->get_row_desc(row_desc);
+  }
+  return ret;
+}
+
+int64_t ObProfileOperator::get_used_mem_size() const
+{
+  return NULL == child_op_ ? 0 : child_op_->get_used_mem_size();
+}
+
+int64_t ObProfileOperator::to_string(char* buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  if (NULL != child_op_)
+  {
+    pos = child_op_->to_string(buf, buf_len);
+  }
+  return pos;
+}
+
+enum ObPhyOperatorType ObProfileOperator::get_type() const
+{
+  return PHY_PROFILE;
+}
+
+DEFINE_SERIALIZE(ObProfileOperator)
+{
+  UNUSED(buf);
+  UNUSED(buf_len);
+  UNUSED(pos);
+  // 只在mergeserver本地执行，不会被序列化
+  return OB_NOT_SUPPORTED;
+}
+
+DEFINE_DESERIALIZE(ObProfileOperator)
+{
+  UNUSED(buf);
+  UNUSED(data_len);
+  UNUSED(pos);
+  return OB_NOT_SUPPORTED;
+}
+
+DEFINE_GET_SERIALIZE_SIZE(ObProfileOperator)
+{
+  return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_profile_operator.h
+ *
+ * 插在物理计划每个算子之上，把被包装算子的行数、耗时和内存
+ * 记入当前线程的ObQueryProfile，不改变计划的输出
+ *
+ */
+
+#ifndef _OB_PROFILE_OPERATOR_H
+#define _OB_PROFILE_OPERATOR_H 1
+
+#include "ob_single_child_phy_operator.h"
+#include "common/ob_query_profile.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    class ObProfileOperator : public ObSingleChildPhyOperator
+    {
+      public:
+        ObProfileOperator();
+        virtual ~ObProfileOperator();
+        /// 包装child_op，depth为child_op在计划中的深度，根为0
+        int init(ObPhyOperator &child_op, const int32_t depth);
+
+        int open();
+        int close();
+        int get_next_row(const common::ObRow *&row);
+        int get_row_desc(const common::ObRowDesc *&row_desc) const;
+        int64_t get_used_mem_size() const;
+        /// 打印被包装的算子，explain的输出不变
+        int64_t to_string(char* buf, const int64_t buf_len) const;
+        enum ObPhyOperatorType get_type() const;
+
+        NEED_SERIALIZE_AND_DESERIALIZE;
+
+      private:
+        // 每ROW_SAMPLE_INTERVAL行取一行计时，按比例估算get_next_row的耗时
+        static const int64_t ROW_SAMPLE_INTERVAL = 64;
+        void update_mem_hwm_();
+
+      private:
+        char name_[common::ObOperatorProfile::MAX_NAME_LENGTH];
+        int32_t depth_;
+        // 同一次执行中算子可能被多次open，沿用第一次open时分到的槽位
+        int64_t query_seq_;
+        int64_t row_seq_;
+        common::ObOperatorProfile *profile_;
+    };
+  }
+}
+
+#endif /* _OB_PROFILE_OPERATOR_H */
@@ -19,6 +19,7 @@
 #include "parse_malloc.h"
 #include "ob_sql_session_info.h"
 #include "common/ob_trace_log.h"
+#include "common/ob_query_profile.h"
 using namespace oceanbase::sql;
 using namespace oceanbase::common;
 
@@ -69,6 +70,12 @@ int ObResultSet::open()
     OB_ASSERT(my_session_);
     FILL_TRACE_LOG("curr_frozen_version=%s", to_cstring(my_session_->get_frozen_version()));
     physical_plan_->set_curr_frozen_version(my_session_->get_frozen_version());
+    if (NULL != ObQueryProfile::get_current() && ObBasicStmt::T_SELECT == stmt_type_
+        && !physical_plan_->is_profiled()
+        && OB_SUCCESS != physical_plan_->add_profile_operators())
+    {
+      TBSYS_LOG(WARN, "fail to profile physical plan, the query is executed without profile");
+    }
     ObPhyOperator *rt = physical_plan_->get_main_query();
     ret = rt->open();
   }
@@ -112,7 +119,7 @@ void ObResultSet::set_statement_name(const common::ObString name)
   statement_name_ = name;
 }
 
-int ObResultSet::pre_assign_params_room(const int64_t& size, common::StackAllocator &alloc)
+int ObResultSet::pre_assign_params_room(const int64_t& size, common::ObIAllocator &alloc)
 {
   int ret = OB_SUCCESS;
   ObObj *place_holder = NULL;
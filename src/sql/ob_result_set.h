@@ -96,7 +96,7 @@ namespace oceanbase
         int reset();
         int add_field_column(const Field & field);
         int add_param_column(const Field & field);
-        int pre_assign_params_room(const int64_t& size, common::StackAllocator &alloc);
+        int pre_assign_params_room(const int64_t& size, common::ObIAllocator &alloc);
         int fill_params(const common::ObArray<obmysql::EMySQLFieldType>& types,
                         const common::ObArray<common::ObObj>& values);
         int from_prepared(const ObResultSet& stored_result_set);
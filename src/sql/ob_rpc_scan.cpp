@@ -15,6 +15,7 @@
  *   Yu Huang <xiaochu.yh@taobao.com>
  *
  */
+#include <algorithm>
 #include "ob_rpc_scan.h"
 #include "common/ob_tsi_factory.h"
 #include "common/ob_obj_cast.h"
@@ -43,7 +44,13 @@ ObRpcScan::ObRpcScan() :
   table_id_(OB_INVALID_ID),
   base_table_id_(OB_INVALID_ID),
   start_key_buf_(NULL),
-  end_key_buf_(NULL)
+  end_key_buf_(NULL),
+  cur_scan_range_idx_(0),
+  scan_range_objs_allocator_(PageArena<ObObj, ModulePageAllocator>::DEFAULT_PAGE_SIZE,
+      ModulePageAllocator(ObModIds::OB_SQL_RPC_SCAN)),
+  index_lookup_(NULL),
+  lookup_source_end_(false),
+  lookup_end_(false)
 {
   sql_read_strategy_.set_rowkey_info(rowkey_info_);
 }
@@ -233,7 +240,7 @@ int ObRpcScan::create_scan_param(ObSqlScanParam &scan_param)
   }
   int64_t end_create_scan_param = tbsys::CTimeUtil::getTime();
   PROFILE_LOG(DEBUG, CREATE_SCAN_PARAM, end_create_scan_param - start_create_scan_param);
-  TBSYS_LOG(INFO, "dump scan range: %s", to_cstring(range));
+  TBSYS_LOG(INFO, "dump scan range: %s, range_count=%ld", to_cstring(range), scan_ranges_.count());
   TBSYS_LOG(DEBUG, "scan_param=%s", to_cstring(scan_param));
   return ret;
 }
@@ -284,6 +291,10 @@ int ObRpcScan::fill_read_param(ObSqlReadParam &dest_param)
   if (OB_SUCCESS == ret)
   {
     dest_param.set_is_result_cached(true);
+    if (NULL != merge_service_)
+    {
+      dest_param.set_accept_compact_row(merge_service_->get_config().accept_compact_row);
+    }
     if (OB_SUCCESS != (ret = dest_param.set_table_id(table_id_, base_table_id_)))
     {
       TBSYS_LOG(WARN, "fail to set table id and scan range. ret=%d", ret);
@@ -378,8 +389,26 @@ int ObRpcScan::open()
     int64_t end_cons_scan = tbsys::CTimeUtil::getTime();
     PROFILE_LOG(DEBUG, CONS_SQL_SCAN_REQUEST, end_cons_scan - start_cons_scan);
   }
+  // Get by rowkeys from index table
+  if (OB_SUCCESS == ret && hint_.read_method_ == ObSqlReadStrategy::USE_GET && NULL != index_lookup_)
+  {
+    lookup_source_end_ = false;
+    lookup_end_ = false;
+    if (OB_SUCCESS != (ret = index_lookup_->open()))
+    {
+      TBSYS_LOG(WARN, "fail to open index lookup. ret=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = fill_read_param(*get_param_)))
+    {
+      TBSYS_LOG(WARN, "fail to fill read param to get param. ret=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = open_next_lookup_batch()))
+    {
+      TBSYS_LOG(WARN, "fail to open first lookup batch. ret=%d", ret);
+    }
+  }
   // Get
-  if (OB_SUCCESS == ret && hint_.read_method_ == ObSqlReadStrategy::USE_GET)
+  else if (OB_SUCCESS == ret && hint_.read_method_ == ObSqlReadStrategy::USE_GET)
   {
     int64_t start_cons_get = tbsys::CTimeUtil::getTime();
     get_row_desc_.reset();
@@ -459,12 +488,19 @@ int ObRpcScan::close()
   {
     scan_param_->reset_local();
   }
+  scan_ranges_.clear();
+  cur_scan_range_idx_ = 0;
+  scan_range_objs_allocator_.free();
   sql_get_request_.close();
   sql_get_request_.reset();
   if (NULL != get_param_)
   {
     get_param_->reset_local();
   }
+  if (NULL != index_lookup_)
+  {
+    index_lookup_->close();
+  }
   return ret;
 }
 
@@ -490,6 +526,10 @@ int ObRpcScan::get_next_row(const common::ObRow *&row)
   {
     ret = get_next_compact_row(row); // 可能需要等待CS返回
   }
+  else if (ObSqlReadStrategy::USE_GET == hint_.read_method_ && NULL != index_lookup_)
+  {
+    ret = get_next_lookup_row();
+  }
   else if (ObSqlReadStrategy::USE_GET == hint_.read_method_)
   {
     ret = sql_get_request_.get_next_row(cur_row_);
@@ -528,6 +568,16 @@ int ObRpcScan::get_next_compact_row(const common::ObRow *&row)
       // no need to check timeout, leave this work to upper layer
       can_break = true;
     }
+    else if (OB_ITER_END == ret && sql_scan_request_.is_finish()
+        && cur_scan_range_idx_ + 1 < scan_ranges_.count())
+    {
+      // current range finished, skip to the next one
+      if (OB_SUCCESS != (ret = open_next_scan_range()))
+      {
+        TBSYS_LOG(WARN, "fail to open next scan range. idx=%ld, ret=%d", cur_scan_range_idx_, ret);
+        can_break = true;
+      }
+    }
     else if (OB_ITER_END == ret && sql_scan_request_.is_finish())
     {
       // finish all data
@@ -635,10 +685,17 @@ int ObRpcScan::cons_get_rows(ObSqlGetParam &get_param)
   }
   else if (rowkey_array.count() > 0)
   {
+    // 排序并去掉重复的rowkey, 每个cs收到的行都是有序的, 相邻的行大多落在同一个tablet和sstable block中
+    ObRowkey *rowkeys = &rowkey_array.at(0);
+    std::sort(rowkeys, rowkeys + rowkey_array.count());
     for (idx = 0; idx < rowkey_array.count(); idx++)
     {
+      if (idx > 0 && rowkeys[idx] == rowkeys[idx - 1])
+      {
+        continue;
+      }
       //深拷贝，从rowkey_objs_allocator 拷贝到了allocator_中
-      if (OB_SUCCESS != (ret = get_param.add_rowkey(rowkey_array.at(idx), true)))
+      else if (OB_SUCCESS != (ret = get_param.add_rowkey(rowkeys[idx], true)))
       {
         TBSYS_LOG(WARN, "fail to add rowkey to get param. ret=%d", ret);
         break;
@@ -666,19 +723,201 @@ int ObRpcScan::cons_get_rows(ObSqlGetParam &get_param)
   return ret;
 }
 
+int ObRpcScan::cons_lookup_rows(ObSqlGetParam &get_param)
+{
+  int ret = OB_SUCCESS;
+  const ObRow *row = NULL;
+  const ObObj *cell = NULL;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  ObObj rowkey_objs[OB_MAX_ROWKEY_COLUMN_NUMBER];
+  ObRowkey rowkey;
+  const int64_t rowkey_size = rowkey_info_.get_size();
+  while (OB_SUCCESS == ret && !lookup_source_end_ && get_param.get_row_size() < INDEX_LOOKUP_BATCH_SIZE)
+  {
+    if (OB_ITER_END == (ret = index_lookup_->get_next_row(row)))
+    {
+      lookup_source_end_ = true;
+      ret = OB_SUCCESS;
+    }
+    else if (OB_SUCCESS != ret)
+    {
+      TBSYS_LOG(WARN, "fail to get next row from index lookup. ret=%d", ret);
+    }
+    else
+    {
+      // lookup输出行的前rowkey_size列就是数据表的rowkey
+      for (int64_t i = 0; OB_SUCCESS == ret && i < rowkey_size; i++)
+      {
+        if (OB_SUCCESS != (ret = row->raw_get_cell(i, cell, tid, cid)))
+        {
+          TBSYS_LOG(WARN, "fail to get rowkey cell from index row. idx=%ld, ret=%d", i, ret);
+        }
+        else
+        {
+          rowkey_objs[i] = *cell;
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        rowkey.assign(rowkey_objs, rowkey_size);
+        if (OB_SUCCESS != (ret = get_param.add_rowkey(rowkey, true)))
+        {
+          TBSYS_LOG(WARN, "fail to add rowkey to get param. ret=%d", ret);
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+int ObRpcScan::open_next_lookup_batch()
+{
+  int ret = OB_SUCCESS;
+  sql_get_request_.close();
+  sql_get_request_.reset();
+  get_param_->reset_local();
+  get_row_desc_.reset();
+  if (OB_SUCCESS != (ret = cons_lookup_rows(*get_param_)))
+  {
+    TBSYS_LOG(WARN, "fail to construct lookup rows. ret=%d", ret);
+  }
+  else if (0 >= get_param_->get_row_size())
+  {
+    lookup_end_ = true;
+  }
+  else
+  {
+    sql_get_request_.alloc_request_id();
+    if (OB_SUCCESS != (ret = sql_get_request_.init(REQUEST_EVENT_QUEUE_SIZE, ObModIds::OB_SQL_RPC_GET)))
+    {
+      TBSYS_LOG(WARN, "fail to init sql_get_request. ret=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = cons_row_desc(*get_param_, get_row_desc_)))
+    {
+      TBSYS_LOG(WARN, "fail to get row desc:ret[%d]", ret);
+    }
+    else if (OB_SUCCESS != (ret = sql_get_request_.set_row_desc(get_row_desc_)))
+    {
+      TBSYS_LOG(WARN, "fail to set row desc:ret[%d]", ret);
+    }
+    else if (OB_SUCCESS != (ret = sql_get_request_.set_request_param(*get_param_, timeout_us_)))
+    {
+      TBSYS_LOG(WARN, "fail to set request param. ret=%d", ret);
+    }
+    else
+    {
+      sql_get_request_.set_timeout_percent((int32_t)merge_service_->get_config().timeout_percent);
+      if (OB_SUCCESS != (ret = sql_get_request_.open()))
+      {
+        TBSYS_LOG(WARN, "fail to open get request. ret=%d", ret);
+      }
+      else
+      {
+        TBSYS_LOG(DEBUG, "open lookup batch, row_count=%ld", get_param_->get_row_size());
+      }
+    }
+  }
+  return ret;
+}
+
+int ObRpcScan::get_next_lookup_row()
+{
+  int ret = OB_ITER_END;
+  while (OB_ITER_END == ret && !lookup_end_)
+  {
+    if (OB_ITER_END != (ret = sql_get_request_.get_next_row(cur_row_)))
+    {
+      // got a row or an error
+    }
+    else if (lookup_source_end_)
+    {
+      lookup_end_ = true;
+    }
+    else if (OB_SUCCESS != (ret = open_next_lookup_batch()))
+    {
+      TBSYS_LOG(WARN, "fail to open next lookup batch. ret=%d", ret);
+    }
+    else
+    {
+      ret = OB_ITER_END;
+    }
+  }
+  return ret;
+}
+
 int ObRpcScan::cons_scan_range(ObNewRange &range)
 {
   int ret = OB_SUCCESS;
-  bool found = false;
-  range.border_flag_.set_inclusive_start();
-  range.border_flag_.set_inclusive_end();
-  range.table_id_ = base_table_id_;
   OB_ASSERT(rowkey_info_.get_size() <= OB_MAX_ROWKEY_COLUMN_NUMBER);
-  // range 指向sql_read_strategy_的空间
-  if (OB_SUCCESS != (ret = sql_read_strategy_.find_scan_range(range, found, false)))
+  scan_ranges_.clear();
+  cur_scan_range_idx_ = 0;
+  // range 指向sql_read_strategy_和scan_range_objs_allocator_的空间
+  if (OB_SUCCESS != (ret = sql_read_strategy_.find_scan_ranges(scan_ranges_, scan_range_objs_allocator_)))
   {
     TBSYS_LOG(WARN, "fail to find range %lu", base_table_id_);
   }
+  else if (scan_ranges_.count() <= 0)
+  {
+    ret = OB_ERR_UNEXPECTED;
+    TBSYS_LOG(WARN, "no scan range found, table_id=%lu", base_table_id_);
+  }
+  else
+  {
+    for (int64_t i = 0; i < scan_ranges_.count(); i++)
+    {
+      scan_ranges_.at(i).table_id_ = base_table_id_;
+    }
+    range = scan_ranges_.at(0);
+    if (scan_ranges_.count() > 1 && (read_param_->has_group() || read_param_->has_scalar_agg()))
+    {
+      // 下压的聚合只能在一个请求内完成，使用覆盖所有range的单个range
+      range.end_key_ = scan_ranges_.at(scan_ranges_.count() - 1).end_key_;
+      scan_ranges_.clear();
+      if (OB_SUCCESS != (ret = scan_ranges_.push_back(range)))
+      {
+        TBSYS_LOG(WARN, "fail to push range. ret=%d", ret);
+      }
+    }
+  }
+  return ret;
+}
+
+int ObRpcScan::open_next_scan_range()
+{
+  int ret = OB_SUCCESS;
+  cur_scan_range_idx_++;
+  sql_scan_request_.close();
+  if (OB_SUCCESS != (ret = sql_scan_request_.initialize()))
+  {
+    TBSYS_LOG(WARN, "initialize sql_scan_request failed, ret=%d", ret);
+  }
+  else
+  {
+    sql_scan_request_.alloc_request_id();
+    if (OB_SUCCESS != (ret = sql_scan_request_.init(REQUEST_EVENT_QUEUE_SIZE, ObModIds::OB_SQL_RPC_SCAN)))
+    {
+      TBSYS_LOG(WARN, "fail to init sql_scan_event. ret=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = scan_param_->set_range(scan_ranges_.at(cur_scan_range_idx_))))
+    {
+      TBSYS_LOG(WARN, "fail to set range to scan param. ret=%d", ret);
+    }
+    else
+    {
+      sql_scan_request_.set_timeout_percent((int32_t)merge_service_->get_config().timeout_percent);
+      if (OB_SUCCESS != (ret = sql_scan_request_.set_request_param(*scan_param_, hint_)))
+      {
+        TBSYS_LOG(WARN, "fail to set request param. max_parallel=%ld, ret=%d",
+            hint_.max_parallel_count, ret);
+      }
+      else
+      {
+        TBSYS_LOG(DEBUG, "scan range %ld/%ld: %s", cur_scan_range_idx_ + 1, scan_ranges_.count(),
+            to_cstring(scan_ranges_.at(cur_scan_range_idx_)));
+      }
+    }
+  }
   return ret;
 }
 
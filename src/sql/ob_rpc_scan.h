@@ -33,6 +33,8 @@
 #include "mergeserver/ob_merge_server_service.h"
 #include "sql/ob_sql_read_strategy.h"
 
+class ObRpcScanTest_cons_get_rows_Test;
+
 namespace oceanbase
 {
   namespace sql
@@ -40,6 +42,7 @@ namespace oceanbase
     // 用于MS进行全表扫描
     class ObRpcScan : public ObPhyOperator
     {
+      friend class ::ObRpcScanTest_cons_get_rows_Test;
       public:
         ObRpcScan();
         virtual ~ObRpcScan();
@@ -106,6 +109,16 @@ namespace oceanbase
         {
           cur_row_desc_.set_rowkey_cell_count(rowkey_cell_count);
         }
+        /**
+         * 通过索引表回表: get的rowkey不从filter中取，而是取lookup输出行的前rowkey个列，
+         * 每INDEX_LOOKUP_BATCH_SIZE行发一次get请求
+         *
+         * @param lookup [in] 索引表上的scan，输出数据表的rowkey列
+         */
+        void set_index_lookup(ObPhyOperator &lookup)
+        {
+          index_lookup_ = &lookup;
+        }
         int64_t to_string(char* buf, const int64_t buf_len) const;
       private:
         // disallow copy
@@ -118,15 +131,20 @@ namespace oceanbase
         int create_scan_param(ObSqlScanParam &scan_param);
         int get_next_compact_row(const common::ObRow*& row);
         int cons_scan_range(ObNewRange &range);
+        int open_next_scan_range();
         int cons_row_desc(const ObSqlGetParam &sql_get_param, ObRowDesc &row_desc);
         int fill_read_param(ObSqlReadParam &dest_param);
         int get_min_max_rowkey(const ObArray<ObRowkey> &rowkey_array, ObObj *start_key_objs_, ObObj *end_key_objs_,int64_t rowkey_size);
 
         int create_get_param(ObSqlGetParam &get_param);
         int cons_get_rows(ObSqlGetParam &get_param);
+        int cons_lookup_rows(ObSqlGetParam &get_param);
+        int open_next_lookup_batch();
+        int get_next_lookup_row();
         void set_hint(const common::ObRpcScanHint &hint);
       private:
         static const int64_t REQUEST_EVENT_QUEUE_SIZE = 8192;
+        static const int64_t INDEX_LOOKUP_BATCH_SIZE = 1024;
         // 等待结果返回的超时时间
         int64_t timeout_us_;
         mergeserver::ObMsSqlScanRequest sql_scan_request_;
@@ -150,6 +168,13 @@ namespace oceanbase
         char* start_key_buf_;
         char* end_key_buf_;
         ObSqlReadStrategy sql_read_strategy_;
+        // rowkey前缀上有in/or等值列表时的多个有序scan range，在一个算子内依次扫描
+        ObArray<ObNewRange> scan_ranges_;
+        int64_t cur_scan_range_idx_;
+        common::PageArena<ObObj, common::ModulePageAllocator> scan_range_objs_allocator_;
+        ObPhyOperator *index_lookup_;
+        bool lookup_source_end_;
+        bool lookup_end_;
     };
   } // end namespace sql
 } // end namespace oceanbase
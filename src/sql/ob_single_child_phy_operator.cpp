@@ -51,6 +51,26 @@ int ObSingleChildPhyOperator::set_child(int32_t child_idx, ObPhyOperator &child_
   return ret;
 }
 
+int ObSingleChildPhyOperator::replace_child(int32_t child_idx, ObPhyOperator &child_operator)
+{
+  int ret = OB_SUCCESS;
+  if (NULL == child_op_)
+  {
+    ret = OB_NOT_INIT;
+    TBSYS_LOG(WARN, "child_op_ not init");
+  }
+  else if (0 != child_idx)
+  {
+    ret = OB_INVALID_ARGUMENT;
+    TBSYS_LOG(WARN, "invalid child idx=%d", child_idx);
+  }
+  else
+  {
+    child_op_ = &child_operator;
+  }
+  return ret;
+}
+
 ObPhyOperator *ObSingleChildPhyOperator::get_child(int32_t child_idx) const
 {
   ObPhyOperator *ret = NULL;
@@ -30,6 +30,7 @@ namespace oceanbase
         /// get the only one child
         virtual ObPhyOperator *get_child(int32_t child_idx) const;
         virtual int32_t get_child_num() const;
+        virtual int replace_child(int32_t child_idx, ObPhyOperator &child_operator);
         /// open child_op_
         virtual int open();
         /// close child_op_
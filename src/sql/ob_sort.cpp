@@ -16,6 +16,8 @@
 #include "ob_sort.h"
 #include "common/utility.h"
 #include "ob_physical_plan.h"
+#include "ob_result_set.h"
+#include "ob_sql_session_info.h"
 using namespace oceanbase::sql;
 using namespace oceanbase::common;
 
@@ -71,13 +73,43 @@ int ObSort::open()
   {
     TBSYS_LOG(WARN, "failed to open child_op, err=%d", ret);
   }
-  else if (OB_SUCCESS != (ret = do_sort()))
+  else
   {
-    TBSYS_LOG(WARN, "failed to sort input data, err=%d", ret);
+    in_mem_sort_.set_parallel_degree(get_parallel_degree());
+    if (OB_SUCCESS != (ret = do_sort()))
+    {
+      TBSYS_LOG(WARN, "failed to sort input data, err=%d", ret);
+    }
   }
   return ret;
 }
 
+int64_t ObSort::get_parallel_degree() const
+{
+  // session variable ob_query_parallel_degree, sort in one thread if not set
+  // or the plan is not executed for a session, e.g. on chunkserver
+  int64_t degree = 1;
+  ObResultSet *result_set = NULL;
+  ObSQLSessionInfo *session = NULL;
+  ObObj val;
+  if (NULL != my_phy_plan_
+      && NULL != (result_set = my_phy_plan_->get_result_set())
+      && NULL != (session = result_set->get_session())
+      && OB_SUCCESS == session->get_sys_variable_value(ObString::make_string("ob_query_parallel_degree"), val)
+      && OB_SUCCESS == val.get_int(degree))
+  {
+    if (degree < 1)
+    {
+      degree = 1;
+    }
+    else if (degree > ObInMemorySort::MAX_PARALLEL_DEGREE)
+    {
+      degree = ObInMemorySort::MAX_PARALLEL_DEGREE;
+    }
+  }
+  return degree;
+}
+
 int ObSort::close()
 {
   int ret = OB_SUCCESS;
@@ -42,6 +42,7 @@ namespace oceanbase
         virtual int get_row_desc(const common::ObRowDesc *&row_desc) const;
         virtual int64_t to_string(char* buf, const int64_t buf_len) const;
         virtual ObPhyOperatorType get_type() const;
+        virtual int64_t get_used_mem_size() const;
 
         void assign(const ObSort &other);
         int64_t get_mem_size_limit() const;
@@ -55,6 +56,7 @@ namespace oceanbase
         // function members
         bool need_dump() const;
         int do_sort();
+        int64_t get_parallel_degree() const;
       private:
         // data members
         common::ObArray<ObSortColumn> sort_columns_;
@@ -68,6 +70,10 @@ namespace oceanbase
     {
       return mem_size_limit_;
     }
+    inline int64_t ObSort::get_used_mem_size() const
+    {
+      return in_mem_sort_.get_used_mem_size();
+    }
     inline int64_t ObSort::get_sort_column_size() const
     {
       return sort_columns_.count();
@@ -0,0 +1,165 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sort_worker_pool.cpp
+ *
+ */
+#include "ob_sort_worker_pool.h"
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+ObSortWorkerPool::ObSortWorkerPool()
+  :inited_(false), thread_num_(0), push_pos_(0), pop_pos_(0)
+{
+  memset(queue_, 0, sizeof(queue_));
+}
+
+ObSortWorkerPool::~ObSortWorkerPool()
+{
+  destroy();
+}
+
+int ObSortWorkerPool::init(const int64_t thread_num)
+{
+  int ret = OB_SUCCESS;
+  if (inited_)
+  {
+    TBSYS_LOG(WARN, "sort worker pool has been inited");
+    ret = OB_INIT_TWICE;
+  }
+  else if (0 > thread_num || MAX_THREAD_NUM < thread_num)
+  {
+    TBSYS_LOG(WARN, "invalid sort thread num=%ld", thread_num);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  else
+  {
+    _stop = false;
+    push_pos_ = 0;
+    pop_pos_ = 0;
+    thread_num_ = thread_num;
+    if (0 < thread_num_)
+    {
+      setThreadCount(static_cast<int32_t>(thread_num_));
+      start();
+    }
+    inited_ = true;
+    TBSYS_LOG(INFO, "sort worker pool started, thread_num=%ld", thread_num_);
+  }
+  return ret;
+}
+
+void ObSortWorkerPool::destroy()
+{
+  if (inited_)
+  {
+    cond_.lock();
+    _stop = true;
+    cond_.broadcast();
+    cond_.unlock();
+    if (0 < thread_num_)
+    {
+      wait();
+    }
+    thread_num_ = 0;
+    inited_ = false;
+  }
+}
+
+bool ObSortWorkerPool::pop_entry(Entry &entry)
+{
+  bool popped = false;
+  if (pop_pos_ < push_pos_)
+  {
+    entry = queue_[pop_pos_ % MAX_QUEUE_SIZE];
+    ++pop_pos_;
+    popped = true;
+  }
+  return popped;
+}
+
+void ObSortWorkerPool::finish_entry(const Entry &entry)
+{
+  if (0 == --entry.batch_->pending_)
+  {
+    cond_.broadcast();
+  }
+}
+
+void ObSortWorkerPool::run_tasks(Task *const *tasks, const int64_t task_count)
+{
+  Batch batch;
+  Entry entry;
+  int64_t queued = 0;
+  batch.pending_ = 0;
+  if (1 < task_count && 0 < thread_num_)
+  {
+    cond_.lock();
+    for (int64_t i = 1; i < task_count && push_pos_ - pop_pos_ < MAX_QUEUE_SIZE; ++i)
+    {
+      entry.task_ = tasks[i];
+      entry.batch_ = &batch;
+      queue_[push_pos_ % MAX_QUEUE_SIZE] = entry;
+      ++push_pos_;
+      ++batch.pending_;
+      ++queued;
+    }
+    cond_.broadcast();
+    cond_.unlock();
+  }
+  // the queue is full or there is no thread
+  for (int64_t i = queued + 1; i < task_count; ++i)
+  {
+    tasks[i]->run();
+  }
+  if (0 < task_count)
+  {
+    tasks[0]->run();
+  }
+  // help with the queued tasks, of this sort or not, until ours are done
+  cond_.lock();
+  while (0 < batch.pending_)
+  {
+    if (pop_entry(entry))
+    {
+      cond_.unlock();
+      entry.task_->run();
+      cond_.lock();
+      finish_entry(entry);
+    }
+    else
+    {
+      cond_.wait();
+    }
+  }
+  cond_.unlock();
+}
+
+void ObSortWorkerPool::run(tbsys::CThread *thread, void *arg)
+{
+  UNUSED(thread);
+  UNUSED(arg);
+  Entry entry;
+  cond_.lock();
+  while (!_stop)
+  {
+    if (pop_entry(entry))
+    {
+      cond_.unlock();
+      entry.task_->run();
+      cond_.lock();
+      finish_entry(entry);
+    }
+    else
+    {
+      cond_.wait();
+    }
+  }
+  cond_.unlock();
+}
@@ -0,0 +1,90 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sort_worker_pool.h
+ *
+ * A fixed number of threads shared by all the in-memory sorts of a
+ * mergeserver. A sort hands its runs in as tasks and waits for them,
+ * helping with the queued tasks while waiting, so the threads sorting
+ * at any time are bounded by the pool size plus the sorting sessions.
+ * Only the sort is run on the pool, operators are still pulled by one
+ * thread each, there is no exchange operator.
+ */
+#ifndef _OB_SORT_WORKER_POOL_H
+#define _OB_SORT_WORKER_POOL_H 1
+#include <tbsys.h>
+#include "common/ob_define.h"
+
+namespace oceanbase
+{
+  namespace sql
+  {
+    class ObSortWorkerPool : public tbsys::CDefaultRunnable
+    {
+      public:
+        class Task
+        {
+          public:
+            virtual ~Task() {}
+            virtual void run() = 0;
+        };
+      public:
+        static const int64_t MAX_THREAD_NUM = 64;
+        static const int64_t MAX_QUEUE_SIZE = 1024;
+
+        ObSortWorkerPool();
+        virtual ~ObSortWorkerPool();
+
+        /// start thread_num threads, no thread is started if thread_num is 0
+        int init(const int64_t thread_num);
+        void destroy();
+        int64_t get_thread_num() const;
+
+        /**
+         * run the tasks and return after all of them are done, the
+         * calling thread runs the first task, the tasks the queue can't
+         * hold and the queued tasks no thread has taken yet
+         */
+        void run_tasks(Task *const *tasks, const int64_t task_count);
+
+        virtual void run(tbsys::CThread *thread, void *arg);
+      private:
+        struct Batch
+        {
+          int64_t pending_;
+        };
+        struct Entry
+        {
+          Task *task_;
+          Batch *batch_;
+        };
+      private:
+        // disallow copy
+        ObSortWorkerPool(const ObSortWorkerPool &other);
+        ObSortWorkerPool& operator=(const ObSortWorkerPool &other);
+        // must hold cond_
+        bool pop_entry(Entry &entry);
+        void finish_entry(const Entry &entry);
+      private:
+        bool inited_;
+        int64_t thread_num_;
+        int64_t push_pos_;
+        int64_t pop_pos_;
+        Entry queue_[MAX_QUEUE_SIZE];
+        tbsys::CThreadCond cond_;
+    };
+
+    inline int64_t ObSortWorkerPool::get_thread_num() const
+    {
+      return thread_num_;
+    }
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_SORT_WORKER_POOL_H */
@@ -41,6 +41,7 @@
 #include "sql/ob_set_password_stmt.h"
 #include "sql/ob_rename_user_stmt.h"
 #include "sql/ob_show_stmt.h"
+#include "sql/ob_sql_parameterizer.h"
 using namespace oceanbase::common;
 using namespace oceanbase::sql;
 
@@ -130,7 +131,10 @@ int ObSql::direct_execute(const common::ObString &stmt, ObResultSet &result, ObS
         ObBasicStmt::StmtType stmt_type = logic_plan->get_main_stmt()->get_stmt_type();
         result.set_stmt_type(stmt_type);
         result.set_inner_stmt_type(stmt_type);
-        if (OB_SUCCESS != (ret = logic_plan->fill_result_set(result, context.session_info_, context.session_info_->get_transformer_mem_pool())))
+        // fields and params of a prepared or cached plan live as long as the plan, in its own arena
+        ObIAllocator *field_allocator = context.is_prepare_protocol_ && NULL != context.transformer_allocator_ ?
+          context.transformer_allocator_ : &context.session_info_->get_transformer_mem_pool();
+        if (OB_SUCCESS != (ret = logic_plan->fill_result_set(result, context.session_info_, *field_allocator)))
         {
           TBSYS_LOG(WARN, "fill result set failed,ret=%d", ret);
         }
@@ -161,6 +165,126 @@ int ObSql::direct_execute(const common::ObString &stmt, ObResultSet &result, ObS
   return ret;
 }
 
+int ObSql::direct_execute_with_plan_cache(const common::ObString &stmt, ObResultSet &result,
+                                          ObSqlContext &context, const int64_t max_cached_plans)
+{
+  int ret = OB_SUCCESS;
+  int err = OB_NOT_SUPPORTED;
+  char *buf = NULL;
+  ObString text;
+  ObString key;
+  ObArray<ObObj> params;
+  ObResultSet *stored_result = NULL;
+  result.set_session(context.session_info_);
+  if (0 < max_cached_plans
+      && NULL != context.session_info_
+      && NULL != context.schema_manager_
+      && NULL != context.pp_privilege_
+      && NULL != *context.pp_privilege_
+      && !context.is_prepare_protocol_
+      && !no_enough_memory()
+      && NULL != (buf = static_cast<char*>(context.session_info_->get_transformer_mem_pool().alloc(2 * stmt.length())))
+      && OB_SUCCESS == ObSqlParameterizer::parameterize(stmt, buf, 2 * stmt.length(), text, key, params))
+  {
+    context.session_info_->set_version_provider(context.merge_service_);
+    const int64_t schema_version = context.schema_manager_->get_version();
+    const int64_t privilege_version = (*context.pp_privilege_)->get_version();
+    err = context.session_info_->get_cached_plan(key, schema_version, privilege_version, stored_result);
+    if (OB_SUCCESS == err)
+    {
+      OB_STAT_INC(SQL, SQL_PLAN_CACHE_HIT_COUNT);
+      FILL_TRACE_LOG("plan_cache_hit stmt_id=%lu", stored_result->get_statement_id());
+    }
+    else if (OB_ENTRY_NOT_EXIST == err)
+    {
+      OB_STAT_INC(SQL, SQL_PLAN_CACHE_MISS_COUNT);
+      if (OB_SUCCESS != (err = prepare_cached_plan(text, key, params.count(), schema_version, privilege_version,
+                                                   max_cached_plans, result, context, stored_result)))
+      {
+        TBSYS_LOG(DEBUG, "statement can not be cached, err=%d key=%.*s", err, key.length(), key.ptr());
+        context.session_info_->set_plan_uncacheable(key, schema_version, privilege_version, max_cached_plans);
+        result.reset();
+      }
+    }
+  }
+  if (OB_SUCCESS == err)
+  {
+    ret = execute_cached_plan(*stored_result, params, result);
+  }
+  else
+  {
+    ret = direct_execute(stmt, result, context);
+  }
+  return ret;
+}
+
+int ObSql::prepare_cached_plan(const common::ObString &text, const common::ObString &key,
+                               const int64_t param_count,
+                               const int64_t schema_version, const int64_t privilege_version,
+                               const int64_t max_cached_plans, ObResultSet &result,
+                               ObSqlContext &context, ObResultSet *&stored_result)
+{
+  int ret = OB_SUCCESS;
+  ObArenaAllocator *allocator = NULL;
+  if (NULL == (allocator = context.session_info_->get_transformer_mem_pool_for_ps()))
+  {
+    TBSYS_LOG(WARN, "failed to get new allocator");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    OB_ASSERT(NULL == context.transformer_allocator_);
+    context.is_prepare_protocol_ = true;
+    context.transformer_allocator_ = allocator;
+    // the transformer's allocator is owned by the result set now, and will be free by the result set
+    result.set_ps_transformer_allocator(allocator);
+    if (OB_SUCCESS != (ret = direct_execute(text, result, context)))
+    {
+      TBSYS_LOG(DEBUG, "failed to generate plan for plan cache, err=%d", ret);
+    }
+    else if (param_count != result.get_params().count())
+    {
+      TBSYS_LOG(DEBUG, "param count mismatch, expect=%ld actual=%ld",
+                param_count, result.get_params().count());
+      ret = OB_NOT_SUPPORTED;
+    }
+    else if (OB_SUCCESS != (ret = context.session_info_->store_cached_plan(key, schema_version,
+                                                                          privilege_version, max_cached_plans,
+                                                                          result, stored_result)))
+    {
+      TBSYS_LOG(WARN, "failed to store cached plan, err=%d", ret);
+    }
+    context.is_prepare_protocol_ = false;
+    context.transformer_allocator_ = NULL;
+  }
+  return ret;
+}
+
+int ObSql::execute_cached_plan(ObResultSet &stored_result, const common::ObArray<common::ObObj> &params,
+                               ObResultSet &result)
+{
+  int ret = OB_SUCCESS;
+  ObArray<obmysql::EMySQLFieldType> params_type; // types are carried by the values
+  if (OB_SUCCESS != (ret = stored_result.fill_params(params_type, params)))
+  {
+    TBSYS_LOG(WARN, "failed to fill params of cached plan, err=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = result.from_prepared(stored_result)))
+  {
+    TBSYS_LOG(ERROR, "Fill result set failed, err=%d", ret);
+  }
+  else
+  {
+    result.set_stmt_type(stored_result.get_stmt_type());
+    if (OB_UNLIKELY(TBSYS_LOGGER._level >= TBSYS_LOG_LEVEL_TRACE))
+    {
+      TBSYS_LOG(TRACE, "ExecutionPlan: \n%s", to_cstring(*stored_result.get_physical_plan()->get_main_query()));
+    }
+  }
+  result.set_errcode(ret);
+  return ret;
+}
+
 int ObSql::generate_logical_plan(const common::ObString &stmt, ObSqlContext & context, ResultPlan  &result_plan, ObResultSet & result)
 {
   int ret = OB_SUCCESS;
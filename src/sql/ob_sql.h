@@ -39,6 +39,23 @@ namespace oceanbase
          * @return oceanbase error code defined in ob_define.h
          */
         static int direct_execute(const common::ObString &stmt, ObResultSet &result, ObSqlContext &context);
+        /**
+         * execute the SQL statement through the plan cache of the session
+         *
+         * The constants of the statement are replaced by parameters, plans
+         * of the same parameterized statement are generated once with the
+         * prepare protocol and reused until the schema or privilege changes,
+         * or until evicted as the least recently used plan of the session.
+         * Falls back to direct_execute() if the statement can not be cached.
+         *
+         * @param stmt [in]
+         * @param result [out]
+         * @param max_cached_plans [in] max number of plans cached by one session, 0 means disabled
+         *
+         * @return oceanbase error code defined in ob_define.h
+         */
+        static int direct_execute_with_plan_cache(const common::ObString &stmt, ObResultSet &result,
+                                                  ObSqlContext &context, const int64_t max_cached_plans);
         /**
          * prepare the SQL statement for later execution
          * @see stmt_execute()
@@ -83,6 +100,13 @@ namespace oceanbase
         static int generate_physical_plan(ObSqlContext & context, ResultPlan &result_plan, ObMultiPhyPlan & multi_phy_plan, ObResultSet & result);
         static int do_grant_privilege(const ObBasicStmt *stmt, ObSqlContext & context, ObResultSet &result);
         static void clean_result_plan(ResultPlan &result_plan);
+        static int prepare_cached_plan(const common::ObString &text, const common::ObString &key,
+                                       const int64_t param_count,
+                                       const int64_t schema_version, const int64_t privilege_version,
+                                       const int64_t max_cached_plans, ObResultSet &result,
+                                       ObSqlContext &context, ObResultSet *&stored_result);
+        static int execute_cached_plan(ObResultSet &stored_result, const common::ObArray<common::ObObj> &params,
+                                       ObResultSet &result);
         // function members
 
         // for temp use to deal with special statment
@@ -80,6 +80,7 @@ namespace oceanbase
         inline bool is_simple_between(bool real_val, uint64_t &column_id, int64_t &cond_op, ObObj &cond_start, ObObj &cond_end) const;
         inline bool is_simple_in_expr(const ObRowkeyInfo &info, ObArray<ObRowkey> &rowkey_array,
             common::PageArena<ObObj,common::ModulePageAllocator> &allocator) const;
+        inline bool is_simple_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const;
         inline bool is_aggr_func() const;
         inline bool is_empty() const;
         NEED_SERIALIZE_AND_DESERIALIZE;
@@ -201,6 +202,10 @@ namespace oceanbase
     {
       return post_expr_.is_simple_in_expr(info, rowkey_array, allocator);
     }
+    inline bool ObSqlExpression::is_simple_value_list(bool real_val, uint64_t &column_id, ObArray<ObObj> &values) const
+    {
+      return post_expr_.is_simple_value_list(real_val, column_id, values);
+    }
     inline bool ObSqlExpression::is_aggr_func() const
     {
       return is_aggr_func_;
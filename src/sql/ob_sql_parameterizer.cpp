@@ -0,0 +1,372 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sql_parameterizer.cpp
+ *
+ */
+#include "sql/ob_sql_parameterizer.h"
+#include <ctype.h>
+#include <strings.h>
+#include "common/ob_define.h"
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+
+namespace
+{
+  enum TokenType
+  {
+    TOKEN_NONE = 0,
+    TOKEN_WORD,       // keywords and identifiers
+    TOKEN_OPERAND,    // constants, quoted identifiers and ')'
+    TOKEN_OPERATOR,   // other punctuations
+  };
+}
+
+bool ObSqlParameterizer::is_word_char(const char c)
+{
+  return (isalnum(static_cast<unsigned char>(c)) || '_' == c || '$' == c || '@' == c
+          || 0 != (c & 0x80));
+}
+
+bool ObSqlParameterizer::word_equals(const char *word, const int64_t len, const char *keyword)
+{
+  return (NULL != word && static_cast<int64_t>(strlen(keyword)) == len
+          && 0 == strncasecmp(word, keyword, len));
+}
+
+int ObSqlParameterizer::parameterize(const ObString &stmt, char *buf, const int64_t buf_len,
+                                     ObString &text, ObString &key, ObArray<ObObj> &params)
+{
+  int ret = OB_SUCCESS;
+  const char *src = stmt.ptr();
+  const int64_t len = stmt.length();
+  int64_t pos = 0;
+  int64_t out = 0;
+  int64_t level = 0;
+  uint64_t select_list_mask = 0;     // bit i is set while in the select list of level i
+  int64_t by_level = -1;             // level of the last ORDER BY/GROUP BY, -1 if none
+  bool is_first_word = true;
+  TokenType prev_token = TOKEN_NONE;
+  char prev_char = '\0';             // valid when prev_token is TOKEN_OPERATOR
+  const char *prev_word = NULL;      // valid when prev_token is TOKEN_WORD
+  int64_t prev_word_len = 0;
+  params.clear();
+  if (NULL == src || 0 >= len || NULL == buf || buf_len < 2 * len)
+  {
+    TBSYS_LOG(WARN, "invalid argument, stmt_len=%ld buf=%p buf_len=%ld", len, buf, buf_len);
+    ret = OB_INVALID_ARGUMENT;
+  }
+  while (OB_SUCCESS == ret && pos < len)
+  {
+    const char c = src[pos];
+    const bool can_param = (0 == select_list_mask && !is_first_word);
+    if (isspace(static_cast<unsigned char>(c)))
+    {
+      if (0 < out && ' ' != buf[out - 1] && '\n' != buf[out - 1])
+      {
+        buf[out++] = ' ';
+      }
+      ++pos;
+    }
+    else if ('?' == c)
+    {
+      // already a parameterized statement, only valid for the prepare protocol
+      ret = OB_NOT_SUPPORTED;
+    }
+    else if (('-' == c && pos + 1 < len && '-' == src[pos + 1]) || '#' == c)
+    {
+      // line comment, keep it and the terminating newline
+      while (pos < len && '\n' != src[pos])
+      {
+        buf[out++] = src[pos++];
+      }
+      if (pos < len)
+      {
+        buf[out++] = src[pos++];
+      }
+    }
+    else if ('/' == c && pos + 1 < len && '*' == src[pos + 1])
+    {
+      // block comment or hint, keep it as it is
+      int64_t end = pos + 2;
+      while (end + 1 < len && !('*' == src[end] && '/' == src[end + 1]))
+      {
+        ++end;
+      }
+      if (end + 1 >= len)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        end += 2;
+        memcpy(buf + out, src + pos, end - pos);
+        out += end - pos;
+        pos = end;
+      }
+    }
+    else if ('\'' == c)
+    {
+      int64_t end = pos + 1;
+      bool has_escape = false;
+      while (end < len)
+      {
+        if ('\\' == src[end])
+        {
+          has_escape = true;
+          end += 2;
+        }
+        else if ('\'' == src[end])
+        {
+          if (end + 1 < len && '\'' == src[end + 1])
+          {
+            has_escape = true;
+            end += 2;
+          }
+          else
+          {
+            break;
+          }
+        }
+        else
+        {
+          ++end;
+        }
+      }
+      if (end >= len)
+      {
+        // unterminated string, let the parser report the error
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        ++end; // skip the closing quote
+        bool is_typed_literal = (TOKEN_WORD == prev_token
+                                 && (word_equals(prev_word, prev_word_len, "DATE")
+                                     || word_equals(prev_word, prev_word_len, "TIME")
+                                     || word_equals(prev_word, prev_word_len, "TIMESTAMP")
+                                     || word_equals(prev_word, prev_word_len, "INTERVAL")));
+        if (can_param && !has_escape && !is_typed_literal)
+        {
+          ObObj value;
+          value.set_varchar(ObString(static_cast<int32_t>(end - pos - 2),
+                                     static_cast<int32_t>(end - pos - 2), src + pos + 1));
+          if (OB_SUCCESS != (ret = params.push_back(value)))
+          {
+            TBSYS_LOG(WARN, "failed to push back param, err=%d", ret);
+          }
+          else
+          {
+            buf[out++] = '?';
+          }
+        }
+        else
+        {
+          memcpy(buf + out, src + pos, end - pos);
+          out += end - pos;
+        }
+        pos = end;
+        prev_token = TOKEN_OPERAND;
+      }
+    }
+    else if ('"' == c || '`' == c)
+    {
+      // quoted identifier
+      int64_t end = pos + 1;
+      while (end < len && c != src[end])
+      {
+        end += ('\\' == src[end]) ? 2 : 1;
+      }
+      if (end >= len)
+      {
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        ++end;
+        memcpy(buf + out, src + pos, end - pos);
+        out += end - pos;
+        pos = end;
+        prev_token = TOKEN_OPERAND;
+      }
+    }
+    else if (isdigit(static_cast<unsigned char>(c))
+             || ('.' == c && pos + 1 < len && isdigit(static_cast<unsigned char>(src[pos + 1])))
+             || ('-' == c && pos + 1 < len && isdigit(static_cast<unsigned char>(src[pos + 1]))
+                 && TOKEN_OPERATOR == prev_token))
+    {
+      // numbers, an unary minus is folded into the constant
+      const bool is_negative = ('-' == c);
+      const int64_t num_start = is_negative ? pos + 1 : pos;
+      int64_t end = num_start;
+      while (end < len && isdigit(static_cast<unsigned char>(src[end])))
+      {
+        ++end;
+      }
+      bool is_int = (end > num_start && end - num_start <= MAX_INT_DIGITS
+                     && !(end < len && ('.' == src[end] || is_word_char(src[end]))));
+      if (!is_int)
+      {
+        // decimal, approximate or hex number, keep it
+        while (end < len && (is_word_char(src[end]) || '.' == src[end]
+                             || (('+' == src[end] || '-' == src[end])
+                                 && ('e' == src[end - 1] || 'E' == src[end - 1]))))
+        {
+          ++end;
+        }
+      }
+      const bool is_positional = (level == by_level
+                                  && ((TOKEN_WORD == prev_token && word_equals(prev_word, prev_word_len, "BY"))
+                                      || (TOKEN_OPERATOR == prev_token && ',' == prev_char)));
+      if (is_int && can_param && !is_positional)
+      {
+        int64_t value = 0;
+        for (int64_t i = num_start; i < end; ++i)
+        {
+          value = value * 10 + (src[i] - '0');
+        }
+        ObObj obj;
+        obj.set_int(is_negative ? -value : value);
+        if (OB_SUCCESS != (ret = params.push_back(obj)))
+        {
+          TBSYS_LOG(WARN, "failed to push back param, err=%d", ret);
+        }
+        else
+        {
+          buf[out++] = '?';
+        }
+      }
+      else
+      {
+        memcpy(buf + out, src + pos, end - pos);
+        out += end - pos;
+      }
+      pos = end;
+      prev_token = TOKEN_OPERAND;
+    }
+    else if (is_word_char(c))
+    {
+      int64_t end = pos;
+      while (end < len && is_word_char(src[end]))
+      {
+        ++end;
+      }
+      const char *word = src + pos;
+      const int64_t word_len = end - pos;
+      if (1 == word_len && end < len && '\'' == src[end]
+          && ('x' == c || 'X' == c || 'b' == c || 'B' == c))
+      {
+        // X'0A1B' style literal, keep it
+        ++end;
+        while (end < len && '\'' != src[end])
+        {
+          ++end;
+        }
+        if (end >= len)
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+        else
+        {
+          ++end;
+          memcpy(buf + out, src + pos, end - pos);
+          out += end - pos;
+          pos = end;
+          prev_token = TOKEN_OPERAND;
+        }
+      }
+      else
+      {
+        if (is_first_word)
+        {
+          if (!word_equals(word, word_len, "SELECT")
+              && !word_equals(word, word_len, "INSERT")
+              && !word_equals(word, word_len, "REPLACE")
+              && !word_equals(word, word_len, "UPDATE")
+              && !word_equals(word, word_len, "DELETE"))
+          {
+            ret = OB_NOT_SUPPORTED;
+          }
+          is_first_word = false;
+        }
+        if (word_equals(word, word_len, "SELECT"))
+        {
+          select_list_mask |= (1UL << level);
+        }
+        else if (word_equals(word, word_len, "FROM"))
+        {
+          select_list_mask &= ~(1UL << level);
+        }
+        if (word_equals(word, word_len, "BY"))
+        {
+          by_level = level;
+        }
+        else if (level == by_level
+                 && (word_equals(word, word_len, "LIMIT")
+                     || word_equals(word, word_len, "OFFSET")
+                     || word_equals(word, word_len, "HAVING")
+                     || word_equals(word, word_len, "UNION")
+                     || word_equals(word, word_len, "EXCEPT")
+                     || word_equals(word, word_len, "INTERSECT")
+                     || word_equals(word, word_len, "FOR")))
+        {
+          by_level = -1;
+        }
+        memcpy(buf + out, word, word_len);
+        out += word_len;
+        pos = end;
+        prev_token = TOKEN_WORD;
+        prev_word = word;
+        prev_word_len = word_len;
+      }
+    }
+    else
+    {
+      if ('(' == c)
+      {
+        if (++level >= MAX_NESTED_LEVEL)
+        {
+          ret = OB_NOT_SUPPORTED;
+        }
+      }
+      else if (')' == c && 0 < level)
+      {
+        select_list_mask &= ~(1UL << level);
+        if (level == by_level)
+        {
+          by_level = -1;
+        }
+        --level;
+      }
+      buf[out++] = c;
+      ++pos;
+      prev_token = (')' == c) ? TOKEN_OPERAND : TOKEN_OPERATOR;
+      prev_char = c;
+    }
+  }
+  if (OB_SUCCESS == ret && is_first_word)
+  {
+    ret = OB_NOT_SUPPORTED;
+  }
+  if (OB_SUCCESS == ret)
+  {
+    while (0 < out && isspace(static_cast<unsigned char>(buf[out - 1])))
+    {
+      --out;
+    }
+    text.assign_ptr(buf, static_cast<int32_t>(out));
+    // every param takes at least one character of stmt, there is room
+    for (int64_t i = 0; i < params.count(); ++i)
+    {
+      buf[out++] = (ObIntType == params.at(i).get_type()) ? 'I' : 'S';
+    }
+    key.assign_ptr(buf, static_cast<int32_t>(out));
+  }
+  return ret;
+}
@@ -0,0 +1,75 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sql_parameterizer.h
+ *
+ */
+#ifndef _OB_SQL_PARAMETERIZER_H
+#define _OB_SQL_PARAMETERIZER_H 1
+#include "common/ob_string.h"
+#include "common/ob_object.h"
+#include "common/ob_array.h"
+namespace oceanbase
+{
+  namespace sql
+  {
+    /*
+     * A light weight lexer pass used by the plan cache. It replaces the
+     * constants of a DML statement by '?' so that statements of the same
+     * shape share one key, and collects the replaced values in order.
+     *
+     * example: select c1 from t where pk = 10 and c2 = 'abc'
+     *       => select c1 from t where pk = ? and c2 = ?  params: [10, "abc"]
+     *
+     * The same text with constants of different types, like `a = 1' and
+     * `a = '1'', is planned differently, so the cache key is the text
+     * followed by the type class of each parameter, 'I' for integers and
+     * 'S' for strings, e.g. "select c1 from t where pk = ? and c2 = ?IS".
+     *
+     * Constants which may change the result set metadata or the meaning of
+     * the statement are kept as they are:
+     *   - select list of every (sub)query, the column names come from there
+     *   - positional ORDER BY/GROUP BY items
+     *   - DATE/TIME/TIMESTAMP/INTERVAL/X'' literals, decimals and strings
+     *     with escape sequences
+     */
+    class ObSqlParameterizer
+    {
+      public:
+        /**
+         * @param stmt [in] original statement
+         * @param buf [in] buffer to hold the text and the key, 2 * stmt.length() bytes is enough
+         * @param buf_len [in]
+         * @param text [out] parameterized statement, pointing into buf
+         * @param key [out] text followed by the param type classes, pointing into buf
+         * @param params [out] replaced constants, varchar values point into stmt
+         *
+         * @return OB_SUCCESS or OB_NOT_SUPPORTED if the statement can not be cached
+         */
+        static int parameterize(const common::ObString &stmt, char *buf, const int64_t buf_len,
+                                common::ObString &text, common::ObString &key,
+                                common::ObArray<common::ObObj> &params);
+      private:
+        // types and constants
+        static const int64_t MAX_NESTED_LEVEL = 64;
+        static const int64_t MAX_INT_DIGITS = 18;
+      private:
+        ObSqlParameterizer(){}
+        ~ObSqlParameterizer(){}
+        // disallow copy
+        ObSqlParameterizer(const ObSqlParameterizer &other);
+        ObSqlParameterizer& operator=(const ObSqlParameterizer &other);
+        // function members
+        static bool is_word_char(const char c);
+        static bool word_equals(const char *word, const int64_t len, const char *keyword);
+    };
+  } // end namespace sql
+} // end namespace oceanbase
+
+#endif /* _OB_SQL_PARAMETERIZER_H */
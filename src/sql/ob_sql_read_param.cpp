@@ -2,6 +2,7 @@
 #include "common/ob_action_flag.h"
 #include "common/ob_schema.h"
 #include "common/ob_rowkey_helper.h"
+#include "common/ob_compact_row_codec.h"
 #include "ob_sql_read_param.h"
 
 using namespace oceanbase::common;
@@ -13,7 +14,7 @@ namespace oceanbase
     ObSqlReadParam::ObSqlReadParam() :
       is_read_master_(0), is_result_cached_(0), data_version_(OB_NEWEST_DATA_VERSION),
       table_id_(OB_INVALID_ID), renamed_table_id_(OB_INVALID_ID), only_static_data_(false),
-      project_(), scalar_agg_(), group_(), group_columns_sort_(), limit_(), filter_(),
+      accept_compact_row_(false), project_(), scalar_agg_(), group_(), group_columns_sort_(), limit_(), filter_(),
       has_project_(false), has_scalar_agg_(false), has_group_(false), has_group_columns_sort_(false),
       has_limit_(false), has_filter_(false)
     {
@@ -27,6 +28,7 @@ namespace oceanbase
       data_version_ = OB_NEWEST_DATA_VERSION;
       table_id_ = OB_INVALID_ID;
       renamed_table_id_ = OB_INVALID_ID;
+      accept_compact_row_ = false;
       project_.reset();
       if (NULL != scalar_agg_)
       {
@@ -551,6 +553,25 @@ namespace oceanbase
         }
       }
 
+      // SQL_COMPACT_ROW_FIELD, old servers skip it and return plain rows
+      if (OB_SUCCESS == ret && accept_compact_row_)
+      {
+        obj.set_ext(ObActionFlag::SQL_COMPACT_ROW_FIELD);
+        if (OB_SUCCESS != (ret = obj.serialize(buf, buf_len, pos)))
+        {
+          TBSYS_LOG(WARN, "fail to serialize obj. buf=%p, buf_len=%ld, pos=%ld, ret=%d", buf, buf_len, pos, ret);
+        }
+        else
+        {
+          obj.set_int(ObCompactRowCodec::FORMAT_VERSION);
+          if (OB_SUCCESS != (ret = obj.serialize(buf, buf_len, pos)))
+          {
+            TBSYS_LOG(WARN, "fail to serialize compact row version. buf=%p, buf_len=%ld, pos=%ld, ret=%d",
+                buf, buf_len, pos, ret);
+          }
+        }
+      }
+
       // END_PARAM_FIELD
       if (OB_SUCCESS == ret)
       {
@@ -684,6 +705,24 @@ namespace oceanbase
                 }
                 break;
               }
+            case ObActionFlag::SQL_COMPACT_ROW_FIELD:
+              {
+                int64_t version = 0;
+                if (OB_SUCCESS != (ret = obj.deserialize(buf, data_len, pos)))
+                {
+                  TBSYS_LOG(WARN, "fail to deserialize compact row version. buf=%p, data_len=%ld, pos=%ld, ret=%d",
+                      buf, data_len, pos, ret);
+                }
+                else if (OB_SUCCESS != (ret = obj.get_int(version)))
+                {
+                  TBSYS_LOG(WARN, "fail to get compact row version. obj=%s, ret=%d", to_cstring(obj), ret);
+                }
+                else
+                {
+                  accept_compact_row_ = (ObCompactRowCodec::FORMAT_VERSION == version);
+                }
+                break;
+              }
             default:
               {
                 // deserialize next cell
@@ -775,6 +814,14 @@ namespace oceanbase
         total_size += filter_.get_serialize_size();
       }
 
+      if (accept_compact_row_)
+      {
+        obj.set_ext(ObActionFlag::SQL_COMPACT_ROW_FIELD);
+        total_size += obj.get_serialize_size();
+        obj.set_int(ObCompactRowCodec::FORMAT_VERSION);
+        total_size += obj.get_serialize_size();
+      }
+
       obj.set_ext(ObActionFlag::END_PARAM_FIELD);
       total_size += obj.get_serialize_size();
       return total_size;
@@ -785,6 +832,7 @@ namespace oceanbase
       data_version_ = other.data_version_;
       is_read_master_ = other.is_read_master_;
       only_static_data_ = other.only_static_data_;
+      accept_compact_row_ = other.accept_compact_row_;
       is_result_cached_ = other. is_result_cached_;
       table_id_ = other.table_id_;
       renamed_table_id_ = other.renamed_table_id_;
@@ -36,6 +36,9 @@ namespace oceanbase
       virtual inline int set_table_id(const uint64_t& renamed_table_id, const uint64_t& table_id);
       virtual inline uint64_t get_renamed_table_id() const;
       virtual inline uint64_t get_table_id() const;
+      // requester can decode rows in compact format, see ObCompactRowCodec
+      inline void set_accept_compact_row(const bool accept);
+      inline bool get_accept_compact_row() const;
       // operator fields
       virtual int set_project(const ObProject &project);
       virtual int add_output_column(const ObSqlExpression& expr);
@@ -82,6 +85,7 @@ namespace oceanbase
       uint64_t table_id_;
       uint64_t renamed_table_id_;
       bool only_static_data_;
+      bool accept_compact_row_;
 
       ObProject project_;
       ObScalarAggregate *scalar_agg_;
@@ -155,6 +159,16 @@ namespace oceanbase
       return table_id_;
     }
 
+    inline void ObSqlReadParam::set_accept_compact_row(const bool accept)
+    {
+      accept_compact_row_ = accept;
+    }
+
+    inline bool ObSqlReadParam::get_accept_compact_row() const
+    {
+      return accept_compact_row_;
+    }
+
     inline bool ObSqlReadParam::has_project() const
     {
       return has_project_;
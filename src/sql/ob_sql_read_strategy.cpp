@@ -14,6 +14,7 @@
  *
  */
 
+#include <algorithm>
 #include "ob_sql_read_strategy.h"
 
 using namespace oceanbase;
@@ -23,6 +24,7 @@ using namespace sql;
 ObSqlReadStrategy::ObSqlReadStrategy()
   :simple_in_filter_list_(common::OB_MALLOC_BLOCK_SIZE, ModulePageAllocator(ObModIds::OB_SQL_READ_STRATEGY)),
    simple_cond_filter_list_(common::OB_MALLOC_BLOCK_SIZE, ModulePageAllocator(ObModIds::OB_SQL_READ_STRATEGY)),
+   simple_value_list_filter_list_(common::OB_MALLOC_BLOCK_SIZE, ModulePageAllocator(ObModIds::OB_SQL_READ_STRATEGY)),
    rowkey_info_(NULL)
 {
   memset(start_key_mem_hold_, 0, sizeof(start_key_mem_hold_));
@@ -88,6 +90,255 @@ int ObSqlReadStrategy::find_scan_range(ObNewRange &range, bool &found, bool sing
   return ret;
 }
 
+int ObSqlReadStrategy::find_scan_ranges(ObArray<ObNewRange> &ranges, PageArena<ObObj,common::ModulePageAllocator> &objs_allocator)
+{
+  int ret = OB_SUCCESS;
+  int64_t idx = 0;
+  int64_t i = 0;
+  int64_t j = 0;
+  int64_t k = 0;
+  int64_t rowkey_size = 0;
+  // 已展开的rowkey前缀: prefix_count个取值组合，每个组合prefix_size列
+  int64_t prefix_size = 0;
+  int64_t prefix_count = 1;
+  uint64_t column_id = OB_INVALID_ID;
+  bool found_start = false;
+  bool found_end = false;
+  bool found_values = false;
+  ObArray<ObObj> values;
+  ObArray<ObObj> prefixes;
+  ObArray<ObObj> new_prefixes;
+  OB_ASSERT(NULL != rowkey_info_);
+  rowkey_size = rowkey_info_->get_size();
+  ranges.clear();
+  for (idx = 0; idx < rowkey_size; idx++)
+  {
+    start_key_objs_[idx].set_min_value();
+    end_key_objs_[idx].set_max_value();
+  }
+
+  for (idx = 0; OB_SUCCESS == ret && idx < rowkey_size; idx++)
+  {
+    bool is_point = false;
+    if (OB_SUCCESS != (ret = rowkey_info_->get_column_id(idx, column_id)))
+    {
+      TBSYS_LOG(WARN, "fail to get column id ret=%d, idx=%ld, column_id=%ld", ret, idx, column_id);
+    }
+    else if (OB_SUCCESS != (ret = find_closed_column_range(idx, column_id, found_start, found_end, false)))
+    {
+      TBSYS_LOG(WARN, "fail to find closed column range for column %lu", column_id);
+    }
+    else if (prefix_size < idx)
+    {
+      // 前面已经有范围列，后面的列只用于收紧边界，和find_scan_range一致
+    }
+    else if (OB_SUCCESS != (ret = find_column_values(idx, column_id, found_start, found_end,
+            values, found_values, objs_allocator)))
+    {
+      TBSYS_LOG(WARN, "fail to find value list for column %lu", column_id);
+    }
+    else if (found_values && values.count() > 0)
+    {
+      if (prefix_count * values.count() <= MAX_SCAN_RANGE_COUNT)
+      {
+        is_point = true;
+      }
+      else
+      {
+        start_key_objs_[idx] = values.at(0);
+        end_key_objs_[idx] = values.at(values.count() - 1);
+        found_start = true;
+        found_end = true;
+      }
+    }
+    else if (found_start && found_end && start_key_objs_[idx] == end_key_objs_[idx])
+    {
+      values.clear();
+      if (OB_SUCCESS != (ret = values.push_back(start_key_objs_[idx])))
+      {
+        TBSYS_LOG(WARN, "fail to push value. ret=%d", ret);
+      }
+      else
+      {
+        is_point = true;
+      }
+    }
+
+    if (OB_SUCCESS == ret && is_point)
+    {
+      new_prefixes.clear();
+      for (i = 0; OB_SUCCESS == ret && i < prefix_count; i++)
+      {
+        for (j = 0; OB_SUCCESS == ret && j < values.count(); j++)
+        {
+          for (k = 0; OB_SUCCESS == ret && k < prefix_size; k++)
+          {
+            ret = new_prefixes.push_back(prefixes.at(i * prefix_size + k));
+          }
+          if (OB_SUCCESS == ret)
+          {
+            ret = new_prefixes.push_back(values.at(j));
+          }
+        }
+      }
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "fail to expand rowkey prefix. ret=%d", ret);
+      }
+      else
+      {
+        prefixes = new_prefixes;
+        prefix_count *= values.count();
+        prefix_size++;
+      }
+    }
+    else if (OB_SUCCESS == ret && (!found_start || !found_end))
+    {
+      break; // no more search
+    }
+  }
+
+  // 每个前缀组合生成一个range，前缀之后的列使用公共的边界
+  for (i = 0; OB_SUCCESS == ret && i < prefix_count; i++)
+  {
+    ObNewRange range;
+    ObObj *key_objs = NULL;
+    if (NULL == (key_objs = objs_allocator.alloc(2 * rowkey_size * sizeof(ObObj))))
+    {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      TBSYS_LOG(WARN, "fail to alloc rowkey objs. rowkey_size=%ld", rowkey_size);
+    }
+    else
+    {
+      for (k = 0; k < rowkey_size; k++)
+      {
+        if (k < prefix_size)
+        {
+          key_objs[k] = prefixes.at(i * prefix_size + k);
+          key_objs[rowkey_size + k] = key_objs[k];
+        }
+        else
+        {
+          key_objs[k] = start_key_objs_[k];
+          key_objs[rowkey_size + k] = end_key_objs_[k];
+        }
+      }
+      range.border_flag_.set_inclusive_start();
+      range.border_flag_.set_inclusive_end();
+      range.start_key_.assign(key_objs, rowkey_size);
+      range.end_key_.assign(key_objs + rowkey_size, rowkey_size);
+      if (OB_SUCCESS != (ret = ranges.push_back(range)))
+      {
+        TBSYS_LOG(WARN, "fail to push range. ret=%d", ret);
+      }
+    }
+  }
+  return ret;
+}
+
+int ObSqlReadStrategy::find_column_values(int64_t idx, uint64_t column_id, bool found_start, bool found_end,
+    ObArray<ObObj> &values, bool &found, PageArena<ObObj,common::ModulePageAllocator> &objs_allocator)
+{
+  int ret = OB_SUCCESS;
+  int64_t i = 0;
+  int64_t j = 0;
+  int64_t count = 0;
+  int64_t used_buf_len = 0;
+  uint64_t cond_cid = OB_INVALID_ID;
+  char *cast_buf = NULL;
+  char *varchar_buf = NULL;
+  ObString varchar;
+  ObArray<ObObj> list;
+  const ObRowkeyColumn *column = rowkey_info_->get_column(idx);
+  found = false;
+  values.clear();
+  if (NULL == column)
+  {
+    ret = OB_ERR_UNEXPECTED;
+    TBSYS_LOG(WARN, "get column from rowkey_info failed, idx=%ld", idx);
+  }
+  for (i = 0; OB_SUCCESS == ret && !found && i < simple_value_list_filter_list_.count(); i++)
+  {
+    if (simple_value_list_filter_list_.at(i).is_simple_value_list(true, cond_cid, list) && cond_cid == column_id)
+    {
+      found = true;
+      values.clear();
+      for (j = 0; OB_SUCCESS == ret && found && j < list.count(); j++)
+      {
+        ObObj value = list.at(j);
+        if (value.is_null())
+        {
+          // null never equals to any rowkey value
+          continue;
+        }
+        else if (value.get_type() != column->type_)
+        {
+          if (ObVarcharType == column->type_ && NULL == cast_buf
+              && NULL == (cast_buf = (char*)objs_allocator.alloc(OB_MAX_VARCHAR_LENGTH)))
+          {
+            ret = OB_ALLOCATE_MEMORY_FAILED;
+            TBSYS_LOG(WARN, "fail to alloc cast buffer");
+          }
+          else if (OB_SUCCESS != obj_cast(value, column->type_, cast_buf, OB_MAX_VARCHAR_LENGTH, used_buf_len))
+          {
+            // leave it to the filter
+            TBSYS_LOG(DEBUG, "can not cast value to rowkey column type, value=%s, type=%d",
+                to_cstring(list.at(j)), column->type_);
+            found = false;
+          }
+          else if (ObVarcharType == column->type_)
+          {
+            if (NULL == (varchar_buf = (char*)objs_allocator.alloc(used_buf_len)))
+            {
+              ret = OB_ALLOCATE_MEMORY_FAILED;
+              TBSYS_LOG(WARN, "fail to alloc varchar buffer, len=%ld", used_buf_len);
+            }
+            else
+            {
+              memcpy(varchar_buf, cast_buf, used_buf_len);
+              varchar.assign_ptr(varchar_buf, static_cast<ObString::obstr_size_t>(used_buf_len));
+              value.set_varchar(varchar);
+            }
+          }
+        }
+        if (OB_SUCCESS != ret || !found)
+        {
+          // nop
+        }
+        else if ((found_start && value < start_key_objs_[idx]) || (found_end && value > end_key_objs_[idx]))
+        {
+          // out of the range of other conditions on this column
+        }
+        else if (OB_SUCCESS != (ret = values.push_back(value)))
+        {
+          TBSYS_LOG(WARN, "fail to push value. ret=%d", ret);
+        }
+      }
+    }
+  }
+  if (OB_SUCCESS == ret && found && values.count() > 1)
+  {
+    ObObj *objs = &values.at(0);
+    std::sort(objs, objs + values.count());
+    for (i = 1, count = 1; i < values.count(); i++)
+    {
+      if (objs[i] != objs[count - 1])
+      {
+        objs[count++] = objs[i];
+      }
+    }
+    while (values.count() > count)
+    {
+      values.pop_back();
+    }
+  }
+  if (!found)
+  {
+    values.clear();
+  }
+  return ret;
+}
+
 int ObSqlReadStrategy::find_closed_column_range(int64_t idx, uint64_t column_id, bool &found_start, bool &found_end, bool single_row_only)
 {
   int ret = OB_SUCCESS;
@@ -570,6 +821,7 @@ int ObSqlReadStrategy::add_filter(const ObSqlExpression &expr)
     ObArray<ObRowkey> rowkey_array;
     common::PageArena<ObObj,common::ModulePageAllocator> rowkey_objs_allocator(
         PageArena<ObObj, ModulePageAllocator>::DEFAULT_PAGE_SIZE,ModulePageAllocator(ObModIds::OB_SQL_COMMON));
+    ObArray<ObObj> values;
     if (true == expr.is_simple_in_expr(*rowkey_info_, rowkey_array, rowkey_objs_allocator))
     {
       // TBSYS_LOG(DEBUG, "simple in expr [%s]", to_cstring(expr));
@@ -578,6 +830,13 @@ int ObSqlReadStrategy::add_filter(const ObSqlExpression &expr)
         TBSYS_LOG(WARN, "fail to add simple filter. ret=%d", ret);
       }
     }
+    else if (expr.is_simple_value_list(true, cid, values))
+    {
+      if (OB_SUCCESS != (ret = simple_value_list_filter_list_.push_back(expr)))
+      {
+        TBSYS_LOG(WARN, "fail to add simple filter. ret=%d", ret);
+      }
+    }
   }
 
   return ret;
@@ -699,6 +958,44 @@ int ObSqlReadStrategy::find_rowkeys_from_in_expr(ObArray<ObRowkey> &rowkey_array
   return ret;
 }
 
+bool ObSqlReadStrategy::has_leading_rowkey_condition() const
+{
+  bool ret = (0 < simple_in_filter_list_.count());
+  uint64_t rowkey_column_id = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  int64_t op = T_INVALID;
+  ObObj val1;
+  ObObj val2;
+  ObArray<ObObj> values;
+  OB_ASSERT(NULL != rowkey_info_);
+  if (ret || OB_SUCCESS != rowkey_info_->get_column_id(0, rowkey_column_id))
+  {
+  }
+  else
+  {
+    for (int64_t i = 0; !ret && i < simple_cond_filter_list_.count(); i++)
+    {
+      const ObSqlExpression &expr = simple_cond_filter_list_.at(i);
+      if ((expr.is_simple_condition(true, cid, op, val1)
+            || expr.is_simple_between(true, cid, op, val1, val2))
+          && rowkey_column_id == cid)
+      {
+        ret = true;
+      }
+    }
+    for (int64_t i = 0; !ret && i < simple_value_list_filter_list_.count(); i++)
+    {
+      values.clear();
+      if (simple_value_list_filter_list_.at(i).is_simple_value_list(true, cid, values)
+          && rowkey_column_id == cid)
+      {
+        ret = true;
+      }
+    }
+  }
+  return ret;
+}
+
 int ObSqlReadStrategy::get_read_method(ObArray<ObRowkey> &rowkey_array, PageArena<ObObj,common::ModulePageAllocator> &rowkey_objs_allocator, int32_t &read_method)
 {
   int ret = OB_SUCCESS;
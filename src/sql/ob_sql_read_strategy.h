@@ -51,15 +51,33 @@ namespace oceanbase
         int find_rowkeys_from_equal_expr(ObArray<ObRowkey> &rowkey_array, PageArena<ObObj,common::ModulePageAllocator> &objs_allocator);
         int find_rowkeys_from_in_expr(ObArray<ObRowkey> &rowkey_array, common::PageArena<ObObj,common::ModulePageAllocator> &objs_allocator);
         int find_scan_range(ObNewRange &range, bool &found, bool single_row_only);
+        /*
+         * 利用rowkey前缀列上的等值列表(in/or)以及等值条件，结合其后第一个rowkey列上的范围条件，
+         * 生成按rowkey有序且互不相交的多个scan range，跳过前缀值之间的数据
+         *
+         * example: rowkey(a, b, c), where a in (1, 3) and b between 10 and 20
+         *   ==> [(1,10,MIN) ; (1,20,MAX)], [(3,10,MIN) ; (3,20,MAX)]
+         *
+         * 没有可用的等值列表时ranges为空，由调用者退回到find_scan_range；
+         * range的个数超过MAX_SCAN_RANGE_COUNT时，剩余的等值列表只用于收紧边界
+         */
+        int find_scan_ranges(ObArray<ObNewRange> &ranges, common::PageArena<ObObj,common::ModulePageAllocator> &objs_allocator);
+        /*
+         * 第一个rowkey列上是否有可以限定scan范围的条件(等值、范围、in/or等值列表)，
+         * 没有时只能全表扫描，用于选择索引表
+         */
+        bool has_leading_rowkey_condition() const;
       public:
         static const int32_t USE_METHOD_UNKNOWN = 0;
         static const int32_t USE_SCAN = 1;
         static const int32_t USE_GET = 2;
+        static const int64_t MAX_SCAN_RANGE_COUNT = 128;
 
       private:
         static const int64_t COMMON_FILTER_NUM = 8;
         ObSEArray<ObSqlExpression, COMMON_FILTER_NUM> simple_in_filter_list_;
         ObSEArray<ObSqlExpression, COMMON_FILTER_NUM> simple_cond_filter_list_;
+        ObSEArray<ObSqlExpression, COMMON_FILTER_NUM> simple_value_list_filter_list_;
         const common::ObRowkeyInfo *rowkey_info_;
         common::ObObj start_key_objs_[OB_MAX_ROWKEY_COLUMN_NUMBER];
         common::ObObj end_key_objs_[OB_MAX_ROWKEY_COLUMN_NUMBER];
@@ -69,6 +87,8 @@ namespace oceanbase
       private:
         int find_single_column_range(int64_t idx, uint64_t column_id, bool &found);
         int find_closed_column_range(int64_t idx, uint64_t column_id, bool &found_start, bool &found_end, bool single_row_only);
+        int find_column_values(int64_t idx, uint64_t column_id, bool found_start, bool found_end,
+            ObArray<ObObj> &values, bool &found, common::PageArena<ObObj,common::ModulePageAllocator> &objs_allocator);
     };
   }
 }
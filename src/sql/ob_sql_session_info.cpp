@@ -22,8 +22,10 @@ ObSQLSessionInfo::ObSQLSessionInfo()
    stmt_name_id_map_allocer_(SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_)),
   var_name_val_map_allocer_(SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_)),
   sys_var_val_map_allocer_(SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_)),
+  plan_cache_map_allocer_(SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_)),
   arena_pointers_(sizeof(ObArenaAllocator), SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_)),
-  result_set_pool_(SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_))
+  result_set_pool_(SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_)),
+  plan_node_pool_(SMALL_BLOCK_SIZE, ObWrapperAllocator(&block_allocator_))
 {
 }
 
@@ -66,6 +68,12 @@ int ObSQLSessionInfo::init(common::DefaultBlockAllocator &block_allocator)
   {
     TBSYS_LOG(WARN, "init sys_var_value map failed, ret=%d", ret);
   }
+  else if (OB_SUCCESS != (ret = plan_cache_map_.create(hash::cal_next_prime(64),
+                                               &plan_cache_map_allocer_,
+                                               &block_allocator_)))
+  {
+    TBSYS_LOG(WARN, "init plan cache map failed, ret=%d", ret);
+  }
   else if (OB_SUCCESS != (ret = transformer_mem_pool_.init(&block_allocator, OB_COMMON_MEM_BLOCK_SIZE)))
   {
     TBSYS_LOG(WARN, "failed to init transformer mem pool, err=%d", ret);
@@ -79,6 +87,14 @@ int ObSQLSessionInfo::init(common::DefaultBlockAllocator &block_allocator)
 
 void ObSQLSessionInfo::destroy()
 {
+  while (!cached_plan_list_.is_empty())
+  {
+    remove_cached_plan_node(static_cast<CachedPlanNode*>(cached_plan_list_.get_real_first()));
+  }
+  while (!uncacheable_plan_list_.is_empty())
+  {
+    remove_cached_plan_node(static_cast<CachedPlanNode*>(uncacheable_plan_list_.get_real_first()));
+  }
   IdPlanMap::iterator iter;
   for (iter = id_plan_map_.begin(); iter != id_plan_map_.end(); iter++)
   {
@@ -238,6 +254,149 @@ ObResultSet* ObSQLSessionInfo::get_plan(const ObString& stmt_name) const
   return result_set;
 }
 
+int ObSQLSessionInfo::get_cached_plan(const ObString& key, const int64_t schema_version,
+                                      const int64_t privilege_version, ObResultSet *&result_set)
+{
+  int ret = OB_SUCCESS;
+  CachedPlanNode *node = NULL;
+  result_set = NULL;
+  if (hash::HASH_EXIST != plan_cache_map_.get(key, node))
+  {
+    ret = OB_ENTRY_NOT_EXIST;
+  }
+  else if (node->schema_version_ != schema_version
+           || node->privilege_version_ != privilege_version)
+  {
+    // schema or privilege changed, the plan is expired
+    remove_cached_plan_node(node);
+    OB_STAT_INC(SQL, SQL_PLAN_CACHE_EXPIRE_COUNT);
+    ret = OB_ENTRY_NOT_EXIST;
+  }
+  else if (NULL == node->result_set_)
+  {
+    uncacheable_plan_list_.move_to_first(node);
+    ret = OB_NOT_SUPPORTED;
+  }
+  else
+  {
+    cached_plan_list_.move_to_first(node);
+    result_set = node->result_set_;
+  }
+  return ret;
+}
+
+int ObSQLSessionInfo::store_cached_plan(const ObString& key, const int64_t schema_version,
+                                        const int64_t privilege_version, const int64_t max_cached_plans,
+                                        ObResultSet& result_set, ObResultSet *&stored_result_set)
+{
+  int ret = OB_SUCCESS;
+  ObResultSet *new_res_set = NULL;
+  stored_result_set = NULL;
+  if (NULL == (new_res_set = result_set_pool_.alloc()))
+  {
+    TBSYS_LOG(ERROR, "ob malloc for ObResultSet failed");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else
+  {
+    // not in id_plan_map_, the client can neither see nor close it
+    result_set.set_statement_id(get_new_stmt_id());
+    if (OB_SUCCESS != (ret = result_set.to_prepare(*new_res_set)))
+    {
+      TBSYS_LOG(WARN, "failed to store cached plan, err=%d", ret);
+      result_set_pool_.free(new_res_set);
+    }
+    else if (OB_SUCCESS != (ret = add_cached_plan_node(key, schema_version, privilege_version,
+                                                       max_cached_plans, new_res_set)))
+    {
+      result_set_pool_.free(new_res_set);
+    }
+    else
+    {
+      stored_result_set = new_res_set;
+    }
+  }
+  return ret;
+}
+
+int ObSQLSessionInfo::set_plan_uncacheable(const ObString& key, const int64_t schema_version,
+                                           const int64_t privilege_version, const int64_t max_cached_plans)
+{
+  return add_cached_plan_node(key, schema_version, privilege_version, max_cached_plans, NULL);
+}
+
+int ObSQLSessionInfo::add_cached_plan_node(const ObString& key, const int64_t schema_version,
+                                           const int64_t privilege_version, const int64_t max_count,
+                                           ObResultSet *result_set)
+{
+  int ret = OB_SUCCESS;
+  CachedPlanNode *node = NULL;
+  char *key_buf = NULL;
+  DList &list = (NULL == result_set) ? uncacheable_plan_list_ : cached_plan_list_;
+  if (hash::HASH_EXIST == plan_cache_map_.get(key, node))
+  {
+    remove_cached_plan_node(node);
+    node = NULL;
+  }
+  // make room for the new one, the least recently used goes first
+  while (0 < list.get_size() && list.get_size() >= max_count)
+  {
+    remove_cached_plan_node(static_cast<CachedPlanNode*>(list.get_header()->get_prev()));
+    OB_STAT_INC(SQL, SQL_PLAN_CACHE_EVICT_COUNT);
+  }
+  if (NULL == (key_buf = static_cast<char*>(ob_malloc(key.length(), ObModIds::OB_SQL_SESSION))))
+  {
+    TBSYS_LOG(WARN, "no memory for plan cache key, len=%d", key.length());
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+  }
+  else if (NULL == (node = plan_node_pool_.alloc()))
+  {
+    TBSYS_LOG(WARN, "no memory for plan cache node");
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    ob_free(key_buf);
+  }
+  else
+  {
+    memcpy(key_buf, key.ptr(), key.length());
+    node->key_.assign_ptr(key_buf, key.length());
+    node->result_set_ = result_set;
+    node->schema_version_ = schema_version;
+    node->privilege_version_ = privilege_version;
+    if (hash::HASH_INSERT_SUCC != plan_cache_map_.set(node->key_, node))
+    {
+      TBSYS_LOG(ERROR, "failed to add cached plan, key=%.*s", key.length(), key.ptr());
+      ret = OB_ERROR;
+      node->result_set_ = NULL;
+      plan_node_pool_.free(node);
+      ob_free(key_buf);
+    }
+    else
+    {
+      list.add_first(node);
+    }
+  }
+  return ret;
+}
+
+void ObSQLSessionInfo::remove_cached_plan_node(CachedPlanNode *node)
+{
+  if (NULL != node)
+  {
+    if (NULL == node->result_set_)
+    {
+      uncacheable_plan_list_.remove(node);
+    }
+    else
+    {
+      cached_plan_list_.remove(node);
+      result_set_pool_.free(node->result_set_); // will free the ps_transformer_allocator to the session
+    }
+    plan_cache_map_.erase(node->key_);
+    ob_free(node->key_.ptr());
+    plan_node_pool_.free(node);
+  }
+}
+
 int ObSQLSessionInfo::replace_variable(const ObString& var, const ObObj& val)
 {
   int ret = OB_SUCCESS;
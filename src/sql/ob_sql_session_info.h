@@ -28,6 +28,7 @@
 #include "common/page_arena.h"
 #include "common/ob_pool.h"
 #include "common/ob_pooled_allocator.h"
+#include "common/dlist.h"
 namespace oceanbase
 {
   namespace sql
@@ -76,6 +77,24 @@ namespace oceanbase
                                         common::hash::NormalPointer,
                                         common::ObSmallBlockAllocator<>
                                         > SysVarNameValMap;
+        struct CachedPlanNode: public common::DLink
+        {
+          common::ObString key_;      // owned by the node
+          ObResultSet *result_set_;   // NULL means the statement can not be cached
+          int64_t schema_version_;
+          int64_t privilege_version_;
+          CachedPlanNode(): result_set_(NULL), schema_version_(0), privilege_version_(0) {}
+        };
+        typedef common::ObPooledAllocator<common::hash::HashMapTypes<common::ObString, CachedPlanNode*>::AllocType, common::ObWrapperAllocator> PlanCacheMapAllocer;
+        typedef common::hash::ObHashMap<common::ObString,
+                                        CachedPlanNode*,
+                                        common::hash::NoPthreadDefendMode,
+                                        common::hash::hash_func<common::ObString>,
+                                        common::hash::equal_to<common::ObString>,
+                                        PlanCacheMapAllocer,
+                                        common::hash::NormalPointer,
+                                        common::ObSmallBlockAllocator<>
+                                        > PlanCacheMap;
       public:
         ObSQLSessionInfo();
         ~ObSQLSessionInfo();
@@ -112,6 +131,38 @@ namespace oceanbase
         bool plan_exists(const common::ObString& stmt_name, uint64_t *stmt_id = NULL);
         ObResultSet* get_plan(const uint64_t& stmt_id) const;
         ObResultSet* get_plan(const common::ObString& stmt_name) const;
+        /**
+         * look up the plan cache with a parameterized statement
+         *
+         * @param key [in] parameterized statement text
+         * @param schema_version [in] version of the schema used by this query
+         * @param privilege_version [in] version of the privilege used by this query
+         * @param result_set [out] the stored plan
+         *
+         * @return OB_SUCCESS if hit,
+         *         OB_ENTRY_NOT_EXIST if the plan should be generated and cached,
+         *         OB_NOT_SUPPORTED if the plan should not be cached
+         */
+        int get_cached_plan(const common::ObString& key, const int64_t schema_version,
+                            const int64_t privilege_version, ObResultSet *&result_set);
+        /**
+         * store the prepared result set as the cached plan of key, the
+         * least recently used plans are evicted to keep at most
+         * max_cached_plans plans. Cached plans are kept apart from the
+         * prepared statements of the client and don't use their ids.
+         */
+        int store_cached_plan(const common::ObString& key, const int64_t schema_version,
+                              const int64_t privilege_version, const int64_t max_cached_plans,
+                              ObResultSet& result_set, ObResultSet *&stored_result_set);
+        /**
+         * remember that key can not be cached under the given versions,
+         * kept in another LRU list of at most max_cached_plans keys which
+         * doesn't take room from the plans
+         */
+        int set_plan_uncacheable(const common::ObString& key, const int64_t schema_version,
+                                 const int64_t privilege_version, const int64_t max_cached_plans);
+        int64_t get_cached_plan_count() const {return cached_plan_list_.get_size();};
+        int64_t get_uncacheable_plan_count() const {return uncacheable_plan_list_.get_size();};
         int set_username(const common::ObString & user_name);
         void set_warnings_buf();
         int64_t to_string(char* buffer, const int64_t length) const;
@@ -133,6 +184,11 @@ namespace oceanbase
         bool get_autocommit() const {return is_autocommit_;};
         // get system variable value
         bool is_create_sys_table_disabled() const;
+      private:
+        int add_cached_plan_node(const common::ObString& key, const int64_t schema_version,
+                                 const int64_t privilege_version, const int64_t max_count,
+                                 ObResultSet *result_set);
+        void remove_cached_plan_node(CachedPlanNode *node);
       private:
         static const int64_t MAX_STORED_PLANS_COUNT = 10240;
         static const int64_t MAX_CACHED_ARENA_COUNT = 2;
@@ -163,11 +219,16 @@ namespace oceanbase
         VarNameValMap var_name_val_map_; // user variables
         SysVarNameValMapAllocer sys_var_val_map_allocer_;
         SysVarNameValMap sys_var_val_map_; // system variables
+        PlanCacheMapAllocer plan_cache_map_allocer_;
+        PlanCacheMap plan_cache_map_; // parameterized-statement -> cached plan
+        common::DList cached_plan_list_; // LRU list of cached plans, most recently used first
+        common::DList uncacheable_plan_list_; // LRU list of statements can not be cached
 
         // PS related
         common::ObPool<common::ObWrapperAllocator> arena_pointers_;
         common::ObList<common::ObArenaAllocator *> free_arena_for_transformer_;
         common::ObPooledAllocator<ObResultSet, common::ObWrapperAllocator> result_set_pool_;
+        common::ObPooledAllocator<CachedPlanNode, common::ObWrapperAllocator> plan_node_pool_;
     };
   }
 }
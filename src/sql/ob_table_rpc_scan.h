@@ -92,6 +92,11 @@ namespace oceanbase
         {
           rpc_scan_.set_rowkey_cell_count(rowkey_cell_count);
         }
+        /// 按索引表scan出的rowkey回表get，只用于get方式
+        void set_index_lookup(ObPhyOperator &lookup)
+        {
+          rpc_scan_.set_index_lookup(lookup);
+        }
 
         NEED_SERIALIZE_AND_DESERIALIZE;
 
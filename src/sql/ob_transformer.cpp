@@ -1244,6 +1244,170 @@ int ObTransformer::gen_phy_scalar_aggregate(
   return ret;
 }
 
+int ObTransformer::gen_phy_table_by_index(
+    ObLogicalPlan *logical_plan,
+    ObPhysicalPlan *physical_plan,
+    ErrStat& err_stat,
+    ObStmt *stmt,
+    const TableItem &table_item,
+    const ObBitSet<> &table_bitset,
+    ObTableRpcScan &table_rpc_scan_op,
+    ObRpcScanHint &hint)
+{
+  int& ret = err_stat.err_code_ = OB_SUCCESS;
+  const ObSchemaManagerV2 *schema_manager = sql_context_->schema_manager_;
+  const ObTableSchema *index_tables[OB_MAX_INDEX_TABLE_NUMBER];
+  const ObTableSchema *index_table = NULL;
+  int64_t index_num = OB_MAX_INDEX_TABLE_NUMBER;
+  int32_t num = stmt->get_condition_size();
+  if (OB_SUCCESS != (ret = schema_manager->get_index_tables(table_item.ref_id_, index_tables, index_num)))
+  {
+    TRANS_LOG("fail to get index tables of table[%ld]", table_item.ref_id_);
+  }
+  // 选第一个已建好且在前缀列上有条件的索引表
+  for (int64_t i = 0; OB_SUCCESS == ret && NULL == index_table && i < index_num; i++)
+  {
+    ObSqlReadStrategy index_read_strategy;
+    if (!index_tables[i]->is_index_built())
+    {
+      TBSYS_LOG(DEBUG, "index table[%lu] is not built yet", index_tables[i]->get_table_id());
+      continue;
+    }
+    index_read_strategy.set_rowkey_info(index_tables[i]->get_rowkey_info());
+    for (int32_t j = 0; ret == OB_SUCCESS && j < num; j++)
+    {
+      ObSqlRawExpr *cnd_expr = logical_plan->get_expr(stmt->get_condition_id(j));
+      if (cnd_expr && table_bitset.is_superset(cnd_expr->get_tables_set()))
+      {
+        ObSqlExpression filter;
+        if ((ret = cnd_expr->fill_sql_expression(filter, this, logical_plan, physical_plan)) != OB_SUCCESS)
+        {
+          TRANS_LOG("Add table filter condition faild");
+        }
+        else if (OB_SUCCESS != (ret = index_read_strategy.add_filter(filter)))
+        {
+          TBSYS_LOG(WARN, "fail to add filter:ret[%d]", ret);
+        }
+      }
+    }
+    if (OB_SUCCESS == ret && index_read_strategy.has_leading_rowkey_condition())
+    {
+      index_table = index_tables[i];
+    }
+  }
+  if (OB_SUCCESS == ret && NULL != index_table)
+  {
+    const uint64_t index_tid = index_table->get_table_id();
+    bool is_covered = true;
+    for (int32_t i = 0; is_covered && i < stmt->get_column_size(); i++)
+    {
+      const ColumnItem *col_item = stmt->get_column_item(i);
+      if (col_item && col_item->table_id_ == table_item.table_id_
+        && NULL == schema_manager->get_column_schema(index_tid, col_item->column_id_))
+      {
+        is_covered = false;
+      }
+    }
+    if (is_covered)
+    {
+      // 索引表与数据表列id相同，直接把索引表当作数据表扫描
+      if (OB_SUCCESS != (ret = table_rpc_scan_op.set_table(table_item.table_id_, index_tid)))
+      {
+        TRANS_LOG("ObTableRpcScan set table faild");
+      }
+      else
+      {
+        TBSYS_LOG(DEBUG, "table[%lu] read by covering index table[%lu]", table_item.ref_id_, index_tid);
+      }
+    }
+    else
+    {
+      ObTableRpcScan *index_scan_op = NULL;
+      ObRpcScanHint index_hint = hint;
+      const ObRowkeyInfo &rowkey_info = index_table->get_rowkey_info();
+      const ObTableSchema *table_schema = schema_manager->get_table_schema(table_item.ref_id_);
+      const ObRowkeyInfo &data_rowkey_info = table_schema->get_rowkey_info();
+      uint64_t cid = OB_INVALID_ID;
+      int64_t op = T_INVALID;
+      ObObj val1;
+      ObObj val2;
+      ObArray<ObObj> values;
+      index_hint.read_method_ = ObSqlReadStrategy::USE_SCAN;
+      CREATE_PHY_OPERRATOR(index_scan_op, ObTableRpcScan, physical_plan, err_stat);
+      if (ret == OB_SUCCESS
+        && (ret = index_scan_op->set_table(table_item.table_id_, index_tid)) != OB_SUCCESS)
+      {
+        TRANS_LOG("ObTableRpcScan set table faild");
+      }
+      else if (ret == OB_SUCCESS && (ret = index_scan_op->init(sql_context_, index_hint)) != OB_SUCCESS)
+      {
+        TRANS_LOG("ObTableRpcScan init faild");
+      }
+      // 只把索引列上的简单条件下压到索引表，所有条件在回表后仍会再过滤一次
+      for (int32_t i = 0; ret == OB_SUCCESS && i < num; i++)
+      {
+        ObSqlRawExpr *cnd_expr = logical_plan->get_expr(stmt->get_condition_id(i));
+        if (cnd_expr && table_bitset.is_superset(cnd_expr->get_tables_set()))
+        {
+          ObSqlExpression *filter = ObSqlExpression::alloc();
+          if (NULL == filter)
+          {
+            ret = OB_ALLOCATE_MEMORY_FAILED;
+            TRANS_LOG("no memory");
+          }
+          else if ((ret = cnd_expr->fill_sql_expression(*filter, this, logical_plan, physical_plan)) != OB_SUCCESS)
+          {
+            TRANS_LOG("Add table filter condition faild");
+          }
+          else if ((filter->is_simple_condition(true, cid, op, val1)
+                || filter->is_simple_between(true, cid, op, val1, val2)
+                || filter->is_simple_value_list(true, cid, values))
+            && rowkey_info.is_rowkey_column(cid))
+          {
+            // filter归index_scan_op所有
+            if ((ret = index_scan_op->add_filter(filter)) != OB_SUCCESS)
+            {
+              TRANS_LOG("Add table filter condition faild");
+            }
+            filter = NULL;
+          }
+          if (NULL != filter)
+          {
+            ObSqlExpression::free(filter);
+          }
+          values.clear();
+        }
+      }
+      // 索引表输出数据表的rowkey
+      for (int64_t i = 0; ret == OB_SUCCESS && i < data_rowkey_info.get_size(); i++)
+      {
+        if (OB_SUCCESS != (ret = data_rowkey_info.get_column_id(i, cid)))
+        {
+          TRANS_LOG("fail to get rowkey column. idx=%ld", i);
+        }
+        else
+        {
+          ObBinaryRefRawExpr col_expr(table_item.table_id_, cid, T_REF_COLUMN);
+          ObSqlRawExpr col_raw_expr(common::OB_INVALID_ID, table_item.table_id_, cid, &col_expr);
+          ObSqlExpression output_expr;
+          if ((ret = col_raw_expr.fill_sql_expression(output_expr, this, logical_plan, physical_plan)) != OB_SUCCESS
+            || (ret = index_scan_op->add_output_column(output_expr)) != OB_SUCCESS)
+          {
+            TRANS_LOG("Add table output columns faild");
+          }
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        table_rpc_scan_op.set_index_lookup(*index_scan_op);
+        hint.read_method_ = ObSqlReadStrategy::USE_GET;
+        TBSYS_LOG(DEBUG, "table[%lu] read by lookup of index table[%lu]", table_item.ref_id_, index_tid);
+      }
+    }
+  }
+  return ret;
+}
+
 int ObTransformer::gen_phy_joins(
     ObLogicalPlan *logical_plan,
     ObPhysicalPlan *physical_plan,
@@ -1958,6 +2122,12 @@ int ObTransformer::gen_phy_table(
           }
           hint.read_method_ = read_method;
         }
+        if (OB_SUCCESS == ret && ObSqlReadStrategy::USE_SCAN == hint.read_method_
+          && !sql_read_strategy.has_leading_rowkey_condition())
+        {
+          ret = gen_phy_table_by_index(logical_plan, physical_plan, err_stat, stmt, *table_item,
+                                       table_bitset, *table_rpc_scan_op, hint);
+        }
 
         if (ret == OB_SUCCESS && (ret = table_rpc_scan_op->init(sql_context_, hint)) != OB_SUCCESS)
         {
@@ -2481,6 +2651,9 @@ int ObTransformer::gen_physical_replace(
   {
     TRANS_LOG("Fail to get statement");
   }
+  else if (OB_SUCCESS != (ret = check_index_dml(insert_stmt->get_table_id(), true, err_stat)))
+  {
+  }
   else if (NULL == CREATE_PHY_OPERRATOR(ups_modify, ObUpsModify, inner_plan, err_stat))
   {
     ret = OB_ALLOCATE_MEMORY_FAILED;
@@ -4741,6 +4914,9 @@ int ObTransformer::gen_physical_insert_new(
   else if (OB_SUCCESS != (ret = get_stmt(logical_plan, err_stat, query_id, insert_stmt)))
   {
   }
+  else if (OB_SUCCESS != (ret = check_index_dml(insert_stmt->get_table_id(), false, err_stat)))
+  {
+  }
   else if (NULL == CREATE_PHY_OPERRATOR(ups_modify, ObUpsModify, inner_plan, err_stat))
   {
     ret = OB_ALLOCATE_MEMORY_FAILED;
@@ -5366,6 +5542,130 @@ int ObTransformer::cons_row_desc(const uint64_t table_id,
   return ret;
 }
 
+int ObTransformer::check_index_dml(const uint64_t table_id, const bool is_replace, ErrStat& err_stat)
+{
+  int& ret = err_stat.err_code_ = OB_SUCCESS;
+  const ObTableSchema *table_schema = NULL;
+  const ObTableSchema *index_tables[OB_MAX_INDEX_TABLE_NUMBER];
+  int64_t index_num = OB_MAX_INDEX_TABLE_NUMBER;
+  if (NULL == (table_schema = sql_context_->schema_manager_->get_table_schema(table_id)))
+  {
+    ret = OB_ERR_ILLEGAL_ID;
+    TRANS_LOG("fail to get table schema for table[%ld]", table_id);
+  }
+  else if (table_schema->is_index_table())
+  {
+    ret = OB_NOT_SUPPORTED;
+    TRANS_LOG("index table '%s' can not be modified directly", table_schema->get_table_name());
+  }
+  else if (!is_replace)
+  {
+  }
+  else if (OB_SUCCESS != (ret = sql_context_->schema_manager_->get_index_tables(table_id, index_tables, index_num)))
+  {
+    TRANS_LOG("fail to get index tables of table[%ld]", table_id);
+  }
+  else if (0 < index_num)
+  {
+    ret = OB_NOT_SUPPORTED;
+    TRANS_LOG("REPLACE on table '%s' with index is not supported", table_schema->get_table_name());
+  }
+  return ret;
+}
+
+int ObTransformer::add_index_column_items(const uint64_t table_id, ObStmt *stmt, ErrStat& err_stat)
+{
+  int& ret = err_stat.err_code_ = OB_SUCCESS;
+  const ObSchemaManagerV2 *schema_manager = sql_context_->schema_manager_;
+  const ObTableSchema *index_tables[OB_MAX_INDEX_TABLE_NUMBER];
+  int64_t index_num = OB_MAX_INDEX_TABLE_NUMBER;
+  if (OB_SUCCESS != (ret = schema_manager->get_index_tables(table_id, index_tables, index_num)))
+  {
+    TRANS_LOG("fail to get index tables of table[%ld]", table_id);
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < index_num; i++)
+  {
+    int32_t column_num = 0;
+    const ObColumnSchemaV2 *columns = schema_manager->get_table_schema(index_tables[i]->get_table_id(), column_num);
+    for (int32_t j = 0; OB_SUCCESS == ret && NULL != columns && j < column_num; j++)
+    {
+      ColumnItem column_item;
+      const char *name = columns[j].get_name();
+      if (NULL != stmt->get_column_item_by_id(table_id, columns[j].get_id()))
+      {
+        continue;
+      }
+      column_item.column_id_ = columns[j].get_id();
+      column_item.column_name_.assign_ptr(const_cast<char*>(name), static_cast<int32_t>(strlen(name)));
+      column_item.table_id_ = table_id;
+      column_item.query_id_ = stmt->get_query_id();
+      column_item.is_name_unique_ = false;
+      column_item.is_group_based_ = false;
+      column_item.data_type_ = columns[j].get_type();
+      if (OB_SUCCESS != (ret = stmt->add_column_item(column_item)))
+      {
+        TRANS_LOG("fail to add index column %s of table[%ld]", name, table_id);
+      }
+    }
+  }
+  return ret;
+}
+
+int ObTransformer::add_index_old_values(
+    ObLogicalPlan *logical_plan,
+    ObPhysicalPlan *physical_plan,
+    const uint64_t table_id,
+    const ObRowDesc &row_desc,
+    ObProject *project_op,
+    ErrStat& err_stat)
+{
+  int& ret = err_stat.err_code_ = OB_SUCCESS;
+  const ObSchemaManagerV2 *schema_manager = sql_context_->schema_manager_;
+  const ObTableSchema *index_tables[OB_MAX_INDEX_TABLE_NUMBER];
+  int64_t index_num = OB_MAX_INDEX_TABLE_NUMBER;
+  uint64_t tid = OB_INVALID_ID;
+  uint64_t cid = OB_INVALID_ID;
+  ObSqlExpression expr;
+  if (OB_SUCCESS != (ret = schema_manager->get_index_tables(table_id, index_tables, index_num)))
+  {
+    TRANS_LOG("fail to get index tables of table[%ld]", table_id);
+  }
+  // 旧值输出为列cid + OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET，UPS写入前去掉
+  for (int64_t i = row_desc.get_rowkey_cell_count(); OB_SUCCESS == ret && 0 < index_num
+         && i < row_desc.get_column_num(); i++)
+  {
+    bool is_index_column = false;
+    if (OB_SUCCESS != (ret = row_desc.get_tid_cid(i, tid, cid)))
+    {
+      TRANS_LOG("Failed to get tid cid");
+      break;
+    }
+    for (int64_t j = 0; !is_index_column && j < index_num; j++)
+    {
+      is_index_column = (NULL != schema_manager->get_column_schema(index_tables[j]->get_table_id(), cid));
+    }
+    if (is_index_column)
+    {
+      ObBinaryRefRawExpr col_raw_ref(tid, cid, T_REF_COLUMN);
+      expr.reset();
+      ObSqlRawExpr col_ref(OB_INVALID_ID, tid, cid, &col_raw_ref);
+      if (OB_SUCCESS != (ret = col_ref.fill_sql_expression(expr, this, logical_plan, physical_plan)))
+      {
+        TRANS_LOG("Failed to fill expression, err=%d", ret);
+      }
+      else
+      {
+        expr.set_tid_cid(tid, cid + OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET);
+        if (OB_SUCCESS != (ret = project_op->add_output_column(expr)))
+        {
+          TRANS_LOG("Failed to add output column");
+        }
+      }
+    }
+  }
+  return ret;
+}
+
 int ObTransformer::gen_physical_update_new(
     ObLogicalPlan *logical_plan,
     ObPhysicalPlan*& physical_plan,
@@ -5390,6 +5690,12 @@ int ObTransformer::gen_physical_update_new(
   else if (OB_SUCCESS != (ret = get_stmt(logical_plan, err_stat, query_id, update_stmt)))
   {
   }
+  else if (OB_SUCCESS != (ret = check_index_dml(update_stmt->get_update_table_id(), false, err_stat)))
+  {
+  }
+  else if (OB_SUCCESS != (ret = add_index_column_items(update_stmt->get_update_table_id(), update_stmt, err_stat)))
+  {
+  }
   /* generate root operator */
   else if (NULL == CREATE_PHY_OPERRATOR(ups_modify, ObUpsModify, inner_plan, err_stat))
   {
@@ -5522,6 +5828,10 @@ int ObTransformer::gen_physical_update_new(
     } // end for
   }
   if (OB_LIKELY(OB_SUCCESS == ret))
+  {
+    ret = add_index_old_values(logical_plan, inner_plan, table_id, row_desc, project_op, err_stat);
+  }
+  if (OB_LIKELY(OB_SUCCESS == ret))
   {
     ObPhyOperator* table_op = NULL;
     if (OB_SUCCESS != (ret = gen_phy_table_for_update(logical_plan, inner_plan, err_stat,
@@ -5563,6 +5873,12 @@ int ObTransformer::gen_physical_delete_new(
   else if (OB_SUCCESS != (ret = get_stmt(logical_plan, err_stat, query_id, delete_stmt)))
   {
   }
+  else if (OB_SUCCESS != (ret = check_index_dml(delete_stmt->get_delete_table_id(), false, err_stat)))
+  {
+  }
+  else if (OB_SUCCESS != (ret = add_index_column_items(delete_stmt->get_delete_table_id(), delete_stmt, err_stat)))
+  {
+  }
   /* generate root operator */
   else if (NULL == CREATE_PHY_OPERRATOR(ups_modify, ObUpsModify, inner_plan, err_stat))
   {
@@ -5637,6 +5953,10 @@ int ObTransformer::gen_physical_delete_new(
         TRANS_LOG("Failed to add output column");
       }
     }
+    if (OB_LIKELY(OB_SUCCESS == ret))
+    {
+      ret = add_index_old_values(logical_plan, inner_plan, table_id, row_desc, project_op, err_stat);
+    }
   }
   if (OB_LIKELY(OB_SUCCESS == ret))
   {
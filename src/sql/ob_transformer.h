@@ -138,6 +138,17 @@ namespace oceanbase
             ObPhyOperator*& table_op,
             bool* group_agg_pushed_down = NULL,
             bool* limit_pushed_down = NULL);
+        // 数据表第一个rowkey列上没有条件时，选择有条件的索引表：
+        // 查询的列都在索引表中时直接扫描索引表，否则扫描索引表得到rowkey后回表get
+        int gen_phy_table_by_index(
+            ObLogicalPlan *logical_plan,
+            ObPhysicalPlan *physical_plan,
+            ErrStat& err_stat,
+            ObStmt *stmt,
+            const TableItem &table_item,
+            const ObBitSet<> &table_bitset,
+            ObTableRpcScan &table_rpc_scan_op,
+            common::ObRpcScanHint &hint);
         int gen_phy_joins(
             ObLogicalPlan *logical_plan,
             ObPhysicalPlan *physical_plan,
@@ -300,6 +311,17 @@ namespace oceanbase
             const ObRowkeyInfo *&rowkey_info,
             common::ObSEArray<int64_t, 64> &row_desc_map,
             ErrStat& err_stat);
+        // 索引表不能直接修改，有索引表的数据表不支持REPLACE
+        int check_index_dml(const uint64_t table_id, const bool is_replace, ErrStat& err_stat);
+        // UPDATE/DELETE读出索引列的旧值，供UPS维护索引表
+        int add_index_column_items(const uint64_t table_id, ObStmt *stmt, ErrStat& err_stat);
+        int add_index_old_values(
+            ObLogicalPlan *logical_plan,
+            ObPhysicalPlan *physical_plan,
+            const uint64_t table_id,
+            const ObRowDesc &row_desc,
+            ObProject *project_op,
+            ErrStat& err_stat);
         int gen_physical_delete_new(
             ObLogicalPlan *logical_plan,
             ObPhysicalPlan* physical_plan,
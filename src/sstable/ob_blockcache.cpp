@@ -257,7 +257,8 @@ namespace oceanbase
         const int64_t cursor, 
         const bool is_reverse, 
         ObBufferHandle &buffer_handle,
-        const bool check_crc)
+        const bool check_crc,
+        ObReadaheadWindow* window)
     {
       UNUSED(table_id);
       int ret = -1;
@@ -279,6 +280,12 @@ namespace oceanbase
         data_index.sstable_id = sstable_id;
         data_index.offset = current_block.offset_;
         data_index.size = current_block.size_;
+        bool prefetched = false;
+        if (NULL != window)
+        {
+          prefetched = window->access(sstable_id, table_id,
+              current_block.offset_, current_block.size_, is_reverse);
+        }
 
         if (OB_SUCCESS == kv_cache_.get(data_index, output_value, buffer_handle.handle_, true))
         {
@@ -299,12 +306,21 @@ namespace oceanbase
           int64_t readahead_offset = 0;
           int64_t pos = 0;
           int64_t next_offset = block_infos.position_info_[cursor].offset_;
+          int64_t max_readahead_size = MAX_READ_AHEAD_SIZE;
+          if (NULL != window)
+          {
+            if (prefetched)
+            {
+              window->on_evicted(current_block.size_);
+            }
+            max_readahead_size = window->get_size();
+          }
 
           // now calculate read ahead offset and size,
           // need attention reverse scan from down to top.
           if (!is_reverse)
           {
-            for (pos = cursor; pos < block_infos.block_count_ && readahead_size < MAX_READ_AHEAD_SIZE; ++pos)
+            for (pos = cursor; pos < block_infos.block_count_ && readahead_size < max_readahead_size; ++pos)
             {
               readahead_size += block_infos.position_info_[pos].size_;
               if (next_offset != block_infos.position_info_[pos].offset_)
@@ -323,7 +339,7 @@ namespace oceanbase
           }
           else
           {
-            for (pos = cursor; pos >= 0 && readahead_size < MAX_READ_AHEAD_SIZE ; --pos)
+            for (pos = cursor; pos >= 0 && readahead_size < max_readahead_size; --pos)
             {
               readahead_size += block_infos.position_info_[pos].size_;
               if (next_offset != block_infos.position_info_[pos].offset_)
@@ -358,6 +374,10 @@ namespace oceanbase
             stat.total_read_times_ = 1;
             stat.total_read_blocks_ = end_cursor - start_cursor + 1;
             add_io_stat(stat);
+            if (NULL != window)
+            {
+              window->on_read(readahead_offset, readahead_size, current_block.size_);
+            }
           }
 
           if (OB_SUCCESS == status && NULL != buffer)
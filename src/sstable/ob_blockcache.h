@@ -19,6 +19,7 @@
 #include "common/ob_kv_storecache.h"
 #include "common/ob_fileinfo_manager.h"
 #include "ob_aio_buffer_mgr.h"
+#include "ob_readahead_window.h"
 
 namespace oceanbase
 {
@@ -151,6 +152,8 @@ namespace oceanbase
        * @param buffer_handle store the return block data buffer, and 
        *                      it will revert buffer handle automaticly
        * @param check_crc whether check the block data record 
+       * @param window readahead window of the scan, if NULL read ahead
+       *               at most MAX_READ_AHEAD_SIZE bytes
        *
        * @return int32_t if success, return the read block data size, 
        *         else return -1
@@ -162,7 +165,8 @@ namespace oceanbase
           const int64_t cursor, 
           const bool is_reverse, 
           ObBufferHandle &buffer_handle,
-          const bool check_crc = true);
+          const bool check_crc = true,
+          ObReadaheadWindow* window = NULL);
 
       /**
        * try to get block data from cache, if success, return the 
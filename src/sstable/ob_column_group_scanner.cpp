@@ -530,7 +530,8 @@ namespace oceanbase
       }
       else
       {
-        // save parameters
+        // save parameters, previous scan of this scanner is over
+        readahead_window_.finish();
         scan_param_ = scan_param;
         sstable_reader_ = sstable_reader;
         group_id_ = group_id;
@@ -584,7 +585,7 @@ namespace oceanbase
         {
           iret = block_cache_->get_block_readahead(sstable_file_id,
               table_id, index_array_, index_array_cursor_, 
-              scan_param_->is_reverse_scan(), handler);
+              scan_param_->is_reverse_scan(), handler, true, &readahead_window_);
         }
         else
         {
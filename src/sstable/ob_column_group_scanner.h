@@ -21,6 +21,7 @@
 #include "ob_sstable_block_scanner.h"
 #include "ob_sstable_scan_param.h"
 #include "ob_scan_column_indexes.h"
+#include "ob_readahead_window.h"
 
 namespace oceanbase
 {
@@ -236,6 +237,7 @@ namespace oceanbase
       char* block_internal_buffer_;
       int64_t block_internal_bufsiz_;
       ObBlockPositionInfos index_array_;
+      ObReadaheadWindow readahead_window_;
 
       // for densense format sstable
       ObScanColumnIndexes current_scan_column_indexes_;
@@ -0,0 +1,198 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_readahead_window.cpp
+ *
+ */
+#include <tbsys.h>
+#include "common/utility.h"
+#include "common/ob_common_stat.h"
+#include "ob_readahead_window.h"
+
+namespace oceanbase
+{
+  namespace sstable
+  {
+    using namespace common;
+
+    int64_t ObReadaheadWindow::disk_budget_ = ObReadaheadWindow::DEFAULT_DISK_BUDGET;
+    volatile int64_t ObReadaheadWindow::disk_scan_count_[ObReadaheadWindow::MAX_DISK_NUM];
+
+    ObReadaheadWindow::ObReadaheadWindow()
+      : sstable_id_(OB_INVALID_ID), table_id_(OB_INVALID_ID), disk_no_(0),
+      is_reverse_(false), on_disk_(false), next_offset_(-1), prefetch_limit_(0),
+      window_size_(MIN_WINDOW_SIZE), unused_size_(0), readahead_count_(0),
+      readahead_bytes_(0), waste_bytes_(0), max_window_size_(0)
+    {
+    }
+
+    ObReadaheadWindow::~ObReadaheadWindow()
+    {
+      finish();
+    }
+
+    void ObReadaheadWindow::set_disk_budget(const int64_t budget)
+    {
+      disk_budget_ = budget < MIN_WINDOW_SIZE ? MIN_WINDOW_SIZE : budget;
+    }
+
+    int64_t ObReadaheadWindow::get_disk_budget()
+    {
+      return disk_budget_;
+    }
+
+    int64_t ObReadaheadWindow::get_disk_scan_count(const int64_t disk_no)
+    {
+      return (disk_no >= 0 && disk_no < MAX_DISK_NUM) ? disk_scan_count_[disk_no] : 0;
+    }
+
+    bool ObReadaheadWindow::access(const uint64_t sstable_id, const uint64_t table_id,
+        const int64_t offset, const int64_t size, const bool is_reverse)
+    {
+      bool prefetched = false;
+
+      if (sstable_id != sstable_id_ || is_reverse != is_reverse_
+          || (is_reverse ? offset + size : offset) != next_offset_)
+      {
+        restart(sstable_id, table_id, is_reverse);
+      }
+      else if (is_reverse ? offset >= prefetch_limit_ : offset + size <= prefetch_limit_)
+      {
+        prefetched = true;
+        unused_size_ -= size;
+      }
+      else
+      {
+        // sequential scan reaches the end of the window
+        grow();
+      }
+      next_offset_ = is_reverse ? offset : offset + size;
+
+      return prefetched;
+    }
+
+    void ObReadaheadWindow::on_evicted(const int64_t size)
+    {
+      // block cache is too small to keep what we read ahead
+      waste_bytes_ += size;
+      window_size_ /= 2;
+      if (window_size_ < MIN_WINDOW_SIZE)
+      {
+        window_size_ = MIN_WINDOW_SIZE;
+      }
+    }
+
+    void ObReadaheadWindow::on_read(const int64_t offset, const int64_t read_size,
+        const int64_t block_size)
+    {
+      ++readahead_count_;
+      readahead_bytes_ += read_size;
+      unused_size_ += read_size - block_size;
+      prefetch_limit_ = is_reverse_ ? offset : offset + read_size;
+    }
+
+    void ObReadaheadWindow::finish()
+    {
+      waste_bytes_ += unused_size_;
+      unused_size_ = 0;
+      leave_disk();
+
+      if (readahead_count_ > 0)
+      {
+#ifndef _SSTABLE_NO_STAT_
+        OB_STAT_TABLE_INC(SSTABLE, table_id_, INDEX_SSTABLE_READAHEAD_COUNT, readahead_count_);
+        OB_STAT_TABLE_INC(SSTABLE, table_id_, INDEX_SSTABLE_READAHEAD_BYTES, readahead_bytes_);
+        OB_STAT_TABLE_INC(SSTABLE, table_id_, INDEX_SSTABLE_READAHEAD_WASTE_BYTES, waste_bytes_);
+#endif
+        TBSYS_LOG(DEBUG, "finish readahead window, %s", to_cstring(*this));
+      }
+
+      sstable_id_ = OB_INVALID_ID;
+      next_offset_ = -1;
+      window_size_ = MIN_WINDOW_SIZE;
+      readahead_count_ = 0;
+      readahead_bytes_ = 0;
+      waste_bytes_ = 0;
+      max_window_size_ = 0;
+    }
+
+    int64_t ObReadaheadWindow::to_string(char* buffer, const int64_t length) const
+    {
+      int64_t pos = 0;
+      databuff_printf(buffer, length, pos, "sstable_id=%lu, table_id=%lu, disk_no=%ld, "
+          "reverse=%d, window_size=%ld, max_window_size=%ld, readahead_count=%ld, "
+          "readahead_bytes=%ld, waste_bytes=%ld",
+          sstable_id_, table_id_, disk_no_, is_reverse_, window_size_, max_window_size_,
+          readahead_count_, readahead_bytes_, get_waste_bytes());
+      return pos;
+    }
+
+    void ObReadaheadWindow::restart(const uint64_t sstable_id, const uint64_t table_id,
+        const bool is_reverse)
+    {
+      waste_bytes_ += unused_size_;
+      unused_size_ = 0;
+      if (sstable_id != sstable_id_)
+      {
+        leave_disk();
+        disk_no_ = static_cast<int64_t>(get_sstable_disk_no(sstable_id) & DISK_NO_MASK);
+      }
+      sstable_id_ = sstable_id;
+      table_id_ = table_id;
+      is_reverse_ = is_reverse;
+      prefetch_limit_ = is_reverse ? INT64_MAX : 0;
+      window_size_ = MIN_WINDOW_SIZE;
+      if (max_window_size_ < window_size_)
+      {
+        max_window_size_ = window_size_;
+      }
+    }
+
+    void ObReadaheadWindow::grow()
+    {
+      int64_t scan_count = 0;
+      int64_t limit = 0;
+
+      join_disk();
+      scan_count = disk_scan_count_[disk_no_];
+      limit = disk_budget_ / (scan_count > 0 ? scan_count : 1);
+      window_size_ *= 2;
+      if (window_size_ > limit)
+      {
+        window_size_ = limit;
+      }
+      if (window_size_ < MIN_WINDOW_SIZE)
+      {
+        window_size_ = MIN_WINDOW_SIZE;
+      }
+      if (max_window_size_ < window_size_)
+      {
+        max_window_size_ = window_size_;
+      }
+    }
+
+    void ObReadaheadWindow::join_disk()
+    {
+      if (!on_disk_)
+      {
+        __sync_add_and_fetch(&disk_scan_count_[disk_no_], 1);
+        on_disk_ = true;
+      }
+    }
+
+    void ObReadaheadWindow::leave_disk()
+    {
+      if (on_disk_)
+      {
+        __sync_sub_and_fetch(&disk_scan_count_[disk_no_], 1);
+        on_disk_ = false;
+      }
+    }
+  } // end namespace sstable
+} // end namespace oceanbase
@@ -0,0 +1,117 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_readahead_window.h
+ *
+ * Readahead window of one sstable scan. The window starts small, is
+ * doubled every time the scan misses the block cache while reading
+ * the sstable sequentially, and is capped by the share of the per-disk
+ * readahead budget among the sequential scans on the same disk. When
+ * blocks read ahead are washed out of the block cache before the scan
+ * reaches them, the window is halved.
+ */
+#ifndef OCEANBASE_SSTABLE_OB_READAHEAD_WINDOW_H_
+#define OCEANBASE_SSTABLE_OB_READAHEAD_WINDOW_H_
+
+#include "common/ob_define.h"
+#include "ob_disk_path.h"
+
+namespace oceanbase
+{
+  namespace sstable
+  {
+    class ObReadaheadWindow
+    {
+      public:
+        static const int64_t MIN_WINDOW_SIZE = 128 * 1024L;                //128K
+        static const int64_t DEFAULT_DISK_BUDGET = 16 * 1024 * 1024L;      //16M
+        static const int64_t MAX_DISK_NUM = static_cast<int64_t>(DISK_NO_MASK + 1);
+
+      public:
+        ObReadaheadWindow();
+        ~ObReadaheadWindow();
+
+        /// readahead bytes shared by all sequential scans on one disk
+        static void set_disk_budget(const int64_t budget);
+        static int64_t get_disk_budget();
+        static int64_t get_disk_scan_count(const int64_t disk_no);
+
+        /**
+         * called for every block the scan reads, before looking up the
+         * block cache. a block not following the previous one restarts
+         * the window.
+         *
+         * @return true if the block has been read ahead by this window
+         */
+        bool access(const uint64_t sstable_id, const uint64_t table_id,
+            const int64_t offset, const int64_t size, const bool is_reverse);
+
+        /// the block just accessed was read ahead but is not in cache any more
+        void on_evicted(const int64_t size);
+
+        /// max bytes to read from disk for the block just accessed
+        inline int64_t get_size() const
+        {
+          return window_size_;
+        }
+
+        /**
+         * %read_size bytes starting at %offset have been read from disk
+         * for the block just accessed, which is %block_size bytes.
+         */
+        void on_read(const int64_t offset, const int64_t read_size, const int64_t block_size);
+
+        /**
+         * end of the scan, bytes read ahead but never accessed are
+         * accounted as waste and the statistics are reported.
+         */
+        void finish();
+
+        inline int64_t get_readahead_count() const { return readahead_count_; }
+        inline int64_t get_readahead_bytes() const { return readahead_bytes_; }
+        inline int64_t get_waste_bytes() const { return waste_bytes_ + unused_size_; }
+        inline int64_t get_max_window_size() const { return max_window_size_; }
+
+        int64_t to_string(char* buffer, const int64_t length) const;
+
+      private:
+        void restart(const uint64_t sstable_id, const uint64_t table_id, const bool is_reverse);
+        void grow();
+        void join_disk();
+        void leave_disk();
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObReadaheadWindow);
+        static int64_t disk_budget_;
+        static volatile int64_t disk_scan_count_[MAX_DISK_NUM];
+
+        uint64_t sstable_id_;
+        uint64_t table_id_;
+        int64_t disk_no_;
+        bool is_reverse_;
+        bool on_disk_;
+        // offset where the next block of a sequential scan ends (reverse)
+        // or starts (forward)
+        int64_t next_offset_;
+        // boundary of the bytes read ahead, end offset for forward scan,
+        // start offset for reverse scan
+        int64_t prefetch_limit_;
+        int64_t window_size_;
+        // bytes read ahead and not accessed yet
+        int64_t unused_size_;
+
+        int64_t readahead_count_;
+        int64_t readahead_bytes_;
+        int64_t waste_bytes_;
+        int64_t max_window_size_;
+    };
+  } // end namespace sstable
+} // end namespace oceanbase
+
+#endif //OCEANBASE_SSTABLE_OB_READAHEAD_WINDOW_H_
@@ -29,7 +29,7 @@ namespace oceanbase
 
     ObSSTableBlockGetter::ObSSTableBlockGetter(const ObScanColumnIndexes& column_index)
     : inited_(false), handled_del_row_(false), not_exit_col_ret_nop_(false), 
-      is_row_cache_data_(false), is_row_finished_(false), 
+      is_row_cache_data_(false), is_row_finished_(false), is_block_decoded_(false),
       sstable_data_store_style_(OB_SSTABLE_STORE_DENSE), 
       column_cursor_(0), current_column_count_(0), query_column_indexes_(column_index),
       row_cursor_(NULL), sstable_row_cache_(NULL), index_buf_(DEFAULT_INDEX_BUF_SIZE)
@@ -307,19 +307,25 @@ namespace oceanbase
       return ret; 
     }
 
-    void ObSSTableBlockGetter::clear()
+    void ObSSTableBlockGetter::clear_row()
     {
       inited_ = false;
       handled_del_row_ = false;
-      not_exit_col_ret_nop_ = false;
-      is_row_cache_data_ = false;
       is_row_finished_ = false;
-      sstable_data_store_style_ = OB_SSTABLE_STORE_DENSE;
       row_cursor_ = NULL;
-      sstable_row_cache_ = NULL;
       column_cursor_ = 0;
       current_column_count_ = 0;
       current_cell_info_.reset();
+    }
+
+    void ObSSTableBlockGetter::clear()
+    {
+      clear_row();
+      not_exit_col_ret_nop_ = false;
+      is_row_cache_data_ = false;
+      is_block_decoded_ = false;
+      sstable_data_store_style_ = OB_SSTABLE_STORE_DENSE;
+      sstable_row_cache_ = NULL;
       reader_.reset();
     }
 
@@ -381,6 +387,7 @@ namespace oceanbase
         if (OB_SUCCESS == ret)
         {
           inited_ = true;
+          is_block_decoded_ = true;
           row_cursor_ = reader_.find(row_key);
           if (row_cursor_ != reader_.end())
           {
@@ -403,6 +410,65 @@ namespace oceanbase
       return ret;
     }
 
+    int ObSSTableBlockGetter::reinit(const ObRowkey& row_key)
+    {
+      int ret = OB_SUCCESS;
+
+      if (!is_block_decoded_)
+      {
+        TBSYS_LOG(WARN, "no decoded block to reuse");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == row_key.ptr() || 0 == row_key.length())
+      {
+        TBSYS_LOG(WARN, "invalid param, row_key_ptr=%p, row_key_len=%ld",
+                  row_key.ptr(), row_key.length());
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        clear_row();
+        current_rowkey_ = row_key;
+        inited_ = true;
+        row_cursor_ = reader_.find(row_key);
+        if (row_cursor_ != reader_.end())
+        {
+          ret = load_current_row(row_cursor_);
+          if (OB_SUCCESS != ret)
+          {
+            TBSYS_LOG(WARN, "load row error, ret=%d", ret);
+            inited_ = false;
+          }
+        }
+        else
+        {
+          ret = OB_SEARCH_NOT_FOUND;
+        }
+      }
+
+      return ret;
+    }
+
+    bool ObSSTableBlockGetter::is_in_block(const ObRowkey& row_key) const
+    {
+      bool bret = false;
+      ObRowkey block_key;
+
+      if (is_block_decoded_ && reader_.get_row_count() > 0)
+      {
+        // get_row_key() may share the key buffer, compare before fetching another key
+        bret = (OB_SUCCESS == reader_.get_row_key(reader_.begin(), block_key)
+                && block_key.compare(row_key) <= 0);
+        if (bret)
+        {
+          bret = (OB_SUCCESS == reader_.get_row_key(reader_.end() - 1, block_key)
+                  && row_key.compare(block_key) <= 0);
+        }
+      }
+
+      return bret;
+    }
+
     int ObSSTableBlockGetter::read_row_columns(
       const int64_t format, const char* row_buf, 
       const int64_t data_len)
@@ -85,6 +85,30 @@ namespace oceanbase
                ObSSTableRowCache* row_cache, const bool is_row_cache_data,
                bool not_exit_col_ret_nop = false);
 
+      /**
+       * search another row key in the block decoded by the last 
+       * init() from block data, the block isn't decoded again. the 
+       * caller must keep the block buffer passed to init() unchanged. 
+       * 
+       * @param row_key row key which the block getter to find 
+       *  
+       * @return int 
+       * 1. success 
+       *    OB_SUCCESS
+       *    OB_SEARCH_NOT_FOUND not find the row key in block
+       * 2. fail 
+       *     OB_NOT_INIT no decoded block
+       *     OB_INVALID_ARGUMENT invalid arguments
+       */
+      int reinit(const common::ObRowkey& row_key);
+
+      /**
+       * whether the row key is between the first row key and the 
+       * last row key of the decoded block, if so the block index 
+       * must point the row key to this block. 
+       */
+      bool is_in_block(const common::ObRowkey& row_key) const;
+
       // WARNING: this function must be called after init()
       inline int get_cache_row_value(ObSSTableRowCacheValue& row_value)
       {
@@ -113,6 +137,7 @@ namespace oceanbase
       int get_current_column_index(const int64_t cursor, ObScanColumnIndexes::Column& column) const;
       int read_row_columns(const int64_t format, const char* row_buf, 
         const int64_t data_len);
+      void clear_row();
       void clear();
       
     private:
@@ -126,6 +151,7 @@ namespace oceanbase
       bool not_exit_col_ret_nop_;       //whether return nop if columns doesn't exit
       bool is_row_cache_data_;          //whether row value cached in sstable row cache
       bool is_row_finished_;            //whether the row is end
+      bool is_block_decoded_;           //whether reader_ holds a decoded block
       int64_t sstable_data_store_style_;//sstable store style
       int64_t column_cursor_;           //current column cursor
       int64_t current_column_count_;    //current column count
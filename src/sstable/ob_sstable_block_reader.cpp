@@ -88,6 +88,56 @@ namespace oceanbase
       return ret;
     }
 
+    inline int ObSSTableBlockReader::decode_cell(const char* buf,
+      const int64_t data_len, int64_t& pos, ObObj& obj)
+    {
+      int ret = OB_SUCCESS;
+      int64_t tmp_pos = pos;
+      int8_t first_byte = 0;
+
+      if (OB_UNLIKELY(tmp_pos >= data_len))
+      {
+        ret = OB_DESERIALIZE_ERROR;
+      }
+      else if (0 == ((first_byte = buf[tmp_pos++]) & 0x80))
+      {
+        int64_t value = 0;
+        bool is_add = false;
+        if (OB_SUCCESS == (ret = decode_int(buf, data_len, first_byte, tmp_pos, value, is_add)))
+        {
+          obj.reset();
+          obj.set_int(value, is_add);
+          pos = tmp_pos;
+        }
+      }
+      else if (OB_VARCHAR_TYPE == static_cast<int8_t>(first_byte & 0xc0))
+      {
+        int32_t length = 0;
+        const char* str = decode_str(buf, data_len, first_byte, tmp_pos, length);
+        if (NULL == str)
+        {
+          ret = OB_DESERIALIZE_ERROR;
+        }
+        else
+        {
+          obj.reset();
+          obj.set_varchar(ObString(0, length, const_cast<char*>(str)));
+          pos = tmp_pos;
+        }
+      }
+      else if (OB_NULL_TYPE == first_byte)
+      {
+        obj.reset();
+        obj.set_null();
+        pos = tmp_pos;
+      }
+      else
+      {
+        ret = obj.deserialize(buf, data_len, pos);
+      }
+      return ret;
+    }
+
     int ObSSTableBlockReader::deserialize(const BlockDataDesc& desc, const BlockData& data)
     {
       int ret = OB_SUCCESS; 
@@ -348,7 +398,7 @@ namespace oceanbase
         while (OB_SUCCESS == ret && row_start + pos < row_end)
         {
 
-          if (OB_SUCCESS != (ret = obj.deserialize(row_start, index->size_, pos)))
+          if (OB_SUCCESS != (ret = decode_cell(row_start, index->size_, pos, obj)))
           {
             TBSYS_LOG(ERROR, "deserialize column value object error, ret=%d, "
                 "result_index=%ld, row_start=%p, pos=%ld, size=%d",
@@ -408,20 +458,25 @@ namespace oceanbase
         ++value_index;
       }
 
-      // traverse rowvalue;
+      // traverse rowvalue, columns not in query columns are skipped
+      // without being decoded;
       while (OB_SUCCESS == ret && row_start + pos < row_end
           && filled < not_null_col_num)
       {
-        if (OB_SUCCESS != (ret = obj.deserialize(row_start, index->size_, pos)))
+        if ((result_index = query_columns.find_by_offset(value_index)) < 0)
+        {
+          if (OB_SUCCESS != (ret = ObObj::skip(row_start, index->size_, pos)))
+          {
+            TBSYS_LOG(ERROR, "skip column value object error, ret=%d, "
+                "object_index=%ld, row_start=%p, pos=%ld, size=%d",
+                ret, value_index, row_start, pos, index->size_);
+          }
+        }
+        else if (OB_SUCCESS != (ret = decode_cell(row_start, index->size_, pos, obj)))
         {
           TBSYS_LOG(ERROR, "deserialize column value object error, ret=%d, "
               "object_index=%ld, row_start=%p, pos=%ld, size=%d",
               ret, value_index, row_start, pos, index->size_);
-          break;
-        }
-        else if ((result_index = query_columns.find_by_offset(value_index)) < 0)
-        {
-          // this column not in query columns, ignore;
         }
         else if (OB_SUCCESS != (ret = value.raw_set_cell(result_index, obj)))
         {
@@ -481,7 +536,7 @@ namespace oceanbase
       while (OB_SUCCESS == ret && row_start + pos < row_end
           && filled < not_null_col_num)
       {
-        if (OB_SUCCESS != (ret = obj.deserialize(row_start, index->size_, pos)))
+        if (OB_SUCCESS != (ret = decode_cell(row_start, index->size_, pos, obj)))
         {
           TBSYS_LOG(ERROR, "deserialize column value object error, ret=%d, "
               "object_index=%ld, row_start=%p, pos=%ld, size=%d",
@@ -492,20 +547,22 @@ namespace oceanbase
           TBSYS_LOG(ERROR, "sparse format, obj(%s) not column_id", to_cstring(obj));
           ret = OB_UNKNOWN_OBJ;
         }
-        else if (OB_SUCCESS != (ret = obj.deserialize(row_start, index->size_, pos)))
-        {
-          TBSYS_LOG(ERROR, "deserialize column value object error, ret=%d, "
-              "object_index=%ld, row_start=%p, pos=%ld, size=%d",
-              ret, value_index, row_start, pos, index->size_);
-        }
         else if (value_index == 0 && static_cast<uint64_t>(column_id) == OB_ACTION_FLAG_COLUMN_ID)
         {
           // delete row? store first
           has_delete_row = true;
+          ret = ObObj::skip(row_start, index->size_, pos);
         }
         else if (OB_INVALID_INDEX == (result_index = row_desc->get_idx(table_id, column_id)))
         {
           // do nothing when user do ask it
+          ret = ObObj::skip(row_start, index->size_, pos);
+        }
+        else if (OB_SUCCESS != (ret = decode_cell(row_start, index->size_, pos, obj)))
+        {
+          TBSYS_LOG(ERROR, "deserialize column value object error, ret=%d, "
+              "object_index=%ld, row_start=%p, pos=%ld, size=%d",
+              ret, value_index, row_start, pos, index->size_);
         }
         else if (OB_SUCCESS != (ret = value.raw_set_cell(result_index, obj)))
         {
@@ -580,8 +637,7 @@ namespace oceanbase
                 ret, object_index, row_start, pos, size);
             break;
           }
-          else if (OB_SUCCESS != (ret = 
-                (values + object_index)->deserialize(row_start, size, pos)) )
+          else if (OB_SUCCESS != (ret = decode_cell(row_start, size, pos, values[object_index])))
           {
             TBSYS_LOG(ERROR, "deserialize column value object error, ret=%d, "
                 "object_index=%ld, row_start=%p, pos=%ld, size=%ld",
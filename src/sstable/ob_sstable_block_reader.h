@@ -187,6 +187,13 @@ namespace oceanbase
         int get_row_key(const_iterator index, common::ObRowkey& key, int64_t &pos) const;
         static int deserialize_sstable_rowkey(const char* buf, const int64_t data_len, common::ObString& key);
 
+        /**
+         * decode one cell at %pos, int, varchar and null cells which make
+         * up most of the rows are decoded inline, others fall back to
+         * ObObj::deserialize.
+         */
+        static int decode_cell(const char* buf, const int64_t data_len, int64_t& pos, common::ObObj& obj);
+
         int get_dense_row(const_iterator index,
             const ObSimpleColumnIndexes& query_columns, 
             common::ObRowkey& key, common::ObRow& value) const;
@@ -0,0 +1,273 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sstable_compress_pipeline.cpp
+ *
+ */
+#include "common/ob_crc64.h"
+#include "ob_sstable_compress_pipeline.h"
+
+namespace oceanbase
+{
+  namespace sstable
+  {
+    using namespace common;
+
+    ObSSTableCompressPipeline::Block::Block()
+      : data_buf_(DEFAULT_BLOCK_BUF_SIZE), data_len_(0), table_id_(OB_INVALID_ID),
+        column_group_id_(OB_INVALID_ID), key_(), binary_key_(), key_buf_(DEFAULT_KEY_BUF_SIZE),
+        comp_buf_(DEFAULT_BLOCK_BUF_SIZE), output_(NULL), output_len_(0), checksum_(0),
+        ret_(OB_SUCCESS), done_(false)
+    {
+    }
+
+    ObSSTableCompressPipeline::ObSSTableCompressPipeline()
+      : started_(false), stop_(false), thread_num_(0), slot_num_(0), pushed_(0),
+        taken_(0), popped_(0), pending_size_(0), cond_()
+    {
+      memset(workers_, 0, sizeof(workers_));
+    }
+
+    ObSSTableCompressPipeline::~ObSSTableCompressPipeline()
+    {
+      stop();
+    }
+
+    int ObSSTableCompressPipeline::start(const int64_t thread_num, const char* compressor_name)
+    {
+      int ret = OB_SUCCESS;
+
+      if (started_)
+      {
+        TBSYS_LOG(WARN, "compress pipeline has been started");
+        ret = OB_INIT_TWICE;
+      }
+      else if (thread_num <= 0 || thread_num > MAX_THREAD_NUM || NULL == compressor_name)
+      {
+        TBSYS_LOG(WARN, "invalid param, thread_num=%ld, compressor_name=%p",
+                  thread_num, compressor_name);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        stop_ = false;
+        pushed_ = 0;
+        taken_ = 0;
+        popped_ = 0;
+        pending_size_ = 0;
+        thread_num_ = 0;
+        for (int64_t i = 0; OB_SUCCESS == ret && i < thread_num; ++i)
+        {
+          Worker& worker = workers_[i];
+          worker.pipeline_ = this;
+          if (NULL == (worker.compressor_ = create_compressor(compressor_name)))
+          {
+            TBSYS_LOG(WARN, "create compressor failed, compressor_name=%s", compressor_name);
+            ret = OB_ERROR;
+          }
+          else if (0 != pthread_create(&worker.thread_, NULL, thread_func_, &worker))
+          {
+            TBSYS_LOG(WARN, "create compress thread failed, started=%ld", thread_num_);
+            destroy_compressor(worker.compressor_);
+            worker.compressor_ = NULL;
+            break;
+          }
+          else
+          {
+            ++thread_num_;
+          }
+        }
+
+        if (OB_SUCCESS == ret && 0 == thread_num_)
+        {
+          ret = OB_ERROR;
+        }
+        if (OB_SUCCESS != ret)
+        {
+          destroy_workers_();
+        }
+        else
+        {
+          slot_num_ = 2 * thread_num_;
+          started_ = true;
+        }
+      }
+
+      return ret;
+    }
+
+    void ObSSTableCompressPipeline::stop()
+    {
+      if (started_)
+      {
+        destroy_workers_();
+        started_ = false;
+      }
+    }
+
+    void ObSSTableCompressPipeline::destroy_workers_()
+    {
+      cond_.lock();
+      stop_ = true;
+      cond_.broadcast();
+      cond_.unlock();
+      for (int64_t i = 0; i < thread_num_; ++i)
+      {
+        pthread_join(workers_[i].thread_, NULL);
+      }
+      for (int64_t i = 0; i < MAX_THREAD_NUM; ++i)
+      {
+        if (NULL != workers_[i].compressor_)
+        {
+          destroy_compressor(workers_[i].compressor_);
+          workers_[i].compressor_ = NULL;
+        }
+      }
+      thread_num_ = 0;
+      pushed_ = 0;
+      taken_ = 0;
+      popped_ = 0;
+      pending_size_ = 0;
+    }
+
+    ObSSTableCompressPipeline::Block* ObSSTableCompressPipeline::get_free_block()
+    {
+      Block* block = NULL;
+      if (started_ && pushed_ - popped_ < slot_num_)
+      {
+        block = &blocks_[pushed_ % slot_num_];
+      }
+      return block;
+    }
+
+    void ObSSTableCompressPipeline::push_block()
+    {
+      Block& block = blocks_[pushed_ % slot_num_];
+      block.done_ = false;
+      block.ret_ = OB_SUCCESS;
+      pending_size_ += block.data_len_;
+      cond_.lock();
+      ++pushed_;
+      cond_.broadcast();
+      cond_.unlock();
+    }
+
+    int ObSSTableCompressPipeline::get_compressed_block(Block*& block, const bool wait)
+    {
+      int ret = OB_SUCCESS;
+
+      if (!started_ || popped_ >= pushed_)
+      {
+        ret = OB_ITER_END;
+      }
+      else
+      {
+        Block& oldest = blocks_[popped_ % slot_num_];
+        cond_.lock();
+        while (wait && !oldest.done_)
+        {
+          cond_.wait();
+        }
+        if (oldest.done_)
+        {
+          block = &oldest;
+        }
+        else
+        {
+          ret = OB_EAGAIN;
+        }
+        cond_.unlock();
+      }
+
+      return ret;
+    }
+
+    void ObSSTableCompressPipeline::pop_block()
+    {
+      if (popped_ < pushed_)
+      {
+        pending_size_ -= blocks_[popped_ % slot_num_].data_len_;
+        ++popped_;
+      }
+    }
+
+    void* ObSSTableCompressPipeline::thread_func_(void* arg)
+    {
+      Worker* worker = reinterpret_cast<Worker*>(arg);
+      if (NULL != worker && NULL != worker->pipeline_ && NULL != worker->compressor_)
+      {
+        worker->pipeline_->compress_(*worker->compressor_);
+      }
+      return NULL;
+    }
+
+    void ObSSTableCompressPipeline::compress_(ObCompressor& compressor)
+    {
+      bool stop = false;
+      while (!stop)
+      {
+        Block* block = NULL;
+        cond_.lock();
+        while (!stop_ && taken_ >= pushed_)
+        {
+          cond_.wait();
+        }
+        stop = stop_;
+        if (!stop)
+        {
+          block = &blocks_[taken_ % slot_num_];
+          ++taken_;
+        }
+        cond_.unlock();
+
+        if (NULL != block)
+        {
+          compress_block_(compressor, *block);
+          cond_.lock();
+          block->done_ = true;
+          cond_.broadcast();
+          cond_.unlock();
+        }
+      }
+    }
+
+    void ObSSTableCompressPipeline::compress_block_(ObCompressor& compressor, Block& block)
+    {
+      int ret = OB_SUCCESS;
+      int64_t compressed_size = 0;
+      int64_t compress_buf_len = block.data_len_ + compressor.get_max_overflow_size(block.data_len_);
+
+      block.output_ = block.data_buf_.get_buffer();
+      block.output_len_ = block.data_len_;
+      if (OB_SUCCESS != (ret = block.comp_buf_.ensure_space(
+              compress_buf_len, ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "failed to alloc compress buffer, compress_buf_len=%ld", compress_buf_len);
+      }
+      else if (OB_SUCCESS != (ret = compressor.compress(block.data_buf_.get_buffer(), block.data_len_,
+              block.comp_buf_.get_buffer(), compress_buf_len, compressed_size)))
+      {
+        TBSYS_LOG(WARN, "failed to compress, ret=%d, input_len=%ld, compress_buf_len=%ld",
+                  ret, block.data_len_, compress_buf_len);
+      }
+      else if (compressed_size < block.data_len_)
+      {
+        //store the original data if compression doesn't make it smaller
+        block.output_ = block.comp_buf_.get_buffer();
+        block.output_len_ = compressed_size;
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        block.checksum_ = ob_crc64(block.output_, block.output_len_);
+      }
+      block.ret_ = ret;
+    }
+  } // end namespace sstable
+} // end namespace oceanbase
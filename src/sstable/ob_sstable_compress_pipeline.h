@@ -0,0 +1,159 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sstable_compress_pipeline.h
+ *
+ * Compress data blocks of one sstable with a few threads. The writer
+ * thread hands the built blocks in one by one, any compress thread may
+ * compress a block, and the writer gets the compressed blocks back in
+ * the order they were handed in. So the writer appends the records
+ * to the sstable file exactly as if it compressed them by itself, the
+ * file format doesn't change. At most 2 * thread_num blocks are in
+ * flight, each compress thread owns its compressor.
+ */
+#ifndef OCEANBASE_SSTABLE_OB_SSTABLE_COMPRESS_PIPELINE_H_
+#define OCEANBASE_SSTABLE_OB_SSTABLE_COMPRESS_PIPELINE_H_
+
+#include <pthread.h>
+#include <tbsys.h>
+#include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "common/ob_rowkey.h"
+#include "common/ob_string.h"
+#include "common/compress/ob_compressor.h"
+
+namespace oceanbase
+{
+  namespace sstable
+  {
+    class ObSSTableCompressPipeline
+    {
+    public:
+      static const int64_t MAX_THREAD_NUM = 16;
+
+      struct Block
+      {
+        static const int64_t DEFAULT_BLOCK_BUF_SIZE = 128 * 1024;
+        static const int64_t DEFAULT_KEY_BUF_SIZE = 64;
+
+        Block();
+
+        // filled by the writer thread before push_block()
+        common::ObMemBuf data_buf_;     //uncompressed block data
+        int64_t data_len_;
+        uint64_t table_id_;             //block index entry of the block
+        uint64_t column_group_id_;
+        common::ObRowkey key_;
+        common::ObString binary_key_;
+        common::ObMemBuf key_buf_;
+
+        // filled by the compress thread
+        common::ObMemBuf comp_buf_;
+        const char* output_;            //compressed data, or the data itself
+        int64_t output_len_;            //if compression doesn't make it smaller
+        uint64_t checksum_;             //crc64 of output
+        int ret_;
+        bool done_;
+      };
+
+    public:
+      ObSSTableCompressPipeline();
+      ~ObSSTableCompressPipeline();
+
+      /**
+       * start thread_num compress threads, each creates its own
+       * compressor of compressor_name
+       *
+       * @return int OB_SUCCESS if at least one thread is started
+       */
+      int start(const int64_t thread_num, const char* compressor_name);
+
+      /**
+       * stop the threads and drop the blocks in flight, safe to call
+       * more than once
+       */
+      void stop();
+
+      bool is_started() const
+      {
+        return started_;
+      }
+
+      /**
+       * get the block to fill next
+       *
+       * @return Block* NULL if all slots are in flight, the oldest block
+       *         must be got out by get_compressed_block() first
+       */
+      Block* get_free_block();
+
+      /**
+       * hand the block got by get_free_block() to the compress threads
+       */
+      void push_block();
+
+      /**
+       * get the oldest block handed in, the block is valid until
+       * pop_block()
+       *
+       * @param wait wait for the block to be compressed
+       *
+       * @return int OB_SUCCESS if the block is compressed, check ret_ of
+       *         it for the result of compression, OB_EAGAIN if it is not
+       *         compressed yet and not wait, OB_ITER_END if no block is in
+       *         flight
+       */
+      int get_compressed_block(Block*& block, const bool wait);
+
+      /**
+       * give back the block got by get_compressed_block()
+       */
+      void pop_block();
+
+      /**
+       * @return int64_t uncompressed size of the blocks in flight
+       */
+      int64_t get_pending_size() const
+      {
+        return pending_size_;
+      }
+
+    private:
+      struct Worker
+      {
+        ObSSTableCompressPipeline* pipeline_;
+        ObCompressor* compressor_;
+        pthread_t thread_;
+      };
+
+      static void* thread_func_(void* arg);
+      void compress_(ObCompressor& compressor);
+      void compress_block_(ObCompressor& compressor, Block& block);
+      void destroy_workers_();
+
+    private:
+      DISALLOW_COPY_AND_ASSIGN(ObSSTableCompressPipeline);
+      static const int64_t MAX_SLOT_NUM = 2 * MAX_THREAD_NUM;
+
+      bool started_;
+      bool stop_;
+      int64_t thread_num_;
+      int64_t slot_num_;
+      int64_t pushed_;          //blocks handed in
+      int64_t taken_;           //blocks taken by compress threads
+      int64_t popped_;          //blocks got out
+      int64_t pending_size_;
+      Worker workers_[MAX_THREAD_NUM];
+      Block blocks_[MAX_SLOT_NUM];
+      tbsys::CThreadCond cond_;
+    };
+  } // namespace oceanbase::sstable
+} // namespace Oceanbase
+
+#endif // OCEANBASE_SSTABLE_OB_SSTABLE_COMPRESS_PIPELINE_H_
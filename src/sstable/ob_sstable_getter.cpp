@@ -32,7 +32,9 @@ namespace oceanbase
       not_exit_col_ret_nop_(false), is_row_finished_(false), readers_(NULL), 
       readers_size_(0), cur_reader_idx_(0), prev_reader_idx_(-1),  
       handled_cells_(0), column_group_num_(0), cur_column_group_idx_(0), 
-      get_param_(NULL), cur_column_mask_(MAX_GET_COLUMN_COUNT_PRE_ROW),
+      get_param_(NULL), is_block_loaded_(false), loaded_sstable_id_(OB_INVALID_ID),
+      loaded_table_id_(OB_INVALID_ID), loaded_column_group_id_(OB_INVALID_ID),
+      loaded_block_offset_(-1), cur_column_mask_(MAX_GET_COLUMN_COUNT_PRE_ROW),
       getter_(cur_column_mask_), block_cache_(NULL), 
       block_index_cache_(NULL), sstable_row_cache_(NULL), 
       uncomp_buf_(DEFAULT_UNCOMP_BUF_SIZE), row_buf_(DEFAULT_ROW_BUF_SIZE)
@@ -388,6 +390,7 @@ namespace oceanbase
       cur_column_group_idx_ = 0;
 
       get_param_ = NULL;
+      is_block_loaded_ = false;
       cur_column_mask_.reset();
       null_cell_info_.reset();
 
@@ -474,6 +477,8 @@ namespace oceanbase
       else
       {
         ObSSTableBlockReader::BlockDataDesc data_desc(&rowkey_info_, row_key.get_obj_cnt(), store_style);
+        //block getter drops the decoded block when it's initialized with a cached row
+        is_block_loaded_ = false;
         ret = getter_.init(row_key, row_cache_val.buf_, row_cache_val.size_, 
           data_desc, sstable_row_cache_, true, not_exit_col_ret_nop_);
         if (OB_SUCCESS != ret && OB_SEARCH_NOT_FOUND != ret)
@@ -492,6 +497,7 @@ namespace oceanbase
       const ObCellInfo* cell  = NULL;
       uint64_t table_id       = OB_INVALID_ID;
       bool is_row_cache_hit   = false;
+      bool reuse_block        = false;
       int64_t store_style     = OB_SSTABLE_STORE_DENSE;
       const ObSSTableTrailer& trailer = readers_[cur_reader_idx_]->get_trailer();
       ObRowkey look_key;
@@ -550,7 +556,14 @@ namespace oceanbase
           FILL_TRACE_LOG("check row cache hit=%d.", is_row_cache_hit);
         }
 
-        if (NULL == sstable_row_cache_ || !is_row_cache_hit)
+        if ((NULL == sstable_row_cache_ || !is_row_cache_hit)
+            && can_reuse_block(table_id, look_key))
+        {
+          //the row key is inside the decoded block, skip block index too
+          reuse_block = true;
+          ret = OB_SUCCESS;
+        }
+        else if (NULL == sstable_row_cache_ || !is_row_cache_hit)
         {
           info.sstable_file_id_ = readers_[cur_reader_idx_]->get_sstable_id().sstable_file_id_;
           info.offset_ = trailer.get_block_index_record_offset();
@@ -559,6 +572,14 @@ namespace oceanbase
           ret = block_index_cache_->get_single_block_pos_info(info, table_id, 
                                                               column_group_[cur_column_group_idx_],
                                                               look_key, mode, block_pos_); 
+          if (OB_SUCCESS == ret && is_block_loaded_
+              && loaded_sstable_id_ == info.sstable_file_id_
+              && loaded_table_id_ == table_id
+              && loaded_column_group_id_ == column_group_[cur_column_group_idx_]
+              && loaded_block_offset_ == block_pos_.offset_)
+          {
+            reuse_block = true;
+          }
         }
 
         if (OB_SUCCESS == ret)  //load block index success
@@ -572,7 +593,7 @@ namespace oceanbase
             }
             else 
             {
-              ret = fetch_block();
+              ret = fetch_block(reuse_block);
             }
             if (OB_SUCCESS != ret && OB_SEARCH_NOT_FOUND != ret)
             {
@@ -882,7 +903,7 @@ namespace oceanbase
       return ret;
     }
 
-    int ObSSTableGetter::fetch_block() 
+    int ObSSTableGetter::fetch_block(const bool reuse_block) 
     {
       int ret                       = OB_SUCCESS;
       const ObCellInfo* cell        = NULL;
@@ -908,24 +929,43 @@ namespace oceanbase
         }
       }
 
-      if (OB_SUCCESS == ret)
+      if (OB_SUCCESS == ret && reuse_block)
+      {
+        //uncomp_buf_ still holds the decoded block, only search the row key
+        store_style = reader->get_trailer().get_row_value_store_style();
+        ret = getter_.reinit(cell->row_key_);
+        if (OB_SUCCESS != ret && OB_SEARCH_NOT_FOUND != ret)
+        {
+          TBSYS_LOG(WARN, "block getter reinitialize error, ret=%d", ret);  
+        }
+#ifndef _SSTABLE_NO_STAT_
+        OB_STAT_TABLE_INC(SSTABLE, cell->table_id_, INDEX_SSTABLE_GET_BLOCK_REUSE, 1);
+#endif
+      }
+      else if (OB_SUCCESS == ret)
       {
+        //uncomp_buf_ is overwritten, the decoded block is invalid from now on
+        is_block_loaded_ = false;
         ret = get_block_data(reader->get_sstable_id().sstable_file_id_, 
                              cell->table_id_, data_buf, data_size);
-      }
 
-      if (OB_SUCCESS == ret)
-      {
-        store_style = reader->get_trailer().get_row_value_store_style();
-        int64_t rowkey_column_count = 0;
-        reader->get_schema()->get_rowkey_column_count(cell->table_id_, rowkey_column_count);
-        ObSSTableBlockReader::BlockDataDesc data_desc(&rowkey_info_, rowkey_column_count, store_style);
-        // translate cell->row_key_ to rowkey
-        ret = getter_.init(cell->row_key_, data_buf, data_size, data_desc,
-          sstable_row_cache_, false, not_exit_col_ret_nop_);
-        if (OB_SUCCESS != ret && OB_SEARCH_NOT_FOUND != ret)
+        if (OB_SUCCESS == ret)
         {
-          TBSYS_LOG(WARN, "block getter initialize error, ret=%d", ret);  
+          store_style = reader->get_trailer().get_row_value_store_style();
+          int64_t rowkey_column_count = 0;
+          reader->get_schema()->get_rowkey_column_count(cell->table_id_, rowkey_column_count);
+          ObSSTableBlockReader::BlockDataDesc data_desc(&rowkey_info_, rowkey_column_count, store_style);
+          // translate cell->row_key_ to rowkey
+          ret = getter_.init(cell->row_key_, data_buf, data_size, data_desc,
+            sstable_row_cache_, false, not_exit_col_ret_nop_);
+          if (OB_SUCCESS == ret || OB_SEARCH_NOT_FOUND == ret)
+          {
+            set_loaded_block(cell->table_id_);
+          }
+          else
+          {
+            TBSYS_LOG(WARN, "block getter initialize error, ret=%d", ret);  
+          }
         }
       }
 
@@ -984,6 +1024,25 @@ namespace oceanbase
       return ret;
     }
 
+    bool ObSSTableGetter::can_reuse_block(const uint64_t table_id, 
+                                          const ObRowkey& row_key) const
+    {
+      return (is_block_loaded_
+              && loaded_sstable_id_ == readers_[cur_reader_idx_]->get_sstable_id().sstable_file_id_
+              && loaded_table_id_ == table_id
+              && loaded_column_group_id_ == column_group_[cur_column_group_idx_]
+              && getter_.is_in_block(row_key));
+    }
+
+    void ObSSTableGetter::set_loaded_block(const uint64_t table_id)
+    {
+      is_block_loaded_ = true;
+      loaded_sstable_id_ = readers_[cur_reader_idx_]->get_sstable_id().sstable_file_id_;
+      loaded_table_id_ = table_id;
+      loaded_column_group_id_ = column_group_[cur_column_group_idx_];
+      loaded_block_offset_ = block_pos_.offset_;
+    }
+
     bool ObSSTableGetter::is_column_group_id_existent(const uint64_t column_group_id)
     {
       bool bret = false;
@@ -146,7 +146,15 @@ namespace oceanbase
        * 2. fail 
        *     OB_ERROR 
        */
-      int fetch_block();
+      int fetch_block(const bool reuse_block);
+
+      /**
+       * whether the block decoded for the previous row can serve the 
+       * current row, rows of a multi-get are sorted by the 
+       * mergeserver, so adjacent rows often fall into one block. 
+       */
+      bool can_reuse_block(const uint64_t table_id, const common::ObRowkey& row_key) const;
+      void set_loaded_block(const uint64_t table_id);
 
       int fetch_cache_row(const common::ObRowkey& row_key, 
         const int64_t store_style, ObSSTableRowCacheValue& row_cache_val);
@@ -216,6 +224,12 @@ namespace oceanbase
       const common::ObGetParam* get_param_;//get parameter
       ObBlockPositionInfo block_pos_;   //current block position for current row key
 
+      bool is_block_loaded_;            //whether getter_ holds a block decoded from uncomp_buf_
+      uint64_t loaded_sstable_id_;      //sstable file id of the decoded block
+      uint64_t loaded_table_id_;        //table id of the decoded block
+      uint64_t loaded_column_group_id_; //column group id of the decoded block
+      int64_t loaded_block_offset_;     //offset of the decoded block in sstable file
+
       ObScanColumnIndexes cur_column_mask_;//current column mask to show which columns to get
       common::ObCellInfo null_cell_info_;//null cell info for return null cell
       ObSSTableBlockGetter getter_;     //block getter
@@ -43,7 +43,8 @@ namespace oceanbase
       table_id_(OB_INVALID_ID), column_group_id_(OB_INVALID_ID), 
       cur_key_buf_(DEFAULT_KEY_BUF_SIZE), bf_key_buf_(DEFAULT_KEY_BUF_SIZE), 
       offset_(0), prev_offset_(0), row_count_(0), prev_column_group_row_count_(0), 
-      column_group_row_count_(0), compressor_(NULL), uncompressed_blocksize_(0), 
+      column_group_row_count_(0), compressor_(NULL), compress_thread_num_(0),
+      compress_pipeline_(), uncompressed_blocksize_(0), 
       compress_buf_(DEFAULT_COMPRESS_BUF_SIZE), serialize_buf_(DEFAULT_SERIALIZE_BUF_SIZE),
       enable_bloom_filter_(false), sstable_checksum_(0), frozen_time_(0)
     {
@@ -168,6 +169,14 @@ namespace oceanbase
         }
       }
 
+      //start compress threads, compress in this thread if failed
+      if (OB_SUCCESS == ret && compress_thread_num_ > 0
+          && OB_SUCCESS != compress_pipeline_.start(compress_thread_num_, compressor_name.ptr()))
+      {
+        TBSYS_LOG(WARN, "failed to start compress threads, compress blocks "
+                        "in writer thread, compress_thread_num=%ld", compress_thread_num_);
+      }
+
       if (OB_SUCCESS == ret)
       {
         //open sstable file whether using dio according to config file
@@ -403,7 +412,8 @@ namespace oceanbase
         }
       }
 
-      approx_space_usage = offset_ + block_builder_.get_block_size();
+      approx_space_usage = offset_ + compress_pipeline_.get_pending_size()
+        + block_builder_.get_block_size();
       
       return ret;
     }
@@ -432,6 +442,15 @@ namespace oceanbase
                     filename_, table_id_, row_count_, offset_);
           }
         }
+
+        //write the blocks still compressing
+        while (OB_SUCCESS == ret && OB_SUCCESS == (ret = write_compressed_block(true)))
+        {
+        }
+        if (OB_ITER_END == ret)
+        {
+          ret = OB_SUCCESS;
+        }
         
         //write block index
         if (OB_SUCCESS == ret)
@@ -638,6 +657,24 @@ namespace oceanbase
                                              const int64_t comp_size, 
                                              const int64_t uncomp_size,
                                              int64_t& wrote_len)
+    {
+      uint64_t data_checksum = 0;
+
+      if (NULL != comp_data && comp_size > 0)
+      {
+        data_checksum = ob_crc64(comp_data, comp_size);
+      }
+
+      return write_record_header(magic, comp_data, comp_size, uncomp_size,
+                                 data_checksum, wrote_len);
+    }
+
+    int ObSSTableWriter::write_record_header(const int16_t magic,
+                                             const char* comp_data, 
+                                             const int64_t comp_size, 
+                                             const int64_t uncomp_size,
+                                             const uint64_t data_checksum,
+                                             int64_t& wrote_len)
     {
       int ret              = OB_SUCCESS;
       int64_t pos          = 0;
@@ -674,7 +711,7 @@ namespace oceanbase
          * if not using compression, store the checksum of uncompressed
          * data
          */
-        header.data_checksum_ = ob_crc64(comp_data, comp_size);
+        header.data_checksum_ = data_checksum;
 
         //caculate the checksum of sstable
         ret = encode_i64(checksum_buf, checksum_len, pos, header.data_checksum_);
@@ -803,43 +840,160 @@ namespace oceanbase
     int ObSSTableWriter::write_current_block()
     {
       int ret               = OB_SUCCESS;
-      int32_t record_size   = 0;
       int64_t wrote_len     = 0;
 
       //builder block data with expected format
       ret = block_builder_.build_block();
-      if (OB_SUCCESS == ret)
+      if (OB_SUCCESS == ret && compress_pipeline_.is_started())
+      {
+        //compressed by the compress threads, written into sstable file in order
+        ret = push_current_block();
+      }
+      else if (OB_SUCCESS == ret)
       {
         //compress and write block data into sstable file
         ret = compress_and_write(block_builder_.block_buf(),
                                  block_builder_.get_block_data_size(),
                                  DATA_BLOCK_MAGIC, wrote_len, true);
+        if (OB_SUCCESS == ret)
+        {
+          offset_ += wrote_len;   //update current sstable file offset
+          block_builder_.reset(); //reset block builder, very important
+
+          //add one block index entry into block index builder
+          ret = add_block_index_entry(table_id_, column_group_id_, 
+                                      cur_key_, cur_binary_key_);
+        }
       }
 
-      if (OB_SUCCESS == ret)
+      return ret;
+    }
+
+    int ObSSTableWriter::add_block_index_entry(const uint64_t table_id,
+                                               const uint64_t column_group_id,
+                                               const ObRowkey& key,
+                                               const ObString& binary_key)
+    {
+      int ret               = OB_SUCCESS;
+      int32_t record_size   = static_cast<int32_t>(offset_ - prev_offset_);
+
+      prev_offset_ = offset_;
+      if (use_binary_rowkey_)
       {
-        offset_ += wrote_len;   //update current sstable file offset
-        block_builder_.reset(); //reset block builder, very important
+        ret = index_builder_.add_entry(table_id, column_group_id, 
+            binary_key, record_size);
+      }
+      else
+      {
+        ret = index_builder_.add_entry(table_id, column_group_id, 
+            key, record_size);
+      }
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "Problem add entry to block index builder, "
+                        "table_id=%lu, record_size=%d, row_key: %s",
+                  table_id, record_size, to_cstring(key));
+      }
+
+      return ret;
+    }
+
+    int ObSSTableWriter::push_current_block()
+    {
+      int ret                                  = OB_SUCCESS;
+      int64_t data_len                         = block_builder_.get_block_data_size();
+      ObSSTableCompressPipeline::Block* block  = NULL;
+
+      //all blocks are compressing, write the oldest one to make room
+      if (NULL == compress_pipeline_.get_free_block())
+      {
+        ret = write_compressed_block(true);
+      }
 
-        //add one block index entry into block index builder
-        record_size = static_cast<int32_t>(offset_ - prev_offset_);
-        prev_offset_ = offset_;
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "failed to write compressed block, sstable='%s'", filename_);
+      }
+      else if (NULL == (block = compress_pipeline_.get_free_block()))
+      {
+        TBSYS_LOG(WARN, "no free block to compress, sstable='%s'", filename_);
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = block->data_buf_.ensure_space(
+              data_len, ObModIds::OB_SSTABLE_WRITER)))
+      {
+        TBSYS_LOG(WARN, "failed to alloc block buffer, data_len=%ld", data_len);
+      }
+      else
+      {
+        //the block keeps its index entry until it is written
+        memcpy(block->data_buf_.get_buffer(), block_builder_.block_buf(), data_len);
+        block->data_len_ = data_len;
+        block->table_id_ = table_id_;
+        block->column_group_id_ = column_group_id_;
         if (use_binary_rowkey_)
         {
-          ret = index_builder_.add_entry(table_id_, column_group_id_, 
-              cur_binary_key_, record_size);
+          if (OB_SUCCESS == (ret = block->key_buf_.ensure_space(
+                  cur_binary_key_.length(), ObModIds::OB_SSTABLE_WRITER)))
+          {
+            memcpy(block->key_buf_.get_buffer(), cur_binary_key_.ptr(), cur_binary_key_.length());
+            block->binary_key_.assign(block->key_buf_.get_buffer(), cur_binary_key_.length());
+          }
         }
         else
         {
-          ret = index_builder_.add_entry(table_id_, column_group_id_, 
-              cur_key_, record_size);
+          ObMemBufAllocatorWrapper allocator(block->key_buf_);
+          ret = cur_key_.deep_copy(block->key_, allocator);
         }
-        if (OB_SUCCESS != ret)
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        compress_pipeline_.push_block();
+        block_builder_.reset(); //reset block builder, very important
+
+        //write the blocks compressed meanwhile, don't wait for the others
+        while (OB_SUCCESS == (ret = write_compressed_block(false)))
+        {
+        }
+        if (OB_EAGAIN == ret || OB_ITER_END == ret)
+        {
+          ret = OB_SUCCESS;
+        }
+      }
+
+      return ret;
+    }
+
+    int ObSSTableWriter::write_compressed_block(const bool wait)
+    {
+      int ret                                  = OB_SUCCESS;
+      int64_t wrote_len                        = 0;
+      ObSSTableCompressPipeline::Block* block  = NULL;
+
+      if (OB_SUCCESS == (ret = compress_pipeline_.get_compressed_block(block, wait)))
+      {
+        if (OB_SUCCESS != (ret = block->ret_))
+        {
+          TBSYS_LOG(WARN, "failed to compress block, sstable='%s', ret=%d",
+                    filename_, ret);
+        }
+        else if (OB_SUCCESS != (ret = write_record_header(DATA_BLOCK_MAGIC, block->output_,
+                block->output_len_, block->data_len_, block->checksum_, wrote_len)))
+        {
+          TBSYS_LOG(WARN, "failed to write record header, sstable='%s'", filename_);
+        }
+        else if (OB_SUCCESS != (ret = filesys_->append(block->output_, block->output_len_, false)))
+        {
+          TBSYS_LOG(WARN, "failed to write block, sstable='%s'", filename_);
+        }
+        else
         {
-          TBSYS_LOG(WARN, "Problem add entry to block index builder, "
-                          "table_id=%lu, record_size=%d, row_key: %s",
-                    table_id_, record_size, to_cstring(cur_key_));
+          offset_ += wrote_len + block->output_len_;
+          ret = add_block_index_entry(block->table_id_, block->column_group_id_,
+                                      block->key_, block->binary_key_);
         }
+        compress_pipeline_.pop_block();
       }
 
       return ret;
@@ -1116,6 +1270,7 @@ namespace oceanbase
       sstable_checksum_ = 0;
       uncompressed_blocksize_ = 0;
 
+      compress_pipeline_.stop();
       if (NULL != compressor_)
       {
         destroy_compressor(compressor_);
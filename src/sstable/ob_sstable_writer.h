@@ -27,6 +27,7 @@
 #include "ob_sstable_trailer.h"
 #include "ob_sstable_block_index_builder.h"
 #include "ob_sstable_block_builder.h"
+#include "ob_sstable_compress_pipeline.h"
 
 
 namespace oceanbase 
@@ -173,6 +174,17 @@ namespace oceanbase
         dio_ = dio;
       }
 
+      /**
+       * compress data blocks with thread_num threads while appending
+       * rows, the sstable file is the same as compressed in the
+       * appending thread. 0 means compress in the appending thread,
+       * it takes effect from the next create_sstable().
+       */
+      void set_compress_thread_num(const int64_t thread_num)
+      {
+        compress_thread_num_ = thread_num;
+      }
+
       int set_tablet_range(const common::ObNewRange& tablet_range);
 
       const ObSSTableTrailer& get_trailer() const
@@ -235,6 +247,10 @@ namespace oceanbase
                               const int64_t comp_size, const int64_t uncomp_size, 
                               int64_t& writed_len);
 
+      int write_record_header(const int16_t magic, const char* comp_data, 
+                              const int64_t comp_size, const int64_t uncomp_size, 
+                              const uint64_t data_checksum, int64_t& writed_len);
+
       /**
        * compress and write one record, it will call the compressor 
        * here, 
@@ -259,6 +275,31 @@ namespace oceanbase
        */   
       int write_current_block();
 
+      /**
+       * hand current block to the compress threads, and write the
+       * blocks compressed meanwhile into sstable in order
+       * 
+       * @return int if success return OB_SUCCESS, else return 
+       */   
+      int push_current_block();
+
+      int add_block_index_entry(const uint64_t table_id,
+                                const uint64_t column_group_id,
+                                const common::ObRowkey& key,
+                                const common::ObString& binary_key);
+
+      /**
+       * write the oldest block handed to the compress threads into
+       * sstable
+       * 
+       * @param wait wait for the block to be compressed
+       * 
+       * @return int if success return OB_SUCCESS, OB_EAGAIN if the
+       *         block isn't compressed yet and not wait, OB_ITER_END if
+       *         no block is compressing
+       */   
+      int write_compressed_block(const bool wait);
+
       /**
        * write block index data  
        * 
@@ -329,6 +370,8 @@ namespace oceanbase
       int64_t prev_column_group_row_count_;      //row count of previous column group
       int64_t column_group_row_count_;           //row count of current writting column group
       ObCompressor* compressor_;                 //compressor to use
+      int64_t compress_thread_num_;              //threads to compress blocks
+      ObSSTableCompressPipeline compress_pipeline_; //compress blocks with threads
       int64_t uncompressed_blocksize_;           //uncompressed block size
       common::ObMemBuf compress_buf_;            //compress buffer
       common::ObMemBuf serialize_buf_;           //serrialize buffer
@@ -18,6 +18,7 @@
 ////====================================================================
 
 #include "ob_fifo_allocator.h"
+#include "common/ob_huge_page.h"
 
 //#define ob_malloc(size) ::malloc(size)
 //#define ob_free(ptr) ::free(ptr)
@@ -117,7 +118,7 @@ namespace oceanbase
       {
         if (NULL != page)
         {
-          ob_free(page);
+          ob_huge_free(page, mod_id_);
         }
       }
       free_list_.destroy();
@@ -229,7 +230,7 @@ namespace oceanbase
         free_list_.pop(ret);
         if (NULL == ret)
         {
-          ret = (Page*)ob_malloc(page_size_ + sizeof(Page), mod_id_);
+          ret = (Page*)ob_huge_malloc(page_size_ + sizeof(Page), mod_id_);
           if (NULL == ret)
           {
             TBSYS_LOG(WARN, "alloc from system fail size=%ld", page_size_ + sizeof(Page));
@@ -257,7 +258,7 @@ namespace oceanbase
         if (hold_limit_ <= (free_list_.get_total() * page_size_)
             || OB_SUCCESS != free_list_.push(ptr))
         {
-          ob_free(ptr);
+          ob_huge_free(ptr, mod_id_);
         }
       }
     }
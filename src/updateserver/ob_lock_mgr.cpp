@@ -17,6 +17,7 @@
  //
 ////====================================================================
 
+#include "common/ob_common_stat.h"
 #include "ob_lock_mgr.h"
 #include "ob_sessionctx_factory.h"
 
@@ -32,7 +33,7 @@ namespace oceanbase
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    RowExclusiveUnlocker::RowExclusiveUnlocker()
+    RowExclusiveUnlocker::RowExclusiveUnlocker(LockMgr *lock_mgr) : lock_mgr_(lock_mgr)
     {
     }
 
@@ -54,15 +55,19 @@ namespace oceanbase
       else
       {
         TBSYS_LOG(DEBUG, "exclusive unlock row succ sd=%u %s value=%p", session.get_session_descriptor(), value->log_str(), value);
+        if (NULL != lock_mgr_)
+        {
+          lock_mgr_->wakeup(value);
+        }
       }
       return ret;
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    RPLockInfo::RPLockInfo(RPSessionCtx &session_ctx) : ILockInfo(READ_COMMITED),
-                                                        session_ctx_(session_ctx),
-                                                        row_exclusive_unlocker_(),
+    RPLockInfo::RPLockInfo(RPSessionCtx &session_ctx, LockMgr &lock_mgr) : ILockInfo(READ_COMMITED),
+                                                                           session_ctx_(session_ctx),
+                                                                           row_exclusive_unlocker_(&lock_mgr),
                                                         callback_mgr_()
     {
     }
@@ -137,10 +142,14 @@ namespace oceanbase
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    RCLockInfo::RCLockInfo(RWSessionCtx &session_ctx) : ILockInfo(READ_COMMITED),
-                                                        session_ctx_(session_ctx),
-                                                        row_exclusive_unlocker_(),
-                                                        callback_mgr_()
+    RCLockInfo::RCLockInfo(RWSessionCtx &session_ctx, LockMgr &lock_mgr) : ILockInfo(READ_COMMITED),
+                                                                           session_ctx_(session_ctx),
+                                                                           lock_mgr_(lock_mgr),
+                                                                           row_exclusive_unlocker_(&lock_mgr),
+                                                                           callback_mgr_(),
+                                                                           lock_count_(0),
+                                                                           stmt_write_count_(0),
+                                                                           stmt_start_time_(0)
     {
     }
 
@@ -164,6 +173,11 @@ namespace oceanbase
     {
       int ret = OB_SUCCESS;
       uint32_t sd = session_ctx_.get_session_descriptor();
+      if (stmt_start_time_ != session_ctx_.get_stmt_start_time())
+      {
+        stmt_start_time_ = session_ctx_.get_stmt_start_time();
+        stmt_write_count_ = 0;
+      }
       if (!value.row_lock.is_exclusive_locked_by(sd))
       {
         int64_t session_end_time = session_ctx_.get_session_start_time() + session_ctx_.get_session_timeout();
@@ -171,7 +185,14 @@ namespace oceanbase
         int64_t stmt_end_time = session_ctx_.get_stmt_start_time() + session_ctx_.get_stmt_timeout();
         stmt_end_time = (0 <= stmt_end_time) ? stmt_end_time : INT64_MAX;
         int64_t end_time = std::min(session_end_time, stmt_end_time);
-        if (OB_SUCCESS == (ret = value.row_lock.exclusive_lock(sd, end_time, session_ctx_.is_alive())))
+        const bool volatile no_wait = false;
+        if (OB_SUCCESS == (ret = value.row_lock.exclusive_lock(sd, end_time, no_wait)))
+        {}
+        else
+        {
+          ret = wait_row_lock_(key, value, end_time);
+        }
+        if (OB_SUCCESS == ret)
         {
           if (OB_SUCCESS != (ret = callback_mgr_.add_callback_info(session_ctx_, &row_exclusive_unlocker_, &value)))
           {
@@ -179,19 +200,74 @@ namespace oceanbase
           }
           else
           {
+            lock_count_++;
             TBSYS_LOG(DEBUG, "exclusive lock row succ sd=%u %s %s value=%p",
                             session_ctx_.get_session_descriptor(), key.log_str(), value.log_str(), &value);
           }
         }
-        else
-        {
-          ret = OB_ERR_EXCLUSIVE_LOCK_CONFLICT;
-        }
       }
-      if (OB_SUCCESS != ret)
+      if (OB_SUCCESS == ret)
+      {
+        stmt_write_count_++;
+      }
+      else if (OB_ERR_EXCLUSIVE_LOCK_CONFLICT == ret)
       {
         TBSYS_LOG(USER_ERROR, "Exclusive lock conflict \'%s\' for key \'PRIMARY\'", to_cstring(key.row_key));
       }
+      else if (OB_DEAD_LOCK == ret)
+      {
+        TBSYS_LOG(USER_ERROR, "Deadlock found when trying to get lock \'%s\' for key \'PRIMARY\'", to_cstring(key.row_key));
+      }
+      return ret;
+    }
+
+    int RCLockInfo::wait_row_lock_(const TEKey &key, TEValue &value, const int64_t end_time)
+    {
+      int ret = OB_SUCCESS;
+      uint32_t sd = session_ctx_.get_session_descriptor();
+      uint32_t holder_sd = LockMgr::get_lock_holder(value);
+      LockWaitCtx &wait_ctx = LockMgr::get_tsi_wait_ctx();
+      // 持有行锁的事务才可能死锁
+      bool need_detect = (lock_mgr_.is_inited() && 0 < lock_count_ && INVALID_SESSION_DESCRIPTOR != holder_sd);
+      if (wait_ctx.enable && wait_ctx.trans_restartable)
+      {
+        // 整个事务回滚后重新执行, 等锁期间不持有任何行锁
+        wait_ctx.row = &value;
+        wait_ctx.table_id = key.table_id;
+        wait_ctx.sd = INVALID_SESSION_DESCRIPTOR;
+        wait_ctx.end_time = end_time;
+        ret = OB_UPS_LOCK_WAIT;
+      }
+      else if (need_detect
+               && OB_SUCCESS != (ret = lock_mgr_.add_wait_for(sd, holder_sd)))
+      {
+        OB_STAT_TABLE_INC(UPDATESERVER, key.table_id, UPS_STAT_DEADLOCK_COUNT, 1);
+        TBSYS_LOG(WARN, "deadlock detected sd=%u holder_sd=%u %s ret=%d", sd, holder_sd, key.log_str(), ret);
+      }
+      else if (wait_ctx.enable && 0 == stmt_write_count_)
+      {
+        // 语句还没有写过数据, 保留事务只重新执行这条语句
+        wait_ctx.row = &value;
+        wait_ctx.table_id = key.table_id;
+        wait_ctx.sd = need_detect ? sd : INVALID_SESSION_DESCRIPTOR;
+        wait_ctx.end_time = end_time;
+        ret = OB_UPS_LOCK_WAIT;
+      }
+      else
+      {
+        int64_t wait_start_time = tbsys::CTimeUtil::getTime();
+        if (OB_SUCCESS != value.row_lock.exclusive_lock(sd, end_time, session_ctx_.is_alive()))
+        {
+          OB_STAT_TABLE_INC(UPDATESERVER, key.table_id, UPS_STAT_LOCK_WAIT_TIMEOUT_COUNT, 1);
+          ret = OB_ERR_EXCLUSIVE_LOCK_CONFLICT;
+        }
+        OB_STAT_TABLE_INC(UPDATESERVER, key.table_id, UPS_STAT_LOCK_WAIT_COUNT, 1);
+        OB_STAT_TABLE_INC(UPDATESERVER, key.table_id, UPS_STAT_LOCK_WAIT_TIMEU, tbsys::CTimeUtil::getTime() - wait_start_time);
+        if (need_detect)
+        {
+          lock_mgr_.del_wait_for(sd);
+        }
+      }
       return ret;
     }
 
@@ -213,12 +289,265 @@ namespace oceanbase
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    LockMgr::LockMgr()
+    LockMgr::LockMgr() : callback_(NULL),
+                         waiter_num_(0),
+                         wait_for_map_()
     {
     }
 
     LockMgr::~LockMgr()
     {
+      destroy();
+    }
+
+    int LockMgr::init(ILockWaitCallback *callback)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL != callback_)
+      {
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == callback)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (0 != wait_for_map_.create(WAIT_FOR_MAP_BUCKET_NUM))
+      {
+        TBSYS_LOG(WARN, "create wait_for_map fail bucket_num=%ld", WAIT_FOR_MAP_BUCKET_NUM);
+        ret = OB_ERROR;
+      }
+      else
+      {
+        callback_ = callback;
+      }
+      return ret;
+    }
+
+    void LockMgr::destroy()
+    {
+      if (NULL != callback_)
+      {
+        // 剩下的等待者按超时处理
+        expire_waiters(INT64_MAX);
+        wait_for_map_.destroy();
+        callback_ = NULL;
+      }
+    }
+
+    LockWaitCtx &LockMgr::get_tsi_wait_ctx()
+    {
+      static __thread LockWaitCtx wait_ctx = {false, false, NULL, OB_INVALID_ID, INVALID_SESSION_DESCRIPTOR, 0};
+      return wait_ctx;
+    }
+
+    uint32_t LockMgr::get_lock_holder(const TEValue &value)
+    {
+      uint32_t uid = value.row_lock.uid_;
+      return (uid & QLock::EXCLUSIVE_BIT) ? static_cast<uint32_t>(uid & QLock::UID_MASK) : INVALID_SESSION_DESCRIPTOR;
+    }
+
+    LockMgr::WaitBucket &LockMgr::get_bucket_(const TEValue *row)
+    {
+      return buckets_[(reinterpret_cast<uint64_t>(row) / sizeof(TEValue)) % WAIT_BUCKET_NUM];
+    }
+
+    int LockMgr::wait(LockWaitNode &node)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL == callback_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == node.row || NULL == node.waiter)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        WaitBucket &bucket = get_bucket_(node.row);
+        ObSpinLockGuard guard(bucket.lock);
+        // 释放行锁的一方先解锁再进桶唤醒, 在桶锁内看到行锁已释放的等待者不会被唤醒
+        if (INVALID_SESSION_DESCRIPTOR == get_lock_holder(*node.row))
+        {
+          ret = OB_EAGAIN;
+        }
+        else
+        {
+          node.next = NULL;
+          node.wait_start_time = tbsys::CTimeUtil::getTime();
+          if (NULL == bucket.tail)
+          {
+            bucket.head = &node;
+          }
+          else
+          {
+            bucket.tail->next = &node;
+          }
+          bucket.tail = &node;
+          __sync_add_and_fetch(&waiter_num_, 1);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        OB_STAT_TABLE_INC(UPDATESERVER, node.table_id, UPS_STAT_LOCK_WAIT_COUNT, 1);
+      }
+      else if (NULL != callback_ && INVALID_SESSION_DESCRIPTOR != node.sd)
+      {
+        del_wait_for(node.sd);
+      }
+      return ret;
+    }
+
+    LockWaitNode *LockMgr::pop_waiter_(TEValue *row)
+    {
+      LockWaitNode *node = NULL;
+      WaitBucket &bucket = get_bucket_(row);
+      ObSpinLockGuard guard(bucket.lock);
+      LockWaitNode *prev = NULL;
+      for (node = bucket.head; NULL != node; prev = node, node = node->next)
+      {
+        if (row == node->row)
+        {
+          if (NULL == prev)
+          {
+            bucket.head = node->next;
+          }
+          else
+          {
+            prev->next = node->next;
+          }
+          if (bucket.tail == node)
+          {
+            bucket.tail = prev;
+          }
+          node->next = NULL;
+          __sync_add_and_fetch(&waiter_num_, -1);
+          break;
+        }
+      }
+      return node;
+    }
+
+    void LockMgr::wakeup(TEValue *row)
+    {
+      LockWaitNode *node = NULL;
+      if (0 < waiter_num_
+          && NULL != row
+          && NULL != (node = pop_waiter_(row)))
+      {
+        on_wakeup_(*node, false);
+      }
+    }
+
+    void LockMgr::wakeup_next(TEValue *row)
+    {
+      if (NULL != row
+          && INVALID_SESSION_DESCRIPTOR == get_lock_holder(*row))
+      {
+        wakeup(row);
+      }
+    }
+
+    void LockMgr::expire_waiters(const int64_t cur_time)
+    {
+      LockWaitNode *expired_list = NULL;
+      for (int64_t i = 0; 0 < waiter_num_ && i < WAIT_BUCKET_NUM; i++)
+      {
+        WaitBucket &bucket = buckets_[i];
+        ObSpinLockGuard guard(bucket.lock);
+        LockWaitNode *prev = NULL;
+        LockWaitNode *node = bucket.head;
+        while (NULL != node)
+        {
+          LockWaitNode *next = node->next;
+          if (node->end_time > cur_time)
+          {
+            prev = node;
+          }
+          else
+          {
+            if (NULL == prev)
+            {
+              bucket.head = next;
+            }
+            else
+            {
+              prev->next = next;
+            }
+            if (bucket.tail == node)
+            {
+              bucket.tail = prev;
+            }
+            node->next = expired_list;
+            expired_list = node;
+            __sync_add_and_fetch(&waiter_num_, -1);
+          }
+          node = next;
+        }
+      }
+      while (NULL != expired_list)
+      {
+        LockWaitNode *node = expired_list;
+        expired_list = expired_list->next;
+        node->next = NULL;
+        OB_STAT_TABLE_INC(UPDATESERVER, node->table_id, UPS_STAT_LOCK_WAIT_TIMEOUT_COUNT, 1);
+        on_wakeup_(*node, true);
+      }
+    }
+
+    void LockMgr::on_wakeup_(LockWaitNode &node, const bool timeout)
+    {
+      OB_STAT_TABLE_INC(UPDATESERVER, node.table_id, UPS_STAT_LOCK_WAIT_TIMEU,
+                        tbsys::CTimeUtil::getTime() - node.wait_start_time);
+      if (INVALID_SESSION_DESCRIPTOR != node.sd)
+      {
+        del_wait_for(node.sd);
+      }
+      TBSYS_LOG(DEBUG, "lock waiter wakeup row=%p table_id=%lu sd=%u wait_time=%ld timeout=%s",
+                node.row, node.table_id, node.sd, tbsys::CTimeUtil::getTime() - node.wait_start_time, STR_BOOL(timeout));
+      callback_->on_lock_wakeup(node, timeout);
+    }
+
+    int LockMgr::add_wait_for(const uint32_t sd, const uint32_t holder_sd)
+    {
+      int ret = OB_SUCCESS;
+      uint32_t cur_sd = holder_sd;
+      uint32_t next_sd = INVALID_SESSION_DESCRIPTOR;
+      int hash_ret = 0;
+      if (NULL == callback_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      // 沿着等待图走, 回到sd说明形成了环
+      // 两个事务同时加边时可能都看不到环, 这种情况由等锁超时兜底
+      for (int64_t depth = 0; OB_SUCCESS == ret && depth < MAX_DEADLOCK_DETECT_DEPTH; depth++)
+      {
+        if (sd == cur_sd)
+        {
+          ret = OB_DEAD_LOCK;
+        }
+        else if (hash::HASH_EXIST != wait_for_map_.get(cur_sd, next_sd))
+        {
+          break;
+        }
+        else
+        {
+          cur_sd = next_sd;
+        }
+      }
+      if (OB_SUCCESS == ret
+          && hash::HASH_INSERT_SUCC != (hash_ret = wait_for_map_.set(sd, holder_sd, 1))
+          && hash::HASH_OVERWRITE_SUCC != hash_ret)
+      {
+        TBSYS_LOG(WARN, "add wait for fail sd=%u holder_sd=%u hash_ret=%d", sd, holder_sd, hash_ret);
+        ret = OB_ERROR;
+      }
+      return ret;
+    }
+
+    void LockMgr::del_wait_for(const uint32_t sd)
+    {
+      wait_for_map_.erase(sd);
     }
 
     ILockInfo *LockMgr::assign(const IsolationLevel level, RWSessionCtx &session_ctx)
@@ -231,14 +560,14 @@ namespace oceanbase
         buffer = session_ctx.alloc(sizeof(RPLockInfo));
         if (NULL != buffer)
         {
-          ret = new(buffer) RPLockInfo(session_ctx);
+          ret = new(buffer) RPLockInfo(session_ctx, *this);
         }
         break;
       case READ_COMMITED:
         buffer = session_ctx.alloc(sizeof(RCLockInfo));
         if (NULL != buffer)
         {
-          ret = new(buffer) RCLockInfo(session_ctx);
+          ret = new(buffer) RCLockInfo(session_ctx, *this);
         }
         break;
       default:
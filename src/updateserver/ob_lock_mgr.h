@@ -21,6 +21,8 @@
 #define  OCEANBASE_UPDATESERVER_LOCK_MGR_H_
 #include "common/ob_define.h"
 #include "common/ob_transaction.h" 
+#include "common/ob_spin_lock.h"
+#include "common/hash/ob_hashmap.h"
 #include "ob_table_engine.h"
 
 namespace oceanbase
@@ -53,23 +55,84 @@ namespace oceanbase
         virtual int unlock(TEValue *value, BaseSessionCtx &session) = 0;
     };
 
+    class LockMgr;
     class RowExclusiveUnlocker : public IRowUnlocker
     {
       public:
-        RowExclusiveUnlocker();
+        RowExclusiveUnlocker(LockMgr *lock_mgr);
         ~RowExclusiveUnlocker();
       public:
         int unlock(TEValue *value, BaseSessionCtx &session);
+      private:
+        LockMgr *lock_mgr_;
+    };
+
+    // 挂在行锁等待队列上的事务, 嵌在事务执行线程的task里
+    struct LockWaitNode
+    {
+      TEValue *row;
+      uint64_t table_id;
+      // 等锁的事务持有其他行锁时才有sd, 用于维护等待图
+      uint32_t sd;
+      int64_t wait_start_time;
+      int64_t end_time;
+      void *waiter;
+      LockWaitNode *next;
+      LockWaitNode()
+      {
+        reset();
+      };
+      void reset()
+      {
+        row = NULL;
+        table_id = common::OB_INVALID_ID;
+        sd = INVALID_SESSION_DESCRIPTOR;
+        wait_start_time = 0;
+        end_time = 0;
+        waiter = NULL;
+        next = NULL;
+      };
+    };
+
+    // 一条语句执行过程中遇到的行锁冲突, 线程局部变量
+    // enable为true时RCLockInfo遇到冲突不再原地等锁, 而是返回OB_UPS_LOCK_WAIT
+    // 由事务执行线程回滚语句后把task挂到行锁等待队列上
+    // trans_restartable为true表示出错时整个事务回滚, 语句写过数据也可以重新执行
+    struct LockWaitCtx
+    {
+      bool enable;
+      bool trans_restartable;
+      TEValue *row;
+      uint64_t table_id;
+      uint32_t sd;
+      int64_t end_time;
+      void reset()
+      {
+        enable = false;
+        trans_restartable = false;
+        row = NULL;
+        table_id = common::OB_INVALID_ID;
+        sd = INVALID_SESSION_DESCRIPTOR;
+        end_time = 0;
+      };
+    };
+
+    class ILockWaitCallback
+    {
+      public:
+        virtual ~ILockWaitCallback() {};
+      public:
+        // 行锁释放或者等锁超时时调用, 调用之后node不再属于LockMgr
+        virtual void on_lock_wakeup(LockWaitNode &node, const bool timeout) = 0;
     };
 
-    class LockMgr;
     class RWSessionCtx;
     typedef RWSessionCtx RPSessionCtx;
     
     class RPLockInfo : public ILockInfo // Replay lock info
     {
       public:
-        RPLockInfo(RPSessionCtx &session_ctx);
+        RPLockInfo(RPSessionCtx &session_ctx, LockMgr &lock_mgr);
         ~RPLockInfo();
       public:
         int on_trans_begin();
@@ -88,7 +151,7 @@ namespace oceanbase
     class RCLockInfo : public ILockInfo // Read commited lock info
     {
       public:
-        RCLockInfo(RWSessionCtx &session_ctx);
+        RCLockInfo(RWSessionCtx &session_ctx, LockMgr &lock_mgr);
         ~RCLockInfo();
       public:
         int on_trans_begin();
@@ -98,19 +161,69 @@ namespace oceanbase
         void on_precommit_end();
       public:
         int cb_func(const bool rollback, void *data, BaseSessionCtx &session);
+      private:
+        int wait_row_lock_(const TEKey &key, TEValue &value, const int64_t end_time);
       private:
         RWSessionCtx &session_ctx_;
+        LockMgr &lock_mgr_;
         RowExclusiveUnlocker row_exclusive_unlocker_;
         CallbackMgr callback_mgr_;
+        // 本事务持有的行锁个数和当前语句加过写锁的行数
+        int64_t lock_count_;
+        int64_t stmt_write_count_;
+        int64_t stmt_start_time_;
     };
 
+    // 行锁等待队列和等待图
+    // 等锁的事务按行挂在分桶的链表上, 行锁释放时按FIFO顺序唤醒第一个等待者,
+    // 被唤醒的事务重新执行语句, 如果没有拿到行锁则通过wakeup_next唤醒下一个
+    // 持有行锁又在等锁的事务在wait_for_map_里记录它等待的事务, 加入等待前沿着
+    // 等待图查找环, 找到环则返回OB_DEAD_LOCK
     class LockMgr
     {
+      typedef common::hash::ObHashMap<uint32_t, uint32_t> WaitForMap;
+      struct WaitBucket
+      {
+        common::ObSpinLock lock;
+        LockWaitNode *head;
+        LockWaitNode *tail;
+        WaitBucket() : lock(), head(NULL), tail(NULL) {};
+      };
+      static const int64_t WAIT_BUCKET_NUM = 1024;
+      static const int64_t WAIT_FOR_MAP_BUCKET_NUM = 10240;
+      static const int64_t MAX_DEADLOCK_DETECT_DEPTH = 64;
       public:
         LockMgr();
         ~LockMgr();
       public:
+        int init(ILockWaitCallback *callback);
+        void destroy();
         ILockInfo *assign(const common::IsolationLevel level, RWSessionCtx &session_ctx);
+      public:
+        static LockWaitCtx &get_tsi_wait_ctx();
+        static uint32_t get_lock_holder(const TEValue &value);
+        bool is_inited() const {return NULL != callback_;};
+        // 挂入等待队列, 行锁已经释放时返回OB_EAGAIN, 调用者应直接重新执行
+        int wait(LockWaitNode &node);
+        // 行锁释放后调用, 唤醒第一个等待者
+        void wakeup(TEValue *row);
+        // 被唤醒的事务没有拿到行锁时调用, 行锁空闲则继续唤醒下一个等待者
+        void wakeup_next(TEValue *row);
+        void expire_waiters(const int64_t cur_time);
+        int64_t get_waiter_num() const {return waiter_num_;};
+      public:
+        // 记录sd在等待holder_sd持有的行锁, 形成环时返回OB_DEAD_LOCK
+        int add_wait_for(const uint32_t sd, const uint32_t holder_sd);
+        void del_wait_for(const uint32_t sd);
+      private:
+        WaitBucket &get_bucket_(const TEValue *row);
+        LockWaitNode *pop_waiter_(TEValue *row);
+        void on_wakeup_(LockWaitNode &node, const bool timeout);
+      private:
+        ILockWaitCallback *callback_;
+        WaitBucket buckets_[WAIT_BUCKET_NUM];
+        volatile int64_t waiter_num_;
+        WaitForMap wait_for_map_;
     };
   }
 }
@@ -29,6 +29,47 @@ namespace oceanbase
     using namespace common;
     using namespace hash;
 
+    void MemTableChainStat::reset(const uint64_t tid)
+    {
+      table_id = tid;
+      row_count = 0;
+      compacted_row_count = 0;
+      max_chain_length = 0;
+      memset(buckets, 0, sizeof(buckets));
+    }
+
+    void MemTableChainStat::add(const int64_t chain_length)
+    {
+      int64_t idx = 0;
+      while (idx < BUCKET_NUM - 1
+             && (2L << idx) <= chain_length)
+      {
+        idx++;
+      }
+      buckets[idx]++;
+      row_count++;
+      if (max_chain_length < chain_length)
+      {
+        max_chain_length = chain_length;
+      }
+    }
+
+    int64_t MemTableChainStat::to_string(char *buf, const int64_t buf_len) const
+    {
+      int64_t pos = 0;
+      databuff_printf(buf, buf_len, pos, "table_id=%lu rows=%ld compacted=%ld max_chain=%ld hist=[",
+                      table_id, row_count, compacted_row_count, max_chain_length);
+      for (int64_t i = 0; i < BUCKET_NUM; i++)
+      {
+        databuff_printf(buf, buf_len, pos, "%s%ld%s:%ld", (0 == i) ? "" : " ",
+                        1L << i, (BUCKET_NUM - 1 == i) ? "+" : "", buckets[i]);
+      }
+      databuff_printf(buf, buf_len, pos, "]");
+      return pos;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
     MemTable::MemTable() : inited_(false), mem_tank_(), table_engine_(mem_tank_), table_bf_(),
                            version_(0), ref_cnt_(0),
                            checksum_before_mutate_(0), checksum_after_mutate_(0),
@@ -314,7 +355,10 @@ namespace oceanbase
           {
             if (OB_SUCCESS != (ret = lock_info.on_write_begin(cur_key, *cur_value)))
             {
-              TBSYS_LOG(WARN, "lock info on write begin fail, ret=%d %s", ret, cur_key.log_str());
+              if (OB_UPS_LOCK_WAIT != ret)
+              {
+                TBSYS_LOG(WARN, "lock info on write begin fail, ret=%d %s", ret, cur_key.log_str());
+              }
             }
             else
             {
@@ -655,6 +699,15 @@ namespace oceanbase
     int MemTable::merge_(RWSessionCtx &session,
                         const TEKey &te_key,
                         TEValue &te_value)
+    {
+      BaseSessionCtx merge_session(session.get_type(), session.get_host());
+      merge_session.set_trans_id(session.get_min_flying_trans_id());
+      return compact_value_(merge_session, te_key, te_value);
+    }
+
+    int MemTable::compact_value_(const BaseSessionCtx &merge_session,
+                                 const TEKey &te_key,
+                                 TEValue &te_value)
     {
       int ret = OB_SUCCESS;
       int64_t timeu = tbsys::CTimeUtil::getTime();
@@ -663,11 +716,8 @@ namespace oceanbase
       new_value.reset();
       new_value.index_stat = te_value.index_stat;
       new_value.cur_uc_info = te_value.cur_uc_info;
-      new_value.row_lock = te_value.row_lock;
 
       MemTableGetIter get_iter;
-      BaseSessionCtx merge_session(session.get_type(), session.get_host());
-      merge_session.set_trans_id(session.get_min_flying_trans_id());
       get_iter.set_(te_key, &te_value, NULL, false, &merge_session);
       ObRowCompaction *rc_iter = GET_TSI_MULT(ObRowCompaction, TSI_UPS_ROW_COMPACTION_1);
       FixedSizeBuffer<OB_MAX_PACKET_LENGTH> *tbuf = GET_TSI_MULT(FixedSizeBuffer<OB_MAX_PACKET_LENGTH>, TSI_UPS_FIXED_SIZE_BUFFER_2);
@@ -789,8 +839,12 @@ namespace oceanbase
                   te_value.log_list(), new_value.log_list(), &te_value, timeu);
         if (NULL != new_value.list_head)
         {
-          // change te_value to new_value
-          te_value = new_value;
+          // change te_value to new_value, row_lock is held by the caller and must not be copied
+          te_value.cell_info_cnt = new_value.cell_info_cnt;
+          te_value.cell_info_size = new_value.cell_info_size;
+          te_value.list_tail = new_value.list_tail;
+          __sync_synchronize();
+          te_value.list_head = new_value.list_head;
           OB_STAT_INC(UPDATESERVER, UPS_STAT_MERGE_COUNT, 1);
           OB_STAT_INC(UPDATESERVER, UPS_STAT_MERGE_TIMEU, timeu);
         }
@@ -1401,8 +1455,12 @@ namespace oceanbase
       {
         if (OB_SUCCESS != (ret = lock_info->on_write_begin(key, *value)))
         {
-          TBSYS_LOG(WARN, "lock info on write begin fail, ret=%d %s", ret, key.log_str());
-          ret = OB_ERR_SHARED_LOCK_CONFLICT;
+          if (OB_UPS_LOCK_WAIT != ret)
+          {
+            TBSYS_LOG(WARN, "lock info on write begin fail, ret=%d %s", ret, key.log_str());
+          }
+          // 进入行锁等待队列和死锁时保留错误码, 由事务执行线程处理
+          ret = (OB_UPS_LOCK_WAIT == ret || OB_DEAD_LOCK == ret) ? ret : OB_ERR_SHARED_LOCK_CONFLICT;
         }
       }
       else
@@ -1722,9 +1780,9 @@ namespace oceanbase
         TBSYS_LOG(WARN, "have not inited");
         ret = OB_ERROR;
       }
-      else if (OB_SUCCESS != table_engine_.scan(empty_key, min_key, start_exclude,
-                                                empty_key, max_key, end_exclude,
-                                                reverse, iter))
+      else if (OB_SUCCESS != (ret = table_engine_.scan(empty_key, min_key, start_exclude,
+                                                       empty_key, max_key, end_exclude,
+                                                       reverse, iter)))
       {
         TBSYS_LOG(WARN, "table engine scan fail ret=%d", ret);
       }
@@ -1735,6 +1793,289 @@ namespace oceanbase
       return ret;
     }
 
+    int64_t MemTable::get_chain_length_(const TEValue &te_value)
+    {
+      int64_t ret = 0;
+      const ObCellInfoNode *list_tail = te_value.list_tail;
+      const ObCellInfoNode *node = te_value.list_head;
+      while (NULL != node)
+      {
+        ret++;
+        if (node == list_tail)
+        {
+          break;
+        }
+        node = node->next;
+      }
+      return ret;
+    }
+
+    int MemTable::compact_rows(SessionMgr &session_mgr,
+                               LockMgr *lock_mgr,
+                               const int64_t min_chain_length,
+                               MemTableChainStats &stats)
+    {
+      int ret = OB_SUCCESS;
+      TableEngineIterator iter;
+      BaseSessionCtx merge_session(ST_READ_ONLY, session_mgr);
+      merge_session.set_trans_id(session_mgr.get_min_flying_trans_id());
+      stats.clear();
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (ret = scan_all(iter)))
+      {
+        TBSYS_LOG(WARN, "scan all fail ret=%d", ret);
+      }
+      while (OB_SUCCESS == ret
+            && OB_SUCCESS == (ret = iter.next()))
+      {
+        const TEKey &te_key = iter.get_key();
+        TEValue *te_value = iter.get_value();
+        if (NULL == te_value)
+        {
+          continue;
+        }
+        if (0 == stats.count()
+            || te_key.table_id != stats.at(stats.count() - 1).table_id)
+        {
+          MemTableChainStat stat;
+          stat.reset(te_key.table_id);
+          if (OB_SUCCESS != (ret = stats.push_back(stat)))
+          {
+            TBSYS_LOG(WARN, "push chain stat fail ret=%d table_id=%lu", ret, te_key.table_id);
+            break;
+          }
+        }
+        MemTableChainStat &stat = stats.at(stats.count() - 1);
+        int64_t chain_length = get_chain_length_(*te_value);
+        stat.add(chain_length);
+        if (min_chain_length > chain_length
+            || NULL != te_value->cur_uc_info)
+        {
+          continue;
+        }
+        if (OB_SUCCESS != te_value->row_lock.try_exclusive_lock(COMPACT_LOCK_UID))
+        {
+          TBSYS_LOG(DEBUG, "row locked, skip compact %s %s", te_key.log_str(), te_value->log_str());
+        }
+        else
+        {
+          // 加锁前可能有事务写入了这一行 此时不合并
+          int tmp_ret = OB_SUCCESS;
+          if (NULL == te_value->cur_uc_info)
+          {
+            if (OB_SUCCESS != (tmp_ret = compact_value_(merge_session, te_key, *te_value)))
+            {
+              TBSYS_LOG(DEBUG, "compact value fail ret=%d %s %s", tmp_ret, te_key.log_str(), te_value->log_str());
+            }
+            else if (chain_length > get_chain_length_(*te_value))
+            {
+              stat.compacted_row_count++;
+            }
+          }
+          te_value->row_lock.exclusive_unlock(COMPACT_LOCK_UID);
+          // 合并期间来写这一行的事务已经在lock_mgr中排队, 与RowExclusiveUnlocker一样先解锁再唤醒
+          if (NULL != lock_mgr)
+          {
+            lock_mgr->wakeup(te_value);
+          }
+        }
+      }
+      if (OB_ITER_END == ret)
+      {
+        ret = OB_SUCCESS;
+      }
+      return ret;
+    }
+
+    int MemTable::checkpoint_row(const BaseSessionCtx &session_ctx,
+                                 const TEKey &te_key,
+                                 const TEValue &te_value,
+                                 char *buf,
+                                 const int64_t buf_len,
+                                 int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      int64_t new_pos = pos;
+      int64_t header_pos = 0;
+      int64_t mtime = 0;
+      int64_t cell_num = 0;
+      MemTableGetIter get_iter;
+      get_iter.set_(te_key, &te_value, NULL, false, &session_ctx);
+      ObRowCompaction *rc_iter = GET_TSI_MULT(ObRowCompaction, TSI_UPS_ROW_COMPACTION_1);
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == rc_iter)
+      {
+        TBSYS_LOG(WARN, "get tsi ObRowCompaction fail");
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, new_pos, static_cast<int64_t>(te_key.table_id)))
+              || OB_SUCCESS != (ret = te_key.row_key.serialize(buf, buf_len, new_pos)))
+      {
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        // modify_time和cell_num在迭代完之后回填
+        header_pos = new_pos;
+        new_pos += 2 * serialization::encoded_length_i64(0);
+        rc_iter->set_iterator(&get_iter);
+      }
+      while (OB_SUCCESS == ret
+            && OB_SUCCESS == (ret = rc_iter->next_cell()))
+      {
+        ObCellInfo *ci = NULL;
+        if (OB_SUCCESS != (ret = rc_iter->get_cell(&ci)))
+        {
+          break;
+        }
+        if (NULL == ci)
+        {
+          ret = OB_ERROR;
+          break;
+        }
+        if (is_row_not_exist_(ci->value_))
+        {
+          ret = OB_ENTRY_NOT_EXIST;
+          break;
+        }
+        if (0 == mtime
+            && ObModifyTimeType == ci->value_.get_type())
+        {
+          ci->value_.get_modifytime(mtime);
+        }
+        if (OB_SUCCESS != (ret = serialization::encode_vi64(buf, buf_len, new_pos, static_cast<int64_t>(ci->column_id_)))
+            || OB_SUCCESS != (ret = ci->value_.serialize(buf, buf_len, new_pos)))
+        {
+          ret = OB_SIZE_OVERFLOW;
+          break;
+        }
+        cell_num++;
+      }
+      if (OB_ITER_END == ret)
+      {
+        if (0 == cell_num)
+        {
+          ret = OB_ENTRY_NOT_EXIST;
+        }
+        else if (new_pos > buf_len)
+        {
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else if (OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, header_pos, mtime))
+                || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, header_pos, cell_num)))
+        {
+          TBSYS_LOG(WARN, "encode row header fail ret=%d %s", ret, te_key.log_str());
+        }
+        else
+        {
+          pos = new_pos;
+        }
+      }
+      return ret;
+    }
+
+    int MemTable::load_checkpoint_row(const char *buf,
+                                      const int64_t data_len,
+                                      int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      int64_t table_id = 0;
+      int64_t mtime = 0;
+      int64_t cell_num = 0;
+      ObObj rowkey_objs[OB_MAX_ROWKEY_COLUMN_NUMBER];
+      TEKey te_key;
+      te_key.row_key.assign(rowkey_objs, OB_MAX_ROWKEY_COLUMN_NUMBER);
+      TEValue *te_value = NULL;
+      FixedSizeBuffer<OB_MAX_PACKET_LENGTH> *tbuf = GET_TSI_MULT(FixedSizeBuffer<OB_MAX_PACKET_LENGTH>, TSI_UPS_FIXED_SIZE_BUFFER_2);
+      ObUpsCompactCellWriter ccw;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == tbuf)
+      {
+        TBSYS_LOG(WARN, "get tsi FixedSizeBuffer fail");
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &table_id))
+              || OB_SUCCESS != (ret = te_key.row_key.deserialize(buf, data_len, pos))
+              || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, &mtime))
+              || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, &cell_num)))
+      {
+        TBSYS_LOG(WARN, "decode row header fail ret=%d pos=%ld data_len=%ld", ret, pos, data_len);
+      }
+      else if (NULL == (te_value = (TEValue*)mem_tank_.tevalue_alloc(sizeof(TEValue))))
+      {
+        ret = OB_MEM_OVERFLOW;
+      }
+      else
+      {
+        te_key.table_id = static_cast<uint64_t>(table_id);
+        te_value->reset();
+        ccw.init(tbuf->get_buffer(), tbuf->get_size(), &mem_tank_);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < cell_num; i++)
+      {
+        int64_t column_id = 0;
+        ObObj value;
+        if (OB_SUCCESS != (ret = serialization::decode_vi64(buf, data_len, pos, &column_id))
+            || OB_SUCCESS != (ret = value.deserialize(buf, data_len, pos)))
+        {
+          TBSYS_LOG(WARN, "decode cell fail ret=%d pos=%ld data_len=%ld", ret, pos, data_len);
+        }
+        else if (OB_SUCCESS != (ret = (is_delete_row_(value) ? ccw.row_delete() : ccw.append(static_cast<uint64_t>(column_id), value))))
+        {
+          TBSYS_LOG(WARN, "append cell fail ret=%d %s", ret, te_key.log_str());
+        }
+        else
+        {
+          te_value->cell_info_cnt++;
+          te_value->cell_info_size = static_cast<int16_t>(te_value->cell_info_size + get_varchar_length_kb_(value));
+        }
+      }
+      if (OB_SUCCESS == ret
+          && 0 < ccw.size())
+      {
+        ccw.row_finish();
+        ObCellInfoNode *node = (ObCellInfoNode*)mem_tank_.node_alloc(static_cast<int32_t>(sizeof(ObCellInfoNode) + ccw.size()));
+        TEKey tmp_key = te_key;
+        if (NULL == node)
+        {
+          ret = OB_MEM_OVERFLOW;
+        }
+        else if (OB_SUCCESS != (ret = mem_tank_.write_string(te_key.row_key, &(tmp_key.row_key))))
+        {
+          TBSYS_LOG(WARN, "copy rowkey fail, ret=%d %s", ret, te_key.log_str());
+        }
+        else
+        {
+          memcpy(node->buf, ccw.get_buf(), ccw.size());
+          node->next = NULL;
+          node->modify_time = mtime;
+          te_value->list_head = node;
+          te_value->list_tail = node;
+          if (OB_SUCCESS != (ret = table_bf_.insert(tmp_key.table_id, tmp_key.row_key)))
+          {
+            TBSYS_LOG(WARN, "insert cur_key to bloomfilter fail ret=%d %s", ret, te_key.log_str());
+          }
+          else if (OB_SUCCESS != (ret = table_engine_.set(tmp_key, te_value)))
+          {
+            TBSYS_LOG(WARN, "put to table_engine fail ret=%d %s", ret, te_key.log_str());
+          }
+        }
+      }
+      return ret;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
     MemTableGetIter::MemTableGetIter() : te_key_(),
@@ -39,6 +39,7 @@
 #include "common/ob_cell_meta.h"
 #include "common/ob_column_filter.h"
 #include "common/ob_cellinfo_processor.h"
+#include "common/ob_array.h"
 #include "sql/ob_husk_phy_operator.h"
 #include "ob_table_engine.h"
 #include "ob_ups_mutator.h"
@@ -214,6 +215,22 @@ namespace oceanbase
       };
     };
 
+    // 每张表的版本链长度直方图 由后台compaction统计
+    struct MemTableChainStat
+    {
+      // bucket i counts rows whose chain length is in [2^i, 2^(i+1)), the last bucket is open
+      static const int64_t BUCKET_NUM = 8;
+      uint64_t table_id;
+      int64_t row_count;
+      int64_t compacted_row_count;
+      int64_t max_chain_length;
+      int64_t buckets[BUCKET_NUM];
+      void reset(const uint64_t tid);
+      void add(const int64_t chain_length);
+      int64_t to_string(char *buf, const int64_t buf_len) const;
+    };
+    typedef common::ObArray<MemTableChainStat> MemTableChainStats;
+
     class ObUpsTableMgr;
     class MemTable : public ITableEngine
     {
@@ -234,6 +251,8 @@ namespace oceanbase
       static const int64_t BLOOM_FILTER_NHASH = 1;
       static const int64_t BLOOM_FILTER_NBYTE = common::OB_MAX_PACKET_LENGTH - 1 * 1024;
       static const int64_t MAX_TRANS_NUM = 64;
+      // 后台合并持有行锁使用的uid, session descriptor只使用低31位且不会分配到这个值
+      static const uint32_t COMPACT_LOCK_UID = 0x7fffffff;
       public:
         MemTable();
         ~MemTable();
@@ -456,6 +475,30 @@ namespace oceanbase
 
         int scan_all(TableEngineIterator &iter);
 
+        // 后台合并版本链: 把早于最小活跃事务的已提交版本合并成一个节点
+        // 只处理链长不小于min_chain_length且没有未提交数据的行 行锁被占用时跳过
+        // 释放行锁后通过lock_mgr唤醒在这一行上排队的事务
+        // @param [out] stats 每张表的版本链长度直方图
+        int compact_rows(SessionMgr &session_mgr,
+                         LockMgr *lock_mgr,
+                         const int64_t min_chain_length,
+                         MemTableChainStats &stats);
+
+        // checkpoint: 把一行在session_ctx的事务号上可见的已提交数据合并后序列化到buf
+        // 格式为 table_id, rowkey, modify_time, cell_num, (column_id, value)*
+        // 该事务号上行不存在时返回OB_ENTRY_NOT_EXIST, buf不够时pos不变
+        int checkpoint_row(const BaseSessionCtx &session_ctx,
+                           const TEKey &te_key,
+                           const TEValue &te_value,
+                           char *buf,
+                           const int64_t buf_len,
+                           int64_t &pos);
+        // 加载checkpoint_row输出的一行 构造成单个已提交版本节点直接插入索引
+        // 只在重启回放日志之前调用 不加行锁也不经过事务
+        int load_checkpoint_row(const char *buf,
+                                const int64_t data_len,
+                                int64_t &pos);
+
       private:
         inline int copy_cells_(TransNode &tn,
                               TEValue &value,
@@ -524,6 +567,10 @@ namespace oceanbase
         inline int merge_(RWSessionCtx &session,
                           const TEKey &te_key,
                           TEValue &te_value);
+        int compact_value_(const BaseSessionCtx &merge_session,
+                           const TEKey &te_key,
+                           TEValue &te_value);
+        inline static int64_t get_chain_length_(const TEValue &te_value);
 
         inline static bool is_row_too_long_(const RWSessionCtx &session, const TEKey &te_key, const TEValue &te_value);
         inline static int16_t get_varchar_length_kb_(const common::ObObj &value)
@@ -0,0 +1,917 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_memtable_checkpoint.cpp
+ *
+ */
+#include <algorithm>
+#include "ob_memtable_checkpoint.h"
+#include "common/ob_record_header.h"
+#include "common/ob_malloc.h"
+#include "common/serialization.h"
+#include "common/utility.h"
+#include "ob_ups_table_mgr.h"
+#include "ob_ups_log_mgr.h"
+#include "ob_sstable_mgr.h"
+#include "ob_session_mgr.h"
+#include "ob_update_server_config.h"
+#include "ob_update_server_main.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    using namespace common;
+
+    const char *MemTableCheckpointer::CHECKPOINT_FNAME = "memtable_checkpoint";
+
+    MemTableCheckpointMeta::MemTableCheckpointMeta()
+    {
+      reset();
+    }
+
+    void MemTableCheckpointMeta::reset()
+    {
+      version = CUR_VERSION;
+      memtable_version = 0;
+      base_clog_id = 0;
+      clog_id = 0;
+      trans_id = 0;
+      checksum = 0;
+      uncommited_checksum = 0;
+      last_trans_id = 0;
+      row_counter = 0;
+    }
+
+    int MemTableCheckpointMeta::serialize(char *buf, const int64_t buf_len, int64_t &pos) const
+    {
+      int ret = OB_SUCCESS;
+      if (OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, version))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, static_cast<int64_t>(memtable_version)))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, static_cast<int64_t>(base_clog_id)))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, static_cast<int64_t>(clog_id)))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, trans_id))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, static_cast<int64_t>(checksum)))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, static_cast<int64_t>(uncommited_checksum)))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, last_trans_id))
+          || OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_len, pos, row_counter))
+          || OB_SUCCESS != (ret = schema.serialize(buf, buf_len, pos)))
+      {
+        TBSYS_LOG(WARN, "serialize checkpoint meta fail ret=%d buf_len=%ld pos=%ld", ret, buf_len, pos);
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointMeta::deserialize(const char *buf, const int64_t data_len, int64_t &pos)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, &version))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, reinterpret_cast<int64_t*>(&memtable_version)))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, reinterpret_cast<int64_t*>(&base_clog_id)))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, reinterpret_cast<int64_t*>(&clog_id)))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, &trans_id))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, reinterpret_cast<int64_t*>(&checksum)))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, reinterpret_cast<int64_t*>(&uncommited_checksum)))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, &last_trans_id))
+          || OB_SUCCESS != (ret = serialization::decode_i64(buf, data_len, pos, &row_counter)))
+      {
+        TBSYS_LOG(WARN, "deserialize checkpoint meta fail ret=%d data_len=%ld pos=%ld", ret, data_len, pos);
+      }
+      else if (CUR_VERSION != version)
+      {
+        TBSYS_LOG(WARN, "checkpoint meta version=%ld not supported", version);
+        ret = OB_NOT_SUPPORTED;
+      }
+      else if (OB_SUCCESS != (ret = schema.deserialize(buf, data_len, pos)))
+      {
+        TBSYS_LOG(WARN, "deserialize checkpoint schema fail ret=%d", ret);
+      }
+      return ret;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    MemTableCheckpointer::MemTableCheckpointer() : table_mgr_(NULL),
+                                                   session_mgr_(NULL),
+                                                   log_mgr_(NULL),
+                                                   sstable_mgr_(NULL),
+                                                   config_(NULL),
+                                                   cond_(),
+                                                   table_item_(NULL),
+                                                   session_descriptor_(0),
+                                                   meta_(),
+                                                   last_memtable_version_(0),
+                                                   last_trans_id_(0),
+                                                   load_memtable_(NULL),
+                                                   block_offsets_(),
+                                                   max_block_size_(0),
+                                                   next_block_(0),
+                                                   loaded_rows_(0),
+                                                   load_ret_(OB_SUCCESS),
+                                                   load_mutex_()
+    {
+      load_fname_[0] = '\0';
+    }
+
+    MemTableCheckpointer::~MemTableCheckpointer()
+    {
+    }
+
+    int MemTableCheckpointer::init(ObUpsTableMgr *table_mgr,
+                                   SessionMgr *session_mgr,
+                                   ObUpsLogMgr *log_mgr,
+                                   SSTableMgr *sstable_mgr,
+                                   const ObUpdateServerConfig *config)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL != table_mgr_)
+      {
+        TBSYS_LOG(WARN, "have inited");
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == table_mgr
+              || NULL == session_mgr
+              || NULL == log_mgr
+              || NULL == sstable_mgr
+              || NULL == config)
+      {
+        TBSYS_LOG(WARN, "invalid param table_mgr=%p session_mgr=%p log_mgr=%p sstable_mgr=%p config=%p",
+                  table_mgr, session_mgr, log_mgr, sstable_mgr, config);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        table_mgr_ = table_mgr;
+        session_mgr_ = session_mgr;
+        log_mgr_ = log_mgr;
+        sstable_mgr_ = sstable_mgr;
+        config_ = config;
+      }
+      return ret;
+    }
+
+    void MemTableCheckpointer::run(tbsys::CThread *thread, void *arg)
+    {
+      UNUSED(thread);
+      UNUSED(arg);
+      int64_t last_checkpoint_time = tbsys::CTimeUtil::getTime();
+      while (!_stop)
+      {
+        bool prepared = false;
+        cond_.lock();
+        if (NULL == table_item_)
+        {
+          cond_.wait(static_cast<int>(CHECK_PERIOD / 1000L));
+        }
+        prepared = (NULL != table_item_);
+        cond_.unlock();
+
+        int64_t interval = config_->memtable_checkpoint_interval;
+        if (prepared)
+        {
+          int tmp_ret = OB_SUCCESS;
+          if (OB_SUCCESS != (tmp_ret = write_()))
+          {
+            TBSYS_LOG(WARN, "write memtable checkpoint fail ret=%d", tmp_ret);
+          }
+          finish_();
+          last_checkpoint_time = tbsys::CTimeUtil::getTime();
+        }
+        else if (0 < interval
+                && last_checkpoint_time + interval <= tbsys::CTimeUtil::getTime())
+        {
+          int tmp_ret = OB_SUCCESS;
+          ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
+          if (NULL == ups_main)
+          {
+            TBSYS_LOG(WARN, "get ups main fail");
+          }
+          else if (OB_SUCCESS != (tmp_ret = ups_main->get_update_server().submit_checkpoint_memtable()))
+          {
+            TBSYS_LOG(WARN, "submit checkpoint memtable fail ret=%d", tmp_ret);
+          }
+          last_checkpoint_time = tbsys::CTimeUtil::getTime();
+        }
+      }
+      finish_();
+    }
+
+    int MemTableCheckpointer::prepare()
+    {
+      int ret = OB_SUCCESS;
+      TableMgr *table_mgr = NULL;
+      TableItem *table_item = NULL;
+      if (NULL == table_mgr_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL != table_item_)
+      {
+        TBSYS_LOG(INFO, "memtable checkpoint is in progress");
+        ret = OB_EAGAIN;
+      }
+      else if (NULL == (table_mgr = table_mgr_->get_table_mgr()))
+      {
+        TBSYS_LOG(WARN, "get table mgr fail");
+        ret = OB_ERROR;
+      }
+      else if (table_mgr->get_last_clog_id() != sstable_mgr_->get_max_clog_id())
+      {
+        // 重启时从最后一个sstable指示的日志文件开始回放 还没转储的frozen memtable不在checkpoint里
+        TBSYS_LOG(INFO, "frozen memtable not dumped, will not checkpoint, last_clog_id=%lu max_clog_id_by_sst=%lu",
+                  table_mgr->get_last_clog_id(), sstable_mgr_->get_max_clog_id());
+        ret = OB_EAGAIN;
+      }
+      else if (NULL == (table_item = table_mgr->get_active_memtable()))
+      {
+        TBSYS_LOG(WARN, "get active memtable fail");
+        ret = OB_ERROR;
+      }
+      else
+      {
+        MemTable &memtable = table_item->get_memtable();
+        BaseSessionCtx *session_ctx = NULL;
+        uint32_t session_descriptor = 0;
+        bool session_started = false;
+        uint64_t clog_id = 0;
+        if (0 == table_item->get_sstable_id()
+            || 0 == memtable.size())
+        {
+          TBSYS_LOG(INFO, "active memtable is empty, will not checkpoint %s", SSTableID::log_str(table_item->get_sstable_id()));
+          ret = OB_EAGAIN;
+        }
+        else if (last_memtable_version_ == table_item->get_sstable_id()
+                && last_trans_id_ == memtable.get_last_trans_id())
+        {
+          TBSYS_LOG(INFO, "active memtable not changed since last checkpoint, last_trans_id=%ld", last_trans_id_);
+          ret = OB_EAGAIN;
+        }
+        else if (OB_SUCCESS != (ret = table_mgr_->get_schema_mgr().get_schema_mgr(meta_.schema)))
+        {
+          TBSYS_LOG(WARN, "get schema fail ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = session_mgr_->begin_session(ST_READ_ONLY, tbsys::CTimeUtil::getTime(),
+                                                                  INT64_MAX, INT64_MAX, session_descriptor)))
+        {
+          TBSYS_LOG(WARN, "begin read only session fail ret=%d", ret);
+        }
+        else
+        {
+          session_started = true;
+          if (NULL == (session_ctx = session_mgr_->fetch_ctx(session_descriptor)))
+          {
+            TBSYS_LOG(WARN, "fetch session ctx fail sd=%u", session_descriptor);
+            ret = OB_ERROR;
+          }
+          else
+          {
+            // 此时没有进行中的写事务 只读session的事务号就是最后提交的事务号
+            meta_.trans_id = session_ctx->get_trans_id();
+            session_mgr_->revert_ctx(session_descriptor);
+            if (OB_SUCCESS != (ret = log_mgr_->switch_log_file(clog_id)))
+            {
+              TBSYS_LOG(WARN, "switch log file fail ret=%d", ret);
+            }
+          }
+        }
+
+        if (OB_SUCCESS == ret)
+        {
+          meta_.version = MemTableCheckpointMeta::CUR_VERSION;
+          meta_.memtable_version = table_item->get_sstable_id();
+          meta_.base_clog_id = table_mgr->get_last_clog_id();
+          meta_.clog_id = clog_id;
+          meta_.checksum = memtable.get_checksum();
+          meta_.uncommited_checksum = memtable.get_uncommited_checksum();
+          meta_.last_trans_id = memtable.get_last_trans_id();
+          meta_.row_counter = memtable.size();
+          cond_.lock();
+          table_item_ = table_item;
+          session_descriptor_ = session_descriptor;
+          cond_.signal();
+          cond_.unlock();
+          TBSYS_LOG(INFO, "prepare memtable checkpoint succ %s base_clog_id=%lu clog_id=%lu trans_id=%ld",
+                    SSTableID::log_str(meta_.memtable_version), meta_.base_clog_id, meta_.clog_id, meta_.trans_id);
+        }
+        else
+        {
+          if (session_started)
+          {
+            session_mgr_->end_session(session_descriptor);
+          }
+          table_mgr->revert_active_memtable(table_item);
+        }
+      }
+      return ret;
+    }
+
+    void MemTableCheckpointer::finish_()
+    {
+      cond_.lock();
+      TableItem *table_item = table_item_;
+      uint32_t session_descriptor = session_descriptor_;
+      table_item_ = NULL;
+      session_descriptor_ = 0;
+      cond_.unlock();
+      if (NULL != table_item)
+      {
+        session_mgr_->end_session(session_descriptor);
+        table_mgr_->get_table_mgr()->revert_active_memtable(table_item);
+      }
+    }
+
+    void MemTableCheckpointer::build_fname_(char *buf, const int64_t buf_len, const bool is_tmp) const
+    {
+      snprintf(buf, buf_len, "%s/%s%s", config_->commit_log_dir.str(), CHECKPOINT_FNAME, is_tmp ? ".tmp" : "");
+    }
+
+    int MemTableCheckpointer::write_()
+    {
+      int ret = OB_SUCCESS;
+      int64_t timeu = tbsys::CTimeUtil::getTime();
+      char fname_tmp[OB_MAX_FILE_NAME_LENGTH];
+      char fname[OB_MAX_FILE_NAME_LENGTH];
+      build_fname_(fname_tmp, sizeof(fname_tmp), true);
+      build_fname_(fname, sizeof(fname), false);
+      char *buffer = (char*)ob_malloc(BLOCK_SIZE, ObModIds::OB_UPS_COMMON);
+      BaseSessionCtx *session_ctx = session_mgr_->fetch_ctx(session_descriptor_);
+      ObFileAppender file;
+      bool dio = true;
+      bool is_create = true;
+      bool is_trunc = true;
+      int64_t pos = 0;
+      int64_t row_count = 0;
+      if (NULL == buffer)
+      {
+        TBSYS_LOG(WARN, "alloc checkpoint buffer fail size=%ld", BLOCK_SIZE);
+        ret = OB_MEM_OVERFLOW;
+      }
+      else if (NULL == session_ctx)
+      {
+        TBSYS_LOG(WARN, "fetch session ctx fail sd=%u", session_descriptor_);
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = file.open(ObString(static_cast<int32_t>(strlen(fname_tmp)),
+                                                       static_cast<int32_t>(strlen(fname_tmp)),
+                                                       fname_tmp),
+                                              dio, is_create, is_trunc)))
+      {
+        TBSYS_LOG(WARN, "open file [%s] for memtable checkpoint fail ret=%d", fname_tmp, ret);
+      }
+      else
+      {
+        if (OB_SUCCESS != (ret = meta_.serialize(buffer, BLOCK_SIZE, pos)))
+        {
+          TBSYS_LOG(WARN, "serialize checkpoint meta fail ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = append_record_(file, META_MAGIC, buffer, pos)))
+        {
+          TBSYS_LOG(WARN, "append checkpoint meta fail ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = write_rows_(file, table_item_->get_memtable(), *session_ctx, buffer, row_count)))
+        {
+          TBSYS_LOG(WARN, "write checkpoint rows fail ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = file.fsync()))
+        {
+          TBSYS_LOG(WARN, "fsync checkpoint file fail ret=%d", ret);
+        }
+        else if (session_ctx->is_killed())
+        {
+          // session被强制结束后 后台合并可能已经越过了checkpoint的事务号
+          TBSYS_LOG(WARN, "checkpoint session killed, discard checkpoint sd=%u", session_descriptor_);
+          ret = OB_CANCELED;
+        }
+        file.close();
+      }
+
+      if (OB_SUCCESS != ret)
+      {
+        unlink(fname_tmp);
+      }
+      else if (0 != rename(fname_tmp, fname))
+      {
+        TBSYS_LOG(WARN, "rename [%s] to [%s] fail errno=%u", fname_tmp, fname, errno);
+        ret = OB_IO_ERROR;
+      }
+      else
+      {
+        last_memtable_version_ = meta_.memtable_version;
+        last_trans_id_ = meta_.last_trans_id;
+        TBSYS_LOG(INFO, "write memtable checkpoint [%s] succ %s clog_id=%lu trans_id=%ld rows=%ld bytes=%ld timeu=%ld",
+                  fname, SSTableID::log_str(meta_.memtable_version), meta_.clog_id, meta_.trans_id,
+                  row_count, get_file_size(fname), tbsys::CTimeUtil::getTime() - timeu);
+      }
+
+      if (NULL != session_ctx)
+      {
+        session_mgr_->revert_ctx(session_descriptor_);
+      }
+      if (NULL != buffer)
+      {
+        ob_free(buffer);
+        buffer = NULL;
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointer::write_rows_(ObIFileAppender &file, MemTable &memtable, const BaseSessionCtx &session_ctx,
+                                          char *buf, int64_t &row_count)
+    {
+      int ret = OB_SUCCESS;
+      TableEngineIterator iter;
+      // 每个数据块以行数开头 写出时回填
+      int64_t pos = serialization::encoded_length_i64(0);
+      int64_t block_rows = 0;
+      row_count = 0;
+      if (OB_SUCCESS != (ret = memtable.scan_all(iter)))
+      {
+        TBSYS_LOG(WARN, "scan all fail ret=%d", ret);
+      }
+      while (OB_SUCCESS == ret
+            && OB_SUCCESS == (ret = iter.next()))
+      {
+        const TEKey &te_key = iter.get_key();
+        const TEValue *te_value = iter.get_value();
+        if (NULL == te_value)
+        {
+          continue;
+        }
+        bool large_row = false;
+        ret = memtable.checkpoint_row(session_ctx, te_key, *te_value, buf, BLOCK_SIZE, pos);
+        if (OB_SIZE_OVERFLOW == ret
+            && 0 < block_rows)
+        {
+          if (OB_SUCCESS == (ret = flush_block_(file, buf, pos, block_rows)))
+          {
+            ret = memtable.checkpoint_row(session_ctx, te_key, *te_value, buf, BLOCK_SIZE, pos);
+          }
+        }
+        if (OB_SIZE_OVERFLOW == ret)
+        {
+          // 空数据块也放不下这一行
+          large_row = true;
+          ret = write_large_row_(file, memtable, session_ctx, te_key, *te_value);
+        }
+        if (OB_SUCCESS == ret)
+        {
+          block_rows += large_row ? 0 : 1;
+          row_count++;
+        }
+        else if (OB_ENTRY_NOT_EXIST == ret)
+        {
+          // checkpoint事务号上行还不存在
+          ret = OB_SUCCESS;
+        }
+        else
+        {
+          TBSYS_LOG(WARN, "checkpoint row fail ret=%d %s %s", ret, te_key.log_str(), te_value->log_str());
+        }
+        if (OB_SUCCESS == ret
+            && _stop)
+        {
+          TBSYS_LOG(INFO, "checkpointer stopped, cancel checkpoint");
+          ret = OB_CANCELED;
+        }
+      }
+      if (OB_ITER_END == ret)
+      {
+        ret = OB_SUCCESS;
+        if (0 < block_rows)
+        {
+          ret = flush_block_(file, buf, pos, block_rows);
+        }
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointer::write_large_row_(ObIFileAppender &file, MemTable &memtable, const BaseSessionCtx &session_ctx,
+                                               const TEKey &te_key, const TEValue &te_value)
+    {
+      int ret = OB_SIZE_OVERFLOW;
+      int64_t block_rows = 1;
+      for (int64_t buf_size = 2 * BLOCK_SIZE; OB_SIZE_OVERFLOW == ret && buf_size <= MAX_ROW_BLOCK_SIZE; buf_size *= 2)
+      {
+        char *buf = (char*)ob_malloc(buf_size, ObModIds::OB_UPS_COMMON);
+        int64_t pos = serialization::encoded_length_i64(0);
+        int64_t header_pos = 0;
+        if (NULL == buf)
+        {
+          TBSYS_LOG(WARN, "alloc large row buffer fail size=%ld", buf_size);
+          ret = OB_MEM_OVERFLOW;
+        }
+        else if (OB_SUCCESS != (ret = memtable.checkpoint_row(session_ctx, te_key, te_value, buf, buf_size, pos)))
+        {
+          if (OB_SIZE_OVERFLOW != ret)
+          {
+            TBSYS_LOG(WARN, "checkpoint large row fail ret=%d %s", ret, te_key.log_str());
+          }
+        }
+        else if (OB_SUCCESS != (ret = serialization::encode_i64(buf, buf_size, header_pos, block_rows)))
+        {
+          TBSYS_LOG(WARN, "encode block row count fail ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = append_record_(file, BLOCK_MAGIC, buf, pos)))
+        {
+          TBSYS_LOG(WARN, "append large row block fail ret=%d size=%ld", ret, pos);
+        }
+        else
+        {
+          TBSYS_LOG(INFO, "write large row block size=%ld %s", pos, te_key.log_str());
+        }
+        if (NULL != buf)
+        {
+          ob_free(buf);
+          buf = NULL;
+        }
+      }
+      if (OB_SIZE_OVERFLOW == ret)
+      {
+        TBSYS_LOG(WARN, "row too large to checkpoint max_size=%ld %s", MAX_ROW_BLOCK_SIZE, te_key.log_str());
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointer::flush_block_(ObIFileAppender &file, char *buf, int64_t &pos, int64_t &block_rows)
+    {
+      int ret = OB_SUCCESS;
+      int64_t header_pos = 0;
+      if (OB_SUCCESS != (ret = serialization::encode_i64(buf, BLOCK_SIZE, header_pos, block_rows)))
+      {
+        TBSYS_LOG(WARN, "encode block row count fail ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = append_record_(file, BLOCK_MAGIC, buf, pos)))
+      {
+        TBSYS_LOG(WARN, "append checkpoint block fail ret=%d size=%ld rows=%ld", ret, pos, block_rows);
+      }
+      else
+      {
+        pos = header_pos;
+        block_rows = 0;
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointer::append_record_(ObIFileAppender &file, const int16_t magic,
+                                             const char *payload, const int64_t payload_len)
+    {
+      int ret = OB_SUCCESS;
+      char header_buf[OB_RECORD_HEADER_LENGTH];
+      int64_t header_pos = 0;
+      ObRecordHeader header;
+      header.set_magic_num(magic);
+      header.header_length_ = OB_RECORD_HEADER_LENGTH;
+      header.version_ = 0;
+      header.reserved_ = 0;
+      header.data_length_ = static_cast<int32_t>(payload_len);
+      header.data_zlength_ = static_cast<int32_t>(payload_len);
+      header.data_checksum_ = ob_crc64(payload, payload_len);
+      header.set_header_checksum();
+      if (OB_SUCCESS != (ret = header.serialize(header_buf, sizeof(header_buf), header_pos)))
+      {
+        TBSYS_LOG(WARN, "serialize record header fail ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = file.append(header_buf, header_pos, false)))
+      {
+        TBSYS_LOG(WARN, "append record header fail ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = file.append(payload, payload_len, false)))
+      {
+        TBSYS_LOG(WARN, "append record payload fail ret=%d size=%ld", ret, payload_len);
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointer::read_record_(ObFileReader &reader, const int64_t offset, const int16_t magic,
+                                           char *buf, const int64_t buf_len,
+                                           const char *&payload, int64_t &payload_len) const
+    {
+      int ret = OB_SUCCESS;
+      ObRecordHeader header;
+      int64_t read_size = 0;
+      if (OB_SUCCESS != (ret = reader.pread(buf, OB_RECORD_HEADER_LENGTH, offset, read_size))
+          || OB_RECORD_HEADER_LENGTH != read_size)
+      {
+        TBSYS_LOG(WARN, "read record header fail ret=%d offset=%ld read_size=%ld", ret, offset, read_size);
+        ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+      }
+      else if (OB_SUCCESS != (ret = ObRecordHeader::get_record_header(buf, read_size, header, payload, payload_len)))
+      {
+        TBSYS_LOG(WARN, "get record header fail ret=%d offset=%ld", ret, offset);
+      }
+      else if (OB_RECORD_HEADER_LENGTH + header.data_zlength_ > buf_len)
+      {
+        TBSYS_LOG(WARN, "record too large offset=%ld data_zlength=%d buf_len=%ld", offset, header.data_zlength_, buf_len);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else if (OB_SUCCESS != (ret = reader.pread(buf, OB_RECORD_HEADER_LENGTH + header.data_zlength_, offset, read_size))
+              || OB_RECORD_HEADER_LENGTH + header.data_zlength_ != read_size)
+      {
+        TBSYS_LOG(WARN, "read record fail ret=%d offset=%ld read_size=%ld", ret, offset, read_size);
+        ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+      }
+      else if (OB_SUCCESS != (ret = ObRecordHeader::check_record(buf, read_size, magic, header, payload, payload_len)))
+      {
+        TBSYS_LOG(WARN, "check record fail ret=%d offset=%ld magic=%hd", ret, offset, magic);
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointer::read_meta_(const char *fname, char *buf, int64_t &meta_len)
+    {
+      int ret = OB_SUCCESS;
+      ObFileReader reader;
+      const char *payload = NULL;
+      int64_t payload_len = 0;
+      int64_t pos = 0;
+      if (OB_SUCCESS != (ret = reader.open(ObString(static_cast<int32_t>(strlen(fname)),
+                                                    static_cast<int32_t>(strlen(fname)),
+                                                    fname), false)))
+      {
+        TBSYS_LOG(WARN, "open checkpoint file [%s] fail ret=%d", fname, ret);
+      }
+      else
+      {
+        if (OB_SUCCESS != (ret = read_record_(reader, 0, META_MAGIC, buf, BLOCK_SIZE, payload, payload_len)))
+        {
+          TBSYS_LOG(WARN, "read checkpoint meta fail ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = meta_.deserialize(payload, payload_len, pos)))
+        {
+          TBSYS_LOG(WARN, "deserialize checkpoint meta fail ret=%d", ret);
+        }
+        else
+        {
+          meta_len = OB_RECORD_HEADER_LENGTH + payload_len;
+        }
+        reader.close();
+      }
+      return ret;
+    }
+
+    int MemTableCheckpointer::scan_blocks_(const char *fname, const int64_t meta_len)
+    {
+      int ret = OB_SUCCESS;
+      ObFileReader reader;
+      int64_t file_size = get_file_size(fname);
+      int64_t offset = meta_len;
+      block_offsets_.clear();
+      max_block_size_ = BLOCK_SIZE;
+      if (OB_SUCCESS != (ret = reader.open(ObString(static_cast<int32_t>(strlen(fname)),
+                                                    static_cast<int32_t>(strlen(fname)),
+                                                    fname), false)))
+      {
+        TBSYS_LOG(WARN, "open checkpoint file [%s] fail ret=%d", fname, ret);
+      }
+      else
+      {
+        // 只读出记录头 数据块由加载线程各自读取和校验
+        char header_buf[OB_RECORD_HEADER_LENGTH];
+        while (OB_SUCCESS == ret
+              && offset < file_size)
+        {
+          ObRecordHeader header;
+          const char *payload = NULL;
+          int64_t payload_len = 0;
+          int64_t read_size = 0;
+          if (OB_SUCCESS != (ret = reader.pread(header_buf, sizeof(header_buf), offset, read_size))
+              || OB_RECORD_HEADER_LENGTH != read_size)
+          {
+            TBSYS_LOG(WARN, "read block header fail ret=%d offset=%ld read_size=%ld", ret, offset, read_size);
+            ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+          }
+          else if (OB_SUCCESS != (ret = ObRecordHeader::get_record_header(header_buf, read_size, header, payload, payload_len))
+                  || OB_SUCCESS != (ret = header.check_magic_num(BLOCK_MAGIC))
+                  || OB_SUCCESS != (ret = header.check_header_checksum()))
+          {
+            TBSYS_LOG(WARN, "invalid block header ret=%d offset=%ld", ret, offset);
+          }
+          else if (OB_SUCCESS != (ret = block_offsets_.push_back(offset)))
+          {
+            TBSYS_LOG(WARN, "push block offset fail ret=%d", ret);
+          }
+          else
+          {
+            offset += OB_RECORD_HEADER_LENGTH + header.data_zlength_;
+            max_block_size_ = std::max(max_block_size_, static_cast<int64_t>(header.data_zlength_));
+          }
+        }
+        if (OB_SUCCESS == ret
+            && offset != file_size)
+        {
+          TBSYS_LOG(WARN, "checkpoint file truncated offset=%ld file_size=%ld", offset, file_size);
+          ret = OB_ERROR;
+        }
+        reader.close();
+      }
+      return ret;
+    }
+
+    void MemTableCheckpointer::load_worker_()
+    {
+      int ret = OB_SUCCESS;
+      ObFileReader reader;
+      // 缓冲区按最大的数据块分配 单行数据块可能大于BLOCK_SIZE
+      const int64_t buf_len = OB_RECORD_HEADER_LENGTH + max_block_size_;
+      char *buffer = (char*)ob_malloc(buf_len, ObModIds::OB_UPS_COMMON);
+      if (NULL == buffer)
+      {
+        TBSYS_LOG(WARN, "alloc load buffer fail size=%ld", buf_len);
+        ret = OB_MEM_OVERFLOW;
+      }
+      else if (OB_SUCCESS != (ret = reader.open(ObString(static_cast<int32_t>(strlen(load_fname_)),
+                                                         static_cast<int32_t>(strlen(load_fname_)),
+                                                         load_fname_), false)))
+      {
+        TBSYS_LOG(WARN, "open checkpoint file [%s] fail ret=%d", load_fname_, ret);
+      }
+      while (OB_SUCCESS == ret)
+      {
+        int64_t block_idx = -1;
+        load_mutex_.lock();
+        if (OB_SUCCESS == load_ret_
+            && next_block_ < block_offsets_.count())
+        {
+          block_idx = next_block_++;
+        }
+        load_mutex_.unlock();
+        if (0 > block_idx)
+        {
+          break;
+        }
+
+        const char *payload = NULL;
+        int64_t payload_len = 0;
+        int64_t pos = 0;
+        int64_t block_rows = 0;
+        if (OB_SUCCESS != (ret = read_record_(reader, block_offsets_.at(block_idx), BLOCK_MAGIC,
+                                              buffer, buf_len, payload, payload_len)))
+        {
+          TBSYS_LOG(WARN, "read checkpoint block fail ret=%d block_idx=%ld", ret, block_idx);
+        }
+        else if (OB_SUCCESS != (ret = serialization::decode_i64(payload, payload_len, pos, &block_rows)))
+        {
+          TBSYS_LOG(WARN, "decode block row count fail ret=%d block_idx=%ld", ret, block_idx);
+        }
+        for (int64_t i = 0; OB_SUCCESS == ret && i < block_rows; i++)
+        {
+          if (OB_SUCCESS != (ret = load_memtable_->load_checkpoint_row(payload, payload_len, pos)))
+          {
+            TBSYS_LOG(WARN, "load checkpoint row fail ret=%d block_idx=%ld row=%ld", ret, block_idx, i);
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          load_mutex_.lock();
+          loaded_rows_ += block_rows;
+          load_mutex_.unlock();
+        }
+      }
+      if (OB_SUCCESS != ret)
+      {
+        load_mutex_.lock();
+        load_ret_ = (OB_SUCCESS == load_ret_) ? ret : load_ret_;
+        load_mutex_.unlock();
+      }
+      reader.close();
+      if (NULL != buffer)
+      {
+        ob_free(buffer);
+        buffer = NULL;
+      }
+    }
+
+    int MemTableCheckpointer::load_blocks_(MemTable &memtable, const int64_t thread_num)
+    {
+      int ret = OB_SUCCESS;
+      LoadWorker worker(*this);
+      // 每个加载线程持有一个最大数据块大小的缓冲区 线程数不超过CPU数
+      int64_t worker_num = std::min(std::min(thread_num, MAX_LOAD_THREAD_NUM),
+                                    std::min(get_cpu_num(), block_offsets_.count()));
+      int64_t started = 0;
+      load_memtable_ = &memtable;
+      next_block_ = 0;
+      loaded_rows_ = 0;
+      load_ret_ = OB_SUCCESS;
+      if (1 < worker_num)
+      {
+        worker.setThreadCount(static_cast<int>(worker_num));
+        started = worker.start();
+        if (started < worker_num)
+        {
+          TBSYS_LOG(WARN, "start load threads fail started=%ld worker_num=%ld", started, worker_num);
+        }
+      }
+      // 只有一个数据块或线程启动失败时在当前线程里加载
+      if (0 == started)
+      {
+        load_worker_();
+      }
+      else
+      {
+        worker.wait();
+      }
+      if (OB_SUCCESS != (ret = load_ret_))
+      {
+        TBSYS_LOG(WARN, "load checkpoint blocks fail ret=%d", ret);
+      }
+      load_memtable_ = NULL;
+      return ret;
+    }
+
+    int MemTableCheckpointer::load(const int64_t replay_file_id, int64_t &checkpoint_file_id, int64_t &row_count)
+    {
+      int ret = OB_SUCCESS;
+      int64_t meta_len = 0;
+      char *buffer = NULL;
+      TableMgr *table_mgr = NULL;
+      TableItem *table_item = NULL;
+      build_fname_(load_fname_, sizeof(load_fname_), false);
+      if (NULL == table_mgr_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (0 != access(load_fname_, F_OK))
+      {
+        TBSYS_LOG(INFO, "memtable checkpoint [%s] not exist", load_fname_);
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (NULL == (buffer = (char*)ob_malloc(BLOCK_SIZE, ObModIds::OB_UPS_COMMON)))
+      {
+        TBSYS_LOG(WARN, "alloc checkpoint buffer fail size=%ld", BLOCK_SIZE);
+        ret = OB_MEM_OVERFLOW;
+      }
+      else if (OB_SUCCESS != read_meta_(load_fname_, buffer, meta_len)
+              || OB_SUCCESS != scan_blocks_(load_fname_, meta_len))
+      {
+        // checkpoint损坏时回放全部日志 结果是一样的
+        TBSYS_LOG(WARN, "memtable checkpoint [%s] is corrupted, ignore it", load_fname_);
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (meta_.base_clog_id != static_cast<uint64_t>(replay_file_id)
+              || meta_.clog_id <= meta_.base_clog_id)
+      {
+        TBSYS_LOG(INFO, "memtable checkpoint [%s] not match replay point, ignore it, "
+                  "base_clog_id=%lu clog_id=%lu replay_file_id=%ld",
+                  load_fname_, meta_.base_clog_id, meta_.clog_id, replay_file_id);
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      // 此后失败时memtable已被部分修改 只能由用户删除checkpoint后重启
+      else if (OB_SUCCESS != (ret = table_mgr_->replay_checkpoint_freeze(meta_.memtable_version, meta_.base_clog_id, meta_.schema)))
+      {
+        TBSYS_LOG(ERROR, "replay checkpoint freeze fail ret=%d", ret);
+      }
+      else if (NULL == (table_mgr = table_mgr_->get_table_mgr())
+              || NULL == (table_item = table_mgr->get_active_memtable()))
+      {
+        TBSYS_LOG(ERROR, "get active memtable fail");
+        ret = OB_ERROR;
+      }
+      else
+      {
+        MemTable &memtable = table_item->get_memtable();
+        if (OB_SUCCESS != (ret = load_blocks_(memtable, config_->memtable_checkpoint_load_thread_num)))
+        {
+          TBSYS_LOG(ERROR, "load checkpoint rows fail ret=%d", ret);
+        }
+        else
+        {
+          memtable.update_checksum(meta_.checksum);
+          memtable.update_uncommited_checksum(meta_.uncommited_checksum);
+          memtable.update_last_trans_id(meta_.last_trans_id);
+          memtable.add_row_counter(meta_.row_counter);
+          session_mgr_->update_commited_trans_id(meta_.trans_id);
+          last_memtable_version_ = meta_.memtable_version;
+          last_trans_id_ = meta_.last_trans_id;
+          checkpoint_file_id = static_cast<int64_t>(meta_.clog_id);
+          row_count = loaded_rows_;
+          TBSYS_LOG(INFO, "load memtable checkpoint [%s] succ %s clog_id=%lu trans_id=%ld blocks=%ld rows=%ld",
+                    load_fname_, SSTableID::log_str(meta_.memtable_version), meta_.clog_id, meta_.trans_id,
+                    block_offsets_.count(), loaded_rows_);
+        }
+        table_mgr->revert_active_memtable(table_item);
+      }
+      if (OB_SUCCESS != ret
+          && OB_ENTRY_NOT_EXIST != ret)
+      {
+        TBSYS_LOG(ERROR, "load memtable checkpoint [%s] fail ret=%d, remove it and restart to replay all commit log",
+                  load_fname_, ret);
+      }
+      block_offsets_.clear();
+      if (NULL != buffer)
+      {
+        ob_free(buffer);
+        buffer = NULL;
+      }
+      return ret;
+    }
+  }
+}
@@ -0,0 +1,147 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_memtable_checkpoint.h
+ *
+ * 把活跃memtable写成checkpoint文件, 重启时加载checkpoint后只需回放checkpoint之后的日志
+ */
+#ifndef OCEANBASE_UPDATESERVER_MEMTABLE_CHECKPOINT_H_
+#define OCEANBASE_UPDATESERVER_MEMTABLE_CHECKPOINT_H_
+
+#include "tbsys.h"
+#include "common/ob_define.h"
+#include "common/ob_file.h"
+#include "common/ob_array.h"
+#include "ob_schema_mgrv2.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    class ObUpsTableMgr;
+    class SessionMgr;
+    class ObUpsLogMgr;
+    class SSTableMgr;
+    class TableItem;
+    class BaseSessionCtx;
+    class MemTable;
+    class ObUpdateServerConfig;
+    struct TEKey;
+    struct TEValue;
+
+    struct MemTableCheckpointMeta
+    {
+      static const int64_t CUR_VERSION = 1;
+      int64_t version;
+      uint64_t memtable_version;      // 活跃memtable的版本号
+      uint64_t base_clog_id;          // 活跃memtable开始的日志文件 即最近一次freeze切换出的文件
+      uint64_t clog_id;               // checkpoint时切换出的日志文件 重启时从这个文件开始回放
+      int64_t trans_id;               // checkpoint包含所有事务号不大于trans_id的已提交事务
+      uint64_t checksum;
+      uint64_t uncommited_checksum;
+      int64_t last_trans_id;
+      int64_t row_counter;
+      CommonSchemaManagerWrapper schema;
+
+      MemTableCheckpointMeta();
+      void reset();
+      int serialize(char *buf, const int64_t buf_len, int64_t &pos) const;
+      int deserialize(const char *buf, const int64_t data_len, int64_t &pos);
+    };
+
+    // checkpoint文件由一个meta记录和若干行数据块记录组成 每个记录以ObRecordHeader开头
+    // 写checkpoint分两步:
+    //   1. prepare()在写线程中原地执行 此时没有进行中的写事务 切换日志文件并开启一个只读session
+    //   2. 后台线程用这个只读session遍历活跃memtable 输出到临时文件后改名
+    // 只读session会阻止后台合并越过checkpoint的事务号 因此遍历过程中读到的数据是一致的
+    class MemTableCheckpointer : public tbsys::CDefaultRunnable
+    {
+      static const int64_t CHECK_PERIOD = 100L * 1000L;
+      // 数据块的大小 超过一个数据块的行单独写成一个更大的数据块
+      static const int64_t BLOCK_SIZE = 4L * 1024L * 1024L;
+      // 单行数据块的上限 受记录头中32位长度的限制
+      static const int64_t MAX_ROW_BLOCK_SIZE = 1024L * 1024L * 1024L;
+      static const int16_t META_MAGIC = static_cast<int16_t>(0x4D43);
+      static const int16_t BLOCK_MAGIC = static_cast<int16_t>(0x4D42);
+      static const int64_t MAX_LOAD_THREAD_NUM = 8;
+      // 加载线程 在重启回放日志之前短暂运行
+      class LoadWorker : public tbsys::CDefaultRunnable
+      {
+        public:
+          explicit LoadWorker(MemTableCheckpointer &host) : host_(host) {};
+          virtual ~LoadWorker() {};
+          virtual void run(tbsys::CThread *thread, void *arg)
+          {
+            UNUSED(thread);
+            UNUSED(arg);
+            host_.load_worker_();
+          };
+        private:
+          MemTableCheckpointer &host_;
+      };
+      public:
+        static const char *CHECKPOINT_FNAME;
+      public:
+        MemTableCheckpointer();
+        virtual ~MemTableCheckpointer();
+      public:
+        int init(ObUpsTableMgr *table_mgr,
+                SessionMgr *session_mgr,
+                ObUpsLogMgr *log_mgr,
+                SSTableMgr *sstable_mgr,
+                const ObUpdateServerConfig *config);
+        virtual void run(tbsys::CThread *thread, void *arg);
+        // 在写线程中调用 返回OB_EAGAIN表示这次不需要或不能做checkpoint
+        int prepare();
+        // 重启回放日志之前调用 replay_file_id是sstable指示的回放起点
+        // @return OB_ENTRY_NOT_EXIST表示没有可用的checkpoint 成功时checkpoint_file_id是新的回放起点
+        int load(const int64_t replay_file_id, int64_t &checkpoint_file_id, int64_t &row_count);
+      private:
+        int write_();
+        int write_rows_(common::ObIFileAppender &file, MemTable &memtable, const BaseSessionCtx &session_ctx,
+                        char *buf, int64_t &row_count);
+        int write_large_row_(common::ObIFileAppender &file, MemTable &memtable, const BaseSessionCtx &session_ctx,
+                            const TEKey &te_key, const TEValue &te_value);
+        int flush_block_(common::ObIFileAppender &file, char *buf, int64_t &pos, int64_t &block_rows);
+        int append_record_(common::ObIFileAppender &file, const int16_t magic, const char *payload, const int64_t payload_len);
+        int read_record_(common::ObFileReader &reader, const int64_t offset, const int16_t magic,
+                        char *buf, const int64_t buf_len, const char *&payload, int64_t &payload_len) const;
+        int read_meta_(const char *fname, char *buf, int64_t &meta_len);
+        int scan_blocks_(const char *fname, const int64_t meta_len);
+        int load_blocks_(MemTable &memtable, const int64_t thread_num);
+        void load_worker_();
+        void finish_();
+        void build_fname_(char *buf, const int64_t buf_len, const bool is_tmp) const;
+      private:
+        ObUpsTableMgr *table_mgr_;
+        SessionMgr *session_mgr_;
+        ObUpsLogMgr *log_mgr_;
+        SSTableMgr *sstable_mgr_;
+        const ObUpdateServerConfig *config_;
+        tbsys::CThreadCond cond_;
+        // prepare()成功后由后台线程写出 写完后清空
+        TableItem *table_item_;
+        uint32_t session_descriptor_;
+        MemTableCheckpointMeta meta_;
+        uint64_t last_memtable_version_;
+        int64_t last_trans_id_;
+        // 加载时多个线程共享的状态
+        char load_fname_[common::OB_MAX_FILE_NAME_LENGTH];
+        MemTable *load_memtable_;
+        common::ObArray<int64_t> block_offsets_;
+        int64_t max_block_size_;
+        int64_t next_block_;
+        int64_t loaded_rows_;
+        int load_ret_;
+        tbsys::CThreadMutex load_mutex_;
+    };
+  }
+}
+
+#endif //OCEANBASE_UPDATESERVER_MEMTABLE_CHECKPOINT_H_
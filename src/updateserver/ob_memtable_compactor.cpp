@@ -0,0 +1,138 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_memtable_compactor.cpp
+ *
+ */
+#include "ob_memtable_compactor.h"
+#include "ob_table_mgr.h"
+#include "ob_session_mgr.h"
+#include "ob_update_server_config.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    using namespace common;
+
+    MemTableCompactor::MemTableCompactor() : table_mgr_(NULL),
+                                             session_mgr_(NULL),
+                                             lock_mgr_(NULL),
+                                             config_(NULL),
+                                             stats_()
+    {
+    }
+
+    MemTableCompactor::~MemTableCompactor()
+    {
+    }
+
+    int MemTableCompactor::init(TableMgr *table_mgr, SessionMgr *session_mgr, LockMgr *lock_mgr,
+                                const ObUpdateServerConfig *config)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL != table_mgr_)
+      {
+        TBSYS_LOG(WARN, "have inited");
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == table_mgr
+              || NULL == session_mgr
+              || NULL == lock_mgr
+              || NULL == config)
+      {
+        TBSYS_LOG(WARN, "invalid param table_mgr=%p session_mgr=%p lock_mgr=%p config=%p",
+                  table_mgr, session_mgr, lock_mgr, config);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        table_mgr_ = table_mgr;
+        session_mgr_ = session_mgr;
+        lock_mgr_ = lock_mgr;
+        config_ = config;
+      }
+      return ret;
+    }
+
+    void MemTableCompactor::run(tbsys::CThread *thread, void *arg)
+    {
+      UNUSED(thread);
+      UNUSED(arg);
+      int64_t last_compact_time = tbsys::CTimeUtil::getTime();
+      while (!_stop)
+      {
+        int64_t interval = config_->memtable_compact_interval;
+        if (0 < interval
+            && last_compact_time + interval <= tbsys::CTimeUtil::getTime())
+        {
+          int tmp_ret = OB_SUCCESS;
+          if (OB_SUCCESS != (tmp_ret = compact_once()))
+          {
+            TBSYS_LOG(WARN, "compact memtable fail ret=%d", tmp_ret);
+          }
+          last_compact_time = tbsys::CTimeUtil::getTime();
+        }
+        usleep(CHECK_PERIOD);
+      }
+    }
+
+    int MemTableCompactor::compact_once()
+    {
+      int ret = OB_SUCCESS;
+      TableItem *table_item = NULL;
+      int64_t min_chain_length = config_->memtable_compact_chain_length;
+      int64_t timeu = tbsys::CTimeUtil::getTime();
+      if (NULL == table_mgr_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == (table_item = table_mgr_->get_active_memtable()))
+      {
+        TBSYS_LOG(WARN, "get active memtable fail");
+        ret = OB_ERROR;
+      }
+      else
+      {
+        if (OB_SUCCESS != (ret = table_item->get_memtable().compact_rows(*session_mgr_, lock_mgr_, min_chain_length, stats_)))
+        {
+          TBSYS_LOG(WARN, "compact rows fail ret=%d", ret);
+        }
+        else
+        {
+          report_(stats_, min_chain_length, tbsys::CTimeUtil::getTime() - timeu);
+        }
+        table_mgr_->revert_active_memtable(table_item);
+      }
+      return ret;
+    }
+
+    void MemTableCompactor::report_(const MemTableChainStats &stats, const int64_t min_chain_length, const int64_t timeu) const
+    {
+      int64_t row_count = 0;
+      int64_t compacted_row_count = 0;
+      char buffer[STAT_BUFFER_SIZE];
+      for (int64_t i = 0; i < stats.count(); i++)
+      {
+        const MemTableChainStat &stat = stats.at(i);
+        row_count += stat.row_count;
+        compacted_row_count += stat.compacted_row_count;
+        // 只输出有长版本链的表
+        if (min_chain_length <= stat.max_chain_length)
+        {
+          stat.to_string(buffer, sizeof(buffer));
+          TBSYS_LOG(INFO, "memtable chain stat: %s", buffer);
+        }
+      }
+      TBSYS_LOG(INFO, "compact memtable done, tables=%ld rows=%ld compacted=%ld min_chain_length=%ld timeu=%ld",
+                stats.count(), row_count, compacted_row_count, min_chain_length, timeu);
+    }
+  }
+}
@@ -0,0 +1,53 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_memtable_compactor.h
+ *
+ * 后台合并活跃memtable中过长的版本链, 并按表输出版本链长度直方图
+ */
+#ifndef OCEANBASE_UPDATESERVER_MEMTABLE_COMPACTOR_H_
+#define OCEANBASE_UPDATESERVER_MEMTABLE_COMPACTOR_H_
+
+#include "tbsys.h"
+#include "ob_memtable.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    class TableMgr;
+    class SessionMgr;
+    class LockMgr;
+    class ObUpdateServerConfig;
+    class MemTableCompactor : public tbsys::CDefaultRunnable
+    {
+      static const int64_t CHECK_PERIOD = 100L * 1000L;
+      static const int64_t STAT_BUFFER_SIZE = 512;
+      public:
+        MemTableCompactor();
+        virtual ~MemTableCompactor();
+      public:
+        int init(TableMgr *table_mgr, SessionMgr *session_mgr, LockMgr *lock_mgr,
+                 const ObUpdateServerConfig *config);
+        virtual void run(tbsys::CThread *thread, void *arg);
+        // 合并一遍当前的活跃memtable
+        int compact_once();
+      private:
+        void report_(const MemTableChainStats &stats, const int64_t min_chain_length, const int64_t timeu) const;
+      private:
+        TableMgr *table_mgr_;
+        SessionMgr *session_mgr_;
+        LockMgr *lock_mgr_;
+        const ObUpdateServerConfig *config_;
+        MemTableChainStats stats_;
+    };
+  }
+}
+
+#endif //OCEANBASE_UPDATESERVER_MEMTABLE_COMPACTOR_H_
@@ -20,6 +20,363 @@ namespace oceanbase
 {
   namespace updateserver
   {
+    static bool is_old_value_column(const uint64_t column_id)
+    {
+      return OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET < column_id
+        && OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET + OB_MAX_VALID_COLUMN_ID >= column_id;
+    }
+
+    IndexModifyRows::IndexModifyRows() : rk_size_(0),
+                                         index_num_(0),
+                                         is_delete_(false),
+                                         has_old_value_(false),
+                                         data_count_(0)
+    {
+      for (int64_t i = 0; i < OB_MAX_INDEX_TABLE_NUMBER; i++)
+      {
+        index_[i].rk_size_ = 0;
+        index_[i].del_count_ = 0;
+        index_[i].put_count_ = 0;
+      }
+    }
+
+    IndexModifyRows::~IndexModifyRows()
+    {
+      data_rows_.close();
+      for (int64_t i = 0; i < index_num_; i++)
+      {
+        index_[i].del_rows_.close();
+        index_[i].put_rows_.close();
+      }
+    }
+
+    int IndexModifyRows::init(const CommonSchemaManager &sm, const ObRowDesc &row_desc, const int64_t rk_size,
+                              const ObTableSchema **index_tables, const int64_t index_num)
+    {
+      int ret = OB_SUCCESS;
+      ObRowDesc data_desc;
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
+      rk_size_ = rk_size;
+      index_num_ = index_num;
+      data_desc.set_rowkey_cell_count(rk_size);
+      for (int64_t i = 0; OB_SUCCESS == ret && i < row_desc.get_column_num(); i++)
+      {
+        if (OB_SUCCESS != (ret = row_desc.get_tid_cid(i, table_id, column_id)))
+        {
+          TBSYS_LOG(WARN, "get_tid_cid fail idx=%ld ret=%d", i, ret);
+        }
+        else if (OB_ACTION_FLAG_COLUMN_ID == column_id)
+        {
+          is_delete_ = true;
+        }
+        else if (is_old_value_column(column_id))
+        {
+          has_old_value_ = true;
+          continue;
+        }
+        if (OB_SUCCESS != ret)
+        {
+        }
+        else if (OB_SUCCESS != (ret = data_pos_.push_back(i)))
+        {
+          TBSYS_LOG(WARN, "push data pos fail ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = data_desc.add_column_desc(table_id, column_id)))
+        {
+          TBSYS_LOG(WARN, "add column desc fail tid=%lu cid=%lu ret=%d", table_id, column_id, ret);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        data_rows_.set_row_desc(data_desc);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < index_num; i++)
+      {
+        if (NULL == index_tables[i])
+        {
+          ret = OB_INVALID_ARGUMENT;
+        }
+        else
+        {
+          ret = init_index_(sm, row_desc, *index_tables[i], i);
+        }
+      }
+      return ret;
+    }
+
+    int IndexModifyRows::init_index_(const CommonSchemaManager &sm, const ObRowDesc &row_desc,
+                                     const ObTableSchema &index_table, const int64_t idx)
+    {
+      int ret = OB_SUCCESS;
+      IndexInfo &index = index_[idx];
+      const ObRowkeyInfo &rki = index_table.get_rowkey_info();
+      const uint64_t index_tid = index_table.get_table_id();
+      const uint64_t data_tid = index_table.get_index_data_table_id();
+      ObRowDesc del_desc;
+      ObRowDesc put_desc;
+      int32_t column_num = 0;
+      const ObColumnSchemaV2 *columns = sm.get_table_schema(index_tid, column_num);
+      uint64_t column_id = OB_INVALID_ID;
+      index.rk_size_ = rki.get_size();
+      del_desc.set_rowkey_cell_count(rki.get_size());
+      put_desc.set_rowkey_cell_count(rki.get_size());
+      // rowkey columns first, then the other columns of the index table
+      for (int64_t i = 0; OB_SUCCESS == ret && i < rki.get_size(); i++)
+      {
+        if (OB_SUCCESS != (ret = rki.get_column_id(i, column_id)))
+        {
+          TBSYS_LOG(WARN, "get rowkey column fail table_id=%lu idx=%ld", index_tid, i);
+        }
+        else if (OB_SUCCESS != (ret = del_desc.add_column_desc(index_tid, column_id))
+                || OB_SUCCESS != (ret = put_desc.add_column_desc(index_tid, column_id)))
+        {
+          TBSYS_LOG(WARN, "add column desc fail tid=%lu cid=%lu ret=%d", index_tid, column_id, ret);
+        }
+      }
+      for (int32_t i = 0; OB_SUCCESS == ret && NULL != columns && i < column_num; i++)
+      {
+        if (!rki.is_rowkey_column(columns[i].get_id())
+            && OB_SUCCESS != (ret = put_desc.add_column_desc(index_tid, columns[i].get_id())))
+        {
+          TBSYS_LOG(WARN, "add column desc fail tid=%lu cid=%lu ret=%d", index_tid, columns[i].get_id(), ret);
+        }
+      }
+      if (OB_SUCCESS == ret
+          && OB_SUCCESS != (ret = del_desc.add_column_desc(index_tid, OB_ACTION_FLAG_COLUMN_ID)))
+      {
+        TBSYS_LOG(WARN, "add action flag column desc fail ret=%d", ret);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < put_desc.get_column_num(); i++)
+      {
+        uint64_t table_id = OB_INVALID_ID;
+        int64_t new_pos = OB_INVALID_INDEX;
+        int64_t old_pos = OB_INVALID_INDEX;
+        put_desc.get_tid_cid(i, table_id, column_id);
+        new_pos = row_desc.get_idx(data_tid, column_id);
+        if (i >= rki.get_size() - rk_size_ && i < rki.get_size())
+        {
+          // rowkey of data table never changes
+          old_pos = new_pos;
+        }
+        else
+        {
+          old_pos = row_desc.get_idx(data_tid, column_id + OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET);
+        }
+        if (OB_SUCCESS != (ret = index.new_pos_.push_back(new_pos))
+            || OB_SUCCESS != (ret = index.old_pos_.push_back(old_pos)))
+        {
+          TBSYS_LOG(WARN, "push column pos fail ret=%d", ret);
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        index.del_rows_.set_row_desc(del_desc);
+        index.put_rows_.set_row_desc(put_desc);
+      }
+      return ret;
+    }
+
+    int IndexModifyRows::add_row(const ObRow &row)
+    {
+      int ret = OB_SUCCESS;
+      const ObRowDesc *data_desc = NULL;
+      const ObObj *cell = NULL;
+      data_rows_.get_row_desc(data_desc);
+      row_.set_row_desc(*data_desc);
+      for (int64_t i = 0; OB_SUCCESS == ret && i < data_pos_.count(); i++)
+      {
+        if (OB_SUCCESS != (ret = get_cell_(row, data_pos_.at(i), cell)))
+        {
+          TBSYS_LOG(WARN, "get cell fail pos=%ld ret=%d", data_pos_.at(i), ret);
+        }
+        else
+        {
+          ret = row_.raw_set_cell(i, *cell);
+        }
+      }
+      if (OB_SUCCESS != ret)
+      {
+      }
+      else if (OB_SUCCESS != (ret = data_rows_.add_values(row_)))
+      {
+        TBSYS_LOG(WARN, "add data row fail ret=%d", ret);
+      }
+      else
+      {
+        data_count_++;
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < index_num_; i++)
+      {
+        ret = add_index_row_(row, i);
+      }
+      return ret;
+    }
+
+    int IndexModifyRows::get_cell_(const ObRow &row, const int64_t pos, const ObObj *&cell)
+    {
+      int ret = OB_SUCCESS;
+      static ObObj null_cell;
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
+      if (0 > pos)
+      {
+        cell = &null_cell;
+      }
+      else
+      {
+        ret = row.raw_get_cell(pos, cell, table_id, column_id);
+      }
+      return ret;
+    }
+
+    int IndexModifyRows::add_index_row_(const ObRow &row, const int64_t idx)
+    {
+      int ret = OB_SUCCESS;
+      IndexInfo &index = index_[idx];
+      const ObRowDesc *desc = NULL;
+      const ObObj *new_cell = NULL;
+      const ObObj *old_cell = NULL;
+      bool need_put = !is_delete_;
+      bool need_del = is_delete_;
+      if (!is_delete_ && has_old_value_)
+      {
+        // update: index row is rewritten only if one of its columns changes,
+        // and the old one is deleted only if its rowkey changes, the rowkey
+        // columns of data table are always present and never change
+        need_put = false;
+        for (int64_t i = 0; OB_SUCCESS == ret && i < index.new_pos_.count(); i++)
+        {
+          if (0 > index.new_pos_.at(i)
+              || (i >= index.rk_size_ - rk_size_ && i < index.rk_size_))
+          {
+            continue;
+          }
+          else if (0 > index.old_pos_.at(i))
+          {
+            TBSYS_LOG(WARN, "old value of index column not found idx=%ld", i);
+            ret = OB_ERR_UNEXPECTED;
+          }
+          else if (OB_SUCCESS == (ret = get_cell_(row, index.new_pos_.at(i), new_cell))
+                  && OB_SUCCESS == (ret = get_cell_(row, index.old_pos_.at(i), old_cell))
+                  && *new_cell != *old_cell)
+          {
+            need_put = true;
+            if (i < index.rk_size_)
+            {
+              need_del = true;
+            }
+          }
+        }
+      }
+      if (OB_SUCCESS == ret && need_del)
+      {
+        index.del_rows_.get_row_desc(desc);
+        row_.set_row_desc(*desc);
+        for (int64_t i = 0; OB_SUCCESS == ret && i < index.rk_size_; i++)
+        {
+          if (OB_SUCCESS != (ret = get_cell_(row, index.old_pos_.at(i), old_cell)))
+          {
+            TBSYS_LOG(WARN, "get old cell fail pos=%ld ret=%d", index.old_pos_.at(i), ret);
+          }
+          else
+          {
+            ret = row_.raw_set_cell(i, *old_cell);
+          }
+        }
+        if (OB_SUCCESS == ret)
+        {
+          ObObj flag;
+          flag.set_int(ObActionFlag::OP_DEL_ROW);
+          ret = row_.raw_set_cell(index.rk_size_, flag);
+        }
+        if (OB_SUCCESS != ret)
+        {
+        }
+        else if (OB_SUCCESS != (ret = index.del_rows_.add_values(row_)))
+        {
+          TBSYS_LOG(WARN, "add index del row fail ret=%d", ret);
+        }
+        else
+        {
+          index.del_count_++;
+        }
+      }
+      if (OB_SUCCESS == ret && need_put)
+      {
+        index.put_rows_.get_row_desc(desc);
+        row_.set_row_desc(*desc);
+        for (int64_t i = 0; OB_SUCCESS == ret && i < index.new_pos_.count(); i++)
+        {
+          int64_t pos = index.new_pos_.at(i);
+          if (0 > pos && has_old_value_)
+          {
+            pos = index.old_pos_.at(i);
+          }
+          if (OB_SUCCESS != (ret = get_cell_(row, pos, new_cell)))
+          {
+            TBSYS_LOG(WARN, "get cell fail pos=%ld ret=%d", pos, ret);
+          }
+          else
+          {
+            ret = row_.raw_set_cell(i, *new_cell);
+          }
+        }
+        if (OB_SUCCESS != ret)
+        {
+        }
+        else if (OB_SUCCESS != (ret = index.put_rows_.add_values(row_)))
+        {
+          TBSYS_LOG(WARN, "add index put row fail ret=%d", ret);
+        }
+        else
+        {
+          index.put_count_++;
+        }
+      }
+      return ret;
+    }
+
+    int IndexModifyRows::apply(const CommonSchemaManager &sm, RWSessionCtx &session, ObIUpsTableMgr &host)
+    {
+      int ret = OB_SUCCESS;
+      // old index rows are all deleted before the new ones are put, so that
+      // a row of this statement taking the index key of another one is kept
+      ret = apply_rows_(sm, data_rows_, data_count_, rk_size_, session, host);
+      for (int64_t i = 0; OB_SUCCESS == ret && i < index_num_; i++)
+      {
+        ret = apply_rows_(sm, index_[i].del_rows_, index_[i].del_count_, index_[i].rk_size_, session, host);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < index_num_; i++)
+      {
+        ret = apply_rows_(sm, index_[i].put_rows_, index_[i].put_count_, index_[i].rk_size_, session, host);
+      }
+      return ret;
+    }
+
+    int IndexModifyRows::apply_rows_(const CommonSchemaManager &sm, ObValues &rows, const int64_t row_count,
+                                     const int64_t rk_size, RWSessionCtx &session, ObIUpsTableMgr &host)
+    {
+      int ret = OB_SUCCESS;
+      if (0 >= row_count)
+      {
+      }
+      else if (OB_SUCCESS != (ret = rows.open()))
+      {
+        TBSYS_LOG(WARN, "open rows fail ret=%d", ret);
+      }
+      else
+      {
+        ObCellIterAdaptor cia;
+        cia.set_row_iter(&rows, rk_size, &sm);
+        if (OB_SUCCESS != (ret = host.apply(session, cia)))
+        {
+          TBSYS_LOG(WARN, "apply rows fail row_count=%ld ret=%d", row_count, ret);
+        }
+      }
+      return ret;
+    }
+
     MemTableModify::MemTableModify(RWSessionCtx &session, ObIUpsTableMgr &host): session_(session),
                                                                                  host_(host)
     {
@@ -83,9 +440,22 @@ namespace oceanbase
         }
         else
         {
-          ObCellIterAdaptor cia;
-          cia.set_row_iter(child_op_, rki->get_size(), sm);
-          ret = host_.apply(session_, cia);
+          const ObTableSchema *index_tables[OB_MAX_INDEX_TABLE_NUMBER];
+          int64_t index_num = OB_MAX_INDEX_TABLE_NUMBER;
+          if (OB_SUCCESS != (ret = sm->get_index_tables(table_id, index_tables, index_num)))
+          {
+            TBSYS_LOG(WARN, "get index tables fail table_id=%lu ret=%d", table_id, ret);
+          }
+          else if (0 < index_num)
+          {
+            ret = apply_with_index_(*sm, *row_desc, rki->get_size(), index_tables, index_num);
+          }
+          else
+          {
+            ObCellIterAdaptor cia;
+            cia.set_row_iter(child_op_, rki->get_size(), sm);
+            ret = host_.apply(session_, cia);
+          }
         }
       }
       if (OB_SUCCESS != ret)
@@ -98,6 +468,54 @@ namespace oceanbase
       return ret;
     }
 
+    int MemTableModify::apply_with_index_(const CommonSchemaManager &sm, const ObRowDesc &row_desc,
+                                          const int64_t rk_size, const ObTableSchema **index_tables,
+                                          const int64_t index_num)
+    {
+      int ret = OB_SUCCESS;
+      const ObRow *row = NULL;
+      IndexModifyRows *rows = OB_NEW(IndexModifyRows, ObModIds::OB_UPS_COMMON);
+      if (NULL == rows)
+      {
+        TBSYS_LOG(WARN, "alloc index modify rows fail");
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else if (OB_SUCCESS != (ret = rows->init(sm, row_desc, rk_size, index_tables, index_num)))
+      {
+        TBSYS_LOG(WARN, "init index modify rows fail %s ret=%d", to_cstring(row_desc), ret);
+      }
+      else
+      {
+        while (OB_SUCCESS == ret
+              && OB_SUCCESS == (ret = child_op_->get_next_row(row)))
+        {
+          if (NULL == row)
+          {
+            ret = OB_ERR_UNEXPECTED;
+          }
+          else if (OB_SUCCESS != (ret = rows->add_row(*row)))
+          {
+            TBSYS_LOG(WARN, "add row fail %s ret=%d", to_cstring(*row), ret);
+          }
+        }
+        if (OB_ITER_END == ret)
+        {
+          ret = rows->apply(sm, session_, host_);
+        }
+        else if (OB_SUCCESS != ret && OB_ERR_PRIMARY_KEY_DUPLICATE != ret)
+        {
+          TBSYS_LOG(WARN, "get next row from child_op=%p type=%d fail ret=%d",
+                    child_op_, child_op_->get_type(), ret);
+        }
+      }
+      if (NULL != rows)
+      {
+        OB_DELETE(IndexModifyRows, ObModIds::OB_UPS_COMMON, rows);
+        rows = NULL;
+      }
+      return ret;
+    }
+
     int MemTableModify::close()
     {
       int ret = OB_SUCCESS;
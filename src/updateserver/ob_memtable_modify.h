@@ -17,6 +17,7 @@
 #define  OCEANBASE_UPDATESERVER_MEMTABLE_MODIFY_H_
 
 #include "sql/ob_ups_modify.h"
+#include "sql/ob_values.h"
 #include "common/ob_iterator.h"
 #include "common/ob_iterator_adaptor.h"
 #include "ob_sessionctx_factory.h"
@@ -27,6 +28,52 @@ namespace oceanbase
 {
   namespace updateserver
   {
+    /**
+     * rows of one statement on a table having index tables, split into the
+     * rows of the data table and the index rows to delete/put, the index rows
+     * are applied in the same session right after the data rows
+     */
+    class IndexModifyRows
+    {
+      public:
+        IndexModifyRows();
+        ~IndexModifyRows();
+      public:
+        int init(const CommonSchemaManager &sm, const common::ObRowDesc &row_desc, const int64_t rk_size,
+                 const common::ObTableSchema **index_tables, const int64_t index_num);
+        int add_row(const common::ObRow &row);
+        int apply(const CommonSchemaManager &sm, RWSessionCtx &session, ObIUpsTableMgr &host);
+      private:
+        int init_index_(const CommonSchemaManager &sm, const common::ObRowDesc &row_desc,
+                        const common::ObTableSchema &index_table, const int64_t idx);
+        int add_index_row_(const common::ObRow &row, const int64_t idx);
+        int get_cell_(const common::ObRow &row, const int64_t pos, const common::ObObj *&cell);
+        int apply_rows_(const CommonSchemaManager &sm, sql::ObValues &rows, const int64_t row_count,
+                        const int64_t rk_size, RWSessionCtx &session, ObIUpsTableMgr &host);
+      private:
+        struct IndexInfo
+        {
+          int64_t rk_size_;
+          // positions in the input row of the new and the old value of each
+          // column of put_rows_, -1 if not present
+          common::ObArray<int64_t> new_pos_;
+          common::ObArray<int64_t> old_pos_;
+          sql::ObValues del_rows_;
+          sql::ObValues put_rows_;
+          int64_t del_count_;
+          int64_t put_count_;
+        };
+        int64_t rk_size_;
+        int64_t index_num_;
+        bool is_delete_;
+        bool has_old_value_;
+        common::ObArray<int64_t> data_pos_;
+        sql::ObValues data_rows_;
+        int64_t data_count_;
+        IndexInfo index_[common::OB_MAX_INDEX_TABLE_NUMBER];
+        common::ObRow row_;
+    };
+
     class MemTableModify : public sql::ObUpsModify, public RowkeyInfoCache
     {
       public:
@@ -38,6 +85,10 @@ namespace oceanbase
         int get_next_row(const common::ObRow *&row);
         int get_row_desc(const common::ObRowDesc *&row_desc) const;
         int64_t to_string(char* buf, const int64_t buf_len) const;
+      private:
+        int apply_with_index_(const CommonSchemaManager &sm, const common::ObRowDesc &row_desc,
+                              const int64_t rk_size, const common::ObTableSchema **index_tables,
+                              const int64_t index_num);
       private:
         RWSessionCtx &session_;
         ObIUpsTableMgr &host_;
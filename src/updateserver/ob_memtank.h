@@ -70,6 +70,10 @@ namespace oceanbase
         {
           int64_t block_size = PAGE_SIZE;
           block_allocator_.set_mod_id(mod_id);
+          // memtable被所有node上的读线程访问, 内存交错分布在各个numa node上
+          block_allocator_.set_numa_interleave(true);
+          // memtable的block长期存在且总量很大, 使用大页减少btree查找的TLB miss
+          block_allocator_.set_huge_page(true);
           string_buf_.init(&block_allocator_, block_size);
           allocer_.init(&block_allocator_, block_size);
           tevalue_allocer_.init(&block_allocator_, block_size);
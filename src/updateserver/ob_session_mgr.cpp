@@ -525,6 +525,16 @@ namespace oceanbase
       return commited_trans_id_;
     }
 
+    void SessionMgr::update_commited_trans_id(const int64_t trans_id)
+    {
+      int64_t tmp_trans_id = trans_id;
+      trans_seq_.update(tmp_trans_id);
+      if (commited_trans_id_ < trans_id)
+      {
+        commited_trans_id_ = trans_id;
+      }
+    }
+
     BaseSessionCtx *SessionMgr::alloc_ctx_(const SessionType type)
     {
       BaseSessionCtx *ret = NULL;
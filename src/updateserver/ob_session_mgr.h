@@ -403,6 +403,8 @@ namespace oceanbase
         int kill_session(const uint32_t session_descriptor);
         void show_sessions(common::ObNewScanner &scanner);
         int64_t get_commited_trans_id() const;
+        // 从memtable checkpoint恢复后 把已提交事务号和事务号序列推进到checkpoint的事务号
+        void update_commited_trans_id(const int64_t trans_id);
         int64_t get_flying_rosession_num() const {return ctx_list_[ST_READ_ONLY].get_free();};
         int64_t get_flying_rpsession_num() const {return ctx_list_[ST_REPLAY].get_free();};
         int64_t get_flying_rwsession_num() const {return ctx_list_[ST_READ_WRITE].get_free();};
@@ -0,0 +1,617 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sstable_compactor.cpp
+ *
+ */
+#include "ob_sstable_compactor.h"
+#include "ob_update_server_config.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    using namespace common;
+
+    RowCellCopyIterator::RowCellCopyIterator() : iter_(NULL),
+                                                 cur_buf_(0),
+                                                 cell_(),
+                                                 is_row_changed_(false)
+    {
+    }
+
+    RowCellCopyIterator::~RowCellCopyIterator()
+    {
+    }
+
+    void RowCellCopyIterator::set_iterator(ObIterator *iter)
+    {
+      iter_ = iter;
+      string_bufs_[0].reset();
+      string_bufs_[1].reset();
+      cur_buf_ = 0;
+      is_row_changed_ = false;
+    }
+
+    int RowCellCopyIterator::next_cell()
+    {
+      int ret = OB_SUCCESS;
+      ObCellInfo *cell_info = NULL;
+      if (NULL == iter_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (ret = iter_->next_cell()))
+      {
+        // OB_ITER_END or error
+      }
+      else if (OB_SUCCESS != (ret = iter_->get_cell(&cell_info, &is_row_changed_))
+              || NULL == cell_info)
+      {
+        TBSYS_LOG(WARN, "get cell fail ret=%d cell_info=%p", ret, cell_info);
+        ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+      }
+      else
+      {
+        if (is_row_changed_)
+        {
+          // 换行时切换缓冲区 被重用的缓冲区里是上上一行 已经被ObRowCompaction输出了
+          cur_buf_ = 1 - cur_buf_;
+          string_bufs_[cur_buf_].reset();
+          cell_.table_id_ = cell_info->table_id_;
+          ret = string_bufs_[cur_buf_].write_string(cell_info->row_key_, &cell_.row_key_);
+        }
+        if (OB_SUCCESS == ret)
+        {
+          cell_.column_id_ = cell_info->column_id_;
+          ret = string_bufs_[cur_buf_].write_obj(cell_info->value_, &cell_.value_);
+        }
+        if (OB_SUCCESS != ret)
+        {
+          TBSYS_LOG(WARN, "copy cell fail ret=%d %s", ret, print_cellinfo(cell_info));
+        }
+      }
+      return ret;
+    }
+
+    int RowCellCopyIterator::get_cell(ObCellInfo **cell_info)
+    {
+      return get_cell(cell_info, NULL);
+    }
+
+    int RowCellCopyIterator::get_cell(ObCellInfo **cell_info, bool *is_row_changed)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL == cell_info)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        *cell_info = &cell_;
+        if (NULL != is_row_changed)
+        {
+          *is_row_changed = is_row_changed_;
+        }
+      }
+      return ret;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    SSTableCompactRowIterator::SSTableCompactRowIterator() : inited_(false),
+                                                             resource_pool_(NULL),
+                                                             source_num_(0),
+                                                             rate_limit_(0),
+                                                             schema_(),
+                                                             cur_table_id_(0),
+                                                             table_opened_(false),
+                                                             merger_(),
+                                                             copy_iter_(),
+                                                             rc_iter_()
+    {
+      memset(sources_, 0, sizeof(sources_));
+      memset(iters_, 0, sizeof(iters_));
+    }
+
+    SSTableCompactRowIterator::~SSTableCompactRowIterator()
+    {
+      destroy();
+    }
+
+    int SSTableCompactRowIterator::init(const TableList &table_list,
+                                        ITableEntity::ResourcePool &resource_pool,
+                                        const int64_t rate_limit)
+    {
+      int ret = OB_SUCCESS;
+      if (inited_)
+      {
+        TBSYS_LOG(WARN, "have inited");
+        ret = OB_INIT_TWICE;
+      }
+      else if (0 >= table_list.size()
+              || MAX_SOURCE_NUM < table_list.size())
+      {
+        TBSYS_LOG(WARN, "invalid param source_num=%ld", table_list.size());
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        resource_pool_ = &resource_pool;
+        TableList::const_iterator iter;
+        for (iter = table_list.begin(); OB_SUCCESS == ret && iter != table_list.end(); iter++)
+        {
+          SSTableEntity *sstable_entity = dynamic_cast<SSTableEntity*>(*iter);
+          if (NULL == sstable_entity
+              || NULL == sstable_entity->get_sstable_reader())
+          {
+            TBSYS_LOG(WARN, "invalid sstable entity=%p", *iter);
+            ret = OB_INVALID_ARGUMENT;
+          }
+          else if (NULL == (iters_[source_num_] = resource_pool.get_sstable_rp().alloc()))
+          {
+            TBSYS_LOG(WARN, "alloc sstable iterator fail");
+            ret = OB_MEM_OVERFLOW;
+          }
+          else
+          {
+            sources_[source_num_++] = sstable_entity;
+          }
+        }
+        if (OB_SUCCESS == ret
+            && OB_SUCCESS != (ret = sources_[source_num_ - 1]->get_table_item().get_schema(schema_)))
+        {
+          TBSYS_LOG(WARN, "get schema fail ret=%d %s", ret,
+                    SSTableID::log_str(sources_[source_num_ - 1]->get_sstable_id()));
+        }
+        if (OB_SUCCESS == ret)
+        {
+          rate_limit_ = rate_limit;
+          cur_table_id_ = 0;
+          table_opened_ = false;
+          inited_ = true;
+        }
+        else
+        {
+          inited_ = true;
+          destroy();
+        }
+      }
+      return ret;
+    }
+
+    void SSTableCompactRowIterator::destroy()
+    {
+      if (inited_)
+      {
+        close_table_();
+        for (int64_t i = 0; i < source_num_; i++)
+        {
+          if (NULL != iters_[i])
+          {
+            resource_pool_->get_sstable_rp().free(iters_[i]);
+            iters_[i] = NULL;
+          }
+          sources_[i] = NULL;
+        }
+        source_num_ = 0;
+        resource_pool_ = NULL;
+        rate_limit_ = 0;
+        cur_table_id_ = 0;
+        inited_ = false;
+      }
+    }
+
+    const CommonSchemaManager *SSTableCompactRowIterator::get_schema() const
+    {
+      return inited_ ? schema_.get_impl() : NULL;
+    }
+
+    int SSTableCompactRowIterator::open_next_table_()
+    {
+      int ret = OB_SUCCESS;
+      const CommonSchemaManager *schema_mgr = schema_.get_impl();
+      while (OB_SUCCESS == ret
+            && !table_opened_)
+      {
+        // 按table id从小到大输出 sstable要求行按table id和rowkey有序
+        uint64_t next_table_id = OB_INVALID_ID;
+        for (const CommonTableSchema *iter = schema_mgr->table_begin(); iter != schema_mgr->table_end(); iter++)
+        {
+          if (cur_table_id_ < iter->get_table_id()
+              && next_table_id > iter->get_table_id())
+          {
+            next_table_id = iter->get_table_id();
+          }
+        }
+        if (OB_INVALID_ID == next_table_id)
+        {
+          ret = OB_ITER_END;
+          break;
+        }
+        cur_table_id_ = next_table_id;
+
+        ObNewRange scan_range;
+        ObScanParam scan_param;
+        scan_range.table_id_ = cur_table_id_;
+        scan_range.set_whole_range();
+        scan_param.set(cur_table_id_, ObString(), scan_range);
+        scan_param.add_column(OB_FULL_ROW_COLUMN_ID);
+        thread_read_prepare();
+        merger_.reset();
+        merger_.set_asc(true);
+        int64_t iter_num = 0;
+        for (int64_t i = 0; OB_SUCCESS == ret && i < source_num_; i++)
+        {
+          TableTransDescriptor trans_descriptor = 0;
+          if (!sources_[i]->get_sstable_reader()->get_schema()->is_table_exist(cur_table_id_))
+          {
+            continue;
+          }
+          if (OB_SUCCESS != (ret = sources_[i]->scan(trans_descriptor, scan_param, iters_[i])))
+          {
+            TBSYS_LOG(WARN, "scan sstable fail ret=%d table_id=%lu %s",
+                      ret, cur_table_id_, SSTableID::log_str(sources_[i]->get_sstable_id()));
+          }
+          else if (OB_ITER_END == iters_[i]->next_cell())
+          {
+            // 与读请求一样 先迭代一次判断是否为空 非空的迭代器下一次next_cell不会前进
+            iters_[i]->reset();
+          }
+          else if (OB_SUCCESS != (ret = merger_.add_iterator(iters_[i])))
+          {
+            TBSYS_LOG(WARN, "add iterator to merger fail ret=%d", ret);
+          }
+          else
+          {
+            iter_num++;
+          }
+        }
+        if (OB_SUCCESS == ret
+            && 0 < iter_num)
+        {
+          copy_iter_.set_iterator(&merger_);
+          ret = rc_iter_.set_iterator(&copy_iter_);
+          table_opened_ = true;
+        }
+        else
+        {
+          for (int64_t i = 0; i < source_num_; i++)
+          {
+            iters_[i]->reset();
+          }
+          thread_read_complete();
+        }
+      }
+      return ret;
+    }
+
+    void SSTableCompactRowIterator::close_table_()
+    {
+      if (table_opened_)
+      {
+        for (int64_t i = 0; i < source_num_; i++)
+        {
+          iters_[i]->reset();
+        }
+        merger_.reset();
+        thread_read_complete();
+        table_opened_ = false;
+      }
+    }
+
+    int SSTableCompactRowIterator::next_row()
+    {
+      int ret = OB_SUCCESS;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited this=%p", this);
+        ret = OB_NOT_INIT;
+      }
+      else
+      {
+        bool row_found = false;
+        while (OB_SUCCESS == ret
+              && !row_found)
+        {
+          if (!table_opened_
+              && OB_SUCCESS != (ret = open_next_table_()))
+          {
+            break;
+          }
+          // 跳过当前行没有被get_row取走的cell
+          ObCellInfo *cell_info = NULL;
+          bool is_row_changed = false;
+          while (OB_SUCCESS == (ret = rc_iter_.next_cell()))
+          {
+            if (OB_SUCCESS != (ret = rc_iter_.get_cell(&cell_info, &is_row_changed)))
+            {
+              break;
+            }
+            if (is_row_changed)
+            {
+              row_found = true;
+              break;
+            }
+          }
+          if (OB_ITER_END == ret)
+          {
+            close_table_();
+            ret = OB_SUCCESS;
+          }
+        }
+        if (OB_SUCCESS != ret
+            && OB_ITER_END != ret)
+        {
+          TBSYS_LOG(WARN, "iterate compacted row fail ret=%d table_id=%lu", ret, cur_table_id_);
+        }
+      }
+      return ret;
+    }
+
+    int SSTableCompactRowIterator::get_row(sstable::ObSSTableRow &sstable_row)
+    {
+      int ret = OB_SUCCESS;
+      ObCellInfo *cell_info = NULL;
+      if (!inited_
+          || !table_opened_)
+      {
+        TBSYS_LOG(WARN, "invalid status inited=%s table_opened=%s", STR_BOOL(inited_), STR_BOOL(table_opened_));
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (ret = rc_iter_.get_cell(&cell_info))
+              || NULL == cell_info)
+      {
+        TBSYS_LOG(WARN, "get cell fail ret=%d cell_info=%p", ret, cell_info);
+        ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+      }
+      else
+      {
+        // 源sstable的数据在预取的行被消费前可能已经被覆盖 所以行内的值都深拷贝
+        sstable_row.clear();
+        sstable_row.set_table_id(cell_info->table_id_);
+        sstable_row.set_column_group_id(OB_DEFAULT_COLUMN_GROUP_ID);
+        if (OB_SUCCESS != (ret = sstable_row.set_rowkey(cell_info->row_key_)))
+        {
+          TBSYS_LOG(WARN, "set rowkey to sstable_row fail ret=%d %s", ret, print_cellinfo(cell_info));
+        }
+        bool is_row_finished = false;
+        while (OB_SUCCESS == ret)
+        {
+          // sstable不接受column_id为OB_INVALID_ID所以转成了0
+          ObObj column_id;
+          column_id.set_int(OB_INVALID_ID == cell_info->column_id_ ? OB_FULL_ROW_COLUMN_ID : cell_info->column_id_);
+          if (OB_SUCCESS != (ret = sstable_row.add_obj(column_id))
+              || OB_SUCCESS != (ret = sstable_row.add_obj(cell_info->value_)))
+          {
+            TBSYS_LOG(WARN, "add obj to sstable_row fail ret=%d %s", ret, print_cellinfo(cell_info));
+          }
+          else if (OB_SUCCESS != (ret = rc_iter_.is_row_finished(&is_row_finished))
+                  || is_row_finished)
+          {
+            break;
+          }
+          else if (OB_SUCCESS != (ret = rc_iter_.next_cell())
+                  || OB_SUCCESS != (ret = rc_iter_.get_cell(&cell_info))
+                  || NULL == cell_info)
+          {
+            TBSYS_LOG(WARN, "get next cell in row fail ret=%d", ret);
+            ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+          }
+        }
+      }
+      return ret;
+    }
+
+    int SSTableCompactRowIterator::reset_iter()
+    {
+      int ret = OB_SUCCESS;
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited this=%p", this);
+        ret = OB_NOT_INIT;
+      }
+      else
+      {
+        TBSYS_LOG(INFO, "reset compact row_iter this=%p", this);
+        close_table_();
+        cur_table_id_ = 0;
+      }
+      return ret;
+    }
+
+    const sstable::ObSSTableReader *SSTableCompactRowIterator::get_newest_reader_() const
+    {
+      return (inited_ && 0 < source_num_) ? sources_[source_num_ - 1]->get_sstable_reader() : NULL;
+    }
+
+    bool SSTableCompactRowIterator::get_compressor_name(ObString &compressor_str)
+    {
+      bool bret = false;
+      const sstable::ObSSTableReader *reader = get_newest_reader_();
+      if (NULL != reader)
+      {
+        const char *compressor_name = reader->get_trailer().get_compressor_name();
+        compressor_str.assign_ptr(const_cast<char*>(compressor_name),
+                                  static_cast<int32_t>(strnlen(compressor_name, OB_MAX_COMPRESSOR_NAME_LENGTH)));
+        bret = true;
+      }
+      return bret;
+    }
+
+    bool SSTableCompactRowIterator::get_sstable_schema(sstable::ObSSTableSchema &sstable_schema)
+    {
+      bool bret = false;
+      if (inited_)
+      {
+        sstable_schema.reset();
+        bret = (OB_SUCCESS == sstable::build_sstable_schema(*schema_.get_impl(), sstable_schema));
+      }
+      return bret;
+    }
+
+    const ObRowkeyInfo *SSTableCompactRowIterator::get_rowkey_info(const uint64_t table_id) const
+    {
+      return RowkeyInfoCache::get_rowkey_info(table_id);
+    }
+
+    bool SSTableCompactRowIterator::get_store_type(int &store_type)
+    {
+      bool bret = false;
+      const sstable::ObSSTableReader *reader = get_newest_reader_();
+      if (NULL != reader)
+      {
+        store_type = reader->get_trailer().get_row_value_store_style();
+        bret = true;
+      }
+      return bret;
+    }
+
+    bool SSTableCompactRowIterator::get_block_size(int64_t &block_size)
+    {
+      bool bret = false;
+      const sstable::ObSSTableReader *reader = get_newest_reader_();
+      if (NULL != reader)
+      {
+        block_size = reader->get_trailer().get_block_size();
+        bret = true;
+      }
+      return bret;
+    }
+
+    bool SSTableCompactRowIterator::get_write_rate_limit(int64_t &rate_limit)
+    {
+      rate_limit = rate_limit_;
+      return (0 < rate_limit_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    SSTableCompactor::SSTableCompactor() : table_mgr_(NULL),
+                                           sstable_mgr_(NULL),
+                                           config_(NULL),
+                                           row_iter_()
+    {
+    }
+
+    SSTableCompactor::~SSTableCompactor()
+    {
+    }
+
+    int SSTableCompactor::init(TableMgr *table_mgr, SSTableMgr *sstable_mgr, const ObUpdateServerConfig *config)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL != table_mgr_)
+      {
+        TBSYS_LOG(WARN, "have inited");
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == table_mgr
+              || NULL == sstable_mgr
+              || NULL == config)
+      {
+        TBSYS_LOG(WARN, "invalid param table_mgr=%p sstable_mgr=%p config=%p", table_mgr, sstable_mgr, config);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else
+      {
+        table_mgr_ = table_mgr;
+        sstable_mgr_ = sstable_mgr;
+        config_ = config;
+      }
+      return ret;
+    }
+
+    void SSTableCompactor::run(tbsys::CThread *thread, void *arg)
+    {
+      UNUSED(thread);
+      UNUSED(arg);
+      int64_t last_compact_time = tbsys::CTimeUtil::getTime();
+      while (!_stop)
+      {
+        int64_t interval = config_->minor_compact_interval;
+        if (0 < interval
+            && last_compact_time + interval <= tbsys::CTimeUtil::getTime())
+        {
+          // 一次检查中合并到没有可以合并的sstable为止 合并出的sstable可能又凑够了一层
+          int tmp_ret = OB_SUCCESS;
+          while (!_stop
+                && OB_SUCCESS == (tmp_ret = compact_once()))
+          {
+          }
+          if (OB_ENTRY_NOT_EXIST != tmp_ret
+              && OB_SUCCESS != tmp_ret)
+          {
+            TBSYS_LOG(WARN, "compact minor sstable fail ret=%d", tmp_ret);
+          }
+          last_compact_time = tbsys::CTimeUtil::getTime();
+        }
+        usleep(CHECK_PERIOD);
+      }
+    }
+
+    int SSTableCompactor::compact_once()
+    {
+      int ret = OB_SUCCESS;
+      TableList table_list;
+      uint64_t sstable_id = OB_INVALID_ID;
+      int64_t fan_in = config_->minor_compact_fan_in;
+      int64_t timeu = tbsys::CTimeUtil::getTime();
+      if (NULL == table_mgr_)
+      {
+        TBSYS_LOG(WARN, "have not inited");
+        ret = OB_NOT_INIT;
+      }
+      else if (OB_SUCCESS != (ret = table_mgr_->acquire_minor_compaction(fan_in, table_list, sstable_id)))
+      {
+        if (OB_ENTRY_NOT_EXIST != ret)
+        {
+          TBSYS_LOG(WARN, "acquire minor compaction fail ret=%d fan_in=%ld", ret, fan_in);
+        }
+      }
+      else
+      {
+        // 合并后的sstable与最新的源sstable使用相同的日志号和冻结时间
+        TableItem *newest_item = NULL;
+        for (TableList::iterator iter = table_list.begin(); iter != table_list.end(); iter++)
+        {
+          newest_item = &((*iter)->get_table_item());
+        }
+        uint64_t clog_id = sstable_mgr_->get_clog_id(newest_item->get_sstable_id());
+        int64_t time_stamp = newest_item->get_time_stamp();
+        bool succ = false;
+        TBSYS_LOG(INFO, "start minor compaction %s source_num=%ld clog_id=%lu",
+                  SSTableID::log_str(sstable_id), table_list.size(), clog_id);
+        if (OB_SUCCESS != (ret = row_iter_.init(table_list, table_mgr_->get_resource_pool(),
+                                                config_->minor_compact_rate_limit)))
+        {
+          TBSYS_LOG(WARN, "init compact row iter fail ret=%d", ret);
+        }
+        else
+        {
+          if (OB_SUCCESS != (ret = sstable_mgr_->add_sstable(sstable_id, clog_id, time_stamp,
+                                                             row_iter_, row_iter_.get_schema())))
+          {
+            TBSYS_LOG(WARN, "build compacted sstable fail ret=%d %s", ret, SSTableID::log_str(sstable_id));
+          }
+          else
+          {
+            succ = true;
+          }
+          row_iter_.destroy();
+        }
+        int tmp_ret = table_mgr_->finish_minor_compaction(table_list, sstable_id, succ);
+        ret = (OB_SUCCESS == ret) ? tmp_ret : ret;
+        TBSYS_LOG(INFO, "finish minor compaction %s ret=%d timeu=%ld",
+                  SSTableID::log_str(sstable_id), ret, tbsys::CTimeUtil::getTime() - timeu);
+      }
+      return ret;
+    }
+  }
+}
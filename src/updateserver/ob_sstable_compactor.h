@@ -0,0 +1,112 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sstable_compactor.h
+ *
+ * 后台按大小分层合并同一个major版本下连续的minor sstable, 减少读取时需要合并的sstable个数
+ */
+#ifndef OCEANBASE_UPDATESERVER_SSTABLE_COMPACTOR_H_
+#define OCEANBASE_UPDATESERVER_SSTABLE_COMPACTOR_H_
+
+#include "tbsys.h"
+#include "common/ob_merger.h"
+#include "common/ob_row_compaction.h"
+#include "common/ob_string_buf.h"
+#include "ob_table_mgr.h"
+
+namespace oceanbase
+{
+  namespace updateserver
+  {
+    class ObUpdateServerConfig;
+
+    // 深拷贝下层迭代出的cell 下层sstable迭代器前进后 当前行和上一行的cell仍然有效
+    // ObRowCompaction在读到下一行的第一个cell之后才输出当前行 所以需要保留两行
+    class RowCellCopyIterator : public common::ObIterator
+    {
+      public:
+        RowCellCopyIterator();
+        virtual ~RowCellCopyIterator();
+      public:
+        void set_iterator(common::ObIterator *iter);
+        virtual int next_cell();
+        virtual int get_cell(common::ObCellInfo **cell_info);
+        virtual int get_cell(common::ObCellInfo **cell_info, bool *is_row_changed);
+      private:
+        common::ObIterator *iter_;
+        common::ObStringBuf string_bufs_[2];
+        int64_t cur_buf_;
+        common::ObCellInfo cell_;
+        bool is_row_changed_;
+    };
+
+    // 把一组连续的minor sstable合并成一个sstable的行迭代器
+    // 逐个表扫描所有源sstable 按版本顺序归并后做行内compaction
+    // 迭代在转储的预取线程中进行 所以扫描在next_row中才开始
+    class SSTableCompactRowIterator : public IRowIterator, public RowkeyInfoCache
+    {
+      static const int64_t MAX_SOURCE_NUM = 64;
+      public:
+        SSTableCompactRowIterator();
+        virtual ~SSTableCompactRowIterator();
+      public:
+        int init(const TableList &table_list, ITableEntity::ResourcePool &resource_pool, const int64_t rate_limit);
+        void destroy();
+        // 合并后的sstable使用最新的源sstable的schema
+        const CommonSchemaManager *get_schema() const;
+      public:
+        virtual int next_row();
+        virtual int get_row(sstable::ObSSTableRow &sstable_row);
+        virtual int reset_iter();
+        virtual bool get_compressor_name(common::ObString &compressor_str);
+        virtual bool get_sstable_schema(sstable::ObSSTableSchema &sstable_schema);
+        virtual const common::ObRowkeyInfo *get_rowkey_info(const uint64_t table_id) const;
+        virtual bool get_store_type(int &store_type);
+        virtual bool get_block_size(int64_t &block_size);
+        virtual bool get_write_rate_limit(int64_t &rate_limit);
+      private:
+        int open_next_table_();
+        void close_table_();
+        const sstable::ObSSTableReader *get_newest_reader_() const;
+      private:
+        bool inited_;
+        ITableEntity::ResourcePool *resource_pool_;
+        SSTableEntity *sources_[MAX_SOURCE_NUM];
+        SSTableEntityIterator *iters_[MAX_SOURCE_NUM];
+        int64_t source_num_;
+        int64_t rate_limit_;
+        CommonSchemaManagerWrapper schema_;
+        uint64_t cur_table_id_;
+        bool table_opened_;
+        common::ObMerger merger_;
+        RowCellCopyIterator copy_iter_;
+        common::ObRowCompaction rc_iter_;
+    };
+
+    class SSTableCompactor : public tbsys::CDefaultRunnable
+    {
+      static const int64_t CHECK_PERIOD = 100L * 1000L;
+      public:
+        SSTableCompactor();
+        virtual ~SSTableCompactor();
+      public:
+        int init(TableMgr *table_mgr, SSTableMgr *sstable_mgr, const ObUpdateServerConfig *config);
+        virtual void run(tbsys::CThread *thread, void *arg);
+        // 合并一组minor sstable 返回OB_ENTRY_NOT_EXIST表示没有需要合并的sstable
+        int compact_once();
+      private:
+        TableMgr *table_mgr_;
+        SSTableMgr *sstable_mgr_;
+        const ObUpdateServerConfig *config_;
+        SSTableCompactRowIterator row_iter_;
+    };
+  }
+}
+
+#endif //OCEANBASE_UPDATESERVER_SSTABLE_COMPACTOR_H_
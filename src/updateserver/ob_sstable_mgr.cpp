@@ -727,6 +727,111 @@ namespace oceanbase
       return bret;
     }
 
+    DumpRowPrefetcher::DumpRowPrefetcher() : ObReadAhead(BATCH_NUM),
+                                             iter_(NULL),
+                                             batches_(NULL),
+                                             cur_batch_(NULL),
+                                             cur_row_(0)
+    {
+    }
+
+    DumpRowPrefetcher::~DumpRowPrefetcher()
+    {
+      stop();
+      if (NULL != batches_)
+      {
+        for (int64_t i = 0; i < BATCH_NUM; i++)
+        {
+          batches_[i].~Batch();
+        }
+        ob_free(batches_);
+        batches_ = NULL;
+      }
+    }
+
+    int DumpRowPrefetcher::start(IRowIterator &iter)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL != iter_)
+      {
+        TBSYS_LOG(WARN, "prefetch has been started");
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == (batches_ = (Batch*)ob_malloc(sizeof(Batch) * BATCH_NUM, ObModIds::OB_UPS_SSTABLE_MGR)))
+      {
+        TBSYS_LOG(WARN, "malloc prefetch batches fail size=%ld", sizeof(Batch) * BATCH_NUM);
+        ret = OB_MEM_OVERFLOW;
+      }
+      else
+      {
+        for (int64_t i = 0; i < BATCH_NUM; i++)
+        {
+          new(&batches_[i]) Batch();
+          batches_[i].row_count = 0;
+        }
+        iter_ = &iter;
+        cur_batch_ = NULL;
+        cur_row_ = 0;
+        ret = ObReadAhead::start();
+      }
+      return ret;
+    }
+
+    int DumpRowPrefetcher::next_row(const sstable::ObSSTableRow *&row)
+    {
+      int ret = OB_SUCCESS;
+      int64_t slot_idx = 0;
+      if (NULL == iter_
+          || NULL == batches_)
+      {
+        TBSYS_LOG(WARN, "have not started");
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL != cur_batch_
+              && cur_row_ < cur_batch_->row_count)
+      {
+        // 当前批还没有消费完 不需要加锁
+      }
+      else if (OB_SUCCESS == (ret = next_slot(slot_idx)))
+      {
+        cur_batch_ = &batches_[slot_idx];
+        cur_row_ = 0;
+      }
+      else
+      {
+        cur_batch_ = NULL;
+      }
+      if (OB_SUCCESS == ret)
+      {
+        row = &(cur_batch_->rows[cur_row_++]);
+      }
+      return ret;
+    }
+
+    int DumpRowPrefetcher::fill_slot(const int64_t slot_idx, bool &filled)
+    {
+      int ret = OB_SUCCESS;
+      Batch &batch = batches_[slot_idx];
+      batch.row_count = 0;
+      while (ROWS_PER_BATCH > batch.row_count
+            && OB_SUCCESS == (ret = iter_->next_row()))
+      {
+        if (OB_SUCCESS != (ret = iter_->get_row(batch.rows[batch.row_count])))
+        {
+          if (OB_SCHEMA_ERROR == ret)
+          {
+            ret = OB_SUCCESS;
+            continue;
+          }
+          TBSYS_LOG(WARN, "get row fail ret=%d", ret);
+          break;
+        }
+        batch.row_count++;
+      }
+      filled = (0 < batch.row_count);
+      return ret;
+    }
+
     bool SSTableMgr::build_sstable_file_(const uint64_t sstable_id, const ObString &fpaths, const int64_t time_stamp, IRowIterator &iter)
     {
       bool bret = false;
@@ -759,10 +864,12 @@ namespace oceanbase
       else
       {
         MultiFileUtils multi_file_utils;
+        DumpRowPrefetcher prefetcher;
         sstable::ObSSTableWriter sstable_writer;
         sstable::ObTrailerParam sstable_trailer_param;
         sstable_writer.set_file_sys(&multi_file_utils);
         sstable_writer.set_dio(sstable_dio_writing());
+        sstable_writer.set_compress_thread_num(ups_main->get_update_server().get_param().sstable_compress_thread_num);
         sstable_trailer_param.compressor_name_ = compressor_str;
         sstable_trailer_param.table_version_ = sstable_id;
         sstable_trailer_param.store_type_ = store_type;
@@ -773,22 +880,21 @@ namespace oceanbase
         {
           TBSYS_LOG(WARN, "sstable create fail ret=%d sstable_id=%lu", tmp_ret, sstable_id);
         }
+        else if (OB_SUCCESS != (tmp_ret = prefetcher.start(iter)))
+        {
+          TBSYS_LOG(WARN, "start row prefetcher fail ret=%d sstable_id=%lu", tmp_ret, sstable_id);
+        }
         else
         {
-          sstable::ObSSTableRow sstable_row;
+          const sstable::ObSSTableRow *row = NULL;
           int64_t approx_space_usage = 0;
-          while (OB_SUCCESS == (tmp_ret = iter.next_row()))
+          int64_t rate_limit = 0;
+          const bool rate_limited = (iter.get_write_rate_limit(rate_limit) && 0 < rate_limit);
+          const int64_t start_time = tbsys::CTimeUtil::getTime();
+          while (OB_SUCCESS == (tmp_ret = prefetcher.next_row(row)))
           {
-            if (OB_SUCCESS != (tmp_ret = iter.get_row(sstable_row)))
-            {
-              if (OB_SCHEMA_ERROR == tmp_ret)
-              {
-                continue;
-              }
-              TBSYS_LOG(WARN, "get row fail ret=%d", tmp_ret);
-              break;
-            }
-            else if (NULL == (rowkey_info = iter.get_rowkey_info(sstable_row.get_table_id())))
+            const sstable::ObSSTableRow &sstable_row = *row;
+            if (NULL == (rowkey_info = iter.get_rowkey_info(sstable_row.get_table_id())))
             {
               TBSYS_LOG(WARN, "get rowkey info failed, table_id=%lu", sstable_row.get_table_id());
               tmp_ret = OB_SCHEMA_ERROR;
@@ -808,6 +914,16 @@ namespace oceanbase
             {
               TBSYS_LOG(DEBUG, "append row succ ret=%d table_id=%lu approx_space_usage=%ld",
                         tmp_ret, sstable_row.get_table_id(), approx_space_usage);
+              if (rate_limited)
+              {
+                // 按已写入的数据量算出应该花费的时间 写得比限速快就等一等
+                const int64_t expect_time = start_time + approx_space_usage * 1000000L / rate_limit;
+                const int64_t cur_time = tbsys::CTimeUtil::getTime();
+                if (cur_time < expect_time)
+                {
+                  usleep(static_cast<useconds_t>(expect_time - cur_time));
+                }
+              }
             }
             if (ObUpsRoleMgr::STOP == ups_main->get_update_server().get_role_mgr().get_state())
             {
@@ -816,6 +932,7 @@ namespace oceanbase
               break;
             }
           }
+          prefetcher.stop();
           iter.reset_iter();
           int64_t trailer_offset = 0;
           int64_t sstable_size = 0;
@@ -1567,6 +1684,20 @@ namespace oceanbase
       return ret;
     }
 
+    uint64_t SSTableMgr::get_clog_id(const uint64_t sstable_id)
+    {
+      uint64_t ret = OB_INVALID_ID;
+      SSTableInfo *sstable_info = NULL;
+      map_lock_.rdlock();
+      if (hash::HASH_EXIST == sstable_info_map_.get(sstable_id, sstable_info)
+          && NULL != sstable_info)
+      {
+        ret = sstable_info->get_clog_id();
+      }
+      map_lock_.unlock();
+      return ret;
+    }
+
     int SSTableMgr::load_sstable_bypass(const uint64_t major_version,
                                         const uint64_t minor_version_start,
                                         const uint64_t minor_version_end,
@@ -1914,6 +2045,69 @@ namespace oceanbase
       return bret;
     }
 
+    int64_t SSTableMgr::get_size_tier_(const int64_t sstable_size, const int64_t fan_in)
+    {
+      int64_t tier = 0;
+      for (int64_t size = sstable_size / MIN_TIER_SSTABLE_SIZE; 0 < size; size /= fan_in)
+      {
+        tier++;
+      }
+      return tier;
+    }
+
+    bool SSTableMgr::pick_minor_compaction(const int64_t *sizes, const int64_t num, const int64_t fan_in,
+                                           int64_t &start_idx)
+    {
+      bool bret = false;
+      if (NULL != sizes
+          && 1 < fan_in
+          && fan_in <= num)
+      {
+        // 同一层级的sstable大小相近 合并它们的写放大最小
+        int64_t same_tier_num = 0;
+        for (int64_t i = 0; i < num; i++)
+        {
+          if (0 < i
+              && get_size_tier_(sizes[i], fan_in) == get_size_tier_(sizes[i - 1], fan_in))
+          {
+            same_tier_num++;
+          }
+          else
+          {
+            same_tier_num = 1;
+          }
+          if (fan_in <= same_tier_num)
+          {
+            start_idx = i + 1 - fan_in;
+            bret = true;
+            break;
+          }
+        }
+        if (!bret
+            && 2 * fan_in < num)
+        {
+          int64_t window_size = 0;
+          int64_t min_window_size = INT64_MAX;
+          for (int64_t i = 0; i < num; i++)
+          {
+            window_size += sizes[i];
+            if (fan_in <= i)
+            {
+              window_size -= sizes[i - fan_in];
+            }
+            if (fan_in - 1 <= i
+                && window_size < min_window_size)
+            {
+              min_window_size = window_size;
+              start_idx = i + 1 - fan_in;
+              bret = true;
+            }
+          }
+        }
+      }
+      return bret;
+    }
+
     const IFileInfo *SSTableMgr::get_fileinfo(const uint64_t sstable_id)
     {
       StoreInfo *ret = NULL;
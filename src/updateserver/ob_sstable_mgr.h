@@ -40,6 +40,7 @@
 #include "common/ob_fileinfo_manager.h"
 #include "common/ob_fetch_runnable.h"
 #include "common/ob_spin_rwlock.h"
+#include "common/ob_read_ahead.h"
 #include "sstable/ob_sstable_row.h"
 #include "sstable/ob_sstable_schema.h"
 #include "ob_ups_utils.h"
@@ -104,6 +105,41 @@ namespace oceanbase
         virtual const common::ObRowkeyInfo *get_rowkey_info(const uint64_t table_id) const = 0;
         virtual bool get_store_type(int &store_type) = 0;
         virtual bool get_block_size(int64_t &block_size) = 0;
+        // 写sstable的限速 单位字节每秒 返回false表示不限速
+        virtual bool get_write_rate_limit(int64_t &rate_limit)
+        {
+          UNUSED(rate_limit);
+          return false;
+        };
+    };
+
+    // 转储时由单独的线程从IRowIterator中迭代出行 与sstable的编码压缩和写盘流水线并行
+    // 行按批交接, 每批最多ROWS_PER_BATCH行, 最多缓存BATCH_NUM批
+    // 调用者提前结束迭代时 或者重置iter之前调用stop()
+    class DumpRowPrefetcher : public common::ObReadAhead
+    {
+      static const int64_t BATCH_NUM = 4;
+      static const int64_t ROWS_PER_BATCH = 16;
+      struct Batch
+      {
+        int64_t row_count;
+        sstable::ObSSTableRow rows[ROWS_PER_BATCH];
+      };
+      public:
+        DumpRowPrefetcher();
+        ~DumpRowPrefetcher();
+      public:
+        // 启动预取线程失败时退化为在调用线程里同步迭代
+        int start(IRowIterator &iter);
+        // @return OB_ITER_END表示迭代结束
+        int next_row(const sstable::ObSSTableRow *&row);
+      protected:
+        virtual int fill_slot(const int64_t slot_idx, bool &filled);
+      private:
+        IRowIterator *iter_;
+        Batch *batches_;
+        Batch *cur_batch_;
+        int64_t cur_row_;
     };
 
     typedef common::ObVector<SSTFileInfo> SSTList;
@@ -349,6 +385,67 @@ namespace oceanbase
       };
     };
 
+    // 按id顺序遍历sstable时选出读取要用的sstable
+    // minor合并出的sstable与转储的sstable版本范围重叠 同一个起点只取覆盖范围最大的
+    // 已经被选中的sstable覆盖的版本直接跳过 合并结果在遍历所持的锁外插入时 读到的总是连续的一组sstable
+    template <typename Item>
+    class CoveringSSTableSelector
+    {
+      public:
+        CoveringSSTableSelector() : pending_id_(), pending_item_(NULL), covered_id_()
+        {
+        };
+      public:
+        // 返回true表示选中了之前暂存的sstable 由selected_id和selected_item返回
+        bool add(const SSTableID &sst_id, Item *item, SSTableID &selected_id, Item *&selected_item)
+        {
+          bool bret = false;
+          if (NULL != pending_item_
+              && sst_id.major_version == pending_id_.major_version
+              && sst_id.minor_version_start == pending_id_.minor_version_start)
+          {
+            pending_id_ = sst_id;
+            pending_item_ = item;
+          }
+          else
+          {
+            if (NULL != pending_item_)
+            {
+              selected_id = pending_id_;
+              selected_item = pending_item_;
+              covered_id_ = pending_id_;
+              pending_item_ = NULL;
+              bret = true;
+            }
+            if (sst_id.major_version != covered_id_.major_version
+                || sst_id.minor_version_start > covered_id_.minor_version_end)
+            {
+              pending_id_ = sst_id;
+              pending_item_ = item;
+            }
+          }
+          return bret;
+        };
+        // 遍历结束后取出最后暂存的sstable
+        bool finish(SSTableID &selected_id, Item *&selected_item)
+        {
+          bool bret = false;
+          if (NULL != pending_item_)
+          {
+            selected_id = pending_id_;
+            selected_item = pending_item_;
+            covered_id_ = pending_id_;
+            pending_item_ = NULL;
+            bret = true;
+          }
+          return bret;
+        };
+      private:
+        SSTableID pending_id_;
+        Item *pending_item_;
+        SSTableID covered_id_;
+    };
+
     struct LoadBypassInfo
     {
       char fname[common::OB_MAX_FILE_NAME_LENGTH];
@@ -368,6 +465,8 @@ namespace oceanbase
     {
       static const int64_t STORE_NUM = 10;
       static const int64_t SSTABLE_NUM = 1024;
+      // 小于这个大小的sstable都属于最低的层级
+      static const int64_t MIN_TIER_SSTABLE_SIZE = 1L * 1024L * 1024L;
       typedef common::hash::ObHashMap<StoreMgr::Handle, int64_t> StoreRefMap;
       typedef common::hash::ObHashMap<uint64_t, SSTableInfo*> SSTableInfoMap;
       typedef common::ObList<ISSTableObserver*> ObserverList;
@@ -416,6 +515,8 @@ namespace oceanbase
         // master调用 用来决定自己的回放点
         // slave调用来传给master
         uint64_t get_max_clog_id();
+        // 返回sstable对应的日志号 sstable不存在时返回OB_INVALID_ID
+        uint64_t get_clog_id(const uint64_t sstable_id);
 
         int load_sstable_bypass(const uint64_t major_version,
                                 const uint64_t minor_version_start,
@@ -430,6 +531,13 @@ namespace oceanbase
 
         static bool sstable_str2id(const char *sstable_str, uint64_t &sstable_id, uint64_t &clog_id);
 
+        // 分层合并minor sstable的策略 sizes为同一个major版本下按版本顺序排列的sstable大小
+        // 选出最老的fan_in个连续且大小在同一层级的sstable 个数超过2倍fan_in时
+        // 退化为选总大小最小的连续fan_in个 保证读取时合并的sstable个数有上限
+        // 返回true表示需要合并[start_idx, start_idx + fan_in)
+        static bool pick_minor_compaction(const int64_t *sizes, const int64_t num, const int64_t fan_in,
+                                          int64_t &start_idx);
+
         inline StoreMgr &get_store_mgr()
         {
           return store_mgr_;
@@ -455,6 +563,7 @@ namespace oceanbase
                                       SSTableInfo &sstable_info, const int64_t time_stamp,
                                       IRowIterator &iter, const CommonSchemaManager *sm);
         bool build_schema_file_(const char *path, const char *fname_substr, const CommonSchemaManager *sm);
+        static int64_t get_size_tier_(const int64_t sstable_size, const int64_t fan_in);
         void add_sstable_file_(const uint64_t sstable_id,
                               const uint64_t clog_id,
                               const StoreMgr::Handle store_handle,
@@ -1014,6 +1014,11 @@ namespace oceanbase
       return ret;
     }
 
+    const sstable::ObSSTableReader *SSTableEntity::get_sstable_reader() const
+    {
+      return sstable_reader_;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
     TableItem::TableItem() : memtable_entity_(*this), sstable_entity_(*this), stat_(UNKNOW),
@@ -1087,6 +1092,11 @@ namespace oceanbase
       return memtable_entity_.get_memtable();
     }
 
+    SSTableEntity &TableItem::get_sstable_entity()
+    {
+      return sstable_entity_;
+    }
+
     int TableItem::init_sstable_meta()
     {
       int ret = OB_SUCCESS;
@@ -1719,7 +1729,16 @@ namespace oceanbase
             if (NULL != table_item)
             {
               SSTableID cur_sst_id = table_item->get_sstable_id();
-              if (!sst_id_checker.continous(cur_sst_id))
+              if (sst_id_checker.major_version == cur_sst_id.major_version
+                  && cur_sst_id.minor_version_start <= sst_id_checker.minor_version_end)
+              {
+                // minor合并出的sstable与转储的sstable版本范围重叠
+                if (sst_id_checker.minor_version_end < cur_sst_id.minor_version_end)
+                {
+                  sst_id_checker.minor_version_end = cur_sst_id.minor_version_end;
+                }
+              }
+              else if (!sst_id_checker.continous(cur_sst_id))
               {
                 TBSYS_LOG(WARN, "sstable id do not continous %s <--> %s", sst_id_checker.log_str(), cur_sst_id.log_str());
                 ret = OB_ERROR;
@@ -2169,6 +2188,9 @@ namespace oceanbase
             TableItemKey key;
             table_map_.set_key_range(handle, start_key_ptr, start_exclude, table_map_.get_max_key(), 0);
             TableItemKey last_key;
+            CoveringSSTableSelector<TableItem> selector;
+            TableItemKey selected_key;
+            TableItem *selected_item = NULL;
             while (ERROR_CODE_OK == table_map_.get_next(handle, key, table_item))
             {
               // if (first
@@ -2184,47 +2206,33 @@ namespace oceanbase
                 is_final_minor = (key.sst_id.major_version > last_key.sst_id.major_version);
                 break;
               }
-              last_key = key;
-              ITableEntity *table_entity = NULL;
-              if (NULL == table_item
-                  || NULL == (table_entity = table_item->get_table_entity(warm_up_percent)))
+              TableItemKey key_end = key;
+              key_end.sst_id.minor_version_start = key.sst_id.minor_version_end;
+              if (0 != start_exclude
+                  && key.sst_id.major_version == sst_id_start.major_version
+                  && key.sst_id.minor_version_start <= sst_id_start.minor_version_start)
               {
-                TBSYS_LOG(WARN, "invalid table_item sstable_id=%lu", key.sst_id.id);
-                ret = OB_UPS_ACQUIRE_TABLE_FAIL;
-                break;
+                // 合并出的sstable包含了不需要读的起始版本
+                continue;
               }
-              else if (active_table_item_ == table_item
-                      && !version_range.border_flag_.is_max_value())
+              if (!less_than(&key_end, end_key_ptr, end_exclude))
               {
-                TBSYS_LOG(WARN, "maybe acquire an active table for daily merge, will fail, version_range=[%s]", range2str(version_range));
-                ret = OB_UPS_TABLE_NOT_FROZEN;
-                break;
+                // 合并出的sstable超出了需要读的结束版本
+                continue;
               }
-              else if (0 != table_list.push_back(table_entity))
+              last_key = key;
+              if (selector.add(key.sst_id, table_item, selected_key.sst_id, selected_item)
+                  && OB_SUCCESS != (ret = acquire_table_item_(version_range, selected_key, selected_item, warm_up_percent,
+                                                              first, sst_id_checker, max_version, table_list)))
               {
-                TBSYS_LOG(WARN, "push to list fail sstable_id=%lu", key.sst_id.id);
-                ret = OB_MEM_OVERFLOW;
                 break;
               }
-              else
-              {
-                table_entity->ref();
-                table_item->inc_ref_cnt();
-                //max_version = key.sst_id.major_version;
-                max_version = key.sst_id.id;
-                if (!first
-                    && !sst_id_checker.continous(key.sst_id))
-                {
-                  TBSYS_LOG(WARN, "sstable id do not continous %s <--> %s", sst_id_checker.log_str(), key.sst_id.log_str());
-                  ret = OB_UPS_ACQUIRE_TABLE_FAIL;
-                  break;
-                }
-                else
-                {
-                  sst_id_checker = key.sst_id;
-                }
-              }
-              first = false;
+            }
+            if (OB_SUCCESS == ret
+                && selector.finish(selected_key.sst_id, selected_item))
+            {
+              ret = acquire_table_item_(version_range, selected_key, selected_item, warm_up_percent,
+                                        first, sst_id_checker, max_version, table_list);
             }
           }
           map_lock_.unlock();
@@ -2238,6 +2246,55 @@ namespace oceanbase
       return ret;
     }
 
+    int TableMgr::acquire_table_item_(const ObVersionRange &version_range,
+                                      const TableItemKey &key,
+                                      TableItem *table_item,
+                                      int64_t &warm_up_percent,
+                                      bool &first,
+                                      SSTableID &sst_id_checker,
+                                      uint64_t &max_version,
+                                      TableList &table_list)
+    {
+      int ret = OB_SUCCESS;
+      ITableEntity *table_entity = NULL;
+      if (NULL == table_item
+          || NULL == (table_entity = table_item->get_table_entity(warm_up_percent)))
+      {
+        TBSYS_LOG(WARN, "invalid table_item sstable_id=%lu", key.sst_id.id);
+        ret = OB_UPS_ACQUIRE_TABLE_FAIL;
+      }
+      else if (active_table_item_ == table_item
+              && !version_range.border_flag_.is_max_value())
+      {
+        TBSYS_LOG(WARN, "maybe acquire an active table for daily merge, will fail, version_range=[%s]", range2str(version_range));
+        ret = OB_UPS_TABLE_NOT_FROZEN;
+      }
+      else if (0 != table_list.push_back(table_entity))
+      {
+        TBSYS_LOG(WARN, "push to list fail sstable_id=%lu", key.sst_id.id);
+        ret = OB_MEM_OVERFLOW;
+      }
+      else
+      {
+        table_entity->ref();
+        table_item->inc_ref_cnt();
+        //max_version = key.sst_id.major_version;
+        max_version = key.sst_id.id;
+        if (!first
+            && !sst_id_checker.continous(key.sst_id))
+        {
+          TBSYS_LOG(WARN, "sstable id do not continous %s <--> %s", sst_id_checker.log_str(), key.sst_id.log_str());
+          ret = OB_UPS_ACQUIRE_TABLE_FAIL;
+        }
+        else
+        {
+          sst_id_checker = key.sst_id;
+        }
+      }
+      first = false;
+      return ret;
+    }
+
     void TableMgr::revert_table(const TableList &table_list)
     {
       if (!inited_)
@@ -2268,6 +2325,199 @@ namespace oceanbase
       return;
     }
 
+    int TableMgr::acquire_minor_compaction(const int64_t fan_in, TableList &table_list, uint64_t &sstable_id)
+    {
+      int ret = OB_SUCCESS;
+      table_list.clear();
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited this=%p", this);
+        ret = OB_NOT_INIT;
+      }
+      else if (1 >= fan_in
+              || MAX_MINOR_COMPACTION_FAN_IN < fan_in)
+      {
+        TBSYS_LOG(WARN, "invalid param fan_in=%ld", fan_in);
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (!sstable_scan_finished_)
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else
+      {
+        // 每个major版本内按读取时会用到的sstable排列 只考虑已经转储的部分
+        TableItem *candidates[MAX_MINOR_COMPACTION_CANDIDATE_NUM];
+        int64_t sizes[MAX_MINOR_COMPACTION_CANDIDATE_NUM];
+        int64_t candidate_num = 0;
+        int64_t start_idx = 0;
+        bool picked = false;
+        bool major_finished = false;
+        uint64_t major_version = 0;
+        map_lock_.rdlock();
+        BtreeReadHandle handle;
+        int btree_ret = ERROR_CODE_OK;
+        if (ERROR_CODE_OK != (btree_ret = table_map_.get_read_handle(handle)))
+        {
+          TBSYS_LOG(WARN, "get read handle fail ret=%d", btree_ret);
+          ret = OB_ERROR;
+        }
+        else
+        {
+          TableItemKey key;
+          TableItem *table_item = NULL;
+          table_map_.set_key_range(handle, table_map_.get_min_key(), 0, table_map_.get_max_key(), 0);
+          while (!picked
+                && ERROR_CODE_OK == table_map_.get_next(handle, key, table_item))
+          {
+            const sstable::ObSSTableReader *sstable_reader = NULL;
+            if (major_version != key.sst_id.major_version)
+            {
+              picked = SSTableMgr::pick_minor_compaction(sizes, candidate_num, fan_in, start_idx);
+              major_version = key.sst_id.major_version;
+              major_finished = false;
+              candidate_num = 0;
+            }
+            if (picked
+                || major_finished)
+            {
+              continue;
+            }
+            if (NULL == table_item
+                || active_table_item_ == table_item
+                || TableItem::DUMPED > table_item->get_stat()
+                || NULL == (sstable_reader = table_item->get_sstable_entity().get_sstable_reader()))
+            {
+              // 没有转储的sstable之后的版本都不合并
+              major_finished = true;
+            }
+            else if (0 < candidate_num
+                    && key.sst_id.minor_version_start
+                      == SSTableID::get_minor_version_start(candidates[candidate_num - 1]->get_sstable_id()))
+            {
+              candidates[candidate_num - 1] = table_item;
+              sizes[candidate_num - 1] = sstable_reader->get_sstable_size();
+            }
+            else if (0 < candidate_num
+                    && key.sst_id.minor_version_start
+                      <= SSTableID::get_minor_version_end(candidates[candidate_num - 1]->get_sstable_id()))
+            {
+              // 已经被合并出的sstable覆盖
+            }
+            else if (MAX_MINOR_COMPACTION_CANDIDATE_NUM <= candidate_num)
+            {
+              major_finished = true;
+            }
+            else
+            {
+              candidates[candidate_num] = table_item;
+              sizes[candidate_num] = sstable_reader->get_sstable_size();
+              candidate_num++;
+            }
+          }
+          if (!picked)
+          {
+            picked = SSTableMgr::pick_minor_compaction(sizes, candidate_num, fan_in, start_idx);
+          }
+          if (!picked)
+          {
+            ret = OB_ENTRY_NOT_EXIST;
+          }
+          else
+          {
+            const uint64_t first_id = candidates[start_idx]->get_sstable_id();
+            const uint64_t last_id = candidates[start_idx + fan_in - 1]->get_sstable_id();
+            sstable_id = SSTableID::get_id(SSTableID::get_major_version(first_id),
+                                           SSTableID::get_minor_version_start(first_id),
+                                           SSTableID::get_minor_version_end(last_id));
+            for (int64_t i = start_idx; OB_SUCCESS == ret && i < start_idx + fan_in; i++)
+            {
+              if (0 != table_list.push_back(&(candidates[i]->get_sstable_entity())))
+              {
+                TBSYS_LOG(WARN, "push to list fail sstable_id=%lu", candidates[i]->get_sstable_id());
+                ret = OB_MEM_OVERFLOW;
+              }
+              else
+              {
+                candidates[i]->inc_ref_cnt();
+              }
+            }
+          }
+        }
+        map_lock_.unlock();
+        if (OB_SUCCESS != ret)
+        {
+          revert_table(table_list);
+          table_list.clear();
+        }
+      }
+      return ret;
+    }
+
+    int TableMgr::finish_minor_compaction(const TableList &table_list, const uint64_t sstable_id, const bool succ)
+    {
+      int ret = OB_SUCCESS;
+      ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
+      bool source_exist = false;
+      if (succ
+          && 0 < table_list.size())
+      {
+        // 合并期间这个major版本可能已经被卸载了
+        TableItem *table_item = NULL;
+        TableItem *source_item = &((*table_list.begin())->get_table_item());
+        const SSTableID source_sst_id = source_item->get_sstable_id();
+        map_lock_.rdlock();
+        source_exist = (ERROR_CODE_OK == table_map_.get(source_sst_id, table_item)
+                        && source_item == table_item);
+        map_lock_.unlock();
+      }
+      if (!inited_)
+      {
+        TBSYS_LOG(WARN, "have not inited this=%p", this);
+        ret = OB_NOT_INIT;
+      }
+      else if (NULL == ups_main)
+      {
+        TBSYS_LOG(ERROR, "get ups main fail");
+        ret = OB_ERROR;
+      }
+      else if (succ
+              && !source_exist)
+      {
+        TBSYS_LOG(WARN, "source sstables have been erased, drop compacted %s", SSTableID::log_str(sstable_id));
+        ups_main->get_update_server().get_sstable_mgr().erase_sstable(sstable_id, true);
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (succ
+              && OB_SUCCESS != (ret = add_sstable(sstable_id)))
+      {
+        TBSYS_LOG(WARN, "add compacted sstable fail ret=%d %s", ret, SSTableID::log_str(sstable_id));
+      }
+      else if (succ)
+      {
+        // 新的sstable加入后读取不会再用到被它覆盖的sstable
+        // 转储出的sstable只包含一个minor版本 保留下来给从中间版本开始读的请求使用
+        SSTableMgr &sstable_mgr = ups_main->get_update_server().get_sstable_mgr();
+        TableList::const_iterator iter;
+        for (iter = table_list.begin(); iter != table_list.end(); iter++)
+        {
+          const uint64_t erase_sstable_id = (*iter)->get_table_item().get_sstable_id();
+          if (SSTableID::get_minor_version_start(erase_sstable_id) != SSTableID::get_minor_version_end(erase_sstable_id))
+          {
+            int tmp_ret = OB_SUCCESS;
+            erase_sstable(erase_sstable_id);
+            if (OB_SUCCESS != (tmp_ret = sstable_mgr.erase_sstable(erase_sstable_id, true)))
+            {
+              TBSYS_LOG(WARN, "erase sstable from sstable_mgr fail ret=%d sstable_id=%lu", tmp_ret, erase_sstable_id);
+            }
+          }
+        }
+        TBSYS_LOG(INFO, "minor compaction done %s source_num=%ld", SSTableID::log_str(sstable_id), table_list.size());
+      }
+      revert_table(table_list);
+      return ret;
+    }
+
     TableItem *TableMgr::get_active_memtable()
     {
       TableItem *ret = NULL;
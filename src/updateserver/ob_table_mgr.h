@@ -353,6 +353,7 @@ namespace oceanbase
         void destroy_sstable_meta();
         void pre_load_sstable_block_index();
         int get_endkey(const uint64_t table_id, common::ObTabletInfo &ci);
+        const sstable::ObSSTableReader *get_sstable_reader() const;
       private:
         uint64_t sstable_id_;
         common::ModulePageAllocator mod_;
@@ -380,6 +381,7 @@ namespace oceanbase
       public:
         ITableEntity *get_table_entity(int64_t &sstable_percent);
         MemTable &get_memtable();
+        SSTableEntity &get_sstable_entity();
         int init_sstable_meta();
         Stat get_stat() const;
         void set_stat(const Stat stat);
@@ -434,6 +436,8 @@ namespace oceanbase
       typedef common::KeyBtree<TableItemKey, TableItem*> TableItemMap;
       typedef common::hash::SimpleAllocer<TableItem> TableItemAllocator;
       static const int64_t MIN_MAJOR_VERSION_KEEP = 2;
+      static const int64_t MAX_MINOR_COMPACTION_FAN_IN = 64;
+      static const int64_t MAX_MINOR_COMPACTION_CANDIDATE_NUM = 1024;
       public:
         enum FreezeType
         {
@@ -464,6 +468,14 @@ namespace oceanbase
         // 释放一组table entity
         void revert_table(const TableList &table_list);
 
+        // 后台合并minor sstable的线程调用 按分层策略在一个major版本已转储的sstable中
+        // 选出fan_in个连续的sstable 加引用后放入table_list sstable_id为合并后的sstable
+        // 返回OB_ENTRY_NOT_EXIST表示没有需要合并的sstable
+        int acquire_minor_compaction(const int64_t fan_in, TableList &table_list, uint64_t &sstable_id);
+        // 合并后的sstable写盘成功后调用 加载新sstable并卸载被它覆盖的合并结果
+        // 转储出的sstable保留 按minor版本起点读取的请求仍然可以用它们 最后释放table_list
+        int finish_minor_compaction(const TableList &table_list, const uint64_t sstable_id, const bool succ);
+
         // 获取当前的活跃内存表
         TableItem *get_active_memtable();
         // 归还活跃表
@@ -545,6 +557,14 @@ namespace oceanbase
                                   const int64_t major_version,
                                   const int64_t minor_version);
         bool less_than(const TableItemKey *v, const TableItemKey *t, int exclusive_equal);
+        int acquire_table_item_(const common::ObVersionRange &version_range,
+                                const TableItemKey &key,
+                                TableItem *table_item,
+                                int64_t &warm_up_percent,
+                                bool &first,
+                                SSTableID &sst_id_checker,
+                                uint64_t &max_version,
+                                TableList &table_list);
       private:
         common::ObILogWriter &log_writer_;
         bool inited_;
@@ -69,6 +69,7 @@ namespace oceanbase
       packet_handler_[OB_UPS_ASYNC_AUTO_FREEZE_MEMTABLE] = phandle_freeze_memtable;
       packet_handler_[OB_UPS_CLEAR_ACTIVE_MEMTABLE] = phandle_clear_active_memtable;
       packet_handler_[OB_UPS_ASYNC_CHECK_CUR_VERSION] = phandle_check_cur_version;
+      packet_handler_[OB_UPS_ASYNC_CHECKPOINT_MEMTABLE] = phandle_checkpoint_memtable;
 
       trans_handler_[OB_NEW_SCAN_REQUEST] = thandle_scan_trans;
       trans_handler_[OB_NEW_GET_REQUEST] = thandle_get_trans;
@@ -119,6 +120,10 @@ namespace oceanbase
       {
         TBSYS_LOG(WARN, "init TransHandlePool fail ret=%d", ret);
       }
+      else if (OB_SUCCESS != (ret = lock_mgr_.init(this)))
+      {
+        TBSYS_LOG(WARN, "init lock mgr fail ret=%d", ret);
+      }
       else
       {
         TBSYS_LOG(INFO, "TransExecutor init succ");
@@ -130,6 +135,7 @@ namespace oceanbase
     {
       TransHandlePool::destroy();
       TransCommitThread::destroy();
+      lock_mgr_.destroy();
       session_mgr_.destroy();
       allocator_.destroy();
     }
@@ -223,7 +229,8 @@ namespace oceanbase
           || OB_UPS_ASYNC_MAJOR_FREEZE_MEMTABLE == pcode
           || OB_UPS_ASYNC_AUTO_FREEZE_MEMTABLE == pcode
           || OB_UPS_CLEAR_ACTIVE_MEMTABLE == pcode
-          || OB_UPS_ASYNC_CHECK_CUR_VERSION == pcode)
+          || OB_UPS_ASYNC_CHECK_CUR_VERSION == pcode
+          || OB_UPS_ASYNC_CHECKPOINT_MEMTABLE == pcode)
       {
         bret = true;
       }
@@ -340,6 +347,13 @@ namespace oceanbase
       bool release_task = true;
       Task *task = (Task*)ptask;
       TransParamData *param = (TransParamData*)pdata;
+      // 从行锁等待队列唤醒的task, 重新执行之后如果行锁仍然空闲要唤醒下一个等待者
+      TEValue *woken_row = NULL;
+      if (NULL != task)
+      {
+        woken_row = task->wait_node.row;
+        task->wait_node.reset();
+      }
       int64_t packet_timewait = (NULL == task || 0 == task->pkt.get_source_timeout()) ?
                                 UPS.get_param().packet_max_wait_time :
                                 task->pkt.get_source_timeout();
@@ -381,7 +395,8 @@ namespace oceanbase
       if (NULL != task)
       {
         if ((OB_SUCCESS != ret && !IS_SQL_ERR(ret) && OB_BEGIN_TRANS_LOCKED != ret)
-            || (OB_SUCCESS != thread_errno() && !IS_SQL_ERR(thread_errno()) && OB_BEGIN_TRANS_LOCKED != thread_errno()))
+            || (OB_SUCCESS != thread_errno() && !IS_SQL_ERR(thread_errno())
+                && OB_BEGIN_TRANS_LOCKED != thread_errno() && OB_UPS_LOCK_WAIT != thread_errno()))
         {
           TBSYS_LOG(WARN, "process fail ret=%d pcode=%d src=%s",
                     (OB_SUCCESS != ret) ? ret : thread_errno(), task->pkt.get_packet_code(), inet_ntoa_r(task->src_addr));
@@ -395,6 +410,56 @@ namespace oceanbase
           allocator_.free(task);
           task = NULL;
         }
+        else if (OB_UPS_LOCK_WAIT == thread_errno())
+        {
+          wait_row_lock_(*task);
+          task = NULL;
+        }
+      }
+      if (NULL != woken_row)
+      {
+        lock_mgr_.wakeup_next(woken_row);
+      }
+    }
+
+    void TransExecutor::wait_row_lock_(Task &task)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_EAGAIN == (ret = lock_mgr_.wait(task.wait_node)))
+      {
+        // 行锁已经释放, 直接重新执行
+        task.wait_node.reset();
+        ret = TransHandlePool::push(&task);
+      }
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "wait row lock fail ret=%d src=%s", ret, inet_ntoa_r(task.src_addr));
+        UPS.response_result(OB_ERR_EXCLUSIVE_LOCK_CONFLICT, task.pkt);
+        allocator_.free(&task);
+      }
+    }
+
+    void TransExecutor::on_lock_wakeup(LockWaitNode &node, const bool timeout)
+    {
+      int ret = OB_SUCCESS;
+      Task *task = (Task*)node.waiter;
+      if (NULL == task)
+      {
+        TBSYS_LOG(ERROR, "lock wait node without task row=%p", node.row);
+      }
+      else if (timeout)
+      {
+        ret = OB_ERR_EXCLUSIVE_LOCK_CONFLICT;
+      }
+      else if (OB_SUCCESS != (ret = TransHandlePool::push(task)))
+      {
+        TBSYS_LOG(WARN, "push lock waiter to trans handle pool fail ret=%d src=%s", ret, inet_ntoa_r(task->src_addr));
+        ret = OB_ERR_EXCLUSIVE_LOCK_CONFLICT;
+      }
+      if (OB_SUCCESS != ret && NULL != task)
+      {
+        UPS.response_result(ret, task->pkt);
+        allocator_.free(task);
       }
     }
 
@@ -656,8 +721,11 @@ namespace oceanbase
                                 UPS.get_param().packet_max_wait_time :
                                 task.pkt.get_source_timeout();
       int64_t process_timeout = packet_timewait - QUERY_TIMEOUT_RESERVE;
-      int64_t pos = task.pkt.get_buffer()->get_position();
+      const int64_t pkt_pos = task.pkt.get_buffer()->get_position();
+      int64_t pos = pkt_pos;
+      int64_t last_stmt_start_time = 0;
       bool with_sid = false;
+      LockWaitCtx &wait_ctx = LockMgr::get_tsi_wait_ctx();
       task.sid.reset();
       if (!UPS.is_master_lease_valid())
       {
@@ -723,6 +791,7 @@ namespace oceanbase
       {}
       else
       {
+        last_stmt_start_time = session_ctx->get_stmt_start_time();
         session_ctx->set_stmt_start_time(task.pkt.get_receive_ts());
         session_ctx->set_stmt_timeout(process_timeout);
         sql::ObPhyOperator *main_op = NULL;
@@ -745,6 +814,9 @@ namespace oceanbase
           FILL_TRACE_BUF(session_ctx->get_tlog_buffer(), "phyplan allocator used=%ld total=%ld %s",
                         allocator.used(), allocator.total(), to_cstring(phy_plan));
         }
+        wait_ctx.reset();
+        wait_ctx.enable = UPS.get_param().enable_lock_wait_queue && lock_mgr_.is_inited();
+        wait_ctx.trans_restartable = !with_sid;
         if (OB_SUCCESS != ret)
         {}
         else if (NULL == (main_op = phy_plan.get_main_query()))
@@ -754,7 +826,8 @@ namespace oceanbase
         }
         else if (OB_SUCCESS != (ret = main_op->open()))
         {
-          if (OB_ERR_PRIMARY_KEY_DUPLICATE != ret)
+          if (OB_ERR_PRIMARY_KEY_DUPLICATE != ret
+              && OB_UPS_LOCK_WAIT != ret)
           {
             OB_STAT_INC(UPDATESERVER, UPS_STAT_APPLY_FAIL_COUNT, 1);
             TBSYS_LOG(WARN, "main_op open fail ret=%d", ret);
@@ -771,6 +844,7 @@ namespace oceanbase
           fill_warning_strings_(session_ctx->get_ups_result());
           TBSYS_LOG(DEBUG, "precommit end timeu=%ld", tbsys::CTimeUtil::getTime() - task.pkt.get_receive_ts());
         }
+        wait_ctx.enable = false;
         if (OB_SUCCESS != ret)
         {}
         else if (with_sid || phy_plan.get_start_trans())
@@ -803,14 +877,40 @@ namespace oceanbase
         }
         FILL_TRACE_BUF(session_ctx->get_tlog_buffer(), "ret=%d affected_rows=%ld", ret, session_ctx->get_ups_result().get_affected_rows());
         PRINT_TRACE_BUF(session_ctx->get_tlog_buffer());
-        if (OB_SUCCESS != ret
-            && (!with_sid || !IS_SQL_ERR(ret)))
+        if (OB_UPS_LOCK_WAIT == ret)
+        {
+          // 自动提交的事务整个回滚, 显式事务的这条语句没有写过数据, 保留事务, 唤醒后重新执行语句
+          if (with_sid)
+          {
+            session_ctx->set_stmt_start_time(last_stmt_start_time);
+          }
+          else
+          {
+            end_session_ret = ret;
+          }
+          task.pkt.get_buffer()->get_position() = pkt_pos;
+          task.wait_node.reset();
+          task.wait_node.row = wait_ctx.row;
+          task.wait_node.table_id = wait_ctx.table_id;
+          task.wait_node.sd = wait_ctx.sd;
+          task.wait_node.end_time = wait_ctx.end_time;
+          task.wait_node.waiter = &task;
+          need_free_task = false;
+        }
+        else if (OB_SUCCESS != ret
+                 && (!with_sid || !IS_SQL_ERR(ret)))
         {
           end_session_ret = ret;
           TBSYS_LOG(DEBUG, "need rollback session %s ret=%d", to_cstring(task.sid), ret);
         }
+        if (OB_UPS_LOCK_WAIT != ret
+            && INVALID_SESSION_DESCRIPTOR != wait_ctx.sd)
+        {
+          lock_mgr_.del_wait_for(wait_ctx.sd);
+        }
+        wait_ctx.reset();
       }
-      if (OB_SUCCESS != ret && OB_BEGIN_TRANS_LOCKED != ret)
+      if (OB_SUCCESS != ret && OB_BEGIN_TRANS_LOCKED != ret && OB_UPS_LOCK_WAIT != ret)
       {
         ret = (OB_ERR_SHARED_LOCK_CONFLICT == ret) ? OB_EAGAIN : ret;
         const char *error_string = ob_get_err_msg().ptr();
@@ -1019,6 +1119,7 @@ namespace oceanbase
     {
       const bool force = false;
       session_mgr_.kill_zombie_session(force);
+      lock_mgr_.expire_waiters(tbsys::CTimeUtil::getTime());
     }
 
     void TransExecutor::handle_show_sessions_(ObPacket &pkt,
@@ -1481,6 +1582,13 @@ namespace oceanbase
       UPS.ups_check_cur_version();
     }
 
+    void TransExecutor::phandle_checkpoint_memtable(ObPacket &pkt, ObDataBuffer &buffer)
+    {
+      UNUSED(pkt);
+      UNUSED(buffer);
+      UPS.ups_checkpoint_memtable();
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////
 
     bool TransExecutor::thandle_non_impl(TransExecutor &host, Task &task, TransParamData &pdata)
@@ -97,7 +97,7 @@ namespace oceanbase
         virtual int64_t get_seq(void* task) = 0;
     };
 
-    class TransExecutor : public TransHandlePool, public TransCommitThread
+    class TransExecutor : public TransHandlePool, public TransCommitThread, public ILockWaitCallback
     {
       struct TransParamData
       {
@@ -127,9 +127,11 @@ namespace oceanbase
         common::ObPacket pkt;
         ObTransID sid;
         easy_addr_t src_addr;
+        LockWaitNode wait_node;
         void reset()
         {
           sid.reset();
+          wait_node.reset();
         };
       };
       static const int64_t TASK_QUEUE_LIMIT = 100000;
@@ -166,6 +168,8 @@ namespace oceanbase
         void on_commit_idle();
         int64_t get_seq(void* ptr);
 
+        void on_lock_wakeup(LockWaitNode &node, const bool timeout);
+
         SessionMgr &get_session_mgr() {return session_mgr_;};
         LockMgr &get_lock_mgr() {return lock_mgr_;};
         void log_trans_info() const;
@@ -174,6 +178,7 @@ namespace oceanbase
       private:
         bool handle_in_situ_(const int pcode);
         int push_task_(Task &task);
+        void wait_row_lock_(Task &task);
         bool wait_for_commit_(const int pcode);
 
         int get_session_type(const ObTransID& sid, SessionType& type);
@@ -213,6 +218,7 @@ namespace oceanbase
         static void phandle_freeze_memtable(common::ObPacket &pkt, ObDataBuffer &buffer);
         static void phandle_clear_active_memtable(common::ObPacket &pkt, ObDataBuffer &buffer);
         static void phandle_check_cur_version(common::ObPacket &pkt, ObDataBuffer &buffer);
+        static void phandle_checkpoint_memtable(common::ObPacket &pkt, ObDataBuffer &buffer);
       private:
         static bool thandle_non_impl(TransExecutor &host, Task &task, TransParamData &pdata);
         static bool thandle_scan_trans(TransExecutor &host, Task &task, TransParamData &pdata);
@@ -23,6 +23,8 @@
 #include "common/ob_token.h"
 #include "common/ob_version.h"
 #include "common/ob_log_cursor.h"
+#include "common/ob_numa.h"
+#include "common/ob_huge_page.h"
 #include "sstable/ob_aio_buffer_mgr.h"
 #include "ob_update_server.h"
 #include "ob_ups_utils.h"
@@ -344,6 +346,18 @@ namespace oceanbase
         set_log_sync_delay_stat_param();
       }
 
+      // numa拓扑需要在工作线程启动和memtable分配内存之前初始化
+      if (OB_SUCCESS == err)
+      {
+        err = ObNumaTopology::get_instance().init(config_.numa_aware);
+      }
+
+      // 大页模式需要在memtable和cache分配内存之前设置
+      if (OB_SUCCESS == err)
+      {
+        err = ObHugePagePool::get_instance().init(config_.huge_page_mode);
+      }
+
       if (OB_SUCCESS == err)
       {
         int64_t read_thread_count = config_.read_thread_count;
@@ -357,6 +371,8 @@ namespace oceanbase
         write_thread_queue_.setThreadParameter(1, this, NULL);
         lease_thread_queue_.setThreadParameter(1, this, NULL);
         store_thread_.setThreadParameter(static_cast<int32_t>(store_thread_count), this, NULL);
+        read_thread_queue_.set_numa_aware(config_.numa_aware);
+        store_thread_.set_numa_aware(config_.numa_aware);
       }
 
       if (OB_SUCCESS == err)
@@ -394,6 +410,38 @@ namespace oceanbase
         }
       }
 
+      if (OB_SUCCESS == err)
+      {
+        err = memtable_compactor_.init(table_mgr_.get_table_mgr(), &trans_executor_.get_session_mgr(),
+                                       &trans_executor_.get_lock_mgr(), &config_);
+        if (OB_SUCCESS != err)
+        {
+          TBSYS_LOG(WARN, "memtable compactor init fail, err=%d", err);
+        }
+      }
+
+      if (OB_SUCCESS == err)
+      {
+        err = memtable_checkpointer_.init(&table_mgr_, &trans_executor_.get_session_mgr(), &log_mgr_, &sstable_mgr_, &config_);
+        if (OB_SUCCESS != err)
+        {
+          TBSYS_LOG(WARN, "memtable checkpointer init fail, err=%d", err);
+        }
+        else
+        {
+          log_mgr_.set_memtable_checkpointer(&memtable_checkpointer_);
+        }
+      }
+
+      if (OB_SUCCESS == err)
+      {
+        err = sstable_compactor_.init(table_mgr_.get_table_mgr(), &sstable_mgr_, &config_);
+        if (OB_SUCCESS != err)
+        {
+          TBSYS_LOG(WARN, "sstable compactor init fail, err=%d", err);
+        }
+      }
+
       if (OB_SUCCESS == err)
       {
         if (OB_SUCCESS != (err = ms_list_task_.init(
@@ -465,6 +513,15 @@ namespace oceanbase
       ///日志回放线程
       log_replay_thread_.stop();
 
+      /// memtable合并线程
+      memtable_compactor_.stop();
+
+      /// memtable checkpoint线程
+      memtable_checkpointer_.stop();
+
+      /// minor sstable合并线程
+      sstable_compactor_.stop();
+
       replay_worker_.wait();
       trans_executor_.destroy();
 
@@ -480,6 +537,15 @@ namespace oceanbase
       /// 转储线程
       store_thread_.wait();
 
+      /// memtable合并线程
+      memtable_compactor_.wait();
+
+      /// memtable checkpoint线程
+      memtable_checkpointer_.wait();
+
+      /// minor sstable合并线程
+      sstable_compactor_.wait();
+
       ///日志回放线程
 
       timer_.destroy();
@@ -753,6 +819,15 @@ namespace oceanbase
       ///日志回放线程
       log_replay_thread_.start();
 
+      /// memtable合并线程
+      memtable_compactor_.start();
+
+      /// memtable checkpoint线程
+      memtable_checkpointer_.start();
+
+      /// minor sstable合并线程
+      sstable_compactor_.start();
+
       return ret;
     }
 
@@ -3969,6 +4044,7 @@ namespace oceanbase
       }
       hb_res.status_ = (true == sync) ? ObMsgUpsHeartbeatResp::SYNC : ObMsgUpsHeartbeatResp::NOTSYNC;
       hb_res.obi_role_.set_role(settled_obi_role_.get_role());
+      table_mgr_.get_memtable_usage(hb_res.memtable_used_, hb_res.memtable_limit_);
     }
 
     int ObUpdateServer::submit_check_keep_alive()
@@ -4100,6 +4176,18 @@ namespace oceanbase
       return submit_async_task_(OB_UPS_ASYNC_CHECK_CUR_VERSION, write_thread_queue_, write_task_queue_size_, NULL, NULL);
     }
 
+    int ObUpdateServer::submit_checkpoint_memtable()
+    {
+      int err = OB_SUCCESS;
+      if (ObUpsRoleMgr::MASTER == role_mgr_.get_role()
+          && ObiRole::MASTER == obi_role_.get_role()
+          && ObUpsRoleMgr::ACTIVE == role_mgr_.get_state())
+      {
+        err = submit_async_task_(OB_UPS_ASYNC_CHECKPOINT_MEMTABLE, write_thread_queue_, write_task_queue_size_);
+      }
+      return err;
+    }
+
     int ObUpdateServer::submit_immediately_drop()
     {
       int ret = OB_SUCCESS;
@@ -4420,6 +4508,24 @@ namespace oceanbase
       return table_mgr_.check_cur_version();
     }
 
+    int ObUpdateServer::ups_checkpoint_memtable()
+    {
+      int ret = OB_SUCCESS;
+      if (!(ObiRole::MASTER == obi_role_.get_role()
+            && ObUpsRoleMgr::MASTER == role_mgr_.get_role()
+            && ObUpsRoleMgr::ACTIVE == role_mgr_.get_state()))
+      {
+        TBSYS_LOG(INFO, "not master now, need not checkpoint memtable");
+        ret = OB_NOT_MASTER;
+      }
+      else if (OB_SUCCESS != (ret = memtable_checkpointer_.prepare())
+              && OB_EAGAIN != ret)
+      {
+        TBSYS_LOG(WARN, "prepare memtable checkpoint fail ret=%d", ret);
+      }
+      return ret;
+    }
+
     int ObUpdateServer::ups_erase_sstable(const int32_t version, easy_request_t* req, const uint32_t channel_id)
     {
       int ret = OB_SUCCESS;
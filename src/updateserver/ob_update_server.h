@@ -56,6 +56,9 @@
 #include "ob_obi_slave_stat.h"
 #include "ob_slave_sync_type.h"
 #include "ob_trans_executor.h"
+#include "ob_memtable_compactor.h"
+#include "ob_memtable_checkpoint.h"
+#include "ob_sstable_compactor.h"
 #include "ob_trigger_handler.h"
 #include "ob_util_interface.h"
 #include "common/ob_trace_id.h"
@@ -305,6 +308,7 @@ namespace oceanbase
         void schedule_warm_up_duty();
         int submit_load_bypass(const common::ObPacket *packet);
         int submit_check_cur_version();
+        int submit_checkpoint_memtable();
 
         void apply_conf();
 
@@ -480,6 +484,7 @@ namespace oceanbase
         int ups_load_bypass(const int32_t version,
             easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff, const int pcode);
         int ups_check_cur_version();
+        int ups_checkpoint_memtable();
         int ups_get_bloomfilter(const int32_t version, common::ObDataBuffer& in_buff,
             easy_request_t* req, const uint32_t channel_id, common::ObDataBuffer& out_buff);
         int ups_store_memtable(const int32_t version, common::ObDataBuffer &in_buf,
@@ -665,6 +670,9 @@ namespace oceanbase
         TransExecutor trans_executor_;
         ObLogReplayWorker replay_worker_;
         ObAsyncLogApplier log_applier_;
+        MemTableCompactor memtable_compactor_;
+        MemTableCheckpointer memtable_checkpointer_;
+        SSTableCompactor sstable_compactor_;
     };
   }
 }
@@ -127,14 +127,23 @@ namespace oceanbase
         DEF_TIME(sstable_time_limit, "7d", "remove from memory and dump to trash directory if sstable stay in memory such time");
         DEF_STR(sstable_compressor_name, "none", "sstable compressor name");
         DEF_CAP(sstable_block_size, "4K", "sstable block size");
+        DEF_INT(sstable_compress_thread_num, "2", "[0,16]", "number of threads to compress blocks when dumping or compacting sstable, 0 means compress in the store thread");
         DEF_MOMENT(major_freeze_duty_time, "Disable", OB_CONFIG_DYNAMIC, "major freeze duty time");
         DEF_TIME(min_major_freeze_interval, "1s", "minimal time to generate major freeze version");
         DEF_BOOL(replay_checksum_flag, "True", "memtable checksum when replay");
         DEF_BOOL(allow_write_without_token, "True", "allow write without token");
+        DEF_BOOL(enable_lock_wait_queue, "True", "release the worker thread of a transaction waiting for a row lock and resume it when the lock is released");
 
         DEF_TIME(lsync_fetch_timeout, "5s", "fetch commit log timeout from lsync or master ups");
         DEF_TIME(refresh_lsync_addr_interval, "60s", "interval of slave to refresh lsyncserver-address");
         DEF_INT(max_row_cell_num, "256", "compact cell when cell of row beyond this valud");
+        DEF_TIME(memtable_compact_interval, "0", "interval of background compaction of row version chains in active memtable, 0 to disable");
+        DEF_INT(memtable_compact_chain_length, "16", "[2,]", "background compaction merges row whose version chain is not shorter than this value");
+        DEF_TIME(memtable_checkpoint_interval, "0", "interval of writing checkpoint of active memtable for fast restart, 0 to disable");
+        DEF_INT(memtable_checkpoint_load_thread_num, "4", "[1,8]", "number of threads to load memtable checkpoint when restart");
+        DEF_TIME(minor_compact_interval, "0", "interval of background tiered compaction of minor sstables, 0 to disable");
+        DEF_INT(minor_compact_fan_in, "4", "[2,64]", "number of consecutive minor sstables of the same size tier merged by one compaction");
+        DEF_CAP(minor_compact_rate_limit, "20MB", "bytes per second written by minor sstable compaction, 0 for no limit");
         DEF_CAP(table_available_warn_size, "0", "try drop frozen table if available table memory less than this value"); /* calc later */
         DEF_CAP(table_available_error_size, "0", "force drop frozen table and give an alarm if available table memory less than this value"); /* calc later */
 
@@ -22,6 +22,7 @@
 #include "common/utility.h"
 #include "common/ob_delay_guard.h"
 #include "ob_update_server_main.h"
+#include "ob_memtable_checkpoint.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::updateserver;
@@ -149,6 +150,7 @@ ObUpsLogMgr::ObUpsLogMgr(): log_buffer_for_fetch_(LOG_BUFFER_SIZE), log_buffer_f
 {
   table_mgr_ = NULL;
   role_mgr_ = NULL;
+  memtable_checkpointer_ = NULL;
   stop_ = false;
   last_receive_log_time_ = 0;
   master_getter_ = NULL;
@@ -328,6 +330,10 @@ int ObUpsLogMgr::replay_local_log()
 {
   int err = OB_SUCCESS;
   ObLogCursor end_cursor;
+  int64_t start_time = tbsys::CTimeUtil::getTime();
+  int64_t locate_timeu = 0;
+  int64_t load_timeu = 0;
+  int64_t checkpoint_rows = 0;
   uint64_t log_file_id_by_sst = get_max_file_id_by_sst();
   if (!is_inited())
   {
@@ -347,6 +353,31 @@ int ObUpsLogMgr::replay_local_log()
     TBSYS_LOG(ERROR, "get_replay_point_func(log_dir=%s)=>%d", log_dir_, err);
   }
   TBSYS_LOG(INFO, "get_replay_point(file_id=%ld)", start_cursor_.file_id_);
+  locate_timeu = tbsys::CTimeUtil::getTime() - start_time;
+
+  // 加载memtable checkpoint成功后只需从checkpoint切换出的日志文件开始回放
+  if (OB_SUCCESS != err || start_cursor_.file_id_ <= 0 || NULL == memtable_checkpointer_)
+  {}
+  else
+  {
+    int64_t checkpoint_file_id = 0;
+    err = memtable_checkpointer_->load(start_cursor_.file_id_, checkpoint_file_id, checkpoint_rows);
+    if (OB_ENTRY_NOT_EXIST == err)
+    {
+      err = OB_SUCCESS;
+    }
+    else if (OB_SUCCESS != err)
+    {
+      TBSYS_LOG(ERROR, "load_memtable_checkpoint(replay_file_id=%ld)=>%d", start_cursor_.file_id_, err);
+    }
+    else
+    {
+      TBSYS_LOG(INFO, "load_memtable_checkpoint(replay_file_id=%ld): start replay from file_id=%ld",
+                start_cursor_.file_id_, checkpoint_file_id);
+      start_cursor_.file_id_ = checkpoint_file_id;
+    }
+  }
+  load_timeu = tbsys::CTimeUtil::getTime() - start_time - locate_timeu;
 
   // 可能会有单个空文件存在
   if (OB_SUCCESS != err || start_cursor_.file_id_ <= 0) 
@@ -393,6 +424,13 @@ int ObUpsLogMgr::replay_local_log()
   {
     role_mgr_->set_state(ObUpsRoleMgr::FATAL);
   }
+  else
+  {
+    int64_t total_timeu = tbsys::CTimeUtil::getTime() - start_time;
+    TBSYS_LOG(INFO, "replay local log done: locate_replay_point_timeu=%ld load_checkpoint_timeu=%ld checkpoint_rows=%ld "
+              "replay_log_timeu=%ld total_timeu=%ld",
+              locate_timeu, load_timeu, checkpoint_rows, total_timeu - locate_timeu - load_timeu, total_timeu);
+  }
   return err;
 }
 
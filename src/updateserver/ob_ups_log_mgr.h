@@ -45,6 +45,7 @@ namespace oceanbase
   }
   namespace updateserver
   {
+    class MemTableCheckpointer;
     class ObUpsLogMgr : public common::ObLogWriter
     {
       public:
@@ -133,6 +134,11 @@ namespace oceanbase
         // 取得recent_log_cache的引用
       ObLogBuffer& get_log_buffer();
       public: // 主要接口
+        // 设置后重放本地日志时先尝试加载memtable checkpoint
+      void set_memtable_checkpointer(MemTableCheckpointer *memtable_checkpointer)
+      {
+        memtable_checkpointer_ = memtable_checkpointer;
+      }
         // UPS刚启动，重放本地日志任务的函数
       int replay_local_log();
       int start_log(const ObLogCursor& start_cursor);
@@ -258,6 +264,7 @@ namespace oceanbase
         tbsys::CThreadCond master_log_id_cond_;
         int64_t last_receive_log_time_;
         ObLogReplayPoint replay_point_;
+        MemTableCheckpointer *memtable_checkpointer_;
       uint64_t max_log_id_;
       bool is_initialized_;
       char log_dir_[common::OB_MAX_FILE_NAME_LENGTH];
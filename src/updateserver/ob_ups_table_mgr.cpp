@@ -563,6 +563,44 @@ namespace oceanbase
       return ret;
     }
 
+    int ObUpsTableMgr :: replay_checkpoint_freeze(const uint64_t active_version,
+                                                 const uint64_t clog_id,
+                                                 const CommonSchemaManagerWrapper &schema_manager)
+    {
+      int ret = OB_SUCCESS;
+      uint64_t frozen_version = SSTableID::get_id(table_mgr_.get_cur_major_version(),
+                                                  table_mgr_.get_cur_minor_version(),
+                                                  table_mgr_.get_cur_minor_version());
+      ObUpdateServerMain *ups_main = ObUpdateServerMain::get_instance();
+      if (NULL == ups_main)
+      {
+        TBSYS_LOG(WARN, "get ups main fail");
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = schema_mgr_.set_schema_mgr(schema_manager)))
+      {
+        TBSYS_LOG(WARN, "set schema fail ret=%d schema_version=%ld", ret, schema_manager.get_version());
+      }
+      else if (OB_SUCCESS != (ret = table_mgr_.replay_freeze_memtable(active_version, frozen_version, clog_id)))
+      {
+        TBSYS_LOG(WARN, "replay freeze memtable fail ret=%d active_version=%s frozen_version=%s clog_id=%lu",
+                  ret, SSTableID::log_str(active_version), SSTableID::log_str(frozen_version), clog_id);
+      }
+      else
+      {
+        has_started_ = true;
+        if (SSTableID::get_major_version(active_version) != SSTableID::get_major_version(frozen_version))
+        {
+          ups_main->get_update_server().submit_report_freeze();
+        }
+        ups_main->get_update_server().submit_handle_frozen();
+        TBSYS_LOG(INFO, "replay checkpoint freeze active_version=%s frozen_version=%s clog_id=%lu",
+                  SSTableID::log_str(active_version), SSTableID::log_str(frozen_version), clog_id);
+      }
+      log_table_info();
+      return ret;
+    }
+
     int ObUpsTableMgr :: replay(ObUpsMutator &ups_mutator, const ReplayType replay_type)
     {
       int ret = OB_SUCCESS;
@@ -1075,6 +1113,21 @@ namespace oceanbase
       }
     }
 
+    void ObUpsTableMgr :: get_memtable_usage(int64_t &used, int64_t &limit)
+    {
+      used = 0;
+      limit = 0;
+      TableItem *table_item = table_mgr_.get_active_memtable();
+      if (NULL != table_item)
+      {
+        MemTableAttr memtable_attr;
+        table_mgr_.get_memtable_attr(memtable_attr);
+        used = table_item->get_memtable().used() + table_mgr_.get_frozen_memused();
+        limit = memtable_attr.total_memlimit;
+        table_mgr_.revert_active_memtable(table_item);
+      }
+    }
+
     int ObUpsTableMgr :: set_schemas(const CommonSchemaManagerWrapper &schema_manager)
     {
       int ret = OB_SUCCESS;
@@ -199,6 +199,10 @@ namespace oceanbase
         int replay_mgt_mutator(ObUpsMutator& ups_mutator, const ReplayType replay_type);
         int set_schemas(const CommonSchemaManagerWrapper &schema_manager);
         int switch_schemas(const CommonSchemaManagerWrapper &schema_manager);
+        // 从memtable checkpoint恢复时代替被跳过的freeze日志: 设置schema并把活跃表切到checkpoint时的版本
+        int replay_checkpoint_freeze(const uint64_t active_version,
+                                     const uint64_t clog_id,
+                                     const CommonSchemaManagerWrapper &schema_manager);
         int get_active_memtable_version(uint64_t &version);
         int get_last_frozen_memtable_version(uint64_t &version);
         int get_table_time_stamp(const uint64_t major_version, int64_t &time_stamp);
@@ -279,6 +283,7 @@ namespace oceanbase
         void set_memtable_attr(const MemTableAttr &memtable_attr);
         int get_memtable_attr(MemTableAttr &memtable_attr);
         void update_memtable_stat_info();
+        void get_memtable_usage(int64_t &used, int64_t &limit);
         int clear_active_memtable();
         int sstable_scan_finished(const int64_t minor_num_limit);
         int check_sstable_id();
@@ -0,0 +1,148 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * bench_btree.cpp
+ *
+ * Insert, point get and range scan of the cmbtree used by the memtable.
+ */
+#include <stdlib.h>
+#include <algorithm>
+#include "common/ob_define.h"
+#include "common/cmbtree/btree_base.h"
+#include "ob_bench.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::common::cmbtree;
+using namespace oceanbase::bench;
+
+namespace
+{
+  static const int64_t BTREE_KEY_NUM = 1000000;
+  static const int64_t BTREE_SCAN_LEN = 100;
+
+  class BenchKey
+  {
+    public:
+      BenchKey() : value_(0) {}
+      BenchKey(const int64_t v) : value_(v) {}
+      int64_t operator - (const BenchKey &r) const
+      {
+        return value_ > r.value_ ? 1 : (value_ < r.value_ ? -1 : 0);
+      }
+      const char *to_cstring() const
+      {
+        return "";
+      }
+      int64_t value_;
+  };
+
+  typedef BtreeBase<BenchKey, int64_t> BenchBtree;
+
+  // keys are a permutation of [0, BTREE_KEY_NUM) so inserts land all over the tree
+  inline int64_t permute(const int64_t i)
+  {
+    static const int64_t PRIME = 2654435761L;
+    return (i * PRIME) % BTREE_KEY_NUM;
+  }
+
+  int fill_btree(BenchBtree &btree)
+  {
+    int ret = OB_SUCCESS;
+    if (ERROR_CODE_OK != btree.init())
+    {
+      ret = OB_INIT_FAIL;
+    }
+    for (int64_t i = 0; OB_SUCCESS == ret && i < BTREE_KEY_NUM; i++)
+    {
+      if (ERROR_CODE_OK != btree.put(BenchKey(permute(i)), i))
+      {
+        ret = OB_ERROR;
+      }
+    }
+    return ret;
+  }
+}
+
+OB_BENCH(cmbtree_insert)
+{
+  int ret = OB_SUCCESS;
+  BenchBtree *btree = new BenchBtree();
+  if (ERROR_CODE_OK != btree->init())
+  {
+    ret = OB_INIT_FAIL;
+  }
+  else
+  {
+    // a key is put once per round, rounds after the first overwrite
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      if (ERROR_CODE_OK != btree->put(BenchKey(permute(i % BTREE_KEY_NUM)), i, true))
+      {
+        ret = OB_ERROR;
+      }
+    }
+    ctx.stop_timer();
+  }
+  delete btree;
+  return ret;
+}
+
+OB_BENCH(cmbtree_get)
+{
+  int ret = OB_SUCCESS;
+  BenchBtree *btree = new BenchBtree();
+  int64_t value = 0;
+  if (OB_SUCCESS == (ret = fill_btree(*btree)))
+  {
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      if (ERROR_CODE_OK != btree->get(BenchKey(random() % BTREE_KEY_NUM), value))
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      ob_bench_sink(value);
+    }
+    ctx.stop_timer();
+  }
+  delete btree;
+  return ret;
+}
+
+OB_BENCH(cmbtree_scan_100)
+{
+  int ret = OB_SUCCESS;
+  BenchBtree *btree = new BenchBtree();
+  BenchKey key;
+  int64_t value = 0;
+  if (OB_SUCCESS == (ret = fill_btree(*btree)))
+  {
+    // one op is a scan of BTREE_SCAN_LEN keys
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      BenchBtree::TScanHandle handle;
+      const int64_t start = random() % (BTREE_KEY_NUM - BTREE_SCAN_LEN);
+      if (ERROR_CODE_OK != btree->get_scan_handle(handle)
+          || ERROR_CODE_OK != btree->set_key_range(handle, BenchKey(start), 0,
+                                                   BenchKey(start + BTREE_SCAN_LEN - 1), 0))
+      {
+        ret = OB_ERROR;
+      }
+      while (OB_SUCCESS == ret && ERROR_CODE_OK == btree->get_next(handle, key, value))
+      {
+        ob_bench_sink(value);
+      }
+    }
+    ctx.stop_timer();
+  }
+  delete btree;
+  return ret;
+}
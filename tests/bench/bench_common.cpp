@@ -0,0 +1,292 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * bench_common.cpp
+ *
+ * Benchmarks of ObRowkey compare, crc64, KeyValueCache and ObNewScanner.
+ */
+#include <stdlib.h>
+#include "common/ob_define.h"
+#include "common/ob_object.h"
+#include "common/ob_rowkey.h"
+#include "common/ob_crc64.h"
+#include "common/ob_string.h"
+#include "common/ob_kv_storecache.h"
+#include "common/ob_row.h"
+#include "common/ob_row_desc.h"
+#include "common/ob_new_scanner.h"
+#include "ob_bench.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::bench;
+
+namespace
+{
+  static const int64_t ROWKEY_NUM = 1024;
+  static const int64_t ROWKEY_COL_NUM = 3;
+  static const int64_t VARCHAR_LEN = 16;
+
+  // rowkeys of (int, varchar, int), adjacent keys share the first two columns
+  struct RowkeySet
+  {
+    ObObj objs_[ROWKEY_NUM][ROWKEY_COL_NUM];
+    char strs_[ROWKEY_NUM][VARCHAR_LEN];
+    ObRowkey keys_[ROWKEY_NUM];
+
+    RowkeySet()
+    {
+      for (int64_t i = 0; i < ROWKEY_NUM; i++)
+      {
+        snprintf(strs_[i], VARCHAR_LEN, "user_%010ld", i / 4);
+        ObString str(0, VARCHAR_LEN - 1, strs_[i]);
+        objs_[i][0].set_int(i / 16);
+        objs_[i][1].set_varchar(str);
+        objs_[i][2].set_int(random() % 1000);
+        keys_[i].assign(objs_[i], ROWKEY_COL_NUM);
+      }
+    }
+  };
+
+  void fill_random(char *buf, const int64_t size)
+  {
+    for (int64_t i = 0; i < size; i++)
+    {
+      buf[i] = static_cast<char>(random() % 64 + 'A');
+    }
+  }
+}
+
+OB_BENCH(rowkey_compare)
+{
+  RowkeySet *set = new RowkeySet();
+  ctx.start_timer();
+  for (int64_t i = 0; i < ctx.get_iterations(); i++)
+  {
+    const int64_t idx = i % ROWKEY_NUM;
+    ob_bench_sink(set->keys_[idx].compare(set->keys_[(idx + 1) % ROWKEY_NUM]));
+  }
+  ctx.stop_timer();
+  delete set;
+  return OB_SUCCESS;
+}
+
+static int bench_crc64(ObBenchContext &ctx, const int64_t size)
+{
+  char *buf = new char[size];
+  fill_random(buf, size);
+  ctx.set_bytes_per_op(size);
+  ctx.start_timer();
+  for (int64_t i = 0; i < ctx.get_iterations(); i++)
+  {
+    ob_bench_sink(static_cast<int64_t>(ob_crc64(buf, size)));
+  }
+  ctx.stop_timer();
+  delete [] buf;
+  return OB_SUCCESS;
+}
+
+OB_BENCH(crc64_64B)
+{
+  return bench_crc64(ctx, 64);
+}
+
+OB_BENCH(crc64_64K)
+{
+  return bench_crc64(ctx, 64L * 1024L);
+}
+
+namespace
+{
+  static const int64_t KVCACHE_ITEM_SIZE = 256;
+  static const int64_t KVCACHE_TOTAL_SIZE = 64L * 1024L * 1024L;
+  static const int64_t KVCACHE_KEY_NUM = 64L * 1024L;
+  static const int64_t KVCACHE_VALUE_LEN = 100;
+  typedef KeyValueCache<int64_t, ObString, KVCACHE_ITEM_SIZE> BenchKVCache;
+}
+
+OB_BENCH(kvcache_put)
+{
+  int ret = OB_SUCCESS;
+  char value_buf[KVCACHE_VALUE_LEN];
+  fill_random(value_buf, KVCACHE_VALUE_LEN);
+  ObString value(0, KVCACHE_VALUE_LEN, value_buf);
+  BenchKVCache *cache = new BenchKVCache();
+  if (OB_SUCCESS != (ret = cache->init(KVCACHE_TOTAL_SIZE)))
+  {
+    TBSYS_LOG(WARN, "init kvcache fail ret=%d", ret);
+  }
+  else
+  {
+    ctx.set_bytes_per_op(KVCACHE_VALUE_LEN);
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      ret = cache->put(i % KVCACHE_KEY_NUM, value);
+    }
+    ctx.stop_timer();
+  }
+  delete cache;
+  return ret;
+}
+
+OB_BENCH(kvcache_get)
+{
+  int ret = OB_SUCCESS;
+  char value_buf[KVCACHE_VALUE_LEN];
+  fill_random(value_buf, KVCACHE_VALUE_LEN);
+  ObString value(0, KVCACHE_VALUE_LEN, value_buf);
+  BenchKVCache *cache = new BenchKVCache();
+  if (OB_SUCCESS != (ret = cache->init(KVCACHE_TOTAL_SIZE)))
+  {
+    TBSYS_LOG(WARN, "init kvcache fail ret=%d", ret);
+  }
+  for (int64_t i = 0; OB_SUCCESS == ret && i < KVCACHE_KEY_NUM; i++)
+  {
+    ret = cache->put(i, value);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    ObString got;
+    CacheHandle handle;
+    ctx.set_bytes_per_op(KVCACHE_VALUE_LEN);
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      if (OB_SUCCESS == (ret = cache->get(random() % KVCACHE_KEY_NUM, got, handle)))
+      {
+        ob_bench_sink(got.length());
+        ret = cache->revert(handle);
+      }
+    }
+    ctx.stop_timer();
+  }
+  delete cache;
+  return ret;
+}
+
+namespace
+{
+  static const uint64_t SCANNER_TABLE_ID = 1001;
+  static const int64_t SCANNER_COL_NUM = 8;
+  static const int64_t SCANNER_ROW_NUM = 1000;
+
+  // a scanner holding SCANNER_ROW_NUM rows of int/varchar columns
+  int build_scanner(ObNewScanner &scanner, ObRowDesc &row_desc, char *str_buf)
+  {
+    int ret = OB_SUCCESS;
+    ObRow row;
+    ObObj cell;
+    for (int64_t i = 0; OB_SUCCESS == ret && i < SCANNER_COL_NUM; i++)
+    {
+      ret = row_desc.add_column_desc(SCANNER_TABLE_ID, OB_APP_MIN_COLUMN_ID + i);
+    }
+    row.set_row_desc(row_desc);
+    fill_random(str_buf, VARCHAR_LEN);
+    for (int64_t i = 0; OB_SUCCESS == ret && i < SCANNER_ROW_NUM; i++)
+    {
+      for (int64_t j = 0; OB_SUCCESS == ret && j < SCANNER_COL_NUM; j++)
+      {
+        if (j % 2 == 0)
+        {
+          cell.set_int(i * SCANNER_COL_NUM + j);
+        }
+        else
+        {
+          ObString str(0, VARCHAR_LEN, str_buf);
+          cell.set_varchar(str);
+        }
+        ret = row.set_cell(SCANNER_TABLE_ID, OB_APP_MIN_COLUMN_ID + j, cell);
+      }
+      if (OB_SUCCESS == ret)
+      {
+        ret = scanner.add_row(row);
+      }
+    }
+    if (OB_SUCCESS == ret)
+    {
+      ret = scanner.set_is_req_fullfilled(true, SCANNER_ROW_NUM);
+    }
+    return ret;
+  }
+}
+
+OB_BENCH(new_scanner_serialize)
+{
+  int ret = OB_SUCCESS;
+  ObNewScanner *scanner = new ObNewScanner();
+  ObRowDesc row_desc;
+  char str_buf[VARCHAR_LEN];
+  const int64_t buf_len = OB_MAX_PACKET_LENGTH;
+  char *buf = new char[buf_len];
+  int64_t pos = 0;
+  if (OB_SUCCESS != (ret = build_scanner(*scanner, row_desc, str_buf)))
+  {
+    TBSYS_LOG(WARN, "build scanner fail ret=%d", ret);
+  }
+  else
+  {
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      pos = 0;
+      ret = scanner->serialize(buf, buf_len, pos);
+    }
+    ctx.stop_timer();
+    ctx.set_bytes_per_op(pos);
+  }
+  delete [] buf;
+  delete scanner;
+  return ret;
+}
+
+OB_BENCH(new_scanner_deserialize)
+{
+  int ret = OB_SUCCESS;
+  ObNewScanner *scanner = new ObNewScanner();
+  ObNewScanner *result = new ObNewScanner();
+  ObRowDesc row_desc;
+  ObRow row;
+  char str_buf[VARCHAR_LEN];
+  const int64_t buf_len = OB_MAX_PACKET_LENGTH;
+  char *buf = new char[buf_len];
+  int64_t data_len = 0;
+  int64_t pos = 0;
+  if (OB_SUCCESS != (ret = build_scanner(*scanner, row_desc, str_buf)))
+  {
+    TBSYS_LOG(WARN, "build scanner fail ret=%d", ret);
+  }
+  else if (OB_SUCCESS != (ret = scanner->serialize(buf, buf_len, data_len)))
+  {
+    TBSYS_LOG(WARN, "serialize scanner fail ret=%d", ret);
+  }
+  else
+  {
+    // decode the rows as well, that is what a mergeserver does with a response
+    row.set_row_desc(row_desc);
+    ctx.set_bytes_per_op(data_len);
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      pos = 0;
+      result->reuse();
+      if (OB_SUCCESS == (ret = result->deserialize(buf, data_len, pos)))
+      {
+        while (OB_SUCCESS == (ret = result->get_next_row(row)))
+        {
+        }
+        ret = OB_ITER_END == ret ? OB_SUCCESS : ret;
+      }
+    }
+    ctx.stop_timer();
+  }
+  delete [] buf;
+  delete result;
+  delete scanner;
+  return ret;
+}
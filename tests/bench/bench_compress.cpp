@@ -0,0 +1,128 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * bench_compress.cpp
+ *
+ * Compress and decompress a sstable-block sized buffer with every
+ * compressor sstables may be configured with.
+ */
+#include <stdlib.h>
+#include "tbsys.h"
+#include "common/ob_define.h"
+#include "common/compress/ob_compressor.h"
+#include "ob_bench.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::bench;
+
+namespace
+{
+  static const int64_t COMPRESS_DATA_SIZE = 64L * 1024L;
+
+  // text like data, repeated words from a small dictionary plus some digits,
+  // so the compressors have something to find but not a trivial stream
+  void fill_compressible(char *buf, const int64_t size)
+  {
+    static const char *words[] = {"oceanbase", "tablet", "rowkey", "column", "merge",
+                                  "update", "server", "chunk", "sstable", "range"};
+    static const int64_t WORD_NUM = sizeof(words) / sizeof(words[0]);
+    int64_t pos = 0;
+    while (pos < size)
+    {
+      const char *word = words[random() % WORD_NUM];
+      for (const char *p = word; *p != '\0' && pos < size; p++)
+      {
+        buf[pos++] = *p;
+      }
+      if (pos < size)
+      {
+        buf[pos++] = static_cast<char>('0' + random() % 10);
+      }
+    }
+  }
+
+  int bench_compress(ObBenchContext &ctx, const char *compressor_name, const bool is_decompress)
+  {
+    int ret = OB_SUCCESS;
+    ObCompressor *compressor = create_compressor(compressor_name);
+    char *src = new char[COMPRESS_DATA_SIZE];
+    char *comp_buf = NULL;
+    char *decomp_buf = new char[COMPRESS_DATA_SIZE];
+    int64_t comp_buf_size = 0;
+    int64_t comp_size = 0;
+    int64_t decomp_size = 0;
+    fill_compressible(src, COMPRESS_DATA_SIZE);
+    if (NULL == compressor)
+    {
+      TBSYS_LOG(WARN, "create compressor %s fail", compressor_name);
+      ret = OB_ERROR;
+    }
+    else
+    {
+      comp_buf_size = COMPRESS_DATA_SIZE + compressor->get_max_overflow_size(COMPRESS_DATA_SIZE);
+      comp_buf = new char[comp_buf_size];
+      if (ObCompressor::COM_E_NOERROR != compressor->compress(src, COMPRESS_DATA_SIZE,
+                                                              comp_buf, comp_buf_size, comp_size))
+      {
+        ret = OB_ERROR;
+      }
+    }
+    if (OB_SUCCESS == ret)
+    {
+      ctx.set_bytes_per_op(COMPRESS_DATA_SIZE);
+      ctx.start_timer();
+      for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+      {
+        int err = is_decompress
+          ? compressor->decompress(comp_buf, comp_size, decomp_buf, COMPRESS_DATA_SIZE, decomp_size)
+          : compressor->compress(src, COMPRESS_DATA_SIZE, comp_buf, comp_buf_size, comp_size);
+        if (ObCompressor::COM_E_NOERROR != err)
+        {
+          TBSYS_LOG(WARN, "%s with %s fail err=%d", is_decompress ? "decompress" : "compress",
+                    compressor_name, err);
+          ret = OB_ERROR;
+        }
+      }
+      ctx.stop_timer();
+    }
+    if (NULL != compressor)
+    {
+      destroy_compressor(compressor);
+    }
+    delete [] comp_buf;
+    delete [] decomp_buf;
+    delete [] src;
+    return ret;
+  }
+}
+
+OB_BENCH(compress_lzo)
+{
+  return bench_compress(ctx, "lzo_1.0", false);
+}
+
+OB_BENCH(decompress_lzo)
+{
+  return bench_compress(ctx, "lzo_1.0", true);
+}
+
+OB_BENCH(compress_snappy)
+{
+  return bench_compress(ctx, "snappy_1.0", false);
+}
+
+OB_BENCH(decompress_snappy)
+{
+  return bench_compress(ctx, "snappy_1.0", true);
+}
+
+OB_BENCH(compress_none)
+{
+  return bench_compress(ctx, "none", false);
+}
@@ -0,0 +1,199 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * bench_sql.cpp
+ *
+ * Postfix expression evaluation, ObSort and ObMergeJoin over the
+ * synthetic rows of test::ObFakeTable. The fake table generates its
+ * rows while being iterated, so the operator numbers include that cost.
+ */
+#include "common/ob_define.h"
+#include "common/ob_row.h"
+#include "common/ob_row_desc.h"
+#include "sql/ob_postfix_expression.h"
+#include "sql/ob_sql_expression.h"
+#include "sql/ob_sort.h"
+#include "sql/ob_merge_join.h"
+#include "ob_fake_table.h"
+#include "ob_bench.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::sql;
+using namespace oceanbase::bench;
+
+namespace
+{
+  static const uint64_t EXPR_TABLE_ID = 1001;
+  static const int64_t EXPR_COL_NUM = 4;
+  static const int64_t OPERATOR_ROW_NUM = 10000;
+
+  inline int add_item(ObPostfixExpression &expr, const ObItemType type, const int64_t value)
+  {
+    ExprItem item;
+    item.type_ = type;
+    item.value_.int_ = value;
+    return expr.add_expr_item(item);
+  }
+
+  inline int add_column(ObPostfixExpression &expr, const uint64_t tid, const uint64_t cid)
+  {
+    ExprItem item;
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = tid;
+    item.value_.cell_.cid = cid;
+    return expr.add_expr_item(item);
+  }
+
+  int drain(ObPhyOperator &op)
+  {
+    int ret = OB_SUCCESS;
+    const ObRow *row = NULL;
+    if (OB_SUCCESS == (ret = op.open()))
+    {
+      while (OB_SUCCESS == (ret = op.get_next_row(row)))
+      {
+      }
+      ret = OB_ITER_END == ret ? OB_SUCCESS : ret;
+      int err = op.close();
+      ret = OB_SUCCESS == ret ? err : ret;
+    }
+    return ret;
+  }
+}
+
+OB_BENCH(postfix_expression_calc)
+{
+  int ret = OB_SUCCESS;
+  ObPostfixExpression expr;
+  ObRowDesc row_desc;
+  ObRow row;
+  ObObj cell;
+  const ObObj *result = NULL;
+  for (int64_t i = 0; OB_SUCCESS == ret && i < EXPR_COL_NUM; i++)
+  {
+    ret = row_desc.add_column_desc(EXPR_TABLE_ID, OB_APP_MIN_COLUMN_ID + i);
+  }
+  row.set_row_desc(row_desc);
+  // c0 * 3 + c1 > c2 AND c3 % 2 = 0
+  if (OB_SUCCESS != ret
+      || OB_SUCCESS != (ret = add_column(expr, EXPR_TABLE_ID, OB_APP_MIN_COLUMN_ID))
+      || OB_SUCCESS != (ret = add_item(expr, T_INT, 3))
+      || OB_SUCCESS != (ret = add_item(expr, T_OP_MUL, 2))
+      || OB_SUCCESS != (ret = add_column(expr, EXPR_TABLE_ID, OB_APP_MIN_COLUMN_ID + 1))
+      || OB_SUCCESS != (ret = add_item(expr, T_OP_ADD, 2))
+      || OB_SUCCESS != (ret = add_column(expr, EXPR_TABLE_ID, OB_APP_MIN_COLUMN_ID + 2))
+      || OB_SUCCESS != (ret = add_item(expr, T_OP_GT, 2))
+      || OB_SUCCESS != (ret = add_column(expr, EXPR_TABLE_ID, OB_APP_MIN_COLUMN_ID + 3))
+      || OB_SUCCESS != (ret = add_item(expr, T_INT, 2))
+      || OB_SUCCESS != (ret = add_item(expr, T_OP_MOD, 2))
+      || OB_SUCCESS != (ret = add_item(expr, T_INT, 0))
+      || OB_SUCCESS != (ret = add_item(expr, T_OP_EQ, 2))
+      || OB_SUCCESS != (ret = add_item(expr, T_OP_AND, 2))
+      || OB_SUCCESS != (ret = expr.add_expr_item_end()))
+  {
+    TBSYS_LOG(WARN, "build expression fail ret=%d", ret);
+  }
+  else
+  {
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      for (int64_t j = 0; OB_SUCCESS == ret && j < EXPR_COL_NUM; j++)
+      {
+        cell.set_int(i + j);
+        ret = row.set_cell(EXPR_TABLE_ID, OB_APP_MIN_COLUMN_ID + j, cell);
+      }
+      if (OB_SUCCESS == ret)
+      {
+        ret = expr.calc(row, result);
+      }
+    }
+    ctx.stop_timer();
+  }
+  return ret;
+}
+
+OB_BENCH(sort_10k_rows)
+{
+  int ret = OB_SUCCESS;
+  // one op is a full in-memory sort of OPERATOR_ROW_NUM rows on a random int column
+  for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+  {
+    test::ObFakeTable input;
+    ObSort sort;
+    input.set_row_count(OPERATOR_ROW_NUM);
+    sort.set_mem_size_limit(200L * 1024L * 1024L);
+    if (OB_SUCCESS != (ret = sort.add_sort_column(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID + 11, true))
+        || OB_SUCCESS != (ret = sort.add_sort_column(test::ObFakeTable::TABLE_ID, OB_APP_MIN_COLUMN_ID + 1, false))
+        || OB_SUCCESS != (ret = sort.set_child(0, input)))
+    {
+      TBSYS_LOG(WARN, "init sort fail ret=%d", ret);
+    }
+    else
+    {
+      ctx.start_timer();
+      ret = drain(sort);
+      ctx.stop_timer();
+    }
+  }
+  return ret;
+}
+
+OB_BENCH(merge_join_10k_rows)
+{
+  int ret = OB_SUCCESS;
+  static const uint64_t LEFT_TID = 1001;
+  static const uint64_t RIGHT_TID = 2001;
+  // one op is an inner join of two sorted inputs of OPERATOR_ROW_NUM rows,
+  // every left row matches two right rows: left.c1 = right.c4 (row_idx / 2)
+  for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+  {
+    test::ObFakeTable left_input;
+    test::ObFakeTable right_input;
+    ObMergeJoin merge_join;
+    ObSqlExpression expr;
+    left_input.set_row_count(OPERATOR_ROW_NUM);
+    left_input.set_table_id(LEFT_TID);
+    right_input.set_row_count(OPERATOR_ROW_NUM * 2);
+    right_input.set_table_id(RIGHT_TID);
+    ExprItem item;
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = LEFT_TID;
+    item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID + 1;
+    if (OB_SUCCESS == ret)
+    {
+      ret = expr.add_expr_item(item);
+    }
+    item.value_.cell_.tid = RIGHT_TID;
+    item.value_.cell_.cid = OB_APP_MIN_COLUMN_ID + 4;
+    if (OB_SUCCESS == ret)
+    {
+      ret = expr.add_expr_item(item);
+    }
+    item.type_ = T_OP_EQ;
+    item.value_.int_ = 2;
+    if (OB_SUCCESS != ret
+        || OB_SUCCESS != (ret = expr.add_expr_item(item))
+        || OB_SUCCESS != (ret = expr.add_expr_item_end())
+        || OB_SUCCESS != (ret = merge_join.set_child(0, left_input))
+        || OB_SUCCESS != (ret = merge_join.set_child(1, right_input))
+        || OB_SUCCESS != (ret = merge_join.set_join_type(ObJoin::INNER_JOIN))
+        || OB_SUCCESS != (ret = merge_join.add_equijoin_condition(expr)))
+    {
+      TBSYS_LOG(WARN, "init merge join fail ret=%d", ret);
+    }
+    else
+    {
+      ctx.start_timer();
+      ret = drain(merge_join);
+      ctx.stop_timer();
+    }
+  }
+  return ret;
+}
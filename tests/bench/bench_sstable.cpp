@@ -0,0 +1,195 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * bench_sstable.cpp
+ *
+ * Build and decode a dense sstable block of synthetic rows.
+ */
+#include "common/ob_define.h"
+#include "common/ob_object.h"
+#include "common/ob_rowkey.h"
+#include "sstable/ob_sstable_row.h"
+#include "sstable/ob_sstable_block_builder.h"
+#include "sstable/ob_sstable_block_reader.h"
+#include "sstable/ob_sstable_trailer.h"
+#include "ob_bench.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::sstable;
+using namespace oceanbase::bench;
+
+namespace
+{
+  static const uint64_t BLOCK_TABLE_ID = 1001;
+  static const int64_t BLOCK_ROWKEY_COL_NUM = 2;
+  static const int64_t BLOCK_VALUE_COL_NUM = 8;
+  static const int64_t BLOCK_COL_NUM = BLOCK_ROWKEY_COL_NUM + BLOCK_VALUE_COL_NUM;
+  // about the size of a default 64K sstable block
+  static const int64_t BLOCK_ROW_NUM = 600;
+  static const int64_t BLOCK_INTERNAL_BUF_SIZE = 256L * 1024L;
+
+  int build_row(const int64_t row_idx, ObSSTableRow &row)
+  {
+    int ret = OB_SUCCESS;
+    ObObj obj;
+    row.clear();
+    row.set_table_id(BLOCK_TABLE_ID);
+    row.set_column_group_id(0);
+    for (int64_t i = 0; OB_SUCCESS == ret && i < BLOCK_COL_NUM; i++)
+    {
+      obj.set_int(row_idx * BLOCK_COL_NUM + i);
+      ret = row.add_obj(obj);
+    }
+    return ret;
+  }
+
+  int build_block(ObSSTableBlockBuilder &builder)
+  {
+    int ret = OB_SUCCESS;
+    ObSSTableRow row;
+    if (OB_SUCCESS != (ret = builder.init()))
+    {
+      TBSYS_LOG(WARN, "init block builder fail ret=%d", ret);
+    }
+    for (int64_t i = 0; OB_SUCCESS == ret && i < BLOCK_ROW_NUM; i++)
+    {
+      if (OB_SUCCESS == (ret = build_row(i, row)))
+      {
+        ret = builder.add_row(row);
+      }
+    }
+    if (OB_SUCCESS == ret)
+    {
+      ret = builder.build_block();
+    }
+    return ret;
+  }
+}
+
+OB_BENCH(sstable_block_build)
+{
+  int ret = OB_SUCCESS;
+  ObSSTableRow *rows = new ObSSTableRow[BLOCK_ROW_NUM];
+  ObSSTableBlockBuilder *builder = new ObSSTableBlockBuilder();
+  for (int64_t i = 0; OB_SUCCESS == ret && i < BLOCK_ROW_NUM; i++)
+  {
+    ret = build_row(i, rows[i]);
+  }
+  if (OB_SUCCESS == ret && OB_SUCCESS != (ret = builder->init()))
+  {
+    TBSYS_LOG(WARN, "init block builder fail ret=%d", ret);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    // one op is one row, bytes are the block bytes per row
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      const int64_t idx = i % BLOCK_ROW_NUM;
+      if (0 == idx && i > 0)
+      {
+        if (OB_SUCCESS == (ret = builder->build_block()))
+        {
+          builder->reset();
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        ret = builder->add_row(rows[idx]);
+      }
+    }
+    ctx.stop_timer();
+    if (OB_SUCCESS == ret && builder->get_row_count() > 0)
+    {
+      ctx.set_bytes_per_op(builder->get_block_data_size() / builder->get_row_count());
+    }
+  }
+  delete builder;
+  delete [] rows;
+  return ret;
+}
+
+OB_BENCH(sstable_block_decode)
+{
+  int ret = OB_SUCCESS;
+  ObSSTableBlockBuilder *builder = new ObSSTableBlockBuilder();
+  char *internal_buf = new char[BLOCK_INTERNAL_BUF_SIZE];
+  ObSSTableBlockReader reader;
+  ObSSTableBlockReader::BlockDataDesc block_desc(NULL, BLOCK_ROWKEY_COL_NUM, OB_SSTABLE_STORE_DENSE);
+  if (OB_SUCCESS != (ret = build_block(*builder)))
+  {
+    TBSYS_LOG(WARN, "build block fail ret=%d", ret);
+  }
+  else
+  {
+    ObSSTableBlockReader::BlockData block_data(internal_buf, BLOCK_INTERNAL_BUF_SIZE,
+                                               builder->block_buf(), builder->get_block_data_size());
+    ctx.set_bytes_per_op(builder->get_block_data_size());
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      reader.reset();
+      ret = reader.deserialize(block_desc, block_data);
+    }
+    ctx.stop_timer();
+  }
+  delete [] internal_buf;
+  delete builder;
+  return ret;
+}
+
+OB_BENCH(sstable_block_get_row)
+{
+  int ret = OB_SUCCESS;
+  ObSSTableBlockBuilder *builder = new ObSSTableBlockBuilder();
+  char *internal_buf = new char[BLOCK_INTERNAL_BUF_SIZE];
+  ObSSTableBlockReader reader;
+  ObSSTableBlockReader::BlockDataDesc block_desc(NULL, BLOCK_ROWKEY_COL_NUM, OB_SSTABLE_STORE_DENSE);
+  if (OB_SUCCESS != (ret = build_block(*builder)))
+  {
+    TBSYS_LOG(WARN, "build block fail ret=%d", ret);
+  }
+  else
+  {
+    ObSSTableBlockReader::BlockData block_data(internal_buf, BLOCK_INTERNAL_BUF_SIZE,
+                                               builder->block_buf(), builder->get_block_data_size());
+    ret = reader.deserialize(block_desc, block_data);
+  }
+  if (OB_SUCCESS == ret)
+  {
+    // random point lookup: binary search of the rowkey then decode the row
+    ObObj key_objs[BLOCK_ROWKEY_COL_NUM];
+    ObRowkey key(key_objs, BLOCK_ROWKEY_COL_NUM);
+    ObRowkey row_key;
+    ObObj ids[OB_MAX_COLUMN_NUMBER];
+    ObObj values[OB_MAX_COLUMN_NUMBER];
+    int64_t column_count = 0;
+    ctx.start_timer();
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ctx.get_iterations(); i++)
+    {
+      const int64_t row_idx = random() % BLOCK_ROW_NUM;
+      key_objs[0].set_int(row_idx * BLOCK_COL_NUM);
+      key_objs[1].set_int(row_idx * BLOCK_COL_NUM + 1);
+      ObSSTableBlockReader::const_iterator it = reader.lower_bound(key);
+      if (it == reader.end())
+      {
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else
+      {
+        column_count = OB_MAX_COLUMN_NUMBER;
+        ret = reader.get_row(OB_SSTABLE_STORE_DENSE, it, row_key, ids, values, column_count);
+      }
+    }
+    ctx.stop_timer();
+  }
+  delete [] internal_buf;
+  delete builder;
+  return ret;
+}
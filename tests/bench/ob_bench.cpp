@@ -0,0 +1,239 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_bench.cpp
+ *
+ * Usage: ob_bench [-f filter] [-t min_time_ms] [-T tag] [-o output] [-l]
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include "tbsys.h"
+#include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "ob_bench.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+  namespace bench
+  {
+    volatile int64_t g_bench_sink = 0;
+
+    static int64_t get_time_ns()
+    {
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return ts.tv_sec * 1000000000L + ts.tv_nsec;
+    }
+
+    ObBenchContext::ObBenchContext(const int64_t iterations)
+      : iterations_(iterations), bytes_per_op_(0), start_ns_(0), elapsed_ns_(0), running_(false)
+    {
+    }
+
+    void ObBenchContext::start_timer()
+    {
+      if (!running_)
+      {
+        start_ns_ = get_time_ns();
+        running_ = true;
+      }
+    }
+
+    void ObBenchContext::stop_timer()
+    {
+      if (running_)
+      {
+        elapsed_ns_ += get_time_ns() - start_ns_;
+        running_ = false;
+      }
+    }
+
+    ObBenchRegistry::ObBenchRegistry() : count_(0)
+    {
+    }
+
+    ObBenchRegistry &ObBenchRegistry::get_instance()
+    {
+      static ObBenchRegistry registry;
+      return registry;
+    }
+
+    int ObBenchRegistry::add(const char *name, ObBenchFunc func)
+    {
+      int ret = OB_SUCCESS;
+      if (NULL == name || NULL == func)
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (count_ >= MAX_BENCH_NUM)
+      {
+        fprintf(stderr, "too many benchmarks, %s is dropped\n", name);
+        ret = OB_SIZE_OVERFLOW;
+      }
+      else
+      {
+        names_[count_] = name;
+        funcs_[count_] = func;
+        count_++;
+      }
+      return ret;
+    }
+
+    void ObBenchRegistry::list(FILE *out) const
+    {
+      for (int64_t i = 0; i < count_; i++)
+      {
+        fprintf(out, "%s\n", names_[i]);
+      }
+    }
+
+    int ObBenchRegistry::run(const char *filter, const int64_t min_time_us, const char *tag, FILE *out) const
+    {
+      int ret = OB_SUCCESS;
+      int err = OB_SUCCESS;
+      ObBenchResult result;
+      for (int64_t i = 0; i < count_; i++)
+      {
+        if (NULL != filter && NULL == strstr(names_[i], filter))
+        {
+          continue;
+        }
+        if (OB_SUCCESS != (err = run_one_(names_[i], funcs_[i], min_time_us, result)))
+        {
+          fprintf(stderr, "benchmark %s failed, err=%d\n", names_[i], err);
+          ret = err;
+        }
+        print_result_(result, tag, out);
+      }
+      return ret;
+    }
+
+    int ObBenchRegistry::run_one_(const char *name, ObBenchFunc func, const int64_t min_time_us,
+                                  ObBenchResult &result) const
+    {
+      int ret = OB_SUCCESS;
+      static const int64_t MAX_ITERATIONS = 1000000000L;
+      const int64_t min_time_ns = min_time_us * 1000L;
+      int64_t iterations = 1;
+      memset(&result, 0, sizeof(result));
+      result.name_ = name;
+      while (true)
+      {
+        ObBenchContext ctx(iterations);
+        srand(BENCH_RAND_SEED);
+        srandom(BENCH_RAND_SEED);
+        if (OB_SUCCESS != (ret = func(ctx)))
+        {
+          break;
+        }
+        ctx.stop_timer();
+        int64_t elapsed_ns = ctx.get_elapsed_ns() > 0 ? ctx.get_elapsed_ns() : 1;
+        if (elapsed_ns >= min_time_ns || iterations >= MAX_ITERATIONS)
+        {
+          result.iterations_ = iterations;
+          result.ns_per_op_ = static_cast<double>(elapsed_ns) / static_cast<double>(iterations);
+          result.bytes_per_sec_ = static_cast<double>(ctx.get_bytes_per_op())
+            * static_cast<double>(iterations) * 1e9 / static_cast<double>(elapsed_ns);
+          break;
+        }
+        // aim 20% over the target to avoid one more round, but grow at most 100x at a time
+        int64_t next = static_cast<int64_t>(static_cast<double>(iterations)
+                                            * static_cast<double>(min_time_ns) * 1.2
+                                            / static_cast<double>(elapsed_ns));
+        iterations = std::max(iterations * 2, std::min(iterations * 100, next));
+        iterations = std::min(iterations, MAX_ITERATIONS);
+      }
+      result.ret_ = ret;
+      return ret;
+    }
+
+    void ObBenchRegistry::print_result_(const ObBenchResult &result, const char *tag, FILE *out) const
+    {
+      fprintf(out, "{\"name\":\"%s\",\"tag\":\"%s\",\"ret\":%d,\"iterations\":%ld,"
+              "\"ns_per_op\":%.3f,\"bytes_per_sec\":%.0f}\n",
+              result.name_, NULL == tag ? "" : tag, result.ret_, result.iterations_,
+              result.ns_per_op_, result.bytes_per_sec_);
+      fflush(out);
+    }
+  }
+}
+
+static void print_usage(const char *prog)
+{
+  fprintf(stderr, "Usage: %s [-f filter] [-t min_time_ms] [-T tag] [-o output] [-l]\n"
+          "  -f  only run benchmarks whose name contains filter\n"
+          "  -t  minimum running time of each benchmark in ms, default 1000\n"
+          "  -T  tag written into every result, e.g. the release version\n"
+          "  -o  append results to this file instead of stdout\n"
+          "  -l  list benchmarks and exit\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+  int ret = OB_SUCCESS;
+  const char *filter = NULL;
+  const char *tag = NULL;
+  const char *output = NULL;
+  int64_t min_time_ms = 1000;
+  bool list_only = false;
+  int opt = 0;
+  while (-1 != (opt = getopt(argc, argv, "f:t:T:o:lh")))
+  {
+    switch (opt)
+    {
+      case 'f':
+        filter = optarg;
+        break;
+      case 't':
+        min_time_ms = atol(optarg);
+        break;
+      case 'T':
+        tag = optarg;
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'l':
+        list_only = true;
+        break;
+      default:
+        print_usage(argv[0]);
+        return 1;
+    }
+  }
+
+  ob_init_memory_pool();
+  TBSYS_LOGGER.setLogLevel("ERROR");
+  oceanbase::bench::ObBenchRegistry &registry = oceanbase::bench::ObBenchRegistry::get_instance();
+  FILE *out = stdout;
+  if (list_only)
+  {
+    registry.list(stdout);
+  }
+  else if (NULL != output && NULL == (out = fopen(output, "a")))
+  {
+    fprintf(stderr, "open %s failed, errno=%d\n", output, errno);
+    ret = OB_IO_ERROR;
+  }
+  else
+  {
+    ret = registry.run(filter, min_time_ms * 1000L, tag, out);
+    if (stdout != out)
+    {
+      fclose(out);
+    }
+  }
+  return OB_SUCCESS == ret ? 0 : 1;
+}
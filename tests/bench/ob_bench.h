@@ -0,0 +1,121 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_bench.h
+ *
+ * A tiny microbenchmark harness. Every benchmark is a function
+ * registered with OB_BENCH(name); the harness calls it with a growing
+ * iteration count until one run lasts long enough, then reports the
+ * result as one JSON object per line so that results of different
+ * releases can be diffed or loaded by scripts.
+ *
+ * A benchmark does its setup, then times exactly ctx.get_iterations()
+ * operations between ctx.start_timer() and ctx.stop_timer():
+ *
+ *   OB_BENCH(crc64_4k)
+ *   {
+ *     char buf[4096];
+ *     ctx.set_bytes_per_op(sizeof(buf));
+ *     ctx.start_timer();
+ *     for (int64_t i = 0; i < ctx.get_iterations(); ++i)
+ *     {
+ *       ob_bench_sink(ob_crc64(buf, sizeof(buf)));
+ *     }
+ *     ctx.stop_timer();
+ *     return OB_SUCCESS;
+ *   }
+ */
+#ifndef OCEANBASE_TESTS_BENCH_OB_BENCH_H_
+#define OCEANBASE_TESTS_BENCH_OB_BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace oceanbase
+{
+  namespace bench
+  {
+    // fixed seed so that every run feeds the same synthetic data
+    static const uint32_t BENCH_RAND_SEED = 20130101;
+
+    class ObBenchContext
+    {
+      public:
+        explicit ObBenchContext(const int64_t iterations);
+        inline int64_t get_iterations() const { return iterations_; }
+        inline void set_bytes_per_op(const int64_t bytes) { bytes_per_op_ = bytes; }
+        inline int64_t get_bytes_per_op() const { return bytes_per_op_; }
+        void start_timer();
+        void stop_timer();
+        // elapsed time in ns of all timed sections
+        inline int64_t get_elapsed_ns() const { return elapsed_ns_; }
+      private:
+        int64_t iterations_;
+        int64_t bytes_per_op_;
+        int64_t start_ns_;
+        int64_t elapsed_ns_;
+        bool running_;
+    };
+
+    typedef int (*ObBenchFunc)(ObBenchContext &ctx);
+
+    struct ObBenchResult
+    {
+      const char *name_;
+      int ret_;
+      int64_t iterations_;
+      double ns_per_op_;
+      double bytes_per_sec_;
+    };
+
+    class ObBenchRegistry
+    {
+      public:
+        static const int64_t MAX_BENCH_NUM = 256;
+      public:
+        static ObBenchRegistry &get_instance();
+        int add(const char *name, ObBenchFunc func);
+        // run every benchmark whose name contains filter (NULL means all),
+        // each one is run until it takes at least min_time_us
+        int run(const char *filter, const int64_t min_time_us, const char *tag, FILE *out) const;
+        void list(FILE *out) const;
+      private:
+        ObBenchRegistry();
+        int run_one_(const char *name, ObBenchFunc func, const int64_t min_time_us, ObBenchResult &result) const;
+        void print_result_(const ObBenchResult &result, const char *tag, FILE *out) const;
+      private:
+        const char *names_[MAX_BENCH_NUM];
+        ObBenchFunc funcs_[MAX_BENCH_NUM];
+        int64_t count_;
+    };
+
+    class ObBenchRegister
+    {
+      public:
+        ObBenchRegister(const char *name, ObBenchFunc func)
+        {
+          ObBenchRegistry::get_instance().add(name, func);
+        }
+    };
+
+    // keep the compiler from optimizing away the measured computation
+    extern volatile int64_t g_bench_sink;
+    inline void ob_bench_sink(const int64_t v)
+    {
+      g_bench_sink = g_bench_sink + v;
+    }
+  }
+}
+
+#define OB_BENCH(name) \
+  static int ob_bench_##name(oceanbase::bench::ObBenchContext &ctx); \
+  static oceanbase::bench::ObBenchRegister ob_bench_register_##name(#name, ob_bench_##name); \
+  static int ob_bench_##name(oceanbase::bench::ObBenchContext &ctx)
+
+#endif //OCEANBASE_TESTS_BENCH_OB_BENCH_H_
@@ -0,0 +1,160 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_index_schema.cpp
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "common/ob_schema.h"
+
+using namespace oceanbase::common;
+
+namespace
+{
+  static const uint64_t DATA_TID = 3001;
+  static const uint64_t INDEX_TID = 3002;
+  static const uint64_t C0 = OB_APP_MIN_COLUMN_ID;
+  static const uint64_t C1 = OB_APP_MIN_COLUMN_ID + 1;
+  static const uint64_t C2 = OB_APP_MIN_COLUMN_ID + 2;
+
+  void add_table(ObSchemaManagerV2 &schema, const uint64_t table_id, const char *name,
+      const uint64_t *column_ids, const int64_t column_num,
+      const uint64_t *rowkey_ids, const int64_t rowkey_num, const uint64_t data_table_id)
+  {
+    ObTableSchema table;
+    ObRowkeyInfo rowkey_info;
+    char column_name[OB_MAX_COLUMN_NAME_LENGTH];
+    for (int64_t i = 0; i < rowkey_num; i++)
+    {
+      ObRowkeyColumn column;
+      column.column_id_ = rowkey_ids[i];
+      column.type_ = ObIntType;
+      column.length_ = 8;
+      ASSERT_EQ(OB_SUCCESS, rowkey_info.add_column(column));
+    }
+    table.set_table_id(table_id);
+    table.set_table_name(name);
+    table.set_max_column_id(OB_APP_MIN_COLUMN_ID + 3);
+    table.set_rowkey_info(rowkey_info);
+    if (OB_INVALID_ID != data_table_id)
+    {
+      table.set_index_data_table_id(data_table_id);
+    }
+    ASSERT_EQ(OB_SUCCESS, schema.add_table(table));
+    for (int64_t i = 0; i < column_num; i++)
+    {
+      ObColumnSchemaV2 column;
+      snprintf(column_name, sizeof(column_name), "c%lu", column_ids[i] - OB_APP_MIN_COLUMN_ID);
+      column.set_table_id(table_id);
+      column.set_column_id(column_ids[i]);
+      column.set_column_name(column_name);
+      column.set_column_type(ObIntType);
+      ASSERT_EQ(OB_SUCCESS, schema.add_column(column));
+    }
+  }
+}
+
+// data table t(c0, c1, c2) primary key (c0), index table t_c1(c1, c0) primary key (c1, c0)
+TEST(TestIndexSchema, index_table)
+{
+  static const int64_t BUF_LEN = 1024 * 1024;
+  ObSchemaManagerV2 *schema = new ObSchemaManagerV2(1);
+  ObSchemaManagerV2 *received = new ObSchemaManagerV2();
+  const uint64_t data_columns[] = {C0, C1, C2};
+  const uint64_t data_rowkey[] = {C0};
+  const uint64_t index_rowkey[] = {C1, C0};
+  add_table(*schema, DATA_TID, "t", data_columns, 3, data_rowkey, 1, OB_INVALID_ID);
+  add_table(*schema, INDEX_TID, "t_c1", index_rowkey, 2, index_rowkey, 2, DATA_TID);
+  ASSERT_EQ(OB_SUCCESS, schema->sort_column());
+  ASSERT_TRUE(schema->check_index_tables());
+
+  const ObTableSchema *data_table = schema->get_table_schema(DATA_TID);
+  const ObTableSchema *index_table = schema->get_table_schema(INDEX_TID);
+  ASSERT_FALSE(data_table->is_index_table());
+  ASSERT_EQ(OB_INVALID_ID, data_table->get_index_data_table_id());
+  ASSERT_TRUE(index_table->is_index_table());
+  ASSERT_EQ(DATA_TID, index_table->get_index_data_table_id());
+  // not read until the rootserver sees it built
+  ASSERT_FALSE(index_table->is_index_built());
+  schema->get_table_schema(INDEX_TID)->set_index_built(true);
+  ASSERT_TRUE(index_table->is_index_built());
+  ASSERT_EQ(DATA_TID, index_table->get_index_data_table_id());
+
+  const ObTableSchema *index_tables[OB_MAX_INDEX_TABLE_NUMBER];
+  int64_t index_num = OB_MAX_INDEX_TABLE_NUMBER;
+  ASSERT_EQ(OB_SUCCESS, schema->get_index_tables(DATA_TID, index_tables, index_num));
+  ASSERT_EQ(1, index_num);
+  ASSERT_EQ(index_table, index_tables[0]);
+  index_num = OB_MAX_INDEX_TABLE_NUMBER;
+  ASSERT_EQ(OB_SUCCESS, schema->get_index_tables(INDEX_TID, index_tables, index_num));
+  ASSERT_EQ(0, index_num);
+  index_num = 0;
+  ASSERT_EQ(OB_SIZE_OVERFLOW, schema->get_index_tables(DATA_TID, index_tables, index_num));
+
+  // index metadata survives serialization
+  char *buf = static_cast<char*>(ob_malloc(BUF_LEN, ObModIds::TEST));
+  int64_t pos = 0;
+  ASSERT_EQ(OB_SUCCESS, schema->serialize(buf, BUF_LEN, pos));
+  ASSERT_EQ(schema->get_serialize_size(), pos);
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, received->deserialize(buf, data_len, pos));
+  ASSERT_EQ(data_len, pos);
+  ASSERT_EQ(DATA_TID, received->get_table_schema(INDEX_TID)->get_index_data_table_id());
+  ASSERT_TRUE(received->get_table_schema(INDEX_TID)->is_index_built());
+  ASSERT_FALSE(received->get_table_schema(DATA_TID)->is_index_table());
+
+  ob_free(buf);
+  delete received;
+  delete schema;
+}
+
+TEST(TestIndexSchema, invalid_index_table)
+{
+  const uint64_t data_columns[] = {C0, C1, C2};
+  const uint64_t data_rowkey[] = {C0};
+  // rowkey of index table must end with the rowkey of data table
+  {
+    ObSchemaManagerV2 *schema = new ObSchemaManagerV2(1);
+    const uint64_t index_rowkey[] = {C1, C2};
+    add_table(*schema, DATA_TID, "t", data_columns, 3, data_rowkey, 1, OB_INVALID_ID);
+    add_table(*schema, INDEX_TID, "t_c1", index_rowkey, 2, index_rowkey, 2, DATA_TID);
+    ASSERT_EQ(OB_SUCCESS, schema->sort_column());
+    ASSERT_FALSE(schema->check_index_tables());
+    delete schema;
+  }
+  // index table without index column
+  {
+    ObSchemaManagerV2 *schema = new ObSchemaManagerV2(1);
+    add_table(*schema, DATA_TID, "t", data_columns, 3, data_rowkey, 1, OB_INVALID_ID);
+    add_table(*schema, INDEX_TID, "t_c0", data_rowkey, 1, data_rowkey, 1, DATA_TID);
+    ASSERT_EQ(OB_SUCCESS, schema->sort_column());
+    ASSERT_FALSE(schema->check_index_tables());
+    delete schema;
+  }
+  // data table not exist
+  {
+    ObSchemaManagerV2 *schema = new ObSchemaManagerV2(1);
+    const uint64_t index_rowkey[] = {C1, C0};
+    add_table(*schema, DATA_TID, "t", data_columns, 3, data_rowkey, 1, OB_INVALID_ID);
+    add_table(*schema, INDEX_TID, "t_c1", index_rowkey, 2, index_rowkey, 2, DATA_TID + 10);
+    ASSERT_EQ(OB_SUCCESS, schema->sort_column());
+    ASSERT_FALSE(schema->check_index_tables());
+    delete schema;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,106 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_merge_schedule.cpp
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "common/ob_merge_schedule.h"
+
+using namespace oceanbase::common;
+
+TEST(ObMergeSchedule, empty_releases_all)
+{
+  ObMergeSchedule schedule;
+  ASSERT_EQ(0, schedule.get_group_count());
+  ASSERT_TRUE(schedule.is_table_released(1001));
+  ASSERT_FALSE(schedule.release_group(3));
+}
+
+TEST(ObMergeSchedule, release_group)
+{
+  ObMergeSchedule schedule;
+  ASSERT_EQ(OB_SUCCESS, schedule.add_table(1003, 2));
+  ASSERT_EQ(OB_SUCCESS, schedule.add_table(1001, 0));
+  ASSERT_EQ(OB_SUCCESS, schedule.add_table(1002, 1));
+  ASSERT_NE(OB_SUCCESS, schedule.add_table(OB_INVALID_ID, 0));
+  schedule.finish();
+  schedule.set_frozen_version(5);
+
+  ASSERT_EQ(3, schedule.get_group_count());
+  ASSERT_EQ(3, schedule.get_table_count());
+  ASSERT_EQ(1, schedule.get_table_group(1002));
+  // tables not in plan merge with the first group
+  ASSERT_EQ(0, schedule.get_table_group(2000));
+  ASSERT_FALSE(schedule.is_table_released(1001));
+
+  ASSERT_TRUE(schedule.release_group(0));
+  ASSERT_TRUE(schedule.is_table_released(1001));
+  ASSERT_TRUE(schedule.is_table_released(2000));
+  ASSERT_FALSE(schedule.is_table_released(1002));
+
+  ASSERT_TRUE(schedule.release_group(1));
+  ASSERT_FALSE(schedule.release_group(0));
+  ASSERT_TRUE(schedule.is_table_released(1002));
+  ASSERT_FALSE(schedule.is_table_released(1003));
+
+  ASSERT_TRUE(schedule.release_group(ObMergeSchedule::ALL_GROUP_RELEASED));
+  ASSERT_TRUE(schedule.is_table_released(1003));
+}
+
+TEST(ObMergeSchedule, serialize)
+{
+  char buf[1024];
+  int64_t pos = 0;
+  ObMergeSchedule schedule;
+  ObMergeSchedule result;
+  for (int64_t i = 0; i < 10; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, schedule.add_table(3000 - i, i / 3));
+  }
+  schedule.finish();
+  schedule.set_frozen_version(7);
+  schedule.set_split_param(1L << 30, 4);
+  schedule.release_group(1);
+
+  ASSERT_EQ(OB_SUCCESS, schedule.serialize(buf, sizeof(buf), pos));
+  ASSERT_EQ(schedule.get_serialize_size(), pos);
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, result.deserialize(buf, data_len, pos));
+  ASSERT_EQ(data_len, pos);
+
+  ASSERT_EQ(7, result.get_frozen_version());
+  ASSERT_EQ(1, result.get_released_group());
+  ASSERT_EQ(4, result.get_group_count());
+  ASSERT_EQ(10, result.get_table_count());
+  ASSERT_EQ(1L << 30, result.get_split_tablet_size());
+  ASSERT_EQ(4, result.get_split_range_count());
+  for (int64_t i = 0; i < 10; ++i)
+  {
+    ASSERT_EQ(i / 3, result.get_table_group(3000 - i));
+    ASSERT_EQ(i < 6, result.is_table_released(3000 - i));
+  }
+
+  // truncated data leaves an empty plan which releases all tables
+  pos = 0;
+  ASSERT_NE(OB_SUCCESS, result.deserialize(buf, data_len - 1, pos));
+  ASSERT_EQ(0, result.get_table_count());
+  ASSERT_EQ(0, result.get_split_range_count());
+  ASSERT_TRUE(result.is_table_released(3000));
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
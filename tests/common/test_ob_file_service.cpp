@@ -1,6 +1,7 @@
 #include<gtest/gtest.h>
 #include"common/ob_file_service.h"
 #include"common/ob_file_client.h"
+#include"common/ob_crc64.h"
 #include "common/ob_tbnet_callback.h"
 
 using namespace oceanbase;
@@ -87,6 +88,53 @@ TEST(test_ob_file_service, send_one_file)
   ASSERT_EQ(0, unlink(dest_path));
 }
 
+TEST(test_ob_file_service, read_ahead)
+{
+  time_t t = time(NULL);
+  char src_path[OB_MAX_FILE_NAME_LENGTH];
+  int n = snprintf(src_path, OB_MAX_FILE_NAME_LENGTH, "/tmp/test_ob_file_read_ahead.%ld", t);
+  ASSERT_LT(n,OB_MAX_FILE_NAME_LENGTH);
+  generate_file(src_path, 5);
+  const int64_t file_size = 5 * 1024 * 1024;
+  const int64_t block_size = 1536 * 1024;
+
+  // crc of the whole file read at once
+  char *buf = new char[file_size];
+  FILE *fp = fopen(src_path, "r");
+  ASSERT_TRUE(NULL != fp);
+  ASSERT_EQ(1u, fread(buf, file_size, 1, fp));
+  fclose(fp);
+  uint64_t expect_crc = ob_crc64(buf, file_size);
+
+  ObFileReader file_reader;
+  ASSERT_EQ(OB_SUCCESS, file_reader.open(ObString(0, static_cast<int32_t>(strlen(src_path)), src_path), true));
+  ObFileBlockReadAhead read_ahead;
+  ASSERT_EQ(OB_SUCCESS, read_ahead.start(file_reader, file_size, block_size));
+  const ObFileBlockReadAhead::Block *block = NULL;
+  int64_t offset = 0;
+  int64_t block_count = 0;
+  uint64_t crc = 0;
+  int ret = OB_SUCCESS;
+  while (OB_SUCCESS == (ret = read_ahead.next_block(block)))
+  {
+    ASSERT_EQ(offset, block->offset_);
+    ASSERT_EQ(0, memcmp(buf + offset, block->buf_, block->size_));
+    offset += block->size_;
+    crc = block->crc_;
+    block_count++;
+  }
+  ASSERT_EQ(OB_ITER_END, ret);
+  ASSERT_EQ(OB_ITER_END, read_ahead.next_block(block));
+  ASSERT_EQ(file_size, offset);
+  ASSERT_EQ(4, block_count);
+  ASSERT_EQ(expect_crc, crc);
+  read_ahead.stop();
+  file_reader.close();
+
+  delete [] buf;
+  ASSERT_EQ(0, unlink(src_path));
+}
+
 class ObFileServer : public common::ObSingleServer
 {
   public:
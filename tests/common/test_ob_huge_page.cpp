@@ -0,0 +1,90 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_ob_huge_page.cpp
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "common/ob_huge_page.h"
+#include "common/utility.h"
+
+using namespace oceanbase::common;
+
+static const int64_t BLOCK_SIZE = 2L * 1024L * 1024L + 8;
+
+TEST(TestHugePage, parse_mode)
+{
+  ObHugePageMode mode = HUGE_PAGE_NONE;
+  ASSERT_EQ(OB_SUCCESS, ObHugePagePool::parse_mode("none", mode));
+  ASSERT_EQ(HUGE_PAGE_NONE, mode);
+  ASSERT_EQ(OB_SUCCESS, ObHugePagePool::parse_mode("Transparent", mode));
+  ASSERT_EQ(HUGE_PAGE_TRANSPARENT, mode);
+  ASSERT_EQ(OB_SUCCESS, ObHugePagePool::parse_mode("2m", mode));
+  ASSERT_EQ(HUGE_PAGE_EXPLICIT_2M, mode);
+  ASSERT_EQ(OB_SUCCESS, ObHugePagePool::parse_mode("1G", mode));
+  ASSERT_EQ(HUGE_PAGE_EXPLICIT_1G, mode);
+  ASSERT_NE(OB_SUCCESS, ObHugePagePool::parse_mode("3G", mode));
+  ASSERT_NE(OB_SUCCESS, ObHugePagePool::parse_mode(NULL, mode));
+}
+
+TEST(TestHugePage, none)
+{
+  ObHugePagePool pool;
+  int64_t huge_size = 0;
+  int64_t normal_size = 0;
+  ASSERT_EQ(OB_SUCCESS, pool.init("none"));
+  void *ptr = pool.alloc(BLOCK_SIZE, ObModIds::TEST);
+  ASSERT_TRUE(NULL != ptr);
+  memset(ptr, 0, BLOCK_SIZE);
+  pool.get_mod_usage(ObModIds::TEST, huge_size, normal_size);
+  ASSERT_EQ(0, huge_size);
+  ASSERT_EQ(BLOCK_SIZE, normal_size);
+  pool.free(ptr, ObModIds::TEST);
+  pool.get_mod_usage(ObModIds::TEST, huge_size, normal_size);
+  ASSERT_EQ(0, normal_size);
+}
+
+TEST(TestHugePage, reuse)
+{
+  ObHugePagePool pool;
+  int64_t huge_size = 0;
+  int64_t normal_size = 0;
+  // explicit huge pages are usually not reserved on test machines, the
+  // pool degrades to transparent or normal pages
+  ASSERT_EQ(OB_SUCCESS, pool.init("2M"));
+  void *ptr1 = pool.alloc(BLOCK_SIZE, ObModIds::TEST);
+  void *ptr2 = pool.alloc(BLOCK_SIZE, ObModIds::TEST);
+  void *small = pool.alloc(1024, ObModIds::TEST);
+  ASSERT_TRUE(NULL != ptr1 && NULL != ptr2 && NULL != small);
+  memset(ptr1, 1, BLOCK_SIZE);
+  memset(ptr2, 2, BLOCK_SIZE);
+  pool.get_mod_usage(ObModIds::TEST, huge_size, normal_size);
+  if (HUGE_PAGE_NONE != pool.get_mode())
+  {
+    ASSERT_EQ(2 * upper_align(BLOCK_SIZE, ObHugePagePool::BLOCK_ALIGN_SIZE), huge_size);
+    ASSERT_EQ(1024, normal_size);
+    pool.free(ptr1, ObModIds::TEST);
+    ASSERT_EQ(ptr1, pool.alloc(BLOCK_SIZE, ObModIds::TEST));
+  }
+  pool.free(ptr1, ObModIds::TEST);
+  pool.free(ptr2, ObModIds::TEST);
+  pool.free(small, ObModIds::TEST);
+  pool.get_mod_usage(ObModIds::TEST, huge_size, normal_size);
+  ASSERT_EQ(0, huge_size);
+  ASSERT_EQ(0, normal_size);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
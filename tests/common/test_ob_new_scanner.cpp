@@ -454,6 +454,170 @@ TEST_F(ObNewScannerTest, basic_test)
 
 }
 
+TEST_F(ObNewScannerTest, compact_row_serialize)
+{
+  ObNewScanner plain_scanner;
+  ObNewScanner compact_scanner;
+  const char *cities[] = {"hangzhou", "beijing", "shanghai"};
+
+  char rowkey_buf[100];
+  ObRowkey rowkey;
+
+  ObRowDesc row_desc;
+  for(int64_t i=0;i<5;i++)
+  {
+    OK(row_desc.add_column_desc(TABLE_ID, i + OB_APP_MIN_COLUMN_ID));
+  }
+
+  ObRow row;
+  row.set_row_desc(row_desc);
+
+  ObObj cell;
+  ObString str;
+  for(int64_t j=0;j<100;j++)
+  {
+    sprintf(rowkey_buf, "rowkey_%05ld", j);
+    gen_rowkey(rowkey_buf, arena_, rowkey);
+    cell.set_int(j * 10);
+    OK(row.raw_set_cell(0, cell));
+    str.assign_ptr(const_cast<char *>(cities[j % 3]), (int32_t)strlen(cities[j % 3]));
+    cell.set_varchar(str);
+    OK(row.raw_set_cell(1, cell));
+    cell.set_null();
+    OK(row.raw_set_cell(2, cell));
+    cell.set_precise_datetime(1356969600000000L + j);
+    OK(row.raw_set_cell(3, cell));
+    cell.set_double(static_cast<double>(j) / 2);
+    OK(row.raw_set_cell(4, cell));
+    OK(plain_scanner.add_row(rowkey, row));
+    OK(compact_scanner.add_row(rowkey, row));
+  }
+  OK(plain_scanner.set_is_req_fullfilled(true, 100));
+  OK(compact_scanner.set_is_req_fullfilled(true, 100));
+  compact_scanner.set_use_compact_row(true);
+
+  char *buf = (char *)ob_malloc(2 * 1024 * 1024, ObModIds::TEST);
+  char *plain_buf = (char *)ob_malloc(2 * 1024 * 1024, ObModIds::TEST);
+  int64_t pos = 0;
+  int64_t plain_pos = 0;
+  OK(compact_scanner.serialize(buf, 2 * 1024 * 1024, pos));
+  OK(plain_scanner.serialize(plain_buf, 2 * 1024 * 1024, plain_pos));
+  printf("compact len [%ld], plain len [%ld]\n", pos, plain_pos);
+  ASSERT_LT(pos, plain_pos);
+
+  ObNewScanner scanner2;
+  int64_t data_len = pos;
+  pos = 0;
+  OK(scanner2.deserialize(buf, data_len, pos));
+  ASSERT_EQ(data_len, pos);
+  ASSERT_EQ(100, scanner2.get_row_num());
+
+  const ObRowkey *rk = NULL;
+  const ObObj *value = NULL;
+  uint64_t table_id = OB_INVALID_ID;
+  uint64_t column_id = OB_INVALID_ID;
+  int64_t int_value = 0;
+  ObPreciseDateTime time_value = 0;
+  double double_value = 0;
+  ObString str_value;
+  for(int64_t j=0;j<100;j++)
+  {
+    OK(scanner2.get_next_row(rk, row));
+
+    sprintf(rowkey_buf, "rowkey_%05ld", j);
+    gen_rowkey(rowkey_buf, arena_, rowkey);
+    ASSERT_TRUE(rowkey == *rk);
+
+    OK(row.raw_get_cell(0, value, table_id, column_id));
+    ASSERT_EQ(OB_APP_MIN_COLUMN_ID, column_id);
+    OK(value->get_int(int_value));
+    ASSERT_EQ(j * 10, int_value);
+    OK(row.raw_get_cell(1, value, table_id, column_id));
+    OK(value->get_varchar(str_value));
+    ASSERT_EQ(strlen(cities[j % 3]), (uint64_t)str_value.length());
+    ASSERT_EQ(0, memcmp(cities[j % 3], str_value.ptr(), str_value.length()));
+    OK(row.raw_get_cell(2, value, table_id, column_id));
+    ASSERT_EQ(ObNullType, value->get_type());
+    OK(row.raw_get_cell(3, value, table_id, column_id));
+    OK(value->get_precise_datetime(time_value));
+    ASSERT_EQ(1356969600000000L + j, time_value);
+    OK(row.raw_get_cell(4, value, table_id, column_id));
+    OK(value->get_double(double_value));
+    ASSERT_EQ(static_cast<double>(j) / 2, double_value);
+  }
+  ASSERT_EQ(OB_ITER_END, scanner2.get_next_row(rk, row));
+
+  bool is_fulfilled = false;
+  int64_t fullfilled_row_num = 0;
+  OK(scanner2.get_is_req_fullfilled(is_fulfilled, fullfilled_row_num));
+  ASSERT_TRUE(is_fulfilled);
+  ASSERT_EQ(100, fullfilled_row_num);
+
+  ob_free(buf);
+  ob_free(plain_buf);
+}
+
+TEST_F(ObNewScannerTest, compact_ups_row_serialize)
+{
+  ObNewScanner new_scanner;
+  ObUpsRow ups_row;
+
+  ObRowDesc row_desc;
+  for(uint64_t i=1;i<=4;i++)
+  {
+    OK(row_desc.add_column_desc(TABLE_ID, i));
+  }
+  ups_row.set_row_desc(row_desc);
+
+  ObObj cell;
+  for(int64_t j=0;j<20;j++)
+  {
+    OK(ups_row.reset());
+    ups_row.set_is_delete_row(0 == j % 2);
+    cell.set_int(j, true);
+    OK(ups_row.raw_set_cell(0, cell));
+    cell.set_int(-j);
+    OK(ups_row.raw_set_cell(1, cell));
+    OK(new_scanner.add_row(ups_row));
+  }
+  new_scanner.set_use_compact_row(true);
+
+  char buf[4096];
+  int64_t pos = 0;
+  OK(new_scanner.serialize(buf, sizeof(buf), pos));
+
+  ObNewScanner scanner2;
+  int64_t data_len = pos;
+  pos = 0;
+  OK(scanner2.deserialize(buf, data_len, pos));
+  ASSERT_EQ(data_len, pos);
+
+  ObUpsRow got_ups_row;
+  got_ups_row.set_row_desc(row_desc);
+  const ObObj *value = NULL;
+  uint64_t table_id = OB_INVALID_ID;
+  uint64_t column_id = OB_INVALID_ID;
+  int64_t int_value = 0;
+  for(int64_t j=0;j<20;j++)
+  {
+    OK(scanner2.get_next_row(got_ups_row));
+    ASSERT_EQ(0 == j % 2, got_ups_row.get_is_delete_row());
+    OK(got_ups_row.raw_get_cell(0, value, table_id, column_id));
+    ASSERT_TRUE(value->get_add());
+    OK(value->get_int(int_value));
+    ASSERT_EQ(j, int_value);
+    OK(got_ups_row.raw_get_cell(1, value, table_id, column_id));
+    OK(value->get_int(int_value));
+    ASSERT_EQ(-j, int_value);
+    for(int64_t i=2;i<4;i++)
+    {
+      OK(got_ups_row.raw_get_cell(i, value, table_id, column_id));
+      ASSERT_EQ(ObExtendType, value->get_type());
+      ASSERT_TRUE(ObActionFlag::OP_NOP == value->get_ext());
+    }
+  }
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
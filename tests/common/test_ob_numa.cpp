@@ -0,0 +1,83 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_ob_numa.cpp
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "common/ob_numa.h"
+
+using namespace oceanbase::common;
+
+TEST(TestNumaTopology, parse_cpu_list)
+{
+  cpu_set_t cpus;
+  ASSERT_EQ(OB_SUCCESS, ObNumaTopology::parse_cpu_list("0-3,8,10-11\n", cpus));
+  ASSERT_EQ(7, CPU_COUNT(&cpus));
+  ASSERT_TRUE(CPU_ISSET(0, &cpus));
+  ASSERT_TRUE(CPU_ISSET(3, &cpus));
+  ASSERT_FALSE(CPU_ISSET(4, &cpus));
+  ASSERT_TRUE(CPU_ISSET(8, &cpus));
+  ASSERT_TRUE(CPU_ISSET(11, &cpus));
+
+  ASSERT_EQ(OB_SUCCESS, ObNumaTopology::parse_cpu_list("\n", cpus));
+  ASSERT_EQ(0, CPU_COUNT(&cpus));
+  ASSERT_NE(OB_SUCCESS, ObNumaTopology::parse_cpu_list("a-b", cpus));
+  ASSERT_NE(OB_SUCCESS, ObNumaTopology::parse_cpu_list("3-1", cpus));
+  ASSERT_NE(OB_SUCCESS, ObNumaTopology::parse_cpu_list("0-", cpus));
+  ASSERT_NE(OB_SUCCESS, ObNumaTopology::parse_cpu_list(NULL, cpus));
+}
+
+TEST(TestNumaTopology, disabled)
+{
+  ObNumaTopology topology;
+  char buf[1 << 16];
+  ASSERT_EQ(OB_SUCCESS, topology.init(false));
+  ASSERT_FALSE(topology.is_enabled());
+  ASSERT_EQ(-1, topology.get_current_node());
+  ASSERT_EQ(-1, topology.get_node_by_key(1001));
+  ASSERT_EQ(OB_NOT_INIT, topology.bind_thread(0));
+  ASSERT_EQ(-1, topology.bind_thread_round_robin(3));
+  ASSERT_EQ(OB_SUCCESS, topology.bind_memory(buf, sizeof(buf), ObNumaTopology::LOCAL_NODE));
+  ASSERT_EQ(OB_SUCCESS, topology.bind_memory(buf, sizeof(buf), ObNumaTopology::INTERLEAVE_NODE));
+}
+
+TEST(TestNumaTopology, enabled)
+{
+  ObNumaTopology topology;
+  // falls back to disabled on single node machines
+  ASSERT_EQ(OB_SUCCESS, topology.init(true));
+  if (topology.is_enabled())
+  {
+    const int64_t node_num = topology.get_node_num();
+    ASSERT_LT(1, node_num);
+    for (uint64_t key = 0; key < 100; key++)
+    {
+      ASSERT_EQ(static_cast<int64_t>(key % node_num), topology.get_node_by_key(key));
+    }
+    ASSERT_EQ(1 % node_num, topology.bind_thread_round_robin(1));
+    ASSERT_EQ(1 % node_num, topology.get_current_node());
+    ASSERT_EQ(1, topology.get_node_stat(1 % node_num)->thread_num_);
+    ASSERT_EQ(OB_INVALID_ARGUMENT, topology.bind_thread(node_num));
+    ASSERT_TRUE(NULL == topology.get_node_stat(node_num));
+  }
+  else
+  {
+    ASSERT_EQ(-1, topology.get_node_by_key(1001));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -581,6 +581,67 @@ TEST(ObObj, size_of_obj)
   ASSERT_EQ(16U, sizeof(ObObj));
 }
 
+TEST(ObObj, skip)
+{
+  static const int64_t BUF_SIZE = 4096;
+  static const int64_t OBJ_NUM = 24;
+  char buf[BUF_SIZE];
+  char long_str[200];
+  memset(long_str, 'a', sizeof(long_str));
+  ObObj objs[OBJ_NUM];
+  ObNumber num;
+  int64_t i = 0;
+  objs[i++].set_int(0);
+  objs[i++].set_int(23);
+  objs[i++].set_int(-24);
+  objs[i++].set_int(0x7fffffffffffffff);
+  objs[i++].set_int(12345678, true);
+  objs[i++].set_varchar(ObString(0, 5, const_cast<char*>("hello")));
+  objs[i++].set_varchar(ObString(0, 200, long_str));
+  objs[i++].set_null();
+  objs[i++].set_bool(true);
+  objs[i++].set_float(1.5f);
+  objs[i++].set_float(1.5f, true);
+  objs[i++].set_double(3.14);
+  objs[i++].set_datetime(1);
+  objs[i++].set_datetime(0x7fffffffffff);
+  objs[i++].set_precise_datetime(1234567890123L);
+  objs[i++].set_precise_datetime(1, true);
+  objs[i++].set_modifytime(1234567890123456L);
+  objs[i++].set_createtime(12);
+  objs[i++].set_ext(ObActionFlag::OP_NOP);
+  objs[i++].set_max_value();
+  objs[i++].set_seq();
+  ASSERT_EQ(OB_SUCCESS, num.from("-123456789.123456789"));
+  ASSERT_EQ(OB_SUCCESS, objs[i++].set_decimal(num, 38, 9));
+  objs[i++].set_int(-1);
+  objs[i++].set_varchar(ObString());
+  ASSERT_EQ(OBJ_NUM, i);
+
+  int64_t pos = 0;
+  int64_t ends[OBJ_NUM];
+  for (i = 0; i < OBJ_NUM; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, objs[i].serialize(buf, BUF_SIZE, pos));
+    ends[i] = pos;
+  }
+  const int64_t data_len = pos;
+
+  // skip stops at the same position as deserialize
+  pos = 0;
+  for (i = 0; i < OBJ_NUM; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, ObObj::skip(buf, data_len, pos));
+    ASSERT_EQ(ends[i], pos);
+  }
+  ASSERT_NE(OB_SUCCESS, ObObj::skip(buf, data_len, pos));
+
+  // truncated buffer
+  pos = ends[5];
+  ASSERT_EQ(OB_DESERIALIZE_ERROR, ObObj::skip(buf, ends[6] - 1, pos));
+  ASSERT_EQ(ends[5], pos);
+}
+
 class ObObjDecimalTest: public ::testing::Test
 {
   public:
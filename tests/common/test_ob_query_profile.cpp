@@ -0,0 +1,129 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_ob_query_profile.cpp
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "common/ob_query_profile.h"
+#include "common/ob_new_scanner.h"
+
+using namespace oceanbase::common;
+
+TEST(TestQueryProfile, scanner_rpc_profile)
+{
+  static const int64_t BUF_LEN = 1024 * 1024;
+  char *buf = static_cast<char*>(ob_malloc(BUF_LEN, ObModIds::TEST));
+  ObNewScanner scanner;
+  ObNewScanner result;
+  ObRpcProfile profile;
+  int64_t pos = 0;
+  profile.reset();
+  profile.server_time_ = 1000;
+  profile.ups_time_ = 300;
+  profile.block_cache_hit_ = 7;
+  profile.block_cache_miss_ = 2;
+  profile.io_bytes_ = 8192;
+  scanner.set_rpc_profile(profile);
+  ASSERT_EQ(OB_SUCCESS, scanner.serialize(buf, BUF_LEN, pos));
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, result.deserialize(buf, data_len, pos));
+  ASSERT_EQ(data_len, pos);
+  ASSERT_EQ(1000, result.get_rpc_profile().server_time_);
+  ASSERT_EQ(300, result.get_rpc_profile().ups_time_);
+  ASSERT_EQ(7, result.get_rpc_profile().block_cache_hit_);
+  ASSERT_EQ(2, result.get_rpc_profile().block_cache_miss_);
+  ASSERT_EQ(8192, result.get_rpc_profile().io_bytes_);
+
+  // an empty profile is not sent
+  scanner.clear();
+  ASSERT_TRUE(scanner.get_rpc_profile().is_empty());
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, scanner.serialize(buf, BUF_LEN, pos));
+  data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, result.deserialize(buf, data_len, pos));
+  ASSERT_TRUE(result.get_rpc_profile().is_empty());
+  ob_free(buf);
+}
+
+TEST(TestQueryProfile, operators)
+{
+  ObQueryProfile profile;
+  ObRpcProfile rpc_profile;
+  ObOperatorProfile *op = NULL;
+  profile.start(1, ObString::make_string("select 1"), 0);
+  // sort(limit(merge_join(scan, scan)))
+  ASSERT_TRUE(NULL != (op = profile.add_operator("ObLimit", 0)));
+  op->rows_out_ = 10;
+  ASSERT_TRUE(NULL != (op = profile.add_operator("ObMergeJoin", 1)));
+  op->rows_out_ = 20;
+  ASSERT_TRUE(NULL != (op = profile.add_operator("ObTableRpcScan", 2)));
+  op->rows_out_ = 100;
+  ASSERT_TRUE(NULL != (op = profile.add_operator("ObTableRpcScan", 2)));
+  op->rows_out_ = 50;
+  rpc_profile.reset();
+  rpc_profile.io_bytes_ = 4096;
+  profile.add_rpc(100, rpc_profile);
+  profile.add_rpc(200, rpc_profile);
+  profile.finish(1000);
+  ASSERT_EQ(1000, profile.get_elapsed_time());
+  ASSERT_EQ(10, profile.get_row_count());
+  ASSERT_EQ(4, profile.get_operator_num());
+  ASSERT_EQ(20, profile.get_operator(0).rows_in_);
+  ASSERT_EQ(150, profile.get_operator(1).rows_in_);
+  ASSERT_EQ(0, profile.get_operator(2).rows_in_);
+  ASSERT_EQ(8192, profile.get_rpc_profile().io_bytes_);
+
+  for (int64_t i = profile.get_operator_num(); i < ObQueryProfile::MAX_OPERATOR_NUM; i++)
+  {
+    ASSERT_TRUE(NULL != profile.add_operator("ObProject", 3));
+  }
+  ASSERT_TRUE(NULL == profile.add_operator("ObProject", 3));
+
+  // a new execution gets a new seq and no operator
+  int64_t seq = profile.get_seq();
+  profile.start(2, ObString::make_string("select 2"), 0);
+  ASSERT_NE(seq, profile.get_seq());
+  ASSERT_EQ(0, profile.get_operator_num());
+}
+
+TEST(TestQueryProfile, slow_query_log)
+{
+  ObSlowQueryLog log;
+  ObQueryProfile profile;
+  ObQueryProfile result;
+  ASSERT_EQ(0, log.get_count());
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, log.get(0, result));
+  for (int64_t i = 0; i < ObSlowQueryLog::MAX_SLOW_QUERY_NUM + 10; i++)
+  {
+    profile.start(i, ObString::make_string("select 1"), 0);
+    profile.finish(i);
+    log.add(profile);
+  }
+  ASSERT_EQ(ObSlowQueryLog::MAX_SLOW_QUERY_NUM, log.get_count());
+  // the oldest queries are overwritten
+  ASSERT_EQ(OB_SUCCESS, log.get(0, result));
+  ASSERT_EQ(10, result.get_elapsed_time());
+  ASSERT_EQ(OB_SUCCESS, log.get(ObSlowQueryLog::MAX_SLOW_QUERY_NUM - 1, result));
+  ASSERT_EQ(ObSlowQueryLog::MAX_SLOW_QUERY_NUM + 9, result.get_elapsed_time());
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, log.get(ObSlowQueryLog::MAX_SLOW_QUERY_NUM, result));
+  log.clear();
+  ASSERT_EQ(0, log.get_count());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
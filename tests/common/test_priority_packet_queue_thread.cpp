@@ -21,33 +21,11 @@
 #include "tblog.h"
 #include "priority_packet_queue_thread.h"
 #include "ob_packet.h"
+#include "ob_malloc.h"
 
 using namespace std;
-using namespace tbnet;
 using namespace oceanbase::common;
 
-class TestPacket : public tbnet::Packet
-{
-  public:
-    TestPacket()
-    {
-    }
-    virtual ~TestPacket()
-    {
-    }
-
-  public:
-    virtual bool encode(DataBuffer *)
-    {
-      return false;
-    }
-
-    virtual bool decode(DataBuffer *, PacketHeader *)
-    {
-      return false;
-    }
-};
-
 namespace oceanbase
 {
 namespace tests
@@ -55,6 +33,18 @@ namespace tests
 namespace common
 {
 
+class CountHandler : public ObPacketQueueHandler
+{
+public:
+  CountHandler() : count_(0) {}
+  virtual bool handlePacketQueue(ObPacket *, void *)
+  {
+    __sync_add_and_fetch(&count_, 1);
+    return true;
+  }
+  volatile int64_t count_;
+};
+
 class TestPriorityPacketQueueThread : public ::testing::Test
 {
 public:
@@ -71,20 +61,61 @@ public:
 
 TEST_F(TestPriorityPacketQueueThread, test_push)
 {
-  TestPacket* packet1 = new TestPacket;
-  TestPacket* packet2 = new TestPacket;
+  ObPacket packet1;
+  ObPacket packet2;
   int priority = PriorityPacketQueueThread::NORMAL_PRIV;
   PriorityPacketQueueThread priority_thread;
-  bool res = priority_thread.push(packet1, 1, true, priority);
+  priority_thread.setThreadParameter(1, NULL, NULL);
+  bool res = priority_thread.push(&packet1, 1, true, priority);
   EXPECT_TRUE(res);
-  res = priority_thread.push(packet2, 1, false, priority);
+  res = priority_thread.push(&packet2, 1, false, priority);
   EXPECT_FALSE(res);
-  res = priority_thread.push(packet2, 2, false, priority);
+  res = priority_thread.push(&packet2, 2, false, priority);
   EXPECT_TRUE(res);
 
-  EXPECT_TRUE(((tbnet::Packet*) packet1) == priority_thread.head(priority));
-  EXPECT_TRUE(((tbnet::Packet*) packet2) == priority_thread.tail(priority));
   EXPECT_EQ(2, (int) priority_thread.size(priority));
+  EXPECT_EQ(0, (int) priority_thread.size(PriorityPacketQueueThread::LOW_PRIV));
+  EXPECT_EQ(2, (int) priority_thread.size());
+}
+
+TEST_F(TestPriorityPacketQueueThread, test_queue_full)
+{
+  ObPacket packets[3];
+  PriorityPacketQueueThread priority_thread;
+  priority_thread.set_queue_capacity(2);
+  priority_thread.setThreadParameter(1, NULL, NULL);
+  EXPECT_TRUE(priority_thread.push(&packets[0], 0, false));
+  EXPECT_TRUE(priority_thread.push(&packets[1], 0, false));
+  // the ring is full
+  EXPECT_FALSE(priority_thread.push(&packets[2], 0, false));
+  EXPECT_TRUE(priority_thread.push(&packets[2], 0, false, PriorityPacketQueueThread::LOW_PRIV));
+  EXPECT_EQ(3, (int) priority_thread.size());
+}
+
+TEST_F(TestPriorityPacketQueueThread, test_handle)
+{
+  static const int64_t PACKET_NUM = 10000;
+  ObPacket *packets = new ObPacket[PACKET_NUM];
+  CountHandler handler;
+  PriorityPacketQueueThread priority_thread;
+  priority_thread.set_pop_batch_num(4);
+  priority_thread.setThreadParameter(4, &handler, NULL);
+  priority_thread.start();
+  for (int64_t i = 0; i < PACKET_NUM; i++)
+  {
+    packets[i].set_receive_ts(tbsys::CTimeUtil::getTime());
+    EXPECT_TRUE(priority_thread.push(&packets[i], 0, true,
+          0 == i % 10 ? PriorityPacketQueueThread::LOW_PRIV : PriorityPacketQueueThread::NORMAL_PRIV));
+  }
+  for (int64_t i = 0; i < 1000 && handler.count_ < PACKET_NUM; i++)
+  {
+    usleep(10000);
+  }
+  EXPECT_EQ(PACKET_NUM, handler.count_);
+  EXPECT_EQ(PACKET_NUM, priority_thread.get_wait_time_histogram().get_total_count());
+  priority_thread.stop();
+  priority_thread.wait();
+  delete [] packets;
 }
 
 } // end namespace common
@@ -94,6 +125,7 @@ TEST_F(TestPriorityPacketQueueThread, test_push)
 
 int main(int argc, char** argv)
 {
+  ob_init_memory_pool();
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
 }
@@ -0,0 +1,141 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_read_ahead.cpp
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "common/ob_read_ahead.h"
+
+using namespace oceanbase::common;
+
+namespace
+{
+  static const int64_t SLOT_NUM = 4;
+
+  // fills the slots with 0, 1, 2... up to value_count, then ends with end_ret
+  class IntReadAhead : public ObReadAhead
+  {
+  public:
+    IntReadAhead(const int64_t value_count, const int end_ret)
+      : ObReadAhead(SLOT_NUM), value_count_(value_count), end_ret_(end_ret),
+        next_value_(0), max_ahead_(0), consumed_(0)
+    {
+    }
+    ~IntReadAhead()
+    {
+      stop();
+    }
+    int next_value(int64_t &value)
+    {
+      int64_t slot_idx = 0;
+      int ret = next_slot(slot_idx);
+      if (OB_SUCCESS == ret)
+      {
+        value = slots_[slot_idx];
+        __sync_add_and_fetch(&consumed_, 1);
+      }
+      return ret;
+    }
+
+  protected:
+    int fill_slot(const int64_t slot_idx, bool &filled)
+    {
+      int ret = OB_SUCCESS;
+      filled = false;
+      // the slot being consumed is not given back yet
+      int64_t ahead = next_value_ - __sync_add_and_fetch(&consumed_, 0) + 1;
+      if (ahead > max_ahead_)
+      {
+        max_ahead_ = ahead;
+      }
+      if (next_value_ >= value_count_)
+      {
+        ret = end_ret_;
+      }
+      else
+      {
+        slots_[slot_idx] = next_value_++;
+        filled = true;
+        // the last value is handed over together with the end
+        if (next_value_ >= value_count_ && OB_ITER_END != end_ret_)
+        {
+          ret = end_ret_;
+        }
+      }
+      return ret;
+    }
+
+  public:
+    int64_t value_count_;
+    int end_ret_;
+    int64_t next_value_;
+    int64_t max_ahead_;
+    volatile int64_t consumed_;
+    int64_t slots_[SLOT_NUM];
+  };
+}
+
+TEST(ObReadAhead, not_started)
+{
+  IntReadAhead read_ahead(10, OB_ITER_END);
+  int64_t value = 0;
+  ASSERT_EQ(OB_NOT_INIT, read_ahead.next_value(value));
+  read_ahead.stop();
+}
+
+TEST(ObReadAhead, bounded_in_order)
+{
+  static const int64_t VALUE_COUNT = 10000;
+  IntReadAhead read_ahead(VALUE_COUNT, OB_ITER_END);
+  int64_t value = 0;
+  ASSERT_EQ(OB_SUCCESS, read_ahead.start());
+  ASSERT_EQ(OB_INIT_TWICE, read_ahead.start());
+  for (int64_t i = 0; i < VALUE_COUNT; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, read_ahead.next_value(value));
+    ASSERT_EQ(i, value);
+  }
+  ASSERT_EQ(OB_ITER_END, read_ahead.next_value(value));
+  ASSERT_EQ(OB_ITER_END, read_ahead.next_value(value));
+  ASSERT_GE(SLOT_NUM + 1, read_ahead.max_ahead_);
+}
+
+TEST(ObReadAhead, error_after_last_slot)
+{
+  IntReadAhead read_ahead(5, OB_ERR_UNEXPECTED);
+  int64_t value = 0;
+  ASSERT_EQ(OB_SUCCESS, read_ahead.start());
+  for (int64_t i = 0; i < 5; i++)
+  {
+    ASSERT_EQ(OB_SUCCESS, read_ahead.next_value(value));
+    ASSERT_EQ(i, value);
+  }
+  ASSERT_EQ(OB_ERR_UNEXPECTED, read_ahead.next_value(value));
+}
+
+TEST(ObReadAhead, stop_early)
+{
+  IntReadAhead read_ahead(1000000, OB_ITER_END);
+  int64_t value = 0;
+  ASSERT_EQ(OB_SUCCESS, read_ahead.start());
+  ASSERT_EQ(OB_SUCCESS, read_ahead.next_value(value));
+  read_ahead.stop();
+  ASSERT_GT(1000000, read_ahead.next_value_);
+  read_ahead.stop();
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_schema_delta.cpp
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "common/ob_schema.h"
+#include "common/ob_schema_delta.h"
+#include "common/ob_schema_manager.h"
+
+using namespace oceanbase::common;
+
+namespace
+{
+  void add_table(ObSchemaManagerV2 &schema, const uint64_t table_id, const char *name, const int64_t column_num)
+  {
+    ObTableSchema table;
+    char column_name[OB_MAX_COLUMN_NAME_LENGTH];
+    table.set_table_id(table_id);
+    table.set_table_name(name);
+    table.set_max_column_id(OB_APP_MIN_COLUMN_ID + column_num);
+    ASSERT_EQ(OB_SUCCESS, schema.add_table(table));
+    for (int64_t i = 0; i < column_num; i++)
+    {
+      ObColumnSchemaV2 column;
+      snprintf(column_name, sizeof(column_name), "c%ld", i);
+      column.set_table_id(table_id);
+      column.set_column_id(OB_APP_MIN_COLUMN_ID + i);
+      column.set_column_name(column_name);
+      column.set_column_type(ObIntType);
+      ASSERT_EQ(OB_SUCCESS, schema.add_column(column));
+    }
+  }
+
+  void check_same(const ObSchemaManagerV2 &expect, const ObSchemaManagerV2 &schema)
+  {
+    int32_t expect_size = 0;
+    int32_t size = 0;
+    ASSERT_EQ(expect.get_version(), schema.get_version());
+    ASSERT_EQ(expect.get_table_count(), schema.get_table_count());
+    ASSERT_EQ(expect.get_column_count(), schema.get_column_count());
+    for (const ObTableSchema *table = expect.table_begin(); table != expect.table_end(); ++table)
+    {
+      const ObTableSchema *other = schema.get_table_schema(table->get_table_id());
+      ASSERT_TRUE(NULL != other);
+      ASSERT_STREQ(table->get_table_name(), other->get_table_name());
+      ASSERT_EQ(other, schema.get_table_schema(table->get_table_name()));
+      expect.get_table_schema(table->get_table_id(), expect_size);
+      schema.get_table_schema(table->get_table_id(), size);
+      ASSERT_EQ(expect_size, size);
+    }
+  }
+}
+
+TEST(TestSchemaDelta, table_index)
+{
+  ObSchemaManagerV2 *schema = new ObSchemaManagerV2(1);
+  char name[OB_MAX_TABLE_NAME_LENGTH];
+  for (int64_t i = 0; i < 500; i++)
+  {
+    snprintf(name, sizeof(name), "t%ld", i);
+    add_table(*schema, 3000 + i, name, 2);
+  }
+  ASSERT_EQ(OB_SUCCESS, schema->sort_column());
+  for (int64_t i = 0; i < 500; i++)
+  {
+    snprintf(name, sizeof(name), "t%ld", i);
+    const ObTableSchema *table = schema->get_table_schema(3000 + i);
+    ASSERT_TRUE(NULL != table);
+    ASSERT_STREQ(name, table->get_table_name());
+    ASSERT_EQ(table, schema->get_table_schema(name));
+    ObString name_str(0, static_cast<int32_t>(strlen(name)), name);
+    ASSERT_EQ(table, schema->get_table_schema(name_str));
+  }
+  ASSERT_TRUE(NULL == schema->get_table_schema(static_cast<uint64_t>(2999)));
+  ASSERT_TRUE(NULL == schema->get_table_schema("t500"));
+  ASSERT_TRUE(NULL == schema->get_table_schema("t1000"));
+
+  // copies and deserialized schemas are indexed too
+  ObSchemaManagerV2 *copy = new ObSchemaManagerV2(*schema);
+  ASSERT_EQ(copy->table_begin() + 10, copy->get_table_schema(3010));
+  delete copy;
+  delete schema;
+}
+
+TEST(TestSchemaDelta, diff_and_apply)
+{
+  static const int64_t BUF_LEN = 1024 * 1024;
+  char *buf = static_cast<char*>(ob_malloc(BUF_LEN, ObModIds::TEST));
+  ObSchemaManagerV2 *base = new ObSchemaManagerV2(100);
+  ObSchemaManagerV2 *target = new ObSchemaManagerV2(200);
+  ObSchemaManagerV2 *result = new ObSchemaManagerV2();
+  add_table(*base, 3001, "t1", 3);
+  add_table(*base, 3002, "t2", 3);
+  add_table(*base, 3003, "t3", 3);
+  ASSERT_EQ(OB_SUCCESS, base->sort_column());
+  // t1 is unchanged, t2 gets a new column, t3 is dropped and t4 created
+  add_table(*target, 3001, "t1", 3);
+  add_table(*target, 3002, "t2", 4);
+  add_table(*target, 3004, "t4", 2);
+  ASSERT_EQ(OB_SUCCESS, target->sort_column());
+
+  ObSchemaDelta delta;
+  ObSchemaDelta received;
+  ASSERT_EQ(OB_SUCCESS, delta.diff(*base, *target));
+  ASSERT_EQ(100, delta.get_base_version());
+  ASSERT_EQ(200, delta.get_version());
+  ASSERT_EQ(2, delta.get_changed_table_count());
+  ASSERT_EQ(1, delta.get_dropped_table_count());
+
+  int64_t pos = 0;
+  ASSERT_EQ(OB_SUCCESS, delta.serialize(buf, BUF_LEN, pos));
+  ASSERT_EQ(delta.get_serialize_size(), pos);
+  ASSERT_GT(target->get_serialize_size(), pos);
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, received.deserialize(buf, data_len, pos));
+  ASSERT_EQ(data_len, pos);
+
+  ASSERT_EQ(OB_SUCCESS, received.apply(*base, *result));
+  check_same(*target, *result);
+  ASSERT_TRUE(NULL == result->get_table_schema(3003));
+  ASSERT_TRUE(NULL == result->get_table_schema("t3"));
+  // base is left as it is
+  ASSERT_EQ(100, base->get_version());
+  ASSERT_TRUE(NULL != base->get_table_schema(3003));
+
+  // a delta can only be applied to its base version
+  ASSERT_EQ(OB_SCHEMA_DELTA_MISMATCH, received.apply(*target, *result));
+
+  delete result;
+  delete target;
+  delete base;
+  ob_free(buf);
+}
+
+TEST(TestSchemaDelta, merger_schema_manager)
+{
+  ObSchemaManagerV2 *base = new ObSchemaManagerV2(100);
+  ObSchemaManagerV2 *target = new ObSchemaManagerV2(200);
+  ObMergerSchemaManager *manager = new ObMergerSchemaManager();
+  add_table(*base, 3001, "t1", 3);
+  ASSERT_EQ(OB_SUCCESS, base->sort_column());
+  add_table(*target, 3001, "t1", 3);
+  add_table(*target, 3002, "t2", 2);
+  ASSERT_EQ(OB_SUCCESS, target->sort_column());
+  ASSERT_EQ(OB_SUCCESS, manager->init(false, *base));
+
+  ObSchemaDelta delta;
+  ASSERT_EQ(OB_SUCCESS, delta.diff(*base, *target));
+  ASSERT_EQ(OB_SUCCESS, manager->apply_delta(delta));
+  ASSERT_EQ(200, manager->get_latest_version());
+  const ObSchemaManagerV2 *latest = manager->get_user_schema(0);
+  ASSERT_TRUE(NULL != latest);
+  check_same(*target, *latest);
+  ASSERT_EQ(OB_SUCCESS, manager->release_schema(latest));
+  ASSERT_EQ(OB_OLD_SCHEMA_VERSION, manager->apply_delta(delta));
+
+  delete manager;
+  delete target;
+  delete base;
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,302 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_sstable_block_index_mgr.cpp
+ *
+ */
+#include <pthread.h>
+#include "gtest/gtest.h"
+#include "common/ob_define.h"
+#include "common/ob_malloc.h"
+#include "common/ob_compact_cell_writer.h"
+#include "common/ob_row.h"
+#include "compactsstablev2/ob_sstable_block_index_mgr.h"
+#include "compactsstablev2/ob_compact_sstable_writer.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::compactsstablev2;
+
+namespace
+{
+  static const int64_t BLOCK_COUNT = 10;
+  static const int64_t BLOCK_SIZE = 64 * 1024L;
+  static const int64_t ENDKEY_SIZE = 64;
+
+  // block index of BLOCK_COUNT blocks, the endkey of the i-th block
+  // is (i * 100, "key_%ld")
+  ObSSTableBlockIndexMgr* build_block_index(char* buf, char* key_buf)
+  {
+    const int64_t index_length = (BLOCK_COUNT + 1) * sizeof(ObSSTableBlockIndex);
+    const int64_t endkey_length = BLOCK_COUNT * ENDKEY_SIZE;
+    ObSSTableBlockIndexMgr* mgr = new (buf) ObSSTableBlockIndexMgr(
+        index_length, endkey_length, BLOCK_COUNT);
+    ObSSTableBlockIndex* index = reinterpret_cast<ObSSTableBlockIndex*>(
+        buf + sizeof(ObSSTableBlockIndexMgr));
+    char* endkey = buf + sizeof(ObSSTableBlockIndexMgr) + index_length;
+    ObCompactCellWriter writer;
+    ObObj obj;
+    ObString str;
+
+    for (int64_t i = 0; i <= BLOCK_COUNT; i ++)
+    {
+      index[i].block_data_offset_ = i * BLOCK_SIZE;
+      index[i].block_endkey_offset_ = i * ENDKEY_SIZE;
+      if (i < BLOCK_COUNT)
+      {
+        writer.init(endkey + i * ENDKEY_SIZE, ENDKEY_SIZE, DENSE);
+        obj.set_int(i * 100);
+        writer.append(obj);
+        snprintf(key_buf, ENDKEY_SIZE, "key_%ld", i);
+        str.assign_ptr(key_buf, static_cast<int32_t>(strlen(key_buf)));
+        obj.set_varchar(str);
+        writer.append(obj);
+        writer.row_finish();
+      }
+    }
+    return mgr;
+  }
+
+  static const uint64_t TABLE_ID = 1001;
+  static const int64_t ROW_COUNT = 4000;
+  static const int64_t SPLIT_KEY_COUNT = 3;
+
+  bool in_range(const ObNewRange& range, const ObRowkey& key)
+  {
+    bool after_start = range.start_key_.is_min_row()
+      || (range.border_flag_.inclusive_start() ? range.start_key_ <= key : range.start_key_ < key);
+    bool before_end = range.end_key_.is_max_row()
+      || (range.border_flag_.inclusive_end() ? key <= range.end_key_ : key < range.end_key_);
+    return after_start && before_end;
+  }
+
+  struct SubRangeWriteTask
+  {
+    const ObNewRange* range_;
+    int64_t index_;
+    int ret_;
+    uint64_t checksum_;
+    int64_t row_count_;
+  };
+
+  // write rows of %task->range_ like the merge of one sub range does
+  void* write_sub_range(void* arg)
+  {
+    SubRangeWriteTask* task = static_cast<SubRangeWriteTask*>(arg);
+    ObCompactSSTableWriter writer;
+    ObFrozenMinorVersionRange version_range;
+    ObSSTableSchema schema;
+    ObSSTableSchemaColumnDef def;
+    ObRowDesc desc;
+    ObRow row;
+    ObObj obj;
+    ObString comp_name;
+    ObString file_path;
+    ObRowkey rowkey;
+    char path[64];
+    bool is_split = false;
+    int ret = OB_SUCCESS;
+
+    version_range.major_version_ = 10;
+    def.table_id_ = TABLE_ID;
+    def.column_id_ = 2;
+    def.column_value_type_ = ObIntType;
+    def.rowkey_seq_ = 1;
+    schema.add_column_def(def);
+    def.column_id_ = 3;
+    def.rowkey_seq_ = 0;
+    schema.add_column_def(def);
+    desc.add_column_desc(TABLE_ID, 2);
+    desc.add_column_desc(TABLE_ID, 3);
+    desc.set_rowkey_cell_count(1);
+    row.set_row_desc(desc);
+    snprintf(path, sizeof(path), "sub_range_%ld.sst", task->index_);
+    file_path.assign_ptr(path, static_cast<int32_t>(strlen(path)));
+
+    if (OB_SUCCESS != (ret = writer.set_sstable_param(version_range, DENSE_DENSE,
+            1, 1024, comp_name, 0)))
+    {
+      TBSYS_LOG(WARN, "set sstable param error, ret=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = writer.set_table_info(TABLE_ID, schema, *task->range_)))
+    {
+      TBSYS_LOG(WARN, "set table info error, ret=%d", ret);
+    }
+    else if (OB_SUCCESS != (ret = writer.set_sstable_filepath(file_path)))
+    {
+      TBSYS_LOG(WARN, "set sstable filepath error, ret=%d", ret);
+    }
+    for (int64_t i = 0; OB_SUCCESS == ret && i < ROW_COUNT; i ++)
+    {
+      obj.set_int(i);
+      rowkey.assign(&obj, 1);
+      if (in_range(*task->range_, rowkey))
+      {
+        row.set_cell(TABLE_ID, 2, obj);
+        obj.set_int(i * 7);
+        row.set_cell(TABLE_ID, 3, obj);
+        ret = writer.append_row(row, is_split);
+      }
+    }
+    if (OB_SUCCESS == ret && OB_SUCCESS == (ret = writer.finish()))
+    {
+      task->checksum_ = writer.get_sstable_checksum(0);
+      task->row_count_ = writer.get_sstable_row_count(0);
+    }
+    task->ret_ = ret;
+    unlink(path);
+    return NULL;
+  }
+}
+
+TEST(TestSSTableBlockIndexMgr, get_block_endkey)
+{
+  const int64_t buf_size = sizeof(ObSSTableBlockIndexMgr)
+    + (BLOCK_COUNT + 1) * sizeof(ObSSTableBlockIndex) + BLOCK_COUNT * ENDKEY_SIZE;
+  char* buf = (char*)ob_malloc(buf_size, ObModIds::TEST);
+  char key_buf[ENDKEY_SIZE];
+  ObSSTableBlockIndexMgr* mgr = build_block_index(buf, key_buf);
+  ObRowkey key;
+  int64_t int_value = 0;
+  ObString str;
+
+  ASSERT_EQ(BLOCK_COUNT, mgr->get_block_count());
+  for (int64_t i = 0; i < BLOCK_COUNT; i ++)
+  {
+    ASSERT_EQ(OB_SUCCESS, mgr->get_block_endkey(i, key));
+    ASSERT_EQ(2, key.length());
+    ASSERT_EQ(OB_SUCCESS, key.ptr()[0].get_int(int_value));
+    ASSERT_EQ(i * 100, int_value);
+    ASSERT_EQ(OB_SUCCESS, key.ptr()[1].get_varchar(str));
+    snprintf(key_buf, ENDKEY_SIZE, "key_%ld", i);
+    ASSERT_EQ(0, strncmp(key_buf, str.ptr(), str.length()));
+  }
+
+  ASSERT_EQ(OB_INVALID_ARGUMENT, mgr->get_block_endkey(-1, key));
+  ASSERT_EQ(OB_INVALID_ARGUMENT, mgr->get_block_endkey(BLOCK_COUNT, key));
+  ob_free(buf);
+}
+
+TEST(TestSSTableBlockIndexMgr, split_range)
+{
+  ObObj key_objs[SPLIT_KEY_COUNT];
+  ObRowkey keys[SPLIT_KEY_COUNT];
+  ObNewRange range;
+  ObNewRange sub_ranges[SPLIT_KEY_COUNT + 1];
+  ObObj obj;
+  ObRowkey rowkey;
+  int64_t hit = 0;
+
+  range.table_id_ = TABLE_ID;
+  range.set_whole_range();
+  for (int64_t i = 0; i < SPLIT_KEY_COUNT; i ++)
+  {
+    key_objs[i].set_int((i + 1) * 1000 - 1);
+    keys[i].assign(&key_objs[i], 1);
+  }
+
+  ASSERT_EQ(OB_INVALID_ARGUMENT, ObSSTableBlockIndexMgr::split_range(range, NULL, 1, sub_ranges));
+  ASSERT_EQ(OB_SUCCESS, ObSSTableBlockIndexMgr::split_range(range, keys, 0, sub_ranges));
+  ASSERT_TRUE(sub_ranges[0].is_whole_range());
+
+  ASSERT_EQ(OB_SUCCESS, ObSSTableBlockIndexMgr::split_range(
+        range, keys, SPLIT_KEY_COUNT, sub_ranges));
+  ASSERT_TRUE(sub_ranges[0].start_key_.is_min_row());
+  ASSERT_TRUE(sub_ranges[SPLIT_KEY_COUNT].end_key_.is_max_row());
+  for (int64_t i = 0; i <= SPLIT_KEY_COUNT; i ++)
+  {
+    ASSERT_EQ(TABLE_ID, sub_ranges[i].table_id_);
+    if (i > 0)
+    {
+      ASSERT_TRUE(sub_ranges[i].start_key_ == keys[i - 1]);
+      ASSERT_FALSE(sub_ranges[i].border_flag_.inclusive_start());
+    }
+    if (i < SPLIT_KEY_COUNT)
+    {
+      ASSERT_TRUE(sub_ranges[i].end_key_ == keys[i]);
+      ASSERT_TRUE(sub_ranges[i].border_flag_.inclusive_end());
+    }
+  }
+
+  // every row falls into exactly one sub range
+  for (int64_t i = 0; i < ROW_COUNT; i ++)
+  {
+    obj.set_int(i);
+    rowkey.assign(&obj, 1);
+    hit = 0;
+    for (int64_t j = 0; j <= SPLIT_KEY_COUNT; j ++)
+    {
+      if (in_range(sub_ranges[j], rowkey))
+      {
+        hit ++;
+      }
+    }
+    ASSERT_EQ(1, hit);
+  }
+}
+
+TEST(TestSSTableBlockIndexMgr, parallel_write_sub_ranges)
+{
+  ObObj key_objs[SPLIT_KEY_COUNT];
+  ObRowkey keys[SPLIT_KEY_COUNT];
+  ObNewRange range;
+  ObNewRange sub_ranges[SPLIT_KEY_COUNT + 1];
+  SubRangeWriteTask serial[SPLIT_KEY_COUNT + 1];
+  SubRangeWriteTask parallel[SPLIT_KEY_COUNT + 1];
+  pthread_t threads[SPLIT_KEY_COUNT + 1];
+  int64_t row_count = 0;
+
+  range.table_id_ = TABLE_ID;
+  range.set_whole_range();
+  for (int64_t i = 0; i < SPLIT_KEY_COUNT; i ++)
+  {
+    key_objs[i].set_int((i + 1) * 1000 - 1);
+    keys[i].assign(&key_objs[i], 1);
+  }
+  ASSERT_EQ(OB_SUCCESS, ObSSTableBlockIndexMgr::split_range(
+        range, keys, SPLIT_KEY_COUNT, sub_ranges));
+
+  // sub ranges merged one by one in the thread owning the tablet
+  for (int64_t i = 0; i <= SPLIT_KEY_COUNT; i ++)
+  {
+    serial[i].range_ = &sub_ranges[i];
+    serial[i].index_ = i;
+    write_sub_range(&serial[i]);
+    ASSERT_EQ(OB_SUCCESS, serial[i].ret_);
+  }
+
+  // sub ranges merged by idle merge threads at the same time
+  for (int64_t i = 0; i <= SPLIT_KEY_COUNT; i ++)
+  {
+    parallel[i].range_ = &sub_ranges[i];
+    parallel[i].index_ = SPLIT_KEY_COUNT + 1 + i;
+    ASSERT_EQ(0, pthread_create(&threads[i], NULL, write_sub_range, &parallel[i]));
+  }
+  for (int64_t i = 0; i <= SPLIT_KEY_COUNT; i ++)
+  {
+    pthread_join(threads[i], NULL);
+  }
+
+  // same sstables and checksums however the sub ranges are run
+  for (int64_t i = 0; i <= SPLIT_KEY_COUNT; i ++)
+  {
+    ASSERT_EQ(OB_SUCCESS, parallel[i].ret_);
+    ASSERT_EQ(1000, serial[i].row_count_);
+    ASSERT_EQ(serial[i].row_count_, parallel[i].row_count_);
+    ASSERT_EQ(serial[i].checksum_, parallel[i].checksum_);
+    row_count += parallel[i].row_count_;
+  }
+  ASSERT_EQ(ROW_COUNT, row_count);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
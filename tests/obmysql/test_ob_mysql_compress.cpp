@@ -0,0 +1,242 @@
+/*
+ * (C) 2007-2013 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $id
+ *
+ * test_ob_mysql_compress.cpp
+ *
+ */
+#include <gtest/gtest.h>
+#include <common/ob_define.h>
+#include <common/ob_malloc.h>
+#include "obmysql/ob_mysql_compress.h"
+#include "obmysql/ob_mysql_util.h"
+#include "obmysql/ob_mysql_callback.h"
+#include "obmysql/ob_mysql_loginer.h"
+#include "obmysql/packet/ob_mysql_command_packet.h"
+
+using namespace oceanbase;
+using namespace oceanbase::obmysql;
+using namespace oceanbase::common;
+
+int main(int argc, char *argv[])
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
+
+class TestObMySQLCompress
+  : public ::testing::Test
+{
+  public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // mysql packet of one command, returns length of the packet
+    int64_t make_packet(char *buf, const uint8_t seq, const char type, const char *arg)
+    {
+      int64_t pos = 0;
+      int64_t arg_len = strlen(arg);
+      EXPECT_EQ(OB_SUCCESS, ObMySQLUtil::store_int3(buf, OB_MYSQL_PACKET_HEADER_SIZE,
+                                                    static_cast<int32_t>(arg_len + 1), pos));
+      buf[pos++] = static_cast<char>(seq);
+      buf[pos++] = type;
+      memcpy(buf + pos, arg, arg_len);
+      return pos + arg_len;
+    }
+
+    // decode as easy does, until the input is used up or no packet can be decoded
+    int64_t decode_all(easy_message_t &m, ObMySQLCommandPacket **packets, const int64_t max_count)
+    {
+      int64_t count = 0;
+      ObMySQLCommandPacket *packet = NULL;
+      while (m.input->pos < m.input->last && count < max_count
+             && NULL != (packet = reinterpret_cast<ObMySQLCommandPacket*>(ObMySQLCallback::decode(&m))))
+      {
+        packets[count++] = packet;
+      }
+      return count;
+    }
+
+    void check_frame(const char *data, const int64_t data_len, bool expect_compressed)
+    {
+      char frame[4096];
+      char plain[4096];
+      int64_t pos = 0;
+      int64_t plain_len = 0;
+      uint32_t payload_len = 0;
+      uint32_t origin_len = 0;
+      uint8_t seq = 0;
+      ASSERT_GE(static_cast<int64_t>(sizeof(frame)), ObMySQLCompress::get_max_frame_size(data_len));
+      ASSERT_EQ(OB_SUCCESS, ObMySQLCompress::encode_frame(data, data_len, 3, frame, sizeof(frame), pos));
+      ObMySQLCompress::decode_header(frame, payload_len, seq, origin_len);
+      ASSERT_EQ(3, seq);
+      ASSERT_EQ(pos, ObMySQLCompress::COMPRESS_HEADER_SIZE + payload_len);
+      if (expect_compressed)
+      {
+        ASSERT_EQ(data_len, origin_len);
+        ASSERT_LT(payload_len, data_len);
+      }
+      else
+      {
+        ASSERT_EQ(0U, origin_len);
+        ASSERT_EQ(data_len, payload_len);
+      }
+      ASSERT_EQ(OB_SUCCESS, ObMySQLCompress::decode_payload(frame + ObMySQLCompress::COMPRESS_HEADER_SIZE,
+                                                            payload_len, origin_len, plain, sizeof(plain), plain_len));
+      ASSERT_EQ(data_len, plain_len);
+      ASSERT_EQ(0, memcmp(data, plain, data_len));
+    }
+};
+
+TEST_F(TestObMySQLCompress, frame)
+{
+  char data[1024];
+  // short packet is not compressed
+  memcpy(data, "\x05\x00\x00\x01\x03show", 9);
+  check_frame(data, 9, false);
+
+  // repeated rows compress well
+  for (int64_t i = 0; i < 1024; i++)
+  {
+    data[i] = static_cast<char>('a' + i % 4);
+  }
+  check_frame(data, sizeof(data), true);
+
+  // not enough buffer
+  char frame[64];
+  int64_t pos = 0;
+  ASSERT_EQ(OB_SIZE_OVERFLOW, ObMySQLCompress::encode_frame(data, sizeof(data), 0, frame, sizeof(frame), pos));
+
+  // corrupted payload
+  char plain[1024];
+  int64_t plain_len = 0;
+  memset(frame, 0x7f, sizeof(frame));
+  ASSERT_NE(OB_SUCCESS, ObMySQLCompress::decode_payload(frame, sizeof(frame), 1024, plain, sizeof(plain), plain_len));
+}
+
+TEST_F(TestObMySQLCompress, next_statement)
+{
+  ObString stmt;
+  int64_t pos = 0;
+  ObString query = ObString::make_string("select 1; insert into t values('a;b', \"c;\"); ;"
+                                         " -- comment;\n update t set c = 1 /* ; */ where `k;` = 2;");
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == ObString::make_string("select 1"));
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == ObString::make_string("insert into t values('a;b', \"c;\")"));
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == ObString::make_string("-- comment;\n update t set c = 1 /* ; */ where `k;` = 2"));
+  ASSERT_FALSE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+
+  pos = 0;
+  query = ObString::make_string("select 'it\\'s;'");
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == query);
+  ASSERT_FALSE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+}
+
+TEST_F(TestObMySQLCompress, next_statement_comment_tail)
+{
+  ObString stmt;
+  int64_t pos = 0;
+  // comments after the last ';' are not another statement
+  ObString query = ObString::make_string("select 1; -- done\n ; /* end; */ \n # bye");
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == ObString::make_string("select 1"));
+  ASSERT_FALSE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+
+  pos = 0;
+  query = ObString::make_string("select 1; /* c */ select 2; /*!40101 set names utf8 */");
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == ObString::make_string("select 1"));
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == ObString::make_string("/* c */ select 2"));
+  ASSERT_TRUE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+  ASSERT_TRUE(stmt == ObString::make_string("/*!40101 set names utf8 */"));
+  ASSERT_FALSE(ObMySQLUtil::get_next_statement(query, pos, stmt));
+}
+
+TEST_F(TestObMySQLCompress, decode_stream)
+{
+  const char *long_arg = "select c1, c2, c3 from t1 where c1 > 100 and c2 < 200 order by c3";
+  char plain[1024];
+  int64_t plain_len = 0;
+  plain_len += make_packet(plain + plain_len, 0, COM_QUERY, "select 1");
+  plain_len += make_packet(plain + plain_len, 0, COM_PING, "");
+  int64_t third_start = plain_len;
+  plain_len += make_packet(plain + plain_len, 0, COM_QUERY, long_arg);
+
+  // first frame holds two packets and half of the third, second frame the rest
+  char input[2048];
+  int64_t input_len = 0;
+  int64_t split = third_start + (plain_len - third_start) / 2;
+  ASSERT_EQ(OB_SUCCESS, ObMySQLCompress::encode_frame(plain, split, 0, input, sizeof(input), input_len));
+  int64_t first_frame_len = input_len;
+  ASSERT_EQ(OB_SUCCESS, ObMySQLCompress::encode_frame(plain + split, plain_len - split, 1,
+                                                      input, sizeof(input), input_len));
+
+  ObMySQLConnectionInfo info;
+  memset(&info, 0, sizeof(info));
+  info.capability_flags_ = CLIENT_COMPRESS;
+  easy_connection_t c;
+  memset(&c, 0, sizeof(c));
+  c.user_data = &info;
+  easy_buf_t buf;
+  memset(&buf, 0, sizeof(buf));
+  easy_message_t m;
+  memset(&m, 0, sizeof(m));
+  m.c = &c;
+  m.pool = easy_pool_create(0);
+  m.input = &buf;
+  ObMySQLCommandPacket *packets[4];
+
+  // only the first frame received, the packets of it are decoded one by one
+  buf.pos = input;
+  buf.last = input + first_frame_len;
+  ASSERT_EQ(2, decode_all(m, packets, 4));
+  ASSERT_EQ(static_cast<uint8_t>(COM_QUERY), packets[0]->get_type());
+  ASSERT_TRUE(packets[0]->get_command() == ObString::make_string("select 1"));
+  ASSERT_EQ(static_cast<uint8_t>(COM_PING), packets[1]->get_type());
+  ASSERT_EQ(0, packets[1]->get_command().length());
+  ASSERT_EQ(input + first_frame_len, buf.pos);
+  ASSERT_EQ(1, info.compress_seq_);
+
+  // part of the second frame
+  buf.last = input + first_frame_len + 3;
+  ASSERT_EQ(0, decode_all(m, packets, 4));
+  ASSERT_EQ(input + first_frame_len, buf.pos);
+
+  buf.last = input + input_len;
+  ASSERT_EQ(1, decode_all(m, packets, 4));
+  ASSERT_EQ(static_cast<uint8_t>(COM_QUERY), packets[0]->get_type());
+  ASSERT_TRUE(packets[0]->get_command() == ObString::make_string(long_arg));
+  ASSERT_EQ(input + input_len, buf.pos);
+  ASSERT_EQ(2, info.compress_seq_);
+  ASSERT_EQ(EASY_OK, m.status);
+
+  // corrupted frame destroys the connection
+  memset(input, 0x7f, sizeof(input));
+  input_len = 0;
+  ASSERT_EQ(OB_SUCCESS, ObMySQLUtil::store_int3(input, sizeof(input), 64, input_len));
+  input[input_len++] = 2;
+  ASSERT_EQ(OB_SUCCESS, ObMySQLUtil::store_int3(input, sizeof(input), 1024, input_len));
+  input_len += 64;
+  buf.pos = input;
+  buf.last = input + input_len;
+  ASSERT_EQ(0, decode_all(m, packets, 4));
+  ASSERT_EQ(EASY_ERROR, m.status);
+
+  ob_free(info.plain_buf_);
+  easy_pool_destroy(m.pool);
+}
@@ -0,0 +1,96 @@
+/*
+ * (C) 2007-2013 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * Version: $id
+ *
+ * test_ob_mysql_util.cpp
+ *
+ */
+#include <gtest/gtest.h>
+#include <time.h>
+#include <common/ob_define.h>
+#include "obmysql/ob_mysql_util.h"
+
+using namespace oceanbase;
+using namespace oceanbase::obmysql;
+using namespace oceanbase::common;
+
+int main(int argc, char *argv[])
+{
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
+
+static void check_int(int64_t value)
+{
+  char buf[ObMySQLUtil::MAX_INT_TEXT_LENGTH];
+  char expect[32];
+  int expect_len = snprintf(expect, sizeof(expect), "%ld", value);
+  int64_t len = ObMySQLUtil::int_to_text(value, buf);
+  ASSERT_EQ(expect_len, len);
+  ASSERT_EQ(0, memcmp(expect, buf, len));
+}
+
+TEST(TestObMySQLUtil, int_to_text)
+{
+  int64_t values[] = {0, 1, -1, 9, 10, 99, 100, -100, 12345, 1000000007,
+                      INT64_MAX, INT64_MIN, INT64_MIN + 1};
+  for (uint64_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+  {
+    check_int(values[i]);
+  }
+  int64_t value = 1;
+  for (int i = 0; i < 62; ++i)
+  {
+    check_int(value - 1);
+    check_int(value);
+    check_int(-value);
+    value *= 2;
+  }
+}
+
+TEST(TestObMySQLUtil, datetime_to_text)
+{
+  char buf[ObMySQLUtil::MAX_DATETIME_TEXT_LENGTH];
+  struct tm tms;
+  memset(&tms, 0, sizeof(tms));
+  tms.tm_year = 2013 - 1900;
+  tms.tm_mon = 0;
+  tms.tm_mday = 9;
+  tms.tm_hour = 8;
+  tms.tm_min = 5;
+  tms.tm_sec = 59;
+  int64_t len = ObMySQLUtil::datetime_to_text(tms, 0, buf);
+  ASSERT_EQ(19, len);
+  ASSERT_EQ(0, memcmp("2013-01-09 08:05:59", buf, len));
+
+  len = ObMySQLUtil::datetime_to_text(tms, 5, buf);
+  ASSERT_EQ(26, len);
+  ASSERT_EQ(0, memcmp("2013-01-09 08:05:59.000005", buf, len));
+
+  tms.tm_year = 12 - 1900;
+  len = ObMySQLUtil::datetime_to_text(tms, 999999, buf);
+  ASSERT_EQ(0, memcmp("0012-01-09 08:05:59.999999", buf, len));
+}
+
+TEST(TestObMySQLUtil, get_local_time)
+{
+  struct tm expect;
+  struct tm tms;
+  time_t base = 1356969600; // 2012-12-31 16:00:00 UTC
+  for (time_t t = base - 7300; t < base + 7300; t += 7)
+  {
+    localtime_r(&t, &expect);
+    ObMySQLUtil::get_local_time(t, tms);
+    ASSERT_EQ(expect.tm_year, tms.tm_year);
+    ASSERT_EQ(expect.tm_mon, tms.tm_mon);
+    ASSERT_EQ(expect.tm_mday, tms.tm_mday);
+    ASSERT_EQ(expect.tm_hour, tms.tm_hour);
+    ASSERT_EQ(expect.tm_min, tms.tm_min);
+    ASSERT_EQ(expect.tm_sec, tms.tm_sec);
+  }
+}
@@ -0,0 +1,189 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_merge_scheduler.cpp
+ *
+ */
+
+#include <gtest/gtest.h>
+#include "common/ob_malloc.h"
+#include "ob_merge_scheduler.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::rootserver;
+
+namespace
+{
+  static const int64_t FROZEN_VERSION = 5;
+  static const int64_t START_TIME = 1000000;
+  static const int64_t WINDOW = 100;
+
+  // four tables of the same size, merge order 1001, 1003, 1004, 1002
+  void build_tables(ObArray<ObTableMergeStat>& tables)
+  {
+    const int64_t read_times[] = {40, 10, 30, 20};
+    for (int64_t i = 0; i < 4; ++i)
+    {
+      ObTableMergeStat stat;
+      stat.table_id_ = 1001 + i;
+      stat.data_size_ = 100;
+      stat.read_count_ = 1;
+      stat.read_time_ = read_times[i];
+      ASSERT_EQ(OB_SUCCESS, tables.push_back(stat));
+    }
+  }
+
+  void get_schedule(const ObMergeScheduler& scheduler, const int64_t frozen_version,
+      ObMergeSchedule& schedule)
+  {
+    char buf[1024];
+    int64_t pos = 0;
+    ASSERT_EQ(OB_SUCCESS, scheduler.serialize_schedule(frozen_version, buf, sizeof(buf), pos));
+    int64_t data_len = pos;
+    pos = 0;
+    ASSERT_EQ(OB_SUCCESS, schedule.deserialize(buf, data_len, pos));
+  }
+}
+
+TEST(ObMergeScheduler, no_plan)
+{
+  ObMergeScheduler scheduler;
+  ObArray<ObTableMergeStat> tables;
+  ObMergeSchedule schedule;
+  build_tables(tables);
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION, START_TIME, tables, 1));
+  ASSERT_EQ(FROZEN_VERSION, scheduler.get_frozen_version());
+  get_schedule(scheduler, FROZEN_VERSION, schedule);
+  ASSERT_EQ(0, schedule.get_group_count());
+  ASSERT_TRUE(schedule.is_table_released(1002));
+}
+
+TEST(ObMergeScheduler, time_slicing)
+{
+  ObMergeScheduler scheduler;
+  ObArray<ObTableMergeStat> tables;
+  ObMergeSchedule schedule;
+  build_tables(tables);
+  ASSERT_EQ(-1, scheduler.get_released_group(FROZEN_VERSION));
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION, START_TIME, tables, 4));
+
+  // tables suffering most from unmerged data go first
+  get_schedule(scheduler, FROZEN_VERSION, schedule);
+  ASSERT_EQ(4, schedule.get_group_count());
+  ASSERT_EQ(0, schedule.get_table_group(1001));
+  ASSERT_EQ(1, schedule.get_table_group(1003));
+  ASSERT_EQ(2, schedule.get_table_group(1004));
+  ASSERT_EQ(3, schedule.get_table_group(1002));
+  ASSERT_TRUE(schedule.is_table_released(1001));
+  ASSERT_FALSE(schedule.is_table_released(1003));
+
+  // group i is released at start + window * i / group_count
+  ASSERT_EQ(0, scheduler.release_groups(START_TIME + 24, WINDOW));
+  ASSERT_EQ(1, scheduler.release_groups(START_TIME + 25, WINDOW));
+  ASSERT_EQ(2, scheduler.release_groups(START_TIME + 50, WINDOW));
+  // released group never goes back
+  ASSERT_EQ(2, scheduler.release_groups(START_TIME + 30, WINDOW));
+  ASSERT_EQ(3, scheduler.release_groups(START_TIME + 99, WINDOW));
+  ASSERT_EQ(3, scheduler.get_released_group(FROZEN_VERSION));
+  get_schedule(scheduler, FROZEN_VERSION, schedule);
+  ASSERT_TRUE(schedule.is_table_released(1002));
+
+  // older versions are all released
+  ASSERT_EQ(static_cast<int64_t>(ObMergeSchedule::ALL_GROUP_RELEASED), scheduler.get_released_group(FROZEN_VERSION - 1));
+}
+
+TEST(ObMergeScheduler, window_closed)
+{
+  ObMergeScheduler scheduler;
+  ObArray<ObTableMergeStat> tables;
+  build_tables(tables);
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION, START_TIME, tables, 4));
+  ASSERT_EQ(3, scheduler.release_groups(START_TIME, 0));
+
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION + 1, START_TIME, tables, 4));
+  ASSERT_EQ(3, scheduler.release_groups(START_TIME + WINDOW, WINDOW));
+}
+
+TEST(ObMergeScheduler, ups_memory_pressure)
+{
+  ObMergeScheduler scheduler;
+  ObArray<ObTableMergeStat> tables;
+  build_tables(tables);
+  scheduler.set_ups_memory_pressure_percent(80);
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION, START_TIME, tables, 4));
+
+  scheduler.set_ups_memory_usage(79, 100);
+  ASSERT_EQ(0, scheduler.release_groups(START_TIME, WINDOW));
+  // frozen memtable can only be dropped after the merge, release all
+  scheduler.set_ups_memory_usage(80, 100);
+  ASSERT_EQ(3, scheduler.release_groups(START_TIME + 1, WINDOW));
+  // unknown memtable limit is not pressure
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION + 1, START_TIME, tables, 4));
+  scheduler.set_ups_memory_usage(80, 0);
+  ASSERT_EQ(0, scheduler.release_groups(START_TIME + 1, WINDOW));
+}
+
+TEST(ObMergeScheduler, serialize_schedule)
+{
+  ObMergeScheduler scheduler;
+  ObArray<ObTableMergeStat> tables;
+  ObMergeSchedule schedule;
+  char buf[1024];
+  int64_t pos = 0;
+  build_tables(tables);
+  scheduler.set_split_param(1L << 30, 4);
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION, START_TIME, tables, 4));
+
+  // plan of a newer version is not made yet
+  ASSERT_EQ(OB_EAGAIN, scheduler.serialize_schedule(FROZEN_VERSION + 1, buf, sizeof(buf), pos));
+
+  get_schedule(scheduler, FROZEN_VERSION, schedule);
+  ASSERT_EQ(FROZEN_VERSION, schedule.get_frozen_version());
+  ASSERT_EQ(1L << 30, schedule.get_split_tablet_size());
+  ASSERT_EQ(4, schedule.get_split_range_count());
+
+  // new split params take effect from the next plan
+  scheduler.set_split_param(1L << 20, 8);
+  ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION + 1, START_TIME, tables, 4));
+  get_schedule(scheduler, FROZEN_VERSION + 1, schedule);
+  ASSERT_EQ(1L << 20, schedule.get_split_tablet_size());
+  ASSERT_EQ(8, schedule.get_split_range_count());
+
+  // late merge of an old version is not delayed but splits as its own plan did
+  get_schedule(scheduler, FROZEN_VERSION, schedule);
+  ASSERT_EQ(FROZEN_VERSION, schedule.get_frozen_version());
+  ASSERT_EQ(0, schedule.get_group_count());
+  ASSERT_TRUE(schedule.is_table_released(1002));
+  ASSERT_EQ(1L << 30, schedule.get_split_tablet_size());
+  ASSERT_EQ(4, schedule.get_split_range_count());
+
+  // no plan of that version is known, don't split
+  get_schedule(scheduler, FROZEN_VERSION - 1, schedule);
+  ASSERT_EQ(FROZEN_VERSION - 1, schedule.get_frozen_version());
+  ASSERT_EQ(0, schedule.get_group_count());
+  ASSERT_EQ(0, schedule.get_split_tablet_size());
+  ASSERT_EQ(0, schedule.get_split_range_count());
+
+  // plans of versions long ago are forgotten
+  for (int64_t i = 2; i <= 4; ++i)
+  {
+    ASSERT_EQ(OB_SUCCESS, scheduler.make_schedule(FROZEN_VERSION + i, START_TIME, tables, 4));
+  }
+  get_schedule(scheduler, FROZEN_VERSION, schedule);
+  ASSERT_EQ(0, schedule.get_split_tablet_size());
+  get_schedule(scheduler, FROZEN_VERSION + 1, schedule);
+  ASSERT_EQ(1L << 20, schedule.get_split_tablet_size());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -13,6 +13,8 @@
  *   Zhifeng YANG <zhuweng.yzf@taobao.com>
  *
  */
+#include <pthread.h>
+#include <unistd.h>
 #include "sql/ob_in_memory_sort.h"
 #include <gtest/gtest.h>
 #include "ob_fake_table.h"
@@ -26,12 +28,11 @@ class ObInMemorySortTest: public ::testing::Test
     virtual ~ObInMemorySortTest();
     virtual void SetUp();
     virtual void TearDown();
+    void test(const uint64_t orderby_col1, const uint64_t orderby_col2, const int64_t parallel_degree = 1);
   private:
     // disallow copy
     ObInMemorySortTest(const ObInMemorySortTest &other);
     ObInMemorySortTest& operator=(const ObInMemorySortTest &other);
-  protected:
-    void test(const uint64_t orderby_col1, const uint64_t orderby_col2);
 };
 
 ObInMemorySortTest::ObInMemorySortTest()
@@ -50,7 +51,7 @@ void ObInMemorySortTest::TearDown()
 {
 }
 
-void ObInMemorySortTest::test(const uint64_t orderby_col1, const uint64_t orderby_col2)
+void ObInMemorySortTest::test(const uint64_t orderby_col1, const uint64_t orderby_col2, const int64_t parallel_degree)
 {
   static const int64_t ROW_COUNT = 128*1024;
   ObInMemorySort in_mem_sort;
@@ -65,6 +66,7 @@ void ObInMemorySortTest::test(const uint64_t orderby_col1, const uint64_t orderb
   sort_column.is_ascending_ = true;
   ASSERT_EQ(OB_SUCCESS, sort_columns.push_back(sort_column));
   in_mem_sort.set_sort_columns(sort_columns);
+  in_mem_sort.set_parallel_degree(parallel_degree);
 
   test::ObFakeTable input_table;
   input_table.set_row_count(ROW_COUNT);
@@ -126,6 +128,109 @@ TEST_F(ObInMemorySortTest, sort_with_equal_items)
   test(orderby_col1, orderby_col2);
 }
 
+TEST_F(ObInMemorySortTest, parallel_sort)
+{
+  ObSortWorkerPool pool;
+  ASSERT_EQ(OB_SUCCESS, pool.init(4));
+  ObInMemorySort::set_worker_pool(&pool);
+  // 3 runs: the last one is copied during the first merge pass
+  test(OB_APP_MIN_COLUMN_ID, OB_APP_MIN_COLUMN_ID+1, 3);
+  // limited by MIN_ROWS_PER_SORT_TASK to 4 runs
+  test(OB_APP_MIN_COLUMN_ID+2, OB_APP_MIN_COLUMN_ID+3, 16);
+  ObInMemorySort::set_worker_pool(NULL);
+  pool.destroy();
+  // no pool, sort in the calling thread
+  test(OB_APP_MIN_COLUMN_ID, OB_APP_MIN_COLUMN_ID+1, 4);
+}
+
+struct ThreadIdTask: public ObSortWorkerPool::Task
+{
+  pthread_t thread_id_;
+  void run()
+  {
+    thread_id_ = pthread_self();
+    usleep(1000);
+  }
+};
+
+TEST_F(ObInMemorySortTest, worker_pool)
+{
+  static const int64_t TASK_COUNT = 16;
+  ObSortWorkerPool pool;
+  ThreadIdTask tasks[TASK_COUNT];
+  ObSortWorkerPool::Task *task_ptrs[TASK_COUNT];
+  ASSERT_EQ(OB_INVALID_ARGUMENT, pool.init(ObSortWorkerPool::MAX_THREAD_NUM + 1));
+  ASSERT_EQ(OB_SUCCESS, pool.init(2));
+  ASSERT_EQ(OB_INIT_TWICE, pool.init(2));
+  ASSERT_EQ(2, pool.get_thread_num());
+  for (int64_t i = 0; i < TASK_COUNT; ++i)
+  {
+    task_ptrs[i] = &tasks[i];
+  }
+  pool.run_tasks(task_ptrs, TASK_COUNT);
+  // the first task runs in the calling thread, all run on the pool threads or it
+  ASSERT_TRUE(pthread_equal(pthread_self(), tasks[0].thread_id_));
+  pthread_t thread_ids[TASK_COUNT];
+  int64_t thread_count = 0;
+  for (int64_t i = 0; i < TASK_COUNT; ++i)
+  {
+    bool found = false;
+    for (int64_t j = 0; j < thread_count && !found; ++j)
+    {
+      found = pthread_equal(thread_ids[j], tasks[i].thread_id_);
+    }
+    if (!found)
+    {
+      thread_ids[thread_count++] = tasks[i].thread_id_;
+    }
+  }
+  ASSERT_GE(3, thread_count);
+  pool.destroy();
+  // no thread, all run in the calling thread
+  ASSERT_EQ(OB_SUCCESS, pool.init(0));
+  pool.run_tasks(task_ptrs, TASK_COUNT);
+  for (int64_t i = 0; i < TASK_COUNT; ++i)
+  {
+    ASSERT_TRUE(pthread_equal(pthread_self(), tasks[i].thread_id_));
+  }
+}
+
+struct ParallelSortArg
+{
+  ObInMemorySortTest *test_;
+  int64_t index_;
+};
+
+static void *parallel_sort_routine(void *arg)
+{
+  ParallelSortArg *sort_arg = static_cast<ParallelSortArg*>(arg);
+  sort_arg->test_->test(OB_APP_MIN_COLUMN_ID + sort_arg->index_ % 2 * 2,
+                        OB_APP_MIN_COLUMN_ID + sort_arg->index_ % 2 * 2 + 1, 4);
+  return NULL;
+}
+
+TEST_F(ObInMemorySortTest, concurrent_parallel_sort)
+{
+  // more concurrent sorts than the pool has threads, they share the threads
+  static const int64_t SORT_COUNT = 8;
+  ObSortWorkerPool pool;
+  ASSERT_EQ(OB_SUCCESS, pool.init(3));
+  ObInMemorySort::set_worker_pool(&pool);
+  pthread_t threads[SORT_COUNT];
+  ParallelSortArg args[SORT_COUNT];
+  for (int64_t i = 0; i < SORT_COUNT; ++i)
+  {
+    args[i].test_ = this;
+    args[i].index_ = i;
+    ASSERT_EQ(0, pthread_create(&threads[i], NULL, parallel_sort_routine, &args[i]));
+  }
+  for (int64_t i = 0; i < SORT_COUNT; ++i)
+  {
+    pthread_join(threads[i], NULL);
+  }
+  ObInMemorySort::set_worker_pool(NULL);
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
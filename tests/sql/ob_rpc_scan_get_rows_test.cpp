@@ -0,0 +1,112 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_rpc_scan_get_rows_test.cpp
+ *
+ */
+#include <gtest/gtest.h>
+#include "common/ob_malloc.h"
+#include "sql/ob_rpc_scan.h"
+
+using namespace oceanbase;
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+namespace
+{
+  static const uint64_t TABLE_ID = 1001;
+  static const uint64_t CID_BEGIN = 16;
+  static const int64_t ROWKEY_COLUMN_NUM = 2;
+
+  void init_rowkey_info(ObRowkeyInfo &rowkey_info)
+  {
+    ObRowkeyColumn column;
+    for (int64_t i = 0; i < ROWKEY_COLUMN_NUM; i++)
+    {
+      column.column_id_ = CID_BEGIN + i;
+      column.type_ = ObIntType;
+      column.length_ = 8;
+      ASSERT_EQ(OB_SUCCESS, rowkey_info.add_column(column));
+    }
+  }
+
+  void add_item(ObSqlExpression &expr, ObItemType type, int64_t value)
+  {
+    ExprItem item;
+    item.type_ = type;
+    item.value_.int_ = value;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+  }
+
+  // (k1, k2) in ((v1, v2), (v3, v4), ...)
+  void make_in_expr(ObSqlExpression &expr, const int64_t values[][ROWKEY_COLUMN_NUM], int64_t count)
+  {
+    ExprItem item;
+    for (int64_t i = 0; i < ROWKEY_COLUMN_NUM; i++)
+    {
+      item.type_ = T_REF_COLUMN;
+      item.value_.cell_.tid = TABLE_ID;
+      item.value_.cell_.cid = CID_BEGIN + i;
+      ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+    }
+    add_item(expr, T_OP_ROW, ROWKEY_COLUMN_NUM);
+    add_item(expr, T_OP_LEFT_PARAM_END, 2);
+    for (int64_t i = 0; i < count; i++)
+    {
+      for (int64_t j = 0; j < ROWKEY_COLUMN_NUM; j++)
+      {
+        add_item(expr, T_INT, values[i][j]);
+      }
+      add_item(expr, T_OP_ROW, ROWKEY_COLUMN_NUM);
+    }
+    add_item(expr, T_OP_ROW, count);
+    add_item(expr, T_OP_IN, 2);
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+  }
+
+  void check_rowkey(const ObRowkey *rowkey, int64_t k1, int64_t k2)
+  {
+    int64_t value = 0;
+    ASSERT_TRUE(NULL != rowkey);
+    ASSERT_EQ(ROWKEY_COLUMN_NUM, rowkey->get_obj_cnt());
+    ASSERT_EQ(OB_SUCCESS, rowkey->ptr()[0].get_int(value));
+    ASSERT_EQ(k1, value);
+    ASSERT_EQ(OB_SUCCESS, rowkey->ptr()[1].get_int(value));
+    ASSERT_EQ(k2, value);
+  }
+}
+
+// (k1, k2) in ((3, 1), (1, 2), (3, 1), (1, 1), (1, 2))
+TEST(ObRpcScanTest, cons_get_rows)
+{
+  ObRowkeyInfo rowkey_info;
+  init_rowkey_info(rowkey_info);
+  ObRpcScan rpc_scan;
+  rpc_scan.sql_read_strategy_.set_rowkey_info(rowkey_info);
+
+  ObSqlExpression in_expr;
+  const int64_t values[][ROWKEY_COLUMN_NUM] = {{3, 1}, {1, 2}, {3, 1}, {1, 1}, {1, 2}};
+  make_in_expr(in_expr, values, 5);
+  ASSERT_EQ(OB_SUCCESS, rpc_scan.sql_read_strategy_.add_filter(in_expr));
+
+  // rows are got in rowkey order, each row once
+  ObSqlGetParam get_param;
+  ASSERT_EQ(OB_SUCCESS, rpc_scan.cons_get_rows(get_param));
+  ASSERT_EQ(3, get_param.get_row_size());
+  check_rowkey(get_param[0], 1, 1);
+  check_rowkey(get_param[1], 1, 2);
+  check_rowkey(get_param[2], 3, 1);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
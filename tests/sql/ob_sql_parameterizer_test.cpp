@@ -0,0 +1,132 @@
+/*
+ * (C) 2007-2013 Taobao Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ *
+ * Version:  ob_sql_parameterizer_test.cpp
+ *
+ * Description:
+ *   Test ObSqlParameterizer class
+ *
+ */
+#include "common/ob_malloc.h"
+#include <gtest/gtest.h>
+#include "sql/ob_sql_parameterizer.h"
+
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+class ObSqlParameterizerTest: public ::testing::Test
+{
+  public:
+    ObSqlParameterizerTest(){}
+    virtual ~ObSqlParameterizerTest(){}
+    virtual void SetUp(){}
+    virtual void TearDown(){}
+  protected:
+    int parameterize(const char *sql)
+    {
+      ObString stmt = ObString::make_string(sql);
+      return ObSqlParameterizer::parameterize(stmt, buf_, sizeof(buf_), text_, key_, params_);
+    }
+    bool text_equals(const char *expect)
+    {
+      return text_ == ObString::make_string(expect);
+    }
+  private:
+    // disallow copy
+    ObSqlParameterizerTest(const ObSqlParameterizerTest &other);
+    ObSqlParameterizerTest& operator=(const ObSqlParameterizerTest &other);
+  protected:
+    // data members
+    char buf_[1024];
+    ObString text_;
+    ObString key_;
+    ObArray<ObObj> params_;
+};
+
+TEST_F(ObSqlParameterizerTest, point_select)
+{
+  int64_t value = 0;
+  ObString str;
+  ASSERT_EQ(OB_SUCCESS, parameterize("select c1,  c2 from t1\n where pk = 10 and c3 = 'abc'"));
+  ASSERT_TRUE(text_equals("select c1, c2 from t1 where pk = ? and c3 = ?"));
+  ASSERT_EQ(2, params_.count());
+  ASSERT_EQ(OB_SUCCESS, params_.at(0).get_int(value));
+  ASSERT_EQ(10, value);
+  ASSERT_EQ(OB_SUCCESS, params_.at(1).get_varchar(str));
+  ASSERT_TRUE(str == ObString::make_string("abc"));
+
+  ObString key1 = key_;
+  char buf[1024];
+  memcpy(buf, key1.ptr(), key1.length());
+  key1.assign_ptr(buf, key1.length());
+  ASSERT_EQ(OB_SUCCESS, parameterize("select c1, c2 from t1 where pk = 99 and c3 = 'xyz'"));
+  ASSERT_TRUE(key_ == key1);
+}
+
+TEST_F(ObSqlParameterizerTest, param_types_in_key)
+{
+  ASSERT_EQ(OB_SUCCESS, parameterize("select * from t where a = 1 and b = 'x'"));
+  ASSERT_TRUE(text_equals("select * from t where a = ? and b = ?"));
+  ASSERT_TRUE(key_ == ObString::make_string("select * from t where a = ? and b = ?IS"));
+
+  // same text, the string constant makes a different key
+  ASSERT_EQ(OB_SUCCESS, parameterize("select * from t where a = '1' and b = 'x'"));
+  ASSERT_TRUE(text_equals("select * from t where a = ? and b = ?"));
+  ASSERT_TRUE(key_ == ObString::make_string("select * from t where a = ? and b = ?SS"));
+
+  // no param, the key is the text
+  ASSERT_EQ(OB_SUCCESS, parameterize("select 1 from t"));
+  ASSERT_TRUE(key_ == text_);
+}
+
+TEST_F(ObSqlParameterizerTest, keep_metadata_constants)
+{
+  ASSERT_EQ(OB_SUCCESS, parameterize("select 1, 'a' from t where c = 2 order by 1, c, 2 limit 5"));
+  ASSERT_TRUE(text_equals("select 1, 'a' from t where c = ? order by 1, c, 2 limit ?"));
+  ASSERT_EQ(2, params_.count());
+
+  ASSERT_EQ(OB_SUCCESS, parameterize("select * from t where c in (select 3 from t2 where d = 4)"));
+  ASSERT_TRUE(text_equals("select * from t where c in (select 3 from t2 where d = ?)"));
+  ASSERT_EQ(1, params_.count());
+
+  ASSERT_EQ(OB_SUCCESS, parameterize("select * from t where c = 1.5 and d = 'it''s' and e = date '2012-01-01'"));
+  ASSERT_TRUE(text_equals("select * from t where c = 1.5 and d = 'it''s' and e = date '2012-01-01'"));
+  ASSERT_EQ(0, params_.count());
+}
+
+TEST_F(ObSqlParameterizerTest, negative_and_dml)
+{
+  int64_t value = 0;
+  ASSERT_EQ(OB_SUCCESS, parameterize("update t set c = c -1 where pk = -7"));
+  ASSERT_TRUE(text_equals("update t set c = c -? where pk = ?"));
+  ASSERT_EQ(2, params_.count());
+  ASSERT_EQ(OB_SUCCESS, params_.at(0).get_int(value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(OB_SUCCESS, params_.at(1).get_int(value));
+  ASSERT_EQ(-7, value);
+
+  ASSERT_EQ(OB_SUCCESS, parameterize("insert into t(a, b) values(1, 'x') -- comment 2\n"));
+  ASSERT_TRUE(text_equals("insert into t(a, b) values(?, ?) -- comment 2"));
+  ASSERT_EQ(2, params_.count());
+}
+
+TEST_F(ObSqlParameterizerTest, not_supported)
+{
+  ASSERT_EQ(OB_NOT_SUPPORTED, parameterize("show tables"));
+  ASSERT_EQ(OB_NOT_SUPPORTED, parameterize("set autocommit = 1"));
+  ASSERT_EQ(OB_NOT_SUPPORTED, parameterize("select * from t where c = ?"));
+  ASSERT_EQ(OB_NOT_SUPPORTED, parameterize("select * from t where c = 'abc"));
+}
+
+int main(int argc, char **argv)
+{
+  TBSYS_LOGGER.setLogLevel("WARN");
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
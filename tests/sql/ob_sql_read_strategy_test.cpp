@@ -0,0 +1,252 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sql_read_strategy_test.cpp
+ *
+ */
+#include <gtest/gtest.h>
+#include "common/ob_malloc.h"
+#include "sql/ob_sql_read_strategy.h"
+
+using namespace oceanbase;
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+namespace
+{
+  static const uint64_t TABLE_ID = 1001;
+  static const uint64_t CID_BEGIN = 16;
+
+  void init_rowkey_info(ObRowkeyInfo &rowkey_info, const int64_t column_count)
+  {
+    ObRowkeyColumn column;
+    for (int64_t i = 0; i < column_count; i++)
+    {
+      column.column_id_ = CID_BEGIN + i;
+      column.type_ = ObIntType;
+      column.length_ = 8;
+      ASSERT_EQ(OB_SUCCESS, rowkey_info.add_column(column));
+    }
+  }
+
+  void add_item(ObSqlExpression &expr, ObItemType type, int64_t value)
+  {
+    ExprItem item;
+    item.type_ = type;
+    item.value_.int_ = value;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+  }
+
+  void add_column(ObSqlExpression &expr, uint64_t cid)
+  {
+    ExprItem item;
+    item.type_ = T_REF_COLUMN;
+    item.value_.cell_.tid = TABLE_ID;
+    item.value_.cell_.cid = cid;
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item(item));
+  }
+
+  // cid in (v1, v2, ...) ==> (cid) in ((v1), (v2), ...)
+  void make_in_expr(ObSqlExpression &expr, uint64_t cid, const int64_t *values, int64_t count)
+  {
+    add_column(expr, cid);
+    add_item(expr, T_OP_ROW, 1);
+    add_item(expr, T_OP_LEFT_PARAM_END, 2);
+    for (int64_t i = 0; i < count; i++)
+    {
+      add_item(expr, T_INT, values[i]);
+      add_item(expr, T_OP_ROW, 1);
+    }
+    add_item(expr, T_OP_ROW, count);
+    add_item(expr, T_OP_IN, 2);
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+  }
+
+  void make_cond_expr(ObSqlExpression &expr, uint64_t cid, ObItemType op, int64_t value)
+  {
+    add_column(expr, cid);
+    add_item(expr, T_INT, value);
+    add_item(expr, op, 2);
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+  }
+
+  void make_between_expr(ObSqlExpression &expr, uint64_t cid, int64_t start, int64_t end)
+  {
+    add_column(expr, cid);
+    add_item(expr, T_INT, start);
+    add_item(expr, T_INT, end);
+    add_item(expr, T_OP_BTW, 3);
+    ASSERT_EQ(OB_SUCCESS, expr.add_expr_item_end());
+  }
+
+  void check_point(const ObRowkey &rowkey, int64_t idx, int64_t expect)
+  {
+    int64_t value = 0;
+    ASSERT_EQ(OB_SUCCESS, rowkey.ptr()[idx].get_int(value));
+    ASSERT_EQ(expect, value);
+  }
+}
+
+// cid in (3, 1, 3) and cid + 1 between 10 and 20
+TEST(ObSqlReadStrategyTest, in_list_with_range)
+{
+  ObRowkeyInfo rowkey_info;
+  init_rowkey_info(rowkey_info, 3);
+  ObSqlReadStrategy strategy;
+  strategy.set_rowkey_info(rowkey_info);
+  PageArena<ObObj, ModulePageAllocator> allocator;
+
+  ObSqlExpression in_expr;
+  ObSqlExpression btw_expr;
+  const int64_t values[] = {3, 1, 3};
+  make_in_expr(in_expr, CID_BEGIN, values, 3);
+  make_between_expr(btw_expr, CID_BEGIN + 1, 10, 20);
+
+  uint64_t cid = OB_INVALID_ID;
+  ObArray<ObObj> list;
+  ASSERT_TRUE(in_expr.is_simple_value_list(true, cid, list));
+  ASSERT_EQ(CID_BEGIN, cid);
+  ASSERT_EQ(3, list.count());
+
+  ASSERT_EQ(OB_SUCCESS, strategy.add_filter(in_expr));
+  ASSERT_EQ(OB_SUCCESS, strategy.add_filter(btw_expr));
+
+  ObArray<ObNewRange> ranges;
+  ASSERT_EQ(OB_SUCCESS, strategy.find_scan_ranges(ranges, allocator));
+  ASSERT_EQ(2, ranges.count());
+  for (int64_t i = 0; i < ranges.count(); i++)
+  {
+    const ObNewRange &range = ranges.at(i);
+    check_point(range.start_key_, 0, i == 0 ? 1 : 3);
+    check_point(range.end_key_, 0, i == 0 ? 1 : 3);
+    check_point(range.start_key_, 1, 10);
+    check_point(range.end_key_, 1, 20);
+    ASSERT_TRUE(range.start_key_.ptr()[2].is_min_value());
+    ASSERT_TRUE(range.end_key_.ptr()[2].is_max_value());
+  }
+  ASSERT_TRUE(ranges.at(0).end_key_ < ranges.at(1).start_key_);
+}
+
+// (cid = 5 or cid = 2 or cid = 9) and cid + 1 = 7 and cid <= 6
+TEST(ObSqlReadStrategyTest, or_list_with_point)
+{
+  ObRowkeyInfo rowkey_info;
+  init_rowkey_info(rowkey_info, 3);
+  ObSqlReadStrategy strategy;
+  strategy.set_rowkey_info(rowkey_info);
+  PageArena<ObObj, ModulePageAllocator> allocator;
+
+  ObSqlExpression or_expr;
+  ObSqlExpression eq_expr;
+  ObSqlExpression le_expr;
+  add_column(or_expr, CID_BEGIN);
+  add_item(or_expr, T_INT, 5);
+  add_item(or_expr, T_OP_EQ, 2);
+  add_column(or_expr, CID_BEGIN);
+  add_item(or_expr, T_INT, 2);
+  add_item(or_expr, T_OP_EQ, 2);
+  add_item(or_expr, T_OP_OR, 2);
+  add_column(or_expr, CID_BEGIN);
+  add_item(or_expr, T_INT, 9);
+  add_item(or_expr, T_OP_EQ, 2);
+  add_item(or_expr, T_OP_OR, 2);
+  ASSERT_EQ(OB_SUCCESS, or_expr.add_expr_item_end());
+  make_cond_expr(eq_expr, CID_BEGIN + 1, T_OP_EQ, 7);
+  make_cond_expr(le_expr, CID_BEGIN, T_OP_LE, 6);
+
+  ASSERT_EQ(OB_SUCCESS, strategy.add_filter(or_expr));
+  ASSERT_EQ(OB_SUCCESS, strategy.add_filter(eq_expr));
+  ASSERT_EQ(OB_SUCCESS, strategy.add_filter(le_expr));
+
+  ObArray<ObNewRange> ranges;
+  ASSERT_EQ(OB_SUCCESS, strategy.find_scan_ranges(ranges, allocator));
+  ASSERT_EQ(2, ranges.count());
+  check_point(ranges.at(0).start_key_, 0, 2);
+  check_point(ranges.at(1).start_key_, 0, 5);
+  for (int64_t i = 0; i < ranges.count(); i++)
+  {
+    check_point(ranges.at(i).start_key_, 1, 7);
+    check_point(ranges.at(i).end_key_, 1, 7);
+  }
+}
+
+// no value list, same range as find_scan_range
+TEST(ObSqlReadStrategyTest, single_range)
+{
+  ObRowkeyInfo rowkey_info;
+  init_rowkey_info(rowkey_info, 2);
+  ObSqlReadStrategy strategy;
+  strategy.set_rowkey_info(rowkey_info);
+  PageArena<ObObj, ModulePageAllocator> allocator;
+
+  ObSqlExpression ge_expr;
+  ObSqlExpression or_expr;
+  make_cond_expr(ge_expr, CID_BEGIN, T_OP_GE, 100);
+  // or on different columns is not a value list
+  add_column(or_expr, CID_BEGIN);
+  add_item(or_expr, T_INT, 1);
+  add_item(or_expr, T_OP_EQ, 2);
+  add_column(or_expr, CID_BEGIN + 1);
+  add_item(or_expr, T_INT, 2);
+  add_item(or_expr, T_OP_EQ, 2);
+  add_item(or_expr, T_OP_OR, 2);
+  ASSERT_EQ(OB_SUCCESS, or_expr.add_expr_item_end());
+  uint64_t cid = OB_INVALID_ID;
+  ObArray<ObObj> list;
+  ASSERT_FALSE(or_expr.is_simple_value_list(true, cid, list));
+
+  ASSERT_EQ(OB_SUCCESS, strategy.add_filter(ge_expr));
+  ASSERT_EQ(OB_SUCCESS, strategy.add_filter(or_expr));
+
+  ObArray<ObNewRange> ranges;
+  ASSERT_EQ(OB_SUCCESS, strategy.find_scan_ranges(ranges, allocator));
+  ASSERT_EQ(1, ranges.count());
+  check_point(ranges.at(0).start_key_, 0, 100);
+  ASSERT_TRUE(ranges.at(0).end_key_.ptr()[0].is_max_value());
+  ASSERT_TRUE(ranges.at(0).start_key_.ptr()[1].is_min_value());
+}
+
+// only conditions on the first rowkey column limit the scan
+TEST(ObSqlReadStrategyTest, leading_rowkey_condition)
+{
+  ObRowkeyInfo rowkey_info;
+  init_rowkey_info(rowkey_info, 2);
+  {
+    ObSqlReadStrategy strategy;
+    strategy.set_rowkey_info(rowkey_info);
+    ObSqlExpression eq_expr;
+    make_cond_expr(eq_expr, CID_BEGIN + 1, T_OP_EQ, 7);
+    ASSERT_EQ(OB_SUCCESS, strategy.add_filter(eq_expr));
+    ASSERT_FALSE(strategy.has_leading_rowkey_condition());
+  }
+  {
+    ObSqlReadStrategy strategy;
+    strategy.set_rowkey_info(rowkey_info);
+    ObSqlExpression btw_expr;
+    make_between_expr(btw_expr, CID_BEGIN, 10, 20);
+    ASSERT_EQ(OB_SUCCESS, strategy.add_filter(btw_expr));
+    ASSERT_TRUE(strategy.has_leading_rowkey_condition());
+  }
+  {
+    ObSqlReadStrategy strategy;
+    strategy.set_rowkey_info(rowkey_info);
+    ObSqlExpression in_expr;
+    const int64_t values[] = {3, 1};
+    make_in_expr(in_expr, CID_BEGIN, values, 2);
+    ASSERT_EQ(OB_SUCCESS, strategy.add_filter(in_expr));
+    ASSERT_TRUE(strategy.has_leading_rowkey_condition());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
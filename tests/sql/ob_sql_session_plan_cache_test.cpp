@@ -0,0 +1,181 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_sql_session_plan_cache_test.cpp
+ *
+ */
+#include "sql/ob_sql_session_info.h"
+#include "sql/ob_result_set.h"
+#include "sql/ob_physical_plan.h"
+#include "common/ob_malloc.h"
+#include <gtest/gtest.h>
+
+using namespace oceanbase::sql;
+using namespace oceanbase::common;
+
+namespace
+{
+  static const int64_t SCHEMA_VERSION = 10;
+  static const int64_t PRIV_VERSION = 20;
+  static const int64_t MAX_CACHED_PLANS = 3;
+}
+
+class ObSqlSessionPlanCacheTest: public ::testing::Test
+{
+  public:
+    ObSqlSessionPlanCacheTest(){}
+    virtual ~ObSqlSessionPlanCacheTest(){}
+    virtual void SetUp()
+    {
+      ASSERT_EQ(OB_SUCCESS, session_.init(block_allocator_));
+    }
+    virtual void TearDown(){}
+  protected:
+    // build a plan in its own arena the way ObSql::prepare_cached_plan does and store it
+    int store_plan(const char *key, const int64_t schema_version, ObResultSet *&stored,
+                   ObArenaAllocator **arena = NULL, const int64_t plan_mem_size = 0)
+    {
+      int ret = OB_SUCCESS;
+      ObResultSet result;
+      ObArenaAllocator *allocator = session_.get_transformer_mem_pool_for_ps();
+      void *ptr = NULL;
+      if (NULL == allocator || NULL == (ptr = allocator->alloc(sizeof(ObPhysicalPlan))))
+      {
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else if (0 < plan_mem_size && NULL == allocator->alloc(plan_mem_size))
+      {
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else
+      {
+        result.set_session(&session_);
+        result.set_ps_transformer_allocator(allocator);
+        result.set_physical_plan(new(ptr) ObPhysicalPlan(), true);
+        ret = session_.store_cached_plan(ObString::make_string(key), schema_version, PRIV_VERSION,
+                                         MAX_CACHED_PLANS, result, stored);
+        if (NULL != arena)
+        {
+          *arena = allocator;
+        }
+      }
+      return ret;
+    }
+    int get_plan(const char *key, const int64_t schema_version, const int64_t privilege_version,
+                 ObResultSet *&stored)
+    {
+      return session_.get_cached_plan(ObString::make_string(key), schema_version, privilege_version, stored);
+    }
+  private:
+    // disallow copy
+    ObSqlSessionPlanCacheTest(const ObSqlSessionPlanCacheTest &other);
+    ObSqlSessionPlanCacheTest& operator=(const ObSqlSessionPlanCacheTest &other);
+  protected:
+    DefaultBlockAllocator block_allocator_;
+    ObSQLSessionInfo session_;
+};
+
+TEST_F(ObSqlSessionPlanCacheTest, hit_and_miss)
+{
+  ObResultSet *stored = NULL;
+  ObResultSet *cached = NULL;
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, get_plan("select * from t where a = ?I", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(OB_SUCCESS, store_plan("select * from t where a = ?I", SCHEMA_VERSION, stored));
+  ASSERT_TRUE(NULL != stored);
+  ASSERT_EQ(OB_SUCCESS, get_plan("select * from t where a = ?I", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(stored, cached);
+  // a string param is another plan
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, get_plan("select * from t where a = ?S", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(1, session_.get_cached_plan_count());
+
+  // statements can not be cached are remembered apart
+  ASSERT_EQ(OB_SUCCESS, session_.set_plan_uncacheable(ObString::make_string("select * from t where b = ?I"),
+                                                      SCHEMA_VERSION, PRIV_VERSION, MAX_CACHED_PLANS));
+  ASSERT_EQ(OB_NOT_SUPPORTED, get_plan("select * from t where b = ?I", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(1, session_.get_cached_plan_count());
+  ASSERT_EQ(1, session_.get_uncacheable_plan_count());
+}
+
+TEST_F(ObSqlSessionPlanCacheTest, lru_eviction)
+{
+  ObResultSet *stored = NULL;
+  ObResultSet *cached = NULL;
+  ASSERT_EQ(OB_SUCCESS, store_plan("k1", SCHEMA_VERSION, stored));
+  ASSERT_EQ(OB_SUCCESS, store_plan("k2", SCHEMA_VERSION, stored));
+  ASSERT_EQ(OB_SUCCESS, store_plan("k3", SCHEMA_VERSION, stored));
+  ASSERT_EQ(MAX_CACHED_PLANS, session_.get_cached_plan_count());
+
+  // k1 becomes the most recently used, k2 is evicted
+  ASSERT_EQ(OB_SUCCESS, get_plan("k1", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(OB_SUCCESS, store_plan("k4", SCHEMA_VERSION, stored));
+  ASSERT_EQ(MAX_CACHED_PLANS, session_.get_cached_plan_count());
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, get_plan("k2", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(OB_SUCCESS, get_plan("k1", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(OB_SUCCESS, get_plan("k3", SCHEMA_VERSION, PRIV_VERSION, cached));
+  ASSERT_EQ(OB_SUCCESS, get_plan("k4", SCHEMA_VERSION, PRIV_VERSION, cached));
+}
+
+TEST_F(ObSqlSessionPlanCacheTest, expire_on_version_change)
+{
+  ObResultSet *stored = NULL;
+  ObResultSet *cached = NULL;
+  ASSERT_EQ(OB_SUCCESS, store_plan("k1", SCHEMA_VERSION, stored));
+  ASSERT_EQ(OB_SUCCESS, store_plan("k2", SCHEMA_VERSION, stored));
+
+  // new schema, the plan is dropped
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, get_plan("k1", SCHEMA_VERSION + 1, PRIV_VERSION, cached));
+  ASSERT_EQ(1, session_.get_cached_plan_count());
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, get_plan("k1", SCHEMA_VERSION, PRIV_VERSION, cached));
+
+  // new privileges, the plan is dropped
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, get_plan("k2", SCHEMA_VERSION, PRIV_VERSION + 1, cached));
+  ASSERT_EQ(0, session_.get_cached_plan_count());
+}
+
+TEST_F(ObSqlSessionPlanCacheTest, memory_returned_after_eviction)
+{
+  static const int64_t PLAN_MEM_SIZE = 256 * 1024;
+  char key[32];
+  ObResultSet *stored = NULL;
+  ObArenaAllocator *arena = NULL;
+  ASSERT_EQ(OB_SUCCESS, store_plan("k000", SCHEMA_VERSION, stored, &arena, PLAN_MEM_SIZE));
+  ObArenaAllocator *evicted_arena = arena;
+  // the last one evicts k000
+  for (int64_t i = 1; i <= MAX_CACHED_PLANS; ++i)
+  {
+    snprintf(key, sizeof(key), "k%03ld", i);
+    ASSERT_EQ(OB_SUCCESS, store_plan(key, SCHEMA_VERSION, stored, &arena, PLAN_MEM_SIZE));
+    ASSERT_NE(evicted_arena, arena);
+  }
+
+  // the arena of the evicted plan went back to the session and is reused
+  snprintf(key, sizeof(key), "k%03ld", MAX_CACHED_PLANS + 1);
+  ASSERT_EQ(OB_SUCCESS, store_plan(key, SCHEMA_VERSION, stored, &arena, PLAN_MEM_SIZE));
+  ASSERT_EQ(evicted_arena, arena);
+
+  // plans keep coming, the memory of the plans stays bounded
+  const int64_t plan_mem_usage = ob_get_mod_memory_usage(ObModIds::OB_SQL_PS_TRANS);
+  const int64_t key_mem_usage = ob_get_mod_memory_usage(ObModIds::OB_SQL_SESSION);
+  for (int64_t i = MAX_CACHED_PLANS + 2; i < 100; ++i)
+  {
+    snprintf(key, sizeof(key), "k%03ld", i);
+    ASSERT_EQ(OB_SUCCESS, store_plan(key, SCHEMA_VERSION, stored, NULL, PLAN_MEM_SIZE));
+  }
+  ASSERT_EQ(MAX_CACHED_PLANS, session_.get_cached_plan_count());
+  ASSERT_EQ(plan_mem_usage, ob_get_mod_memory_usage(ObModIds::OB_SQL_PS_TRANS));
+  ASSERT_EQ(key_mem_usage, ob_get_mod_memory_usage(ObModIds::OB_SQL_SESSION));
+}
+
+int main(int argc, char **argv)
+{
+  TBSYS_LOGGER.setLogLevel("WARN");
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_readahead_window.cpp
+ *
+ */
+#include "gtest/gtest.h"
+#include "common/ob_malloc.h"
+#include "sstable/ob_readahead_window.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::sstable;
+
+namespace
+{
+  static const uint64_t TABLE_ID = 1001;
+  static const int64_t DISK_NO = 3;
+  static const uint64_t SSTABLE_ID = (100 << 8) | DISK_NO;
+  static const int64_t BLOCK_SIZE = 64 * 1024L;
+  static const int64_t MIN_SIZE = ObReadaheadWindow::MIN_WINDOW_SIZE;
+
+  // read block at %offset as ObBlockCache::get_block_readahead does
+  // with a cold cache, return whether it was read ahead before
+  bool read_block(ObReadaheadWindow &window, const int64_t offset)
+  {
+    bool prefetched = window.access(SSTABLE_ID, TABLE_ID, offset, BLOCK_SIZE, false);
+    if (!prefetched)
+    {
+      window.on_read(offset, window.get_size(), BLOCK_SIZE);
+    }
+    return prefetched;
+  }
+}
+
+TEST(TestReadaheadWindow, grow_on_sequential_scan)
+{
+  ObReadaheadWindow::set_disk_budget(1024 * 1024L);
+  ObReadaheadWindow window;
+
+  ASSERT_FALSE(read_block(window, 0));
+  ASSERT_EQ(MIN_SIZE, window.get_size());
+  ASSERT_TRUE(read_block(window, BLOCK_SIZE));
+  // window used up, doubled for the next read
+  ASSERT_FALSE(read_block(window, 2 * BLOCK_SIZE));
+  ASSERT_EQ(2 * MIN_SIZE, window.get_size());
+  ASSERT_EQ(1, ObReadaheadWindow::get_disk_scan_count(DISK_NO));
+  for (int64_t i = 3; i < 6; ++i)
+  {
+    ASSERT_TRUE(read_block(window, i * BLOCK_SIZE));
+  }
+  ASSERT_FALSE(read_block(window, 6 * BLOCK_SIZE));
+  ASSERT_EQ(4 * MIN_SIZE, window.get_size());
+
+  // capped by the disk budget
+  int64_t offset = 7 * BLOCK_SIZE;
+  for (int64_t i = 0; i < 100; ++i, offset += BLOCK_SIZE)
+  {
+    read_block(window, offset);
+  }
+  ASSERT_EQ(1024 * 1024L, window.get_size());
+  ASSERT_EQ(1024 * 1024L, window.get_max_window_size());
+
+  // a seek restarts the window
+  ASSERT_FALSE(read_block(window, offset + 10 * BLOCK_SIZE));
+  ASSERT_EQ(MIN_SIZE, window.get_size());
+
+  window.finish();
+  ASSERT_EQ(0, ObReadaheadWindow::get_disk_scan_count(DISK_NO));
+  ASSERT_EQ(0, window.get_readahead_count());
+}
+
+TEST(TestReadaheadWindow, share_budget_and_waste)
+{
+  ObReadaheadWindow::set_disk_budget(512 * 1024L);
+  ObReadaheadWindow window;
+  ObReadaheadWindow other;
+
+  ASSERT_FALSE(read_block(window, 0));
+  ASSERT_TRUE(read_block(window, BLOCK_SIZE));
+  ASSERT_FALSE(read_block(window, 2 * BLOCK_SIZE));
+  ASSERT_EQ(2 * MIN_SIZE, window.get_size());
+
+  // another sequential scan on the same disk halves the share
+  ASSERT_FALSE(read_block(other, 0));
+  ASSERT_TRUE(read_block(other, BLOCK_SIZE));
+  ASSERT_FALSE(read_block(other, 2 * BLOCK_SIZE));
+  ASSERT_EQ(2, ObReadaheadWindow::get_disk_scan_count(DISK_NO));
+  ASSERT_EQ(2 * MIN_SIZE, other.get_size());
+  for (int64_t i = 3; i < 6; ++i)
+  {
+    ASSERT_TRUE(read_block(window, i * BLOCK_SIZE));
+  }
+  ASSERT_FALSE(read_block(window, 6 * BLOCK_SIZE));
+  ASSERT_EQ(2 * MIN_SIZE, window.get_size());
+  other.finish();
+  ASSERT_EQ(1, ObReadaheadWindow::get_disk_scan_count(DISK_NO));
+
+  // block read ahead was washed out of cache before the scan got it
+  ASSERT_TRUE(window.access(SSTABLE_ID, TABLE_ID, 7 * BLOCK_SIZE, BLOCK_SIZE, false));
+  window.on_evicted(BLOCK_SIZE);
+  ASSERT_EQ(MIN_SIZE, window.get_size());
+  window.on_read(7 * BLOCK_SIZE, window.get_size(), BLOCK_SIZE);
+
+  ASSERT_EQ(4, window.get_readahead_count());
+  ASSERT_EQ(MIN_SIZE + 2 * MIN_SIZE + 2 * MIN_SIZE + MIN_SIZE, window.get_readahead_bytes());
+  // evicted block 7, blocks 8 and 9 never used, and block 8 read twice
+  ASSERT_EQ(4 * BLOCK_SIZE, window.get_waste_bytes());
+  window.finish();
+  ASSERT_EQ(0, ObReadaheadWindow::get_disk_scan_count(DISK_NO));
+}
+
+TEST(TestReadaheadWindow, reverse_scan)
+{
+  ObReadaheadWindow::set_disk_budget(1024 * 1024L);
+  ObReadaheadWindow window;
+  int64_t offset = 100 * BLOCK_SIZE;
+
+  ASSERT_FALSE(window.access(SSTABLE_ID, TABLE_ID, offset, BLOCK_SIZE, true));
+  window.on_read(offset + BLOCK_SIZE - MIN_SIZE, MIN_SIZE, BLOCK_SIZE);
+  offset -= BLOCK_SIZE;
+  ASSERT_TRUE(window.access(SSTABLE_ID, TABLE_ID, offset, BLOCK_SIZE, true));
+  offset -= BLOCK_SIZE;
+  ASSERT_FALSE(window.access(SSTABLE_ID, TABLE_ID, offset, BLOCK_SIZE, true));
+  ASSERT_EQ(2 * MIN_SIZE, window.get_size());
+  // switching direction restarts the window
+  ASSERT_FALSE(window.access(SSTABLE_ID, TABLE_ID, offset + BLOCK_SIZE, BLOCK_SIZE, false));
+  ASSERT_EQ(MIN_SIZE, window.get_size());
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,8 @@
 #include "common/ob_action_flag.h"
 #include "common/thread_buffer.h"
 #include "common/page_arena.h"
+#include "common/ob_statistics.h"
+#include "common/ob_common_stat.h"
 #include "sstable/ob_sstable_reader.h"
 #include "sstable/ob_sstable_writer.h"
 #include "sstable/ob_sstable_getter.h"
@@ -1140,6 +1142,108 @@ namespace oceanbase
 
       }
 
+      TEST_F(TestObSSTableGetter, test_sorted_get_reuse_block)
+      {
+          int ret = OB_SUCCESS;
+          ObSSTableGetter getter;
+          ObGetParam get_param;
+          ObSSTableReader* readers[OB_MAX_GET_COLUMN_NUMBER];
+          ObCellInfo *cell = NULL;
+          bool row_change = false;
+          ObStatManager stat_mgr(OB_CHUNKSERVER);
+          ObStat *stat = NULL;
+          const ObSSTableTrailer& trailer = sstable.get_trailer();
+          ObBlockIndexPositionInfo info;
+          ObBlockPositionInfo first_pos;
+          ObBlockPositionInfo pos;
+
+          //find the first row of the second block of column group 0
+          info.sstable_file_id_ = sstable.get_sstable_id().sstable_file_id_;
+          info.offset_ = trailer.get_block_index_record_offset();
+          info.size_ = trailer.get_block_index_record_size();
+          ret = tablet_mgr.get_serving_block_index_cache().get_single_block_pos_info(
+            info, table_id, 0, cell_infos[0][0].row_key_, OB_SEARCH_MODE_GREATER_EQUAL, first_pos);
+          ASSERT_EQ(OB_SUCCESS, ret);
+          int64_t next_block_row = 0;
+          for (int64_t i = 1; i < ROW_NUM && 0 == next_block_row; ++i)
+          {
+            ret = tablet_mgr.get_serving_block_index_cache().get_single_block_pos_info(
+              info, table_id, 0, cell_infos[i][0].row_key_, OB_SEARCH_MODE_GREATER_EQUAL, pos);
+            ASSERT_EQ(OB_SUCCESS, ret);
+            if (pos.offset_ != first_pos.offset_)
+            {
+              next_block_row = i;
+            }
+          }
+          ASSERT_LE(4, next_block_row);
+
+          //the third row is in row cache
+          const int64_t cached_row = next_block_row - 2;
+          readers[0] = &sstable;
+          for (int64_t j = 0; j < 2; ++j)
+          {
+            ret = get_param.add_cell(cell_infos[cached_row][j]);
+            EXPECT_EQ(OB_SUCCESS, ret);
+          }
+          ret = reset_thread_local_buffer();
+          ASSERT_EQ(OB_SUCCESS, ret);
+          ret = getter.init(tablet_mgr.get_serving_block_cache(), 
+                            tablet_mgr.get_serving_block_index_cache(), 
+                            get_param, readers, 1, false, tablet_mgr.get_row_cache());
+          ASSERT_EQ(OB_SUCCESS, ret);
+          while (OB_SUCCESS == (ret = getter.next_cell()))
+          {
+            ret = getter.get_cell(&cell, &row_change);
+            EXPECT_EQ(OB_SUCCESS, ret);
+          }
+          ASSERT_EQ(OB_ITER_END, ret);
+
+          //four rows at the end of the first block, one row of the next block
+          const int64_t row_index = next_block_row - 4;
+          const int64_t row_count = 5;
+          get_param.reset();
+          for (int64_t i = row_index; i < row_index + row_count; ++i)
+          {
+            for (int64_t j = 0; j < 2; ++j)
+            {
+              ret = get_param.add_cell(cell_infos[i][j]);
+              EXPECT_EQ(OB_SUCCESS, ret);
+            }
+            readers[i - row_index] = &sstable;
+          }
+          ret = reset_thread_local_buffer();
+          ASSERT_EQ(OB_SUCCESS, ret);
+          ObStatSingleton::init(&stat_mgr);
+          ret = getter.init(tablet_mgr.get_serving_block_cache(), 
+                            tablet_mgr.get_serving_block_index_cache(), 
+                            get_param, readers, row_count, false, tablet_mgr.get_row_cache());
+          ASSERT_EQ(OB_SUCCESS, ret);
+          for (int64_t i = row_index; i < row_index + row_count; ++i)
+          {
+            for (int64_t j = 0; j < 2; ++j)
+            {
+              ret = getter.next_cell();
+              ASSERT_EQ(OB_SUCCESS, ret);
+              ret = getter.get_cell(&cell, &row_change);
+              ASSERT_EQ(OB_SUCCESS, ret);
+              ASSERT_NE((ObCellInfo*)NULL, cell);
+              check_cell(cell_infos[i][j], *cell);
+              EXPECT_EQ(0 == j, row_change);
+            }
+          }
+          ret = getter.next_cell();
+          EXPECT_EQ(OB_ITER_END, ret);
+          ObStatSingleton::init(NULL);
+
+          //only the second row reuses the decoded block, the row after the
+          //cached one loads the block again, the last one is in another block
+          ret = stat_mgr.get_stat(OB_STAT_SSTABLE, table_id, stat);
+          ASSERT_EQ(OB_SUCCESS, ret);
+          EXPECT_EQ(1, stat->get_value(INDEX_SSTABLE_ROW_CACHE_HIT));
+          EXPECT_EQ(row_count - 1, stat->get_value(INDEX_SSTABLE_ROW_CACHE_MISS));
+          EXPECT_EQ(1, stat->get_value(INDEX_SSTABLE_GET_BLOCK_REUSE));
+      }
+
     }//end namespace sstable
   }//end namespace tests
 }//end namespace oceanbase
@@ -994,6 +994,90 @@ namespace oceanbase
         remove(sstable_path);
       }
 
+      TEST_F(TestObSSTableWriter, test_compress_threads)
+      {
+        // the same rows make the same file whether compressed in the
+        // appending thread or by compress threads
+        static const int64_t THREAD_NUMS[] = {0, 1, 3};
+        static const int64_t ROWS_PER_GROUP = 3000;
+        ObSSTableSchema schema;
+        ObSSTableRow row;
+        char *compressor_name = (char*)COMPRESSOR_NAME;
+        ObString compressor(static_cast<int32_t>(strlen(compressor_name) + 1),
+                           static_cast<int32_t>(strlen(compressor_name) + 1), compressor_name);
+        char paths[3][OB_MAX_FILE_NAME_LENGTH];
+        int64_t trailer_offsets[3];
+        int64_t sstable_sizes[3];
+        char value_data[256];
+        ObObj obj;
+        ObRowkey row_key;
+
+        init_generic_schema(schema);
+        for (int64_t t = 0; t < 3; ++t)
+        {
+          ObSSTableWriter writer;
+          int64_t space_usage = 0;
+          snprintf(paths[t], OB_MAX_FILE_NAME_LENGTH, "%s.%ld", sstable_path, t);
+          ObString file_name(static_cast<int32_t>(strlen(paths[t]) + 1),
+                             static_cast<int32_t>(strlen(paths[t]) + 1), paths[t]);
+          writer.set_compress_thread_num(THREAD_NUMS[t]);
+          ASSERT_EQ(OB_SUCCESS, writer.create_sstable(schema, file_name, compressor, 2));
+          for (int64_t table = 0; table < 2; ++table)
+          {
+            for (int64_t group = 0; group < 3; ++group)
+            {
+              for (int64_t i = 0; i < ROWS_PER_GROUP; ++i)
+              {
+                row.clear();
+                row.set_table_id(TABLE_ID_BASE + table);
+                row.set_column_group_id(COLUMN_GROUP_ID_BASE + group);
+                Key tmp_key(i, 0, 0);
+                tmp_key.trans_to_rowkey(row_key);
+                row.set_rowkey(row_key);
+                // values of various length, some blocks compress better
+                int32_t value_len = static_cast<int32_t>(snprintf(value_data, sizeof(value_data),
+                      "%0*ld", static_cast<int>(i % 200) + 1, i * 7919 + group));
+                ObString value_str(value_len, value_len, value_data);
+                obj.set_double(static_cast<double>(i));
+                row.add_obj(obj);
+                obj.set_int(i / 16);
+                row.add_obj(obj);
+                obj.set_varchar(value_str);
+                row.add_obj(obj);
+                ASSERT_EQ(OB_SUCCESS, writer.append_row(row, space_usage));
+                ASSERT_GT(space_usage, 0);
+              }
+            }
+          }
+          ASSERT_EQ(OB_SUCCESS, writer.close_sstable(trailer_offsets[t], sstable_sizes[t]));
+        }
+
+        char *expect_buf = NULL;
+        char *buf = NULL;
+        FileUtils file_util;
+        ASSERT_GT(sstable_sizes[0], 0);
+        ASSERT_TRUE(NULL != (expect_buf = (char*)ob_malloc(sstable_sizes[0], ObModIds::TEST)));
+        ASSERT_TRUE(NULL != (buf = (char*)ob_malloc(sstable_sizes[0], ObModIds::TEST)));
+        ASSERT_LE(0, file_util.open(paths[0], O_RDONLY));
+        ASSERT_EQ(sstable_sizes[0], file_util.read(expect_buf, sstable_sizes[0]));
+        file_util.close();
+        for (int64_t t = 1; t < 3; ++t)
+        {
+          ASSERT_EQ(trailer_offsets[0], trailer_offsets[t]);
+          ASSERT_EQ(sstable_sizes[0], sstable_sizes[t]);
+          ASSERT_LE(0, file_util.open(paths[t], O_RDONLY));
+          ASSERT_EQ(sstable_sizes[t], file_util.read(buf, sstable_sizes[t]));
+          file_util.close();
+          ASSERT_EQ(0, memcmp(expect_buf, buf, sstable_sizes[0])) << "thread_num=" << THREAD_NUMS[t];
+        }
+        ob_free(expect_buf);
+        ob_free(buf);
+        for (int64_t t = 0; t < 3; ++t)
+        {
+          remove(paths[t]);
+        }
+      }
+
       TEST_F(TestObSSTableWriter, test_write_patch_file_with_check)
       {
         ObSSTableWriter writer;
@@ -0,0 +1,272 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_index_modify_rows.cpp
+ *
+ */
+#include "updateserver/ob_memtable_modify.h"
+#include "sql/ob_values.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace updateserver;
+using namespace sql;
+
+namespace
+{
+  static const uint64_t DATA_TID = 1001;
+  static const uint64_t INDEX_TID = 1002;
+  static const uint64_t RK = 16;
+  static const uint64_t C1 = 101;
+  static const uint64_t C2 = 102;
+  static const uint64_t C1_OLD = C1 + OB_INDEX_OLD_VALUE_COLUMN_ID_OFFSET;
+  static const int64_t MAX_RECORD_NUM = 16;
+
+  struct RowRecord
+  {
+    uint64_t table_id;
+    int64_t key0;
+    int64_t key1;
+    bool is_del;
+  };
+
+  // data table t(rk, c1, c2) primary key (rk), index table t_c1(c1, rk) primary key (c1, rk),
+  // records the rows applied, one table after another
+  class RecordUpsTableMgr : public ObIUpsTableMgr
+  {
+    public:
+      RecordUpsTableMgr() : row_num_(0)
+      {
+        CommonSchemaManager cschema;
+        CommonTableSchema table;
+        ObRowkeyInfo data_rki;
+        ObRowkeyInfo index_rki;
+        ObRowkeyColumn rkc;
+        rkc.type_ = ObIntType;
+        rkc.column_id_ = RK;
+        data_rki.add_column(rkc);
+        table.set_table_id(DATA_TID);
+        table.set_table_name("t");
+        table.set_max_column_id(9999);
+        table.set_rowkey_info(data_rki);
+        cschema.add_table(table);
+
+        rkc.column_id_ = C1;
+        index_rki.add_column(rkc);
+        rkc.column_id_ = RK;
+        index_rki.add_column(rkc);
+        table.set_table_id(INDEX_TID);
+        table.set_table_name("t_c1");
+        table.set_rowkey_info(index_rki);
+        table.set_index_data_table_id(DATA_TID);
+        cschema.add_table(table);
+
+        CommonColumnSchema col;
+        col.set_column_type(ObIntType);
+        col.set_table_id(DATA_TID); col.set_column_id(RK); col.set_column_name("rk");
+        cschema.add_column(col);
+        col.set_table_id(DATA_TID); col.set_column_id(C1); col.set_column_name("c1");
+        cschema.add_column(col);
+        col.set_table_id(DATA_TID); col.set_column_id(C2); col.set_column_name("c2");
+        cschema.add_column(col);
+        col.set_table_id(INDEX_TID); col.set_column_id(RK); col.set_column_name("rk");
+        cschema.add_column(col);
+        col.set_table_id(INDEX_TID); col.set_column_id(C1); col.set_column_name("c1");
+        cschema.add_column(col);
+        cschema.sort_column();
+
+        CommonSchemaManagerWrapper cschema_wrapper(cschema);
+        schema_mgr_.set_schema_mgr(cschema_wrapper);
+      };
+    public:
+      int apply(RWSessionCtx &session_ctx, ObIterator &iter)
+      {
+        int ret = OB_SUCCESS;
+        UNUSED(session_ctx);
+        while (OB_SUCCESS == ret
+              && OB_SUCCESS == (ret = iter.next_cell()))
+        {
+          ObCellInfo *ci = NULL;
+          bool is_row_changed = false;
+          if (OB_SUCCESS != (ret = iter.get_cell(&ci, &is_row_changed))
+              || NULL == ci)
+          {
+            ret = (OB_SUCCESS == ret) ? OB_ERROR : ret;
+          }
+          else if (is_row_changed)
+          {
+            if (MAX_RECORD_NUM <= row_num_)
+            {
+              ret = OB_SIZE_OVERFLOW;
+            }
+            else
+            {
+              RowRecord &record = rows_[row_num_++];
+              record.table_id = ci->table_id_;
+              record.key0 = -1;
+              record.key1 = -1;
+              record.is_del = false;
+              ci->row_key_.get_obj_ptr()[0].get_int(record.key0);
+              if (1 < ci->row_key_.get_obj_cnt())
+              {
+                ci->row_key_.get_obj_ptr()[1].get_int(record.key1);
+              }
+            }
+          }
+          if (OB_SUCCESS == ret
+              && ObExtendType == ci->value_.get_type()
+              && ObActionFlag::OP_DEL_ROW == ci->value_.get_ext())
+          {
+            rows_[row_num_ - 1].is_del = true;
+          }
+        }
+        return (OB_ITER_END == ret) ? OB_SUCCESS : ret;
+      };
+      UpsSchemaMgr &get_schema_mgr()
+      {
+        return schema_mgr_;
+      };
+      void reset()
+      {
+        row_num_ = 0;
+      };
+      void check(const int64_t idx, const uint64_t table_id, const int64_t key0, const int64_t key1, const bool is_del)
+      {
+        ASSERT_LT(idx, row_num_);
+        EXPECT_EQ(table_id, rows_[idx].table_id);
+        EXPECT_EQ(key0, rows_[idx].key0);
+        EXPECT_EQ(key1, rows_[idx].key1);
+        EXPECT_EQ(is_del, rows_[idx].is_del);
+      };
+    public:
+      int64_t row_num_;
+      RowRecord rows_[MAX_RECORD_NUM];
+    private:
+      UpsSchemaMgr schema_mgr_;
+  };
+
+  void build_row(ObRowDesc &row_desc, const int64_t *values, ObValues &child)
+  {
+    ObRow row;
+    row.set_row_desc(row_desc);
+    child.set_row_desc(row_desc);
+    for (int64_t i = 0; i < row_desc.get_column_num(); i++)
+    {
+      ObObj obj;
+      obj.set_int(values[i]);
+      row.raw_set_cell(i, obj);
+    }
+    child.add_values(row);
+  }
+
+  void modify(SessionMgr &sm, RecordUpsTableMgr &tm, ObRowDesc &row_desc, const int64_t *values)
+  {
+    ObValues child;
+    uint32_t sd = 0;
+    build_row(row_desc, values, child);
+    tm.reset();
+    ASSERT_EQ(OB_SUCCESS, sm.begin_session(ST_READ_WRITE, tbsys::CTimeUtil::getTime(), INT64_MAX, INT64_MAX, sd));
+    RWSessionCtx *session = sm.fetch_ctx<RWSessionCtx>(sd);
+    ASSERT_TRUE(NULL != session);
+    MemTableModify mm(*session, tm);
+    mm.set_child(0, child);
+    EXPECT_EQ(OB_SUCCESS, mm.open());
+    EXPECT_EQ(OB_SUCCESS, mm.close());
+    sm.revert_ctx(sd);
+    sm.end_session(sd);
+  }
+}
+
+TEST(TestIndexModifyRows, insert)
+{
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  sm.init(1000, 1000, 1000, &scf);
+  RecordUpsTableMgr tm;
+  ObRowDesc row_desc;
+  row_desc.set_rowkey_cell_count(1);
+  row_desc.add_column_desc(DATA_TID, RK);
+  row_desc.add_column_desc(DATA_TID, C1);
+  row_desc.add_column_desc(DATA_TID, C2);
+  const int64_t values[] = {1, 10, 100};
+  modify(sm, tm, row_desc, values);
+  ASSERT_EQ(2, tm.row_num_);
+  tm.check(0, DATA_TID, 1, -1, false);
+  tm.check(1, INDEX_TID, 10, 1, false);
+}
+
+TEST(TestIndexModifyRows, update_index_column)
+{
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  sm.init(1000, 1000, 1000, &scf);
+  RecordUpsTableMgr tm;
+  ObRowDesc row_desc;
+  row_desc.set_rowkey_cell_count(1);
+  row_desc.add_column_desc(DATA_TID, RK);
+  row_desc.add_column_desc(DATA_TID, C1);
+  row_desc.add_column_desc(DATA_TID, C1_OLD);
+  // old index row is deleted before the new one is put
+  const int64_t values[] = {1, 20, 10};
+  modify(sm, tm, row_desc, values);
+  ASSERT_EQ(3, tm.row_num_);
+  tm.check(0, DATA_TID, 1, -1, false);
+  tm.check(1, INDEX_TID, 10, 1, true);
+  tm.check(2, INDEX_TID, 20, 1, false);
+
+  // index column set to its old value leaves the index row alone
+  const int64_t same_values[] = {1, 20, 20};
+  modify(sm, tm, row_desc, same_values);
+  ASSERT_EQ(1, tm.row_num_);
+  tm.check(0, DATA_TID, 1, -1, false);
+}
+
+TEST(TestIndexModifyRows, update_other_column)
+{
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  sm.init(1000, 1000, 1000, &scf);
+  RecordUpsTableMgr tm;
+  ObRowDesc row_desc;
+  row_desc.set_rowkey_cell_count(1);
+  row_desc.add_column_desc(DATA_TID, RK);
+  row_desc.add_column_desc(DATA_TID, C2);
+  row_desc.add_column_desc(DATA_TID, C1_OLD);
+  // rowkey of data table is part of index rowkey but never changes
+  const int64_t values[] = {1, 200, 20};
+  modify(sm, tm, row_desc, values);
+  ASSERT_EQ(1, tm.row_num_);
+  tm.check(0, DATA_TID, 1, -1, false);
+}
+
+TEST(TestIndexModifyRows, delete)
+{
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  sm.init(1000, 1000, 1000, &scf);
+  RecordUpsTableMgr tm;
+  ObRowDesc row_desc;
+  row_desc.set_rowkey_cell_count(1);
+  row_desc.add_column_desc(DATA_TID, RK);
+  row_desc.add_column_desc(DATA_TID, OB_ACTION_FLAG_COLUMN_ID);
+  row_desc.add_column_desc(DATA_TID, C1_OLD);
+  const int64_t values[] = {1, ObActionFlag::OP_DEL_ROW, 20};
+  modify(sm, tm, row_desc, values);
+  ASSERT_EQ(2, tm.row_num_);
+  tm.check(0, DATA_TID, 1, -1, true);
+  tm.check(1, INDEX_TID, 20, 1, true);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -74,6 +74,111 @@ TEST(TestLockMgr, init)
   EXPECT_TRUE(false == r2.row_lock.is_exclusive_locked_by(1024));
 }
 
+class TestWaitCallback : public ILockWaitCallback
+{
+  public:
+    TestWaitCallback() : wakeup_num_(0), timeout_num_(0), last_waiter_(NULL) {};
+    void on_lock_wakeup(LockWaitNode &node, const bool timeout)
+    {
+      if (timeout)
+      {
+        timeout_num_++;
+      }
+      else
+      {
+        wakeup_num_++;
+      }
+      last_waiter_ = node.waiter;
+    };
+  public:
+    int64_t wakeup_num_;
+    int64_t timeout_num_;
+    void *last_waiter_;
+};
+
+TEST(TestLockMgr, wait_queue)
+{
+  ILockInfo *nil = NULL;
+  SessionMgr sm;
+  FIFOAllocator allocator;
+  allocator.init(1L<<30, 1L<<30, 1L<<22);
+  TestWaitCallback cb;
+  LockMgr lm;
+  EXPECT_EQ(OB_SUCCESS, lm.init(&cb));
+
+  RWSessionCtx ctx(ST_READ_WRITE, sm, allocator);
+  ctx.set_session_start_time(tbsys::CTimeUtil::getTime());
+  ctx.set_session_timeout(1000000);
+  ctx.set_session_descriptor(1024);
+  ILockInfo *li = lm.assign(READ_COMMITED, ctx);
+  EXPECT_NE(nil, li);
+
+  RWSessionCtx ctx2(ST_READ_WRITE, sm, allocator);
+  ctx2.set_session_start_time(tbsys::CTimeUtil::getTime());
+  ctx2.set_session_timeout(1000000);
+  ctx2.set_session_descriptor(4096);
+  ILockInfo *li2 = lm.assign(READ_COMMITED, ctx2);
+  EXPECT_NE(nil, li2);
+
+  TEKey k;
+  TEValue r1;
+  EXPECT_EQ(OB_SUCCESS, li->on_write_begin(k, r1));
+
+  LockWaitCtx &wait_ctx = LockMgr::get_tsi_wait_ctx();
+  wait_ctx.reset();
+  wait_ctx.enable = true;
+  EXPECT_EQ(OB_UPS_LOCK_WAIT, li2->on_write_begin(k, r1));
+  EXPECT_EQ(&r1, wait_ctx.row);
+  // ctx2 holds no lock, it can not be part of a deadlock
+  EXPECT_EQ(INVALID_SESSION_DESCRIPTOR, wait_ctx.sd);
+
+  int waiter1 = 0;
+  int waiter2 = 0;
+  LockWaitNode n1;
+  LockWaitNode n2;
+  n1.row = &r1;
+  n1.waiter = &waiter1;
+  n1.end_time = INT64_MAX;
+  n2.row = &r1;
+  n2.waiter = &waiter2;
+  n2.end_time = 0;
+  EXPECT_EQ(OB_SUCCESS, lm.wait(n1));
+  EXPECT_EQ(OB_SUCCESS, lm.wait(n2));
+  EXPECT_EQ(2, lm.get_waiter_num());
+
+  // n2 has expired
+  lm.expire_waiters(tbsys::CTimeUtil::getTime());
+  EXPECT_EQ(1, cb.timeout_num_);
+  EXPECT_EQ(&waiter2, cb.last_waiter_);
+  EXPECT_EQ(1, lm.get_waiter_num());
+
+  // row is still locked, nobody is woken
+  lm.wakeup_next(&r1);
+  EXPECT_EQ(0, cb.wakeup_num_);
+
+  EXPECT_EQ(OB_SUCCESS, dynamic_cast<RCLockInfo*>(li)->cb_func(false, NULL, ctx));
+  EXPECT_EQ(1, cb.wakeup_num_);
+  EXPECT_EQ(&waiter1, cb.last_waiter_);
+  EXPECT_EQ(0, lm.get_waiter_num());
+
+  // row is free, waiting on it returns OB_EAGAIN
+  EXPECT_EQ(OB_EAGAIN, lm.wait(n1));
+  wait_ctx.reset();
+}
+
+TEST(TestLockMgr, deadlock)
+{
+  TestWaitCallback cb;
+  LockMgr lm;
+  EXPECT_EQ(OB_SUCCESS, lm.init(&cb));
+  EXPECT_EQ(OB_SUCCESS, lm.add_wait_for(1, 2));
+  EXPECT_EQ(OB_SUCCESS, lm.add_wait_for(2, 3));
+  EXPECT_EQ(OB_DEAD_LOCK, lm.add_wait_for(3, 1));
+  EXPECT_EQ(OB_DEAD_LOCK, lm.add_wait_for(3, 3));
+  lm.del_wait_for(2);
+  EXPECT_EQ(OB_SUCCESS, lm.add_wait_for(3, 1));
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
@@ -0,0 +1,283 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_memtable_checkpoint.cpp
+ *
+ */
+#include "updateserver/ob_memtable_modify.h"
+#include "updateserver/ob_memtable_checkpoint.h"
+#include "sql/ob_values.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace updateserver;
+using namespace sql;
+
+class MockUpsTableMgr : public ObIUpsTableMgr
+{
+  public:
+    MockUpsTableMgr()
+    {
+      mock_active_memtable_.init();
+
+      CommonSchemaManager cschema;
+      CommonTableSchema table;
+      table.set_table_id(1001);
+      table.set_table_name("t1");
+      table.set_max_column_id(9999);
+      ObRowkeyInfo rki;
+      ObRowkeyColumn rkc;
+      rkc.column_id_ = 16; rkc.type_ = ObIntType; rki.add_column(rkc);
+      rkc.column_id_ = 17; rkc.type_ = ObIntType; rki.add_column(rkc);
+      table.set_rowkey_info(rki);
+      cschema.add_table(table);
+
+      CommonColumnSchema col;
+      col.set_table_id(1001); col.set_column_id(16);  col.set_column_name("rk1");  col.set_column_type(ObIntType);
+      cschema.add_column(col);
+      col.set_table_id(1001); col.set_column_id(17);  col.set_column_name("rk2");  col.set_column_type(ObIntType);
+      cschema.add_column(col);
+      col.set_table_id(1001); col.set_column_id(101);  col.set_column_name("c1");  col.set_column_type(ObIntType);
+      cschema.add_column(col);
+      col.set_table_id(1001); col.set_column_id(102);  col.set_column_name("c2");  col.set_column_type(ObIntType);
+      cschema.add_column(col);
+
+      CommonSchemaManagerWrapper cschema_wrapper(cschema);
+      schema_mgr_.set_schema_mgr(cschema_wrapper);
+    };
+    ~MockUpsTableMgr()
+    {
+    };
+  public:
+    int apply(RWSessionCtx &session_ctx, ObIterator &iter)
+    {
+      int ret = OB_SUCCESS;
+      if (OB_SUCCESS != (ret = session_ctx.add_callback_info(session_ctx,
+                                                            &(mock_active_memtable_.get_trans_cb()),
+                                                            &(session_ctx.get_uc_info()))))
+      {
+        TBSYS_LOG(WARN, "add trans cb info to session ctx fail, ret=%d", ret);
+      }
+      else
+      {
+        session_ctx.get_ups_mutator().get_mutator().reset();
+        if (OB_SUCCESS != (ret = mock_active_memtable_.set(session_ctx, iter)))
+        {
+          TBSYS_LOG(WARN, "set to memtable fail ret=%d", ret);
+        }
+      }
+      return ret;
+    };
+    UpsSchemaMgr &get_schema_mgr()
+    {
+      return schema_mgr_;
+    };
+    MemTable &get_memtable()
+    {
+      return mock_active_memtable_;
+    };
+  private:
+    MemTable mock_active_memtable_;
+    UpsSchemaMgr schema_mgr_;
+};
+
+class MockMemTableModify : public MemTableModify
+{
+  public:
+    MockMemTableModify(RWSessionCtx &session, ObIUpsTableMgr &host) : MemTableModify(session, host)
+    {
+      ObRowkeyColumn rkc;
+
+      rkc.length_ = 0;
+      rkc.column_id_ = 16;
+      rkc.type_ = ObIntType;
+      rki_1001_.add_column(rkc);
+      rki_1002_.add_column(rkc);
+
+      rkc.length_ = 0;
+      rkc.column_id_ = 17;
+      rkc.type_ = ObIntType;
+      rki_1001_.add_column(rkc);
+      rki_1002_.add_column(rkc);
+    };
+    ~MockMemTableModify()
+    {
+    };
+  private:
+    ObRowkeyInfo *get_rowkey_info_(const uint64_t table_id)
+    {
+      ObRowkeyInfo *ret = NULL;
+      switch (table_id)
+      {
+        case 1001:
+          ret = &rki_1001_;
+          break;
+        case 1002:
+          ret = &rki_1002_;
+          break;
+        default:
+          break;
+      }
+      return ret;
+    };
+  private:
+    ObRowkeyInfo rki_1001_;
+    ObRowkeyInfo rki_1002_;
+};
+
+void build_values(const int64_t row_count, ObRowDesc &row_desc, ObValues &values1, ObValues &values2)
+{
+  values1.set_row_desc(row_desc);
+  values2.set_row_desc(row_desc);
+  for (int64_t i = 0; i < row_count; i++)
+  {
+    ObRow row;
+    row.set_row_desc(row_desc);
+    for (int64_t j = 0; j < row_desc.get_column_num(); j++)
+    {
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
+      row_desc.get_tid_cid(j, table_id, column_id);
+      ObObj obj;
+      obj.set_int(i + j);
+      row.set_cell(table_id, column_id, obj); 
+    }
+    values1.add_values(row);
+    values2.add_values(row);
+  }
+}
+
+TEST(TestMemTableCheckpoint, meta_serialize)
+{
+  MemTableCheckpointMeta meta;
+  MemTableCheckpointMeta result;
+  meta.memtable_version = 3;
+  meta.base_clog_id = 10;
+  meta.clog_id = 12;
+  meta.trans_id = 1000;
+  meta.checksum = 7;
+  meta.uncommited_checksum = 8;
+  meta.last_trans_id = 999;
+  meta.row_counter = 50;
+
+  const int64_t buf_len = 1L << 20;
+  char *buf = new char[buf_len];
+  int64_t pos = 0;
+  ASSERT_EQ(OB_SUCCESS, meta.serialize(buf, buf_len, pos));
+  int64_t data_len = pos;
+  pos = 0;
+  ASSERT_EQ(OB_SUCCESS, result.deserialize(buf, data_len, pos));
+  EXPECT_EQ(data_len, pos);
+  EXPECT_EQ(3U, result.memtable_version);
+  EXPECT_EQ(10U, result.base_clog_id);
+  EXPECT_EQ(12U, result.clog_id);
+  EXPECT_EQ(1000, result.trans_id);
+  EXPECT_EQ(7U, result.checksum);
+  EXPECT_EQ(8U, result.uncommited_checksum);
+  EXPECT_EQ(999, result.last_trans_id);
+  EXPECT_EQ(50, result.row_counter);
+
+  // 截断的meta不能加载
+  pos = 0;
+  EXPECT_NE(OB_SUCCESS, result.deserialize(buf, 16, pos));
+  delete [] buf;
+}
+
+TEST(TestMemTableCheckpoint, checkpoint_and_load)
+{
+  ObRowDesc row_desc;
+  row_desc.add_column_desc(1001, 16);
+  row_desc.add_column_desc(1001, 17);
+  row_desc.add_column_desc(1001, 101);
+  row_desc.add_column_desc(1001, 102);
+
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  sm.init(1000, 1000, 1000, &scf);
+  MockUpsTableMgr tm;
+  LockMgr lm;
+
+  for (int64_t i = 0; i < 5; i++)
+  {
+    ObValues child;
+    ObValues check;
+    build_values(10, row_desc, child, check);
+    uint32_t sd = 0;
+    sm.begin_session(ST_READ_WRITE, tbsys::CTimeUtil::getTime(), INT64_MAX, INT64_MAX, sd);
+    RWSessionCtx *session = sm.fetch_ctx<RWSessionCtx>(sd);
+    lm.assign(READ_COMMITED, *session);
+    MockMemTableModify mm(*session, tm);
+    mm.set_child(0, child);
+    EXPECT_EQ(OB_SUCCESS, mm.open());
+    EXPECT_EQ(OB_SUCCESS, mm.close());
+    session->set_trans_id(tbsys::CTimeUtil::getTime());
+    sm.revert_ctx(sd);
+    sm.end_session(sd);
+  }
+
+  uint32_t sd = 0;
+  EXPECT_EQ(OB_SUCCESS, sm.begin_session(ST_READ_ONLY, tbsys::CTimeUtil::getTime(), INT64_MAX, INT64_MAX, sd));
+  BaseSessionCtx *session = sm.fetch_ctx(sd);
+  ASSERT_TRUE(NULL != session);
+
+  const int64_t buf_len = 1L << 20;
+  char *buf = new char[buf_len];
+  char *buf2 = new char[buf_len];
+  int64_t pos = 0;
+  int64_t row_count = 0;
+  TableEngineIterator iter;
+  EXPECT_EQ(OB_SUCCESS, tm.get_memtable().scan_all(iter));
+  while (OB_SUCCESS == iter.next())
+  {
+    EXPECT_EQ(OB_SUCCESS, tm.get_memtable().checkpoint_row(*session, iter.get_key(), *iter.get_value(), buf, buf_len, pos));
+    row_count++;
+  }
+  EXPECT_EQ(10, row_count);
+
+  // buf不够时返回OB_SIZE_OVERFLOW且不修改pos
+  int64_t small_pos = 0;
+  TableEngineIterator iter2;
+  EXPECT_EQ(OB_SUCCESS, tm.get_memtable().scan_all(iter2));
+  EXPECT_EQ(OB_SUCCESS, iter2.next());
+  EXPECT_EQ(OB_SIZE_OVERFLOW, tm.get_memtable().checkpoint_row(*session, iter2.get_key(), *iter2.get_value(), buf2, 8, small_pos));
+  EXPECT_EQ(0, small_pos);
+
+  // 加载到一个新的memtable后再做一次checkpoint 输出应该完全相同
+  MemTable memtable;
+  memtable.init();
+  int64_t load_pos = 0;
+  for (int64_t i = 0; i < row_count; i++)
+  {
+    EXPECT_EQ(OB_SUCCESS, memtable.load_checkpoint_row(buf, pos, load_pos));
+  }
+  EXPECT_EQ(pos, load_pos);
+
+  int64_t pos2 = 0;
+  TableEngineIterator iter3;
+  EXPECT_EQ(OB_SUCCESS, memtable.scan_all(iter3));
+  while (OB_SUCCESS == iter3.next())
+  {
+    EXPECT_EQ(OB_SUCCESS, memtable.checkpoint_row(*session, iter3.get_key(), *iter3.get_value(), buf2, buf_len, pos2));
+  }
+  EXPECT_EQ(pos, pos2);
+  EXPECT_EQ(0, memcmp(buf, buf2, pos));
+
+  sm.revert_ctx(sd);
+  sm.end_session(sd);
+  delete [] buf;
+  delete [] buf2;
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
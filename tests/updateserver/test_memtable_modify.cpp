@@ -189,6 +189,158 @@ TEST(TestObInsertDBSemFilter, iter_succ)
   tm.get_memtable().dump2text(ObString(2, 2, "./"));
 }
 
+TEST(TestMemTableCompact, compact_rows)
+{
+  ObRowDesc row_desc;
+  row_desc.add_column_desc(1001, 16);
+  row_desc.add_column_desc(1001, 17);
+  row_desc.add_column_desc(1001, 101);
+  row_desc.add_column_desc(1001, 102);
+
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  sm.init(1000, 1000, 1000, &scf);
+  MockUpsTableMgr tm;
+  LockMgr lm;
+
+  const int64_t version_num = 20;
+  for (int64_t i = 0; i < version_num; i++)
+  {
+    ObValues child;
+    ObValues check;
+    build_values(10, row_desc, child, check);
+    uint32_t sd = 0;
+    sm.begin_session(ST_READ_WRITE, tbsys::CTimeUtil::getTime(), INT64_MAX, INT64_MAX, sd);
+    RWSessionCtx *session = sm.fetch_ctx<RWSessionCtx>(sd);
+    lm.assign(READ_COMMITED, *session);
+    MockMemTableModify mm(*session, tm);
+    mm.set_child(0, child);
+    EXPECT_EQ(OB_SUCCESS, mm.open());
+    EXPECT_EQ(OB_SUCCESS, mm.close());
+    session->set_trans_id(tbsys::CTimeUtil::getTime());
+    sm.revert_ctx(sd);
+    sm.end_session(sd);
+  }
+
+  // 写入路径上也可能已经合并过, 这里只检查后台合并之后每行只剩一个节点
+  MemTableChainStats stats;
+  EXPECT_EQ(OB_SUCCESS, tm.get_memtable().compact_rows(sm, &lm, 2, stats));
+  ASSERT_EQ(1, stats.count());
+  EXPECT_EQ(1001U, stats.at(0).table_id);
+  EXPECT_EQ(10, stats.at(0).row_count);
+
+  EXPECT_EQ(OB_SUCCESS, tm.get_memtable().compact_rows(sm, &lm, 2, stats));
+  ASSERT_EQ(1, stats.count());
+  EXPECT_EQ(10, stats.at(0).row_count);
+  EXPECT_EQ(0, stats.at(0).compacted_row_count);
+  EXPECT_EQ(1, stats.at(0).max_chain_length);
+  EXPECT_EQ(10, stats.at(0).buckets[0]);
+}
+
+class TestCompactWaitCallback : public ILockWaitCallback
+{
+  public:
+    TestCompactWaitCallback() : wakeup_num_(0), last_waiter_(NULL) {};
+    void on_lock_wakeup(LockWaitNode &node, const bool timeout)
+    {
+      if (!timeout)
+      {
+        wakeup_num_++;
+      }
+      last_waiter_ = node.waiter;
+    };
+  public:
+    int64_t wakeup_num_;
+    void *last_waiter_;
+};
+
+TEST(TestMemTableCompact, wakeup_waiter)
+{
+  ObRowDesc row_desc;
+  row_desc.add_column_desc(1001, 16);
+  row_desc.add_column_desc(1001, 17);
+  row_desc.add_column_desc(1001, 101);
+  row_desc.add_column_desc(1001, 102);
+
+  SessionCtxFactory scf;
+  SessionMgr sm;
+  sm.init(1000, 1000, 1000, &scf);
+  MockUpsTableMgr tm;
+  TestCompactWaitCallback cb;
+  LockMgr lm;
+  EXPECT_EQ(OB_SUCCESS, lm.init(&cb));
+
+  for (int64_t i = 0; i < 4; i++)
+  {
+    ObValues child;
+    ObValues check;
+    build_values(1, row_desc, child, check);
+    uint32_t sd = 0;
+    sm.begin_session(ST_READ_WRITE, tbsys::CTimeUtil::getTime(), INT64_MAX, INT64_MAX, sd);
+    RWSessionCtx *session = sm.fetch_ctx<RWSessionCtx>(sd);
+    lm.assign(READ_COMMITED, *session);
+    MockMemTableModify mm(*session, tm);
+    mm.set_child(0, child);
+    EXPECT_EQ(OB_SUCCESS, mm.open());
+    EXPECT_EQ(OB_SUCCESS, mm.close());
+    session->set_trans_id(tbsys::CTimeUtil::getTime());
+    sm.revert_ctx(sd);
+    sm.end_session(sd);
+  }
+
+  TableEngineIterator iter;
+  ASSERT_EQ(OB_SUCCESS, tm.get_memtable().scan_all(iter));
+  ASSERT_EQ(OB_SUCCESS, iter.next());
+  TEValue *row = iter.get_value();
+  ASSERT_TRUE(NULL != row);
+
+  // 行锁被占用时来写的事务在lock_mgr中排队, 之后行锁由不负责唤醒的一方释放,
+  // 和合并线程持锁期间排队的情形一样, 等待者留在队列里
+  const uint32_t holder = 1024;
+  int waiter = 0;
+  LockWaitNode node;
+  node.row = row;
+  node.waiter = &waiter;
+  node.end_time = INT64_MAX;
+  ASSERT_EQ(OB_SUCCESS, row->row_lock.try_exclusive_lock(holder));
+  ASSERT_EQ(OB_SUCCESS, lm.wait(node));
+  EXPECT_EQ(OB_SUCCESS, row->row_lock.exclusive_unlock(holder));
+  EXPECT_EQ(1, lm.get_waiter_num());
+  EXPECT_EQ(0, cb.wakeup_num_);
+
+  // 合并线程拿到行锁合并后释放, 必须唤醒等待者而不是等它超时
+  MemTableChainStats stats;
+  EXPECT_EQ(OB_SUCCESS, tm.get_memtable().compact_rows(sm, &lm, 1, stats));
+  EXPECT_EQ(1, cb.wakeup_num_);
+  EXPECT_EQ(&waiter, cb.last_waiter_);
+  EXPECT_EQ(0, lm.get_waiter_num());
+  EXPECT_FALSE(row->row_lock.is_exclusive_locked_by(holder));
+}
+
+TEST(TestMemTableCompact, chain_stat)
+{
+  MemTableChainStat stat;
+  stat.reset(1001);
+  stat.add(1);
+  stat.add(2);
+  stat.add(3);
+  stat.add(4);
+  stat.add(127);
+  stat.add(128);
+  stat.add(100000);
+  EXPECT_EQ(7, stat.row_count);
+  EXPECT_EQ(100000, stat.max_chain_length);
+  EXPECT_EQ(1, stat.buckets[0]);
+  EXPECT_EQ(2, stat.buckets[1]);
+  EXPECT_EQ(1, stat.buckets[2]);
+  EXPECT_EQ(1, stat.buckets[6]);
+  EXPECT_EQ(2, stat.buckets[MemTableChainStat::BUCKET_NUM - 1]);
+
+  char buf[512];
+  stat.to_string(buf, sizeof(buf));
+  EXPECT_STREQ("table_id=1001 rows=7 compacted=0 max_chain=100000 hist=[1:1 2:2 4:1 8:0 16:0 32:0 64:1 128+:2]", buf);
+}
+
 int main(int argc, char **argv)
 {
   ob_init_memory_pool();
@@ -0,0 +1,204 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * test_minor_compaction.cpp
+ *
+ */
+#include <pthread.h>
+#include <algorithm>
+#include "common/ob_malloc.h"
+#include "updateserver/ob_sstable_mgr.h"
+#include "gtest/gtest.h"
+
+using namespace oceanbase;
+using namespace common;
+using namespace updateserver;
+
+namespace
+{
+  static const int64_t MB = 1L << 20;
+  static const uint64_t MAJOR = 2;
+  static const int64_t MINOR_NUM = 8;
+  static const int64_t MAX_SSTABLE_NUM = 16;
+  static const int64_t READ_TIMES = 100000;
+
+  // sstable id表 模拟TableMgr的table_map_ 合并结果在写锁下插入 被覆盖的合并结果随后删除
+  struct SSTableTable
+  {
+    pthread_rwlock_t lock;
+    uint64_t ids[MAX_SSTABLE_NUM];
+    int64_t num;
+    volatile bool stop;
+
+    SSTableTable() : num(0), stop(false)
+    {
+      pthread_rwlock_init(&lock, NULL);
+      for (int64_t i = 1; i <= MINOR_NUM; i++)
+      {
+        ids[num++] = SSTableID::get_id(MAJOR, i, i);
+      }
+    };
+    ~SSTableTable()
+    {
+      pthread_rwlock_destroy(&lock);
+    };
+    void add(const uint64_t id)
+    {
+      pthread_rwlock_wrlock(&lock);
+      ids[num++] = id;
+      std::sort(ids, ids + num);
+      pthread_rwlock_unlock(&lock);
+    };
+    void erase(const uint64_t id)
+    {
+      pthread_rwlock_wrlock(&lock);
+      uint64_t *end = std::remove(ids, ids + num, id);
+      num = end - ids;
+      pthread_rwlock_unlock(&lock);
+    };
+  };
+
+  // 与TableMgr::acquire_table相同 读到的sstable必须首尾相接且覆盖全部minor版本
+  int64_t read_sstables(SSTableTable &table, SSTableID *selected)
+  {
+    int64_t selected_num = 0;
+    CoveringSSTableSelector<uint64_t> selector;
+    SSTableID sst_id;
+    uint64_t *item = NULL;
+    pthread_rwlock_rdlock(&table.lock);
+    for (int64_t i = 0; i < table.num; i++)
+    {
+      if (selector.add(table.ids[i], &table.ids[i], sst_id, item))
+      {
+        selected[selected_num++] = sst_id;
+      }
+    }
+    if (selector.finish(sst_id, item))
+    {
+      selected[selected_num++] = sst_id;
+    }
+    pthread_rwlock_unlock(&table.lock);
+    return selected_num;
+  }
+
+  void check_sstables(const SSTableID *selected, const int64_t selected_num)
+  {
+    ASSERT_LT(0, selected_num);
+    EXPECT_EQ(static_cast<uint64_t>(SSTableID::START_MINOR_VERSION), selected[0].minor_version_start);
+    for (int64_t i = 1; i < selected_num; i++)
+    {
+      EXPECT_TRUE(selected[i - 1].continous(selected[i]));
+    }
+    EXPECT_EQ(static_cast<uint64_t>(MINOR_NUM), selected[selected_num - 1].minor_version_end);
+  }
+
+  void *read_routine(void *arg)
+  {
+    SSTableTable *table = static_cast<SSTableTable*>(arg);
+    SSTableID selected[MAX_SSTABLE_NUM];
+    for (int64_t i = 0; i < READ_TIMES && !table->stop; i++)
+    {
+      int64_t selected_num = read_sstables(*table, selected);
+      check_sstables(selected, selected_num);
+    }
+    return NULL;
+  }
+}
+
+TEST(TestMinorCompaction, pick_same_tier)
+{
+  int64_t start_idx = -1;
+  // 最老的一组同层级的sstable
+  const int64_t sizes1[] = {1 * MB, 1 * MB, 1 * MB, 1 * MB, 1 * MB, 1 * MB, 1 * MB, 1 * MB};
+  ASSERT_TRUE(SSTableMgr::pick_minor_compaction(sizes1, 8, 4, start_idx));
+  EXPECT_EQ(0, start_idx);
+
+  // 大的sstable不与小的合并
+  const int64_t sizes2[] = {10 * MB, 1 * MB, 2 * MB, 3 * MB, 1 * MB};
+  ASSERT_TRUE(SSTableMgr::pick_minor_compaction(sizes2, 5, 4, start_idx));
+  EXPECT_EQ(1, start_idx);
+
+  // 个数不够
+  EXPECT_FALSE(SSTableMgr::pick_minor_compaction(sizes2, 3, 4, start_idx));
+  EXPECT_FALSE(SSTableMgr::pick_minor_compaction(sizes2, 5, 1, start_idx));
+  EXPECT_FALSE(SSTableMgr::pick_minor_compaction(NULL, 5, 4, start_idx));
+}
+
+TEST(TestMinorCompaction, pick_bounded)
+{
+  int64_t start_idx = -1;
+  // 层级都不同 个数没有超过2倍fan_in时不合并
+  const int64_t sizes1[] = {64 * MB, 16 * MB, 4 * MB, 1 * MB};
+  EXPECT_FALSE(SSTableMgr::pick_minor_compaction(sizes1, 4, 4, start_idx));
+
+  // 超过2倍fan_in时合并总大小最小的连续fan_in个
+  const int64_t sizes2[] = {64 * MB, 2 * MB, 64 * MB, 3 * MB, 16 * MB, 1 * MB, 64 * MB, 1 * MB, 64 * MB};
+  EXPECT_FALSE(SSTableMgr::pick_minor_compaction(sizes2, 8, 4, start_idx));
+  ASSERT_TRUE(SSTableMgr::pick_minor_compaction(sizes2, 9, 4, start_idx));
+  EXPECT_EQ(4, start_idx);
+}
+
+TEST(TestMinorCompaction, select_covering)
+{
+  SSTableTable table;
+  SSTableID selected[MAX_SSTABLE_NUM];
+  ASSERT_EQ(MINOR_NUM, read_sstables(table, selected));
+  check_sstables(selected, MINOR_NUM);
+
+  table.add(SSTableID::get_id(MAJOR, 1, 4));
+  ASSERT_EQ(5, read_sstables(table, selected));
+  check_sstables(selected, 5);
+  EXPECT_EQ(SSTableID::get_id(MAJOR, 1, 4), selected[0].id);
+
+  table.add(SSTableID::get_id(MAJOR, 5, 8));
+  table.add(SSTableID::get_id(MAJOR, 1, 8));
+  ASSERT_EQ(1, read_sstables(table, selected));
+  EXPECT_EQ(SSTableID::get_id(MAJOR, 1, 8), selected[0].id);
+
+  // 下一个major版本从头开始
+  table.add(SSTableID::get_id(MAJOR + 1, 1, 1));
+  ASSERT_EQ(2, read_sstables(table, selected));
+  EXPECT_EQ(SSTableID::get_id(MAJOR + 1, 1, 1), selected[1].id);
+  EXPECT_TRUE(selected[0].continous(selected[1]));
+}
+
+TEST(TestMinorCompaction, read_racing_install)
+{
+  static const int64_t READER_NUM = 4;
+  SSTableTable table;
+  pthread_t readers[READER_NUM];
+  for (int64_t i = 0; i < READER_NUM; i++)
+  {
+    ASSERT_EQ(0, pthread_create(&readers[i], NULL, read_routine, &table));
+  }
+  for (int64_t round = 0; round < 1000; round++)
+  {
+    // 两次fan_in为4的合并 再把两个合并结果合并 然后卸载被覆盖的合并结果
+    // 最后去掉全部合并结果 下一轮从转储的sstable重新开始
+    table.add(SSTableID::get_id(MAJOR, 1, 4));
+    table.add(SSTableID::get_id(MAJOR, 5, 8));
+    table.add(SSTableID::get_id(MAJOR, 1, 8));
+    table.erase(SSTableID::get_id(MAJOR, 1, 4));
+    table.erase(SSTableID::get_id(MAJOR, 5, 8));
+    table.erase(SSTableID::get_id(MAJOR, 1, 8));
+  }
+  table.stop = true;
+  for (int64_t i = 0; i < READER_NUM; i++)
+  {
+    pthread_join(readers[i], NULL);
+  }
+  ASSERT_EQ(MINOR_NUM, table.num);
+}
+
+int main(int argc, char **argv)
+{
+  ob_init_memory_pool();
+  testing::InitGoogleTest(&argc,argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,977 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_bulk_loader.cpp
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <new>
+#include "common/ob_malloc.h"
+#include "common/ob_crc64.h"
+#include "common/ob_obj_cast.h"
+#include "common/serialization.h"
+#include "common/utility.h"
+#include "ob_bulk_loader.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::sstable;
+using namespace oceanbase::sql;
+using namespace oceanbase::tools;
+
+const char* g_sstable_directory = NULL;
+
+namespace oceanbase
+{
+  namespace tools
+  {
+    ObBulkLoader::ObBulkLoader()
+      : inited_(false), table_schema_(NULL), column_group_id_(OB_INVALID_ID),
+        partitions_(NULL), partition_num_(0), used_mem_size_(0),
+        line_buf_(NULL), input_rows_(0), next_partition_(0),
+        finished_partitions_(0), err_(OB_SUCCESS)
+    {
+    }
+
+    ObBulkLoader::~ObBulkLoader()
+    {
+      if (NULL != partitions_)
+      {
+        delete [] partitions_;
+        partitions_ = NULL;
+      }
+      if (NULL != line_buf_)
+      {
+        delete [] line_buf_;
+        line_buf_ = NULL;
+      }
+    }
+
+    int ObBulkLoader::init(const ObBulkLoaderArgs &args)
+    {
+      int ret = OB_SUCCESS;
+      args_ = args;
+      if (inited_)
+      {
+        ret = OB_INIT_TWICE;
+      }
+      else if (NULL == args_.schema_mgr_ || OB_INVALID_ID == args_.table_id_
+          || NULL == args_.output_dir_ || 0 >= args_.input_files_.count()
+          || 0 >= args_.thread_num_ || 0 >= args_.mem_limit_)
+      {
+        fprintf(stderr, "invalid bulk load arguments\n");
+        ret = OB_INVALID_ARGUMENT;
+      }
+      else if (NULL == (table_schema_ = args_.schema_mgr_->get_table_schema(args_.table_id_)))
+      {
+        fprintf(stderr, "table %lu not exist in schema\n", args_.table_id_);
+        ret = OB_ENTRY_NOT_EXIST;
+      }
+      else if (OB_SUCCESS != (ret = build_sstable_schema(args_.table_id_,
+              *args_.schema_mgr_, sstable_schema_, false)))
+      {
+        fprintf(stderr, "build sstable schema of table %lu failed, ret=%d\n", args_.table_id_, ret);
+      }
+      else if (OB_SUCCESS != (ret = init_columns()))
+      {
+        fprintf(stderr, "init columns of table %lu failed, ret=%d\n", args_.table_id_, ret);
+      }
+      else if (OB_SUCCESS != (ret = load_boundaries()))
+      {
+        fprintf(stderr, "load tablet boundaries failed, ret=%d\n", ret);
+      }
+      else if (NULL == (line_buf_ = new (std::nothrow) char[MAX_LINE_LENGTH]))
+      {
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else
+      {
+        if (NULL == args_.tmp_dir_)
+        {
+          args_.tmp_dir_ = args_.output_dir_;
+        }
+        compressor_.assign_ptr(const_cast<char*>(args_.compressor_name_),
+            static_cast<int32_t>(strlen(args_.compressor_name_)));
+        setThreadCount(static_cast<int32_t>(args_.thread_num_));
+        inited_ = true;
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::init_columns()
+    {
+      int ret = OB_SUCCESS;
+      int32_t column_num = 0;
+      uint64_t group_ids[OB_MAX_COLUMN_GROUP_NUMBER];
+      int32_t group_num = OB_MAX_COLUMN_GROUP_NUMBER;
+      const ObColumnSchemaV2 *columns = args_.schema_mgr_->get_table_schema(args_.table_id_, column_num);
+      const ObRowkeyInfo &rowkey_info = table_schema_->get_rowkey_info();
+
+      if (NULL == columns || 0 >= column_num)
+      {
+        ret = OB_ERROR;
+      }
+      else if (OB_SUCCESS != (ret = args_.schema_mgr_->get_column_groups(args_.table_id_, group_ids, group_num)))
+      {
+        fprintf(stderr, "get column groups failed, ret=%d\n", ret);
+      }
+      else if (1 != group_num)
+      {
+        // the rows are read once from the sorted runs, while every
+        // column group of a dense sstable is written as a whole
+        fprintf(stderr, "table %lu has %d column groups, only one is supported\n",
+            args_.table_id_, group_num);
+        ret = OB_NOT_SUPPORTED;
+      }
+      else
+      {
+        column_group_id_ = group_ids[0];
+        for (int32_t i = 0; OB_SUCCESS == ret && i < column_num; ++i)
+        {
+          if (OB_SUCCESS != (ret = columns_.push_back(&columns[i])))
+          {
+            TBSYS_LOG(WARN, "push back column failed, ret=%d", ret);
+          }
+          else if (OB_SUCCESS != (ret = row_desc_.add_column_desc(args_.table_id_, columns[i].get_id())))
+          {
+            TBSYS_LOG(WARN, "add column desc failed, ret=%d", ret);
+          }
+        }
+      }
+
+      for (int64_t i = 0; OB_SUCCESS == ret && i < rowkey_info.get_size(); ++i)
+      {
+        uint64_t column_id = OB_INVALID_ID;
+        int64_t idx = OB_INVALID_INDEX;
+        ObSortColumn sort_column;
+        rowkey_info.get_column_id(i, column_id);
+        for (int64_t j = 0; j < columns_.count(); ++j)
+        {
+          if (columns_.at(j)->get_id() == column_id)
+          {
+            idx = j;
+            break;
+          }
+        }
+        sort_column.table_id_ = args_.table_id_;
+        sort_column.column_id_ = column_id;
+        if (OB_INVALID_INDEX == idx)
+        {
+          fprintf(stderr, "rowkey column %lu not found in table %lu\n", column_id, args_.table_id_);
+          ret = OB_ERR_COLUMN_NOT_FOUND;
+        }
+        else if (OB_SUCCESS != (ret = rowkey_idx_.push_back(idx)))
+        {
+          TBSYS_LOG(WARN, "push back rowkey index failed, ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = sort_columns_.push_back(sort_column)))
+        {
+          TBSYS_LOG(WARN, "push back sort column failed, ret=%d", ret);
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        row_desc_.set_rowkey_cell_count(rowkey_idx_.count());
+        row_.set_row_desc(row_desc_);
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::cast_cell(ObObj &cell, const ObObjType type)
+    {
+      int ret = OB_SUCCESS;
+      ObString cast_buffer;
+      cast_buffer.assign_ptr(cast_buf_, CAST_BUFFER_SIZE);
+      if (ObNullType != cell.get_type() && type != cell.get_type())
+      {
+        ret = obj_cast(cell, type, cast_buffer);
+      }
+      return ret;
+    }
+
+    /// one end rowkey per line, the rowkey columns are separated by the
+    /// delimiter of the input
+    int ObBulkLoader::load_boundaries()
+    {
+      int ret = OB_SUCCESS;
+      FILE *fp = NULL;
+      char line[OB_MAX_ROW_KEY_LENGTH];
+      ObRowkey rowkey;
+      ObRowkey boundary;
+
+      if (NULL != args_.boundary_file_)
+      {
+        if (NULL == (fp = fopen(args_.boundary_file_, "r")))
+        {
+          fprintf(stderr, "open boundary file %s failed, %s\n", args_.boundary_file_, strerror(errno));
+          ret = OB_IO_ERROR;
+        }
+        while (OB_SUCCESS == ret && NULL != fgets(line, sizeof(line), fp))
+        {
+          line[strcspn(line, "\r\n")] = '\0';
+          if ('\0' == line[0])
+          {
+            continue;
+          }
+          else if (OB_SUCCESS != (ret = parse_rowkey(line, rowkey)))
+          {
+            fprintf(stderr, "invalid boundary [%s], ret=%d\n", line, ret);
+          }
+          else if (0 < boundaries_.count() && rowkey <= boundaries_.at(boundaries_.count() - 1))
+          {
+            fprintf(stderr, "boundary [%s] is not in ascending order\n", line);
+            ret = OB_INVALID_ARGUMENT;
+          }
+          else if (OB_SUCCESS != (ret = rowkey.deep_copy(boundary, boundary_allocator_)))
+          {
+            TBSYS_LOG(WARN, "deep copy boundary failed, ret=%d", ret);
+          }
+          else if (OB_SUCCESS != (ret = boundaries_.push_back(boundary)))
+          {
+            TBSYS_LOG(WARN, "push back boundary failed, ret=%d", ret);
+          }
+        }
+        if (NULL != fp)
+        {
+          fclose(fp);
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        partition_num_ = boundaries_.count() + 1;
+        if (NULL == (partitions_ = new (std::nothrow) Partition[partition_num_]))
+        {
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+        }
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < partition_num_; ++i)
+      {
+        Partition &partition = partitions_[i];
+        char run_filename[OB_MAX_FILE_NAME_LENGTH];
+        int length = snprintf(run_filename, sizeof(run_filename), "%s/bulk_load_%lu_run_%ld",
+            NULL == args_.tmp_dir_ ? args_.output_dir_ : args_.tmp_dir_, args_.table_id_, i);
+        partition.range_.table_id_ = args_.table_id_;
+        partition.range_.border_flag_.unset_inclusive_start();
+        partition.range_.border_flag_.set_inclusive_end();
+        if (0 == i)
+        {
+          partition.range_.start_key_.set_min_row();
+        }
+        else
+        {
+          partition.range_.start_key_ = boundaries_.at(i - 1);
+        }
+        if (partition_num_ - 1 == i)
+        {
+          partition.range_.end_key_.set_max_row();
+        }
+        else
+        {
+          partition.range_.end_key_ = boundaries_.at(i);
+        }
+        if (OB_SUCCESS != (ret = partition.in_mem_sort_.set_sort_columns(sort_columns_)))
+        {
+          TBSYS_LOG(WARN, "set sort columns failed, ret=%d", ret);
+        }
+        else if (OB_SUCCESS != (ret = partition.merge_sort_.set_run_filename(
+                ObString(0, length, run_filename))))
+        {
+          TBSYS_LOG(WARN, "set run filename failed, ret=%d", ret);
+        }
+        else
+        {
+          partition.merge_sort_.set_sort_columns(sort_columns_);
+        }
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::parse_rowkey(char *line, ObRowkey &rowkey)
+    {
+      int ret = OB_SUCCESS;
+      int64_t count = 0;
+      char *field = line;
+      char *end = NULL;
+      while (OB_SUCCESS == ret && NULL != field)
+      {
+        if (count >= rowkey_idx_.count())
+        {
+          ret = OB_INVALID_ARGUMENT;
+          break;
+        }
+        if (NULL != (end = strchr(field, args_.delimiter_)))
+        {
+          *end = '\0';
+        }
+        rowkey_cells_[count].set_varchar(ObString(0, static_cast<int32_t>(strlen(field)), field));
+        if (OB_SUCCESS != (ret = cast_cell(rowkey_cells_[count],
+                columns_.at(rowkey_idx_.at(count))->get_type())))
+        {
+          TBSYS_LOG(WARN, "cast rowkey column %ld failed, ret=%d", count, ret);
+        }
+        ++count;
+        field = NULL == end ? NULL : end + 1;
+      }
+      if (OB_SUCCESS == ret)
+      {
+        if (count != rowkey_idx_.count())
+        {
+          ret = OB_INVALID_ARGUMENT;
+        }
+        else
+        {
+          rowkey.assign(rowkey_cells_, count);
+        }
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::route_row(int64_t &partition_idx) const
+    {
+      int ret = OB_SUCCESS;
+      ObRowkey rowkey(const_cast<ObObj*>(rowkey_cells_), rowkey_idx_.count());
+      // the first tablet whose end key is not less than the rowkey
+      int64_t low = 0;
+      int64_t high = boundaries_.count();
+      while (low < high)
+      {
+        int64_t middle = low + (high - low) / 2;
+        if (boundaries_.at(middle) < rowkey)
+        {
+          low = middle + 1;
+        }
+        else
+        {
+          high = middle;
+        }
+      }
+      partition_idx = low;
+      return ret;
+    }
+
+    int ObBulkLoader::add_row()
+    {
+      int ret = OB_SUCCESS;
+      int64_t partition_idx = 0;
+      for (int64_t i = 0; i < rowkey_idx_.count(); ++i)
+      {
+        rowkey_cells_[i] = cells_[rowkey_idx_.at(i)];
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < columns_.count(); ++i)
+      {
+        ret = row_.raw_set_cell(i, cells_[i]);
+      }
+      if (OB_SUCCESS != ret)
+      {
+        TBSYS_LOG(WARN, "set cell failed, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = route_row(partition_idx)))
+      {
+        TBSYS_LOG(WARN, "route row failed, ret=%d", ret);
+      }
+      else
+      {
+        Partition &partition = partitions_[partition_idx];
+        int64_t mem_size = partition.in_mem_sort_.get_used_mem_size();
+        if (OB_SUCCESS != (ret = partition.in_mem_sort_.add_row(row_)))
+        {
+          TBSYS_LOG(WARN, "add row to partition %ld failed, ret=%d", partition_idx, ret);
+        }
+        else
+        {
+          ++partition.row_count_;
+          ++input_rows_;
+          used_mem_size_ += partition.in_mem_sort_.get_used_mem_size() - mem_size;
+          if (used_mem_size_ >= args_.mem_limit_)
+          {
+            ret = dump_largest_partition();
+          }
+        }
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::dump_largest_partition()
+    {
+      int ret = OB_SUCCESS;
+      int64_t largest = 0;
+      for (int64_t i = 1; i < partition_num_; ++i)
+      {
+        if (partitions_[i].in_mem_sort_.get_used_mem_size()
+            > partitions_[largest].in_mem_sort_.get_used_mem_size())
+        {
+          largest = i;
+        }
+      }
+      Partition &partition = partitions_[largest];
+      int64_t mem_size = partition.in_mem_sort_.get_used_mem_size();
+      if (OB_SUCCESS != (ret = partition.in_mem_sort_.sort_rows()))
+      {
+        TBSYS_LOG(WARN, "sort partition %ld failed, ret=%d", largest, ret);
+      }
+      else if (OB_SUCCESS != (ret = partition.merge_sort_.dump_run(partition.in_mem_sort_)))
+      {
+        TBSYS_LOG(WARN, "dump partition %ld failed, ret=%d", largest, ret);
+      }
+      else
+      {
+        // reset clears the reserved sort columns of the row store too
+        partition.in_mem_sort_.reset();
+        if (OB_SUCCESS != (ret = partition.in_mem_sort_.set_sort_columns(sort_columns_)))
+        {
+          TBSYS_LOG(WARN, "set sort columns failed, ret=%d", ret);
+        }
+        ++partition.dump_count_;
+        used_mem_size_ -= mem_size - partition.in_mem_sort_.get_used_mem_size();
+        TBSYS_LOG(INFO, "dump run of partition %ld, run_count=%ld, mem_size=%ld",
+            largest, partition.dump_count_, mem_size);
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::parse_csv_line(char *line, const int64_t length)
+    {
+      int ret = OB_SUCCESS;
+      int64_t count = 0;
+      char *field = line;
+      char *end = NULL;
+      int64_t len = length;
+      while (len > 0 && ('\n' == line[len - 1] || '\r' == line[len - 1]))
+      {
+        line[--len] = '\0';
+      }
+      while (OB_SUCCESS == ret && NULL != field)
+      {
+        if (count >= columns_.count())
+        {
+          ret = OB_INVALID_ARGUMENT;
+          break;
+        }
+        if (NULL != (end = strchr(field, args_.delimiter_)))
+        {
+          *end = '\0';
+        }
+        // empty field is NULL
+        if ('\0' == *field)
+        {
+          cells_[count].set_null();
+        }
+        else
+        {
+          cells_[count].set_varchar(ObString(0, static_cast<int32_t>(strlen(field)), field));
+          ret = cast_cell(cells_[count], columns_.at(count)->get_type());
+        }
+        ++count;
+        field = NULL == end ? NULL : end + 1;
+      }
+      if (OB_SUCCESS == ret && count != columns_.count())
+      {
+        ret = OB_INVALID_ARGUMENT;
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::partition_csv_file(FILE *fp)
+    {
+      int ret = OB_SUCCESS;
+      int64_t line_no = 0;
+      while (OB_SUCCESS == ret && NULL != fgets(line_buf_, static_cast<int>(MAX_LINE_LENGTH), fp))
+      {
+        int64_t length = strlen(line_buf_);
+        ++line_no;
+        if (0 == length || '\n' == line_buf_[0])
+        {
+          continue;
+        }
+        else if (MAX_LINE_LENGTH - 1 == length && '\n' != line_buf_[length - 1])
+        {
+          fprintf(stderr, "line %ld is too long\n", line_no);
+          ret = OB_SIZE_OVERFLOW;
+        }
+        else if (OB_SUCCESS != (ret = parse_csv_line(line_buf_, length)))
+        {
+          fprintf(stderr, "invalid line %ld, ret=%d\n", line_no, ret);
+        }
+        else
+        {
+          ret = add_row();
+        }
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::partition_binary_file(FILE *fp)
+    {
+      int ret = OB_SUCCESS;
+      char len_buf[sizeof(int64_t)];
+      int64_t row_no = 0;
+      while (OB_SUCCESS == ret)
+      {
+        int64_t row_len = 0;
+        int64_t pos = 0;
+        size_t read_len = fread(len_buf, 1, sizeof(len_buf), fp);
+        if (0 == read_len && feof(fp))
+        {
+          break;
+        }
+        ++row_no;
+        if (sizeof(len_buf) != read_len
+            || OB_SUCCESS != serialization::decode_i64(len_buf, sizeof(len_buf), pos, &row_len)
+            || 0 >= row_len || MAX_LINE_LENGTH < row_len)
+        {
+          fprintf(stderr, "invalid length of row %ld\n", row_no);
+          ret = OB_DESERIALIZE_ERROR;
+        }
+        else if (static_cast<size_t>(row_len) != fread(line_buf_, 1, row_len, fp))
+        {
+          fprintf(stderr, "row %ld is truncated\n", row_no);
+          ret = OB_DESERIALIZE_ERROR;
+        }
+        else
+        {
+          pos = 0;
+          for (int64_t i = 0; OB_SUCCESS == ret && i < columns_.count(); ++i)
+          {
+            if (OB_SUCCESS != (ret = cells_[i].deserialize(line_buf_, row_len, pos)))
+            {
+              fprintf(stderr, "deserialize column %ld of row %ld failed, ret=%d\n", i, row_no, ret);
+            }
+            else
+            {
+              ret = cast_cell(cells_[i], columns_.at(i)->get_type());
+            }
+          }
+          if (OB_SUCCESS == ret)
+          {
+            ret = add_row();
+          }
+        }
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::partition_file(const char *file_name)
+    {
+      int ret = OB_SUCCESS;
+      FILE *fp = NULL;
+      if (NULL == (fp = fopen(file_name, "r")))
+      {
+        fprintf(stderr, "open input file %s failed, %s\n", file_name, strerror(errno));
+        ret = OB_IO_ERROR;
+      }
+      else
+      {
+        if (BULK_INPUT_BINARY == args_.input_format_)
+        {
+          ret = partition_binary_file(fp);
+        }
+        else
+        {
+          ret = partition_csv_file(fp);
+        }
+        fclose(fp);
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::load()
+    {
+      int ret = OB_SUCCESS;
+      int64_t start_time = tbsys::CTimeUtil::getTime();
+      if (!inited_)
+      {
+        ret = OB_NOT_INIT;
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && i < args_.input_files_.count(); ++i)
+      {
+        const char *file_name = args_.input_files_.at(i);
+        if (OB_SUCCESS != (ret = partition_file(file_name)))
+        {
+          fprintf(stderr, "partition input file %s failed, ret=%d\n", file_name, ret);
+        }
+        else
+        {
+          fprintf(stderr, "partitioned input file %s, total_rows=%ld\n", file_name, input_rows_);
+        }
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        fprintf(stderr, "partition done, rows=%ld, partitions=%ld, cost=%ldus, "
+            "build sstables with %ld threads\n", input_rows_, partition_num_,
+            tbsys::CTimeUtil::getTime() - start_time, args_.thread_num_);
+        start();
+        wait();
+        ret = err_;
+      }
+
+      if (OB_SUCCESS == ret)
+      {
+        fprintf(stderr, "build sstables done, cost=%ldus, load them with\n"
+            "  cs_admin -s <chunkserver> -i \"load_sstables %ld 1 %lu\"\n"
+            "after copying %s/%lu-* into the bypass directories of the chunkservers\n",
+            tbsys::CTimeUtil::getTime() - start_time, args_.version_, args_.table_id_,
+            args_.output_dir_, args_.table_id_);
+      }
+      return ret;
+    }
+
+    void ObBulkLoader::run(tbsys::CThread *thread, void *arg)
+    {
+      UNUSED(thread);
+      UNUSED(arg);
+      int ret = OB_SUCCESS;
+      int64_t partition_idx = 0;
+      while (OB_SUCCESS == err_
+          && (partition_idx = __sync_fetch_and_add(&next_partition_, 1)) < partition_num_)
+      {
+        if (OB_SUCCESS != (ret = build_partition(partition_idx)))
+        {
+          fprintf(stderr, "build sstable of partition %ld failed, ret=%d\n", partition_idx, ret);
+          __sync_bool_compare_and_swap(&err_, OB_SUCCESS, ret);
+        }
+        else
+        {
+          __sync_add_and_fetch(&finished_partitions_, 1);
+        }
+      }
+    }
+
+    int ObBulkLoader::get_rowkey(const ObRow &row, ObObj *objs, ObRowkey &rowkey) const
+    {
+      int ret = OB_SUCCESS;
+      const ObObj *cell = NULL;
+      uint64_t table_id = OB_INVALID_ID;
+      uint64_t column_id = OB_INVALID_ID;
+      for (int64_t i = 0; OB_SUCCESS == ret && i < rowkey_idx_.count(); ++i)
+      {
+        if (OB_SUCCESS == (ret = row.raw_get_cell(rowkey_idx_.at(i), cell, table_id, column_id)))
+        {
+          objs[i] = *cell;
+        }
+      }
+      if (OB_SUCCESS == ret)
+      {
+        rowkey.assign(objs, rowkey_idx_.count());
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::fill_sstable_row(const ObRow &row, const ObRowkey &rowkey,
+        ObSSTableRow &sstable_row) const
+    {
+      int ret = OB_SUCCESS;
+      int64_t def_count = 0;
+      const ObObj *cell = NULL;
+      const ObSSTableSchemaColumnDef *defs = sstable_schema_.get_group_schema(
+          args_.table_id_, column_group_id_, def_count);
+      sstable_row.clear();
+      if (OB_SUCCESS != (ret = sstable_row.set_table_id(args_.table_id_)))
+      {
+        TBSYS_LOG(WARN, "set table id failed, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = sstable_row.set_column_group_id(column_group_id_)))
+      {
+        TBSYS_LOG(WARN, "set column group id failed, ret=%d", ret);
+      }
+      else if (OB_SUCCESS != (ret = sstable_row.set_rowkey(rowkey)))
+      {
+        TBSYS_LOG(WARN, "set rowkey failed, ret=%d", ret);
+      }
+      for (int64_t i = 0; OB_SUCCESS == ret && NULL != defs && i < def_count; ++i)
+      {
+        if (OB_SUCCESS != (ret = row.get_cell(args_.table_id_, defs[i].column_name_id_, cell)))
+        {
+          TBSYS_LOG(WARN, "get cell %u failed, ret=%d", defs[i].column_name_id_, ret);
+        }
+        else if (OB_SUCCESS != (ret = sstable_row.add_obj(*cell)))
+        {
+          TBSYS_LOG(WARN, "add obj failed, ret=%d", ret);
+        }
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::check_rowkey_order(const ObRowkey &rowkey,
+        ObRowkey &last_rowkey, CharArena &allocator) const
+    {
+      int ret = OB_SUCCESS;
+      if (!last_rowkey.is_empty_row() && rowkey <= last_rowkey)
+      {
+        ret = OB_ERR_PRIMARY_KEY_DUPLICATE;
+      }
+      else
+      {
+        allocator.reuse();
+        ret = rowkey.deep_copy(last_rowkey, allocator);
+      }
+      return ret;
+    }
+
+    int ObBulkLoader::build_partition(const int64_t partition_idx)
+    {
+      int ret = OB_SUCCESS;
+      Partition &partition = partitions_[partition_idx];
+      ObSortHelper *reader = &partition.in_mem_sort_;
+      ObSSTableWriter *writer = NULL;
+      ObSSTableRow *sstable_row = NULL;
+      const ObRow *row = NULL;
+      ObObj rowkey_objs[OB_MAX_ROWKEY_COLUMN_NUMBER];
+      ObRowkey rowkey;
+      ObRowkey last_rowkey;
+      CharArena allocator;
+      char path[OB_MAX_FILE_NAME_LENGTH];
+      int64_t approx_size = 0;
+      int64_t trailer_offset = 0;
+      int64_t start_time = tbsys::CTimeUtil::getTime();
+      int length = snprintf(path, sizeof(path), "%s/%lu-%06ld",
+          args_.output_dir_, args_.table_id_, args_.seq_base_ + partition_idx);
+
+      if (0 == partition.row_count_)
+      {
+        // no tablet for an empty partition, the range is left to the
+        // tablets already on the chunkservers
+        fprintf(stderr, "partition %ld is empty, skip\n", partition_idx);
+      }
+      else if (NULL == (writer = new (std::nothrow) ObSSTableWriter())
+          || NULL == (sstable_row = new (std::nothrow) ObSSTableRow()))
+      {
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+      }
+      else if (OB_SUCCESS != (ret = partition.in_mem_sort_.sort_rows()))
+      {
+        TBSYS_LOG(WARN, "sort partition %ld failed, ret=%d", partition_idx, ret);
+      }
+      else if (0 < partition.dump_count_)
+      {
+        partition.merge_sort_.set_final_run(partition.in_mem_sort_);
+        if (OB_SUCCESS != (ret = partition.merge_sort_.build_merge_heap()))
+        {
+          TBSYS_LOG(WARN, "build merge heap of partition %ld failed, ret=%d", partition_idx, ret);
+        }
+        else
+        {
+          reader = &partition.merge_sort_;
+        }
+      }
+
+      if (OB_SUCCESS == ret && 0 < partition.row_count_)
+      {
+        if (OB_SUCCESS != (ret = writer->create_sstable(sstable_schema_, ObString(0, length, path),
+                compressor_, args_.version_, OB_SSTABLE_STORE_DENSE, args_.block_size_)))
+        {
+          fprintf(stderr, "create sstable %s failed, ret=%d\n", path, ret);
+        }
+        while (OB_SUCCESS == ret && OB_SUCCESS == (ret = reader->get_next_row(row)))
+        {
+          if (OB_SUCCESS != (ret = get_rowkey(*row, rowkey_objs, rowkey)))
+          {
+            TBSYS_LOG(WARN, "get rowkey failed, ret=%d", ret);
+          }
+          else if (OB_SUCCESS != (ret = check_rowkey_order(rowkey, last_rowkey, allocator)))
+          {
+            fprintf(stderr, "duplicate rowkey %s in partition %ld\n", to_cstring(rowkey), partition_idx);
+          }
+          else if (OB_SUCCESS != (ret = fill_sstable_row(*row, rowkey, *sstable_row)))
+          {
+            TBSYS_LOG(WARN, "fill sstable row failed, ret=%d", ret);
+          }
+          else if (OB_SUCCESS != (ret = writer->append_row(*sstable_row, approx_size)))
+          {
+            fprintf(stderr, "append row to sstable %s failed, ret=%d\n", path, ret);
+          }
+        }
+        if (OB_ITER_END == ret)
+        {
+          ret = OB_SUCCESS;
+        }
+        if (OB_SUCCESS != ret)
+        {
+          // leave no half written sstable in the output directory
+          unlink(path);
+        }
+        else if (OB_SUCCESS != (ret = writer->set_tablet_range(partition.range_)))
+        {
+          fprintf(stderr, "set range of sstable %s failed, ret=%d\n", path, ret);
+        }
+        else if (OB_SUCCESS != (ret = writer->close_sstable(trailer_offset, partition.sstable_size_)))
+        {
+          fprintf(stderr, "close sstable %s failed, ret=%d\n", path, ret);
+        }
+        else
+        {
+          fprintf(stderr, "build sstable %s, range=%s, rows=%ld, runs=%ld, size=%ld, cost=%ldus\n",
+              path, to_cstring(partition.range_), partition.row_count_, partition.dump_count_,
+              partition.sstable_size_, tbsys::CTimeUtil::getTime() - start_time);
+        }
+      }
+
+      partition.in_mem_sort_.reset();
+      partition.merge_sort_.reset();
+      if (NULL != sstable_row)
+      {
+        delete sstable_row;
+      }
+      if (NULL != writer)
+      {
+        delete writer;
+      }
+      return ret;
+    }
+  } // end namespace tools
+} // end namespace oceanbase
+
+void usage(const char *program_name)
+{
+  fprintf(stderr, "Usage: %s -s schema_file -t table_id -o output_dir [options] input_file...\n"
+      "  -s, --schema      schema file of the table\n"
+      "  -t, --table       id of the table to load\n"
+      "  -o, --output      directory of the output sstables, named as <table_id>-<seq>\n"
+      "  -b, --boundary    tablet boundaries, one end rowkey per line in ascending order,\n"
+      "                    the last tablet ends with max rowkey, one tablet if not set\n"
+      "  -f, --format      input format, csv(default) or binary\n"
+      "  -d, --delimiter   field delimiter of csv input and boundaries, ',' by default\n"
+      "  -T, --tmp         directory of the sort run files, output directory by default\n"
+      "  -c, --compressor  compressor name, lzo_1.0 by default\n"
+      "  -B, --block_size  sstable block size\n"
+      "  -v, --version     data version of the sstables, 1 by default\n"
+      "  -q, --seq         sequence number of the first sstable, 1 by default\n"
+      "  -n, --threads     number of threads building sstables, 8 by default\n"
+      "  -m, --memory      memory limit in MB for sorting before spilling runs, 2048 by default\n"
+      "  -h, --help        show this message\n", program_name);
+  exit(1);
+}
+
+int main(int argc, char **argv)
+{
+  int ret = OB_SUCCESS;
+  const char *opt_string = "s:t:o:b:f:d:T:c:B:v:q:n:m:h";
+  struct option longopts[] =
+  {
+    {"schema", 1, NULL, 's'},
+    {"table", 1, NULL, 't'},
+    {"output", 1, NULL, 'o'},
+    {"boundary", 1, NULL, 'b'},
+    {"format", 1, NULL, 'f'},
+    {"delimiter", 1, NULL, 'd'},
+    {"tmp", 1, NULL, 'T'},
+    {"compressor", 1, NULL, 'c'},
+    {"block_size", 1, NULL, 'B'},
+    {"version", 1, NULL, 'v'},
+    {"seq", 1, NULL, 'q'},
+    {"threads", 1, NULL, 'n'},
+    {"memory", 1, NULL, 'm'},
+    {"help", 0, NULL, 'h'},
+    {0, 0, 0, 0}
+  };
+  ObBulkLoaderArgs args;
+  int opt = 0;
+
+  while ((opt = getopt_long(argc, argv, opt_string, longopts, NULL)) != -1)
+  {
+    switch (opt)
+    {
+      case 's':
+        args.schema_file_ = optarg;
+        break;
+      case 't':
+        args.table_id_ = strtoull(optarg, NULL, 10);
+        break;
+      case 'o':
+        args.output_dir_ = optarg;
+        break;
+      case 'b':
+        args.boundary_file_ = optarg;
+        break;
+      case 'f':
+        if (0 == strcmp(optarg, "binary"))
+        {
+          args.input_format_ = BULK_INPUT_BINARY;
+        }
+        else if (0 == strcmp(optarg, "csv"))
+        {
+          args.input_format_ = BULK_INPUT_CSV;
+        }
+        else
+        {
+          usage(argv[0]);
+        }
+        break;
+      case 'd':
+        args.delimiter_ = optarg[0];
+        break;
+      case 'T':
+        args.tmp_dir_ = optarg;
+        break;
+      case 'c':
+        args.compressor_name_ = optarg;
+        break;
+      case 'B':
+        args.block_size_ = strtoll(optarg, NULL, 10);
+        break;
+      case 'v':
+        args.version_ = strtoll(optarg, NULL, 10);
+        break;
+      case 'q':
+        args.seq_base_ = strtoll(optarg, NULL, 10);
+        break;
+      case 'n':
+        args.thread_num_ = strtoll(optarg, NULL, 10);
+        break;
+      case 'm':
+        args.mem_limit_ = strtoll(optarg, NULL, 10) * 1024L * 1024L;
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        break;
+    }
+  }
+  for (int i = optind; i < argc; ++i)
+  {
+    args.input_files_.push_back(argv[i]);
+  }
+  if (NULL == args.schema_file_ || OB_INVALID_ID == args.table_id_
+      || NULL == args.output_dir_ || 0 >= args.input_files_.count())
+  {
+    usage(argv[0]);
+  }
+
+  TBSYS_LOGGER.setLogLevel("INFO");
+  ob_init_crc64_table(OB_DEFAULT_CRC64_POLYNOM);
+  ob_init_memory_pool();
+  tbsys::CConfig config;
+  ObSchemaManagerV2 *schema_mgr = new ObSchemaManagerV2(tbsys::CTimeUtil::getTime());
+  ObBulkLoader *loader = new ObBulkLoader();
+  if (!schema_mgr->parse_from_file(args.schema_file_, config))
+  {
+    fprintf(stderr, "parse schema file %s failed\n", args.schema_file_);
+    ret = OB_ERROR;
+  }
+  else
+  {
+    args.schema_mgr_ = schema_mgr;
+    if (OB_SUCCESS != (ret = loader->init(args)))
+    {
+      fprintf(stderr, "init bulk loader failed, ret=%d\n", ret);
+    }
+    else if (OB_SUCCESS != (ret = loader->load()))
+    {
+      fprintf(stderr, "bulk load failed, ret=%d\n", ret);
+    }
+  }
+  delete loader;
+  delete schema_mgr;
+  return OB_SUCCESS == ret ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/**
+ * (C) 2010-2013 Alibaba Group Holding Limited.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2 as published by the Free Software Foundation.
+ *
+ * Version: $Id$
+ *
+ * ob_bulk_loader.h
+ *
+ * Build the sstables of a table from CSV or binary input files.
+ * Rows are partitioned by the tablet boundaries of the table, every
+ * partition is sorted in memory and spilled to a run file when the
+ * memory limit is reached, then the partitions are merged and written
+ * to sstables by a pool of threads. The output files are named as
+ * the bypass sstables (<table_id>-<seq>), so they can be copied into
+ * the bypass directories of the chunkservers and loaded with
+ * "cs_admin load_sstables".
+ */
+#ifndef OCEANBASE_TOOLS_OB_BULK_LOADER_H_
+#define OCEANBASE_TOOLS_OB_BULK_LOADER_H_
+
+#include <stdio.h>
+#include <tbsys.h>
+#include "common/ob_define.h"
+#include "common/ob_array.h"
+#include "common/ob_string.h"
+#include "common/ob_object.h"
+#include "common/ob_row.h"
+#include "common/ob_row_desc.h"
+#include "common/ob_rowkey.h"
+#include "common/ob_range2.h"
+#include "common/ob_schema.h"
+#include "common/page_arena.h"
+#include "sql/ob_in_memory_sort.h"
+#include "sql/ob_merge_sort.h"
+#include "sstable/ob_sstable_row.h"
+#include "sstable/ob_sstable_schema.h"
+#include "sstable/ob_sstable_block_builder.h"
+#include "sstable/ob_sstable_writer.h"
+
+namespace oceanbase
+{
+  namespace tools
+  {
+    enum ObBulkInputFormat
+    {
+      BULK_INPUT_CSV = 0,
+      // rows of serialized ObObj, each row is prefixed by its length in
+      // bytes (encode_i64), columns in the order of the table schema
+      BULK_INPUT_BINARY = 1,
+    };
+
+    struct ObBulkLoaderArgs
+    {
+      ObBulkLoaderArgs()
+        : schema_file_(NULL), table_id_(common::OB_INVALID_ID),
+          input_format_(BULK_INPUT_CSV), delimiter_(','),
+          boundary_file_(NULL), output_dir_(NULL), tmp_dir_(NULL),
+          compressor_name_("lzo_1.0"), block_size_(sstable::ObSSTableBlockBuilder::SSTABLE_BLOCK_SIZE),
+          version_(1), seq_base_(1), thread_num_(8), mem_limit_(DEFAULT_MEM_LIMIT),
+          schema_mgr_(NULL)
+      {
+      }
+      static const int64_t DEFAULT_MEM_LIMIT = 2L * 1024L * 1024L * 1024L; //2G
+
+      const char *schema_file_;
+      uint64_t table_id_;
+      ObBulkInputFormat input_format_;
+      char delimiter_;
+      const char *boundary_file_;
+      const char *output_dir_;
+      const char *tmp_dir_;
+      const char *compressor_name_;
+      int64_t block_size_;
+      int64_t version_;
+      int64_t seq_base_;
+      int64_t thread_num_;
+      int64_t mem_limit_;
+      common::ObArray<const char*> input_files_;
+      const common::ObSchemaManagerV2 *schema_mgr_;
+    };
+
+    class ObBulkLoader : public tbsys::CDefaultRunnable
+    {
+      public:
+        ObBulkLoader();
+        virtual ~ObBulkLoader();
+
+        int init(const ObBulkLoaderArgs &args);
+        /// partition and spill all input files, then build the sstables
+        int load();
+        virtual void run(tbsys::CThread *thread, void *arg);
+
+      private:
+        static const int64_t MAX_LINE_LENGTH = 2L * 1024L * 1024L; //2M
+        static const int64_t CAST_BUFFER_SIZE = 64L * 1024L;
+
+        struct Partition
+        {
+          Partition() : dump_count_(0), row_count_(0), sstable_size_(0) {}
+          common::ObNewRange range_;
+          sql::ObInMemorySort in_mem_sort_;
+          sql::ObMergeSort merge_sort_;
+          int64_t dump_count_;
+          int64_t row_count_;
+          int64_t sstable_size_;
+        };
+
+      private:
+        DISALLOW_COPY_AND_ASSIGN(ObBulkLoader);
+        int init_columns();
+        int load_boundaries();
+        int parse_rowkey(char *line, common::ObRowkey &rowkey);
+        int cast_cell(common::ObObj &cell, const common::ObObjType type);
+
+        int partition_file(const char *file_name);
+        int partition_csv_file(FILE *fp);
+        int partition_binary_file(FILE *fp);
+        int parse_csv_line(char *line, const int64_t length);
+        int add_row();
+        int route_row(int64_t &partition_idx) const;
+        int dump_largest_partition();
+
+        int build_partition(const int64_t partition_idx);
+        int get_rowkey(const common::ObRow &row, common::ObObj *objs, common::ObRowkey &rowkey) const;
+        int fill_sstable_row(const common::ObRow &row, const common::ObRowkey &rowkey,
+            sstable::ObSSTableRow &sstable_row) const;
+        int check_rowkey_order(const common::ObRowkey &rowkey,
+            common::ObRowkey &last_rowkey, common::CharArena &allocator) const;
+
+      private:
+        bool inited_;
+        ObBulkLoaderArgs args_;
+        const common::ObTableSchema *table_schema_;
+        sstable::ObSSTableSchema sstable_schema_;
+        uint64_t column_group_id_;
+        common::ObString compressor_;
+
+        /// columns of the input in schema order
+        common::ObArray<const common::ObColumnSchemaV2*> columns_;
+        /// position of each rowkey column in columns_
+        common::ObArray<int64_t> rowkey_idx_;
+        common::ObRowDesc row_desc_;
+        common::ObArray<sql::ObSortColumn> sort_columns_;
+
+        /// end keys of the tablets but the last one, in ascending order
+        common::ObArray<common::ObRowkey> boundaries_;
+        common::CharArena boundary_allocator_;
+        Partition *partitions_;
+        int64_t partition_num_;
+        int64_t used_mem_size_;
+
+        common::ObRow row_;
+        common::ObObj cells_[common::OB_MAX_COLUMN_NUMBER];
+        common::ObObj rowkey_cells_[common::OB_MAX_ROWKEY_COLUMN_NUMBER];
+        char cast_buf_[CAST_BUFFER_SIZE];
+        char *line_buf_;
+        int64_t input_rows_;
+
+        volatile int64_t next_partition_;
+        volatile int64_t finished_partitions_;
+        volatile int err_;
+    };
+  } // end namespace tools
+} // end namespace oceanbase
+
+#endif //OCEANBASE_TOOLS_OB_BULK_LOADER_H_